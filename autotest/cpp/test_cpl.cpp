@@ -33,6 +33,9 @@
 #include "cpl_list.h"
 #include "cpl_hash_set.h"
 #include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "cpl_vsi_virtual.h"
+#include "cpl_minixml.h"
 
 namespace tut
 {
@@ -660,5 +663,311 @@ namespace tut
         ensure( "9g", EQUAL(oNVL.FetchNameValue("D"),"DD") );
     }
 
-} // namespace tut
+    // Test VSIFGetRangePointerL()
+    template<>
+    template<>
+    void object::test<10>()
+    {
+        const char szContent[] = "0123456789";
+
+        VSILFILE* fp = VSIFOpenL( "/vsimem/test_range_pointer", "wb" );
+        ensure( fp != NULL );
+        VSIFWriteL( szContent, 1, 10, fp );
+        VSIFCloseL( fp );
+
+        fp = VSIFOpenL( "/vsimem/test_range_pointer", "rb" );
+        ensure( fp != NULL );
+        const char* pszPtr = (const char*)VSIFGetRangePointerL( fp, 2, 3 );
+        ensure( pszPtr != NULL );
+        ensure( EQUALN(pszPtr, "234", 3) );
+        ensure( VSIFGetRangePointerL( fp, 8, 3 ) == NULL );
+        ensure_equals( VSIFTellL( fp ), (vsi_l_offset)0 );
+        VSIFCloseL( fp );
+
+        fp = VSIFOpenL( "/vsisubfile/1_5,/vsimem/test_range_pointer", "rb" );
+        ensure( fp != NULL );
+        pszPtr = (const char*)VSIFGetRangePointerL( fp, 1, 4 );
+        ensure( pszPtr != NULL );
+        ensure( EQUALN(pszPtr, "2345", 4) );
+        ensure( VSIFGetRangePointerL( fp, 1, 5 ) == NULL );
+        VSIFCloseL( fp );
+
+        VSIUnlink( "/vsimem/test_range_pointer" );
+
+        CPLString osTmpFile( CPLGenerateTempFilename("range_pointer") );
+        fp = VSIFOpenL( osTmpFile, "wb" );
+        ensure( fp != NULL );
+        VSIFWriteL( szContent, 1, 10, fp );
+        VSIFCloseL( fp );
+
+        fp = VSIFOpenL( osTmpFile, "rb" );
+        ensure( fp != NULL );
+        pszPtr = (const char*)VSIFGetRangePointerL( fp, 7, 3 );
+        if( pszPtr != NULL )
+            ensure( EQUALN(pszPtr, "789", 3) );
+        ensure( VSIFGetRangePointerL( fp, 7, 4 ) == NULL );
+        VSIFCloseL( fp );
+
+        VSIUnlink( osTmpFile );
+    }
+
+    // Test VSIFPReadL()
+    template<>
+    template<>
+    void object::test<11>()
+    {
+        const char szContent[] = "0123456789";
+        char szBuffer[10];
+
+        VSILFILE* fp = VSIFOpenL( "/vsimem/test_pread", "wb" );
+        ensure( fp != NULL );
+        VSIFWriteL( szContent, 1, 10, fp );
+        VSIFCloseL( fp );
+
+        fp = VSIFOpenL( "/vsimem/test_pread", "rb" );
+        ensure( fp != NULL );
+        ensure( VSIFHasPReadL( fp ) );
+        VSIFSeekL( fp, 1, SEEK_SET );
+        ensure_equals( VSIFPReadL( szBuffer, 3, 5, fp ), (size_t)3 );
+        ensure( EQUALN(szBuffer, "567", 3) );
+        ensure_equals( VSIFPReadL( szBuffer, 3, 8, fp ), (size_t)2 );
+        ensure( EQUALN(szBuffer, "89", 2) );
+        ensure_equals( VSIFTellL( fp ), (vsi_l_offset)1 );
+        VSIFCloseL( fp );
+
+        fp = VSIFOpenL( "/vsisubfile/2_5,/vsimem/test_pread", "rb" );
+        ensure( fp != NULL );
+        ensure( VSIFHasPReadL( fp ) );
+        ensure_equals( VSIFPReadL( szBuffer, 10, 1, fp ), (size_t)4 );
+        ensure( EQUALN(szBuffer, "3456", 4) );
+        VSIFCloseL( fp );
+
+        VSIUnlink( "/vsimem/test_pread" );
+
+        CPLString osTmpFile( CPLGenerateTempFilename("pread") );
+        fp = VSIFOpenL( osTmpFile, "wb" );
+        ensure( fp != NULL );
+        VSIFWriteL( szContent, 1, 10, fp );
+        VSIFCloseL( fp );
+
+        fp = VSIFOpenL( osTmpFile, "rb" );
+        ensure( fp != NULL );
+        ensure_equals( VSIFReadL( szBuffer, 1, 1, fp ), (size_t)1 );
+        ensure_equals( VSIFPReadL( szBuffer, 4, 6, fp ), (size_t)4 );
+        ensure( EQUALN(szBuffer, "6789", 4) );
+        ensure_equals( VSIFReadL( szBuffer, 1, 2, fp ), (size_t)2 );
+        ensure( EQUALN(szBuffer, "12", 2) );
+        VSIFCloseL( fp );
+
+        VSIUnlink( osTmpFile );
+    }
+
+    // Test VSI_CACHE and VSI_CACHE_PREFIX_OPTIONS
+    template<>
+    template<>
+    void object::test<12>()
+    {
+        GByte abyContent[1000];
+        GByte abyBuffer[1000];
+        for( int i = 0; i < 1000; i++ )
+            abyContent[i] = (GByte)(i * 7);
+
+        VSILFILE* fp = VSIFOpenL( "/vsimem/test_cache/file.bin", "wb" );
+        ensure( fp != NULL );
+        VSIFWriteL( abyContent, 1, 1000, fp );
+        VSIFCloseL( fp );
+
+        const char* apszOptions[] = {
+            "/vsimem/test_cache/ CHUNK_SIZE=7 READ_AHEAD=4",
+            "/vsimem/other/;/vsimem/test_cache/ CHUNK_SIZE=64 READ_AHEAD=0" };
+        for( int iTest = 0; iTest < 2; iTest++ )
+        {
+            CPLSetConfigOption( "VSI_CACHE_PREFIX_OPTIONS", apszOptions[iTest] );
+            CPLSetConfigOption( "VSI_CACHE_SIZE", "100" );
+
+            fp = VSIFOpenL( "/vsimem/test_cache/file.bin", "rb" );
+            ensure( fp != NULL );
+
+            // Sequential reads
+            for( int i = 0; i < 100; i++ )
+                ensure_equals( VSIFReadL( abyBuffer + i * 10, 1, 10, fp ), (size_t)10 );
+            ensure( memcmp( abyBuffer, abyContent, 1000 ) == 0 );
+            ensure_equals( VSIFReadL( abyBuffer, 1, 1, fp ), (size_t)0 );
+            ensure( VSIFEofL( fp ) );
+
+            // Random reads
+            ensure_equals( VSIFSeekL( fp, 0, SEEK_END ), 0 );
+            ensure_equals( VSIFTellL( fp ), (vsi_l_offset)1000 );
+            VSIFSeekL( fp, 995, SEEK_SET );
+            ensure_equals( VSIFReadL( abyBuffer, 1, 10, fp ), (size_t)5 );
+            ensure( memcmp( abyBuffer, abyContent + 995, 5 ) == 0 );
+            VSIFSeekL( fp, 13, SEEK_SET );
+            ensure_equals( VSIFReadL( abyBuffer, 1, 500, fp ), (size_t)500 );
+            ensure( memcmp( abyBuffer, abyContent + 13, 500 ) == 0 );
+            VSIFSeekL( fp, 3, SEEK_SET );
+            ensure_equals( VSIFReadL( abyBuffer, 1, 1, fp ), (size_t)1 );
+            ensure_equals( abyBuffer[0], abyContent[3] );
+
+            VSIFCloseL( fp );
+        }
+
+        CPLSetConfigOption( "VSI_CACHE_PREFIX_OPTIONS", NULL );
+        CPLSetConfigOption( "VSI_CACHE_SIZE", NULL );
+
+        VSIUnlink( "/vsimem/test_cache/file.bin" );
+    }
+
+    // Test CPLParseXMLStringInArena()
+    template<>
+    template<>
+    void object::test<13>()
+    {
+        const char* pszXML =
+            "<?xml version=\"1.0\"?>"
+            "<!-- comment -->"
+            "<Root a=\"1\" b='x&amp;y'>"
+            "<Empty/>"
+            "<Child>text &lt;1&gt;</Child>"
+            "<![CDATA[<raw>]]>"
+            "</Root>";
+
+        CPLXMLNode* psRef = CPLParseXMLString( pszXML );
+        ensure( psRef != NULL );
+        CPLXMLNode* psArena = CPLParseXMLStringInArena( pszXML );
+        ensure( psArena != NULL );
+
+        char* pszRef = CPLSerializeXMLTree( psRef );
+        char* pszArena = CPLSerializeXMLTree( psArena );
+        ensure_equals( std::string(pszArena), std::string(pszRef) );
+        ensure_equals( std::string(CPLGetXMLValue( psArena, "=Root.b", "" )),
+                       std::string("x&y") );
+
+        // A regular copy can be taken from a read-only tree
+        CPLXMLNode* psClone = CPLCloneXMLTree( CPLGetXMLNode( psArena, "=Root" ) );
+        CPLDestroyXMLArenaTree( psArena );
+        ensure_equals( std::string(CPLGetXMLValue( psClone, "Child", "" )),
+                       std::string("text <1>") );
+        CPLDestroyXMLNode( psClone );
+
+        CPLFree( pszRef );
+        CPLFree( pszArena );
+        CPLDestroyXMLNode( psRef );
+
+        // Big enough to need several blocks
+        std::string osBig( "<Root>" );
+        for( int i = 0; i < 10000; i++ )
+            osBig += "<a x=\"1\">b</a>";
+        osBig += "</Root>";
+        psArena = CPLParseXMLStringInArena( osBig.c_str() );
+        ensure( psArena != NULL );
+        int nCount = 0;
+        for( CPLXMLNode* psIter = psArena->psChild; psIter; psIter = psIter->psNext )
+            nCount ++;
+        ensure_equals( nCount, 10000 );
+        CPLDestroyXMLArenaTree( psArena );
+
+        CPLPushErrorHandler( CPLQuietErrorHandler );
+        psArena = CPLParseXMLStringInArena( "<a><b></a>" );
+        CPLPopErrorHandler();
+        ensure( psArena == NULL );
+    }
 
+    static int SAXStartElement( void* pUserData, const char* pszName,
+                                const char* const* papszAttributes )
+    {
+        std::string& osEvents = *(std::string*)pUserData;
+        osEvents += "<";
+        osEvents += pszName;
+        for( int i = 0; papszAttributes[i] != NULL; i += 2 )
+        {
+            osEvents += " ";
+            osEvents += papszAttributes[i];
+            osEvents += "=";
+            osEvents += papszAttributes[i+1];
+        }
+        osEvents += ">";
+        return strcmp(pszName, "Stop") != 0;
+    }
+
+    static int SAXEndElement( void* pUserData, const char* pszName )
+    {
+        std::string& osEvents = *(std::string*)pUserData;
+        osEvents += "</";
+        osEvents += pszName;
+        osEvents += ">";
+        return TRUE;
+    }
+
+    static int SAXCharacterData( void* pUserData, const char* pszData )
+    {
+        std::string& osEvents = *(std::string*)pUserData;
+        osEvents += "[";
+        osEvents += pszData;
+        osEvents += "]";
+        return TRUE;
+    }
+
+    // Test CPLParseXMLStringSAX()
+    template<>
+    template<>
+    void object::test<14>()
+    {
+        std::string osEvents;
+        ensure( CPLParseXMLStringSAX(
+            "<?xml version=\"1.0\"?><!-- comment -->"
+            "<Root a=\"1\" b='x&amp;y'><Empty c=\"2\"/>"
+            "<Child>text &lt;1&gt;</Child></Root>",
+            SAXStartElement, SAXEndElement, SAXCharacterData, &osEvents ) );
+        ensure_equals( osEvents,
+                       std::string("<?xml version=1.0></?xml>"
+                                   "<Root a=1 b=x&y><Empty c=2></Empty>"
+                                   "<Child>[text <1>]</Child></Root>") );
+
+        // Stopped by a callback
+        osEvents = "";
+        ensure( !CPLParseXMLStringSAX( "<Root><Stop/><Other/></Root>",
+                                       SAXStartElement, NULL, NULL, &osEvents ) );
+        ensure_equals( osEvents, std::string("<Root><Stop>") );
+
+        // Error
+        CPLPushErrorHandler( CPLQuietErrorHandler );
+        ensure( !CPLParseXMLStringSAX( "<a><b></a>", NULL, NULL, NULL, NULL ) );
+        ensure( !CPLParseXMLStringSAX( "<a>", NULL, NULL, NULL, NULL ) );
+        CPLPopErrorHandler();
+    }
+
+    // Test that a cached handle survives VSICleanupCachedFileManager()
+    // and is not cached a second time
+    template<>
+    template<>
+    void object::test<15>()
+    {
+        GByte abyContent[1000];
+        GByte abyBuffer[1000];
+        for( int i = 0; i < 1000; i++ )
+            abyContent[i] = (GByte)(i * 7);
+
+        VSILFILE* fp = VSIFOpenL( "/vsimem/test_cache/file2.bin", "wb" );
+        ensure( fp != NULL );
+        VSIFWriteL( abyContent, 1, 1000, fp );
+        VSIFCloseL( fp );
+
+        CPLSetConfigOption( "VSI_CACHE_PREFIX_OPTIONS",
+                            "/vsimem/test_cache/ CHUNK_SIZE=64" );
+        fp = VSIFOpenL( "/vsimem/test_cache/file2.bin", "rb" );
+        CPLSetConfigOption( "VSI_CACHE_PREFIX_OPTIONS", NULL );
+        ensure( fp != NULL );
+
+        VSIVirtualHandle* poHandle = (VSIVirtualHandle*) fp;
+        ensure( VSICreateCachedFile( poHandle ) == poHandle );
+
+        ensure_equals( VSIFReadL( abyBuffer, 1, 100, fp ), (size_t)100 );
+        VSICleanupCachedFileManager();
+        ensure_equals( VSIFReadL( abyBuffer + 100, 1, 900, fp ), (size_t)900 );
+        ensure( memcmp( abyBuffer, abyContent, 1000 ) == 0 );
+        VSIFCloseL( fp );
+
+        VSIUnlink( "/vsimem/test_cache/file2.bin" );
+    }
+
+} // namespace tut
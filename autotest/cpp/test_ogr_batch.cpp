@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////////////
+// $Id$
+//
+// Project:  C++ Test Suite for GDAL/OGR
+// Purpose:  Test OGRLayer::GetNextFeatureBatch() of the drivers that
+//           implement it natively, against GetNextFeature().
+//
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2015, GDAL contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Library General Public
+// License as published by the Free Software Foundation; either
+// version 2 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Library General Public License for more details.
+//
+// You should have received a copy of the GNU Library General Public
+// License along with this library; if not, write to the
+// Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+///////////////////////////////////////////////////////////////////////////////
+#include <tut.h>
+#include <tut_gdal.h>
+#include <gdal_common.h>
+#include <gdal_priv.h>
+#include <ogrsf_frmts.h>
+#include <cpl_vsi.h>
+#include <string>
+#include <vector>
+
+namespace tut
+{
+
+    // Test data
+    struct test_batch_data
+    {
+        test_batch_data()
+        {
+            GDALAllRegister();
+        }
+    };
+
+    // Register test group
+    typedef test_group<test_batch_data> group;
+    typedef group::object object;
+    group test_batch_group("OGR::FeatureBatch");
+
+    // Read the layer with GetNextFeatureBatch(), in batches of nBatchSize,
+    // and check that every row matches the feature of GetNextFeature()
+    static void ensure_batches_match_features(OGRLayer* lyr, int nBatchSize,
+                                              size_t nExpectedFeatures)
+    {
+        std::vector<OGRFeature*> features;
+        OGRFeature* feat = NULL;
+        lyr->ResetReading();
+        while( (feat = lyr->GetNextFeature()) != NULL )
+            features.push_back(feat);
+        ensure_equals("Wrong number of features", features.size(),
+                      nExpectedFeatures);
+
+        OGRFeatureDefn* defn = lyr->GetLayerDefn();
+        OGRFeatureBatch batch(defn);
+        size_t total = 0;
+        int count = 0;
+        lyr->ResetReading();
+        while( (count = lyr->GetNextFeatureBatch(&batch, nBatchSize)) > 0 )
+        {
+            ensure("Batch too large", count <= nBatchSize);
+            ensure("Too many features", total + count <= features.size());
+
+            for( int i = 0; i < count; i++ )
+            {
+                OGRFeature* ref = features[total + i];
+                ensure_equals("Wrong FID", batch.GetFIDs()[i], ref->GetFID());
+
+                for( int iField = 0; iField < defn->GetFieldCount(); iField++ )
+                {
+                    ensure_equals("Wrong set state",
+                                  batch.IsFieldSet(i, iField) != 0,
+                                  ref->IsFieldSet(iField) != 0);
+                    if( !ref->IsFieldSet(iField) )
+                        continue;
+
+                    switch( defn->GetFieldDefn(iField)->GetType() )
+                    {
+                        case OFTInteger:
+                            ensure_equals("Wrong integer value",
+                                batch.GetFieldAsIntegerArray(iField)[i],
+                                ref->GetFieldAsInteger(iField));
+                            break;
+                        case OFTInteger64:
+                            ensure_equals("Wrong integer64 value",
+                                batch.GetFieldAsInteger64Array(iField)[i],
+                                ref->GetFieldAsInteger64(iField));
+                            break;
+                        case OFTReal:
+                            ensure_equals("Wrong real value",
+                                batch.GetFieldAsDoubleArray(iField)[i],
+                                ref->GetFieldAsDouble(iField));
+                            break;
+                        default:
+                            break;
+                    }
+                }
+
+                feat = batch.GetFeature(i);
+                ensure("No feature", NULL != feat);
+                if( !feat->Equal(ref) )
+                {
+                    feat->DumpReadable(stderr);
+                    ref->DumpReadable(stderr);
+                }
+                ensure("Batch feature differs", feat->Equal(ref));
+                delete feat;
+            }
+            total += count;
+        }
+        ensure_equals("Wrong number of features in batches", total,
+                      features.size());
+
+        for( size_t i = 0; i < features.size(); i++ )
+            delete features[i];
+    }
+
+    // Test CSV batches with typed columns, out of range, invalid and
+    // null values
+    template<>
+    template<>
+    void object::test<1>()
+    {
+        const char* csv =
+            "id,i,i64,r,s,d,b,WKT\n"
+            "1,1,1,1.5,\"a\",2015/01/02,true,\"POINT (1 2)\"\n"
+            "2,99999999999,-99999999999999,1e300,\"two\n\"\"lines\"\"\",2015-12-31,0,\n"
+            "3,,,,,,,\n"
+            "4,abc,1.5,xyz,x,notadate,maybe,\"LINESTRING (0 0,1 1)\"\n"
+            "5,-99999999999,12,-0.25,\"\",2000-02-29,false\n";
+        const char* csvt =
+            "Integer,Integer,Integer64,Real,String,Date,Integer(Boolean),String\n";
+
+        VSILFILE* fp = VSIFOpenL("/vsimem/test_ogr_batch.csv", "wb");
+        VSIFWriteL(csv, 1, strlen(csv), fp);
+        VSIFCloseL(fp);
+        fp = VSIFOpenL("/vsimem/test_ogr_batch.csvt", "wb");
+        VSIFWriteL(csvt, 1, strlen(csvt), fp);
+        VSIFCloseL(fp);
+
+        GDALDataset* ds = (GDALDataset*) GDALOpenEx(
+            "/vsimem/test_ogr_batch.csv", GDAL_OF_VECTOR, NULL, NULL, NULL);
+        ensure("Can't open CSV file", NULL != ds);
+        OGRLayer* lyr = ds->GetLayer(0);
+        ensure("Can't get layer", NULL != lyr);
+        ensure_equals("Wrong type", lyr->GetLayerDefn()->GetFieldDefn(1)->GetType(),
+                      OFTInteger);
+
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure_batches_match_features(lyr, 2, 5);
+        ensure_batches_match_features(lyr, 100, 5);
+        CPLPopErrorHandler();
+
+        GDALClose(ds);
+        VSIUnlink("/vsimem/test_ogr_batch.csv");
+        VSIUnlink("/vsimem/test_ogr_batch.csvt");
+    }
+
+    // Test GeoPackage batches with typed columns, out of range, mistyped
+    // and null values
+    template<>
+    template<>
+    void object::test<2>()
+    {
+        GDALDriver* drv = GetGDALDriverManager()->GetDriverByName("GPKG");
+        ensure("GPKG driver not available", NULL != drv);
+
+        GDALDataset* ds = drv->Create("/vsimem/test_ogr_batch.gpkg",
+                                      0, 0, 0, GDT_Unknown, NULL);
+        ensure("Can't create GeoPackage", NULL != ds);
+        OGRLayer* lyr = ds->CreateLayer("test", NULL, wkbPoint, NULL);
+        ensure("Can't create layer", NULL != lyr);
+
+        const char* apszNames[] = { "i", "i64", "r", "s", "d", "dt", "bin", "b" };
+        const OGRFieldType aeTypes[] = { OFTInteger, OFTInteger64, OFTReal,
+            OFTString, OFTDate, OFTDateTime, OFTBinary, OFTInteger };
+        for( size_t i = 0; i < sizeof(aeTypes) / sizeof(aeTypes[0]); i++ )
+        {
+            OGRFieldDefn oField(apszNames[i], aeTypes[i]);
+            if( EQUAL(apszNames[i], "b") )
+                oField.SetSubType(OFSTBoolean);
+            ensure_equals("Can't create field",
+                          lyr->CreateField(&oField), OGRERR_NONE);
+        }
+
+        OGRFeature* feat = new OGRFeature(lyr->GetLayerDefn());
+        feat->SetField("i", 1);
+        feat->SetField("i64", (GIntBig)1234567890123LL);
+        feat->SetField("r", 1.5);
+        feat->SetField("s", "a");
+        feat->SetField("d", 2015, 1, 2);
+        feat->SetField("dt", 2015, 1, 2, 3, 4, 5, 100);
+        feat->SetField(feat->GetFieldIndex("bin"), 3, (GByte*)"\x00\x01\x02");
+        feat->SetField("b", 1);
+        OGRPoint oPoint(1, 2);
+        feat->SetGeometry(&oPoint);
+        ensure_equals("Can't create feature", lyr->CreateFeature(feat),
+                      OGRERR_NONE);
+        delete feat;
+
+        // A feature with no field set and no geometry
+        feat = new OGRFeature(lyr->GetLayerDefn());
+        ensure_equals("Can't create feature", lyr->CreateFeature(feat),
+                      OGRERR_NONE);
+        delete feat;
+
+        // Values out of range or of another type than the column, that
+        // only other applications could write
+        const char* apszSQL[] = {
+            "INSERT INTO test (i, i64, r, s, d, dt, b) VALUES "
+            "(99999999999, 1.5, 'xyz', 12, '2015-12-31', "
+            "'2015-12-31T23:59:59Z', 2)",
+            "INSERT INTO test (i, i64, r, s, d, dt, bin) VALUES "
+            "('abc', -9223372036854775808, 1e300, '', 'notadate', "
+            "'notadatetime', 'text')",
+            "INSERT INTO test (i, i64, r) VALUES (-2147483648, NULL, -0.25)" };
+        for( size_t i = 0; i < sizeof(apszSQL) / sizeof(apszSQL[0]); i++ )
+            ds->ExecuteSQL(apszSQL[i], NULL, NULL);
+
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure_batches_match_features(lyr, 2, 5);
+        ensure_batches_match_features(lyr, 100, 5);
+        CPLPopErrorHandler();
+
+        GDALClose(ds);
+        VSIUnlink("/vsimem/test_ogr_batch.gpkg");
+    }
+
+} // namespace tut
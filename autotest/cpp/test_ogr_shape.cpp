@@ -414,4 +414,158 @@ namespace tut
         OGR_DS_Destroy(ds);
     }
 
+    // Test reading features by batches
+    template<>
+    template<>
+    void object::test<11>()
+    {
+        std::string source(data_);
+        source += SEP;
+        source += "poly.shp";
+        OGRDataSourceH ds = OGR_Dr_Open(drv_, source.c_str(), false);
+        ensure("Can't open layer", NULL != ds);
+
+        OGRLayer* lyr = (OGRLayer*) OGR_DS_GetLayer(ds, 0);
+        ensure("Can't get layer", NULL != lyr);
+
+        std::vector<OGRFeature*> features;
+        OGRFeature* feat = NULL;
+        lyr->ResetReading();
+        while( (feat = lyr->GetNextFeature()) != NULL )
+            features.push_back(feat);
+        ensure_equals("Wrong number of features", features.size(), 10U);
+
+        const int area = lyr->GetLayerDefn()->GetFieldIndex("AREA");
+        const int prfedea = lyr->GetLayerDefn()->GetFieldIndex("PRFEDEA");
+        OGRFeatureBatch batch(lyr->GetLayerDefn());
+
+        size_t total = 0;
+        int count = 0;
+        lyr->ResetReading();
+        while( (count = lyr->GetNextFeatureBatch(&batch, 4)) > 0 )
+        {
+            ensure("Batch too large", count <= 4);
+            ensure_equals(batch.GetFeatureCount(), count);
+
+            const double* areas = batch.GetFieldAsDoubleArray(area);
+            ensure("No AREA column", NULL != areas);
+            ensure("Unexpected column type",
+                   NULL == batch.GetFieldAsIntegerArray(area));
+
+            for( int i = 0; i < count; i++ )
+            {
+                OGRFeature* ref = features[total + i];
+                ensure_equals("Wrong FID", batch.GetFIDs()[i], ref->GetFID());
+                ensure_equals("Wrong AREA", areas[i],
+                              ref->GetFieldAsDouble(area));
+
+                int bytes = 0;
+                const GByte* str = batch.GetFieldAsBinary(i, prfedea, &bytes);
+                ensure_equals("Wrong PRFEDEA",
+                              std::string((const char*)str, bytes),
+                              std::string(ref->GetFieldAsString(prfedea)));
+
+                const GByte* wkb = batch.GetGeomFieldAsWKB(i, 0, &bytes);
+                ensure("No geometry", NULL != wkb);
+                ensure_equals("Wrong WKB size", bytes,
+                              ref->GetGeometryRef()->WkbSize());
+
+                feat = batch.GetFeature(i);
+                ensure("Batch feature differs", feat->Equal(ref));
+                delete feat;
+            }
+            total += count;
+        }
+        ensure_equals("Wrong number of features in batches", total,
+                      features.size());
+
+        // With a spatial filter, batches must honour it as GetNextFeature()
+        const char* wkt = "LINESTRING(479505 4763195,480526 4762819)";
+        OGRGeometryH filterGeom = NULL;
+        OGRErr err = OGR_G_CreateFromWkt((char**) &wkt, NULL, &filterGeom);
+        ensure_equals("Can't create geometry from WKT", OGRERR_NONE, err);
+        OGR_L_SetSpatialFilter((OGRLayerH) lyr, filterGeom);
+        OGR_G_DestroyGeometry(filterGeom);
+
+        count = lyr->GetNextFeatureBatch(&batch, 100);
+        ensure_equals("Wrong number of filtered features", count, 1);
+        ensure_equals("Wrong filtered FID", batch.GetFIDs()[0], (GIntBig)7);
+
+        for( size_t i = 0; i < features.size(); i++ )
+            delete features[i];
+        OGR_DS_Destroy(ds);
+    }
+
+    // Test reading features in place
+    template<>
+    template<>
+    void object::test<12>()
+    {
+        std::string source(data_);
+        source += SEP;
+        source += "poly.shp";
+        OGRDataSourceH ds = OGR_Dr_Open(drv_, source.c_str(), false);
+        ensure("Can't open layer", NULL != ds);
+
+        OGRLayer* lyr = (OGRLayer*) OGR_DS_GetLayer(ds, 0);
+        ensure("Can't get layer", NULL != lyr);
+
+        std::vector<OGRFeature*> features;
+        OGRFeature* feat = NULL;
+        lyr->ResetReading();
+        while( (feat = lyr->GetNextFeature()) != NULL )
+            features.push_back(feat);
+        ensure_equals("Wrong number of features", features.size(), 10U);
+
+        OGRFeature inplace(lyr->GetLayerDefn());
+        size_t total = 0;
+        lyr->ResetReading();
+        while( lyr->GetNextFeatureInPlace(&inplace) )
+        {
+            ensure("Too many features", total < features.size());
+            ensure("In place feature differs",
+                   inplace.Equal(features[total]));
+            total++;
+        }
+        ensure_equals("Wrong number of features read in place", total,
+                      features.size());
+        ensure("Feature not reset at end of layer",
+               NULL == inplace.GetGeometryRef() && !inplace.IsFieldSet(0));
+
+        // With a spatial filter
+        const char* wkt = "LINESTRING(479505 4763195,480526 4762819)";
+        OGRGeometryH filterGeom = NULL;
+        OGRErr err = OGR_G_CreateFromWkt((char**) &wkt, NULL, &filterGeom);
+        ensure_equals("Can't create geometry from WKT", OGRERR_NONE, err);
+        OGR_L_SetSpatialFilter((OGRLayerH) lyr, filterGeom);
+        OGR_G_DestroyGeometry(filterGeom);
+
+        ensure("No filtered feature", lyr->GetNextFeatureInPlace(&inplace));
+        ensure_equals("Wrong filtered FID", inplace.GetFID(), (GIntBig)7);
+        ensure("Filtered feature differs", inplace.Equal(features[7]));
+        ensure("Too many filtered features",
+               !lyr->GetNextFeatureInPlace(&inplace));
+        OGR_L_SetSpatialFilter((OGRLayerH) lyr, NULL);
+
+        // Generic implementation, through a SQL result layer
+        OGRLayerH sql = OGR_DS_ExecuteSQL(ds,
+                            "SELECT * FROM poly WHERE EAS_ID > 160", NULL, NULL);
+        ensure("Can't execute SQL", NULL != sql);
+        OGRFeature sqlFeat((OGRFeatureDefn*) OGR_L_GetLayerDefn(sql));
+        total = 0;
+        while( OGR_L_GetNextFeatureInPlace(sql, (OGRFeatureH) &sqlFeat) )
+        {
+            ensure("Wrong EAS_ID", sqlFeat.GetFieldAsInteger("EAS_ID") > 160);
+            ensure("Wrong PRFEDEA", strlen(sqlFeat.GetFieldAsString("PRFEDEA")) > 0);
+            ensure("No geometry", NULL != sqlFeat.GetGeometryRef());
+            total++;
+        }
+        ensure_equals("Wrong number of SQL features", total, 9U);
+        OGR_DS_ReleaseResultSet(ds, sql);
+
+        for( size_t i = 0; i < features.size(); i++ )
+            delete features[i];
+        OGR_DS_Destroy(ds);
+    }
+
 } // namespace tut
@@ -353,6 +353,160 @@ def vsifile_8():
 
     return 'success'
 
+###############################################################################
+# Test per prefix cache options, and sharing of the cache between handles
+
+def vsifile_9():
+
+    fp = gdal.VSIFOpenL('tmp/vsifile_9.bin', 'wb')
+    ref_data = ''.join(['%08X' % i for i in range(10000)])
+    gdal.VSIFWriteL(ref_data, 1, len(ref_data), fp)
+    gdal.VSIFCloseL(fp)
+
+    gdal.SetConfigOption('VSI_CACHE_PREFIX_OPTIONS', 'tmp/vsifile_9 CHUNK_SIZE=1000 READ_AHEAD=4')
+    for i in range(2):
+        fp = gdal.VSIFOpenL('tmp/vsifile_9.bin', 'rb')
+        data = ''
+        while True:
+            chunk = gdal.VSIFReadL(1, 333, fp)
+            if len(chunk) == 0:
+                break
+            data = data + chunk.decode('ascii')
+        gdal.VSIFSeekL(fp, 12345, 0)
+        data2 = gdal.VSIFReadL(1, 10, fp).decode('ascii')
+        gdal.VSIFCloseL(fp)
+        if data != ref_data or data2 != ref_data[12345:12355]:
+            gdaltest.post_reason('fail')
+            gdal.SetConfigOption('VSI_CACHE_PREFIX_OPTIONS', None)
+            return 'fail'
+    gdal.SetConfigOption('VSI_CACHE_PREFIX_OPTIONS', None)
+
+    gdal.Unlink('tmp/vsifile_9.bin')
+
+    return 'success'
+
+###############################################################################
+# Test the persistent member index of /vsitar/
+
+def vsifile_10():
+
+    import tarfile
+
+    tar = tarfile.open('tmp/vsifile_10.tar', 'w')
+    for name in ['a/1.txt', 'a/2.txt', 'b.txt']:
+        open('tmp/vsifile_10_member', 'wb').write(name.encode('ascii'))
+        tar.add('tmp/vsifile_10_member', name)
+    tar.close()
+    gdal.Unlink('tmp/vsifile_10_member')
+
+    # Build the index
+    gdal.SetConfigOption('CPL_VSIL_ARCHIVE_INDEX', 'YES')
+    content = gdal.ReadDir('/vsitar/tmp/vsifile_10.tar/a')
+    gdal.SetConfigOption('CPL_VSIL_ARCHIVE_INDEX', None)
+    if content != ['1.txt', '2.txt']:
+        gdaltest.post_reason('fail')
+        print(content)
+        return 'fail'
+    if gdal.VSIStatL('tmp/vsifile_10.tar.vsiidx') is None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    index = open('tmp/vsifile_10.tar.vsiidx', 'rb').read().decode('ascii').split('\n')
+
+    # Use it for copies of the archive, renaming a member to check that
+    # the index is used rather than the archive itself
+    data = open('tmp/vsifile_10.tar', 'rb').read()
+    for i in range(2):
+        filename = 'tmp/vsifile_10_%d.tar' % i
+        open(filename, 'wb').write(data)
+        statBuf = gdal.VSIStatL(filename)
+        size = statBuf.size
+        if i == 1:
+            # Stale index : must be ignored
+            size = size + 1
+        lines = [ index[0], '/vsitar %d %d %s' % (size, statBuf.mtime, index[1].split(' ')[3]) ]
+        lines += [ line.replace('a/2.txt', 'a/3.txt') for line in index[2:] ]
+        open(filename + '.vsiidx', 'wb').write('\n'.join(lines).encode('ascii'))
+
+    fp = gdal.VSIFOpenL('/vsitar/tmp/vsifile_10_0.tar/a/3.txt', 'rb')
+    if fp is None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    data = gdal.VSIFReadL(1, 100, fp).decode('ascii')
+    gdal.VSIFCloseL(fp)
+    if data != 'a/2.txt':
+        gdaltest.post_reason('fail')
+        print(data)
+        return 'fail'
+    content = gdal.ReadDir('/vsitar/tmp/vsifile_10_0.tar/a')
+    if content != ['1.txt', '3.txt']:
+        gdaltest.post_reason('fail')
+        print(content)
+        return 'fail'
+
+    if gdal.VSIStatL('/vsitar/tmp/vsifile_10_1.tar/a/3.txt') is not None or \
+       gdal.VSIStatL('/vsitar/tmp/vsifile_10_1.tar/a/2.txt') is None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    for filename in ['tmp/vsifile_10.tar', 'tmp/vsifile_10_0.tar', 'tmp/vsifile_10_1.tar']:
+        gdal.Unlink(filename)
+        gdal.Unlink(filename + '.vsiidx')
+
+    return 'success'
+
+###############################################################################
+# Test that the cache does not return stale data after a file is rewritten
+# with the same size within the same second
+
+def vsifile_11_read(filename):
+    fp = gdal.VSIFOpenL(filename, 'rb')
+    data = gdal.VSIFReadL(1, 10000, fp).decode('ascii')
+    gdal.VSIFCloseL(fp)
+    return data
+
+def vsifile_11_write(filename, data, access = 'wb'):
+    fp = gdal.VSIFOpenL(filename, access)
+    gdal.VSIFWriteL(data, 1, len(data), fp)
+    gdal.VSIFCloseL(fp)
+
+def vsifile_11():
+
+    gdal.SetConfigOption('VSI_CACHE_PREFIX_OPTIONS', 'tmp/vsifile_11 CHUNK_SIZE=100')
+
+    ret = 'success'
+    for i in range(3):
+        vsifile_11_write('tmp/vsifile_11.bin', 'a' * 1000)
+        if vsifile_11_read('tmp/vsifile_11.bin') != 'a' * 1000:
+            gdaltest.post_reason('fail')
+            ret = 'fail'
+
+        if i == 0:
+            # Rewritten through a new handle
+            vsifile_11_write('tmp/vsifile_11.bin', 'b' * 1000)
+        elif i == 1:
+            # Updated through a handle opened before a cached read
+            fp = gdal.VSIFOpenL('tmp/vsifile_11.bin', 'r+b')
+            if vsifile_11_read('tmp/vsifile_11.bin') != 'a' * 1000:
+                gdaltest.post_reason('fail')
+                ret = 'fail'
+            gdal.VSIFWriteL('b' * 1000, 1, 1000, fp)
+            gdal.VSIFCloseL(fp)
+        else:
+            # Replaced by another file
+            vsifile_11_write('tmp/vsifile_11_new.bin', 'b' * 1000)
+            gdal.Rename('tmp/vsifile_11_new.bin', 'tmp/vsifile_11.bin')
+
+        if vsifile_11_read('tmp/vsifile_11.bin') != 'b' * 1000:
+            gdaltest.post_reason('fail')
+            print(i)
+            ret = 'fail'
+
+    gdal.SetConfigOption('VSI_CACHE_PREFIX_OPTIONS', None)
+
+    gdal.Unlink('tmp/vsifile_11.bin')
+
+    return ret
+
 gdaltest_list = [ vsifile_1,
                   vsifile_2,
                   vsifile_3,
@@ -360,7 +514,10 @@ gdaltest_list = [ vsifile_1,
                   vsifile_5,
                   vsifile_6,
                   vsifile_7,
-                  vsifile_8 ]
+                  vsifile_8,
+                  vsifile_9,
+                  vsifile_10,
+                  vsifile_11 ]
 
 if __name__ == '__main__':
 
@@ -1580,6 +1580,55 @@ def ogr_csv_34():
 
     return 'success'
 
+###############################################################################
+# Test records with quoted line breaks and CR/LF line endings spanning
+# the read buffer, and typed numeric values
+
+def ogr_csv_35():
+
+    content = 'id,int64,real,str\r\n'
+    for i in range(20000):
+        content += '%d,-%d00000000000,%d.25,"line ""%d""\r\nsecond, line"\r\n' % (i, i, i, i)
+    content += '\r\n-0,+12,-0.5,"last"'
+    gdal.FileFromMemBuffer('/vsimem/ogr_csv_35.csv', content)
+    gdal.FileFromMemBuffer('/vsimem/ogr_csv_35.csvt',
+                           'Integer,Integer64,Real,String')
+
+    ds = ogr.Open('/vsimem/ogr_csv_35.csv')
+    lyr = ds.GetLayer(0)
+    if lyr.GetFeatureCount() != 20001:
+        gdaltest.post_reason('fail')
+        print(lyr.GetFeatureCount())
+        return 'fail'
+    for i in range(20000):
+        f = lyr.GetNextFeature()
+        if f.GetField(0) != i or f.GetField(1) != -i * 100000000000 or \
+           f.GetField(2) != i + 0.25 or \
+           f.GetField(3) != 'line "%d"\nsecond, line' % i:
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            return 'fail'
+    f = lyr.GetNextFeature()
+    if f.GetField(0) != 0 or f.GetField(1) != 12 or f.GetField(2) != -0.5 or \
+       f.GetField(3) != 'last':
+        gdaltest.post_reason('fail')
+        f.DumpReadable()
+        return 'fail'
+    if lyr.GetNextFeature() is not None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    f = lyr.GetFeature(12345)
+    if f.GetField(3) != 'line "12344"\nsecond, line':
+        gdaltest.post_reason('fail')
+        f.DumpReadable()
+        return 'fail'
+    ds = None
+
+    gdal.Unlink('/vsimem/ogr_csv_35.csv')
+    gdal.Unlink('/vsimem/ogr_csv_35.csvt')
+
+    return 'success'
+
 ###############################################################################
 #
 
@@ -1651,6 +1700,7 @@ gdaltest_list = [
     ogr_csv_32,
     ogr_csv_33,
     ogr_csv_34,
+    ogr_csv_35,
     ogr_csv_cleanup ]
 
 if __name__ == '__main__':
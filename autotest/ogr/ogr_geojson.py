@@ -2011,6 +2011,84 @@ def ogr_geojson_41():
 
     return 'success'
 
+###############################################################################
+# Test reading a FeatureCollection incrementally from the file
+
+def ogr_geojson_42():
+
+    if gdaltest.geojson_drv is None:
+        return 'skip'
+
+    content = """\xef\xbb\xbf{
+  "type": "FeatureCollection",
+  "features" :
+  [
+    { "type": "Feature", "id": 1,
+      "properties": { "str": "a } ] \\" , { [", "int": 1 },
+      "geometry": { "type": "LineString", "coordinates": [ [2, 49], [3, 50] ] } },
+    { "type": "Feature",
+      "properties": { "str": "no geometry member" } },
+    { "type": "Feature",
+      "properties": { "str": "b", "real": 1.5, "list": [ 1, 2 ] },
+      "geometry": null },
+    { "type": "Feature", "id": 12345678901,
+      "properties": { "str": "c" },
+      "geometry": { "type": "LineString", "coordinates": [ [4, 51], [5, 52] ] } }
+  ],
+  "crs": { "type": "name", "properties": { "name": "urn:ogc:def:crs:EPSG::4322" } }
+}"""
+    gdal.FileFromMemBuffer('/vsimem/ogr_geojson_42.json', content)
+
+    res = []
+    for min_size in [ None, '0' ]:
+        gdal.SetConfigOption('GEOJSON_STREAMING_MIN_SIZE', min_size)
+        gdal.PushErrorHandler('CPLQuietErrorHandler')
+        ds = ogr.Open('/vsimem/ogr_geojson_42.json')
+        gdal.PopErrorHandler()
+        gdal.SetConfigOption('GEOJSON_STREAMING_MIN_SIZE', None)
+        if ds is None:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        lyr = ds.GetLayer(0)
+        if lyr.GetSpatialRef().ExportToWkt().find('4322') < 0:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        out = [ lyr.GetFeatureCount(), lyr.GetGeomType(),
+                lyr.GetMetadataItem(ogr.OLMD_FID64),
+                [ lyr.GetLayerDefn().GetFieldDefn(i).GetName() + ':' +
+                  str(lyr.GetLayerDefn().GetFieldDefn(i).GetType())
+                  for i in range(lyr.GetLayerDefn().GetFieldCount()) ] ]
+        for i in range(2):
+            lyr.ResetReading()
+            gdal.PushErrorHandler('CPLQuietErrorHandler')
+            feat = lyr.GetNextFeature()
+            while feat is not None:
+                geom = feat.GetGeometryRef()
+                if geom is not None:
+                    geom = geom.ExportToWkt()
+                out.append([ feat.GetFID(), geom ] +
+                           [ feat.GetField(j) for j in range(feat.GetFieldCount()) ])
+                feat = lyr.GetNextFeature()
+            gdal.PopErrorHandler()
+        res.append(out)
+        ds = None
+
+    gdal.Unlink('/vsimem/ogr_geojson_42.json')
+
+    if res[0] != res[1]:
+        gdaltest.post_reason('fail')
+        print(res[0])
+        print(res[1])
+        return 'fail'
+    if res[1][0] != 3 or res[1][1] != ogr.wkbLineString or res[1][2] != 'YES' or \
+       len(res[1]) != 4 + 2 * 3 or res[1][4][0] != 1 or res[1][4][2] != 'a } ] " , { [' or \
+       res[1][6][0] != 12345678901:
+        gdaltest.post_reason('fail')
+        print(res[1])
+        return 'fail'
+
+    return 'success'
+
 
 gdaltest_list = [ 
     ogr_geojson_1,
@@ -2054,6 +2132,7 @@ gdaltest_list = [
     ogr_geojson_39,
     ogr_geojson_40,
     ogr_geojson_41,
+    ogr_geojson_42,
     ogr_geojson_cleanup ]
 
 if __name__ == '__main__':
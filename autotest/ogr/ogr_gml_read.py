@@ -3848,6 +3848,117 @@ def ogr_gml_74():
 
     return 'success'
 
+###############################################################################
+# Test FEATURE_INDEX open option
+
+def ogr_gml_75_dump(ds):
+    ret = []
+    for i in range(ds.GetLayerCount()):
+        lyr = ds.GetLayer(i)
+        lyr.SetSpatialFilterRect(10.5, -1, 20.5, 1)
+        for feat in lyr:
+            geom = feat.GetGeometryRef()
+            if geom is not None:
+                geom = geom.ExportToWkt()
+            ret.append((lyr.GetName(), feat.GetFID(), feat.GetField('name'), geom))
+    return ret
+
+def ogr_gml_75_debug_handler(eErrClass, err_no, msg):
+    if eErrClass == gdal.CE_Debug and msg.find('Feature index: ') >= 0:
+        # "Feature index: X features not parsed, Y features parsed but not built"
+        tokens = msg[msg.find('Feature index: '):].split(' ')
+        gdaltest.ogr_gml_75_not_parsed += int(tokens[2])
+        gdaltest.ogr_gml_75_not_built += int(tokens[6])
+
+def ogr_gml_75():
+
+    if not gdaltest.have_gml_reader:
+        return 'skip'
+
+    # 'pts' has gml:id that map to stable FIDs, 'lines' has not, and some
+    # features have no geometry.
+    f = open('tmp/ogr_gml_75.gml', 'wt')
+    f.write("""<?xml version="1.0" encoding="utf-8" ?>
+<ogr:FeatureCollection xmlns:ogr="http://ogr.maptools.org/" xmlns:gml="http://www.opengis.net/gml">
+""")
+    for i in range(40):
+        f.write('<gml:featureMember><ogr:pts gml:id="pts.%d"><ogr:name>p%d</ogr:name><ogr:geometryProperty><gml:Point><gml:coordinates>%d,0</gml:coordinates></gml:Point></ogr:geometryProperty></ogr:pts></gml:featureMember>\n' % (i, i, i))
+        if (i % 2) == 0:
+            gml_id = 'l%d' % i
+        else:
+            gml_id = 'l%dx' % i
+        f.write('<gml:featureMember><ogr:lines gml:id="%s"><ogr:name>l%d</ogr:name><ogr:geometryProperty><gml:LineString><gml:coordinates>%d,0 %d,1</gml:coordinates></gml:LineString></ogr:geometryProperty></ogr:lines></gml:featureMember>\n' % (gml_id, i, i, i))
+        if (i % 10) == 0:
+            f.write('<gml:featureMember><ogr:pts gml:id="pts.%d"><ogr:name>nogeom%d</ogr:name></ogr:pts></gml:featureMember>\n' % (1000 + i, i))
+    f.write('</ogr:FeatureCollection>\n')
+    f.close()
+
+    ds = gdal.OpenEx('tmp/ogr_gml_75.gml')
+    expected = ogr_gml_75_dump(ds)
+    ds = None
+
+    if len(expected) != 4 + 10 + 10:
+        gdaltest.post_reason('fail')
+        print(expected)
+        return 'fail'
+
+    # First open builds the index, second one loads it
+    for i in range(2):
+        gdaltest.ogr_gml_75_not_parsed = 0
+        gdaltest.ogr_gml_75_not_built = 0
+        old_val = gdal.GetConfigOption('CPL_DEBUG')
+        gdal.SetConfigOption('CPL_DEBUG', 'ON')
+        gdal.PushErrorHandler(ogr_gml_75_debug_handler)
+        ds = gdal.OpenEx('tmp/ogr_gml_75.gml', open_options = ['FEATURE_INDEX=YES'])
+        got = ogr_gml_75_dump(ds)
+        ds = None
+        gdal.PopErrorHandler()
+        gdal.SetConfigOption('CPL_DEBUG', old_val)
+
+        if got != expected:
+            gdaltest.post_reason('fail')
+            print(got)
+            return 'fail'
+
+        # 'pts' features outside of the filter, and all 'lines' features when
+        # reading 'pts' (and conversely) are not parsed. 'lines' features
+        # outside of the filter are parsed, but their geometry is not built.
+        if gdaltest.ogr_gml_75_not_parsed != 30 + 40 + 44 or \
+           gdaltest.ogr_gml_75_not_built != 30:
+            gdaltest.post_reason('fail')
+            print(gdaltest.ogr_gml_75_not_parsed)
+            print(gdaltest.ogr_gml_75_not_built)
+            return 'fail'
+
+        try:
+            os.stat('tmp/ogr_gml_75.gfi')
+        except:
+            gdaltest.post_reason('fail')
+            return 'fail'
+
+    # An out of date index must be ignored
+    f = open('tmp/ogr_gml_75.gml', 'rt')
+    content = f.read()
+    f.close()
+    f = open('tmp/ogr_gml_75.gml', 'wt')
+    f.write(content.replace('<ogr:name>p15</ogr:name>', '<ogr:name>p15 but longer</ogr:name>'))
+    f.close()
+
+    ds = gdal.OpenEx('tmp/ogr_gml_75.gml', open_options = ['FEATURE_INDEX=YES'])
+    got = ogr_gml_75_dump(ds)
+    ds = None
+
+    expected = [ (x[0], x[1], 'p15 but longer', x[3]) if x[2] == 'p15' else x for x in expected ]
+    if got != expected:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    for ext in [ 'gml', 'gfs', 'gfi' ]:
+        os.unlink('tmp/ogr_gml_75.' + ext)
+
+    return 'success'
+
 ###############################################################################
 #  Cleanup
 
@@ -4054,6 +4165,7 @@ gdaltest_list = [
     ogr_gml_72,
     ogr_gml_73,
     ogr_gml_74,
+    ogr_gml_75,
     ogr_gml_cleanup ]
 
 disabled_gdaltest_list = [ 
@@ -1859,6 +1859,202 @@ def ogr_gpkg_26():
 
     return 'success'
 
+###############################################################################
+# Test R-Tree population, and deferred R-Tree update in transactions
+
+def ogr_gpkg_27():
+
+    if gdaltest.gpkg_dr is None:
+        return 'skip'
+
+    ds = gdaltest.gpkg_dr.CreateDataSource('/vsimem/ogr_gpkg_27.gpkg')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbLineString)
+    for i in range(100):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('LINESTRING(%d %d,%d %d)' % (i, i % 10, i + 1, i % 10 + 1)))
+        lyr.CreateFeature(f)
+    f = ogr.Feature(lyr.GetLayerDefn())
+    lyr.CreateFeature(f)
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('LINESTRING EMPTY'))
+    lyr.CreateFeature(f)
+    ds = None
+
+    ds = ogr.Open('/vsimem/ogr_gpkg_27.gpkg', update = 1)
+    sql_lyr = ds.ExecuteSQL('SELECT COUNT(*) FROM rtree_test_geom')
+    f = sql_lyr.GetNextFeature()
+    if f.GetField(0) != 100:
+        gdaltest.post_reason('fail')
+        f.DumpReadable()
+        return 'fail'
+    ds.ReleaseResultSet(sql_lyr)
+
+    lyr = ds.GetLayer(0)
+    ds.StartTransaction()
+    for i in range(100):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('LINESTRING(%d 100,%d 101)' % (i, i + 1)))
+        lyr.CreateFeature(f)
+    ds.RollbackTransaction()
+
+    ds.StartTransaction()
+    for i in range(100):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('LINESTRING(%d 200,%d 201)' % (i, i + 1)))
+        lyr.CreateFeature(f)
+
+    # Spatially filtered reads must see the features not indexed yet
+    for j in range(2):
+        lyr.SetSpatialFilterRect(10.5, 200.5, 11.5, 200.6)
+        if lyr.GetFeatureCount() != 2 + j:
+            gdaltest.post_reason('fail')
+            print(lyr.GetFeatureCount())
+            return 'fail'
+        lyr.ResetReading()
+        n = 0
+        for f in lyr:
+            n = n + 1
+        if n != 2 + j:
+            gdaltest.post_reason('fail')
+            print(n)
+            return 'fail'
+        lyr.SetSpatialFilter(None)
+        if j == 0:
+            f = ogr.Feature(lyr.GetLayerDefn())
+            f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('LINESTRING(10.8 200.55,10.9 200.58)'))
+            lyr.CreateFeature(f)
+
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('POINT(1000 1000)'))
+    lyr.CreateFeature(f)
+    fid = f.GetFID()
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('LINESTRING EMPTY'))
+    lyr.CreateFeature(f)
+    lyr.DeleteFeature(fid)
+    ds.CommitTransaction()
+
+    # New features are indexed after the commit, and the insert trigger is back
+    for (sql, expected) in [ ('SELECT COUNT(*) FROM rtree_test_geom', 201),
+                             ('SELECT COUNT(*) FROM rtree_test_geom WHERE miny >= 200', 101),
+                             ("SELECT COUNT(*) FROM sqlite_master WHERE name = 'rtree_test_geom_insert'", 1) ]:
+        sql_lyr = ds.ExecuteSQL(sql)
+        f = sql_lyr.GetNextFeature()
+        if f.GetField(0) != expected:
+            gdaltest.post_reason('fail')
+            print(sql)
+            f.DumpReadable()
+            return 'fail'
+        ds.ReleaseResultSet(sql_lyr)
+
+    lyr.SetSpatialFilterRect(10.5, 200.5, 11.5, 200.6)
+    lyr.ResetReading()
+    n = 0
+    for f in lyr:
+        n = n + 1
+    if n != 3:
+        gdaltest.post_reason('fail')
+        print(n)
+        return 'fail'
+    lyr.SetSpatialFilter(None)
+
+    # Without deferring
+    gdal.SetConfigOption('OGR_GPKG_DEFERRED_SPATIAL_INDEX_UPDATE', 'NO')
+    ds.StartTransaction()
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('LINESTRING(0 300,1 301)'))
+    lyr.CreateFeature(f)
+    ds.CommitTransaction()
+    gdal.SetConfigOption('OGR_GPKG_DEFERRED_SPATIAL_INDEX_UPDATE', None)
+    sql_lyr = ds.ExecuteSQL('SELECT COUNT(*) FROM rtree_test_geom')
+    f = sql_lyr.GetNextFeature()
+    if f.GetField(0) != 202:
+        gdaltest.post_reason('fail')
+        f.DumpReadable()
+        return 'fail'
+    ds.ReleaseResultSet(sql_lyr)
+    ds = None
+
+    gdaltest.gpkg_dr.DeleteDataSource('/vsimem/ogr_gpkg_27.gpkg')
+
+    return 'success'
+
+###############################################################################
+# Test reading with several threads
+
+def ogr_gpkg_28_feature_as_tuple(f):
+    geom = f.GetGeometryRef()
+    if geom is not None:
+        geom = geom.ExportToWkt()
+    return (f.GetFID(), f.GetField('str'), f.GetField('real'), geom)
+
+def ogr_gpkg_28():
+
+    if gdaltest.gpkg_dr is None:
+        return 'skip'
+
+    ds = gdaltest.gpkg_dr.CreateDataSource('/vsimem/ogr_gpkg_28.gpkg')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbPoint)
+    lyr.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+    ds.StartTransaction()
+    for i in range(5000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetField('str', 'foo%d' % i)
+        f.SetField('real', i + 0.5)
+        if (i % 10) != 0:
+            f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i, -i)))
+        lyr.CreateFeature(f)
+    ds.CommitTransaction()
+    for i in range(1000, 2000):
+        lyr.DeleteFeature(i)
+    ds = None
+
+    ds = ogr.Open('/vsimem/ogr_gpkg_28.gpkg')
+    lyr = ds.GetLayer(0)
+    ref = [ ogr_gpkg_28_feature_as_tuple(f) for f in lyr ]
+    if len(ref) != 4000:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    ds = None
+
+    for (num_threads, ordered) in [ ('2', 'YES'), ('ALL_CPUS', 'YES'), ('3', 'NO') ]:
+        gdal.SetConfigOption('OGR_GPKG_NUM_THREADS', num_threads)
+        gdal.SetConfigOption('OGR_GPKG_PARALLEL_SCAN_ORDERED', ordered)
+        ds = ogr.Open('/vsimem/ogr_gpkg_28.gpkg')
+        lyr = ds.GetLayer(0)
+        # Interrupted read
+        for i in range(10):
+            lyr.GetNextFeature()
+        lyr.ResetReading()
+        got = [ ogr_gpkg_28_feature_as_tuple(f) for f in lyr ]
+        if lyr.GetNextFeature() is not None:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        lyr.SetSpatialFilterRect(10, -20, 20, -10)
+        filtered = [ f.GetFID() for f in lyr ]
+        ds = None
+        gdal.SetConfigOption('OGR_GPKG_NUM_THREADS', None)
+        gdal.SetConfigOption('OGR_GPKG_PARALLEL_SCAN_ORDERED', None)
+
+        if ordered == 'NO':
+            got.sort()
+            ref_sorted = sorted(ref)
+        else:
+            ref_sorted = ref
+        if got != ref_sorted:
+            gdaltest.post_reason('fail')
+            print(num_threads, ordered)
+            return 'fail'
+        if filtered != [ 12, 13, 14, 15, 16, 17, 18, 19, 20 ]:
+            gdaltest.post_reason('fail')
+            print(filtered)
+            return 'fail'
+
+    gdaltest.gpkg_dr.DeleteDataSource('/vsimem/ogr_gpkg_28.gpkg')
+
+    return 'success'
+
 ###############################################################################
 # Run test_ogrsf
 
@@ -1943,6 +2139,8 @@ gdaltest_list = [
     ogr_gpkg_24,
     ogr_gpkg_25,
     ogr_gpkg_26,
+    ogr_gpkg_27,
+    ogr_gpkg_28,
     ogr_gpkg_test_ogrsf,
     ogr_gpkg_cleanup,
 ]
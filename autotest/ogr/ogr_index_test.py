@@ -28,10 +28,12 @@
 
 import os
 import sys
+import shutil
 
 sys.path.append( '../pymod' )
 
 import gdaltest
+from osgeo import gdal
 from osgeo import ogr
 import ogrtest
 
@@ -488,6 +490,254 @@ def ogr_index_11():
 
     return 'success'
 
+###############################################################################
+# Test B-tree attribute indexes on range, BETWEEN and LIKE queries
+
+def ogr_index_12_check(lyr, where, predicate, values):
+
+    lyr.SetAttributeFilter(where)
+    lyr.ResetReading()
+    got_fids = []
+    feat = lyr.GetNextFeature()
+    while feat is not None:
+        got_fids.append(feat.GetFID())
+        feat = lyr.GetNextFeature()
+    got_fids.sort()
+
+    expected_fids = []
+    for i in range(len(values)):
+        if predicate(values[i]):
+            expected_fids.append(i)
+
+    if got_fids != expected_fids:
+        gdaltest.post_reason('failed')
+        print(where)
+        print(got_fids)
+        print(expected_fids)
+        return 'fail'
+
+    return 'success'
+
+def ogr_index_12():
+
+    ds = ogr.GetDriverByName( 'ESRI Shapefile' ).CreateDataSource('tmp/ogr_index_12.dbf')
+    lyr = ds.CreateLayer('ogr_index_12', geom_type = ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('intfield', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('realfield', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('strfield', ogr.OFTString))
+
+    # Enough features for the tree to have interior pages
+    values = []
+    for i in range(3000):
+        (intval, realval, strval) = (i % 1000, i / 10.0 - 50, 'val%04d' % (i % 500))
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetField(0, intval)
+        feat.SetField(1, realval)
+        feat.SetField(2, strval)
+        lyr.CreateFeature(feat)
+        values.append((intval, realval, strval))
+    feat = None
+
+    gdal.SetConfigOption('OGR_ATTR_INDEX_FORMAT', 'BTREE')
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_12 USING intfield')
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_12 USING realfield')
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_12 USING strfield')
+    gdal.SetConfigOption('OGR_ATTR_INDEX_FORMAT', None)
+    ds = None
+
+    for filename in ['tmp/ogr_index_12.btm', 'tmp/ogr_index_12.0.bti',
+                     'tmp/ogr_index_12.1.bti', 'tmp/ogr_index_12.2.bti']:
+        try:
+            os.stat(filename)
+        except:
+            gdaltest.post_reason("%s should exist" % filename)
+            return 'fail'
+    try:
+        os.stat('tmp/ogr_index_12.idm')
+        gdaltest.post_reason("tmp/ogr_index_12.idm shouldn't exist")
+        return 'fail'
+    except:
+        pass
+
+    # The .btm file is picked up without the configuration option
+    ds = ogr.Open('tmp/ogr_index_12.dbf')
+    lyr = ds.GetLayer(0)
+
+    lyr.SetAttributeFilter('intfield > 990')
+    if lyr.TestCapability(ogr.OLCFastFeatureCount) != 1:
+        gdaltest.post_reason('index not used')
+        return 'fail'
+
+    tests = [ ('intfield > 990', lambda v: v[0] > 990),
+              ('intfield >= 990 AND intfield < 993', lambda v: v[0] >= 990 and v[0] < 993),
+              ('intfield BETWEEN 10 AND 12', lambda v: v[0] >= 10 and v[0] <= 12),
+              ('intfield < 2.5', lambda v: v[0] < 2.5),
+              ('intfield > 997.5', lambda v: v[0] > 997.5),
+              ('intfield <= -1', lambda v: False),
+              ('intfield IN (5, 7)', lambda v: v[0] == 5 or v[0] == 7),
+              ('realfield <= -49.5', lambda v: v[1] <= -49.5),
+              ('realfield > 249.5', lambda v: v[1] > 249.5),
+              ('realfield BETWEEN -0.15 AND 0.15', lambda v: v[1] >= -0.15 and v[1] <= 0.15),
+              ("strfield = 'VAL0001'", lambda v: v[2] == 'val0001'),
+              ("strfield LIKE 'VAL049%'", lambda v: v[2].startswith('val049')),
+              ("strfield >= 'val0498'", lambda v: v[2] >= 'val0498'),
+              ("intfield = 3 OR strfield LIKE 'val0004%'", lambda v: v[0] == 3 or v[2].startswith('val0004')),
+              ("intfield < 5 AND realfield > 0", lambda v: v[0] < 5 and v[1] > 0),
+              ("intfield < 5 AND strfield <> 'val0001'", lambda v: v[0] < 5 and v[2] != 'val0001') ]
+    for (where, predicate) in tests:
+        ret = ogr_index_12_check(lyr, where, predicate, values)
+        if ret != 'success':
+            return ret
+
+    ds = None
+
+    ds = ogr.Open('tmp/ogr_index_12.dbf', update = 1)
+    ds.ExecuteSQL('DROP INDEX ON ogr_index_12')
+    ds = None
+
+    for filename in ['tmp/ogr_index_12.btm', 'tmp/ogr_index_12.0.bti',
+                     'tmp/ogr_index_12.1.bti', 'tmp/ogr_index_12.2.bti']:
+        try:
+            os.stat(filename)
+            gdaltest.post_reason("%s shouldn't exist" % filename)
+            return 'fail'
+        except:
+            pass
+
+    return 'success'
+
+###############################################################################
+# Test B-tree attribute indexes on a driver without its own index support
+
+def ogr_index_13_check(ds, sql, expected_fids):
+
+    sql_lyr = ds.ExecuteSQL(sql)
+    got_fids = []
+    feat = sql_lyr.GetNextFeature()
+    while feat is not None:
+        if feat.GetGeometryRef() is None:
+            gdaltest.post_reason('failed')
+            return 'fail'
+        got_fids.append(feat.GetFID())
+        feat = sql_lyr.GetNextFeature()
+    count = sql_lyr.GetFeatureCount()
+    ds.ReleaseResultSet(sql_lyr)
+
+    if got_fids != expected_fids or count != len(expected_fids):
+        gdaltest.post_reason('failed')
+        print(sql)
+        print(got_fids)
+        print(count)
+        return 'fail'
+
+    return 'success'
+
+def ogr_index_13():
+
+    shutil.copy('data/smalltest.dgn', 'tmp/ogr_index_13.dgn')
+
+    ds = ogr.Open('tmp/ogr_index_13.dgn')
+    ds.ExecuteSQL('CREATE INDEX ON elements USING Type')
+    ds.ExecuteSQL('CREATE INDEX ON elements USING Text')
+    ds = None
+
+    filenames = ['tmp/ogr_index_13_elements.btm',
+                 'tmp/ogr_index_13_elements.0.bti',
+                 'tmp/ogr_index_13_elements.8.bti']
+    for filename in filenames:
+        try:
+            os.stat(filename)
+        except:
+            gdaltest.post_reason("%s should exist" % filename)
+            return 'fail'
+
+    ds = ogr.Open('tmp/ogr_index_13.dgn')
+
+    ret = ogr_index_13_check(ds, 'SELECT * FROM elements WHERE Type < 10 AND Level = 2', [13, 14])
+    if ret != 'success':
+        return ret
+
+    ret = ogr_index_13_check(ds, "SELECT * FROM elements WHERE Text LIKE 'demo%'", [11])
+    if ret != 'success':
+        return ret
+
+    ret = ogr_index_13_check(ds, 'SELECT * FROM elements WHERE Type BETWEEN 7 AND 14', [])
+    if ret != 'success':
+        return ret
+
+    ds.ExecuteSQL('DROP INDEX ON elements')
+    ds = None
+
+    for filename in filenames:
+        try:
+            os.stat(filename)
+            gdaltest.post_reason("%s shouldn't exist" % filename)
+            return 'fail'
+        except:
+            pass
+
+    return 'success'
+
+###############################################################################
+# Test that generic B-tree indexes are ignored once the data file has changed
+
+def ogr_index_14_debug_handler(eErrClass, err_no, msg):
+    if msg.find('Using attribute indexes') >= 0:
+        gdaltest.ogr_index_14_used = 1
+
+def ogr_index_14_used(ds):
+
+    gdaltest.ogr_index_14_used = 0
+    old_val = gdal.GetConfigOption('CPL_DEBUG')
+    gdal.SetConfigOption('CPL_DEBUG', 'ON')
+    gdal.PushErrorHandler(ogr_index_14_debug_handler)
+    sql_lyr = ds.ExecuteSQL('SELECT * FROM elements WHERE Type < 10')
+    count = sql_lyr.GetFeatureCount()
+    ds.ReleaseResultSet(sql_lyr)
+    gdal.PopErrorHandler()
+    gdal.SetConfigOption('CPL_DEBUG', old_val)
+
+    if count != 2:
+        gdaltest.post_reason('failed')
+        print(count)
+        return -1
+
+    return gdaltest.ogr_index_14_used
+
+def ogr_index_14():
+
+    shutil.copy('data/smalltest.dgn', 'tmp/ogr_index_14.dgn')
+
+    ds = ogr.Open('tmp/ogr_index_14.dgn')
+    ds.ExecuteSQL('CREATE INDEX ON elements USING Type')
+    ds = None
+
+    ds = ogr.Open('tmp/ogr_index_14.dgn')
+    if ogr_index_14_used(ds) != 1:
+        gdaltest.post_reason('index not used')
+        return 'fail'
+    ds = None
+
+    # Pretend that the file has been edited
+    st = os.stat('tmp/ogr_index_14.dgn')
+    os.utime('tmp/ogr_index_14.dgn', (st.st_atime, st.st_mtime + 10))
+
+    ds = ogr.Open('tmp/ogr_index_14.dgn')
+    if ogr_index_14_used(ds) != 0:
+        gdaltest.post_reason('stale index used')
+        return 'fail'
+
+    # Rebuilding the index makes it usable again
+    ds.ExecuteSQL('CREATE INDEX ON elements USING Type')
+    if ogr_index_14_used(ds) != 1:
+        gdaltest.post_reason('index not used')
+        return 'fail'
+
+    ds.ExecuteSQL('DROP INDEX ON elements')
+    ds = None
+
+    return 'success'
+
 ###############################################################################
 
 def ogr_index_cleanup():
@@ -515,6 +765,9 @@ def ogr_index_cleanup():
 
     ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource( 'tmp/ogr_index_10.shp' )
     ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource( 'tmp/ogr_index_11.dbf' )
+    ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource( 'tmp/ogr_index_12.dbf' )
+    os.unlink( 'tmp/ogr_index_13.dgn' )
+    os.unlink( 'tmp/ogr_index_14.dgn' )
 
     return 'success'
 
@@ -530,6 +783,9 @@ gdaltest_list = [
     ogr_index_9,
     ogr_index_10,
     ogr_index_11,
+    ogr_index_12,
+    ogr_index_13,
+    ogr_index_14,
     ogr_index_cleanup ]
 
 if __name__ == '__main__':
@@ -516,6 +516,109 @@ def ogr_join_22():
 
     return 'success'
 
+###############################################################################
+# Test that the hashed join gives the same results as per-feature lookups
+# (case insensitive string keys, NULL keys, first secondary feature wins)
+
+def ogr_join_23():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('first')
+    ogrtest.quick_create_layer_def(lyr, [['skey'], ['ikey', ogr.OFTInteger]])
+    ogrtest.quick_create_feature(lyr, [ 'a', 1 ], None)
+    ogrtest.quick_create_feature(lyr, [ 'B', 2 ], None)
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    lyr.CreateFeature(feat)
+    ogrtest.quick_create_feature(lyr, [ 'z', 26 ], None)
+
+    lyr = ds.CreateLayer('second')
+    ogrtest.quick_create_layer_def(lyr, [['skey'], ['ikey', ogr.OFTInteger64], ['val']])
+    ogrtest.quick_create_feature(lyr, [ 'A', 2, 'first_A' ], None)
+    ogrtest.quick_create_feature(lyr, [ 'b', 1, 'first_b' ], None)
+    ogrtest.quick_create_feature(lyr, [ 'a', 2, 'second_a' ], None)
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    feat.SetField('val', 'null')
+    lyr.CreateFeature(feat)
+
+    for max_mem in [ None, '0' ]:
+        gdal.SetConfigOption('OGR_SQL_JOIN_HASH_MAX_MEMORY', max_mem)
+
+        sql_lyr = ds.ExecuteSQL("SELECT second.val FROM first LEFT JOIN second ON first.skey = second.skey")
+        vals = [ f.GetField(0) for f in sql_lyr ]
+        ds.ReleaseResultSet(sql_lyr)
+        if vals != [ 'first_A', 'first_b', None, None ]:
+            gdaltest.post_reason('fail')
+            print(max_mem)
+            print(vals)
+            gdal.SetConfigOption('OGR_SQL_JOIN_HASH_MAX_MEMORY', None)
+            return 'fail'
+
+        sql_lyr = ds.ExecuteSQL("SELECT second.val FROM first LEFT JOIN second ON second.ikey = first.ikey")
+        vals = [ f.GetField(0) for f in sql_lyr ]
+        ds.ReleaseResultSet(sql_lyr)
+        if vals != [ 'first_b', 'first_A', None, None ]:
+            gdaltest.post_reason('fail')
+            print(max_mem)
+            print(vals)
+            gdal.SetConfigOption('OGR_SQL_JOIN_HASH_MAX_MEMORY', None)
+            return 'fail'
+
+    gdal.SetConfigOption('OGR_SQL_JOIN_HASH_MAX_MEMORY', None)
+
+    return 'success'
+
+###############################################################################
+# Test that the hashed join follows the case sensitivity of the attribute
+# filter of the secondary layer, and sees changes made between passes
+
+def ogr_join_24():
+
+    drv = ogr.GetDriverByName('SQLite')
+    if drv is None:
+        return 'skip'
+
+    ds = drv.CreateDataSource('tmp/ogr_join_24.sqlite')
+    lyr = ds.CreateLayer('first', geom_type = ogr.wkbNone)
+    ogrtest.quick_create_layer_def(lyr, [['skey']])
+    for skey in [ 'a', 'B', 'c' ]:
+        ogrtest.quick_create_feature(lyr, [ skey ], None)
+
+    lyr = ds.CreateLayer('second', geom_type = ogr.wkbNone)
+    ogrtest.quick_create_layer_def(lyr, [['skey'], ['val']])
+    ogrtest.quick_create_feature(lyr, [ 'A', 'A' ], None)
+    ogrtest.quick_create_feature(lyr, [ 'a', 'a' ], None)
+    ogrtest.quick_create_feature(lyr, [ 'b', 'b' ], None)
+
+    # SQLite compares strings case sensitively
+    for max_mem in [ None, '0' ]:
+        gdal.SetConfigOption('OGR_SQL_JOIN_HASH_MAX_MEMORY', max_mem)
+        sql_lyr = ds.ExecuteSQL("SELECT second.val FROM first LEFT JOIN second ON first.skey = second.skey", dialect = 'OGRSQL')
+        vals = [ f.GetField(0) for f in sql_lyr ]
+        ds.ReleaseResultSet(sql_lyr)
+        gdal.SetConfigOption('OGR_SQL_JOIN_HASH_MAX_MEMORY', None)
+        if vals != [ 'a', None, None ]:
+            gdaltest.post_reason('fail')
+            print(max_mem)
+            print(vals)
+            return 'fail'
+
+    sql_lyr = ds.ExecuteSQL("SELECT second.val FROM first LEFT JOIN second ON first.skey = second.skey", dialect = 'OGRSQL')
+    vals = [ f.GetField(0) for f in sql_lyr ]
+    ogrtest.quick_create_feature(lyr, [ 'c', 'c' ], None)
+    sql_lyr.ResetReading()
+    vals2 = [ f.GetField(0) for f in sql_lyr ]
+    ds.ReleaseResultSet(sql_lyr)
+    if vals != [ 'a', None, None ] or vals2 != [ 'a', None, 'c' ]:
+        gdaltest.post_reason('fail')
+        print(vals)
+        print(vals2)
+        return 'fail'
+
+    ds = None
+    drv.DeleteDataSource('tmp/ogr_join_24.sqlite')
+
+    return 'success'
+
 ###############################################################################
 
 def ogr_join_cleanup():
@@ -548,6 +651,8 @@ gdaltest_list = [
     ogr_join_20,
     ogr_join_21,
     ogr_join_22,
+    ogr_join_23,
+    ogr_join_24,
     ogr_join_cleanup ]
 
 if __name__ == '__main__':
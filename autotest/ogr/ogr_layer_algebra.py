@@ -565,6 +565,65 @@ def algebra_erase():
 
     return 'success'
 
+###############################################################################
+# Check that the worker threads and the prepared geometries do not change
+# the result, including its order.
+
+def algebra_threads():
+    if not ogrtest.have_geos():
+        return 'skip'
+
+    wrk_ds = ogr.GetDriverByName('Memory').CreateDataSource( 'wrk_threads' )
+
+    grid_A = wrk_ds.CreateLayer( 'grid_A' )
+    grid_A.CreateField( ogr.FieldDefn("A", ogr.OFTInteger) )
+    grid_B = wrk_ds.CreateLayer( 'grid_B' )
+    grid_B.CreateField( ogr.FieldDefn("B", ogr.OFTInteger) )
+
+    for i in range(20):
+        for j in range(20):
+            feat = ogr.Feature( grid_A.GetLayerDefn() )
+            feat.SetField('A', i * 20 + j)
+            feat.SetGeometryDirectly( ogr.CreateGeometryFromWkt( 'POLYGON((%d %d,%d %d,%d %d,%d %d,%d %d))' %
+                (i, j, i, j + 1, i + 1, j + 1, i + 1, j, i, j) ) )
+            grid_A.CreateFeature( feat )
+    for i in range(7):
+        for j in range(7):
+            feat = ogr.Feature( grid_B.GetLayerDefn() )
+            feat.SetField('B', i * 7 + j)
+            x = i * 3 + 0.5
+            y = j * 3 + 0.5
+            feat.SetGeometryDirectly( ogr.CreateGeometryFromWkt( 'POLYGON((%f %f,%f %f,%f %f,%f %f,%f %f))' %
+                (x, y, x, y + 2.2, x + 2.2, y + 2.2, x + 2.2, y, x, y) ) )
+            grid_B.CreateFeature( feat )
+
+    for method in [ 'Intersection', 'Union', 'SymDifference', 'Identity', 'Update', 'Clip', 'Erase' ]:
+        ref = wrk_ds.CreateLayer( 'ref' )
+        err = getattr(grid_A, method)( grid_B, ref )
+        if err != 0:
+            gdaltest.post_reason( 'got non-zero result code '+str(err)+' from Layer.'+method )
+            return 'fail'
+        if ref.GetFeatureCount() == 0:
+            gdaltest.post_reason( 'Layer.'+method+' returned no feature' )
+            return 'fail'
+
+        for options in [ ['NUM_THREADS=4'], ['USE_PREPARED_GEOMETRIES=NO'] ]:
+            res = wrk_ds.CreateLayer( 'res' )
+            err = getattr(grid_A, method)( grid_B, res, options = options )
+            if err != 0:
+                gdaltest.post_reason( 'got non-zero result code '+str(err)+' from Layer.'+method )
+                return 'fail'
+            if not is_same(ref, res):
+                gdaltest.post_reason( 'Layer.'+method+' with '+options[0]+' gives a different result' )
+                return 'fail'
+            wrk_ds.DeleteLayer( wrk_ds.GetLayerCount() - 1 )
+
+        wrk_ds.DeleteLayer( wrk_ds.GetLayerCount() - 1 )
+
+    wrk_ds = None
+
+    return 'success'
+
 def algebra_cleanup():
     if not ogrtest.have_geos():
         return 'skip'
@@ -591,6 +650,7 @@ gdaltest_list = [
     algebra_update,
     algebra_clip,
     algebra_erase,
+    algebra_threads,
     algebra_cleanup,
     ]
 
@@ -1306,6 +1306,55 @@ def ogr_openfilegdb_15():
         return 'fail'
     return 'success'
 
+###############################################################################
+# Test spatial filtering with the .spx spatial index
+
+def ogr_openfilegdb_16():
+
+    # The spatial index is used instead of building the in-memory one
+    ds = ogr.Open('data/testopenfilegdb92.gdb.zip')
+    lyr = ds.GetLayerByName('several_polygons')
+    lyr.SetSpatialFilterRect(0.25,0.25,0.5,0.5)
+    if get_spi_state(ds, lyr) != SPI_INVALID:
+        gdaltest.post_reason('failure')
+        return 'fail'
+    fids = [ feat.GetFID() for feat in lyr ]
+    if fids != [ 1 ]:
+        gdaltest.post_reason('failure')
+        print(fids)
+        return 'fail'
+    if lyr.GetFeatureCount() != 1:
+        gdaltest.post_reason('failure')
+        return 'fail'
+    if lyr.TestCapability(ogr.OLCFastSetNextByIndex) != 0:
+        gdaltest.post_reason('failure')
+        return 'fail'
+    ds = None
+
+    # Compare with a filtering without the spatial index
+    for rect in [ (0.25,0.25,0.5,0.5), (1.25,1.25,2.5,2.5), (-1,-1,0.1,0.1),
+                  (1.5,0.5,3.5,3.5), (10,10,11,11) ]:
+        res = []
+        for use_index in [ 'YES', 'NO' ]:
+            gdal.SetConfigOption('OPENFILEGDB_USE_SPATIAL_INDEX', use_index)
+            ds = ogr.Open('data/testopenfilegdb92.gdb.zip')
+            gdal.SetConfigOption('OPENFILEGDB_USE_SPATIAL_INDEX', None)
+            for lyr_name in [ 'point', 'multipoint', 'linestring',
+                              'multilinestring', 'polygon', 'multipolygon',
+                              'several_polygons' ]:
+                lyr = ds.GetLayerByName(lyr_name)
+                lyr.SetSpatialFilterRect(rect[0], rect[1], rect[2], rect[3])
+                res.append([ feat.GetFID() for feat in lyr ])
+                res.append(lyr.GetFeatureCount())
+            ds = None
+        if res[0:len(res)/2] != res[len(res)/2:]:
+            gdaltest.post_reason('failure')
+            print(rect)
+            print(res)
+            return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # Cleanup
 
@@ -1352,6 +1401,7 @@ gdaltest_list = [
     ogr_openfilegdb_13,
     ogr_openfilegdb_14,
     ogr_openfilegdb_15,
+    ogr_openfilegdb_16,
     ogr_openfilegdb_cleanup,
     ]
 
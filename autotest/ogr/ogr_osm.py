@@ -328,6 +328,24 @@ def ogr_osm_3_sqlite_nodes():
 def ogr_osm_3_custom_compress_nodes():
     return ogr_osm_3(options = '--config OSM_COMPRESS_NODES YES')
 
+###############################################################################
+# Test ogr2ogr with --config OSM_NODES_ARRAY RAM
+
+def ogr_osm_3_nodes_array_ram():
+    return ogr_osm_3(options = '--config OSM_NODES_ARRAY RAM')
+
+###############################################################################
+# Test ogr2ogr with --config OSM_NODES_ARRAY FILE
+
+def ogr_osm_3_nodes_array_file():
+    return ogr_osm_3(options = '--config OSM_NODES_ARRAY FILE')
+
+###############################################################################
+# Test ogr2ogr with --config OSM_NUM_THREADS 4
+
+def ogr_osm_3_num_threads():
+    return ogr_osm_3(options = '--config OSM_NUM_THREADS 4')
+
 ###############################################################################
 # Test optimization when reading only the points layer through a SQL request
 
@@ -692,6 +710,9 @@ gdaltest_list = [
     ogr_osm_3,
     ogr_osm_3_sqlite_nodes,
     ogr_osm_3_custom_compress_nodes,
+    ogr_osm_3_nodes_array_ram,
+    ogr_osm_3_nodes_array_file,
+    ogr_osm_3_num_threads,
     ogr_osm_4,
     ogr_osm_5,
     ogr_osm_6,
@@ -4833,6 +4833,80 @@ def ogr_pg_78():
 
     return 'success'
 
+###############################################################################
+# Test PG_INSERT_BATCH_SIZE and PG_USE_COPY_BINARY
+
+def ogr_pg_79():
+
+    if gdaltest.pg_ds is None:
+        return 'skip'
+
+    for (option, value) in [ ('PG_INSERT_BATCH_SIZE', '7'), ('PG_USE_COPY_BINARY', 'YES') ]:
+        gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_79' )
+        # COPY is selected at layer creation
+        gdal.SetConfigOption(option, value)
+        if option == 'PG_USE_COPY_BINARY':
+            gdal.SetConfigOption('PG_USE_COPY', 'YES')
+        else:
+            gdal.SetConfigOption('PG_USE_COPY', 'NO')
+        lyr = gdaltest.pg_ds.CreateLayer('ogr_pg_79', geom_type = ogr.wkbPoint)
+        lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+        fld_defn = ogr.FieldDefn('bool', ogr.OFTInteger)
+        fld_defn.SetSubType(ogr.OFSTBoolean)
+        lyr.CreateField(fld_defn)
+        lyr.CreateField(ogr.FieldDefn('int64', ogr.OFTInteger64))
+        lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+        fld_defn = ogr.FieldDefn('str', ogr.OFTString)
+        fld_defn.SetWidth(5)
+        lyr.CreateField(fld_defn)
+
+        for i in range(20):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            # Sparse features, to change the list of columns
+            if (i % 5) != 4:
+                f.SetField('int', i)
+                f.SetField('bool', i % 2)
+                f.SetField('int64', 1234567890123 + i)
+                f.SetField('real', i + 0.5)
+                f.SetField('str', '%02d\xc3\xa9\t\\xyz' % i)
+                f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i, -i)))
+            lyr.CreateFeature(f)
+        gdal.SetConfigOption(option, None)
+        gdal.SetConfigOption('PG_USE_COPY', gdaltest.pg_use_copy)
+
+        # Reading flushes the pending rows
+        if lyr.GetFeatureCount() != 20:
+            gdaltest.post_reason('fail')
+            print(option)
+            return 'fail'
+
+        sql_lyr = gdaltest.pg_ds.ExecuteSQL('SELECT * FROM ogr_pg_79 ORDER BY int')
+        i = 0
+        for f in sql_lyr:
+            if f.IsFieldSet('int') == 0:
+                continue
+            while (i % 5) == 4:
+                i = i + 1
+            if f.GetField('int') != i or f.GetField('bool') != i % 2 or \
+               f.GetField('int64') != 1234567890123 + i or \
+               f.GetField('real') != i + 0.5 or \
+               f.GetField('str') != ('%02d\xc3\xa9\t\\xyz' % i)[0:6] or \
+               f.GetGeometryRef().ExportToWkt() != 'POINT (%d %d)' % (i, -i):
+                gdaltest.post_reason('fail')
+                print(option)
+                f.DumpReadable()
+                gdaltest.pg_ds.ReleaseResultSet(sql_lyr)
+                return 'fail'
+            i = i + 1
+        gdaltest.pg_ds.ReleaseResultSet(sql_lyr)
+        if i != 19:
+            gdaltest.post_reason('fail')
+            print(option)
+            print(i)
+            return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # 
 
@@ -4891,6 +4965,7 @@ def ogr_pg_table_cleanup():
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_77_2' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_78' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_78_2' )
+    gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_79' )
     
     # Drop second 'tpoly' from schema 'AutoTest-schema' (do NOT quote names here)
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:AutoTest-schema.tpoly' )
@@ -5001,6 +5076,7 @@ gdaltest_list_internal = [
     ogr_pg_76,
     ogr_pg_77,
     ogr_pg_78,
+    ogr_pg_79,
     ogr_pg_cleanup ]
 
 DISABLED_gdaltest_list_internal = [ 
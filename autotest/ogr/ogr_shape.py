@@ -4118,6 +4118,159 @@ def ogr_shape_86():
 
     return 'success'
 
+###############################################################################
+# Test the packed Hilbert R-tree spatial index (.hrx)
+
+def ogr_shape_87():
+
+    ds = ogr.GetDriverByName('ESRI Shapefile').CreateDataSource('/vsimem/ogr_shape_87.shp')
+    lyr = ds.CreateLayer('ogr_shape_87', geom_type = ogr.wkbPolygon)
+    for i in range(1000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i % 100 != 0:
+            x = (i * 37) % 100
+            y = (i * 11) % 50 + (i % 7) * 0.1
+            f.SetGeometryDirectly(ogr.CreateGeometryFromWkt(
+                'POLYGON((%f %f,%f %f,%f %f,%f %f))' % (x, y, x + 0.5, y, x + 0.5, y + 2, x, y)))
+        lyr.CreateFeature(f)
+        f = None
+
+    rects = [ (10, 10, 20, 20), (-5, -5, 0.2, 0.2), (99.9, 0, 200, 100),
+              (50, 25, 50.1, 25.1), (-10, -10, 110, 60), (200, 200, 300, 300) ]
+    expected = []
+    for rect in rects:
+        lyr.SetSpatialFilterRect(rect[0], rect[1], rect[2], rect[3])
+        expected.append([ f.GetFID() for f in lyr if f.GetGeometryRef() is not None ])
+    lyr.SetSpatialFilter(None)
+
+    ds.ExecuteSQL('CREATE SPATIAL INDEX ON ogr_shape_87 TYPE HRX')
+    if gdal.VSIStatL('/vsimem/ogr_shape_87.hrx') is None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    if gdal.VSIStatL('/vsimem/ogr_shape_87.qix') is not None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    ds = None
+
+    ds = ogr.Open('/vsimem/ogr_shape_87.shp', update = 1)
+    lyr = ds.GetLayer(0)
+    if lyr.TestCapability(ogr.OLCFastSpatialFilter) != 1:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    for i in range(len(rects)):
+        rect = rects[i]
+        lyr.SetSpatialFilterRect(rect[0], rect[1], rect[2], rect[3])
+        got = [ f.GetFID() for f in lyr if f.GetGeometryRef() is not None ]
+        if got != expected[i]:
+            gdaltest.post_reason('fail')
+            print(rect)
+            print(got)
+            print(expected[i])
+            return 'fail'
+    lyr.SetSpatialFilter(None)
+
+    # Creating a .qix replaces the .hrx
+    ds.ExecuteSQL('CREATE SPATIAL INDEX ON ogr_shape_87 TYPE QIX')
+    if gdal.VSIStatL('/vsimem/ogr_shape_87.hrx') is not None or \
+       gdal.VSIStatL('/vsimem/ogr_shape_87.qix') is None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    ds.ExecuteSQL('CREATE SPATIAL INDEX ON ogr_shape_87 TYPE HRX')
+    ds.ExecuteSQL('DROP SPATIAL INDEX ON ogr_shape_87')
+    if gdal.VSIStatL('/vsimem/ogr_shape_87.hrx') is not None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    ds = None
+
+    return 'success'
+
+###############################################################################
+# Test that editing a layer removes both the .qix and the .hrx, including
+# an out of date .hrx
+
+def ogr_shape_88_copy(src, dst):
+    f = gdal.VSIFOpenL(src, 'rb')
+    data = gdal.VSIFReadL(1, gdal.VSIStatL(src).size, f)
+    gdal.VSIFCloseL(f)
+    f = gdal.VSIFOpenL(dst, 'wb')
+    gdal.VSIFWriteL(data, 1, len(data), f)
+    gdal.VSIFCloseL(f)
+
+def ogr_shape_88():
+
+    ds = ogr.GetDriverByName('ESRI Shapefile').CreateDataSource('/vsimem/ogr_shape_88.shp')
+    lyr = ds.CreateLayer('ogr_shape_88', geom_type = ogr.wkbPoint)
+    for i in range(10):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i, i)))
+        lyr.CreateFeature(f)
+        f = None
+
+    # Get a .qix and a .hrx side by side
+    ds.ExecuteSQL('CREATE SPATIAL INDEX ON ogr_shape_88 TYPE QIX')
+    ogr_shape_88_copy('/vsimem/ogr_shape_88.qix', '/vsimem/ogr_shape_88_saved.qix')
+    ds.ExecuteSQL('CREATE SPATIAL INDEX ON ogr_shape_88 TYPE HRX')
+    ds = None
+    ogr_shape_88_copy('/vsimem/ogr_shape_88_saved.qix', '/vsimem/ogr_shape_88.qix')
+    gdal.Unlink('/vsimem/ogr_shape_88_saved.qix')
+    if gdal.VSIStatL('/vsimem/ogr_shape_88.qix') is None or \
+       gdal.VSIStatL('/vsimem/ogr_shape_88.hrx') is None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    ds = ogr.Open('/vsimem/ogr_shape_88.shp', update = 1)
+    lyr = ds.GetLayer(0)
+    f = lyr.GetFeature(0)
+    f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('POINT(100 100)'))
+    lyr.SetFeature(f)
+    f = None
+    ds = None
+
+    if gdal.VSIStatL('/vsimem/ogr_shape_88.qix') is not None or \
+       gdal.VSIStatL('/vsimem/ogr_shape_88.hrx') is not None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # Make the .hrx out of date, as if another application had added a shape
+    ds = ogr.Open('/vsimem/ogr_shape_88.shp', update = 1)
+    ds.ExecuteSQL('CREATE SPATIAL INDEX ON ogr_shape_88 TYPE HRX')
+    ds = None
+    ogr_shape_88_copy('/vsimem/ogr_shape_88.hrx', '/vsimem/ogr_shape_88_saved.hrx')
+    ds = ogr.Open('/vsimem/ogr_shape_88.shp', update = 1)
+    lyr = ds.GetLayer(0)
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('POINT(10 10)'))
+    lyr.CreateFeature(f)
+    f = None
+    ds = None
+    ogr_shape_88_copy('/vsimem/ogr_shape_88_saved.hrx', '/vsimem/ogr_shape_88.hrx')
+    gdal.Unlink('/vsimem/ogr_shape_88_saved.hrx')
+
+    ds = ogr.Open('/vsimem/ogr_shape_88.shp', update = 1)
+    lyr = ds.GetLayer(0)
+    lyr.SetSpatialFilterRect(9.5, 9.5, 10.5, 10.5)
+    gdal.PushErrorHandler('CPLQuietErrorHandler')
+    count = lyr.GetFeatureCount()
+    gdal.PopErrorHandler()
+    if gdal.GetLastErrorMsg().find('out of date') < 0:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    if count != 1:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    lyr.SetSpatialFilter(None)
+    f = lyr.GetFeature(0)
+    lyr.SetFeature(f)
+    f = None
+    ds = None
+
+    if gdal.VSIStatL('/vsimem/ogr_shape_88.hrx') is not None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # 
 
@@ -4154,6 +4307,8 @@ def ogr_shape_cleanup():
     shape_drv.DeleteDataSource( '/vsimem/ogr_shape_83.shp' )
     shape_drv.DeleteDataSource( '/vsimem/ogr_shape_84.shp' )
     shape_drv.DeleteDataSource( '/vsimem/ogr_shape_85.shp' )
+    shape_drv.DeleteDataSource( '/vsimem/ogr_shape_87.shp' )
+    shape_drv.DeleteDataSource( '/vsimem/ogr_shape_88.shp' )
 
     return 'success'
 
@@ -4246,6 +4401,8 @@ gdaltest_list = [
     ogr_shape_84,
     ogr_shape_85,
     ogr_shape_86,
+    ogr_shape_87,
+    ogr_shape_88,
     ogr_shape_cleanup ]
 
 if __name__ == '__main__':
@@ -1245,6 +1245,109 @@ def ogr_rfc28_45():
     gdaltest.ds.ReleaseResultSet( ql )
     return 'success'
 
+###############################################################################
+# Test attribute filters mixing NULL values, short-circuited AND/OR,
+# constant sub-expressions and string functions
+
+def ogr_rfc28_46():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test')
+    lyr.CreateField(ogr.FieldDefn('i', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('r', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('s', ogr.OFTString))
+    for (i, r, s) in [ (1, 1.5, 'foo'), (2, None, 'bar'), (None, 3.5, None), (4, 4.5, 'foobar') ]:
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        if i is not None:
+            feat.SetField('i', i)
+        if r is not None:
+            feat.SetField('r', r)
+        if s is not None:
+            feat.SetField('s', s)
+        lyr.CreateFeature(feat)
+
+    tests = [ ( 'i > 1 AND r > 1', [ 4 ] ),
+              ( 'i > 1 OR r > 1', [ 1, 2, 3, 4 ] ),
+              ( 'i = 2 OR i IS NULL', [ 2, 3 ] ),
+              ( 'NOT (i IS NULL) AND s IS NOT NULL', [ 1, 2, 4 ] ),
+              ( 'i + 1 = 1 + 2 * 1', [ 2 ] ),
+              ( 'r * 2 = 2 + 1', [ 1 ] ),
+              ( 'i % 3 = 1', [ 1, 4 ] ),
+              ( 'i / 0 > 1000', [ 1, 2, 4 ] ),
+              ( 'r BETWEEN 1 AND 4', [ 1, 3 ] ),
+              ( 'i IN (1, 2 + 2)', [ 1, 4 ] ),
+              ( "CONCAT(s, 'x') = 'foox'", [ 1 ] ),
+              ( "s + s = 'barbar'", [ 2 ] ),
+              ( "SUBSTR(s, 2, 2) = 'oo'", [ 1, 4 ] ),
+              ( "SUBSTR(s, -3) = 'bar'", [ 2, 4 ] ),
+              ( "s LIKE 'foo%' AND i > 1", [ 4 ] ),
+              ( "s IN ('bar', 'foobar')", [ 2, 4 ] ),
+              ( "CAST(i AS CHARACTER) = '4'", [ 4 ] ),
+              ( "s > 'c'", [ 1, 4 ] ) ]
+
+    for (cond, expected_fids) in tests:
+        if lyr.SetAttributeFilter(cond) != 0:
+            gdaltest.post_reason('fail')
+            print(cond)
+            return 'fail'
+        fids = [ f.GetFID() + 1 for f in lyr ]
+        if fids != expected_fids:
+            gdaltest.post_reason('fail')
+            print(cond)
+            print(fids)
+            return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that attribute filters and SELECT expressions agree on IN and BETWEEN
+# when integer and floating point values are mixed
+
+def ogr_rfc28_47():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test')
+    lyr.CreateField(ogr.FieldDefn('i', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('r', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('j', ogr.OFTInteger64))
+    for (i, r) in [ (0, 0.0), (1, 1.0), (2, 2.5), (3, 3.0) ]:
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetField('i', i)
+        feat.SetField('r', r)
+        feat.SetField('j', i)
+        lyr.CreateFeature(feat)
+
+    tests = [ ( 'i IN (1, 2.5)', [ 1 ] ),
+              ( 'i IN (2.5, 1)', [ 1 ] ),
+              ( 'i IN (2.5, j)', [ 0, 1, 2, 3 ] ),
+              ( 'r IN (2.5, i)', [ 0, 1, 2, 3 ] ),
+              ( 'r IN (0.5, i + 0)', [ 0, 1, 3 ] ),
+              ( 'r IN (7.5, j)', [ 0, 1, 3 ] ),
+              ( 'r BETWEEN 0.5 AND i', [ 1, 3 ] ),
+              ( 'i BETWEEN 1 AND 2.5', [ 1, 2 ] ),
+              ( 'j BETWEEN 0 AND 0.5', [ 0 ] ) ]
+
+    for (cond, expected_fids) in tests:
+        if lyr.SetAttributeFilter(cond) != 0:
+            gdaltest.post_reason('fail')
+            print(cond)
+            return 'fail'
+        fids = [ f.GetFID() for f in lyr ]
+        lyr.SetAttributeFilter(None)
+
+        sql_lyr = ds.ExecuteSQL('SELECT %s AS x FROM test' % cond)
+        sql_fids = [ f.GetFID() for f in sql_lyr if f.GetField('x') ]
+        ds.ReleaseResultSet(sql_lyr)
+
+        if fids != expected_fids or sql_fids != expected_fids:
+            gdaltest.post_reason('fail')
+            print(cond)
+            print(fids)
+            print(sql_fids)
+            return 'fail'
+
+    return 'success'
+
 ###############################################################################
 def ogr_rfc28_cleanup():
     gdaltest.lyr = None
@@ -1304,6 +1407,8 @@ gdaltest_list = [
     ogr_rfc28_43,
     ogr_rfc28_44,
     ogr_rfc28_45,
+    ogr_rfc28_46,
+    ogr_rfc28_47,
     ogr_rfc28_cleanup ]
 
 if __name__ == '__main__':
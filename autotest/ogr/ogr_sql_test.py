@@ -1475,6 +1475,186 @@ def ogr_sql_46():
         
     return 'success'
 
+###############################################################################
+# Test ORDER BY on a layer without random access (sorted in memory, or
+# through temporary files)
+
+def ogr_sql_47():
+
+    gdal.FileFromMemBuffer('/vsimem/ogr_sql_47.csv',
+"""id,name,val,WKT
+1,c,3.5,POINT (1 1)
+2,a,,POINT (2 2)
+3,b,1.5,
+4,a,2.5,POINT (4 4)
+5,d,0.5,POINT (5 5)
+6,b,4.5,POINT (6 6)
+""")
+
+    ds = ogr.Open('/vsimem/ogr_sql_47.csv')
+    if ds.GetLayer(0).TestCapability(ogr.OLCRandomRead) != 0:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    for max_mem in [ None, '0.0000001' ]:
+        gdal.SetConfigOption('OGR_SQL_SORT_MAX_MEMORY', max_mem)
+        sql_lyr = ds.ExecuteSQL( "SELECT id, val FROM ogr_sql_47 ORDER BY name DESC, id" )
+        gdal.SetConfigOption('OGR_SQL_SORT_MAX_MEMORY', None)
+
+        ids = [ f.GetField('id') for f in sql_lyr ]
+        if ids != [ '5', '1', '3', '6', '2', '4' ]:
+            gdaltest.post_reason('fail')
+            print(max_mem)
+            print(ids)
+            ds.ReleaseResultSet(sql_lyr)
+            return 'fail'
+
+        # Read again, and with random access
+        sql_lyr.ResetReading()
+        ids = [ f.GetField('id') for f in sql_lyr ]
+        if ids != [ '5', '1', '3', '6', '2', '4' ]:
+            gdaltest.post_reason('fail')
+            print(max_mem)
+            print(ids)
+            ds.ReleaseResultSet(sql_lyr)
+            return 'fail'
+        f = sql_lyr.GetFeature(4)
+        if f.GetField('id') != '2' or f.GetFID() != 2:
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            ds.ReleaseResultSet(sql_lyr)
+            return 'fail'
+        f = sql_lyr.GetFeature(0)
+        if f.GetField('id') != '5' or f.GetGeometryRef().ExportToWkt() != 'POINT (5 5)':
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            ds.ReleaseResultSet(sql_lyr)
+            return 'fail'
+        sql_lyr.SetNextByIndex(2)
+        f = sql_lyr.GetNextFeature()
+        if f.GetField('id') != '3' or f.GetGeometryRef() is not None or f.IsFieldSet('val') == 0:
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            ds.ReleaseResultSet(sql_lyr)
+            return 'fail'
+        f = sql_lyr.GetNextFeature()
+        if f.GetField('id') != '6':
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            ds.ReleaseResultSet(sql_lyr)
+            return 'fail'
+        ds.ReleaseResultSet(sql_lyr)
+
+    ds = None
+    gdal.Unlink('/vsimem/ogr_sql_47.csv')
+
+    return 'success'
+
+###############################################################################
+# Test GROUP BY
+
+def ogr_sql_48():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test')
+    lyr.CreateField(ogr.FieldDefn('name', ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn('k', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('val', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('d', ogr.OFTDate))
+    for (name, k, val, d) in [ ('c', 1, 3.5, '2014/01/01'),
+                               ('a', 2, None, '2014/02/01'),
+                               ('b', 1, 1.5, None),
+                               ('a', 2, 2.5, '2013/01/01'),
+                               (None, None, 0.5, '2012/01/01'),
+                               ('b', 1, 4.5, '2015/01/01'),
+                               (None, None, None, None) ]:
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        if name is not None:
+            feat.SetField('name', name)
+        if k is not None:
+            feat.SetField('k', k)
+        if val is not None:
+            feat.SetField('val', val)
+        if d is not None:
+            feat.SetField('d', d)
+        lyr.CreateFeature(feat)
+
+    sql_lyr = ds.ExecuteSQL( "SELECT name, COUNT(*), COUNT(val), SUM(val), AVG(val), MIN(val), MAX(val) FROM test GROUP BY name" )
+    if sql_lyr.GetFeatureCount() != 4 or \
+       sql_lyr.GetLayerDefn().GetFieldDefn(1).GetType() != ogr.OFTInteger:
+        gdaltest.post_reason('fail')
+        ds.ReleaseResultSet(sql_lyr)
+        return 'fail'
+    expected = [ [ 'c', 1, 1, 3.5, 3.5, 3.5, 3.5 ],
+                 [ 'a', 2, 1, 2.5, 2.5, 2.5, 2.5 ],
+                 [ 'b', 2, 2, 6.0, 3.0, 1.5, 4.5 ],
+                 [ None, 2, 1, 0.5, 0.5, 0.5, 0.5 ] ]
+    got = []
+    feat = sql_lyr.GetNextFeature()
+    while feat is not None:
+        got.append( [ feat.GetField(i) for i in range(7) ] )
+        feat = sql_lyr.GetNextFeature()
+    if got != expected:
+        gdaltest.post_reason('fail')
+        print(got)
+        ds.ReleaseResultSet(sql_lyr)
+        return 'fail'
+    feat = sql_lyr.GetFeature(2)
+    if feat.GetFID() != 2 or feat.GetField('name') != 'b':
+        gdaltest.post_reason('fail')
+        feat.DumpReadable()
+        ds.ReleaseResultSet(sql_lyr)
+        return 'fail'
+    ds.ReleaseResultSet(sql_lyr)
+
+    # Several keys, ORDER BY on a key, aggregates of dates
+    sql_lyr = ds.ExecuteSQL( "SELECT k, name, COUNT(*) AS c, MIN(d), MAX(d) FROM test GROUP BY k, name ORDER BY name DESC" )
+    expected = [ [ 1, 'c', 1, '2014/01/01', '2014/01/01' ],
+                 [ 1, 'b', 2, '2015/01/01', '2015/01/01' ],
+                 [ 2, 'a', 2, '2013/01/01', '2014/02/01' ],
+                 [ None, None, 2, '2012/01/01', '2012/01/01' ] ]
+    got = []
+    feat = sql_lyr.GetNextFeature()
+    while feat is not None:
+        got.append( [ feat.GetField(i) for i in range(5) ] )
+        feat = sql_lyr.GetNextFeature()
+    ds.ReleaseResultSet(sql_lyr)
+    if got != expected:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    # Group key not in the field list, and no value to aggregate in a group
+    sql_lyr = ds.ExecuteSQL( "SELECT SUM(val) FROM test WHERE k = 2 OR k IS NULL GROUP BY name" )
+    got = []
+    feat = sql_lyr.GetNextFeature()
+    while feat is not None:
+        got.append( feat.GetField(0) )
+        feat = sql_lyr.GetNextFeature()
+    ds.ReleaseResultSet(sql_lyr)
+    if got != [ 2.5, 0.5 ]:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    # Errors
+    for sql in [ "SELECT k FROM test GROUP BY name",
+                 "SELECT name FROM test GROUP BY name ORDER BY k",
+                 "SELECT name, COUNT(DISTINCT k) FROM test GROUP BY name",
+                 "SELECT name FROM test GROUP BY foo" ]:
+        gdal.PushErrorHandler('CPLQuietErrorHandler')
+        sql_lyr = ds.ExecuteSQL( sql )
+        gdal.PopErrorHandler()
+        if sql_lyr is not None:
+            gdaltest.post_reason('fail')
+            print(sql)
+            ds.ReleaseResultSet(sql_lyr)
+            return 'fail'
+
+    ds = None
+
+    return 'success'
+
 def ogr_sql_cleanup():
     gdaltest.lyr = None
     gdaltest.ds.Destroy()
@@ -1531,6 +1711,8 @@ gdaltest_list = [
     ogr_sql_44,
     ogr_sql_45,
     ogr_sql_46,
+    ogr_sql_47,
+    ogr_sql_48,
     ogr_sql_cleanup ]
 
 if __name__ == '__main__':
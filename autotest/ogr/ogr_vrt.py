@@ -3447,6 +3447,143 @@ def ogr_vrt_35():
 
     return 'success'
 
+###############################################################################
+# Test OGRVRTSpatialIndexedLayer
+
+def ogr_vrt_36_get_fids(lyr, filter_geom, attr_filter = None):
+    lyr.SetAttributeFilter(attr_filter)
+    lyr.SetSpatialFilter(filter_geom)
+    lyr.ResetReading()
+    fids = []
+    feat = lyr.GetNextFeature()
+    while feat is not None:
+        fids.append(feat.GetFID())
+        feat = lyr.GetNextFeature()
+    return sorted(fids)
+
+def ogr_vrt_36():
+    if gdaltest.vrt_ds is None:
+        return 'skip'
+
+    # Sequential only source
+    f = open('tmp/ogr_vrt_36.csv', 'wb')
+    f.write('id,x,y\n'.encode('ascii'))
+    for i in range(400):
+        f.write(('%d,%d,%d\n' % (i, i % 20, i // 20)).encode('ascii'))
+    f.close()
+
+    f = open('tmp/ogr_vrt_36.vrt', 'wb')
+    f.write("""<OGRVRTDataSource>
+    <OGRVRTSpatialIndexedLayer>
+        <OGRVRTLayer name="poly">
+            <SrcDataSource relativeToVRT="1">../data/poly.shp</SrcDataSource>
+        </OGRVRTLayer>
+        <IndexFile relativeToVRT="1">ogr_vrt_36_poly.spix</IndexFile>
+    </OGRVRTSpatialIndexedLayer>
+    <OGRVRTSpatialIndexedLayer>
+        <OGRVRTLayer name="points">
+            <SrcDataSource relativeToVRT="1">ogr_vrt_36.csv</SrcDataSource>
+            <SrcLayer>ogr_vrt_36</SrcLayer>
+            <GeometryType>wkbPoint</GeometryType>
+            <GeometryField encoding="PointFromColumns" x="x" y="y"/>
+            <Field name="id" type="Integer"/>
+        </OGRVRTLayer>
+        <IndexFile relativeToVRT="1">ogr_vrt_36_points.spix</IndexFile>
+    </OGRVRTSpatialIndexedLayer>
+</OGRVRTDataSource>""".encode('ascii'))
+    f.close()
+
+    src_ds = ogr.Open('data/poly.shp')
+    src_lyr = src_ds.GetLayer(0)
+
+    filters = [ ogr.CreateGeometryFromWkt('POLYGON((479750 4764500,479750 4765000,480500 4765000,480500 4764500,479750 4764500))'),
+                ogr.CreateGeometryFromWkt('POLYGON((0 0,0 1,1 1,1 0,0 0))'),
+                ogr.CreateGeometryFromWkt('POLYGON((478000 4762000,478000 4766000,482000 4766000,482000 4762000,478000 4762000))') ]
+
+    for i in range(2):
+        ds = ogr.Open('tmp/ogr_vrt_36.vrt')
+        lyr = ds.GetLayerByName('poly')
+        if i == 0 and lyr.TestCapability(ogr.OLCFastSpatialFilter) != 0:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        for filter_geom in filters:
+            for attr_filter in [ None, 'EAS_ID > 170' ]:
+                expected = ogr_vrt_36_get_fids(src_lyr, filter_geom, attr_filter)
+                got = ogr_vrt_36_get_fids(lyr, filter_geom, attr_filter)
+                if got != expected:
+                    gdaltest.post_reason('fail')
+                    print(i, filter_geom.ExportToWkt(), attr_filter)
+                    print(expected)
+                    print(got)
+                    return 'fail'
+        if lyr.TestCapability(ogr.OLCFastSpatialFilter) != 1:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        if lyr.GetFeatureCount() != len(ogr_vrt_36_get_fids(src_lyr, filters[2], 'EAS_ID > 170')):
+            gdaltest.post_reason('fail')
+            return 'fail'
+        lyr.SetSpatialFilter(None)
+        lyr.SetAttributeFilter(None)
+        if lyr.GetFeatureCount() != 10:
+            gdaltest.post_reason('fail')
+            return 'fail'
+
+        lyr = ds.GetLayerByName('points')
+        lyr.SetSpatialFilterRect(2.5, 3.5, 5.5, 4.5)
+        ids = []
+        feat = lyr.GetNextFeature()
+        while feat is not None:
+            ids.append(feat.GetField('id'))
+            feat = lyr.GetNextFeature()
+        if ids != [ 83, 84, 85 ]:
+            gdaltest.post_reason('fail')
+            print(ids)
+            return 'fail'
+        lyr.SetAttributeFilter('id <> 84')
+        if lyr.GetFeatureCount() != 2:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        ds = None
+
+        if os.stat('tmp/ogr_vrt_36_poly.spix').st_size != 40 + 10 * 48:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        if os.stat('tmp/ogr_vrt_36_points.spix').st_size != 40 + 400 * 48:
+            gdaltest.post_reason('fail')
+            return 'fail'
+
+    src_ds = None
+
+    # Same size edit of the source in the same second as the index
+    f = open('tmp/ogr_vrt_36.csv', 'wb')
+    f.write('id,x,y\n'.encode('ascii'))
+    for i in range(400):
+        f.write(('%d,%d,%d\n' % (i, (i + 1) % 20, i // 20)).encode('ascii'))
+    f.close()
+    spix_mtime = os.stat('tmp/ogr_vrt_36_points.spix').st_mtime
+    os.utime('tmp/ogr_vrt_36.csv', (spix_mtime, spix_mtime))
+
+    ds = ogr.Open('tmp/ogr_vrt_36.vrt')
+    lyr = ds.GetLayerByName('points')
+    lyr.SetSpatialFilterRect(2.5, 3.5, 5.5, 4.5)
+    ids = []
+    feat = lyr.GetNextFeature()
+    while feat is not None:
+        ids.append(feat.GetField('id'))
+        feat = lyr.GetNextFeature()
+    if ids != [ 82, 83, 84 ]:
+        gdaltest.post_reason('fail')
+        print(ids)
+        return 'fail'
+    ds = None
+
+    os.unlink('tmp/ogr_vrt_36.csv')
+    os.unlink('tmp/ogr_vrt_36.vrt')
+    os.unlink('tmp/ogr_vrt_36_poly.spix')
+    os.unlink('tmp/ogr_vrt_36_points.spix')
+
+    return 'success'
+
 ###############################################################################
 # 
 
@@ -3511,6 +3648,7 @@ gdaltest_list = [
     ogr_vrt_33,
     ogr_vrt_34,
     ogr_vrt_35,
+    ogr_vrt_36,
     ogr_vrt_cleanup ]
 
 if __name__ == '__main__':
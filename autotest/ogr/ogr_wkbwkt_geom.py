@@ -633,6 +633,46 @@ def ogr_wkbwkt_export_wkt_iso_multipoint():
 
     return 'success'
 
+###############################################################################
+# Test that coordinate arrays are byte swapped properly in both directions,
+# including odd point counts and 3D vertices.
+
+def ogr_wkbwkt_test_wkb_byte_order():
+
+    import struct
+
+    g = ogr.CreateGeometryFromWkt('LINESTRING (1 2,3 4,5 6)')
+    wkb = g.ExportToWkb(ogr.wkbXDR)
+    expected = struct.pack('>BII6d', 0, 2, 3, 1, 2, 3, 4, 5, 6)
+    if wkb != expected:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    g = ogr.CreateGeometryFromWkt('LINESTRING (1 2 3,4 5 6,7 8 9)')
+    wkb = g.ExportToWkb(ogr.wkbXDR)
+    expected = struct.pack('>BII9d', 0, 0x80000002, 3, 1, 2, 3, 4, 5, 6, 7, 8, 9)
+    if wkb != expected:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    for wkt in [ 'LINESTRING (1 2,3 4,5 6)',
+                 'LINESTRING (1 2 3,4 5 6,7 8 9,10 11 12)',
+                 'POLYGON ((0 0,0 1,1 1,0 0),(0.25 0.25,0.25 0.5,0.5 0.5,0.5 0.25,0.25 0.25))',
+                 'POLYGON ((0 0 1,0 1 2,1 1 3,0 0 1))',
+                 'MULTILINESTRING ((1 2,3 4),(5 6,7 8,9 10))',
+                 'COMPOUNDCURVE ((0 0 1,1 1 2),CIRCULARSTRING (1 1 2,2 0 3,3 1 4))' ]:
+        g = ogr.CreateGeometryFromWkt(wkt)
+        for byte_order in [ ogr.wkbXDR, ogr.wkbNDR ]:
+            wkb = g.ExportToIsoWkb(byte_order)
+            g2 = ogr.CreateGeometryFromWkb(wkb)
+            if g2 is None or g2.ExportToIsoWkt() != g.ExportToIsoWkt():
+                gdaltest.post_reason('fail')
+                print(wkt)
+                print(byte_order)
+                return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # When imported build a list of units based on the files available.
 
@@ -655,6 +695,7 @@ gdaltest_list.append( ogr_wkbwkt_test_geometrycollection_wktwkb )
 gdaltest_list.append( ogr_wkbwkt_test_geometrycollection_wkt_recursion )
 gdaltest_list.append( ogr_wkbwkt_test_geometrycollection_wkb_recursion )
 gdaltest_list.append( ogr_wkbwkt_export_wkt_iso_multipoint )
+gdaltest_list.append( ogr_wkbwkt_test_wkb_byte_order )
 
 if __name__ == '__main__':
 
@@ -38,7 +38,6 @@
 #endif
 
 #define IO_CHUNK_SIZE 65536L
-#define IO_BUFFER_SIZE 1048576L
 /************************************************************************/
 /*                            subfile_source                            */
 /************************************************************************/
@@ -107,7 +106,7 @@ class subfile_source : public kdu_compressed_source {
 
           if ( bCached )
           {
-              file = (VSILFILE*)VSICreateCachedFile( (VSIVirtualHandle*)file, IO_CHUNK_SIZE, IO_BUFFER_SIZE );
+              file = (VSILFILE*)VSICreateCachedFile( (VSIVirtualHandle*)file, real_filename, IO_CHUNK_SIZE );
               if( file == NULL )
               {
                   kdu_error e;
@@ -359,13 +359,53 @@ CPLErr RawRasterBand::IReadBlock( CPL_UNUSED int nBlockXOff,
     if (pLineBuffer == NULL)
         return CE_Failure;
 
+/* -------------------------------------------------------------------- */
+/*      If the file can be memory mapped, copy directly from the        */
+/*      mapping to the user block buffer, without going through the     */
+/*      line buffer.                                                    */
+/* -------------------------------------------------------------------- */
+    const int nWordSize = GDALGetDataTypeSize(eDataType) / 8;
+    if( nLoadedScanline != nBlockYOff )
+    {
+        vsi_l_offset nReadStart = nImgOffset
+            + (vsi_l_offset)nBlockYOff * nLineOffset;
+        if( nPixelOffset < 0 )
+            nReadStart -= ABS(nPixelOffset) * (nBlockXSize-1);
+        const GByte* pabyMapped = GetMappedRange( nReadStart,
+                        ABS(nPixelOffset) * (nBlockXSize - 1) + nWordSize );
+        if( pabyMapped != NULL )
+        {
+            if( nPixelOffset < 0 )
+                pabyMapped += ABS(nPixelOffset) * (nBlockXSize-1);
+            GDALCopyWords( (void*) pabyMapped, eDataType, nPixelOffset,
+                           pImage, eDataType, nWordSize,
+                           nBlockXSize );
+
+            if( !bNativeOrder && eDataType != GDT_Byte )
+            {
+                if( GDALDataTypeIsComplex( eDataType ) )
+                {
+                    GDALSwapWords( pImage, nWordSize / 2, nBlockXSize,
+                                   nWordSize );
+                    GDALSwapWords( ((GByte *) pImage) + nWordSize / 2,
+                                   nWordSize / 2, nBlockXSize, nWordSize );
+                }
+                else
+                    GDALSwapWords( pImage, nWordSize, nBlockXSize,
+                                   nWordSize );
+            }
+
+            return CE_None;
+        }
+    }
+
     eErr = AccessLine( nBlockYOff );
 
 /* -------------------------------------------------------------------- */
 /*      Copy data from disk buffer to user block buffer.                */
 /* -------------------------------------------------------------------- */
     GDALCopyWords( pLineStart, eDataType, nPixelOffset,
-                   pImage, eDataType, GDALGetDataTypeSize(eDataType)/8,
+                   pImage, eDataType, nWordSize,
                    nBlockXSize );
 
     return eErr;
@@ -488,6 +528,23 @@ CPLErr RawRasterBand::IWriteBlock( CPL_UNUSED int nBlockXOff,
     return eErr;
 }
 
+/************************************************************************/
+/*                           GetMappedRange()                           */
+/*                                                                      */
+/*      Return a pointer to the file content in [nOffset,nOffset+nSize[ */
+/*      if the underlying VSI file can expose it without copy (memory   */
+/*      mapped local file, /vsimem/), or NULL.                          */
+/************************************************************************/
+
+const GByte *RawRasterBand::GetMappedRange( vsi_l_offset nOffset,
+                                            size_t nSize )
+{
+    if( !bIsVSIL || poDS == NULL || poDS->GetAccess() != GA_ReadOnly )
+        return NULL;
+
+    return (const GByte*) VSIFGetRangePointerL( fpRawL, nOffset, nSize );
+}
+
 /************************************************************************/
 /*                             AccessBlock()                            */
 /************************************************************************/
@@ -498,24 +555,35 @@ CPLErr RawRasterBand::AccessBlock( vsi_l_offset nBlockOff, int nBlockSize,
     int         nBytesActuallyRead;
 
 /* -------------------------------------------------------------------- */
-/*      Seek to the right block.                                        */
+/*      Use the memory mapped file content if available.                */
 /* -------------------------------------------------------------------- */
-    if( Seek( nBlockOff, SEEK_SET ) == -1 )
+    const GByte* pabyMapped = GetMappedRange( nBlockOff, nBlockSize );
+    if( pabyMapped != NULL )
     {
-        memset( pData, 0, nBlockSize );
-        return CE_None;
+        memcpy( pData, pabyMapped, nBlockSize );
     }
+    else
+    {
+/* -------------------------------------------------------------------- */
+/*      Seek to the right block.                                        */
+/* -------------------------------------------------------------------- */
+        if( Seek( nBlockOff, SEEK_SET ) == -1 )
+        {
+            memset( pData, 0, nBlockSize );
+            return CE_None;
+        }
 
 /* -------------------------------------------------------------------- */
 /*      Read the block.                                                 */
 /* -------------------------------------------------------------------- */
-    nBytesActuallyRead = Read( pData, 1, nBlockSize );
-    if( nBytesActuallyRead < nBlockSize )
-    {
+        nBytesActuallyRead = Read( pData, 1, nBlockSize );
+        if( nBytesActuallyRead < nBlockSize )
+        {
 
-        memset( ((GByte *) pData) + nBytesActuallyRead, 
-                0, nBlockSize - nBytesActuallyRead );
-        return CE_None;
+            memset( ((GByte *) pData) + nBytesActuallyRead, 
+                    0, nBlockSize - nBytesActuallyRead );
+            return CE_None;
+        }
     }
 
 /* -------------------------------------------------------------------- */
@@ -106,6 +106,7 @@ protected:
 
     CPLErr      AccessBlock( vsi_l_offset nBlockOff, int nBlockSize,
                              void * pData );
+    const GByte *GetMappedRange( vsi_l_offset nOffset, size_t nSize );
     int         IsSignificantNumberOfLinesLoaded( int nLineOff, int nLines );
     void        Initialize();
 
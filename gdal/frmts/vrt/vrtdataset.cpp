@@ -747,6 +747,19 @@ GDALDataset *VRTDataset::Open( GDALOpenInfo * poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                            DestroyTree()                             */
+/************************************************************************/
+
+static void DestroyTree( CPLXMLNode *psTree, int bWarped )
+
+{
+    if( bWarped )
+        CPLDestroyXMLNode( psTree );
+    else
+        CPLDestroyXMLArenaTree( psTree );
+}
+
 /************************************************************************/
 /*                              OpenXML()                               */
 /*                                                                      */
@@ -763,7 +776,13 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
  /* -------------------------------------------------------------------- */
     CPLXMLNode	*psTree;
 
-    psTree = CPLParseXMLString( pszXML );
+    /* VRTWarpedDataset::XMLInit() modifies the tree, so only the other */
+    /* datasets can use the faster read-only tree */
+    int bWarped = strstr(pszXML,"VRTWarpedDataset") != NULL;
+    if( bWarped )
+        psTree = CPLParseXMLString( pszXML );
+    else
+        psTree = CPLParseXMLStringInArena( pszXML );
 
     if( psTree == NULL )
         return NULL;
@@ -773,7 +792,7 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
     {
         CPLError( CE_Failure, CPLE_AppDefined,
                   "Missing VRTDataset element." );
-        CPLDestroyXMLNode( psTree );
+        DestroyTree( psTree, bWarped );
         return NULL;
     }
 
@@ -784,7 +803,7 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
         CPLError( CE_Failure, CPLE_AppDefined, 
                   "Missing one of rasterXSize, rasterYSize or bands on"
                   " VRTDataset." );
-        CPLDestroyXMLNode( psTree );
+        DestroyTree( psTree, bWarped );
         return NULL;
     }
 
@@ -797,11 +816,11 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
     
     if ( !GDALCheckDatasetDimensions(nXSize, nYSize) )
     {
-        CPLDestroyXMLNode( psTree );
+        DestroyTree( psTree, bWarped );
         return NULL;
     }
 
-    if( strstr(pszXML,"VRTWarpedDataset") != NULL )
+    if( bWarped )
         poDS = new VRTWarpedDataset( nXSize, nYSize );
     else
     {
@@ -818,7 +837,7 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
 /* -------------------------------------------------------------------- */
 /*      Try to return a regular handle on the file.                     */
 /* -------------------------------------------------------------------- */
-    CPLDestroyXMLNode( psTree );
+    DestroyTree( psTree, bWarped );
 
     return poDS;
 }
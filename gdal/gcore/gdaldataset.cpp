@@ -4084,6 +4084,31 @@ OGRLayer *GDALDataset::GetLayerByName( const char *pszName )
     return NULL;
 }
 
+/************************************************************************/
+/*                   InitializeGenericIndexSupport()                    */
+/*                                                                      */
+/*      Layers of drivers that do not manage attribute indexes          */
+/*      themselves get B-tree indexes in sidecar files, provided they   */
+/*      can fetch features by FID.                                      */
+/************************************************************************/
+
+static void InitializeGenericIndexSupport( GDALDataset *poDS,
+                                           OGRLayer *poLayer )
+
+{
+    if( poLayer->GetIndex() != NULL
+        || !poLayer->TestCapability( OLCRandomRead ) )
+        return;
+
+    CPLString osSourceFilename;
+    CPLString osIndexFilename = OGRGetGenericLayerIndexFilename( poDS,
+                                                                 poLayer,
+                                                        &osSourceFilename );
+    if( !osIndexFilename.empty()
+        && poLayer->InitializeIndexSupport( osIndexFilename ) == OGRERR_NONE )
+        poLayer->GetIndex()->SetSourceFilename( osSourceFilename );
+}
+
 /************************************************************************/
 /*                       ProcessSQLCreateIndex()                        */
 /*                                                                      */
@@ -4146,6 +4171,7 @@ OGRErr GDALDataset::ProcessSQLCreateIndex( const char *pszSQLCommand )
 /* -------------------------------------------------------------------- */
 /*      Does this layer even support attribute indexes?                 */
 /* -------------------------------------------------------------------- */
+    InitializeGenericIndexSupport( this, poLayer );
     if( poLayer->GetIndex() == NULL )
     {
         CPLError( CE_Failure, CPLE_AppDefined, 
@@ -4254,6 +4280,7 @@ OGRErr GDALDataset::ProcessSQLDropIndex( const char *pszSQLCommand )
 /* -------------------------------------------------------------------- */
 /*      Does this layer even support attribute indexes?                 */
 /* -------------------------------------------------------------------- */
+    InitializeGenericIndexSupport( this, poLayer );
     if( poLayer->GetIndex() == NULL )
     {
         CPLError( CE_Failure, CPLE_AppDefined, 
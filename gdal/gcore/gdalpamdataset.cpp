@@ -612,6 +612,8 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
 
 {
     CPLXMLNode *psTree = NULL;
+    /* XMLInit() only reads the tree, so it can be a read-only arena tree */
+    int bArenaTree = TRUE;
 
     PamInitialize();
 
@@ -646,7 +648,7 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
         {
             CPLErrorReset();
             CPLPushErrorHandler( CPLQuietErrorHandler );
-            psTree = CPLParseXMLFile( psPam->pszPamFilename );
+            psTree = CPLParseXMLFileInArena( psPam->pszPamFilename );
             CPLPopErrorHandler();
         }
     }
@@ -657,7 +659,7 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
     {
         CPLErrorReset();
         CPLPushErrorHandler( CPLQuietErrorHandler );
-        psTree = CPLParseXMLFile( psPam->pszPamFilename );
+        psTree = CPLParseXMLFileInArena( psPam->pszPamFilename );
         CPLPopErrorHandler();
     }
 
@@ -688,8 +690,9 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
         if( psSubTree != NULL )
             psSubTree = CPLCloneXMLTree( psSubTree );
 
-        CPLDestroyXMLNode( psTree );
+        CPLDestroyXMLArenaTree( psTree );
         psTree = psSubTree;
+        bArenaTree = FALSE;
     }
 
 /* -------------------------------------------------------------------- */
@@ -706,7 +709,10 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
     CPLString osVRTPath(CPLGetPath(psPam->pszPamFilename));
     eErr = XMLInit( psTree, osVRTPath );
 
-    CPLDestroyXMLNode( psTree );
+    if( bArenaTree )
+        CPLDestroyXMLArenaTree( psTree );
+    else
+        CPLDestroyXMLNode( psTree );
 
     if( eErr != CE_None )
         PamClear();
@@ -245,11 +245,13 @@ typedef struct OGRFieldDefnHS   *OGRFieldDefnH;
 typedef struct OGRFeatureDefnHS *OGRFeatureDefnH;
 typedef struct OGRFeatureHS     *OGRFeatureH;
 typedef struct OGRStyleTableHS *OGRStyleTableH;
+typedef struct OGRFeatureBatchHS *OGRFeatureBatchH;
 #else
 typedef void *OGRFieldDefnH;
 typedef void *OGRFeatureDefnH;
 typedef void *OGRFeatureH;
 typedef void *OGRStyleTableH;
+typedef void *OGRFeatureBatchH;
 #endif
 typedef struct OGRGeomFieldDefnHS *OGRGeomFieldDefnH;
 
@@ -424,6 +426,21 @@ void   CPL_DLL OGR_F_FillUnsetWithDefault( OGRFeatureH hFeat,
                                            char** papszOptions );
 int    CPL_DLL OGR_F_Validate( OGRFeatureH, int nValidateFlags, int bEmitError );
 
+/* OGRFeatureBatch */
+
+OGRFeatureBatchH CPL_DLL OGR_FB_Create( OGRFeatureDefnH ) CPL_WARN_UNUSED_RESULT;
+void   CPL_DLL OGR_FB_Destroy( OGRFeatureBatchH );
+int    CPL_DLL OGR_FB_GetFeatureCount( OGRFeatureBatchH );
+const GIntBig CPL_DLL *OGR_FB_GetFIDs( OGRFeatureBatchH );
+const GByte CPL_DLL *OGR_FB_GetFieldIsSetArray( OGRFeatureBatchH, int );
+const int CPL_DLL *OGR_FB_GetFieldAsIntegerArray( OGRFeatureBatchH, int );
+const GIntBig CPL_DLL *OGR_FB_GetFieldAsInteger64Array( OGRFeatureBatchH, int );
+const double CPL_DLL *OGR_FB_GetFieldAsDoubleArray( OGRFeatureBatchH, int );
+const GByte CPL_DLL *OGR_FB_GetFieldAsBinary( OGRFeatureBatchH, int iRow,
+                                              int iField, int *pnBytes );
+const GByte CPL_DLL *OGR_FB_GetGeomFieldAsWKB( OGRFeatureBatchH, int iRow,
+                                               int iGeomField, int *pnBytes );
+
 /* -------------------------------------------------------------------- */
 /*      ogrsf_frmts.h                                                   */
 /* -------------------------------------------------------------------- */
@@ -454,6 +471,9 @@ void     CPL_DLL OGR_L_SetSpatialFilterRectEx( OGRLayerH, int iGeomField,
 OGRErr CPL_DLL OGR_L_SetAttributeFilter( OGRLayerH, const char * );
 void   CPL_DLL OGR_L_ResetReading( OGRLayerH );
 OGRFeatureH CPL_DLL OGR_L_GetNextFeature( OGRLayerH );
+int    CPL_DLL OGR_L_GetNextFeatureBatch( OGRLayerH, OGRFeatureBatchH,
+                                          int nMaxFeatures );
+int    CPL_DLL OGR_L_GetNextFeatureInPlace( OGRLayerH, OGRFeatureH );
 OGRErr CPL_DLL OGR_L_SetNextByIndex( OGRLayerH, GIntBig );
 OGRFeatureH CPL_DLL OGR_L_GetFeature( OGRLayerH, GIntBig );
 OGRErr CPL_DLL OGR_L_SetFeature( OGRLayerH, OGRFeatureH );
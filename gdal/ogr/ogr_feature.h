@@ -270,6 +270,10 @@ class CPL_DLL OGRFeature
     OGRFeatureDefn      *poDefn;
     OGRGeometry        **papoGeometries;
     OGRField            *pauFields;
+    void                *m_pStringArena;
+
+    char               *AllocFieldString( const char * );
+    void                FreeFieldString( char * );
 
   protected: 
     char *              m_pszStyleString;
@@ -425,10 +429,110 @@ class CPL_DLL OGRFeature
     virtual void        SetStyleTable(OGRStyleTable *poStyleTable);
     virtual void        SetStyleTableDirectly(OGRStyleTable *poStyleTable);
 
+    void                Reset();
+    void                EnableStringArena();
+
     static OGRFeature  *CreateFeature( OGRFeatureDefn * );
     static void         DestroyFeature( OGRFeature * );
 };
 
+/************************************************************************/
+/*                           OGRFeatureBatch                            */
+/************************************************************************/
+
+/**
+ * A batch of features stored column by column.
+ *
+ * Each attribute field is stored as an array of "is set" flags and a
+ * column of values.  OFTInteger, OFTInteger64 and OFTReal fields use fixed
+ * width arrays of int, GIntBig and double.  OFTDate, OFTTime and
+ * OFTDateTime fields use an array of OGRField.  All other field types
+ * (strings, binary and lists) are stored as a single byte buffer with
+ * an array of GetFeatureCount()+1 offsets, list values being stored with
+ * their GetFieldAsString() representation.  Strings are not nul
+ * terminated in the buffer.
+ *
+ * Each geometry field is stored as ISO WKB in a byte buffer with an array
+ * of offsets.  Null geometries have a zero length.
+ *
+ * Batches are filled with OGRLayer::GetNextFeatureBatch().
+ *
+ * @since GDAL 2.0
+ */
+
+class CPL_DLL OGRFeatureBatch
+{
+  private:
+    typedef struct
+    {
+        GByte          *pabyIsSet;
+        GByte          *pabyValues;
+        int             nValueSize;
+        OGRFieldSubType eSubType;
+        GIntBig        *panOffsets;
+        GByte          *pabyData;
+        size_t          nDataSize;
+        size_t          nDataCapacity;
+    } OGRFeatureBatchColumn;
+
+    OGRFeatureDefn     *poDefn;
+    int                 nFieldCount;
+    int                 nGeomFieldCount;
+    int                 nFeatureCount;
+    int                 nCapacity;
+    GIntBig            *panFIDs;
+    OGRFeatureBatchColumn *pasFields;
+    OGRFeatureBatchColumn *pasGeomFields;
+
+    int                 GrowColumn( OGRFeatureBatchColumn *psCol,
+                                    int nNewCapacity );
+    GByte              *ReserveData( OGRFeatureBatchColumn *psCol,
+                                     size_t nBytes );
+    void                FreeColumn( OGRFeatureBatchColumn *psCol );
+
+  public:
+                        OGRFeatureBatch( OGRFeatureDefn * );
+                       ~OGRFeatureBatch();
+
+    OGRFeatureDefn     *GetDefnRef() { return poDefn; }
+    int                 GetFieldCount() { return nFieldCount; }
+    int                 GetGeomFieldCount() { return nGeomFieldCount; }
+
+    void                Reset();
+    int                 GetFeatureCount() { return nFeatureCount; }
+
+    const GIntBig      *GetFIDs() { return panFIDs; }
+    const GByte        *GetFieldIsSetArray( int iField );
+    int                 IsFieldSet( int iRow, int iField );
+
+    const int          *GetFieldAsIntegerArray( int iField );
+    const GIntBig      *GetFieldAsInteger64Array( int iField );
+    const double       *GetFieldAsDoubleArray( int iField );
+    const OGRField     *GetFieldAsDateTimeArray( int iField );
+    const GIntBig      *GetFieldOffsets( int iField );
+    const GByte        *GetFieldData( int iField );
+    const GByte        *GetFieldAsBinary( int iRow, int iField,
+                                          int *pnBytes );
+
+    const GIntBig      *GetGeomFieldOffsets( int iGeomField );
+    const GByte        *GetGeomFieldData( int iGeomField );
+    const GByte        *GetGeomFieldAsWKB( int iRow, int iGeomField,
+                                           int *pnBytes );
+
+    OGRFeature         *GetFeature( int iRow );
+
+    int                 AddFeature( OGRFeature *poFeature );
+
+    int                 BeginFeature( GIntBig nFID );
+    void                SetFieldInteger( int iField, int nValue );
+    void                SetFieldInteger64( int iField, GIntBig nValue );
+    void                SetFieldDouble( int iField, double dfValue );
+    void                SetFieldDateTime( int iField, const OGRField *psValue );
+    int                 SetFieldBinary( int iField, const void *pData,
+                                        size_t nBytes );
+    GByte              *ReserveGeomFieldWKB( int iGeomField, size_t nBytes );
+};
+
 /************************************************************************/
 /*                           OGRFeatureQuery                            */
 /************************************************************************/
@@ -442,6 +546,9 @@ class CPL_DLL OGRFeatureQuery
   private:
     OGRFeatureDefn *poTargetDefn;
     void           *pSWQExpr;
+    /* Built by Compile(). Holds the scratch values of Evaluate(), so a */
+    /* query must not be evaluated by several threads at the same time. */
+    void           *pSWQProgram;
 
     char          **FieldCollector( void *, char ** );
 
@@ -464,6 +571,7 @@ class CPL_DLL OGRFeatureQuery
     char      **GetUsedFields();
 
     void       *GetSWQExpr() { return pSWQExpr; }
+    void        ExpressionChanged();
 };
 
 #endif /* ndef _OGR_FEATURE_H_INCLUDED */
@@ -160,4 +160,10 @@ OGRErr OGRReadWKBGeometryType( unsigned char * pabyData,
                                OGRwkbVariant wkbVariant,
                                OGRwkbGeometryType *eGeometryType, OGRBoolean *b3D );
 
+void OGRCopyWkbDoubles( void *pDst, const void *pSrc, int nCount, int bSwap );
+void OGRReadWkbXYZ( const GByte *pabyWkb, OGRRawPoint *paoPoints,
+                    double *padfZ, int nPointCount, int bSwap );
+void OGRWriteWkbXYZ( GByte *pabyWkb, const OGRRawPoint *paoPoints,
+                     const double *padfZ, int nPointCount, int bSwap );
+
 #endif /* ndef OGR_P_H_INCLUDED */
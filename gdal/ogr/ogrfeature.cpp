@@ -37,6 +37,108 @@
 
 CPL_CVSID("$Id$");
 
+/************************************************************************/
+/*                         OGRFeatureStringArena                        */
+/*                                                                      */
+/*      Chain of memory blocks from which the strings of a feature      */
+/*      can be carved when the feature is reused from one read to the   */
+/*      next.  Strings are never freed individually: the whole arena    */
+/*      is rewound by OGRFeature::Reset().                              */
+/************************************************************************/
+
+typedef struct _OGRFeatureArenaBlock OGRFeatureArenaBlock;
+
+struct _OGRFeatureArenaBlock
+{
+    OGRFeatureArenaBlock *psNext;
+    size_t                nSize;
+    size_t                nUsed;
+};
+
+#define ARENA_BLOCK_DATA(psBlock) ((char*)((psBlock) + 1))
+#define ARENA_MIN_BLOCK_SIZE      4096
+
+static OGRFeatureArenaBlock *OGRFeatureArenaNewBlock( size_t nSize )
+{
+    OGRFeatureArenaBlock *psBlock = (OGRFeatureArenaBlock *)
+        VSIMalloc( sizeof(OGRFeatureArenaBlock) + nSize );
+    if( psBlock == NULL )
+        return NULL;
+    psBlock->psNext = NULL;
+    psBlock->nSize = nSize;
+    psBlock->nUsed = 0;
+    return psBlock;
+}
+
+static void OGRFeatureArenaFree( OGRFeatureArenaBlock *psBlock )
+{
+    while( psBlock != NULL )
+    {
+        OGRFeatureArenaBlock *psNext = psBlock->psNext;
+        VSIFree( psBlock );
+        psBlock = psNext;
+    }
+}
+
+static int OGRFeatureArenaContains( OGRFeatureArenaBlock *psBlock,
+                                    const char *pszStr )
+{
+    for( ; psBlock != NULL; psBlock = psBlock->psNext )
+    {
+        const char *pszData = ARENA_BLOCK_DATA(psBlock);
+        if( pszStr >= pszData && pszStr < pszData + psBlock->nSize )
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/************************************************************************/
+/*                          AllocFieldString()                          */
+/*                                                                      */
+/*      Duplicate a string field value, from the string arena if it     */
+/*      is enabled, or from the heap otherwise.                         */
+/************************************************************************/
+
+char *OGRFeature::AllocFieldString( const char *pszValue )
+
+{
+    if( m_pStringArena == NULL )
+        return CPLStrdup( pszValue );
+
+    OGRFeatureArenaBlock *psBlock = (OGRFeatureArenaBlock *) m_pStringArena;
+    size_t nNeeded = strlen(pszValue) + 1;
+    if( psBlock->nUsed + nNeeded > psBlock->nSize )
+    {
+        size_t nNewSize = 2 * psBlock->nSize;
+        if( nNewSize < nNeeded )
+            nNewSize = nNeeded;
+        OGRFeatureArenaBlock *psNewBlock = OGRFeatureArenaNewBlock( nNewSize );
+        if( psNewBlock == NULL )
+            return CPLStrdup( pszValue );
+        psNewBlock->psNext = psBlock;
+        m_pStringArena = psBlock = psNewBlock;
+    }
+
+    char *pszRet = ARENA_BLOCK_DATA(psBlock) + psBlock->nUsed;
+    memcpy( pszRet, pszValue, nNeeded );
+    psBlock->nUsed += nNeeded;
+    return pszRet;
+}
+
+/************************************************************************/
+/*                          FreeFieldString()                           */
+/************************************************************************/
+
+void OGRFeature::FreeFieldString( char *pszValue )
+
+{
+    if( m_pStringArena != NULL &&
+        OGRFeatureArenaContains( (OGRFeatureArenaBlock *) m_pStringArena,
+                                 pszValue ) )
+        return;
+    CPLFree( pszValue );
+}
+
 /************************************************************************/
 /*                             OGRFeature()                             */
 /************************************************************************/
@@ -61,6 +163,7 @@ OGRFeature::OGRFeature( OGRFeatureDefn * poDefnIn )
     m_pszStyleString = NULL;
     m_poStyleTable = NULL;
     m_pszTmpFieldValue = NULL;
+    m_pStringArena = NULL;
     poDefnIn->Reference();
     poDefn = poDefnIn;
 
@@ -129,7 +232,7 @@ OGRFeature::~OGRFeature()
         {
           case OFTString:
             if( pauFields[i].String != NULL )
-                VSIFree( pauFields[i].String );
+                FreeFieldString( pauFields[i].String );
             break;
 
           case OFTBinary:
@@ -165,6 +268,7 @@ OGRFeature::~OGRFeature()
     CPLFree( papoGeometries );
     CPLFree(m_pszStyleString);
     CPLFree(m_pszTmpFieldValue);
+    OGRFeatureArenaFree( (OGRFeatureArenaBlock *) m_pStringArena );
 }
 
 /************************************************************************/
@@ -239,6 +343,88 @@ void OGRFeature::DestroyFeature( OGRFeature *poFeature )
     delete poFeature;
 }
 
+/************************************************************************/
+/*                               Reset()                                */
+/************************************************************************/
+
+/**
+ * \brief Reset the feature to its just created state.
+ *
+ * All fields are unset, geometries are destroyed, the FID is set to
+ * OGRNullFID and the style string is cleared.  The field array and the
+ * string arena (see EnableStringArena()) are kept, so that the feature can
+ * be filled again without allocating them.
+ *
+ * @since GDAL 2.0
+ */
+
+void OGRFeature::Reset()
+
+{
+    int i;
+
+    for( i = 0; i < poDefn->GetFieldCount(); i++ )
+        UnsetField( i );
+
+    for( i = 0; i < poDefn->GetGeomFieldCount(); i++ )
+    {
+        delete papoGeometries[i];
+        papoGeometries[i] = NULL;
+    }
+
+    nFID = OGRNullFID;
+    CPLFree( m_pszStyleString );
+    m_pszStyleString = NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Rewind the string arena.  If it has grown into several blocks,  */
+/*      replace them by a single block large enough for all of them,    */
+/*      so that the next features fit in one block.                     */
+/* -------------------------------------------------------------------- */
+    OGRFeatureArenaBlock *psBlock = (OGRFeatureArenaBlock *) m_pStringArena;
+    if( psBlock != NULL )
+    {
+        if( psBlock->psNext != NULL )
+        {
+            size_t nTotalSize = 0;
+            for( OGRFeatureArenaBlock *psIter = psBlock; psIter != NULL;
+                 psIter = psIter->psNext )
+                nTotalSize += psIter->nSize;
+            OGRFeatureArenaFree( psBlock );
+            m_pStringArena = psBlock = OGRFeatureArenaNewBlock( nTotalSize );
+            if( psBlock == NULL )
+                m_pStringArena = OGRFeatureArenaNewBlock( ARENA_MIN_BLOCK_SIZE );
+        }
+        else
+            psBlock->nUsed = 0;
+    }
+}
+
+/************************************************************************/
+/*                         EnableStringArena()                          */
+/************************************************************************/
+
+/**
+ * \brief Allocate string field values from a per-feature arena.
+ *
+ * Once enabled, the values of OFTString fields are carved out of memory
+ * blocks owned by the feature instead of being individually allocated on
+ * the heap, and are released in bulk by Reset() or on destruction.  This
+ * is intended for features that are refilled many times, such as with
+ * OGRLayer::GetNextFeatureInPlace().  The pointers returned by
+ * GetRawFieldRef() for string fields must then not be freed or reallocated
+ * by the caller.
+ *
+ * @since GDAL 2.0
+ */
+
+void OGRFeature::EnableStringArena()
+
+{
+    if( m_pStringArena == NULL )
+        m_pStringArena = OGRFeatureArenaNewBlock( ARENA_MIN_BLOCK_SIZE );
+}
+
 /************************************************************************/
 /*                             GetDefnRef()                             */
 /************************************************************************/
@@ -1207,7 +1393,7 @@ void OGRFeature::UnsetField( int iField )
         break;
 
       case OFTString:
-        CPLFree( pauFields[iField].String );
+        FreeFieldString( pauFields[iField].String );
         break;
 
       case OFTBinary:
@@ -2573,9 +2759,9 @@ void OGRFeature::SetField( int iField, int nValue )
         sprintf( szTempBuffer, "%d", nValue );
 
         if( IsFieldSet( iField) )
-            CPLFree( pauFields[iField].String );
+            FreeFieldString( pauFields[iField].String );
 
-        pauFields[iField].String = CPLStrdup( szTempBuffer );
+        pauFields[iField].String = AllocFieldString( szTempBuffer );
     }
     else
     {
@@ -2682,9 +2868,9 @@ void OGRFeature::SetField( int iField, GIntBig nValue )
         sprintf( szTempBuffer, CPL_FRMT_GIB, nValue );
 
         if( IsFieldSet( iField) )
-            CPLFree( pauFields[iField].String );
+            FreeFieldString( pauFields[iField].String );
 
-        pauFields[iField].String = CPLStrdup( szTempBuffer );
+        pauFields[iField].String = AllocFieldString( szTempBuffer );
     }
     else
     {
@@ -2787,9 +2973,9 @@ void OGRFeature::SetField( int iField, double dfValue )
         CPLsprintf( szTempBuffer, "%.16g", dfValue );
 
         if( IsFieldSet( iField) )
-            CPLFree( pauFields[iField].String );
+            FreeFieldString( pauFields[iField].String );
 
-        pauFields[iField].String = CPLStrdup( szTempBuffer );
+        pauFields[iField].String = AllocFieldString( szTempBuffer );
     }
     else
     {
@@ -2859,17 +3045,18 @@ void OGRFeature::SetField( int iField, const char * pszValue )
     if( eType == OFTString )
     {
         if( IsFieldSet(iField) )
-            CPLFree( pauFields[iField].String );
+            FreeFieldString( pauFields[iField].String );
             
-        pauFields[iField].String = CPLStrdup( pszValue );
+        pauFields[iField].String = AllocFieldString( pszValue );
     }
     else if( eType == OFTInteger )
     {
         errno = 0; /* As allowed by C standard, some systems like MSVC doesn't reset errno */
         long nVal = strtol(pszValue, &pszLast, 10);
-        nVal = OGRFeatureGetIntegerValue(poFDefn, nVal);
-        pauFields[iField].Integer = (nVal > INT_MAX) ? INT_MAX : (nVal < INT_MIN) ? INT_MIN : (int) nVal;
-        if( bWarn && (errno == ERANGE || nVal != (long)pauFields[iField].Integer || !pszLast || *pszLast ) )
+        /* Clamp before the subtype check, which takes an int */
+        int nVal32 = (nVal > INT_MAX) ? INT_MAX : (nVal < INT_MIN) ? INT_MIN : (int) nVal;
+        pauFields[iField].Integer = OGRFeatureGetIntegerValue(poFDefn, nVal32);
+        if( bWarn && (errno == ERANGE || nVal != (long)nVal32 || !pszLast || *pszLast ) )
             CPLError(CE_Warning, CPLE_AppDefined,
                      "Value '%s' of field %s.%s parsed incompletely to integer %d.",
                      pszValue, poDefn->GetName(), poFDefn->GetNameRef(), pauFields[iField].Integer );
@@ -3617,7 +3804,7 @@ void OGRFeature::SetField( int iField, OGRField * puValue )
     else if( poFDefn->GetType() == OFTString )
     {
         if( IsFieldSet( iField ) )
-            CPLFree( pauFields[iField].String );
+            FreeFieldString( pauFields[iField].String );
         
         if( puValue->String == NULL )
             pauFields[iField].String = NULL;
@@ -3625,7 +3812,7 @@ void OGRFeature::SetField( int iField, OGRField * puValue )
                  && puValue->Set.nMarker2 == OGRUnsetMarker )
             pauFields[iField] = *puValue;
         else
-            pauFields[iField].String = CPLStrdup( puValue->String );
+            pauFields[iField].String = AllocFieldString( puValue->String );
     }
     else if( poFDefn->GetType() == OFTDate
              || poFDefn->GetType() == OFTTime
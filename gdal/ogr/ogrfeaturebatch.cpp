@@ -0,0 +1,1185 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  The OGRFeatureBatch class implementation, a column oriented
+ *           container for a set of features.
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_feature.h"
+#include "ogr_api.h"
+#include "ogr_p.h"
+
+CPL_CVSID("$Id$");
+
+/************************************************************************/
+/*                     OGRFeatureBatchGetValueSize()                    */
+/*                                                                      */
+/*      Returns the size of the fixed width values of a field type,     */
+/*      or 0 if the values are stored in the variable length buffer.    */
+/************************************************************************/
+
+static int OGRFeatureBatchGetValueSize( OGRFieldType eType )
+{
+    switch( eType )
+    {
+        case OFTInteger:
+            return (int)sizeof(int);
+        case OFTInteger64:
+            return (int)sizeof(GIntBig);
+        case OFTReal:
+            return (int)sizeof(double);
+        case OFTDate:
+        case OFTTime:
+        case OFTDateTime:
+            return (int)sizeof(OGRField);
+        default:
+            return 0;
+    }
+}
+
+/************************************************************************/
+/*                          OGRFeatureBatch()                           */
+/************************************************************************/
+
+/**
+ * \brief Constructor
+ *
+ * The batch keeps a reference on the feature definition, which must be
+ * the layer definition of the layer the batch is filled from.
+ *
+ * @param poDefnIn feature definition.
+ */
+
+OGRFeatureBatch::OGRFeatureBatch( OGRFeatureDefn *poDefnIn )
+
+{
+    poDefn = poDefnIn;
+    poDefn->Reference();
+
+    nFeatureCount = 0;
+    nCapacity = 0;
+    panFIDs = NULL;
+
+    nFieldCount = poDefn->GetFieldCount();
+    nGeomFieldCount = poDefn->GetGeomFieldCount();
+
+    pasFields = (OGRFeatureBatchColumn *)
+        CPLCalloc( MAX(1, nFieldCount), sizeof(OGRFeatureBatchColumn) );
+    for( int iField = 0; iField < nFieldCount; iField++ )
+    {
+        OGRFieldDefn *poFieldDefn = poDefn->GetFieldDefn(iField);
+        pasFields[iField].nValueSize =
+            OGRFeatureBatchGetValueSize( poFieldDefn->GetType() );
+        pasFields[iField].eSubType = poFieldDefn->GetSubType();
+    }
+
+    pasGeomFields = (OGRFeatureBatchColumn *)
+        CPLCalloc( MAX(1, nGeomFieldCount), sizeof(OGRFeatureBatchColumn) );
+}
+
+/************************************************************************/
+/*                          ~OGRFeatureBatch()                          */
+/************************************************************************/
+
+OGRFeatureBatch::~OGRFeatureBatch()
+
+{
+    int iField;
+
+    for( iField = 0; iField < nFieldCount; iField++ )
+        FreeColumn( pasFields + iField );
+    for( iField = 0; iField < nGeomFieldCount; iField++ )
+        FreeColumn( pasGeomFields + iField );
+
+    CPLFree( pasFields );
+    CPLFree( pasGeomFields );
+    CPLFree( panFIDs );
+
+    poDefn->Release();
+}
+
+/************************************************************************/
+/*                             FreeColumn()                             */
+/************************************************************************/
+
+void OGRFeatureBatch::FreeColumn( OGRFeatureBatchColumn *psCol )
+
+{
+    CPLFree( psCol->pabyIsSet );
+    CPLFree( psCol->pabyValues );
+    CPLFree( psCol->panOffsets );
+    CPLFree( psCol->pabyData );
+}
+
+/************************************************************************/
+/*                             GrowColumn()                             */
+/************************************************************************/
+
+int OGRFeatureBatch::GrowColumn( OGRFeatureBatchColumn *psCol,
+                                 int nNewCapacity )
+
+{
+    GByte *pabyNewIsSet = (GByte *)
+        VSIRealloc( psCol->pabyIsSet, nNewCapacity );
+    if( pabyNewIsSet == NULL )
+        return FALSE;
+    psCol->pabyIsSet = pabyNewIsSet;
+
+    if( psCol->nValueSize > 0 )
+    {
+        GByte *pabyNewValues = (GByte *)
+            VSIRealloc( psCol->pabyValues,
+                        (size_t)nNewCapacity * psCol->nValueSize );
+        if( pabyNewValues == NULL )
+            return FALSE;
+        psCol->pabyValues = pabyNewValues;
+    }
+    else
+    {
+        GIntBig *panNewOffsets = (GIntBig *)
+            VSIRealloc( psCol->panOffsets,
+                        ((size_t)nNewCapacity + 1) * sizeof(GIntBig) );
+        if( panNewOffsets == NULL )
+            return FALSE;
+        if( psCol->panOffsets == NULL )
+            panNewOffsets[0] = 0;
+        psCol->panOffsets = panNewOffsets;
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                            ReserveData()                             */
+/*                                                                      */
+/*      Append nBytes to the variable length buffer of a column for     */
+/*      the current row, and return a pointer on them.                  */
+/************************************************************************/
+
+GByte *OGRFeatureBatch::ReserveData( OGRFeatureBatchColumn *psCol,
+                                     size_t nBytes )
+
+{
+    if( psCol->pabyData == NULL ||
+        psCol->nDataSize + nBytes > psCol->nDataCapacity )
+    {
+        size_t nNewCapacity = MAX( psCol->nDataCapacity * 2,
+                                   psCol->nDataSize + nBytes );
+        nNewCapacity = MAX( nNewCapacity, 256 );
+        GByte *pabyNewData = (GByte *)
+            VSIRealloc( psCol->pabyData, nNewCapacity );
+        if( pabyNewData == NULL )
+        {
+            CPLError( CE_Failure, CPLE_OutOfMemory,
+                      "Cannot allocate " CPL_FRMT_GUIB " bytes for "
+                      "feature batch.", (GUIntBig)nNewCapacity );
+            return NULL;
+        }
+        psCol->pabyData = pabyNewData;
+        psCol->nDataCapacity = nNewCapacity;
+    }
+
+    GByte *pabyRet = psCol->pabyData + psCol->nDataSize;
+    psCol->nDataSize += nBytes;
+    psCol->panOffsets[nFeatureCount] = (GIntBig)psCol->nDataSize;
+
+    return pabyRet;
+}
+
+/************************************************************************/
+/*                               Reset()                                */
+/************************************************************************/
+
+/**
+ * \brief Remove all features from the batch.
+ *
+ * Allocated buffers are kept so that the batch can be refilled without
+ * new memory allocations.
+ */
+
+void OGRFeatureBatch::Reset()
+
+{
+    int iField;
+
+    for( iField = 0; iField < nFieldCount; iField++ )
+        pasFields[iField].nDataSize = 0;
+    for( iField = 0; iField < nGeomFieldCount; iField++ )
+        pasGeomFields[iField].nDataSize = 0;
+
+    nFeatureCount = 0;
+}
+
+/************************************************************************/
+/*                            BeginFeature()                            */
+/************************************************************************/
+
+/**
+ * \brief Append a new feature to the batch.
+ *
+ * All the fields and geometry fields of the new feature are unset.  The
+ * SetFieldXXX() and ReserveGeomFieldWKB() methods can then be used to
+ * assign them.  This method is intended for drivers filling the batch
+ * directly from their native storage.
+ *
+ * @param nFID feature id of the new feature.
+ *
+ * @return TRUE on success or FALSE in case of memory allocation failure.
+ */
+
+int OGRFeatureBatch::BeginFeature( GIntBig nFID )
+
+{
+    int iField;
+
+    if( nFeatureCount == nCapacity )
+    {
+        int nNewCapacity = MAX(16, nCapacity * 2);
+        int bOK = TRUE;
+
+        GIntBig *panNewFIDs = (GIntBig *)
+            VSIRealloc( panFIDs, nNewCapacity * sizeof(GIntBig) );
+        if( panNewFIDs == NULL )
+            bOK = FALSE;
+        else
+            panFIDs = panNewFIDs;
+
+        for( iField = 0; bOK && iField < nFieldCount; iField++ )
+            bOK = GrowColumn( pasFields + iField, nNewCapacity );
+        for( iField = 0; bOK && iField < nGeomFieldCount; iField++ )
+            bOK = GrowColumn( pasGeomFields + iField, nNewCapacity );
+
+        if( !bOK )
+        {
+            CPLError( CE_Failure, CPLE_OutOfMemory,
+                      "Cannot grow feature batch to %d features.",
+                      nNewCapacity );
+            return FALSE;
+        }
+        nCapacity = nNewCapacity;
+    }
+
+    panFIDs[nFeatureCount] = nFID;
+
+    for( iField = 0; iField < nFieldCount; iField++ )
+    {
+        OGRFeatureBatchColumn *psCol = pasFields + iField;
+        psCol->pabyIsSet[nFeatureCount] = FALSE;
+        if( psCol->nValueSize > 0 )
+            memset( psCol->pabyValues +
+                        (size_t)nFeatureCount * psCol->nValueSize,
+                    0, psCol->nValueSize );
+        else
+            psCol->panOffsets[nFeatureCount + 1] =
+                psCol->panOffsets[nFeatureCount];
+    }
+
+    for( iField = 0; iField < nGeomFieldCount; iField++ )
+    {
+        OGRFeatureBatchColumn *psCol = pasGeomFields + iField;
+        psCol->pabyIsSet[nFeatureCount] = FALSE;
+        psCol->panOffsets[nFeatureCount + 1] =
+            psCol->panOffsets[nFeatureCount];
+    }
+
+    nFeatureCount++;
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          SetFieldInteger()                           */
+/************************************************************************/
+
+/**
+ * \brief Set an OFTInteger field of the last feature begun with
+ * BeginFeature().
+ *
+ * As OGRFeature::SetField() does, a non-zero value of a OFSTBoolean field
+ * is stored as 1, and the value of a OFSTInt16 field is clamped to the
+ * range of a 16 bit integer, but without a warning.
+ *
+ * @param iField the field to set, from 0 to GetFieldCount()-1.
+ * @param nValue the value to assign.
+ */
+
+void OGRFeatureBatch::SetFieldInteger( int iField, int nValue )
+
+{
+    CPLAssert( nFeatureCount > 0 );
+    CPLAssert( pasFields[iField].nValueSize == (int)sizeof(int) &&
+               poDefn->GetFieldDefn(iField)->GetType() == OFTInteger );
+
+    OGRFeatureBatchColumn *psCol = pasFields + iField;
+    if( psCol->eSubType == OFSTBoolean && nValue != 0 )
+        nValue = 1;
+    else if( psCol->eSubType == OFSTInt16 )
+        nValue = MAX( -32768, MIN( 32767, nValue ) );
+    ((int *)psCol->pabyValues)[nFeatureCount - 1] = nValue;
+    psCol->pabyIsSet[nFeatureCount - 1] = TRUE;
+}
+
+/************************************************************************/
+/*                         SetFieldInteger64()                          */
+/************************************************************************/
+
+/**
+ * \brief Set an OFTInteger64 field of the last feature begun with
+ * BeginFeature().
+ *
+ * @param iField the field to set, from 0 to GetFieldCount()-1.
+ * @param nValue the value to assign.
+ */
+
+void OGRFeatureBatch::SetFieldInteger64( int iField, GIntBig nValue )
+
+{
+    CPLAssert( nFeatureCount > 0 );
+    CPLAssert( poDefn->GetFieldDefn(iField)->GetType() == OFTInteger64 );
+
+    OGRFeatureBatchColumn *psCol = pasFields + iField;
+    ((GIntBig *)psCol->pabyValues)[nFeatureCount - 1] = nValue;
+    psCol->pabyIsSet[nFeatureCount - 1] = TRUE;
+}
+
+/************************************************************************/
+/*                           SetFieldDouble()                           */
+/************************************************************************/
+
+/**
+ * \brief Set an OFTReal field of the last feature begun with
+ * BeginFeature().
+ *
+ * @param iField the field to set, from 0 to GetFieldCount()-1.
+ * @param dfValue the value to assign.
+ */
+
+void OGRFeatureBatch::SetFieldDouble( int iField, double dfValue )
+
+{
+    CPLAssert( nFeatureCount > 0 );
+    CPLAssert( poDefn->GetFieldDefn(iField)->GetType() == OFTReal );
+
+    OGRFeatureBatchColumn *psCol = pasFields + iField;
+    ((double *)psCol->pabyValues)[nFeatureCount - 1] = dfValue;
+    psCol->pabyIsSet[nFeatureCount - 1] = TRUE;
+}
+
+/************************************************************************/
+/*                          SetFieldDateTime()                          */
+/************************************************************************/
+
+/**
+ * \brief Set an OFTDate, OFTTime or OFTDateTime field of the last feature
+ * begun with BeginFeature().
+ *
+ * @param iField the field to set, from 0 to GetFieldCount()-1.
+ * @param psValue the value to assign, in its Date member.
+ */
+
+void OGRFeatureBatch::SetFieldDateTime( int iField, const OGRField *psValue )
+
+{
+    CPLAssert( nFeatureCount > 0 );
+    CPLAssert( pasFields[iField].nValueSize == (int)sizeof(OGRField) );
+
+    OGRFeatureBatchColumn *psCol = pasFields + iField;
+    memcpy( ((OGRField *)psCol->pabyValues) + nFeatureCount - 1, psValue,
+            sizeof(OGRField) );
+    psCol->pabyIsSet[nFeatureCount - 1] = TRUE;
+}
+
+/************************************************************************/
+/*                           SetFieldBinary()                           */
+/************************************************************************/
+
+/**
+ * \brief Set a variable length field of the last feature begun with
+ * BeginFeature().
+ *
+ * This applies to all field types not stored in fixed width arrays.
+ * For strings, the terminating nul character must not be included in
+ * nBytes.  A field may only be set once per feature.
+ *
+ * @param iField the field to set, from 0 to GetFieldCount()-1.
+ * @param pData the bytes to assign.
+ * @param nBytes the number of bytes.
+ *
+ * @return TRUE on success or FALSE in case of memory allocation failure.
+ */
+
+int OGRFeatureBatch::SetFieldBinary( int iField, const void *pData,
+                                     size_t nBytes )
+
+{
+    CPLAssert( nFeatureCount > 0 );
+    CPLAssert( pasFields[iField].nValueSize == 0 );
+
+    OGRFeatureBatchColumn *psCol = pasFields + iField;
+    CPLAssert( !psCol->pabyIsSet[nFeatureCount - 1] );
+
+    GByte *pabyDst = ReserveData( psCol, nBytes );
+    if( pabyDst == NULL )
+        return FALSE;
+    if( nBytes )
+        memcpy( pabyDst, pData, nBytes );
+    psCol->pabyIsSet[nFeatureCount - 1] = TRUE;
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                        ReserveGeomFieldWKB()                         */
+/************************************************************************/
+
+/**
+ * \brief Reserve room for the WKB geometry of the last feature begun with
+ * BeginFeature().
+ *
+ * The caller must write exactly nBytes of ISO WKB at the returned
+ * location.  The pointer is only valid until the next call to a method
+ * appending data to the batch.
+ *
+ * @param iGeomField the geometry field to set.
+ * @param nBytes the size of the WKB geometry.
+ *
+ * @return a pointer to write the WKB geometry or NULL in case of memory
+ * allocation failure.
+ */
+
+GByte *OGRFeatureBatch::ReserveGeomFieldWKB( int iGeomField, size_t nBytes )
+
+{
+    CPLAssert( nFeatureCount > 0 );
+    CPLAssert( iGeomField >= 0 && iGeomField < nGeomFieldCount );
+
+    OGRFeatureBatchColumn *psCol = pasGeomFields + iGeomField;
+    CPLAssert( !psCol->pabyIsSet[nFeatureCount - 1] );
+
+    GByte *pabyDst = ReserveData( psCol, nBytes );
+    if( pabyDst != NULL )
+        psCol->pabyIsSet[nFeatureCount - 1] = TRUE;
+    return pabyDst;
+}
+
+/************************************************************************/
+/*                             AddFeature()                             */
+/************************************************************************/
+
+/**
+ * \brief Append a copy of a feature to the batch.
+ *
+ * The feature must use the same feature definition as the batch.
+ *
+ * @param poFeature the feature to copy.
+ *
+ * @return TRUE on success or FALSE in case of memory allocation failure.
+ */
+
+int OGRFeatureBatch::AddFeature( OGRFeature *poFeature )
+
+{
+    CPLAssert( poFeature->GetDefnRef() == poDefn );
+
+    if( !BeginFeature( poFeature->GetFID() ) )
+        return FALSE;
+
+    for( int iField = 0; iField < nFieldCount; iField++ )
+    {
+        if( !poFeature->IsFieldSet( iField ) )
+            continue;
+
+        OGRField *psField = poFeature->GetRawFieldRef( iField );
+        switch( poDefn->GetFieldDefn(iField)->GetType() )
+        {
+            case OFTInteger:
+                SetFieldInteger( iField, psField->Integer );
+                break;
+
+            case OFTInteger64:
+                SetFieldInteger64( iField, psField->Integer64 );
+                break;
+
+            case OFTReal:
+                SetFieldDouble( iField, psField->Real );
+                break;
+
+            case OFTDate:
+            case OFTTime:
+            case OFTDateTime:
+                SetFieldDateTime( iField, psField );
+                break;
+
+            case OFTString:
+                if( !SetFieldBinary( iField, psField->String,
+                                     strlen(psField->String) ) )
+                    return FALSE;
+                break;
+
+            case OFTBinary:
+                if( !SetFieldBinary( iField, psField->Binary.paData,
+                                     psField->Binary.nCount ) )
+                    return FALSE;
+                break;
+
+            default:
+            {
+                const char *pszValue = poFeature->GetFieldAsString( iField );
+                if( !SetFieldBinary( iField, pszValue, strlen(pszValue) ) )
+                    return FALSE;
+                break;
+            }
+        }
+    }
+
+    for( int iGeomField = 0; iGeomField < nGeomFieldCount; iGeomField++ )
+    {
+        OGRGeometry *poGeom = poFeature->GetGeomFieldRef( iGeomField );
+        if( poGeom == NULL )
+            continue;
+
+        GByte *pabyWKB = ReserveGeomFieldWKB( iGeomField, poGeom->WkbSize() );
+        if( pabyWKB == NULL )
+            return FALSE;
+        poGeom->exportToWkb( wkbNDR, pabyWKB, wkbVariantIso );
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                         GetFieldIsSetArray()                         */
+/************************************************************************/
+
+/**
+ * \brief Fetch the array of "is set" flags of a field.
+ *
+ * @param iField the field, from 0 to GetFieldCount()-1.
+ *
+ * @return an array of GetFeatureCount() flags, non zero for features
+ * where the field is set.
+ */
+
+const GByte *OGRFeatureBatch::GetFieldIsSetArray( int iField )
+
+{
+    if( iField < 0 || iField >= nFieldCount )
+        return NULL;
+    return pasFields[iField].pabyIsSet;
+}
+
+/************************************************************************/
+/*                             IsFieldSet()                             */
+/************************************************************************/
+
+/**
+ * \brief Test if a field of a feature of the batch is set.
+ *
+ * @param iRow the feature index in the batch.
+ * @param iField the field, from 0 to GetFieldCount()-1.
+ *
+ * @return TRUE if the field is set.
+ */
+
+int OGRFeatureBatch::IsFieldSet( int iRow, int iField )
+
+{
+    if( iRow < 0 || iRow >= nFeatureCount ||
+        iField < 0 || iField >= nFieldCount )
+        return FALSE;
+    return pasFields[iField].pabyIsSet[iRow];
+}
+
+/************************************************************************/
+/*                       GetFieldAsIntegerArray()                       */
+/************************************************************************/
+
+/**
+ * \brief Fetch the values of an OFTInteger field.
+ *
+ * Values of unset fields are 0.
+ *
+ * @param iField the field, from 0 to GetFieldCount()-1.
+ *
+ * @return an array of GetFeatureCount() values, or NULL if the field is
+ * not an OFTInteger field.
+ */
+
+const int *OGRFeatureBatch::GetFieldAsIntegerArray( int iField )
+
+{
+    if( iField < 0 || iField >= nFieldCount ||
+        poDefn->GetFieldDefn(iField)->GetType() != OFTInteger )
+        return NULL;
+    return (const int *)pasFields[iField].pabyValues;
+}
+
+/************************************************************************/
+/*                      GetFieldAsInteger64Array()                      */
+/************************************************************************/
+
+/**
+ * \brief Fetch the values of an OFTInteger64 field.
+ *
+ * Values of unset fields are 0.
+ *
+ * @param iField the field, from 0 to GetFieldCount()-1.
+ *
+ * @return an array of GetFeatureCount() values, or NULL if the field is
+ * not an OFTInteger64 field.
+ */
+
+const GIntBig *OGRFeatureBatch::GetFieldAsInteger64Array( int iField )
+
+{
+    if( iField < 0 || iField >= nFieldCount ||
+        poDefn->GetFieldDefn(iField)->GetType() != OFTInteger64 )
+        return NULL;
+    return (const GIntBig *)pasFields[iField].pabyValues;
+}
+
+/************************************************************************/
+/*                       GetFieldAsDoubleArray()                        */
+/************************************************************************/
+
+/**
+ * \brief Fetch the values of an OFTReal field.
+ *
+ * Values of unset fields are 0.
+ *
+ * @param iField the field, from 0 to GetFieldCount()-1.
+ *
+ * @return an array of GetFeatureCount() values, or NULL if the field is
+ * not an OFTReal field.
+ */
+
+const double *OGRFeatureBatch::GetFieldAsDoubleArray( int iField )
+
+{
+    if( iField < 0 || iField >= nFieldCount ||
+        poDefn->GetFieldDefn(iField)->GetType() != OFTReal )
+        return NULL;
+    return (const double *)pasFields[iField].pabyValues;
+}
+
+/************************************************************************/
+/*                      GetFieldAsDateTimeArray()                       */
+/************************************************************************/
+
+/**
+ * \brief Fetch the values of an OFTDate, OFTTime or OFTDateTime field.
+ *
+ * @param iField the field, from 0 to GetFieldCount()-1.
+ *
+ * @return an array of GetFeatureCount() values, to be read through their
+ * Date member, or NULL if the field is not a date or time field.
+ */
+
+const OGRField *OGRFeatureBatch::GetFieldAsDateTimeArray( int iField )
+
+{
+    if( iField < 0 || iField >= nFieldCount ||
+        pasFields[iField].nValueSize != (int)sizeof(OGRField) )
+        return NULL;
+    return (const OGRField *)pasFields[iField].pabyValues;
+}
+
+/************************************************************************/
+/*                          GetFieldOffsets()                           */
+/************************************************************************/
+
+/**
+ * \brief Fetch the offsets of a variable length field.
+ *
+ * The value of the field for feature iRow is stored in GetFieldData()
+ * from offset panOffsets[iRow] (included) to offset panOffsets[iRow+1]
+ * (excluded).
+ *
+ * @param iField the field, from 0 to GetFieldCount()-1.
+ *
+ * @return an array of GetFeatureCount()+1 offsets, or NULL if the field
+ * is stored in a fixed width array.
+ */
+
+const GIntBig *OGRFeatureBatch::GetFieldOffsets( int iField )
+
+{
+    if( iField < 0 || iField >= nFieldCount ||
+        pasFields[iField].nValueSize != 0 || nCapacity == 0 )
+        return NULL;
+    return pasFields[iField].panOffsets;
+}
+
+/************************************************************************/
+/*                            GetFieldData()                            */
+/************************************************************************/
+
+/**
+ * \brief Fetch the buffer of a variable length field.
+ *
+ * @param iField the field, from 0 to GetFieldCount()-1.
+ *
+ * @return the buffer, to be used with GetFieldOffsets(), or NULL.
+ */
+
+const GByte *OGRFeatureBatch::GetFieldData( int iField )
+
+{
+    if( iField < 0 || iField >= nFieldCount ||
+        pasFields[iField].nValueSize != 0 )
+        return NULL;
+    return pasFields[iField].pabyData;
+}
+
+/************************************************************************/
+/*                          GetFieldAsBinary()                          */
+/************************************************************************/
+
+/**
+ * \brief Fetch the value of a variable length field of a feature.
+ *
+ * @param iRow the feature index in the batch.
+ * @param iField the field, from 0 to GetFieldCount()-1.
+ * @param pnBytes location to put the number of bytes returned.
+ *
+ * @return the bytes of the value (not nul terminated), or NULL if the
+ * field is unset or not a variable length field.
+ */
+
+const GByte *OGRFeatureBatch::GetFieldAsBinary( int iRow, int iField,
+                                                int *pnBytes )
+
+{
+    *pnBytes = 0;
+    const GIntBig *panOffsets = GetFieldOffsets( iField );
+    if( panOffsets == NULL || iRow < 0 || iRow >= nFeatureCount ||
+        !pasFields[iField].pabyIsSet[iRow] )
+        return NULL;
+
+    *pnBytes = (int)(panOffsets[iRow+1] - panOffsets[iRow]);
+    return pasFields[iField].pabyData + panOffsets[iRow];
+}
+
+/************************************************************************/
+/*                        GetGeomFieldOffsets()                         */
+/************************************************************************/
+
+/**
+ * \brief Fetch the offsets of the WKB geometries of a geometry field.
+ *
+ * @param iGeomField the geometry field, from 0 to GetGeomFieldCount()-1.
+ *
+ * @return an array of GetFeatureCount()+1 offsets in GetGeomFieldData().
+ */
+
+const GIntBig *OGRFeatureBatch::GetGeomFieldOffsets( int iGeomField )
+
+{
+    if( iGeomField < 0 || iGeomField >= nGeomFieldCount ||
+        nCapacity == 0 )
+        return NULL;
+    return pasGeomFields[iGeomField].panOffsets;
+}
+
+/************************************************************************/
+/*                          GetGeomFieldData()                          */
+/************************************************************************/
+
+/**
+ * \brief Fetch the buffer of the WKB geometries of a geometry field.
+ *
+ * @param iGeomField the geometry field, from 0 to GetGeomFieldCount()-1.
+ *
+ * @return the buffer, to be used with GetGeomFieldOffsets(), or NULL.
+ */
+
+const GByte *OGRFeatureBatch::GetGeomFieldData( int iGeomField )
+
+{
+    if( iGeomField < 0 || iGeomField >= nGeomFieldCount )
+        return NULL;
+    return pasGeomFields[iGeomField].pabyData;
+}
+
+/************************************************************************/
+/*                         GetGeomFieldAsWKB()                          */
+/************************************************************************/
+
+/**
+ * \brief Fetch the WKB geometry of a feature.
+ *
+ * @param iRow the feature index in the batch.
+ * @param iGeomField the geometry field, from 0 to GetGeomFieldCount()-1.
+ * @param pnBytes location to put the size of the WKB geometry.
+ *
+ * @return the WKB geometry or NULL if the geometry is null.
+ */
+
+const GByte *OGRFeatureBatch::GetGeomFieldAsWKB( int iRow, int iGeomField,
+                                                 int *pnBytes )
+
+{
+    *pnBytes = 0;
+    const GIntBig *panOffsets = GetGeomFieldOffsets( iGeomField );
+    if( panOffsets == NULL || iRow < 0 || iRow >= nFeatureCount ||
+        panOffsets[iRow+1] == panOffsets[iRow] )
+        return NULL;
+
+    *pnBytes = (int)(panOffsets[iRow+1] - panOffsets[iRow]);
+    return pasGeomFields[iGeomField].pabyData + panOffsets[iRow];
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/************************************************************************/
+
+/**
+ * \brief Build a feature from a row of the batch.
+ *
+ * @param iRow the feature index in the batch.
+ *
+ * @return a new feature, to be freed with OGRFeature::DestroyFeature(),
+ * or NULL if iRow is out of range.
+ */
+
+OGRFeature *OGRFeatureBatch::GetFeature( int iRow )
+
+{
+    if( iRow < 0 || iRow >= nFeatureCount )
+        return NULL;
+
+    OGRFeature *poFeature = new OGRFeature( poDefn );
+    poFeature->SetFID( panFIDs[iRow] );
+
+    for( int iField = 0; iField < nFieldCount; iField++ )
+    {
+        OGRFeatureBatchColumn *psCol = pasFields + iField;
+        if( !psCol->pabyIsSet[iRow] )
+            continue;
+
+        OGRFieldType eType = poDefn->GetFieldDefn(iField)->GetType();
+        if( eType == OFTInteger )
+            poFeature->SetField( iField, ((int *)psCol->pabyValues)[iRow] );
+        else if( eType == OFTInteger64 )
+            poFeature->SetField( iField,
+                                 ((GIntBig *)psCol->pabyValues)[iRow] );
+        else if( eType == OFTReal )
+            poFeature->SetField( iField,
+                                 ((double *)psCol->pabyValues)[iRow] );
+        else if( psCol->nValueSize > 0 )
+            poFeature->SetField( iField,
+                                 ((OGRField *)psCol->pabyValues) + iRow );
+        else
+        {
+            int nBytes = 0;
+            const GByte *pabyData = GetFieldAsBinary( iRow, iField, &nBytes );
+            if( eType == OFTBinary )
+                poFeature->SetField( iField, nBytes, (GByte *)pabyData );
+            else
+            {
+                CPLString osValue;
+                osValue.assign( (const char *)pabyData, nBytes );
+                poFeature->SetField( iField, osValue.c_str() );
+            }
+        }
+    }
+
+    for( int iGeomField = 0; iGeomField < nGeomFieldCount; iGeomField++ )
+    {
+        int nBytes = 0;
+        const GByte *pabyWKB = GetGeomFieldAsWKB( iRow, iGeomField, &nBytes );
+        if( pabyWKB == NULL )
+            continue;
+
+        OGRGeometry *poGeom = NULL;
+        if( OGRGeometryFactory::createFromWkb(
+                (unsigned char *)pabyWKB,
+                poDefn->GetGeomFieldDefn(iGeomField)->GetSpatialRef(),
+                &poGeom, nBytes ) == OGRERR_NONE )
+            poFeature->SetGeomFieldDirectly( iGeomField, poGeom );
+    }
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                           OGR_FB_Create()                            */
+/************************************************************************/
+
+/**
+ * \brief Create a feature batch.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::OGRFeatureBatch().
+ *
+ * @param hDefn feature definition, normally the one of the layer the batch
+ * will be filled from.
+ *
+ * @return a handle to the new batch, to be freed with OGR_FB_Destroy().
+ *
+ * @since GDAL 2.0
+ */
+
+OGRFeatureBatchH OGR_FB_Create( OGRFeatureDefnH hDefn )
+
+{
+    VALIDATE_POINTER1( hDefn, "OGR_FB_Create", NULL );
+
+    return (OGRFeatureBatchH) new OGRFeatureBatch( (OGRFeatureDefn *) hDefn );
+}
+
+/************************************************************************/
+/*                           OGR_FB_Destroy()                           */
+/************************************************************************/
+
+/**
+ * \brief Destroy a feature batch.
+ *
+ * @param hBatch handle to the batch to destroy.
+ *
+ * @since GDAL 2.0
+ */
+
+void OGR_FB_Destroy( OGRFeatureBatchH hBatch )
+
+{
+    delete (OGRFeatureBatch *) hBatch;
+}
+
+/************************************************************************/
+/*                       OGR_FB_GetFeatureCount()                       */
+/************************************************************************/
+
+/**
+ * \brief Fetch the number of features in the batch.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFeatureCount().
+ *
+ * @param hBatch handle to the batch.
+ *
+ * @return the number of features.
+ *
+ * @since GDAL 2.0
+ */
+
+int OGR_FB_GetFeatureCount( OGRFeatureBatchH hBatch )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFeatureCount", 0 );
+
+    return ((OGRFeatureBatch *) hBatch)->GetFeatureCount();
+}
+
+/************************************************************************/
+/*                           OGR_FB_GetFIDs()                           */
+/************************************************************************/
+
+/**
+ * \brief Fetch the feature ids of the features of the batch.
+ *
+ * This function is the same as the C++ method OGRFeatureBatch::GetFIDs().
+ *
+ * @param hBatch handle to the batch.
+ *
+ * @return an array of OGR_FB_GetFeatureCount() feature ids.
+ *
+ * @since GDAL 2.0
+ */
+
+const GIntBig *OGR_FB_GetFIDs( OGRFeatureBatchH hBatch )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFIDs", NULL );
+
+    return ((OGRFeatureBatch *) hBatch)->GetFIDs();
+}
+
+/************************************************************************/
+/*                     OGR_FB_GetFieldIsSetArray()                      */
+/************************************************************************/
+
+/**
+ * \brief Fetch the array of "is set" flags of a field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldIsSetArray().
+ *
+ * @param hBatch handle to the batch.
+ * @param iField the field.
+ *
+ * @return an array of OGR_FB_GetFeatureCount() flags.
+ *
+ * @since GDAL 2.0
+ */
+
+const GByte *OGR_FB_GetFieldIsSetArray( OGRFeatureBatchH hBatch, int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldIsSetArray", NULL );
+
+    return ((OGRFeatureBatch *) hBatch)->GetFieldIsSetArray( iField );
+}
+
+/************************************************************************/
+/*                   OGR_FB_GetFieldAsIntegerArray()                    */
+/************************************************************************/
+
+/**
+ * \brief Fetch the values of an OFTInteger field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldAsIntegerArray().
+ *
+ * @param hBatch handle to the batch.
+ * @param iField the field.
+ *
+ * @return an array of OGR_FB_GetFeatureCount() values, or NULL.
+ *
+ * @since GDAL 2.0
+ */
+
+const int *OGR_FB_GetFieldAsIntegerArray( OGRFeatureBatchH hBatch, int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldAsIntegerArray", NULL );
+
+    return ((OGRFeatureBatch *) hBatch)->GetFieldAsIntegerArray( iField );
+}
+
+/************************************************************************/
+/*                  OGR_FB_GetFieldAsInteger64Array()                   */
+/************************************************************************/
+
+/**
+ * \brief Fetch the values of an OFTInteger64 field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldAsInteger64Array().
+ *
+ * @param hBatch handle to the batch.
+ * @param iField the field.
+ *
+ * @return an array of OGR_FB_GetFeatureCount() values, or NULL.
+ *
+ * @since GDAL 2.0
+ */
+
+const GIntBig *OGR_FB_GetFieldAsInteger64Array( OGRFeatureBatchH hBatch,
+                                                int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldAsInteger64Array", NULL );
+
+    return ((OGRFeatureBatch *) hBatch)->GetFieldAsInteger64Array( iField );
+}
+
+/************************************************************************/
+/*                    OGR_FB_GetFieldAsDoubleArray()                    */
+/************************************************************************/
+
+/**
+ * \brief Fetch the values of an OFTReal field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldAsDoubleArray().
+ *
+ * @param hBatch handle to the batch.
+ * @param iField the field.
+ *
+ * @return an array of OGR_FB_GetFeatureCount() values, or NULL.
+ *
+ * @since GDAL 2.0
+ */
+
+const double *OGR_FB_GetFieldAsDoubleArray( OGRFeatureBatchH hBatch,
+                                            int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldAsDoubleArray", NULL );
+
+    return ((OGRFeatureBatch *) hBatch)->GetFieldAsDoubleArray( iField );
+}
+
+/************************************************************************/
+/*                      OGR_FB_GetFieldAsBinary()                       */
+/************************************************************************/
+
+/**
+ * \brief Fetch the value of a variable length field of a feature.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldAsBinary().
+ *
+ * @param hBatch handle to the batch.
+ * @param iRow the feature index in the batch.
+ * @param iField the field.
+ * @param pnBytes location to put the number of bytes returned.
+ *
+ * @return the bytes of the value (not nul terminated), or NULL.
+ *
+ * @since GDAL 2.0
+ */
+
+const GByte *OGR_FB_GetFieldAsBinary( OGRFeatureBatchH hBatch, int iRow,
+                                      int iField, int *pnBytes )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldAsBinary", NULL );
+    VALIDATE_POINTER1( pnBytes, "OGR_FB_GetFieldAsBinary", NULL );
+
+    return ((OGRFeatureBatch *) hBatch)->GetFieldAsBinary( iRow, iField,
+                                                           pnBytes );
+}
+
+/************************************************************************/
+/*                      OGR_FB_GetGeomFieldAsWKB()                      */
+/************************************************************************/
+
+/**
+ * \brief Fetch the WKB geometry of a feature.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetGeomFieldAsWKB().
+ *
+ * @param hBatch handle to the batch.
+ * @param iRow the feature index in the batch.
+ * @param iGeomField the geometry field.
+ * @param pnBytes location to put the size of the WKB geometry.
+ *
+ * @return the ISO WKB geometry or NULL if the geometry is null.
+ *
+ * @since GDAL 2.0
+ */
+
+const GByte *OGR_FB_GetGeomFieldAsWKB( OGRFeatureBatchH hBatch, int iRow,
+                                       int iGeomField, int *pnBytes )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetGeomFieldAsWKB", NULL );
+    VALIDATE_POINTER1( pnBytes, "OGR_FB_GetGeomFieldAsWKB", NULL );
+
+    return ((OGRFeatureBatch *) hBatch)->GetGeomFieldAsWKB( iRow, iGeomField,
+                                                            pnBytes );
+}
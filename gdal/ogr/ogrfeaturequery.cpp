@@ -55,6 +55,7 @@ OGRFeatureQuery::OGRFeatureQuery()
 {
     poTargetDefn = NULL;
     pSWQExpr = NULL;
+    pSWQProgram = NULL;
 }
 
 /************************************************************************/
@@ -64,6 +65,7 @@ OGRFeatureQuery::OGRFeatureQuery()
 OGRFeatureQuery::~OGRFeatureQuery()
 
 {
+    delete (swq_expr_program *) pSWQProgram;
     delete (swq_expr_node *) pSWQExpr;
 }
 
@@ -85,6 +87,7 @@ OGRErr OGRFeatureQuery::Compile( OGRFeatureDefn *poDefn,
         delete (swq_expr_node *) pSWQExpr;
         pSWQExpr = NULL;
     }
+    ExpressionChanged();
 
 /* -------------------------------------------------------------------- */
 /*      Build list of fields.                                           */
@@ -182,6 +185,8 @@ OGRErr OGRFeatureQuery::Compile( OGRFeatureDefn *poDefn,
         eErr = OGRERR_CORRUPT_DATA;
         pSWQExpr = NULL;
     }
+    else
+        ExpressionChanged();
 
     CPLFree( papszFieldNames );
     CPLFree( paeFieldTypes );
@@ -190,6 +195,24 @@ OGRErr OGRFeatureQuery::Compile( OGRFeatureDefn *poDefn,
     return eErr;
 }
 
+/************************************************************************/
+/*                         ExpressionChanged()                          */
+/*                                                                      */
+/*      Rebuild the program used by Evaluate() from the expression.     */
+/*      Must be called by code that modifies in place the tree          */
+/*      returned by GetSWQExpr().                                       */
+/************************************************************************/
+
+void OGRFeatureQuery::ExpressionChanged()
+
+{
+    delete (swq_expr_program *) pSWQProgram;
+    pSWQProgram = NULL;
+
+    if( pSWQExpr != NULL )
+        pSWQProgram = new swq_expr_program( (swq_expr_node *) pSWQExpr );
+}
+
 /************************************************************************/
 /*                         OGRFeatureFetcher()                          */
 /************************************************************************/
@@ -236,6 +259,45 @@ static swq_expr_node *OGRFeatureFetcher( swq_expr_node *op, void *pFeatureIn )
     return poRetNode;
 }
 
+/************************************************************************/
+/*                       OGRFeatureValueFetcher()                       */
+/*                                                                      */
+/*      Same as OGRFeatureFetcher(), but for compiled expressions.      */
+/************************************************************************/
+
+static void OGRFeatureValueFetcher( swq_expr_node *op, void *pFeatureIn,
+                                    swq_value *psValue )
+
+{
+    OGRFeature *poFeature = (OGRFeature *) pFeatureIn;
+
+    switch( op->field_type )
+    {
+      case SWQ_INTEGER:
+      case SWQ_BOOLEAN:
+        psValue->field_type = SWQ_INTEGER;
+        psValue->int_value = poFeature->GetFieldAsInteger(op->field_index);
+        break;
+
+      case SWQ_INTEGER64:
+        psValue->field_type = SWQ_INTEGER64;
+        psValue->int_value = poFeature->GetFieldAsInteger64(op->field_index);
+        break;
+
+      case SWQ_FLOAT:
+        psValue->field_type = SWQ_FLOAT;
+        psValue->float_value = poFeature->GetFieldAsDouble(op->field_index);
+        break;
+
+      default:
+        psValue->field_type = SWQ_STRING;
+        psValue->string_value = poFeature->GetFieldAsString(op->field_index);
+        break;
+    }
+
+    psValue->is_null = !(poFeature->IsFieldSet(op->field_index));
+}
+
 /************************************************************************/
 /*                              Evaluate()                              */
 /************************************************************************/
@@ -243,26 +305,131 @@ static swq_expr_node *OGRFeatureFetcher( swq_expr_node *op, void *pFeatureIn )
 int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
 
 {
-    if( pSWQExpr == NULL )
+    if( pSWQExpr == NULL || pSWQProgram == NULL )
+        return FALSE;
+
+    return ((swq_expr_program *) pSWQProgram)->EvaluateAsBoolean(
+        OGRFeatureValueFetcher, OGRFeatureFetcher, (void *) poFeature );
+}
+
+/************************************************************************/
+/*                      OGRIsIndexRangeOperation()                      */
+/*                                                                      */
+/*      Operations that can be answered by GetRangeMatches() or         */
+/*      GetPrefixMatches() of ordered indexes.                          */
+/************************************************************************/
+
+static int OGRIsIndexRangeOperation( swq_expr_node *psExpr )
+{
+    switch( psExpr->nOperation )
+    {
+      case SWQ_LT:
+      case SWQ_LE:
+      case SWQ_GT:
+      case SWQ_GE:
+        return psExpr->nSubExprCount == 2;
+
+      case SWQ_BETWEEN:
+        return psExpr->nSubExprCount == 3;
+
+      case SWQ_LIKE:
+        /* no ESCAPE clause */
+        return psExpr->nSubExprCount == 2;
+
+      default:
+        return FALSE;
+    }
+}
+
+/************************************************************************/
+/*                          OGRGetIndexBound()                          */
+/*                                                                      */
+/*      Convert the constant bound of a range comparison into a key     */
+/*      of the type of the indexed field.  Non integral bounds on       */
+/*      integer fields are rounded inwards and made inclusive, and      */
+/*      bounds out of the range of the field are clamped.  This may     */
+/*      select more features than strictly needed, but the attribute    */
+/*      filter is evaluated on them anyway.                             */
+/************************************************************************/
+
+static int OGRGetIndexBound( OGRFieldType eType, swq_expr_node *poValue,
+                             int bLowerBound, OGRField *psField,
+                             int *pbIncluded )
+{
+    if( poValue->eNodeType != SNT_CONSTANT || poValue->is_null )
         return FALSE;
 
-    swq_expr_node *poResult;
+    if( eType == OFTString )
+    {
+        if( poValue->field_type != SWQ_STRING )
+            return FALSE;
+        psField->String = poValue->string_value;
+        return TRUE;
+    }
+
+    if( eType != OFTInteger && eType != OFTInteger64 && eType != OFTReal )
+        return FALSE;
 
-    poResult = ((swq_expr_node *) pSWQExpr)->Evaluate( OGRFeatureFetcher,
-                                                       (void *) poFeature );
+    if( poValue->field_type != SWQ_FLOAT )
+    {
+        if( poValue->field_type != SWQ_INTEGER
+            && poValue->field_type != SWQ_INTEGER64 )
+            return FALSE;
+
+        GIntBig nValue = poValue->int_value;
+        if( eType == OFTReal )
+            psField->Real = (double) nValue;
+        else if( eType == OFTInteger64 )
+            psField->Integer64 = nValue;
+        else
+        {
+            if( nValue < INT_MIN || nValue > INT_MAX )
+            {
+                nValue = (nValue < INT_MIN) ? INT_MIN : INT_MAX;
+                *pbIncluded = TRUE;
+            }
+            psField->Integer = (int) nValue;
+        }
+        return TRUE;
+    }
 
-    if( poResult == NULL )
+    double dfValue = poValue->float_value;
+    if( CPLIsNan( dfValue ) )
         return FALSE;
 
-    int bLogicalResult = FALSE;
-    if( poResult->field_type == SWQ_INTEGER ||
-        poResult->field_type == SWQ_INTEGER64 ||
-        poResult->field_type == SWQ_BOOLEAN )
-        bLogicalResult = (int)poResult->int_value;
+    if( eType == OFTReal )
+    {
+        psField->Real = dfValue;
+        return TRUE;
+    }
 
-    delete poResult;
+    double dfRounded = bLowerBound ? ceil( dfValue ) : floor( dfValue );
+    if( dfRounded != dfValue )
+        *pbIncluded = TRUE;
+
+    double dfMin, dfMax;
+    if( eType == OFTInteger )
+    {
+        dfMin = INT_MIN;
+        dfMax = INT_MAX;
+    }
+    else
+    {
+        /* exactly representable bounds within the GIntBig range */
+        dfMin = -9223372036854775808.0;
+        dfMax = 9223372036854774784.0;
+    }
+    if( dfRounded < dfMin || dfRounded > dfMax )
+    {
+        dfRounded = (dfRounded < dfMin) ? dfMin : dfMax;
+        *pbIncluded = TRUE;
+    }
 
-    return bLogicalResult;
+    if( eType == OFTInteger )
+        psField->Integer = (int) dfRounded;
+    else
+        psField->Integer64 = (GIntBig) dfRounded;
+    return TRUE;
 }
 
 /************************************************************************/
@@ -294,14 +461,21 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
         psExpr->eNodeType != SNT_OPERATION )
         return FALSE;
 
-    if ((psExpr->nOperation == SWQ_OR || psExpr->nOperation == SWQ_AND) &&
-         psExpr->nSubExprCount == 2)
+    if (psExpr->nOperation == SWQ_OR && psExpr->nSubExprCount == 2)
     {
         return CanUseIndex( psExpr->papoSubExpr[0], poLayer ) &&
                CanUseIndex( psExpr->papoSubExpr[1], poLayer );
     }
 
-    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
+    /* One indexed side is enough to restrict the candidates of an AND */
+    if (psExpr->nOperation == SWQ_AND && psExpr->nSubExprCount == 2)
+    {
+        return CanUseIndex( psExpr->papoSubExpr[0], poLayer ) ||
+               CanUseIndex( psExpr->papoSubExpr[1], poLayer );
+    }
+
+    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN
+          || OGRIsIndexRangeOperation( psExpr ))
         || psExpr->nSubExprCount < 2 )
         return FALSE;
 
@@ -309,13 +483,17 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
     swq_expr_node *poValue = psExpr->papoSubExpr[1];
     
     if( poColumn->eNodeType != SNT_COLUMN
-        || poValue->eNodeType != SNT_CONSTANT )
+        || poValue->eNodeType != SNT_CONSTANT
+        || poColumn->field_index >= poLayer->GetLayerDefn()->GetFieldCount() )
         return FALSE;
 
     poIndex = poLayer->GetIndex()->GetFieldIndex( poColumn->field_index );
     if( poIndex == NULL )
         return FALSE;
 
+    if( OGRIsIndexRangeOperation( psExpr ) && !poIndex->SupportsRangeMatches() )
+        return FALSE;
+
 /* -------------------------------------------------------------------- */
 /*      OK, we have an index                                            */
 /* -------------------------------------------------------------------- */
@@ -331,9 +509,13 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
 /*      available indices, or an "OGRNullFID" terminated list of        */
 /*      FIDs if it can.                                                 */
 /*                                                                      */
-/*      For now we only support equality tests on a single indexed      */
-/*      attribute field.  Eventually we should make this support        */
-/*      multi-part queries with ranges.                                 */
+/*      Equality and IN tests are supported on all indexes.  Range      */
+/*      comparisons, BETWEEN and LIKE with a constant prefix are        */
+/*      supported on indexes implementing GetRangeMatches().  They      */
+/*      can be combined with OR, and with AND, in which case a single   */
+/*      indexed side is enough.  The result may then be a superset of   */
+/*      the matching features, so callers must still evaluate the       */
+/*      query on the returned features.                                 */
 /************************************************************************/
 
 static int CompareGIntBig(const void *pa, const void *pb)
@@ -510,9 +692,22 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
     {
         GIntBig nFIDCount1 = 0, nFIDCount2 = 0;
         GIntBig* panFIDList1 = EvaluateAgainstIndices( psExpr->papoSubExpr[0], poLayer, nFIDCount1 );
-        GIntBig* panFIDList2 = panFIDList1 == NULL ? NULL :
+        GIntBig* panFIDList2 = (panFIDList1 == NULL && psExpr->nOperation == SWQ_OR) ? NULL :
                             EvaluateAgainstIndices( psExpr->papoSubExpr[1], poLayer, nFIDCount2 );
         GIntBig* panFIDList = NULL;
+
+        /* For an AND, the FIDs of the indexed side are a superset of the result */
+        if (psExpr->nOperation == SWQ_AND &&
+            (panFIDList1 == NULL || panFIDList2 == NULL))
+        {
+            if (panFIDList1 != NULL)
+            {
+                nFIDCount = nFIDCount1;
+                return panFIDList1;
+            }
+            nFIDCount = nFIDCount2;
+            return panFIDList2;
+        }
         if (panFIDList1 != NULL && panFIDList2 != NULL)
         {
             if (psExpr->nOperation == SWQ_OR )
@@ -528,7 +723,8 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
         return panFIDList;
     }
 
-    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
+    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN
+          || OGRIsIndexRangeOperation( psExpr ))
         || psExpr->nSubExprCount < 2 )
         return NULL;
 
@@ -536,7 +732,8 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
     swq_expr_node *poValue = psExpr->papoSubExpr[1];
     
     if( poColumn->eNodeType != SNT_COLUMN
-        || poValue->eNodeType != SNT_CONSTANT )
+        || poValue->eNodeType != SNT_CONSTANT
+        || poColumn->field_index >= poLayer->GetLayerDefn()->GetFieldCount() )
         return NULL;
 
     poIndex = poLayer->GetIndex()->GetFieldIndex( poColumn->field_index );
@@ -551,6 +748,89 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
 
     poFieldDefn = poLayer->GetLayerDefn()->GetFieldDefn(poColumn->field_index);
 
+/* -------------------------------------------------------------------- */
+/*      Handle range comparisons and LIKE on ordered indexes.           */
+/* -------------------------------------------------------------------- */
+    if( OGRIsIndexRangeOperation( psExpr ) )
+    {
+        if( !poIndex->SupportsRangeMatches() )
+            return NULL;
+
+        GIntBig *panFIDs = NULL;
+        int nFIDCount32 = 0;
+        OGRFieldType eType = poFieldDefn->GetType();
+
+        if( psExpr->nOperation == SWQ_LIKE )
+        {
+            /* Only the literal part before the first wildcard is used */
+            if( eType != OFTString || poValue->field_type != SWQ_STRING
+                || poValue->is_null )
+                return NULL;
+
+            CPLString osPrefix( poValue->string_value );
+            size_t nWildcard = osPrefix.find_first_of( "%_" );
+            if( nWildcard != std::string::npos )
+                osPrefix.resize( nWildcard );
+            if( osPrefix.empty() )
+                return NULL;
+
+            panFIDs = poIndex->GetPrefixMatches( osPrefix, &nFIDCount32 );
+        }
+        else
+        {
+            OGRField sMin, sMax;
+            OGRField *psMin = NULL, *psMax = NULL;
+            int bMinIncluded = FALSE, bMaxIncluded = FALSE;
+
+            switch( psExpr->nOperation )
+            {
+              case SWQ_GE:
+                bMinIncluded = TRUE;
+                /* fallthrough */
+              case SWQ_GT:
+                if( !OGRGetIndexBound( eType, poValue, TRUE,
+                                       &sMin, &bMinIncluded ) )
+                    return NULL;
+                psMin = &sMin;
+                break;
+
+              case SWQ_LE:
+                bMaxIncluded = TRUE;
+                /* fallthrough */
+              case SWQ_LT:
+                if( !OGRGetIndexBound( eType, poValue, FALSE,
+                                       &sMax, &bMaxIncluded ) )
+                    return NULL;
+                psMax = &sMax;
+                break;
+
+              default: /* SWQ_BETWEEN */
+                bMinIncluded = TRUE;
+                bMaxIncluded = TRUE;
+                if( !OGRGetIndexBound( eType, poValue, TRUE,
+                                       &sMin, &bMinIncluded )
+                    || !OGRGetIndexBound( eType, psExpr->papoSubExpr[2],
+                                          FALSE, &sMax, &bMaxIncluded ) )
+                    return NULL;
+                psMin = &sMin;
+                psMax = &sMax;
+                break;
+            }
+
+            panFIDs = poIndex->GetRangeMatches( psMin, bMinIncluded,
+                                                psMax, bMaxIncluded,
+                                                &nFIDCount32 );
+        }
+
+        nFIDCount = nFIDCount32;
+        if (panFIDs != NULL && nFIDCount > 1)
+        {
+            /* the returned FIDs are expected to be in sorted order */
+            qsort(panFIDs, (size_t)nFIDCount, sizeof(GIntBig), CompareGIntBig);
+        }
+        return panFIDs;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Handle the case of an IN operation.                             */
 /* -------------------------------------------------------------------- */
@@ -559,6 +839,7 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
         int nLength;
         GIntBig *panFIDs = NULL;
         int iIN;
+        int nFIDCount32 = 0;
 
         for( iIN = 1; iIN < psExpr->nSubExprCount; iIN++ )
         {
@@ -591,7 +872,6 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
                 return NULL;
             }
 
-            int nFIDCount32 = 0;
             panFIDs = poIndex->GetAllMatches( &sValue, panFIDs, &nFIDCount32, &nLength );
             nFIDCount = nFIDCount32;
         }
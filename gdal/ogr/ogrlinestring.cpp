@@ -833,43 +833,15 @@ OGRErr OGRSimpleCurve::importFromWkb( unsigned char * pabyData,
         return OGRERR_FAILURE;
 
 /* -------------------------------------------------------------------- */
-/*      Get the vertex.                                                 */
+/*      Get the vertex, byte swapping on the fly if needed.             */
 /* -------------------------------------------------------------------- */
-    int i = 0;
-    
     if( getCoordinateDimension() == 3 )
-    {
-        for( i = 0; i < nPointCount; i++ )
-        {
-            memcpy( paoPoints + i, pabyData + 9 + i*24, 16 );
-            memcpy( padfZ + i, pabyData + 9 + 16 + i*24, 8 );
-        }
-    }
+        OGRReadWkbXYZ( pabyData + 9, paoPoints, padfZ, nPointCount,
+                       OGR_SWAP( eByteOrder ) );
     else
-    {
-        memcpy( paoPoints, pabyData + 9, 16 * nPointCount );
-    }
-    
-/* -------------------------------------------------------------------- */
-/*      Byte swap if needed.                                            */
-/* -------------------------------------------------------------------- */
-    if( OGR_SWAP( eByteOrder ) )
-    {
-        for( i = 0; i < nPointCount; i++ )
-        {
-            CPL_SWAPDOUBLE( &(paoPoints[i].x) );
-            CPL_SWAPDOUBLE( &(paoPoints[i].y) );
-        }
+        OGRCopyWkbDoubles( paoPoints, pabyData + 9, 2 * nPointCount,
+                           OGR_SWAP( eByteOrder ) );
 
-        if( getCoordinateDimension() == 3 )
-        {
-            for( i = 0; i < nPointCount; i++ )
-            {
-                CPL_SWAPDOUBLE( padfZ + i );
-            }
-        }
-    }
-    
     return OGRERR_NONE;
 }
 
@@ -912,23 +884,7 @@ OGRErr  OGRSimpleCurve::exportToWkb( OGRwkbByteOrder eByteOrder,
     memcpy( pabyData+5, &nPointCount, 4 );
 
 /* -------------------------------------------------------------------- */
-/*      Copy in the raw data.                                           */
-/* -------------------------------------------------------------------- */
-    int         i;
-    
-    if( getCoordinateDimension() == 3 )
-    {
-        for( i = 0; i < nPointCount; i++ )
-        {
-            memcpy( pabyData + 9 + 24*i, paoPoints+i, 16 );
-            memcpy( pabyData + 9 + 16 + 24*i, padfZ+i, 8 );
-        }
-    }
-    else
-        memcpy( pabyData+9, paoPoints, 16 * nPointCount );
-
-/* -------------------------------------------------------------------- */
-/*      Swap if needed.                                                 */
+/*      Swap the count if needed.                                       */
 /* -------------------------------------------------------------------- */
     if( OGR_SWAP( eByteOrder ) )
     {
@@ -936,13 +892,18 @@ OGRErr  OGRSimpleCurve::exportToWkb( OGRwkbByteOrder eByteOrder,
 
         nCount = CPL_SWAP32( nPointCount );
         memcpy( pabyData+5, &nCount, 4 );
-
-        for( i = getCoordinateDimension() * nPointCount - 1; i >= 0; i-- )
-        {
-            CPL_SWAP64PTR( pabyData + 9 + 8 * i );
-        }
     }
-    
+
+/* -------------------------------------------------------------------- */
+/*      Copy in the raw data, byte swapping on the fly if needed.       */
+/* -------------------------------------------------------------------- */
+    if( getCoordinateDimension() == 3 )
+        OGRWriteWkbXYZ( pabyData + 9, paoPoints, padfZ, nPointCount,
+                        OGR_SWAP( eByteOrder ) );
+    else
+        OGRCopyWkbDoubles( pabyData + 9, paoPoints, 2 * nPointCount,
+                           OGR_SWAP( eByteOrder ) );
+
     return OGRERR_NONE;
 }
 
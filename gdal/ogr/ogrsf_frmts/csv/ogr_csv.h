@@ -32,6 +32,7 @@
 #define _OGR_CSV_H_INCLUDED
 
 #include "ogrsf_frmts.h"
+#include <vector>
 
 typedef enum
 {
@@ -96,8 +97,19 @@ class OGRCSVLayer : public OGRLayer
     
     int                 bWarningBadTypeOrWidth;
     int                 bKeepSourceColumns;
-    
-    char              **GetNextLineTokens();
+
+    /* Buffered reading of the records, split in place into tokens */
+    char               *pszReadBuffer;
+    size_t              nReadBufferAlloc;
+    size_t              nReadBufferLen;
+    size_t              nReadBufferPos;
+    int                 bReadBufferEOF;
+    std::vector<char*>  apszLineTokens;
+
+    void                ResetReadBuffer();
+    int                 FillReadBuffer( size_t nKeepFrom );
+    char               *ReadNextRecord();
+    char              **GetNextLineTokens( int *pnTokens = NULL );
 
   public:
     OGRCSVLayer( const char *pszName, VSILFILE *fp, const char *pszFilename,
@@ -110,6 +122,8 @@ class OGRCSVLayer : public OGRLayer
 
     void                ResetReading();
     OGRFeature *        GetNextFeature();
+    virtual int         GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures );
     virtual OGRFeature* GetFeature( GIntBig nFID );
 
     OGRFeatureDefn *    GetLayerDefn() { return poFeatureDefn; }
@@ -202,6 +202,163 @@ char **OGRCSVReadParseLineL( VSILFILE * fp, char chDelimiter,
     return papszReturn;
 }
 
+/************************************************************************/
+/*                          OGRCSVSplitRecord()                         */
+/*                                                                      */
+/*      Split a record in place into tokens, with the same quoting      */
+/*      semantics as CSVSplitLine(), but without any allocation         */
+/*      once the token array has grown.  Returns the number of          */
+/*      tokens, the array being also NULL terminated.                   */
+/************************************************************************/
+
+static int OGRCSVSplitRecord( char *pszRecord, char chDelimiter,
+                              int bHonourStrings,
+                              std::vector<char*>& apszTokens )
+
+{
+    apszTokens.resize(0);
+
+    if( *pszRecord != '\0' &&
+        (!bHonourStrings || strchr(pszRecord, '"') == NULL) )
+    {
+        /* Simple case: no quotes.  strchr() is much faster than a */
+        /* character by character loop on most C libraries. */
+        char *pszToken = pszRecord;
+        while( TRUE )
+        {
+            apszTokens.push_back( pszToken );
+            char *pszDelimiter = strchr( pszToken, chDelimiter );
+            if( pszDelimiter == NULL )
+                break;
+            *pszDelimiter = '\0';
+            pszToken = pszDelimiter + 1;
+        }
+    }
+    else
+    {
+        /* The unquoted token is never longer than the source, so it */
+        /* can be written over it. */
+        char *pszIn = pszRecord;
+        char *pszOut = pszRecord;
+        while( *pszIn != '\0' )
+        {
+            int bInString = FALSE;
+            int bEndedOnDelimiter = FALSE;
+            char *pszToken = pszOut;
+
+            for( ; *pszIn != '\0'; pszIn++ )
+            {
+                if( !bInString && *pszIn == chDelimiter )
+                {
+                    pszIn++;
+                    bEndedOnDelimiter = TRUE;
+                    break;
+                }
+
+                if( *pszIn == '"' )
+                {
+                    if( !bInString || pszIn[1] != '"' )
+                    {
+                        bInString = !bInString;
+                        continue;
+                    }
+                    else  /* doubled quotes in string resolve to one quote */
+                    {
+                        pszIn++;
+                    }
+                }
+
+                *pszOut++ = *pszIn;
+            }
+
+            *pszOut++ = '\0';
+            apszTokens.push_back( pszToken );
+
+            /* If the last token is an empty token, then we have to catch */
+            /* it now, otherwise we won't reenter the loop and it will be lost. */
+            if( *pszIn == '\0' && bEndedOnDelimiter )
+                apszTokens.push_back( pszIn );
+        }
+    }
+
+    int nTokens = (int) apszTokens.size();
+    apszTokens.push_back( NULL );
+    return nTokens;
+}
+
+/************************************************************************/
+/*                          OGRCSVParseNumber()                         */
+/*                                                                      */
+/*      Parse in a single pass the most common forms of numbers,        */
+/*      that is [+-]?[0-9]+ and [+-]?[0-9]+\.[0-9]+, when the result    */
+/*      is guaranteed to be the same as with strtol() / CPLStrtod().    */
+/*      Returns CPL_VALUE_STRING for any other form, that must then     */
+/*      go through the generic code path.                               */
+/************************************************************************/
+
+static CPLValueType OGRCSVParseNumber( const char *pszToken,
+                                       GIntBig *pnValue, double *pdfValue )
+
+{
+    static const double adfPowersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    const char *pszIter = pszToken;
+    int bNegative = FALSE;
+    if( *pszIter == '-' )
+    {
+        bNegative = TRUE;
+        pszIter++;
+    }
+    else if( *pszIter == '+' )
+        pszIter++;
+
+    GUIntBig nMantissa = 0;
+    int nDigits = 0;
+    while( *pszIter >= '0' && *pszIter <= '9' )
+    {
+        nMantissa = nMantissa * 10 + (*pszIter - '0');
+        pszIter++;
+        /* 18 digits always fit in a 64 bit integer */
+        if( ++nDigits > 18 )
+            return CPL_VALUE_STRING;
+    }
+    if( nDigits == 0 )
+        return CPL_VALUE_STRING;
+
+    if( *pszIter == '\0' )
+    {
+        *pnValue = bNegative ? -(GIntBig)nMantissa : (GIntBig)nMantissa;
+        *pdfValue = bNegative ? -(double)nMantissa : (double)nMantissa;
+        return CPL_VALUE_INTEGER;
+    }
+
+    if( *pszIter != '.' )
+        return CPL_VALUE_STRING;
+    pszIter++;
+
+    int nDecimals = 0;
+    while( *pszIter >= '0' && *pszIter <= '9' )
+    {
+        nMantissa = nMantissa * 10 + (*pszIter - '0');
+        pszIter++;
+        nDecimals++;
+        /* Beyond 15 significant digits, the mantissa might not be */
+        /* exactly representable as a double, and the division below */
+        /* would not be correctly rounded anymore. */
+        if( ++nDigits > 15 )
+            return CPL_VALUE_STRING;
+    }
+    if( nDecimals == 0 || *pszIter != '\0' )
+        return CPL_VALUE_STRING;
+
+    /* Both operands are exact, so the quotient is correctly rounded */
+    double dfValue = (double) nMantissa / adfPowersOf10[nDecimals];
+    *pdfValue = bNegative ? -dfValue : dfValue;
+    return CPL_VALUE_REAL;
+}
+
 /************************************************************************/
 /*                            OGRCSVLayer()                             */
 /*                                                                      */
@@ -250,6 +407,12 @@ OGRCSVLayer::OGRCSVLayer( const char *pszLayerNameIn,
     nTotalFeatures = -1;
     bWarningBadTypeOrWidth = FALSE;
     bKeepSourceColumns = FALSE;
+
+    pszReadBuffer = NULL;
+    nReadBufferAlloc = 0;
+    nReadBufferLen = 0;
+    nReadBufferPos = 0;
+    bReadBufferEOF = FALSE;
 }
 
 /************************************************************************/
@@ -704,6 +867,14 @@ char** OGRCSVLayer::AutodetectFieldTypes(char** papszOpenOptions, int nFieldCoun
     int iField;
     char** papszFieldTypes = NULL;
 
+    /* Records are normally read ahead through the read buffer, so */
+    /* position the file right after the header line for sampling */
+    VSIRewindL( fpCSV );
+    ResetReadBuffer();
+    if( bHasFieldNames )
+        CSLDestroy( OGRCSVReadParseLineL( fpCSV, chDelimiter,
+                                          bDontHonourStrings ) );
+
     /* Use 1000000 as default maximum distance to be compatible with /vsistdin/ */
     /* caching */
     int nBytes = atoi(CSLFetchNameValueDef(papszOpenOptions,
@@ -1016,6 +1187,7 @@ OGRCSVLayer::~OGRCSVLayer()
 
     poFeatureDefn->Release();
     CPLFree(pszFilename);
+    CPLFree(pszReadBuffer);
 
     if (fpCSV)
         VSIFCloseL( fpCSV );
@@ -1031,8 +1203,10 @@ void OGRCSVLayer::ResetReading()
     if (fpCSV)
         VSIRewindL( fpCSV );
 
+    ResetReadBuffer();
+
     if( bHasFieldNames )
-        CSLDestroy( OGRCSVReadParseLineL( fpCSV, chDelimiter, bDontHonourStrings ) );
+        ReadNextRecord();
 
     bNeedRewindBeforeRead = FALSE;
 
@@ -1040,28 +1214,210 @@ void OGRCSVLayer::ResetReading()
 }
 
 /************************************************************************/
-/*                        GetNextLineTokens()                           */
+/*                          ResetReadBuffer()                           */
+/*                                                                      */
+/*      Forget the buffered data, so that the next record is read       */
+/*      from the current position of the file.                          */
 /************************************************************************/
 
-char** OGRCSVLayer::GetNextLineTokens()
+void OGRCSVLayer::ResetReadBuffer()
+
 {
+    nReadBufferLen = 0;
+    nReadBufferPos = 0;
+    bReadBufferEOF = FALSE;
+}
+
+/************************************************************************/
+/*                           FillReadBuffer()                           */
+/*                                                                      */
+/*      Move the data from nKeepFrom to the beginning of the read       */
+/*      buffer, growing it if needed, and append the following bytes    */
+/*      of the file.                                                    */
+/************************************************************************/
+
+#define CSV_READ_CHUNK_SIZE     (256 * 1024)
+
+int OGRCSVLayer::FillReadBuffer( size_t nKeepFrom )
+
+{
+    size_t nKeep = nReadBufferLen - nKeepFrom;
+    if( nKeep > 0 && nKeepFrom > 0 )
+        memmove( pszReadBuffer, pszReadBuffer + nKeepFrom, nKeep );
+    nReadBufferLen = nKeep;
+    nReadBufferPos = 0;
+
+    /* One byte is reserved for the terminating nul character */
+    if( nReadBufferAlloc < nKeep + CSV_READ_CHUNK_SIZE + 1 )
+    {
+        size_t nNewAlloc = MAX( nReadBufferAlloc * 2,
+                                nKeep + CSV_READ_CHUNK_SIZE + 1 );
+        char *pszNewBuffer = (char *) VSIRealloc( pszReadBuffer, nNewAlloc );
+        if( pszNewBuffer == NULL )
+        {
+            CPLError( CE_Failure, CPLE_OutOfMemory,
+                      "Cannot allocate %lu bytes for a CSV record.",
+                      (unsigned long) nNewAlloc );
+            bReadBufferEOF = TRUE;
+            return FALSE;
+        }
+        pszReadBuffer = pszNewBuffer;
+        nReadBufferAlloc = nNewAlloc;
+    }
+
+    size_t nRead = VSIFReadL( pszReadBuffer + nReadBufferLen, 1,
+                              nReadBufferAlloc - 1 - nReadBufferLen, fpCSV );
+    if( nRead == 0 )
+        bReadBufferEOF = TRUE;
+    nReadBufferLen += nRead;
+    return nRead > 0;
+}
+
+/************************************************************************/
+/*                           ReadNextRecord()                           */
+/*                                                                      */
+/*      Return the next record, that is the next line, joined with      */
+/*      the following ones as long as it has an odd number of           */
+/*      quotes, as OGRCSVReadParseLineL() does.  The record is nul      */
+/*      terminated and stays in the read buffer, so it is only valid    */
+/*      till the next call.                                             */
+/************************************************************************/
+
+char *OGRCSVLayer::ReadNextRecord()
+
+{
+    /* Special fix to read NdfcFacilities.xls that has non-balanced double quotes */
+    const int bHonourStrings = !(chDelimiter == '\t' && bDontHonourStrings);
+
+    if( fpCSV == NULL )
+        return NULL;
+
+    size_t nStart = nReadBufferPos;
+    size_t nLineStart = nStart;
+    /* End of the part of the record already joined, which is behind */
+    /* nLineStart once a two character line break has been normalized */
+    size_t nWrite = nStart;
+    int nQuotes = 0;
+
+    while( TRUE )
+    {
 /* -------------------------------------------------------------------- */
-/*      Read the CSV record.                                            */
+/*      Find the end of the current line.  Line breaks are the same     */
+/*      as for CPLReadLineL(): LF, CR, CRLF or LFCR.                    */
+/* -------------------------------------------------------------------- */
+        char *pszLine = pszReadBuffer + nLineStart;
+        size_t nAvailable = nReadBufferLen - nLineStart;
+        char *pszEOL = NULL;
+        if( nAvailable > 0 )
+        {
+            char *pszLF = (char *) memchr( pszLine, '\n', nAvailable );
+            char *pszCR = (char *) memchr( pszLine, '\r',
+                            (pszLF != NULL) ? (size_t)(pszLF - pszLine) : nAvailable );
+            pszEOL = (pszCR != NULL) ? pszCR : pszLF;
+        }
+
+        /* We need the character after the end of line, to know if the */
+        /* line break is made of one or two characters. */
+        if( (pszEOL == NULL ||
+             pszEOL + 1 == pszReadBuffer + nReadBufferLen) && !bReadBufferEOF )
+        {
+            FillReadBuffer( nStart );
+            nLineStart -= nStart;
+            nWrite -= nStart;
+            nStart = 0;
+            continue;
+        }
+
+        size_t nLineEnd = (pszEOL != NULL) ?
+            (size_t)(pszEOL - pszReadBuffer) : nReadBufferLen;
+        if( pszEOL == NULL && nLineEnd == nStart )
+        {
+            nReadBufferPos = nReadBufferLen;
+            return NULL;
+        }
+
+        if( bHonourStrings )
+        {
+            const char *pszQuote = pszLine;
+            const char *pszLineEnd = pszReadBuffer + nLineEnd;
+            while( (pszQuote = (const char *)
+                        memchr( pszQuote, '"', pszLineEnd - pszQuote )) != NULL )
+            {
+                nQuotes ++;
+                pszQuote ++;
+            }
+        }
+
+        size_t nEOLSize = 0;
+        if( pszEOL != NULL )
+        {
+            nEOLSize = 1;
+            if( nLineEnd + 1 < nReadBufferLen &&
+                (pszEOL[1] == '\n' || pszEOL[1] == '\r') && pszEOL[1] != pszEOL[0] )
+                nEOLSize = 2;
+        }
+
+        /* Join the line to the previous ones of the record */
+        size_t nLineLen = nLineEnd - nLineStart;
+        if( nWrite != nLineStart && nLineLen > 0 )
+            memmove( pszReadBuffer + nWrite, pszReadBuffer + nLineStart,
+                     nLineLen );
+        nWrite += nLineLen;
+
+        if( (nQuotes % 2) == 0 || pszEOL == NULL )
+        {
+            /* At end of file, the line break that was added below must */
+            /* not be kept */
+            if( pszEOL == NULL && nLineLen == 0 && nWrite > nStart )
+                nWrite --;
+
+            pszReadBuffer[nWrite] = '\0';
+            nReadBufferPos = (pszEOL != NULL) ? nLineEnd + nEOLSize : nReadBufferLen;
+
+            /* Skip BOM */
+            GByte *pabyData = (GByte *) pszReadBuffer + nStart;
+            if( nWrite - nStart >= 3 &&
+                pabyData[0] == 0xEF && pabyData[1] == 0xBB && pabyData[2] == 0xBF )
+                nStart += 3;
+
+            return pszReadBuffer + nStart;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Odd number of quotes: the line break is part of a quoted        */
+/*      field, and is normalized to a single LF character.              */
 /* -------------------------------------------------------------------- */
-    char **papszTokens;
+        pszReadBuffer[nWrite ++] = '\n';
+        nLineStart = nLineEnd + nEOLSize;
+    }
+}
+
+/************************************************************************/
+/*                        GetNextLineTokens()                           */
+/*                                                                      */
+/*      The returned tokens belong to the layer, and are only valid     */
+/*      till the next call.                                             */
+/************************************************************************/
+
+char** OGRCSVLayer::GetNextLineTokens( int *pnTokens )
+{
+    const int bHonourStrings = !(chDelimiter == '\t' && bDontHonourStrings);
 
     while(TRUE)
     {
-        papszTokens = OGRCSVReadParseLineL( fpCSV, chDelimiter, bDontHonourStrings );
-        if( papszTokens == NULL )
+        char *pszRecord = ReadNextRecord();
+        if( pszRecord == NULL )
             return NULL;
 
-        if( papszTokens[0] != NULL )
-            break;
-
-        CSLDestroy(papszTokens);
+        int nTokens = OGRCSVSplitRecord( pszRecord, chDelimiter,
+                                         bHonourStrings, apszLineTokens );
+        if( nTokens > 0 )
+        {
+            if( pnTokens != NULL )
+                *pnTokens = nTokens;
+            return &apszLineTokens[0];
+        }
     }
-    return papszTokens;
 }
 
 /************************************************************************/
@@ -1076,10 +1432,8 @@ OGRFeature* OGRCSVLayer::GetFeature(GIntBig nFID)
         ResetReading();
     while( nNextFID < nFID )
     {
-        char **papszTokens = GetNextLineTokens();
-        if( papszTokens == NULL )
+        if( GetNextLineTokens() == NULL )
             return NULL;
-        CSLDestroy(papszTokens);
         nNextFID ++;
     }
     return GetNextUnfilteredFeature();
@@ -1098,7 +1452,8 @@ OGRFeature * OGRCSVLayer::GetNextUnfilteredFeature()
 /* -------------------------------------------------------------------- */
 /*      Read the CSV record.                                            */
 /* -------------------------------------------------------------------- */
-    char **papszTokens = GetNextLineTokens();
+    int nTokens = 0;
+    char **papszTokens = GetNextLineTokens( &nTokens );
     if( papszTokens == NULL )
         return NULL;
 
@@ -1114,7 +1469,7 @@ OGRFeature * OGRCSVLayer::GetNextUnfilteredFeature()
 /* -------------------------------------------------------------------- */
     int         iAttr;
     int         iOGRField = 0;
-    int         nAttrCount = MIN(CSLCount(papszTokens), nCSVFieldCount );
+    int         nAttrCount = MIN(nTokens, nCSVFieldCount );
     CPLValueType eType;
     
     for( iAttr = 0; !bIsEurostatTSV && iAttr < nAttrCount; iAttr++, iOGRField++)
@@ -1173,10 +1528,29 @@ OGRFeature * OGRCSVLayer::GetNextUnfilteredFeature()
                     if (chComma)
                         *chComma = '.';
                 }
-                eType = CPLGetValueType(papszTokens[iAttr]);
+
+                /* Try first to set the value directly from the token, */
+                /* without going through CPLGetValueType() and the */
+                /* string version of SetField() */
+                GIntBig nVal = 0;
+                double dfVal = 0.0;
+                eType = OGRCSVParseNumber(papszTokens[iAttr], &nVal, &dfVal);
+                if( eType == CPL_VALUE_INTEGER && eFieldType == OFTInteger &&
+                    nVal >= INT_MIN && nVal <= INT_MAX )
+                    poFeature->SetField( iOGRField, (int)nVal );
+                else if( eType == CPL_VALUE_INTEGER &&
+                         eFieldType == OFTInteger64 )
+                    poFeature->SetField( iOGRField, nVal );
+                else if( eType != CPL_VALUE_STRING && eFieldType == OFTReal )
+                    poFeature->SetField( iOGRField, dfVal );
+                else
+                {
+                    eType = CPLGetValueType(papszTokens[iAttr]);
+                    if ( eType == CPL_VALUE_INTEGER || eType == CPL_VALUE_REAL )
+                        poFeature->SetField( iOGRField, papszTokens[iAttr] );
+                }
                 if ( eType == CPL_VALUE_INTEGER || eType == CPL_VALUE_REAL )
                 {
-                    poFeature->SetField( iOGRField, papszTokens[iAttr] );
                     if( !bWarningBadTypeOrWidth &&
                         (eFieldType == OFTInteger || eFieldType == OFTInteger64) && eType == CPL_VALUE_REAL )
                     {
@@ -1353,8 +1727,6 @@ OGRFeature * OGRCSVLayer::GetNextUnfilteredFeature()
         }
     }
 
-    CSLDestroy( papszTokens );
-
 /* -------------------------------------------------------------------- */
 /*      Translate the record id.                                        */
 /* -------------------------------------------------------------------- */
@@ -1366,6 +1738,190 @@ OGRFeature * OGRCSVLayer::GetNextUnfilteredFeature()
 }
 
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/*                                                                      */
+/*      For plain CSV files without filters, convert the tokens of      */
+/*      each record directly into the batch columns.  Otherwise use     */
+/*      the generic implementation.                                     */
+/************************************************************************/
+
+int OGRCSVLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                      int nMaxFeatures )
+
+{
+    int iField;
+    int nFieldCount = poFeatureDefn->GetFieldCount();
+    int bCanUseBatch = m_poAttrQuery == NULL && m_poFilterGeom == NULL &&
+                       !bIsEurostatTSV && !bKeepSourceColumns &&
+                       iNfdcLatitudeS == -1 && iLatitudeField == -1;
+
+    for( iField = 0; bCanUseBatch && iField < nFieldCount; iField++ )
+    {
+        switch( poFeatureDefn->GetFieldDefn(iField)->GetType() )
+        {
+            case OFTInteger:
+            case OFTInteger64:
+            case OFTReal:
+            case OFTString:
+            case OFTDate:
+            case OFTTime:
+            case OFTDateTime:
+                break;
+            default:
+                bCanUseBatch = FALSE;
+                break;
+        }
+    }
+
+    if( !bCanUseBatch )
+        return OGRLayer::GetNextFeatureBatch( poBatch, nMaxFeatures );
+
+    poBatch->Reset();
+
+    if( !ValidateFeatureBatch( poBatch ) )
+        return 0;
+
+    if( bNeedRewindBeforeRead )
+        ResetReading();
+
+    if( fpCSV == NULL )
+        return 0;
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        int nTokens = 0;
+        char **papszTokens = GetNextLineTokens( &nTokens );
+        if( papszTokens == NULL )
+            break;
+
+        if( !poBatch->BeginFeature( nNextFID ) )
+            break;
+
+        int nAttrCount = MIN(nTokens, nCSVFieldCount );
+        int bOK = TRUE;
+
+        for( iField = 0; bOK && iField < nAttrCount; iField++ )
+        {
+            char *pszToken = papszTokens[iField];
+
+            int iGeom = panGeomFieldIndex[iField];
+            if( iGeom >= 0 && pszToken[0] != '\0' &&
+                !(poFeatureDefn->GetGeomFieldDefn(iGeom)->IsIgnored()) )
+            {
+                char *pszWKT = pszToken;
+                OGRGeometry *poGeom = NULL;
+
+                if( OGRGeometryFactory::createFromWkt( &pszWKT, NULL, &poGeom )
+                    == OGRERR_NONE )
+                {
+                    GByte *pabyWKB = poBatch->ReserveGeomFieldWKB(
+                                            iGeom, poGeom->WkbSize() );
+                    if( pabyWKB != NULL )
+                        poGeom->exportToWkb( wkbNDR, pabyWKB, wkbVariantIso );
+                    else
+                        bOK = FALSE;
+                    delete poGeom;
+                }
+            }
+
+            OGRFieldDefn* poFieldDefn = poFeatureDefn->GetFieldDefn(iField);
+            if( poFieldDefn->IsIgnored() )
+                continue;
+
+            OGRFieldType eFieldType = poFieldDefn->GetType();
+            int bInvalid = FALSE;
+
+            if( eFieldType == OFTString )
+            {
+                bOK = poBatch->SetFieldBinary( iField, pszToken,
+                                               strlen(pszToken) );
+            }
+            else if( pszToken[0] == '\0' )
+            {
+                /* leave unset */
+            }
+            else if( eFieldType == OFTInteger &&
+                     poFieldDefn->GetSubType() == OFSTBoolean )
+            {
+                if( OGRCSVIsTrue(pszToken) || strcmp(pszToken, "1") == 0 )
+                    poBatch->SetFieldInteger( iField, 1 );
+                else if( OGRCSVIsFalse(pszToken) ||
+                         strcmp(pszToken, "0") == 0 )
+                    poBatch->SetFieldInteger( iField, 0 );
+                else
+                    bInvalid = TRUE;
+            }
+            else if( eFieldType == OFTReal || eFieldType == OFTInteger ||
+                     eFieldType == OFTInteger64 )
+            {
+                if (chDelimiter == ';' && eFieldType == OFTReal)
+                {
+                    char* chComma = strchr(pszToken, ',');
+                    if (chComma)
+                        *chComma = '.';
+                }
+                GIntBig nVal = 0;
+                double dfVal = 0.0;
+                CPLValueType eType = OGRCSVParseNumber(pszToken, &nVal, &dfVal);
+                if( eType == CPL_VALUE_INTEGER && eFieldType == OFTInteger64 )
+                    poBatch->SetFieldInteger64( iField, nVal );
+                else if( eType == CPL_VALUE_INTEGER && eFieldType == OFTInteger )
+                    poBatch->SetFieldInteger( iField,
+                        (nVal > INT_MAX) ? INT_MAX :
+                        (nVal < INT_MIN) ? INT_MIN : (int) nVal );
+                else if( eType != CPL_VALUE_STRING && eFieldType == OFTReal )
+                    poBatch->SetFieldDouble( iField, dfVal );
+                else if( (eType = CPLGetValueType(pszToken)) != CPL_VALUE_INTEGER &&
+                         eType != CPL_VALUE_REAL )
+                    bInvalid = TRUE;
+                else if( eFieldType == OFTReal )
+                    poBatch->SetFieldDouble( iField, CPLAtof(pszToken) );
+                else
+                {
+                    if( eType == CPL_VALUE_REAL )
+                        bInvalid = TRUE;
+                    if( eFieldType == OFTInteger64 )
+                        poBatch->SetFieldInteger64( iField,
+                                                    CPLAtoGIntBig(pszToken) );
+                    else
+                    {
+                        long nVal = strtol(pszToken, NULL, 10);
+                        poBatch->SetFieldInteger( iField,
+                            (nVal > INT_MAX) ? INT_MAX :
+                            (nVal < INT_MIN) ? INT_MIN : (int) nVal );
+                    }
+                }
+            }
+            else
+            {
+                OGRField sField;
+                if( OGRParseDate( pszToken, &sField, 0 ) )
+                    poBatch->SetFieldDateTime( iField, &sField );
+                else
+                    bInvalid = TRUE;
+            }
+
+            if( bInvalid && !bWarningBadTypeOrWidth )
+            {
+                bWarningBadTypeOrWidth = TRUE;
+                CPLError(CE_Warning, CPLE_AppDefined,
+                         "Invalid value type found in record %d for field %s. "
+                         "This warning will no longer be emitted",
+                         nNextFID, poFieldDefn->GetNameRef());
+            }
+        }
+
+        nNextFID++;
+        m_nFeaturesRead++;
+
+        if( !bOK )
+            break;
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                           GetNextFeature()                           */
 /************************************************************************/
@@ -1964,19 +2520,10 @@ GIntBig OGRCSVLayer::GetFeatureCount( int bForce )
 
     ResetReading();
 
-    char **papszTokens;
     nTotalFeatures = 0;
-    while(TRUE)
-    {
-        papszTokens = GetNextLineTokens();
-        if( papszTokens == NULL )
-            break;
-
+    while( GetNextLineTokens() != NULL )
         nTotalFeatures ++;
 
-        CSLDestroy(papszTokens);
-    }
-
     ResetReading();
 
     return nTotalFeatures;
@@ -82,3 +82,115 @@ OGRAttrIndex::OGRAttrIndex()
 OGRAttrIndex::~OGRAttrIndex()
 {
 }
+
+/************************************************************************/
+/*                        SupportsRangeMatches()                        */
+/*                                                                      */
+/*      Whether GetRangeMatches() and GetPrefixMatches() are            */
+/*      implemented by this index format.                               */
+/************************************************************************/
+
+int OGRAttrIndex::SupportsRangeMatches()
+{
+    return FALSE;
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/*                                                                      */
+/*      Return the FIDs of the features whose key is within a range,    */
+/*      as an OGRNullFID terminated list.  A NULL bound means no        */
+/*      bound.  Index formats that cannot answer range queries return   */
+/*      NULL.                                                           */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetRangeMatches( OGRField * /* psMin */,
+                                        int /* bMinIncluded */,
+                                        OGRField * /* psMax */,
+                                        int /* bMaxIncluded */,
+                                        int *pnFIDCount )
+{
+    *pnFIDCount = 0;
+    return NULL;
+}
+
+/************************************************************************/
+/*                          GetPrefixMatches()                          */
+/*                                                                      */
+/*      Return the FIDs of the features whose string key starts with    */
+/*      a prefix, case insensitively, as an OGRNullFID terminated       */
+/*      list.  Index formats that cannot answer such queries return     */
+/*      NULL.                                                           */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetPrefixMatches( const char * /* pszPrefix */,
+                                         int *pnFIDCount )
+{
+    *pnFIDCount = 0;
+    return NULL;
+}
+
+/************************************************************************/
+/*                  OGRGetGenericLayerIndexFilename()                   */
+/*                                                                      */
+/*      Name of the sidecar attribute index of a layer whose driver     */
+/*      does not manage attribute indexes itself.  Returns an empty     */
+/*      string if the dataset is not backed by a file or directory.     */
+/*                                                                      */
+/*      If posSourceFilename is not NULL, it receives the file whose    */
+/*      size and modification time tell whether the index is stale :    */
+/*      the dataset file, or for a directory the file of the layer      */
+/*      (same basename as the layer) if there is one.  It is empty      */
+/*      when it cannot be determined.                                   */
+/************************************************************************/
+
+CPLString OGRGetGenericLayerIndexFilename( GDALDataset *poDS,
+                                           OGRLayer *poLayer,
+                                           CPLString *posSourceFilename )
+
+{
+    const char *pszDSName = poDS->GetDescription();
+    VSIStatBufL sStat;
+
+    if( pszDSName == NULL || pszDSName[0] == '\0'
+        || VSIStatL( pszDSName, &sStat ) != 0 )
+        return "";
+
+    CPLString osLayerName( poLayer->GetName() );
+    for( size_t i = 0; i < osLayerName.size(); i++ )
+    {
+        if( !isalnum( (unsigned char) osLayerName[i] ) )
+            osLayerName[i] = '_';
+    }
+
+    if( posSourceFilename != NULL )
+        *posSourceFilename = pszDSName;
+
+    if( VSI_ISDIR( sStat.st_mode ) )
+    {
+        /* Writing the index changes the modification time of the */
+        /* directory, so it cannot be the source. */
+        if( posSourceFilename != NULL )
+        {
+            *posSourceFilename = "";
+            char **papszFiles = VSIReadDir( pszDSName );
+            for( int i = 0; papszFiles != NULL && papszFiles[i] != NULL; i++ )
+            {
+                if( EQUAL(CPLGetBasename(papszFiles[i]), poLayer->GetName())
+                    && !EQUAL(CPLGetExtension(papszFiles[i]), "btm") )
+                {
+                    *posSourceFilename =
+                        CPLFormFilename( pszDSName, papszFiles[i], NULL );
+                    break;
+                }
+            }
+            CSLDestroy( papszFiles );
+        }
+        return CPLFormFilename( pszDSName, osLayerName, "btm" );
+    }
+
+    return CPLFormFilename( CPLGetPath( pszDSName ),
+                            CPLSPrintf( "%s_%s", CPLGetBasename( pszDSName ),
+                                        osLayerName.c_str() ),
+                            "btm" );
+}
@@ -0,0 +1,1818 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Persistent B-tree implementation of OGRLayerAttrIndex, usable
+ *           by any layer supporting random reads.
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_attrind.h"
+#include "cpl_minixml.h"
+#include <algorithm>
+#include <vector>
+
+CPL_CVSID("$Id$");
+
+/*
+ * Layout of a .bti file.
+ *
+ * The file is a sequence of BTI_PAGE_SIZE bytes pages.  All integers are
+ * little endian.  Page 0 is the header :
+ *   - 8 bytes  : signature "OGRBTI01"
+ *   - int32    : key type (BTI_KEY_INTEGER, BTI_KEY_REAL or BTI_KEY_STRING)
+ *   - int32    : key size in bytes
+ *   - int32    : flags (BTI_FLAG_TRUNCATED if some string keys were truncated)
+ *   - int32    : depth of the tree, leaves included (0 for an empty index)
+ *   - int64    : number of entries
+ *   - int64    : page number of the root
+ *   - int64    : page number of the first leaf
+ *   - int64    : number of leaf pages
+ *
+ * Leaf pages follow the header, in key order, so that range scans read
+ * consecutive pages.  Interior pages come after the leaves, level by level,
+ * the root being the last page.  Each page starts with an int32 entry count
+ * and an int32 level (0 for leaves), followed by entries made of a key and
+ * an int64, which is the FID in leaves and the child page number in
+ * interior pages.  The key of an interior entry is the first key of the
+ * child page.
+ *
+ * Keys are encoded so that memcmp() gives the ordering of OGR SQL :
+ *   - integers as big endian 64 bit values with the sign bit flipped,
+ *   - reals as big endian IEEE doubles with the sign bit flipped for
+ *     positive values and all bits flipped for negative values,
+ *   - strings lower cased (OGR SQL comparisons are case insensitive),
+ *     truncated to BTI_MAX_KEY_SIZE and padded with nul bytes.
+ * Unset fields and NaN values are not indexed.
+ */
+
+#define BTI_SIGNATURE       "OGRBTI01"
+#define BTI_PAGE_SIZE       4096
+#define BTI_PAGE_HEADER     8
+#define BTI_MAX_KEY_SIZE    254
+
+#define BTI_KEY_INTEGER     1
+#define BTI_KEY_REAL        2
+#define BTI_KEY_STRING      3
+
+#define BTI_FLAG_TRUNCATED  1
+
+#define BTI_RUN_BUFFER_SIZE 65536
+
+/************************************************************************/
+/*                           Key encoding.                              */
+/************************************************************************/
+
+static int OGRBTreeGetKeyType( OGRFieldType eType )
+{
+    switch( eType )
+    {
+      case OFTInteger:
+      case OFTInteger64:
+        return BTI_KEY_INTEGER;
+      case OFTReal:
+        return BTI_KEY_REAL;
+      case OFTString:
+        return BTI_KEY_STRING;
+      default:
+        return 0;
+    }
+}
+
+static void OGRBTreeEncodeUInt64( GUIntBig nBits, GByte *pabyKey )
+{
+    for( int i = 7; i >= 0; i-- )
+    {
+        pabyKey[i] = (GByte) (nBits & 0xff);
+        nBits >>= 8;
+    }
+}
+
+static void OGRBTreeEncodeInteger( GIntBig nVal, GByte *pabyKey )
+{
+    OGRBTreeEncodeUInt64( ((GUIntBig) nVal) ^ (((GUIntBig) 1) << 63),
+                          pabyKey );
+}
+
+static void OGRBTreeEncodeReal( double dfVal, GByte *pabyKey )
+{
+    GUIntBig nBits;
+
+    if( dfVal == 0.0 )
+        dfVal = 0.0; /* so that -0.0 and 0.0 have the same key */
+    memcpy( &nBits, &dfVal, sizeof(double) );
+    if( nBits >> 63 )
+        nBits = ~nBits;
+    else
+        nBits ^= ((GUIntBig) 1) << 63;
+    OGRBTreeEncodeUInt64( nBits, pabyKey );
+}
+
+/* Returns the full length of the folded string, which may be larger */
+/* than the nMaxSize bytes written to pabyKey. */
+static size_t OGRBTreeEncodeString( const char *pszVal, GByte *pabyKey,
+                                    size_t nMaxSize )
+{
+    size_t nLen = strlen( pszVal );
+    for( size_t i = 0; i < nLen && i < nMaxSize; i++ )
+        pabyKey[i] = (GByte) tolower( (unsigned char) pszVal[i] );
+    return nLen;
+}
+
+static void OGRBTreeWriteInt32( GByte *pabyDst, GInt32 nVal )
+{
+    CPL_LSBPTR32( &nVal );
+    memcpy( pabyDst, &nVal, 4 );
+}
+
+static void OGRBTreeWriteInt64( GByte *pabyDst, GIntBig nVal )
+{
+    CPL_LSBPTR64( &nVal );
+    memcpy( pabyDst, &nVal, 8 );
+}
+
+static GInt32 OGRBTreeReadInt32( const GByte *pabySrc )
+{
+    GInt32 nVal;
+    memcpy( &nVal, pabySrc, 4 );
+    CPL_LSBPTR32( &nVal );
+    return nVal;
+}
+
+static GIntBig OGRBTreeReadInt64( const GByte *pabySrc )
+{
+    GIntBig nVal;
+    memcpy( &nVal, pabySrc, 8 );
+    CPL_LSBPTR64( &nVal );
+    return nVal;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          OGRBTreeIndexWriter                         */
+/*                                                                      */
+/*      Writes entries received in key order as a packed B-tree.        */
+/* ==================================================================== */
+/************************************************************************/
+
+class OGRBTreeIndexWriter
+{
+    VSILFILE           *fp;
+    int                 nKeyType;
+    int                 nKeySize;
+    int                 nFlags;
+    int                 nEntrySize;
+    int                 nEntriesPerPage;
+
+    GIntBig             nEntryCount;
+    GIntBig             nPageCount;     /* pages written, header included */
+    std::vector<GByte>  abyPage;
+    int                 nPageEntries;
+    int                 nPageLevel;
+
+    /* first key and page number of the pages of the level being written */
+    std::vector<GByte>  abyLevelKeys;
+    std::vector<GIntBig> anLevelPages;
+
+    int                 FlushPage();
+
+  public:
+                        OGRBTreeIndexWriter( VSILFILE *fpIn, int nKeyTypeIn,
+                                             int nKeySizeIn, int nFlagsIn );
+
+    int                 AddEntry( const GByte *pabyKey, size_t nKeyLen,
+                                  GIntBig nValue );
+    int                 Finish();
+};
+
+/************************************************************************/
+/*                        OGRBTreeIndexWriter()                         */
+/************************************************************************/
+
+OGRBTreeIndexWriter::OGRBTreeIndexWriter( VSILFILE *fpIn, int nKeyTypeIn,
+                                          int nKeySizeIn, int nFlagsIn )
+
+{
+    fp = fpIn;
+    nKeyType = nKeyTypeIn;
+    nKeySize = nKeySizeIn;
+    nFlags = nFlagsIn;
+    nEntrySize = nKeySize + 8;
+    nEntriesPerPage = (BTI_PAGE_SIZE - BTI_PAGE_HEADER) / nEntrySize;
+    nEntryCount = 0;
+    nPageCount = 1;
+    abyPage.resize( BTI_PAGE_SIZE );
+    nPageEntries = 0;
+    nPageLevel = 0;
+}
+
+/************************************************************************/
+/*                             FlushPage()                              */
+/************************************************************************/
+
+int OGRBTreeIndexWriter::FlushPage()
+
+{
+    if( nPageEntries == 0 )
+        return TRUE;
+
+    OGRBTreeWriteInt32( &abyPage[0], nPageEntries );
+    OGRBTreeWriteInt32( &abyPage[4], nPageLevel );
+
+    abyLevelKeys.insert( abyLevelKeys.end(),
+                         abyPage.begin() + BTI_PAGE_HEADER,
+                         abyPage.begin() + BTI_PAGE_HEADER + nKeySize );
+    anLevelPages.push_back( nPageCount );
+
+    if( VSIFSeekL( fp, (vsi_l_offset) nPageCount * BTI_PAGE_SIZE,
+                   SEEK_SET ) != 0
+        || VSIFWriteL( &abyPage[0], 1, BTI_PAGE_SIZE, fp ) != BTI_PAGE_SIZE )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Failed to write attribute index page." );
+        return FALSE;
+    }
+
+    nPageCount++;
+    nPageEntries = 0;
+    memset( &abyPage[0], 0, BTI_PAGE_SIZE );
+    return TRUE;
+}
+
+/************************************************************************/
+/*                              AddEntry()                              */
+/*                                                                      */
+/*      Append a leaf entry.  Entries must be added in key order.       */
+/************************************************************************/
+
+int OGRBTreeIndexWriter::AddEntry( const GByte *pabyKey, size_t nKeyLen,
+                                   GIntBig nValue )
+
+{
+    if( nPageEntries == nEntriesPerPage && !FlushPage() )
+        return FALSE;
+
+    GByte *pabyEntry = &abyPage[BTI_PAGE_HEADER + nPageEntries * nEntrySize];
+    if( nKeyLen > (size_t) nKeySize )
+        nKeyLen = nKeySize;
+    memcpy( pabyEntry, pabyKey, nKeyLen );
+    memset( pabyEntry + nKeyLen, 0, nKeySize - nKeyLen );
+    OGRBTreeWriteInt64( pabyEntry + nKeySize, nValue );
+
+    nPageEntries++;
+    nEntryCount++;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                               Finish()                               */
+/*                                                                      */
+/*      Flush the last leaf, build the interior levels from the first   */
+/*      keys of the level below, and write the header.                  */
+/************************************************************************/
+
+int OGRBTreeIndexWriter::Finish()
+
+{
+    if( !FlushPage() )
+        return FALSE;
+
+    GIntBig nLeafPageCount = nPageCount - 1;
+    GIntBig nRootPage = nLeafPageCount > 0 ? 1 : 0;
+    int nDepth = nLeafPageCount > 0 ? 1 : 0;
+
+    while( anLevelPages.size() > 1 )
+    {
+        std::vector<GByte> abyChildKeys;
+        std::vector<GIntBig> anChildPages;
+        abyChildKeys.swap( abyLevelKeys );
+        anChildPages.swap( anLevelPages );
+
+        nPageLevel++;
+        for( size_t i = 0; i < anChildPages.size(); i++ )
+        {
+            if( !AddEntry( &abyChildKeys[i * nKeySize], nKeySize,
+                           anChildPages[i] ) )
+                return FALSE;
+        }
+        if( !FlushPage() )
+            return FALSE;
+
+        nEntryCount -= (GIntBig) anChildPages.size();
+        nDepth++;
+        nRootPage = nPageCount - 1;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write the header.                                               */
+/* -------------------------------------------------------------------- */
+    std::vector<GByte> abyHeader( BTI_PAGE_SIZE, 0 );
+    memcpy( &abyHeader[0], BTI_SIGNATURE, 8 );
+    OGRBTreeWriteInt32( &abyHeader[8], nKeyType );
+    OGRBTreeWriteInt32( &abyHeader[12], nKeySize );
+    OGRBTreeWriteInt32( &abyHeader[16], nFlags );
+    OGRBTreeWriteInt32( &abyHeader[20], nDepth );
+    OGRBTreeWriteInt64( &abyHeader[24], nEntryCount );
+    OGRBTreeWriteInt64( &abyHeader[32], nRootPage );
+    OGRBTreeWriteInt64( &abyHeader[40], 1 );
+    OGRBTreeWriteInt64( &abyHeader[48], nLeafPageCount );
+
+    if( VSIFSeekL( fp, 0, SEEK_SET ) != 0
+        || VSIFWriteL( &abyHeader[0], 1, BTI_PAGE_SIZE, fp ) != BTI_PAGE_SIZE )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Failed to write attribute index header." );
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          OGRBTreeIndexBuilder                        */
+/*                                                                      */
+/*      Collects the (key, FID) pairs of one field during the scan of   */
+/*      the layer, sorts them in memory, spilling sorted runs to a      */
+/*      temporary file beyond a memory budget, and finally merges       */
+/*      them into an OGRBTreeIndexWriter.                               */
+/* ==================================================================== */
+/************************************************************************/
+
+typedef struct
+{
+    vsi_l_offset nOffset;       /* next file offset to load in the buffer */
+    vsi_l_offset nEnd;
+
+    GByte       *pabyBuffer;
+    size_t       nBufferPos;
+    size_t       nBufferFilled;
+
+    /* current entry of the run */
+    GByte        abyKey[BTI_MAX_KEY_SIZE];
+    size_t       nKeyLen;
+    GIntBig      nFID;
+} OGRBTreeSortRun;
+
+/* Records are stored as a GUInt16 key length, the key and a GIntBig FID. */
+class OGRBTreeRecordLess
+{
+    const GByte *pabyData;
+
+  public:
+    OGRBTreeRecordLess( const GByte *pabyDataIn ) : pabyData(pabyDataIn) {}
+
+    bool operator()( size_t nOffset1, size_t nOffset2 ) const
+    {
+        GUInt16 nLen1, nLen2;
+        memcpy( &nLen1, pabyData + nOffset1, 2 );
+        memcpy( &nLen2, pabyData + nOffset2, 2 );
+        int nCmp = memcmp( pabyData + nOffset1 + 2, pabyData + nOffset2 + 2,
+                           MIN(nLen1, nLen2) );
+        if( nCmp != 0 )
+            return nCmp < 0;
+        if( nLen1 != nLen2 )
+            return nLen1 < nLen2;
+
+        GIntBig nFID1, nFID2;
+        memcpy( &nFID1, pabyData + nOffset1 + 2 + nLen1, 8 );
+        memcpy( &nFID2, pabyData + nOffset2 + 2 + nLen2, 8 );
+        return nFID1 < nFID2;
+    }
+};
+
+class OGRBTreeIndexBuilder
+{
+    int                 iField;
+    OGRFieldType        eFieldType;
+    int                 nKeyType;
+    size_t              nMaxMemory;
+
+    std::vector<GByte>  abyRecords;
+    std::vector<size_t> anOffsets;
+    size_t              nMaxKeyLen;
+    int                 bTruncated;
+
+    CPLString           osTmpFilename;
+    VSILFILE           *fpTmp;
+    vsi_l_offset        nTmpSize;
+    std::vector<OGRBTreeSortRun> asRuns;
+    std::vector<int>    anHeap;
+
+    int                 FlushRun();
+    int                 ReadBytes( OGRBTreeSortRun *psRun, void *pDst,
+                                   size_t nSize );
+    int                 ReadHead( OGRBTreeSortRun *psRun );
+    int                 Before( int iRun1, int iRun2 );
+    void                SiftDown( int iPos );
+
+  public:
+                        OGRBTreeIndexBuilder( int iFieldIn,
+                                              OGRFieldType eFieldTypeIn,
+                                              size_t nMaxMemoryIn );
+                       ~OGRBTreeIndexBuilder();
+
+    int                 GetField() { return iField; }
+
+    int                 AddFeature( OGRFeature *poFeature );
+    int                 Finish( const char *pszFilename );
+};
+
+/************************************************************************/
+/*                        OGRBTreeIndexBuilder()                        */
+/************************************************************************/
+
+OGRBTreeIndexBuilder::OGRBTreeIndexBuilder( int iFieldIn,
+                                            OGRFieldType eFieldTypeIn,
+                                            size_t nMaxMemoryIn )
+
+{
+    iField = iFieldIn;
+    eFieldType = eFieldTypeIn;
+    nKeyType = OGRBTreeGetKeyType( eFieldType );
+    nMaxMemory = nMaxMemoryIn;
+    nMaxKeyLen = 0;
+    bTruncated = FALSE;
+    fpTmp = NULL;
+    nTmpSize = 0;
+}
+
+/************************************************************************/
+/*                       ~OGRBTreeIndexBuilder()                        */
+/************************************************************************/
+
+OGRBTreeIndexBuilder::~OGRBTreeIndexBuilder()
+
+{
+    for( size_t i = 0; i < asRuns.size(); i++ )
+        CPLFree( asRuns[i].pabyBuffer );
+
+    if( fpTmp != NULL )
+    {
+        VSIFCloseL( fpTmp );
+        VSIUnlink( osTmpFilename );
+    }
+}
+
+/************************************************************************/
+/*                             AddFeature()                             */
+/************************************************************************/
+
+int OGRBTreeIndexBuilder::AddFeature( OGRFeature *poFeature )
+
+{
+    if( !poFeature->IsFieldSet( iField ) || poFeature->GetFID() == OGRNullFID )
+        return TRUE;
+
+    GByte abyKey[BTI_MAX_KEY_SIZE];
+    size_t nKeyLen;
+
+    if( nKeyType == BTI_KEY_INTEGER )
+    {
+        OGRBTreeEncodeInteger( poFeature->GetFieldAsInteger64( iField ),
+                               abyKey );
+        nKeyLen = 8;
+    }
+    else if( nKeyType == BTI_KEY_REAL )
+    {
+        double dfVal = poFeature->GetFieldAsDouble( iField );
+        if( CPLIsNan( dfVal ) )
+            return TRUE;
+        OGRBTreeEncodeReal( dfVal, abyKey );
+        nKeyLen = 8;
+    }
+    else
+    {
+        nKeyLen = OGRBTreeEncodeString( poFeature->GetFieldAsString( iField ),
+                                        abyKey, BTI_MAX_KEY_SIZE );
+        if( nKeyLen > BTI_MAX_KEY_SIZE )
+        {
+            nKeyLen = BTI_MAX_KEY_SIZE;
+            bTruncated = TRUE;
+        }
+    }
+
+    if( nKeyLen > nMaxKeyLen )
+        nMaxKeyLen = nKeyLen;
+
+    size_t nOffset = abyRecords.size();
+    GUInt16 nLen16 = (GUInt16) nKeyLen;
+    GIntBig nFID = poFeature->GetFID();
+
+    abyRecords.resize( nOffset + 2 + nKeyLen + 8 );
+    memcpy( &abyRecords[nOffset], &nLen16, 2 );
+    memcpy( &abyRecords[nOffset + 2], abyKey, nKeyLen );
+    memcpy( &abyRecords[nOffset + 2 + nKeyLen], &nFID, 8 );
+    anOffsets.push_back( nOffset );
+
+    if( abyRecords.size() + anOffsets.size() * sizeof(size_t) > nMaxMemory )
+        return FlushRun();
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                              FlushRun()                              */
+/*                                                                      */
+/*      Sort the records in memory and append them as a run to the      */
+/*      temporary file.                                                 */
+/************************************************************************/
+
+int OGRBTreeIndexBuilder::FlushRun()
+
+{
+    if( anOffsets.empty() )
+        return TRUE;
+
+    if( fpTmp == NULL )
+    {
+        osTmpFilename = CPLGenerateTempFilename( "ogr_attr_index" );
+        fpTmp = VSIFOpenL( osTmpFilename, "wb+" );
+        if( fpTmp == NULL )
+        {
+            CPLError( CE_Failure, CPLE_OpenFailed,
+                      "Cannot create temporary file %s for attribute index",
+                      osTmpFilename.c_str() );
+            return FALSE;
+        }
+    }
+
+    std::sort( anOffsets.begin(), anOffsets.end(),
+               OGRBTreeRecordLess( &abyRecords[0] ) );
+
+    OGRBTreeSortRun sRun;
+    memset( &sRun, 0, sizeof(sRun) );
+    sRun.nOffset = nTmpSize;
+
+    VSIFSeekL( fpTmp, nTmpSize, SEEK_SET );
+    for( size_t i = 0; i < anOffsets.size(); i++ )
+    {
+        GUInt16 nLen16;
+        memcpy( &nLen16, &abyRecords[anOffsets[i]], 2 );
+        size_t nRecordSize = 2 + nLen16 + 8;
+        if( VSIFWriteL( &abyRecords[anOffsets[i]], 1, nRecordSize, fpTmp )
+            != nRecordSize )
+        {
+            CPLError( CE_Failure, CPLE_FileIO,
+                      "Cannot write in temporary file %s for attribute index",
+                      osTmpFilename.c_str() );
+            return FALSE;
+        }
+        nTmpSize += nRecordSize;
+    }
+
+    sRun.nEnd = nTmpSize;
+    asRuns.push_back( sRun );
+
+    abyRecords.resize( 0 );
+    anOffsets.resize( 0 );
+    return TRUE;
+}
+
+/************************************************************************/
+/*                             ReadBytes()                              */
+/************************************************************************/
+
+int OGRBTreeIndexBuilder::ReadBytes( OGRBTreeSortRun *psRun,
+                                     void *pDst, size_t nSize )
+
+{
+    GByte *pabyDst = (GByte *) pDst;
+
+    while( nSize > 0 )
+    {
+        if( psRun->nBufferPos == psRun->nBufferFilled )
+        {
+            if( psRun->nOffset >= psRun->nEnd )
+                return FALSE;
+            if( psRun->pabyBuffer == NULL )
+                psRun->pabyBuffer = (GByte *) CPLMalloc( BTI_RUN_BUFFER_SIZE );
+
+            size_t nToRead = BTI_RUN_BUFFER_SIZE;
+            if( psRun->nEnd - psRun->nOffset < nToRead )
+                nToRead = (size_t) (psRun->nEnd - psRun->nOffset);
+            VSIFSeekL( fpTmp, psRun->nOffset, SEEK_SET );
+            psRun->nBufferFilled = VSIFReadL( psRun->pabyBuffer, 1, nToRead,
+                                              fpTmp );
+            psRun->nBufferPos = 0;
+            if( psRun->nBufferFilled == 0 )
+                return FALSE;
+            psRun->nOffset += psRun->nBufferFilled;
+        }
+
+        size_t nAvail = psRun->nBufferFilled - psRun->nBufferPos;
+        if( nAvail > nSize )
+            nAvail = nSize;
+        memcpy( pabyDst, psRun->pabyBuffer + psRun->nBufferPos, nAvail );
+        psRun->nBufferPos += nAvail;
+        pabyDst += nAvail;
+        nSize -= nAvail;
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                              ReadHead()                              */
+/************************************************************************/
+
+int OGRBTreeIndexBuilder::ReadHead( OGRBTreeSortRun *psRun )
+
+{
+    GUInt16 nLen16;
+
+    if( !ReadBytes( psRun, &nLen16, 2 ) || nLen16 > BTI_MAX_KEY_SIZE
+        || !ReadBytes( psRun, psRun->abyKey, nLen16 )
+        || !ReadBytes( psRun, &psRun->nFID, 8 ) )
+        return FALSE;
+
+    psRun->nKeyLen = nLen16;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                               Before()                               */
+/************************************************************************/
+
+int OGRBTreeIndexBuilder::Before( int iRun1, int iRun2 )
+
+{
+    const OGRBTreeSortRun *psRun1 = &(asRuns[iRun1]);
+    const OGRBTreeSortRun *psRun2 = &(asRuns[iRun2]);
+
+    int nCmp = memcmp( psRun1->abyKey, psRun2->abyKey,
+                       MIN(psRun1->nKeyLen, psRun2->nKeyLen) );
+    if( nCmp != 0 )
+        return nCmp < 0;
+    if( psRun1->nKeyLen != psRun2->nKeyLen )
+        return psRun1->nKeyLen < psRun2->nKeyLen;
+    return psRun1->nFID < psRun2->nFID;
+}
+
+/************************************************************************/
+/*                              SiftDown()                              */
+/************************************************************************/
+
+void OGRBTreeIndexBuilder::SiftDown( int iPos )
+
+{
+    int nHeapSize = (int) anHeap.size();
+
+    while( TRUE )
+    {
+        int iFirst = iPos;
+        int iLeft = 2 * iPos + 1;
+        int iRight = iLeft + 1;
+
+        if( iLeft < nHeapSize && Before( anHeap[iLeft], anHeap[iFirst] ) )
+            iFirst = iLeft;
+        if( iRight < nHeapSize && Before( anHeap[iRight], anHeap[iFirst] ) )
+            iFirst = iRight;
+        if( iFirst == iPos )
+            break;
+
+        int nTmp = anHeap[iPos];
+        anHeap[iPos] = anHeap[iFirst];
+        anHeap[iFirst] = nTmp;
+        iPos = iFirst;
+    }
+}
+
+/************************************************************************/
+/*                               Finish()                               */
+/*                                                                      */
+/*      Write the index file from the collected entries.                */
+/************************************************************************/
+
+int OGRBTreeIndexBuilder::Finish( const char *pszFilename )
+
+{
+    VSILFILE *fp = VSIFOpenL( pszFilename, "wb" );
+    if( fp == NULL )
+    {
+        CPLError( CE_Failure, CPLE_OpenFailed,
+                  "Failed to create %s.", pszFilename );
+        return FALSE;
+    }
+
+    int nKeySize = 8;
+    if( nKeyType == BTI_KEY_STRING )
+        nKeySize = MAX( 1, (int) nMaxKeyLen );
+
+    OGRBTreeIndexWriter oWriter( fp, nKeyType, nKeySize,
+                                 bTruncated ? BTI_FLAG_TRUNCATED : 0 );
+    int bOK = TRUE;
+
+/* -------------------------------------------------------------------- */
+/*      Everything fitted in memory: sort and write directly.           */
+/* -------------------------------------------------------------------- */
+    if( asRuns.empty() )
+    {
+        if( !anOffsets.empty() )
+            std::sort( anOffsets.begin(), anOffsets.end(),
+                       OGRBTreeRecordLess( &abyRecords[0] ) );
+
+        for( size_t i = 0; bOK && i < anOffsets.size(); i++ )
+        {
+            const GByte *pabyRecord = &abyRecords[anOffsets[i]];
+            GUInt16 nLen16;
+            GIntBig nFID;
+            memcpy( &nLen16, pabyRecord, 2 );
+            memcpy( &nFID, pabyRecord + 2 + nLen16, 8 );
+            bOK = oWriter.AddEntry( pabyRecord + 2, nLen16, nFID );
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Otherwise merge the sorted runs.                                */
+/* -------------------------------------------------------------------- */
+    else
+    {
+        bOK = FlushRun();
+
+        for( int iRun = 0; bOK && iRun < (int) asRuns.size(); iRun++ )
+        {
+            if( ReadHead( &asRuns[iRun] ) )
+                anHeap.push_back( iRun );
+        }
+        for( int iPos = (int) anHeap.size() / 2 - 1; iPos >= 0; iPos-- )
+            SiftDown( iPos );
+
+        while( bOK && !anHeap.empty() )
+        {
+            OGRBTreeSortRun *psRun = &(asRuns[anHeap[0]]);
+            bOK = oWriter.AddEntry( psRun->abyKey, psRun->nKeyLen,
+                                    psRun->nFID );
+
+            if( !ReadHead( psRun ) )
+            {
+                anHeap[0] = anHeap.back();
+                anHeap.pop_back();
+            }
+            if( !anHeap.empty() )
+                SiftDown( 0 );
+        }
+    }
+
+    if( bOK )
+        bOK = oWriter.Finish();
+
+    if( VSIFCloseL( fp ) != 0 )
+        bOK = FALSE;
+    if( !bOK )
+        VSIUnlink( pszFilename );
+
+    return bOK;
+}
+
+/************************************************************************/
+/*                          OGRBTreeAttrIndex                           */
+/*                                                                      */
+/*      Access to the B-tree index of one field.                        */
+/************************************************************************/
+
+class OGRBTreeAttrIndex : public OGRAttrIndex
+{
+    VSILFILE   *fp;
+    int         nKeyType;
+    int         nKeySize;
+    int         nFlags;
+    int         nDepth;
+    GIntBig     nEntryCount;
+    GIntBig     nRootPage;
+    GIntBig     nFirstLeafPage;
+    GIntBig     nLeafPageCount;
+
+    std::vector<GByte> abyPage;
+    GIntBig     nCachedPage;
+
+    int         ReadPage( GIntBig nPage );
+    int         BuildKey( OGRField *psKey, GByte *pabyKey, int *pbInexact );
+    int         Search( const GByte *pabyMin, int bMinIncluded,
+                        const GByte *pabyMax, int bMaxIncluded,
+                        int nPrefixLen, std::vector<GIntBig> &anFIDs );
+    GIntBig    *ToFIDList( const std::vector<GIntBig> &anFIDs,
+                           int *pnFIDCount );
+
+public:
+    int         iField;
+    CPLString   osFilename;
+    OGRFieldType eFieldType;
+
+                OGRBTreeAttrIndex( int iFieldIn, OGRFieldType eFieldTypeIn,
+                                   const char *pszFilename );
+               ~OGRBTreeAttrIndex();
+
+    int         Open();
+    void        Close();
+
+    GIntBig     GetFirstMatch( OGRField *psKey );
+    GIntBig    *GetAllMatches( OGRField *psKey );
+    GIntBig    *GetAllMatches( OGRField *psKey, GIntBig* panFIDList,
+                               int* nFIDCount, int* nLength );
+    int         SupportsRangeMatches() { return TRUE; }
+    GIntBig    *GetRangeMatches( OGRField *psMin, int bMinIncluded,
+                                 OGRField *psMax, int bMaxIncluded,
+                                 int *pnFIDCount );
+    GIntBig    *GetPrefixMatches( const char *pszPrefix, int *pnFIDCount );
+
+    OGRErr      AddEntry( OGRField *psKey, GIntBig nFID );
+    OGRErr      RemoveEntry( OGRField *psKey, GIntBig nFID );
+
+    OGRErr      Clear();
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                        OGRBTreeLayerAttrIndex                        */
+/*                                                                      */
+/*      B-tree attribute indexes of a layer : a .btm XML file lists     */
+/*      the indexed fields, each index being in its own .bti file.      */
+/* ==================================================================== */
+/************************************************************************/
+
+class OGRBTreeLayerAttrIndex : public OGRLayerAttrIndex
+{
+    std::vector<OGRBTreeAttrIndex *> apoIndexList;
+    CPLString   osMetadataFilename;
+
+    /* size and modification time of the source when the indexes were */
+    /* built, -1 if unknown */
+    GIntBig     nSourceSize;
+    GIntBig     nSourceMTime;
+    int         bSourceChecked;
+    int         bSourceChanged;
+
+    OGRBTreeAttrIndex *FindIndex( int iField, int *piPos = NULL );
+    CPLString   GetIndexFilename( int iField );
+    void        CheckSource();
+
+public:
+                OGRBTreeLayerAttrIndex();
+    virtual     ~OGRBTreeLayerAttrIndex();
+
+    /* base class virtual methods */
+    OGRErr      Initialize( const char *pszIndexPath, OGRLayer * );
+    OGRErr      CreateIndex( int iField );
+    OGRErr      DropIndex( int iField );
+    OGRErr      IndexAllFeatures( int iField = -1 );
+
+    OGRErr      AddToIndex( OGRFeature *poFeature, int iField = -1 );
+    OGRErr      RemoveFromIndex( OGRFeature *poFeature );
+
+    OGRAttrIndex *GetFieldIndex( int iField );
+
+    /* custom to OGRBTreeLayerAttrIndex */
+    OGRErr      SaveConfigToXML();
+    OGRErr      LoadConfigFromXML();
+};
+
+/************************************************************************/
+/*                      OGRBTreeLayerAttrIndex()                        */
+/************************************************************************/
+
+OGRBTreeLayerAttrIndex::OGRBTreeLayerAttrIndex()
+
+{
+    nSourceSize = -1;
+    nSourceMTime = -1;
+    bSourceChecked = FALSE;
+    bSourceChanged = FALSE;
+}
+
+/************************************************************************/
+/*                      ~OGRBTreeLayerAttrIndex()                       */
+/************************************************************************/
+
+OGRBTreeLayerAttrIndex::~OGRBTreeLayerAttrIndex()
+
+{
+    for( size_t i = 0; i < apoIndexList.size(); i++ )
+        delete apoIndexList[i];
+}
+
+/************************************************************************/
+/*                             Initialize()                             */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::Initialize( const char *pszIndexPathIn,
+                                           OGRLayer *poLayerIn )
+
+{
+    if( poLayerIn == poLayer )
+        return OGRERR_NONE;
+
+    poLayer = poLayerIn;
+    pszIndexPath = CPLStrdup( pszIndexPathIn );
+    osMetadataFilename = CPLResetExtension( pszIndexPathIn, "btm" );
+
+    VSIStatBufL sStat;
+    if( VSIStatL( osMetadataFilename, &sStat ) == 0 )
+        return LoadConfigFromXML();
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          GetIndexFilename()                          */
+/*                                                                      */
+/*      <base>.<field index>.bti, next to the .btm file.                */
+/************************************************************************/
+
+CPLString OGRBTreeLayerAttrIndex::GetIndexFilename( int iField )
+
+{
+    return CPLResetExtension( osMetadataFilename,
+                              CPLSPrintf( "%d.bti", iField ) );
+}
+
+/************************************************************************/
+/*                             FindIndex()                              */
+/************************************************************************/
+
+OGRBTreeAttrIndex *OGRBTreeLayerAttrIndex::FindIndex( int iField, int *piPos )
+
+{
+    for( size_t i = 0; i < apoIndexList.size(); i++ )
+    {
+        if( apoIndexList[i]->iField == iField )
+        {
+            if( piPos != NULL )
+                *piPos = (int) i;
+            return apoIndexList[i];
+        }
+    }
+    return NULL;
+}
+
+/************************************************************************/
+/*                            CheckSource()                             */
+/*                                                                      */
+/*      The indexes are not updated when the layer is edited.  They     */
+/*      are not used if the size or the modification time of the       */
+/*      source differ from the ones recorded when they were built,      */
+/*      until CREATE INDEX rebuilds them.  This is done on first use,   */
+/*      once SetSourceFilename() has been called for generic sidecars.  */
+/*      Drivers that use these indexes for their own layers do not set  */
+/*      a source, since they may rewrite their files when closed.  An   */
+/*      edit that keeps the size of the file, in the same second as     */
+/*      the start of CREATE INDEX, is not detected.                     */
+/************************************************************************/
+
+void OGRBTreeLayerAttrIndex::CheckSource()
+
+{
+    if( bSourceChecked )
+        return;
+    bSourceChecked = TRUE;
+
+    if( osSourceFilename.empty() || apoIndexList.empty() )
+        return;
+
+    VSIStatBufL sStat;
+    if( VSIStatL( osSourceFilename, &sStat ) == 0
+        && nSourceSize == (GIntBig) sStat.st_size
+        && nSourceMTime == (GIntBig) sStat.st_mtime )
+        return;
+
+    CPLDebug( "OGR", "%s has changed since %s was built, ignoring its "
+              "indexes.", osSourceFilename.c_str(),
+              osMetadataFilename.c_str() );
+    bSourceChanged = TRUE;
+}
+
+/************************************************************************/
+/*                         LoadConfigFromXML()                          */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::LoadConfigFromXML()
+
+{
+    CPLXMLNode *psRoot = CPLParseXMLFile( osMetadataFilename );
+    if( psRoot == NULL )
+        return OGRERR_FAILURE;
+
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    CPLXMLNode *psAttrIndex;
+
+    nSourceSize = CPLAtoGIntBig( CPLGetXMLValue(psRoot,"SourceSize","-1") );
+    nSourceMTime = CPLAtoGIntBig( CPLGetXMLValue(psRoot,"SourceMTime","-1") );
+
+    for( psAttrIndex = psRoot->psChild;
+         psAttrIndex != NULL;
+         psAttrIndex = psAttrIndex->psNext )
+    {
+        if( psAttrIndex->eType != CXT_Element
+            || !EQUAL(psAttrIndex->pszValue,"OGRBTreeAttrIndex") )
+            continue;
+
+        /* The field name prevails over the field index, in case fields */
+        /* have been reordered since the index was built. */
+        int iField = poDefn->GetFieldIndex(
+                            CPLGetXMLValue(psAttrIndex,"FieldName","") );
+        if( iField < 0 )
+            iField = atoi(CPLGetXMLValue(psAttrIndex,"FieldIndex","-1"));
+        const char *pszFilename = CPLGetXMLValue(psAttrIndex,"Filename",NULL);
+
+        if( iField < 0 || iField >= poDefn->GetFieldCount()
+            || pszFilename == NULL || FindIndex( iField ) != NULL )
+        {
+            CPLError( CE_Warning, CPLE_AppDefined,
+                      "Skipping corrupt OGRBTreeAttrIndex entry." );
+            continue;
+        }
+
+        OGRBTreeAttrIndex *poIndex = new OGRBTreeAttrIndex(
+            iField, poDefn->GetFieldDefn(iField)->GetType(),
+            CPLFormFilename( CPLGetPath(osMetadataFilename), pszFilename,
+                             NULL ) );
+        if( !poIndex->Open() )
+        {
+            delete poIndex;
+            continue;
+        }
+        apoIndexList.push_back( poIndex );
+    }
+
+    CPLDestroyXMLNode( psRoot );
+
+    CPLDebug( "OGR", "Restored %d B-tree field indexes for layer %s from %s.",
+              (int) apoIndexList.size(), poDefn->GetName(),
+              osMetadataFilename.c_str() );
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          SaveConfigToXML()                           */
+/*                                                                      */
+/*      Write the list of indexed fields, or remove the .btm file if    */
+/*      there are none left.                                            */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::SaveConfigToXML()
+
+{
+    if( apoIndexList.empty() )
+    {
+        VSIStatBufL sStat;
+        if( VSIStatL( osMetadataFilename, &sStat ) == 0 )
+            VSIUnlink( osMetadataFilename );
+        return OGRERR_NONE;
+    }
+
+    CPLXMLNode *psRoot = CPLCreateXMLNode( NULL, CXT_Element,
+                                           "OGRBTreeLayerAttrIndex" );
+
+    if( nSourceSize >= 0 )
+    {
+        CPLCreateXMLElementAndValue( psRoot, "SourceSize",
+                                     CPLSPrintf( CPL_FRMT_GIB, nSourceSize ) );
+        CPLCreateXMLElementAndValue( psRoot, "SourceMTime",
+                                     CPLSPrintf( CPL_FRMT_GIB, nSourceMTime ) );
+    }
+
+    for( size_t i = 0; i < apoIndexList.size(); i++ )
+    {
+        OGRBTreeAttrIndex *poAI = apoIndexList[i];
+        CPLXMLNode *psIndex;
+
+        psIndex = CPLCreateXMLNode( psRoot, CXT_Element, "OGRBTreeAttrIndex" );
+
+        CPLCreateXMLElementAndValue( psIndex, "FieldIndex",
+                                     CPLSPrintf( "%d", poAI->iField ) );
+        CPLCreateXMLElementAndValue( psIndex, "FieldName",
+            poLayer->GetLayerDefn()->GetFieldDefn(poAI->iField)->GetNameRef() );
+        CPLCreateXMLElementAndValue( psIndex, "Filename",
+                                     CPLGetFilename( poAI->osFilename ) );
+    }
+
+    int bOK = CPLSerializeXMLTreeToFile( psRoot, osMetadataFilename );
+    CPLDestroyXMLNode( psRoot );
+
+    return bOK ? OGRERR_NONE : OGRERR_FAILURE;
+}
+
+/************************************************************************/
+/*                            CreateIndex()                             */
+/*                                                                      */
+/*      Register an index on the indicated field.  The index is only    */
+/*      usable once IndexAllFeatures() has built it.                    */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::CreateIndex( int iField )
+
+{
+    OGRFieldDefn *poFldDefn = poLayer->GetLayerDefn()->GetFieldDefn(iField);
+
+    CheckSource();
+
+    /* A stale index is rebuilt by the IndexAllFeatures() that follows. */
+    if( FindIndex( iField ) != NULL && bSourceChanged )
+        return OGRERR_NONE;
+
+    if( FindIndex( iField ) != NULL )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "It seems we already have an index for field %d/%s\n"
+                  "of layer %s.",
+                  iField, poFldDefn->GetNameRef(),
+                  poLayer->GetLayerDefn()->GetName() );
+        return OGRERR_FAILURE;
+    }
+
+    if( OGRBTreeGetKeyType( poFldDefn->GetType() ) == 0 )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Indexing not support for the field type of field %s.",
+                  poFldDefn->GetNameRef() );
+        return OGRERR_FAILURE;
+    }
+
+    apoIndexList.push_back(
+        new OGRBTreeAttrIndex( iField, poFldDefn->GetType(),
+                               GetIndexFilename( iField ) ) );
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             DropIndex()                              */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::DropIndex( int iField )
+
+{
+    int iPos = 0;
+
+    CheckSource();
+
+    OGRBTreeAttrIndex *poIndex = FindIndex( iField, &iPos );
+
+    if( poIndex == NULL )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "DROP INDEX on field (%s) that doesn't have an index.",
+                  poLayer->GetLayerDefn()->GetFieldDefn(iField)->GetNameRef() );
+        return OGRERR_FAILURE;
+    }
+
+    apoIndexList.erase( apoIndexList.begin() + iPos );
+
+    poIndex->Close();
+    VSIStatBufL sStat;
+    if( VSIStatL( poIndex->osFilename, &sStat ) == 0 )
+        VSIUnlink( poIndex->osFilename );
+    delete poIndex;
+
+    return SaveConfigToXML();
+}
+
+/************************************************************************/
+/*                          IndexAllFeatures()                          */
+/*                                                                      */
+/*      Build the index of one field, or of all registered fields if    */
+/*      iField is -1, in a single scan of the layer.  Beyond            */
+/*      OGR_ATTR_INDEX_SORT_MAX_MEMORY (in MB), the entries are sorted  */
+/*      in runs written to a temporary file and merged.                 */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::IndexAllFeatures( int iField )
+
+{
+    std::vector<OGRBTreeIndexBuilder *> apoBuilders;
+    size_t nMaxMemory = (size_t) MAX( 1, atoi(
+        CPLGetConfigOption( "OGR_ATTR_INDEX_SORT_MAX_MEMORY", "100" ) ) )
+        * 1024 * 1024;
+    size_t i;
+
+    CheckSource();
+
+/* -------------------------------------------------------------------- */
+/*      Record the state of the source before the scan, so that edits   */
+/*      made during the scan make the indexes stale.  If it is not the  */
+/*      one the other indexes were built from, rebuild them all.        */
+/* -------------------------------------------------------------------- */
+    GIntBig nNewSourceSize = -1;
+    GIntBig nNewSourceMTime = -1;
+    VSIStatBufL sStat;
+    if( !osSourceFilename.empty()
+        && VSIStatL( osSourceFilename, &sStat ) == 0 )
+    {
+        nNewSourceSize = (GIntBig) sStat.st_size;
+        nNewSourceMTime = (GIntBig) sStat.st_mtime;
+    }
+    if( bSourceChanged || nNewSourceSize != nSourceSize
+        || nNewSourceMTime != nSourceMTime )
+        iField = -1;
+    nSourceSize = nNewSourceSize;
+    nSourceMTime = nNewSourceMTime;
+
+    for( i = 0; i < apoIndexList.size(); i++ )
+    {
+        if( iField < 0 || apoIndexList[i]->iField == iField )
+            apoBuilders.push_back( NULL );
+    }
+
+    if( apoBuilders.empty() )
+        return OGRERR_NONE;
+
+    /* The memory budget is shared between the fields being indexed. */
+    size_t j = 0;
+    for( i = 0; i < apoIndexList.size(); i++ )
+    {
+        if( iField < 0 || apoIndexList[i]->iField == iField )
+            apoBuilders[j++] = new OGRBTreeIndexBuilder(
+                apoIndexList[i]->iField, apoIndexList[i]->eFieldType,
+                nMaxMemory / apoBuilders.size() );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Collect the keys of all features.                               */
+/* -------------------------------------------------------------------- */
+    OGRFeature *poFeature;
+    int bOK = TRUE;
+
+    poLayer->ResetReading();
+    while( bOK && (poFeature = poLayer->GetNextFeature()) != NULL )
+    {
+        for( i = 0; bOK && i < apoBuilders.size(); i++ )
+            bOK = apoBuilders[i]->AddFeature( poFeature );
+
+        delete poFeature;
+    }
+    poLayer->ResetReading();
+
+/* -------------------------------------------------------------------- */
+/*      Write the index files.                                          */
+/* -------------------------------------------------------------------- */
+    for( i = 0; i < apoBuilders.size(); i++ )
+    {
+        OGRBTreeAttrIndex *poIndex = FindIndex( apoBuilders[i]->GetField() );
+
+        poIndex->Close();
+        if( bOK )
+            bOK = apoBuilders[i]->Finish( poIndex->osFilename )
+                && poIndex->Open();
+
+        delete apoBuilders[i];
+    }
+
+    if( !bOK )
+        return OGRERR_FAILURE;
+
+    bSourceChanged = FALSE;
+    return SaveConfigToXML();
+}
+
+/************************************************************************/
+/*                             AddToIndex()                             */
+/*                                                                      */
+/*      B-tree indexes are bulk loaded and cannot be updated            */
+/*      incrementally.  They must be rebuilt with CREATE INDEX after    */
+/*      the layer has been modified.                                    */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::AddToIndex( CPL_UNUSED OGRFeature *poFeature,
+                                           CPL_UNUSED int iTargetField )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                          RemoveFromIndex()                           */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::RemoveFromIndex(
+                                        CPL_UNUSED OGRFeature *poFeature )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                           GetFieldIndex()                            */
+/************************************************************************/
+
+OGRAttrIndex *OGRBTreeLayerAttrIndex::GetFieldIndex( int iField )
+
+{
+    CheckSource();
+
+    OGRBTreeAttrIndex *poIndex = FindIndex( iField );
+
+    /* An index registered by CreateIndex() but not yet built is not */
+    /* usable. */
+    if( poIndex == NULL || poIndex->osFilename.empty() || bSourceChanged )
+        return NULL;
+    return poIndex->Open() ? poIndex : NULL;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          OGRBTreeAttrIndex                           */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                         OGRBTreeAttrIndex()                          */
+/************************************************************************/
+
+OGRBTreeAttrIndex::OGRBTreeAttrIndex( int iFieldIn,
+                                      OGRFieldType eFieldTypeIn,
+                                      const char *pszFilename )
+
+{
+    iField = iFieldIn;
+    eFieldType = eFieldTypeIn;
+    osFilename = pszFilename;
+    fp = NULL;
+    nKeyType = 0;
+    nKeySize = 0;
+    nFlags = 0;
+    nDepth = 0;
+    nEntryCount = 0;
+    nRootPage = 0;
+    nFirstLeafPage = 0;
+    nLeafPageCount = 0;
+    nCachedPage = -1;
+}
+
+/************************************************************************/
+/*                         ~OGRBTreeAttrIndex()                         */
+/************************************************************************/
+
+OGRBTreeAttrIndex::~OGRBTreeAttrIndex()
+
+{
+    Close();
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/*                                                                      */
+/*      Open the .bti file and read its header, if not already done.    */
+/************************************************************************/
+
+int OGRBTreeAttrIndex::Open()
+
+{
+    if( fp != NULL )
+        return TRUE;
+
+    VSIStatBufL sStat;
+    if( VSIStatL( osFilename, &sStat ) != 0 )
+        return FALSE;
+
+    fp = VSIFOpenL( osFilename, "rb" );
+    if( fp == NULL )
+        return FALSE;
+
+    GByte abyHeader[56];
+    if( VSIFReadL( abyHeader, 1, sizeof(abyHeader), fp ) != sizeof(abyHeader)
+        || memcmp( abyHeader, BTI_SIGNATURE, 8 ) != 0 )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "%s is not a valid attribute index file.",
+                  osFilename.c_str() );
+        Close();
+        return FALSE;
+    }
+
+    nKeyType = OGRBTreeReadInt32( abyHeader + 8 );
+    nKeySize = OGRBTreeReadInt32( abyHeader + 12 );
+    nFlags = OGRBTreeReadInt32( abyHeader + 16 );
+    nDepth = OGRBTreeReadInt32( abyHeader + 20 );
+    nEntryCount = OGRBTreeReadInt64( abyHeader + 24 );
+    nRootPage = OGRBTreeReadInt64( abyHeader + 32 );
+    nFirstLeafPage = OGRBTreeReadInt64( abyHeader + 40 );
+    nLeafPageCount = OGRBTreeReadInt64( abyHeader + 48 );
+
+    if( nKeyType != OGRBTreeGetKeyType( eFieldType )
+        || nKeySize <= 0 || nKeySize > BTI_MAX_KEY_SIZE
+        || nDepth < 0 || nEntryCount < 0 || nLeafPageCount < 0 )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "%s is corrupted or does not match the type of its field.",
+                  osFilename.c_str() );
+        Close();
+        return FALSE;
+    }
+
+    abyPage.resize( BTI_PAGE_SIZE );
+    nCachedPage = -1;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                               Close()                                */
+/************************************************************************/
+
+void OGRBTreeAttrIndex::Close()
+
+{
+    if( fp != NULL )
+    {
+        VSIFCloseL( fp );
+        fp = NULL;
+    }
+    nCachedPage = -1;
+}
+
+/************************************************************************/
+/*                              ReadPage()                              */
+/************************************************************************/
+
+int OGRBTreeAttrIndex::ReadPage( GIntBig nPage )
+
+{
+    if( nPage == nCachedPage )
+        return TRUE;
+
+    nCachedPage = -1;
+    if( VSIFSeekL( fp, (vsi_l_offset) nPage * BTI_PAGE_SIZE, SEEK_SET ) != 0
+        || VSIFReadL( &abyPage[0], 1, BTI_PAGE_SIZE, fp ) != BTI_PAGE_SIZE )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Failed to read page " CPL_FRMT_GIB " of %s.",
+                  nPage, osFilename.c_str() );
+        return FALSE;
+    }
+
+    int nEntries = OGRBTreeReadInt32( &abyPage[0] );
+    if( nEntries < 0 || nEntries > (BTI_PAGE_SIZE - BTI_PAGE_HEADER)
+                                                    / (nKeySize + 8) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Corrupted page " CPL_FRMT_GIB " in %s.",
+                  nPage, osFilename.c_str() );
+        return FALSE;
+    }
+
+    nCachedPage = nPage;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                              BuildKey()                              */
+/*                                                                      */
+/*      Encode a key value of the type of the field.  *pbInexact is     */
+/*      set if the key had to be truncated.                             */
+/************************************************************************/
+
+int OGRBTreeAttrIndex::BuildKey( OGRField *psKey, GByte *pabyKey,
+                                 int *pbInexact )
+
+{
+    memset( pabyKey, 0, nKeySize );
+    *pbInexact = FALSE;
+
+    switch( eFieldType )
+    {
+      case OFTInteger:
+        OGRBTreeEncodeInteger( psKey->Integer, pabyKey );
+        return TRUE;
+
+      case OFTInteger64:
+        OGRBTreeEncodeInteger( psKey->Integer64, pabyKey );
+        return TRUE;
+
+      case OFTReal:
+        if( CPLIsNan( psKey->Real ) )
+            return FALSE;
+        OGRBTreeEncodeReal( psKey->Real, pabyKey );
+        return TRUE;
+
+      case OFTString:
+      {
+        size_t nLen = OGRBTreeEncodeString( psKey->String, pabyKey,
+                                            nKeySize );
+        if( nLen > (size_t) nKeySize )
+            *pbInexact = TRUE;
+        return TRUE;
+      }
+
+      default:
+        return FALSE;
+    }
+}
+
+/************************************************************************/
+/*                               Search()                               */
+/*                                                                      */
+/*      Collect the FIDs of the entries between the encoded bounds.     */
+/*      A NULL bound is unbounded.  If nPrefixLen is not zero, the      */
+/*      entries whose first nPrefixLen bytes match pabyMin are          */
+/*      collected instead.                                              */
+/************************************************************************/
+
+int OGRBTreeAttrIndex::Search( const GByte *pabyMin, int bMinIncluded,
+                               const GByte *pabyMax, int bMaxIncluded,
+                               int nPrefixLen, std::vector<GIntBig> &anFIDs )
+
+{
+    if( fp == NULL || nDepth == 0 )
+        return TRUE;
+
+    const int nEntrySize = nKeySize + 8;
+
+/* -------------------------------------------------------------------- */
+/*      Descend to the first leaf that may contain the lower bound :    */
+/*      follow the last child whose first key is strictly lower than    */
+/*      the bound, as equal keys may span several pages.                */
+/* -------------------------------------------------------------------- */
+    GIntBig nPage = nRootPage;
+    for( int iLevel = nDepth - 1; iLevel > 0; iLevel-- )
+    {
+        if( !ReadPage( nPage ) )
+            return FALSE;
+
+        int nEntries = OGRBTreeReadInt32( &abyPage[0] );
+        const GByte *pabyEntries = &abyPage[BTI_PAGE_HEADER];
+        int iChild = 0;
+
+        if( pabyMin != NULL )
+        {
+            int nLow = 1, nHigh = nEntries - 1;
+            while( nLow <= nHigh )
+            {
+                int nMid = (nLow + nHigh) / 2;
+                if( memcmp( pabyEntries + nMid * nEntrySize, pabyMin,
+                            nKeySize ) < 0 )
+                {
+                    iChild = nMid;
+                    nLow = nMid + 1;
+                }
+                else
+                    nHigh = nMid - 1;
+            }
+        }
+
+        nPage = OGRBTreeReadInt64( pabyEntries + iChild * nEntrySize
+                                   + nKeySize );
+        if( nPage < nFirstLeafPage || nPage >= nCachedPage )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Corrupted page " CPL_FRMT_GIB " in %s.",
+                      nCachedPage, osFilename.c_str() );
+            return FALSE;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Scan the leaves forward.                                        */
+/* -------------------------------------------------------------------- */
+    const GIntBig nLastLeafPage = nFirstLeafPage + nLeafPageCount - 1;
+
+    for( ; nPage <= nLastLeafPage; nPage++ )
+    {
+        if( !ReadPage( nPage ) )
+            return FALSE;
+
+        int nEntries = OGRBTreeReadInt32( &abyPage[0] );
+        const GByte *pabyEntry = &abyPage[BTI_PAGE_HEADER];
+
+        for( int i = 0; i < nEntries; i++, pabyEntry += nEntrySize )
+        {
+            if( nPrefixLen > 0 )
+            {
+                int nCmp = memcmp( pabyEntry, pabyMin, nPrefixLen );
+                if( nCmp < 0 )
+                    continue;
+                if( nCmp > 0 )
+                    return TRUE;
+            }
+            else
+            {
+                if( pabyMin != NULL )
+                {
+                    int nCmp = memcmp( pabyEntry, pabyMin, nKeySize );
+                    if( nCmp < 0 || (nCmp == 0 && !bMinIncluded) )
+                        continue;
+                }
+                if( pabyMax != NULL )
+                {
+                    int nCmp = memcmp( pabyEntry, pabyMax, nKeySize );
+                    if( nCmp > 0 || (nCmp == 0 && !bMaxIncluded) )
+                        return TRUE;
+                }
+            }
+
+            anFIDs.push_back( OGRBTreeReadInt64( pabyEntry + nKeySize ) );
+        }
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                             ToFIDList()                              */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::ToFIDList( const std::vector<GIntBig> &anFIDs,
+                                       int *pnFIDCount )
+
+{
+    *pnFIDCount = (int) anFIDs.size();
+
+    GIntBig *panFIDList = (GIntBig *)
+        CPLMalloc( sizeof(GIntBig) * (anFIDs.size() + 1) );
+    if( !anFIDs.empty() )
+        memcpy( panFIDList, &anFIDs[0], sizeof(GIntBig) * anFIDs.size() );
+    panFIDList[anFIDs.size()] = OGRNullFID;
+
+    return panFIDList;
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/*                                                                      */
+/*      Keys that were truncated compare as their prefix, so bounds     */
+/*      become inclusive for string indexes with truncated keys.  The   */
+/*      result may then contain extra FIDs, which is fine as callers    */
+/*      evaluate the attribute filter on the returned features.         */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetRangeMatches( OGRField *psMin,
+                                             int bMinIncluded,
+                                             OGRField *psMax,
+                                             int bMaxIncluded,
+                                             int *pnFIDCount )
+
+{
+    GByte abyMin[BTI_MAX_KEY_SIZE], abyMax[BTI_MAX_KEY_SIZE];
+    int bInexact;
+    std::vector<GIntBig> anFIDs;
+
+    *pnFIDCount = 0;
+    if( !Open() )
+        return NULL;
+
+    if( psMin != NULL )
+    {
+        if( !BuildKey( psMin, abyMin, &bInexact ) )
+            return NULL;
+        if( bInexact || (nFlags & BTI_FLAG_TRUNCATED) )
+            bMinIncluded = TRUE;
+    }
+    if( psMax != NULL )
+    {
+        if( !BuildKey( psMax, abyMax, &bInexact ) )
+            return NULL;
+        if( bInexact || (nFlags & BTI_FLAG_TRUNCATED) )
+            bMaxIncluded = TRUE;
+    }
+
+    if( !Search( psMin ? abyMin : NULL, bMinIncluded,
+                 psMax ? abyMax : NULL, bMaxIncluded, 0, anFIDs ) )
+        return NULL;
+
+    return ToFIDList( anFIDs, pnFIDCount );
+}
+
+/************************************************************************/
+/*                          GetPrefixMatches()                          */
+/*                                                                      */
+/*      Entries of a string index starting with pszPrefix, ignoring     */
+/*      case.                                                           */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetPrefixMatches( const char *pszPrefix,
+                                              int *pnFIDCount )
+
+{
+    GByte abyPrefix[BTI_MAX_KEY_SIZE];
+    std::vector<GIntBig> anFIDs;
+
+    *pnFIDCount = 0;
+    if( eFieldType != OFTString || !Open() )
+        return NULL;
+
+    memset( abyPrefix, 0, sizeof(abyPrefix) );
+    size_t nLen = OGRBTreeEncodeString( pszPrefix, abyPrefix, nKeySize );
+    if( nLen == 0 )
+        return NULL;
+    if( nLen > (size_t) nKeySize )
+        nLen = nKeySize;
+
+    if( !Search( abyPrefix, TRUE, NULL, FALSE, (int) nLen, anFIDs ) )
+        return NULL;
+
+    return ToFIDList( anFIDs, pnFIDCount );
+}
+
+/************************************************************************/
+/*                           GetAllMatches()                            */
+/*                                                                      */
+/*      Append the FIDs matching psKey to panFIDList, which is          */
+/*      reallocated as needed and terminated by OGRNullFID.             */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetAllMatches( OGRField *psKey,
+                                           GIntBig* panFIDList,
+                                           int* nFIDCount, int* nLength )
+
+{
+    int nMatchCount = 0;
+    GIntBig *panMatches = GetRangeMatches( psKey, TRUE, psKey, TRUE,
+                                           &nMatchCount );
+
+    if( panFIDList == NULL )
+    {
+        *nFIDCount = 0;
+        *nLength = 0;
+    }
+
+    if( *nFIDCount + nMatchCount + 1 > *nLength )
+    {
+        *nLength = (*nFIDCount + nMatchCount) * 2 + 10;
+        panFIDList = (GIntBig *)
+            CPLRealloc( panFIDList, sizeof(GIntBig) * *nLength );
+    }
+
+    for( int i = 0; i < nMatchCount; i++ )
+        panFIDList[(*nFIDCount)++] = panMatches[i];
+    panFIDList[*nFIDCount] = OGRNullFID;
+
+    CPLFree( panMatches );
+
+    return panFIDList;
+}
+
+GIntBig *OGRBTreeAttrIndex::GetAllMatches( OGRField *psKey )
+
+{
+    int nFIDCount, nLength;
+    return GetAllMatches( psKey, NULL, &nFIDCount, &nLength );
+}
+
+/************************************************************************/
+/*                           GetFirstMatch()                            */
+/************************************************************************/
+
+GIntBig OGRBTreeAttrIndex::GetFirstMatch( OGRField *psKey )
+
+{
+    int nMatchCount = 0;
+    GIntBig *panMatches = GetRangeMatches( psKey, TRUE, psKey, TRUE,
+                                           &nMatchCount );
+    GIntBig nFID = (nMatchCount > 0) ? panMatches[0] : OGRNullFID;
+
+    CPLFree( panMatches );
+    return nFID;
+}
+
+/************************************************************************/
+/*                          AddEntry()/RemoveEntry()/Clear()            */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::AddEntry( CPL_UNUSED OGRField *psKey,
+                                    CPL_UNUSED GIntBig nFID )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+OGRErr OGRBTreeAttrIndex::RemoveEntry( CPL_UNUSED OGRField *psKey,
+                                       CPL_UNUSED GIntBig nFID )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+OGRErr OGRBTreeAttrIndex::Clear()
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                      OGRCreateBTreeLayerIndex()                      */
+/************************************************************************/
+
+OGRLayerAttrIndex *OGRCreateBTreeLayerIndex()
+
+{
+    return new OGRBTreeLayerAttrIndex();
+}
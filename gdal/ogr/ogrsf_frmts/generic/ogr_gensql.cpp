@@ -31,6 +31,7 @@
 #include "swq.h"
 #include "ogr_p.h"
 #include "ogr_gensql.h"
+#include "ogr_attrind.h"
 #include "cpl_string.h"
 #include "ogr_api.h"
 #include "cpl_time.h"
@@ -52,6 +53,75 @@ class OGRGenSQLGeomFieldDefn: public OGRGeomFieldDefn
         int bForceGeomType;
 };
 
+/************************************************************************/
+/*                          OGRGenSQLJoinHash                           */
+/*                                                                      */
+/*      In-memory hash table of the features of a secondary table,      */
+/*      keyed on the field of a JOIN of the form                        */
+/*      primary.field = secondary.field. It replaces an attribute       */
+/*      filter and a read of the secondary layer for each primary       */
+/*      feature by a single scan of the secondary layer.                */
+/************************************************************************/
+
+typedef struct
+{
+    GIntBig     nKey;
+    char       *pszKey;     /* NULL for integer keys, upper-cased if the */
+                            /* secondary layer compares case insensitively */
+    OGRFeature *poFeature;
+} OGRGenSQLJoinHashEntry;
+
+/* Memory used by the hash set for each entry besides the entry itself : */
+/* the CPLList node (2 pointers), its bucket slot and the malloc() */
+/* overhead of the node, roughly one pointer each. */
+#define JOIN_HASH_SET_OVERHEAD  (4 * sizeof(void*))
+
+static unsigned long OGRGenSQLJoinHashFunc( const void *elt )
+{
+    const OGRGenSQLJoinHashEntry *psEntry = (const OGRGenSQLJoinHashEntry *) elt;
+    if( psEntry->pszKey != NULL )
+        return CPLHashSetHashStr( psEntry->pszKey );
+    return (unsigned long) (psEntry->nKey ^ (psEntry->nKey >> 32));
+}
+
+static int OGRGenSQLJoinEqualFunc( const void *elt1, const void *elt2 )
+{
+    const OGRGenSQLJoinHashEntry *psEntry1 = (const OGRGenSQLJoinHashEntry *) elt1;
+    const OGRGenSQLJoinHashEntry *psEntry2 = (const OGRGenSQLJoinHashEntry *) elt2;
+    if( psEntry1->pszKey != NULL )
+        return strcmp( psEntry1->pszKey, psEntry2->pszKey ) == 0;
+    return psEntry1->nKey == psEntry2->nKey;
+}
+
+static void OGRGenSQLJoinFreeFunc( void *elt )
+{
+    OGRGenSQLJoinHashEntry *psEntry = (OGRGenSQLJoinHashEntry *) elt;
+    CPLFree( psEntry->pszKey );
+    delete psEntry->poFeature;
+    CPLFree( psEntry );
+}
+
+class OGRGenSQLJoinHash
+{
+  public:
+    int         bUsable;
+    int         iPrimaryField;
+    int         bStringKey;
+    int         bCaseInsensitive;
+    CPLHashSet *hSet;
+
+                OGRGenSQLJoinHash() : bUsable(FALSE), iPrimaryField(-1),
+                                      bStringKey(FALSE),
+                                      bCaseInsensitive(FALSE), hSet(NULL) {}
+               ~OGRGenSQLJoinHash() { if( hSet ) CPLHashSetDestroy( hSet ); }
+
+    int         ProbeCaseInsensitive( OGRLayer *poJoinLayer,
+                                      int iSecondaryField );
+    int         Build( swq_join_def *psJoinInfo, OGRLayer *poSrcLayer,
+                       OGRLayer *poJoinLayer );
+    OGRFeature *Lookup( OGRFeature *poSrcFeat );
+};
+
 /************************************************************************/
 /*               OGRGenSQLResultsLayerHasSpecialField()                 */
 /************************************************************************/
@@ -97,13 +167,23 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDS,
     this->pSelectInfo = pSelectInfo;
     poDefn = NULL;
     poSummaryFeature = NULL;
+    nGroupFeatureCount = 0;
+    papoGroupFeatures = NULL;
     panFIDIndex = NULL;
     bOrderByValid = FALSE;
     nIndexSize = 0;
+    papoSortedFeatures = NULL;
+    poSortRuns = NULL;
     nNextIndexFID = 0;
     nExtraDSCount = 0;
     papoExtraDS = NULL;
+    papoJoinHash = NULL;
     panGeomFieldToSrcGeomField = NULL;
+    poSrcLayerDS = poSrcDS;
+    bSrcLayerHasGenericIndex = FALSE;
+    poSrcIndexQuery = NULL;
+    panSrcIndexFIDs = NULL;
+    iNextSrcIndexFID = 0;
 
 /* -------------------------------------------------------------------- */
 /*      Identify all the layers involved in the SELECT.                 */
@@ -145,6 +225,9 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDS,
 
         if( papoTableLayers[iTable] == NULL )
             return;
+
+        if( iTable == 0 )
+            poSrcLayerDS = poTableDS;
     }
     
     poSrcLayer = papoTableLayers[0];
@@ -473,6 +556,8 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDS,
     if( poSpatFilter != NULL )
         SetSpatialFilter( 0, poSpatFilter );
 
+    OpenSrcLayerGenericIndex();
+
     ResetReading();
 
     FindAndSetIgnoredFields();
@@ -503,10 +588,17 @@ OGRGenSQLResultsLayer::~OGRGenSQLResultsLayer()
     CPLFree( papoTableLayers );
     papoTableLayers = NULL;
              
-    CPLFree( panFIDIndex );
+    InvalidateOrderByIndex();
     CPLFree( panGeomFieldToSrcGeomField );
+    CPLFree( panSrcIndexFIDs );
+    delete poSrcIndexQuery;
+
+    ClearJoinHashes();
 
     delete poSummaryFeature;
+    for( GIntBig i = 0; i < nGroupFeatureCount; i++ )
+        delete papoGroupFeatures[i];
+    CPLFree( papoGroupFeatures );
     delete (swq_select *) pSelectInfo;
 
     if( poDefn != NULL )
@@ -623,11 +715,96 @@ void OGRGenSQLResultsLayer::ResetReading()
     if( psSelectInfo->query_mode == SWQM_RECORDSET )
     {
         ApplyFiltersToSource();
+        ComputeSrcIndexFIDs();
     }
 
+    /* The secondary layers may have changed since the last pass. */
+    ClearJoinHashes();
+
     nNextIndexFID = 0;
 }
 
+/************************************************************************/
+/*                      OpenSrcLayerGenericIndex()                      */
+/*                                                                      */
+/*      Drivers that manage attribute indexes use them in their own     */
+/*      GetNextFeature().  For other drivers, look once for generic     */
+/*      B-tree indexes built by CREATE INDEX (see                       */
+/*      OGRGetGenericLayerIndexFilename()).                             */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::OpenSrcLayerGenericIndex()
+
+{
+    if( pszWHERE == NULL || poSrcLayerDS == NULL
+        || !poSrcLayer->TestCapability( OLCRandomRead ) )
+        return;
+
+    CPLString osSourceFilename;
+    CPLString osIndexFilename =
+        OGRGetGenericLayerIndexFilename( poSrcLayerDS, poSrcLayer,
+                                         &osSourceFilename );
+    if( osIndexFilename.empty() )
+        return;
+
+    if( poSrcLayer->GetIndex() == NULL )
+    {
+        VSIStatBufL sStat;
+        if( VSIStatL( osIndexFilename, &sStat ) != 0 )
+            return;
+        poSrcLayer->InitializeIndexSupport( osIndexFilename );
+    }
+
+    OGRLayerAttrIndex *poIndex = poSrcLayer->GetIndex();
+    if( poIndex == NULL || poIndex->GetIndexPath() == NULL
+        || !EQUAL(poIndex->GetIndexPath(), osIndexFilename) )
+        return;
+
+    poIndex->SetSourceFilename( osSourceFilename );
+    bSrcLayerHasGenericIndex = TRUE;
+}
+
+/************************************************************************/
+/*                        ComputeSrcIndexFIDs()                         */
+/*                                                                      */
+/*      If the source layer has generic attribute indexes, evaluate     */
+/*      the WHERE clause against them so that GetNextFeature() only     */
+/*      fetches the candidate features by FID.                          */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::ComputeSrcIndexFIDs()
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+
+    CPLFree( panSrcIndexFIDs );
+    panSrcIndexFIDs = NULL;
+    iNextSrcIndexFID = 0;
+
+    if( pszWHERE == NULL || psSelectInfo->order_specs > 0
+        || m_poFilterGeom != NULL || !bSrcLayerHasGenericIndex )
+        return;
+
+    if( poSrcIndexQuery == NULL )
+    {
+        poSrcIndexQuery = new OGRFeatureQuery();
+        if( poSrcIndexQuery->Compile( poSrcLayer->GetLayerDefn(),
+                                      pszWHERE ) != OGRERR_NONE )
+        {
+            delete poSrcIndexQuery;
+            poSrcIndexQuery = NULL;
+            return;
+        }
+    }
+
+    panSrcIndexFIDs = poSrcIndexQuery->EvaluateAgainstIndices( poSrcLayer,
+                                                               NULL );
+    if( panSrcIndexFIDs != NULL )
+        CPLDebug( "GenSQL", "Using attribute indexes of %s on layer %s.",
+                  poSrcLayer->GetIndex()->GetIndexPath(),
+                  poSrcLayer->GetName() );
+}
+
 /************************************************************************/
 /*                           SetNextByIndex()                           */
 /*                                                                      */
@@ -644,11 +821,17 @@ OGRErr OGRGenSQLResultsLayer::SetNextByIndex( GIntBig nIndex )
 
     if( psSelectInfo->query_mode == SWQM_SUMMARY_RECORD 
         || psSelectInfo->query_mode == SWQM_DISTINCT_LIST 
-        || panFIDIndex != NULL )
+        || psSelectInfo->query_mode == SWQM_GROUP_BY 
+        || panFIDIndex != NULL || papoSortedFeatures != NULL
+        || poSortRuns != NULL )
     {
         nNextIndexFID = nIndex;
         return OGRERR_NONE;
     }
+    else if( panSrcIndexFIDs != NULL )
+    {
+        return OGRLayer::SetNextByIndex( nIndex );
+    }
     else
     {
         return poSrcLayer->SetNextByIndex( nIndex );
@@ -714,9 +897,17 @@ GIntBig OGRGenSQLResultsLayer::GetFeatureCount( int bForce )
 
         return psSummary->count;
     }
+    else if( psSelectInfo->query_mode == SWQM_GROUP_BY )
+    {
+        if( !PrepareSummary() )
+            return 0;
+
+        return nGroupFeatureCount;
+    }
     else if( psSelectInfo->query_mode != SWQM_RECORDSET )
         return 1;
-    else if( m_poAttrQuery == NULL && !MustEvaluateSpatialFilterOnGenSQL() )
+    else if( m_poAttrQuery == NULL && !MustEvaluateSpatialFilterOnGenSQL()
+             && panSrcIndexFIDs == NULL )
         return poSrcLayer->GetFeatureCount( bForce );
     else
         return OGRLayer::GetFeatureCount( bForce );
@@ -735,7 +926,8 @@ int OGRGenSQLResultsLayer::TestCapability( const char *pszCap )
     {
         if( psSelectInfo->query_mode == SWQM_SUMMARY_RECORD 
             || psSelectInfo->query_mode == SWQM_DISTINCT_LIST 
-            || panFIDIndex != NULL )
+            || psSelectInfo->query_mode == SWQM_GROUP_BY 
+            || panFIDIndex != NULL || papoSortedFeatures != NULL )
             return TRUE;
         else 
             return poSrcLayer->TestCapability( pszCap );
@@ -789,6 +981,63 @@ int OGRGenSQLResultsLayer::ContainGeomSpecialField(swq_expr_node* expr)
     return FALSE;
 }
 
+/************************************************************************/
+/*                      OGRGenSQLSetSummaryField()                      */
+/*                                                                      */
+/*      Set the value of a MIN/MAX/AVG/SUM/COUNT column from its        */
+/*      summary.                                                        */
+/************************************************************************/
+
+static void OGRGenSQLSetSummaryField( OGRFeature *poFeature, int iField,
+                                      swq_col_def *psColDef,
+                                      swq_summary *psSummary )
+
+{
+    if( psColDef->col_func == SWQCF_AVG )
+    {
+        if( psColDef->field_type == SWQ_DATE ||
+            psColDef->field_type == SWQ_TIME ||
+            psColDef->field_type == SWQ_TIMESTAMP)
+        {
+            struct tm brokendowntime;
+            double dfAvg = psSummary->sum / psSummary->count;
+            CPLUnixTimeToYMDHMS((GIntBig)dfAvg, &brokendowntime);
+            poFeature->SetField( iField,
+                                 brokendowntime.tm_year + 1900,
+                                 brokendowntime.tm_mon + 1,
+                                 brokendowntime.tm_mday,
+                                 brokendowntime.tm_hour,
+                                 brokendowntime.tm_min,
+                                 brokendowntime.tm_sec + fmod(dfAvg, 1), 0);
+        }
+        else
+            poFeature->SetField( iField,
+                                 psSummary->sum / psSummary->count );
+    }
+    else if( psColDef->col_func == SWQCF_MIN )
+    {
+        if( psColDef->field_type == SWQ_DATE ||
+            psColDef->field_type == SWQ_TIME ||
+            psColDef->field_type == SWQ_TIMESTAMP)
+            poFeature->SetField( iField, psSummary->szMin );
+        else
+            poFeature->SetField( iField, psSummary->min );
+    }
+    else if( psColDef->col_func == SWQCF_MAX )
+    {
+        if( psColDef->field_type == SWQ_DATE ||
+            psColDef->field_type == SWQ_TIME ||
+            psColDef->field_type == SWQ_TIMESTAMP)
+            poFeature->SetField( iField, psSummary->szMax );
+        else
+            poFeature->SetField( iField, psSummary->max );
+    }
+    else if( psColDef->col_func == SWQCF_COUNT )
+        poFeature->SetField( iField, psSummary->count );
+    else if( psColDef->col_func == SWQCF_SUM )
+        poFeature->SetField( iField, psSummary->sum );
+}
+
 /************************************************************************/
 /*                           PrepareSummary()                           */
 /************************************************************************/
@@ -852,6 +1101,21 @@ int OGRGenSQLResultsLayer::PrepareSummary()
             poSrcLayer->GetLayerDefn()->SetGeometryIgnored(TRUE);
     }
 
+/* -------------------------------------------------------------------- */
+/*      GROUP BY queries are aggregated per group.                      */
+/* -------------------------------------------------------------------- */
+    if( psSelectInfo->query_mode == SWQM_GROUP_BY )
+    {
+        int bRet = PrepareGroups();
+        poSrcLayer->GetLayerDefn()->SetGeometryIgnored(bSaveIsGeomIgnored);
+        if( !bRet )
+        {
+            delete poSummaryFeature;
+            poSummaryFeature = NULL;
+        }
+        return bRet;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      We treat COUNT(*) as a special case, and fill with              */
 /*      GetFeatureCount().                                            */
@@ -993,50 +1257,8 @@ int OGRGenSQLResultsLayer::PrepareSummary()
             if (psSelectInfo->column_summary != NULL)
             {
                 swq_summary *psSummary = psSelectInfo->column_summary + iField;
-
-                if( psColDef->col_func == SWQCF_AVG )
-                {
-                    if( psColDef->field_type == SWQ_DATE ||
-                        psColDef->field_type == SWQ_TIME ||
-                        psColDef->field_type == SWQ_TIMESTAMP)
-                    {
-                        struct tm brokendowntime;
-                        double dfAvg = psSummary->sum / psSummary->count;
-                        CPLUnixTimeToYMDHMS((GIntBig)dfAvg, &brokendowntime);
-                        poSummaryFeature->SetField( iField,
-                                                    brokendowntime.tm_year + 1900,
-                                                    brokendowntime.tm_mon + 1,
-                                                    brokendowntime.tm_mday,
-                                                    brokendowntime.tm_hour,
-                                                    brokendowntime.tm_min,
-                                                    brokendowntime.tm_sec + fmod(dfAvg, 1), 0);
-                    }
-                    else
-                        poSummaryFeature->SetField( iField,
-                                                    psSummary->sum / psSummary->count );
-                }
-                else if( psColDef->col_func == SWQCF_MIN )
-                {
-                    if( psColDef->field_type == SWQ_DATE ||
-                        psColDef->field_type == SWQ_TIME ||
-                        psColDef->field_type == SWQ_TIMESTAMP)
-                        poSummaryFeature->SetField( iField, psSummary->szMin );
-                    else
-                        poSummaryFeature->SetField( iField, psSummary->min );
-                }
-                else if( psColDef->col_func == SWQCF_MAX )
-                {
-                    if( psColDef->field_type == SWQ_DATE ||
-                        psColDef->field_type == SWQ_TIME ||
-                        psColDef->field_type == SWQ_TIMESTAMP)
-                        poSummaryFeature->SetField( iField, psSummary->szMax );
-                    else
-                        poSummaryFeature->SetField( iField, psSummary->max );
-                }
-                else if( psColDef->col_func == SWQCF_COUNT )
-                    poSummaryFeature->SetField( iField, psSummary->count );
-                else if( psColDef->col_func == SWQCF_SUM )
-                    poSummaryFeature->SetField( iField, psSummary->sum );
+                OGRGenSQLSetSummaryField( poSummaryFeature, iField,
+                                          psColDef, psSummary );
             }
             else if ( psColDef->col_func == SWQCF_COUNT )
                 poSummaryFeature->SetField( iField, 0 );
@@ -1047,664 +1269,2200 @@ int OGRGenSQLResultsLayer::PrepareSummary()
 }
 
 /************************************************************************/
-/*                       OGRMultiFeatureFetcher()                       */
+/*                            OGRGenSQLGroup                            */
+/*                                                                      */
+/*      A group of a GROUP BY query : the typed values of its           */
+/*      grouping fields, the aggregates of the result columns, and      */
+/*      the ORDER BY keys of its first feature.                         */
 /************************************************************************/
 
-static swq_expr_node *OGRMultiFeatureFetcher( swq_expr_node *op, 
-                                              void *pFeatureList )
-
+typedef struct
 {
-    std::vector<OGRFeature*> *papoFeatures = 
-        (std::vector<OGRFeature*> *) pFeatureList;
-    OGRFeature *poFeature;
-    swq_expr_node *poRetNode = NULL;
+    int                 nKeyCount;
+    const OGRFieldType *paeKeyTypes;
+    OGRField           *pasKeys;
+    swq_summary        *pasSummaries;
+    OGRField           *pasOrderKeys;
+} OGRGenSQLGroup;
+
+static int OGRGenSQLIsKeyUnset( const OGRField *psKey )
+{
+    return psKey->Set.nMarker1 == OGRUnsetMarker &&
+           psKey->Set.nMarker2 == OGRUnsetMarker;
+}
 
-    CPLAssert( op->eNodeType == SNT_COLUMN );
+static unsigned long OGRGenSQLGroupHashFunc( const void *elt )
+{
+    const OGRGenSQLGroup *psGroup = (const OGRGenSQLGroup *) elt;
+    unsigned long nHash = 0;
 
-/* -------------------------------------------------------------------- */
-/*      What feature are we using?  The primary or one of the joined ones?*/
-/* -------------------------------------------------------------------- */
-    if( op->table_index < 0 || op->table_index >= (int)papoFeatures->size() )
+    for( int iKey = 0; iKey < psGroup->nKeyCount; iKey++ )
     {
-        CPLError( CE_Failure, CPLE_AppDefined,
-                  "Request for unexpected table_index (%d) in field fetcher.",
-                  op->table_index );
-        return NULL;
-    }
-    
-    poFeature = (*papoFeatures)[op->table_index];
+        const OGRField *psKey = psGroup->pasKeys + iKey;
+        unsigned long nKeyHash;
 
-/* -------------------------------------------------------------------- */
-/*      Fetch the value.                                                */
-/* -------------------------------------------------------------------- */
-    switch( op->field_type )
-    {
-      case SWQ_INTEGER:
-      case SWQ_BOOLEAN:
-        if( poFeature == NULL 
-            || !poFeature->IsFieldSet(op->field_index) )
-        {
-            poRetNode = new swq_expr_node(0);
-            poRetNode->is_null = TRUE;
-        }
+        if( OGRGenSQLIsKeyUnset( psKey ) )
+            nKeyHash = 0x9E3779B9UL;
         else
-            poRetNode = new swq_expr_node( 
-                poFeature->GetFieldAsInteger(op->field_index) );
-        break;
-
-      case SWQ_INTEGER64:
-        if( poFeature == NULL 
-            || !poFeature->IsFieldSet(op->field_index) )
         {
-            poRetNode = new swq_expr_node((GIntBig)0);
-            poRetNode->is_null = TRUE;
-        }
-        else
-            poRetNode = new swq_expr_node( 
-                poFeature->GetFieldAsInteger64(op->field_index) );
-        break;
+            switch( psGroup->paeKeyTypes[iKey] )
+            {
+              case OFTInteger:
+                nKeyHash = (unsigned long) psKey->Integer;
+                break;
 
-      case SWQ_FLOAT:
-        if( poFeature == NULL 
-            || !poFeature->IsFieldSet(op->field_index) )
-        {
-            poRetNode = new swq_expr_node( 0.0 );
-            poRetNode->is_null = TRUE;
-        }
-        else
-            poRetNode = new swq_expr_node( 
-                poFeature->GetFieldAsDouble(op->field_index) );
-        break;
-        
-      case SWQ_GEOMETRY:
-        if( poFeature == NULL )
-        {
-            poRetNode = new swq_expr_node( (OGRGeometry*) NULL );
+              case OFTInteger64:
+                nKeyHash = (unsigned long) (psKey->Integer64 ^
+                                            (psKey->Integer64 >> 32));
+                break;
+
+              case OFTReal:
+              {
+                /* 0.0 and -0.0 compare equal, so they must hash the same */
+                double dfVal = (psKey->Real == 0.0) ? 0.0 : psKey->Real;
+                GUIntBig nVal;
+                memcpy( &nVal, &dfVal, sizeof(nVal) );
+                nKeyHash = (unsigned long) (nVal ^ (nVal >> 32));
+                break;
+              }
+
+              case OFTString:
+                nKeyHash = CPLHashSetHashStr( psKey->String );
+                break;
+
+              default: /* OFTDate, OFTTime, OFTDateTime */
+                nKeyHash = psKey->Date.Year;
+                nKeyHash = nKeyHash * 13 + psKey->Date.Month;
+                nKeyHash = nKeyHash * 32 + psKey->Date.Day;
+                nKeyHash = nKeyHash * 24 + psKey->Date.Hour;
+                nKeyHash = nKeyHash * 60 + psKey->Date.Minute;
+                nKeyHash = nKeyHash * 61 + (unsigned long) psKey->Date.Second;
+                nKeyHash = nKeyHash * 31 + psKey->Date.TZFlag;
+                break;
+            }
         }
-        else
+
+        nHash = nHash * 31 + nKeyHash;
+    }
+
+    return nHash;
+}
+
+static int OGRGenSQLGroupEqualFunc( const void *elt1, const void *elt2 )
+{
+    const OGRGenSQLGroup *psGroup1 = (const OGRGenSQLGroup *) elt1;
+    const OGRGenSQLGroup *psGroup2 = (const OGRGenSQLGroup *) elt2;
+
+    for( int iKey = 0; iKey < psGroup1->nKeyCount; iKey++ )
+    {
+        const OGRField *psKey1 = psGroup1->pasKeys + iKey;
+        const OGRField *psKey2 = psGroup2->pasKeys + iKey;
+        int bUnset1 = OGRGenSQLIsKeyUnset( psKey1 );
+        int bUnset2 = OGRGenSQLIsKeyUnset( psKey2 );
+
+        if( bUnset1 || bUnset2 )
         {
-            int iSrcGeomField = ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(
-                poFeature->GetDefnRef(), op->field_index);
-            poRetNode = new swq_expr_node(
-                poFeature->GetGeomFieldRef(iSrcGeomField) );
+            if( bUnset1 != bUnset2 )
+                return FALSE;
+            continue;
         }
-        break;
 
-      default:
-        if( poFeature == NULL 
-            || !poFeature->IsFieldSet(op->field_index) )
+        switch( psGroup1->paeKeyTypes[iKey] )
         {
-            poRetNode = new swq_expr_node("");
-            poRetNode->is_null = TRUE;
+          case OFTInteger:
+            if( psKey1->Integer != psKey2->Integer )
+                return FALSE;
+            break;
+
+          case OFTInteger64:
+            if( psKey1->Integer64 != psKey2->Integer64 )
+                return FALSE;
+            break;
+
+          case OFTReal:
+            if( psKey1->Real != psKey2->Real )
+                return FALSE;
+            break;
+
+          case OFTString:
+            if( strcmp( psKey1->String, psKey2->String ) != 0 )
+                return FALSE;
+            break;
+
+          default: /* OFTDate, OFTTime, OFTDateTime */
+            if( psKey1->Date.Year != psKey2->Date.Year ||
+                psKey1->Date.Month != psKey2->Date.Month ||
+                psKey1->Date.Day != psKey2->Date.Day ||
+                psKey1->Date.Hour != psKey2->Date.Hour ||
+                psKey1->Date.Minute != psKey2->Date.Minute ||
+                psKey1->Date.Second != psKey2->Date.Second ||
+                psKey1->Date.TZFlag != psKey2->Date.TZFlag )
+                return FALSE;
+            break;
         }
-        else
-            poRetNode = new swq_expr_node( 
-                poFeature->GetFieldAsString(op->field_index) );
-        break;
     }
 
-    return poRetNode;
+    return TRUE;
 }
 
 /************************************************************************/
-/*                          GetFilterForJoin()                          */
+/*                           PrepareGroups()                            */
+/*                                                                      */
+/*      Read the source layer once, aggregating the features in a       */
+/*      hash table keyed on the typed values of the GROUP BY fields,    */
+/*      and build one result feature per group.                         */
 /************************************************************************/
 
-static CPLString GetFilterForJoin(swq_expr_node* poExpr, OGRFeature* poSrcFeat,
-                                  OGRLayer* poJoinLayer, int secondary_table)
+int OGRGenSQLResultsLayer::PrepareGroups()
+
 {
-    if( poExpr->eNodeType == SNT_CONSTANT )
-    {
-        char* pszRes = poExpr->Unparse(NULL, '"');
-        CPLString osRes = pszRes;
-        CPLFree(pszRes);
-        return osRes;
-    }
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    OGRFeatureDefn *poSrcDefn = poSrcLayer->GetLayerDefn();
+    int nKeys = psSelectInfo->group_by_specs;
+    int nOrderItems = psSelectInfo->order_specs;
+    int iKey, iField;
+    size_t i;
 
-    if( poExpr->eNodeType == SNT_COLUMN )
+/* -------------------------------------------------------------------- */
+/*      Establish the type of each grouping key.  Keys of special       */
+/*      fields are copied, as their string values are only valid       */
+/*      until the next request on the source feature.                  */
+/* -------------------------------------------------------------------- */
+    std::vector<OGRFieldType> aeKeyTypes( nKeys );
+    std::vector<int> abKeyIsSpecial( nKeys );
+
+    for( iKey = 0; iKey < nKeys; iKey++ )
     {
-        CPLAssert( poExpr->field_index != -1 );
-        CPLAssert( poExpr->table_index == 0 || poExpr->table_index == secondary_table );
+        swq_group_by_def *psGroupDef = psSelectInfo->group_by_defs + iKey;
 
-        if( poExpr->table_index == 0 )
+        abKeyIsSpecial[iKey] = psGroupDef->field_index >= iFIDFieldIndex;
+        if( abKeyIsSpecial[iKey] )
         {
-            // if source key is null, we can't do join.
-            if( !poSrcFeat->IsFieldSet( poExpr->field_index ) )
+            switch( SpecialFieldTypes[psGroupDef->field_index - iFIDFieldIndex] )
             {
-                return "";
-            }
-            OGRFieldType ePrimaryFieldType =
-                    poSrcFeat->GetFieldDefnRef(poExpr->field_index)->GetType();
-            OGRField *psSrcField = 
-                    poSrcFeat->GetRawFieldRef(poExpr->field_index);
-
-            switch( ePrimaryFieldType )
-            {
-            case OFTInteger:
-                return CPLString().Printf("%d", psSrcField->Integer );
+              case SWQ_INTEGER:
+                aeKeyTypes[iKey] = OFTInteger;
                 break;
-
-            case OFTInteger64:
-                return CPLString().Printf(CPL_FRMT_GIB, psSrcField->Integer64 );
+              case SWQ_INTEGER64:
+                aeKeyTypes[iKey] = OFTInteger64;
                 break;
-
-            case OFTReal:
-                return CPLString().Printf("%.16g", psSrcField->Real );
+              case SWQ_FLOAT:
+                aeKeyTypes[iKey] = OFTReal;
+                break;
+              default:
+                aeKeyTypes[iKey] = OFTString;
                 break;
+            }
+            continue;
+        }
 
-            case OFTString:
+        OGRFieldDefn *poFDefn = poSrcDefn->GetFieldDefn( psGroupDef->field_index );
+        aeKeyTypes[iKey] = poFDefn->GetType();
+        if( aeKeyTypes[iKey] != OFTInteger &&
+            aeKeyTypes[iKey] != OFTInteger64 &&
+            aeKeyTypes[iKey] != OFTReal &&
+            aeKeyTypes[iKey] != OFTString &&
+            aeKeyTypes[iKey] != OFTDate &&
+            aeKeyTypes[iKey] != OFTTime &&
+            aeKeyTypes[iKey] != OFTDateTime )
+        {
+            CPLError( CE_Failure, CPLE_NotSupported,
+                      "GROUP BY on field '%s' of type %s not supported.",
+                      poFDefn->GetNameRef(),
+                      OGRFieldDefn::GetFieldTypeName( aeKeyTypes[iKey] ) );
+            return FALSE;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Aggregate the source features.                                  */
+/* -------------------------------------------------------------------- */
+    CPLHashSet *hSet = CPLHashSetNew( OGRGenSQLGroupHashFunc,
+                                      OGRGenSQLGroupEqualFunc, NULL );
+    std::vector<OGRGenSQLGroup*> apsGroups;
+    OGRGenSQLGroup sLookup;
+    OGRFeature *poSrcFeature;
+
+    sLookup.nKeyCount = nKeys;
+    sLookup.paeKeyTypes = &aeKeyTypes[0];
+    sLookup.pasKeys = (OGRField *) CPLMalloc( sizeof(OGRField) * nKeys );
+    sLookup.pasSummaries = NULL;
+    sLookup.pasOrderKeys = NULL;
+
+    while( (poSrcFeature = poSrcLayer->GetNextFeature()) != NULL )
+    {
+        for( iKey = 0; iKey < nKeys; iKey++ )
+        {
+            int iSrcField = psSelectInfo->group_by_defs[iKey].field_index;
+            OGRField *psKey = sLookup.pasKeys + iKey;
+
+            memset( psKey, 0, sizeof(OGRField) );
+            if( !poSrcFeature->IsFieldSet( iSrcField ) )
             {
-                char *pszEscaped = CPLEscapeString( psSrcField->String, 
-                                                    strlen(psSrcField->String),
-                                                    CPLES_SQL );
-                CPLString osRes = "'";
-                osRes += pszEscaped;
-                osRes += "'";
-                CPLFree( pszEscaped );
-                return osRes;
+                psKey->Set.nMarker1 = OGRUnsetMarker;
+                psKey->Set.nMarker2 = OGRUnsetMarker;
+                continue;
             }
-            break;
 
-            default:
-                CPLAssert( FALSE );
-                return "";
+            switch( aeKeyTypes[iKey] )
+            {
+              case OFTInteger:
+                psKey->Integer = poSrcFeature->GetFieldAsInteger( iSrcField );
+                break;
+              case OFTInteger64:
+                psKey->Integer64 = poSrcFeature->GetFieldAsInteger64( iSrcField );
+                break;
+              case OFTReal:
+                psKey->Real = poSrcFeature->GetFieldAsDouble( iSrcField );
+                break;
+              case OFTString:
+                if( abKeyIsSpecial[iKey] )
+                    psKey->String = CPLStrdup( poSrcFeature->GetFieldAsString( iSrcField ) );
+                else
+                    psKey->String = poSrcFeature->GetRawFieldRef( iSrcField )->String;
+                break;
+              default:
+                memcpy( psKey, poSrcFeature->GetRawFieldRef( iSrcField ),
+                        sizeof(OGRField) );
+                break;
             }
         }
-        
-        if(  poExpr->table_index == secondary_table )
+
+        OGRGenSQLGroup *psGroup = (OGRGenSQLGroup *) CPLHashSetLookup( hSet, &sLookup );
+        if( psGroup == NULL )
         {
-            OGRFieldDefn* poSecondaryFieldDefn =
-                poJoinLayer->GetLayerDefn()->GetFieldDefn(poExpr->field_index);
-            return CPLSPrintf("\"%s\"", poSecondaryFieldDefn->GetNameRef());
-        }
+            psGroup = (OGRGenSQLGroup *) CPLMalloc( sizeof(OGRGenSQLGroup) );
+            psGroup->nKeyCount = nKeys;
+            psGroup->paeKeyTypes = &aeKeyTypes[0];
+            psGroup->pasKeys = (OGRField *) CPLMalloc( sizeof(OGRField) * nKeys );
+            memcpy( psGroup->pasKeys, sLookup.pasKeys, sizeof(OGRField) * nKeys );
+            for( iKey = 0; iKey < nKeys; iKey++ )
+            {
+                if( aeKeyTypes[iKey] == OFTString && !abKeyIsSpecial[iKey] &&
+                    !OGRGenSQLIsKeyUnset( psGroup->pasKeys + iKey ) )
+                    psGroup->pasKeys[iKey].String =
+                        CPLStrdup( psGroup->pasKeys[iKey].String );
+            }
 
-        CPLAssert(FALSE);
-        return "";
-    }
+            psGroup->pasSummaries = (swq_summary *)
+                CPLMalloc( sizeof(swq_summary) * psSelectInfo->result_columns );
+            for( iField = 0; iField < psSelectInfo->result_columns; iField++ )
+                swq_summary_init( psGroup->pasSummaries + iField );
 
-    if( poExpr->eNodeType == SNT_OPERATION )
-    {
-        /* -------------------------------------------------------------------- */
-        /*      Operation - start by unparsing all the subexpressions.          */
-        /* -------------------------------------------------------------------- */
-        std::vector<char*> apszSubExpr;
-        int i;
+            psGroup->pasOrderKeys = NULL;
+            if( nOrderItems > 0 )
+            {
+                psGroup->pasOrderKeys = (OGRField *)
+                    CPLCalloc( sizeof(OGRField), nOrderItems );
+                ExtractOrderByKeys( poSrcFeature, psGroup->pasOrderKeys );
+            }
 
-        for( i = 0; i < poExpr->nSubExprCount; i++ )
+            CPLHashSetInsert( hSet, psGroup );
+            apsGroups.push_back( psGroup );
+        }
+        else
         {
-            CPLString osSubExpr = GetFilterForJoin(poExpr->papoSubExpr[i], poSrcFeat,
-                                                   poJoinLayer, secondary_table);
-            if( osSubExpr.size() == 0 )
+            for( iKey = 0; iKey < nKeys; iKey++ )
             {
-                for( --i; i >=0; i-- )
-                    CPLFree( apszSubExpr[i] );
-                return "";
+                if( aeKeyTypes[iKey] == OFTString && abKeyIsSpecial[iKey] &&
+                    !OGRGenSQLIsKeyUnset( sLookup.pasKeys + iKey ) )
+                    CPLFree( sLookup.pasKeys[iKey].String );
             }
-            apszSubExpr.push_back( CPLStrdup(osSubExpr) );
         }
 
-        CPLString osExpr = poExpr->UnparseOperationFromUnparsedSubExpr(&apszSubExpr[0]);
+        for( iField = 0; iField < psSelectInfo->result_columns; iField++ )
+        {
+            swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+            swq_summary *psSummary = psGroup->pasSummaries + iField;
 
-        /* -------------------------------------------------------------------- */
-        /*      cleanup subexpressions.                                         */
-        /* -------------------------------------------------------------------- */
-        for( i = 0; i < poExpr->nSubExprCount; i++ )
-            CPLFree( apszSubExpr[i] );
+            if( psColDef->col_func == SWQCF_NONE )
+                continue;
 
-        return osExpr;
-    }
+            if( psColDef->col_func == SWQCF_COUNT )
+            {
+                /* psColDef->field_index can be -1 in the case of a COUNT(*) */
+                if( psColDef->field_index < 0 )
+                    psSummary->count++;
+                else if( IS_GEOM_FIELD_INDEX(poSrcDefn, psColDef->field_index) )
+                {
+                    int iSrcGeomField = ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(
+                            poSrcDefn, psColDef->field_index);
+                    if( poSrcFeature->GetGeomFieldRef(iSrcGeomField) != NULL )
+                        psSummary->count++;
+                }
+                else if( poSrcFeature->IsFieldSet( psColDef->field_index ) )
+                    psSummary->count++;
+                continue;
+            }
 
-    return "";
-}
+            if( !poSrcFeature->IsFieldSet( psColDef->field_index ) )
+                continue;
 
-/************************************************************************/
-/*                          TranslateFeature()                          */
-/************************************************************************/
+            /* The count of MIN() and MAX() tells whether a value was found */
+            if( psColDef->col_func == SWQCF_MIN ||
+                psColDef->col_func == SWQCF_MAX )
+                psSummary->count++;
 
-OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
+            if( psColDef->field_type == SWQ_DATE ||
+                psColDef->field_type == SWQ_TIME ||
+                psColDef->field_type == SWQ_TIMESTAMP )
+            {
+                swq_summary_accumulate( psColDef, psSummary,
+                    poSrcFeature->GetFieldAsString( psColDef->field_index ) );
+                continue;
+            }
 
-{
-    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
-    OGRFeature *poDstFeat;
-    std::vector<OGRFeature*> apoFeatures;
+            double dfValue = poSrcFeature->GetFieldAsDouble( psColDef->field_index );
+            if( psColDef->col_func == SWQCF_MIN )
+            {
+                if( dfValue < psSummary->min )
+                    psSummary->min = dfValue;
+            }
+            else if( psColDef->col_func == SWQCF_MAX )
+            {
+                if( dfValue > psSummary->max )
+                    psSummary->max = dfValue;
+            }
+            else
+            {
+                psSummary->count++;
+                psSummary->sum += dfValue;
+            }
+        }
 
-    if( poSrcFeat == NULL )
-        return NULL;
+        delete poSrcFeature;
+    }
 
-    m_nFeaturesRead++;
+    CPLFree( sLookup.pasKeys );
+    CPLHashSetDestroy( hSet );
 
-    apoFeatures.push_back( poSrcFeat );
+    ClearFilters();
+
+    CPLDebug( "GenSQL", "GROUP BY : %d groups on layer '%s'.",
+              (int) apsGroups.size(), poSrcLayer->GetName() );
 
 /* -------------------------------------------------------------------- */
-/*      Fetch the corresponding features from any jointed tables.       */
+/*      Order the groups, on the ORDER BY keys of their first           */
+/*      feature, or in the order they were found.                       */
 /* -------------------------------------------------------------------- */
-    int iJoin;
-
-    for( iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++ )
-    {
-        CPLString osFilter;
-
-        swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
-
-        /* OGRMultiFeatureFetcher assumes that the features are pushed in */
-        /* apoFeatures with increasing secondary_table, so make sure */
-        /* we have taken care of this */
-        CPLAssert(psJoinInfo->secondary_table == iJoin + 1);
+    GIntBig nGroups = (GIntBig) apsGroups.size();
+    std::vector<GIntBig> anIndex( apsGroups.size() + 1 );
+    int bOK = TRUE;
 
-        OGRLayer *poJoinLayer = papoTableLayers[psJoinInfo->secondary_table];
-        
-        osFilter = GetFilterForJoin(psJoinInfo->poExpr, poSrcFeat, poJoinLayer, 
-                                    psJoinInfo->secondary_table);
-        //CPLDebug("OGR", "Filter = %s\n", osFilter.c_str());
+    for( i = 0; i < apsGroups.size(); i++ )
+        anIndex[i] = i;
 
-        // if source key is null, we can't do join.
-        if( osFilter.size() == 0 )
+    if( nOrderItems > 0 && nGroups > 1 )
+    {
+        OGRField *pasIndexFields = (OGRField *)
+            VSIMalloc2( sizeof(OGRField) * nOrderItems, apsGroups.size() );
+        if( pasIndexFields == NULL )
         {
-            apoFeatures.push_back( NULL );
-            continue;
+            CPLError( CE_Failure, CPLE_OutOfMemory,
+                      "Cannot allocate pasIndexFields" );
+            bOK = FALSE;
+        }
+        else
+        {
+            for( i = 0; i < apsGroups.size(); i++ )
+                memcpy( pasIndexFields + i * nOrderItems,
+                        apsGroups[i]->pasOrderKeys,
+                        sizeof(OGRField) * nOrderItems );
+            bOK = SortIndexSection( pasIndexFields, &anIndex[0], 0, nGroups );
+            CPLFree( pasIndexFields );
         }
-
-        OGRFeature *poJoinFeature = NULL;
-
-        poJoinLayer->ResetReading();
-        if( poJoinLayer->SetAttributeFilter( osFilter.c_str() ) == OGRERR_NONE )
-            poJoinFeature = poJoinLayer->GetNextFeature();
-
-        apoFeatures.push_back( poJoinFeature );
     }
 
 /* -------------------------------------------------------------------- */
-/*      Create destination feature.                                     */
+/*      COUNT() columns are reported as 32 bit integers when all the    */
+/*      counts fit, as for summary records.                             */
 /* -------------------------------------------------------------------- */
-    poDstFeat = new OGRFeature( poDefn );
+    delete poSummaryFeature;
+    poSummaryFeature = NULL;
 
-    poDstFeat->SetFID( poSrcFeat->GetFID() );
+    for( iField = 0; bOK && iField < psSelectInfo->result_columns; iField++ )
+    {
+        if( psSelectInfo->column_defs[iField].col_func != SWQCF_COUNT )
+            continue;
 
-    poDstFeat->SetStyleString( poSrcFeat->GetStyleString() );
+        for( i = 0; i < apsGroups.size(); i++ )
+        {
+            GIntBig nCount = apsGroups[i]->pasSummaries[iField].count;
+            if( (GIntBig)(int)nCount != nCount )
+                break;
+        }
+        if( i == apsGroups.size() )
+            poDefn->GetFieldDefn(iField)->SetType(OFTInteger);
+    }
 
 /* -------------------------------------------------------------------- */
-/*      Evaluate fields that are complex expressions.                   */
+/*      Build the result features, and free the groups.                 */
 /* -------------------------------------------------------------------- */
-    int iRegularField = 0;
-    int iGeomField = 0;
-    for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
+    if( bOK )
     {
-        swq_col_def *psColDef = psSelectInfo->column_defs + iField;
-        swq_expr_node *poResult;
-
-        if( psColDef->field_index != -1 )
+        papoGroupFeatures = (OGRFeature **)
+            VSIMalloc2( sizeof(OGRFeature*), apsGroups.size() + 1 );
+        if( papoGroupFeatures == NULL )
         {
-            if( psColDef->field_type == SWQ_GEOMETRY ||
-                psColDef->target_type == SWQ_GEOMETRY )
-                iGeomField++;
-            else
-                iRegularField++;
-            continue;
+            CPLError( CE_Failure, CPLE_OutOfMemory,
+                      "Cannot allocate papoGroupFeatures" );
+            bOK = FALSE;
         }
+    }
 
-        poResult = psColDef->expr->Evaluate( OGRMultiFeatureFetcher, 
-                                             (void *) &apoFeatures );
-        
-        if( poResult == NULL )
+    for( i = 0; bOK && i < apsGroups.size(); i++ )
+    {
+        OGRGenSQLGroup *psGroup = apsGroups[anIndex[i]];
+        OGRFeature *poFeature = new OGRFeature( poDefn );
+
+        poFeature->SetFID( (GIntBig) i );
+
+        for( iField = 0; iField < psSelectInfo->result_columns; iField++ )
         {
-            delete poDstFeat;
-            return NULL;
+            swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+            swq_summary *psSummary = psGroup->pasSummaries + iField;
+
+            if( psColDef->col_func != SWQCF_NONE )
+            {
+                if( psColDef->col_func == SWQCF_COUNT || psSummary->count > 0 )
+                    OGRGenSQLSetSummaryField( poFeature, iField,
+                                              psColDef, psSummary );
+                continue;
+            }
+
+            for( iKey = 0; iKey < nKeys; iKey++ )
+            {
+                if( psSelectInfo->group_by_defs[iKey].field_index ==
+                                                    psColDef->field_index )
+                    break;
+            }
+            CPLAssert( iKey < nKeys );
+
+            OGRField *psKey = psGroup->pasKeys + iKey;
+            if( iKey == nKeys || OGRGenSQLIsKeyUnset( psKey ) )
+                continue;
+
+            switch( aeKeyTypes[iKey] )
+            {
+              case OFTInteger:
+                poFeature->SetField( iField, psKey->Integer );
+                break;
+              case OFTInteger64:
+                poFeature->SetField( iField, psKey->Integer64 );
+                break;
+              case OFTReal:
+                poFeature->SetField( iField, psKey->Real );
+                break;
+              case OFTString:
+                poFeature->SetField( iField, psKey->String );
+                break;
+              default:
+                poFeature->SetField( iField, psKey );
+                break;
+            }
         }
 
-        if( poResult->is_null )
+        papoGroupFeatures[nGroupFeatureCount++] = poFeature;
+    }
+
+    for( i = 0; i < apsGroups.size(); i++ )
+    {
+        OGRGenSQLGroup *psGroup = apsGroups[i];
+        for( iKey = 0; iKey < nKeys; iKey++ )
         {
-            if( poResult->field_type == SWQ_GEOMETRY )
-                iGeomField++;
-            else
-                iRegularField++;
-            delete poResult;
-            continue;
+            if( aeKeyTypes[iKey] == OFTString &&
+                !OGRGenSQLIsKeyUnset( psGroup->pasKeys + iKey ) )
+                CPLFree( psGroup->pasKeys[iKey].String );
         }
-
-        switch( poResult->field_type )
+        if( psGroup->pasOrderKeys != NULL )
         {
-          case SWQ_BOOLEAN:
-          case SWQ_INTEGER:
-            poDstFeat->SetField( iRegularField++, (int)poResult->int_value );
-            break;
+            FreeOrderByKeys( psGroup->pasOrderKeys, 1 );
+            CPLFree( psGroup->pasOrderKeys );
+        }
+        CPLFree( psGroup->pasKeys );
+        CPLFree( psGroup->pasSummaries );
+        CPLFree( psGroup );
+    }
 
-          case SWQ_INTEGER64:
-            poDstFeat->SetField( iRegularField++, poResult->int_value );
-            break;
-            
-          case SWQ_FLOAT:
-            poDstFeat->SetField( iRegularField++, poResult->float_value );
+    if( !bOK )
+        return FALSE;
+
+    poSummaryFeature = new OGRFeature( poDefn );
+    poSummaryFeature->SetFID( 0 );
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                       OGRMultiFeatureFetcher()                       */
+/************************************************************************/
+
+static swq_expr_node *OGRMultiFeatureFetcher( swq_expr_node *op, 
+                                              void *pFeatureList )
+
+{
+    std::vector<OGRFeature*> *papoFeatures = 
+        (std::vector<OGRFeature*> *) pFeatureList;
+    OGRFeature *poFeature;
+    swq_expr_node *poRetNode = NULL;
+
+    CPLAssert( op->eNodeType == SNT_COLUMN );
+
+/* -------------------------------------------------------------------- */
+/*      What feature are we using?  The primary or one of the joined ones?*/
+/* -------------------------------------------------------------------- */
+    if( op->table_index < 0 || op->table_index >= (int)papoFeatures->size() )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Request for unexpected table_index (%d) in field fetcher.",
+                  op->table_index );
+        return NULL;
+    }
+    
+    poFeature = (*papoFeatures)[op->table_index];
+
+/* -------------------------------------------------------------------- */
+/*      Fetch the value.                                                */
+/* -------------------------------------------------------------------- */
+    switch( op->field_type )
+    {
+      case SWQ_INTEGER:
+      case SWQ_BOOLEAN:
+        if( poFeature == NULL 
+            || !poFeature->IsFieldSet(op->field_index) )
+        {
+            poRetNode = new swq_expr_node(0);
+            poRetNode->is_null = TRUE;
+        }
+        else
+            poRetNode = new swq_expr_node( 
+                poFeature->GetFieldAsInteger(op->field_index) );
+        break;
+
+      case SWQ_INTEGER64:
+        if( poFeature == NULL 
+            || !poFeature->IsFieldSet(op->field_index) )
+        {
+            poRetNode = new swq_expr_node((GIntBig)0);
+            poRetNode->is_null = TRUE;
+        }
+        else
+            poRetNode = new swq_expr_node( 
+                poFeature->GetFieldAsInteger64(op->field_index) );
+        break;
+
+      case SWQ_FLOAT:
+        if( poFeature == NULL 
+            || !poFeature->IsFieldSet(op->field_index) )
+        {
+            poRetNode = new swq_expr_node( 0.0 );
+            poRetNode->is_null = TRUE;
+        }
+        else
+            poRetNode = new swq_expr_node( 
+                poFeature->GetFieldAsDouble(op->field_index) );
+        break;
+        
+      case SWQ_GEOMETRY:
+        if( poFeature == NULL )
+        {
+            poRetNode = new swq_expr_node( (OGRGeometry*) NULL );
+        }
+        else
+        {
+            int iSrcGeomField = ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(
+                poFeature->GetDefnRef(), op->field_index);
+            poRetNode = new swq_expr_node(
+                poFeature->GetGeomFieldRef(iSrcGeomField) );
+        }
+        break;
+
+      default:
+        if( poFeature == NULL 
+            || !poFeature->IsFieldSet(op->field_index) )
+        {
+            poRetNode = new swq_expr_node("");
+            poRetNode->is_null = TRUE;
+        }
+        else
+            poRetNode = new swq_expr_node( 
+                poFeature->GetFieldAsString(op->field_index) );
+        break;
+    }
+
+    return poRetNode;
+}
+
+/************************************************************************/
+/*                          GetFilterForJoin()                          */
+/************************************************************************/
+
+static CPLString GetFilterForJoin(swq_expr_node* poExpr, OGRFeature* poSrcFeat,
+                                  OGRLayer* poJoinLayer, int secondary_table)
+{
+    if( poExpr->eNodeType == SNT_CONSTANT )
+    {
+        char* pszRes = poExpr->Unparse(NULL, '"');
+        CPLString osRes = pszRes;
+        CPLFree(pszRes);
+        return osRes;
+    }
+
+    if( poExpr->eNodeType == SNT_COLUMN )
+    {
+        CPLAssert( poExpr->field_index != -1 );
+        CPLAssert( poExpr->table_index == 0 || poExpr->table_index == secondary_table );
+
+        if( poExpr->table_index == 0 )
+        {
+            // if source key is null, we can't do join.
+            if( !poSrcFeat->IsFieldSet( poExpr->field_index ) )
+            {
+                return "";
+            }
+            OGRFieldType ePrimaryFieldType =
+                    poSrcFeat->GetFieldDefnRef(poExpr->field_index)->GetType();
+            OGRField *psSrcField = 
+                    poSrcFeat->GetRawFieldRef(poExpr->field_index);
+
+            switch( ePrimaryFieldType )
+            {
+            case OFTInteger:
+                return CPLString().Printf("%d", psSrcField->Integer );
+                break;
+
+            case OFTInteger64:
+                return CPLString().Printf(CPL_FRMT_GIB, psSrcField->Integer64 );
+                break;
+
+            case OFTReal:
+                return CPLString().Printf("%.16g", psSrcField->Real );
+                break;
+
+            case OFTString:
+            {
+                char *pszEscaped = CPLEscapeString( psSrcField->String, 
+                                                    strlen(psSrcField->String),
+                                                    CPLES_SQL );
+                CPLString osRes = "'";
+                osRes += pszEscaped;
+                osRes += "'";
+                CPLFree( pszEscaped );
+                return osRes;
+            }
+            break;
+
+            default:
+                CPLAssert( FALSE );
+                return "";
+            }
+        }
+        
+        if(  poExpr->table_index == secondary_table )
+        {
+            OGRFieldDefn* poSecondaryFieldDefn =
+                poJoinLayer->GetLayerDefn()->GetFieldDefn(poExpr->field_index);
+            return CPLSPrintf("\"%s\"", poSecondaryFieldDefn->GetNameRef());
+        }
+
+        CPLAssert(FALSE);
+        return "";
+    }
+
+    if( poExpr->eNodeType == SNT_OPERATION )
+    {
+        /* -------------------------------------------------------------------- */
+        /*      Operation - start by unparsing all the subexpressions.          */
+        /* -------------------------------------------------------------------- */
+        std::vector<char*> apszSubExpr;
+        int i;
+
+        for( i = 0; i < poExpr->nSubExprCount; i++ )
+        {
+            CPLString osSubExpr = GetFilterForJoin(poExpr->papoSubExpr[i], poSrcFeat,
+                                                   poJoinLayer, secondary_table);
+            if( osSubExpr.size() == 0 )
+            {
+                for( --i; i >=0; i-- )
+                    CPLFree( apszSubExpr[i] );
+                return "";
+            }
+            apszSubExpr.push_back( CPLStrdup(osSubExpr) );
+        }
+
+        CPLString osExpr = poExpr->UnparseOperationFromUnparsedSubExpr(&apszSubExpr[0]);
+
+        /* -------------------------------------------------------------------- */
+        /*      cleanup subexpressions.                                         */
+        /* -------------------------------------------------------------------- */
+        for( i = 0; i < poExpr->nSubExprCount; i++ )
+            CPLFree( apszSubExpr[i] );
+
+        return osExpr;
+    }
+
+    return "";
+}
+
+/************************************************************************/
+/*                         GetFeatureMemSize()                          */
+/*                                                                      */
+/*      Rough estimate of the memory used by a feature.                 */
+/************************************************************************/
+
+static size_t GetFeatureMemSize( OGRFeature *poFeature )
+{
+    size_t nSize = sizeof(OGRFeature) +
+        poFeature->GetFieldCount() * sizeof(OGRField) +
+        poFeature->GetGeomFieldCount() * sizeof(OGRGeometry*);
+
+    for( int i = 0; i < poFeature->GetFieldCount(); i++ )
+    {
+        if( poFeature->IsFieldSet(i) &&
+            poFeature->GetFieldDefnRef(i)->GetType() == OFTString )
+            nSize += strlen(poFeature->GetRawFieldRef(i)->String) + 1;
+    }
+    for( int i = 0; i < poFeature->GetGeomFieldCount(); i++ )
+    {
+        OGRGeometry *poGeom = poFeature->GetGeomFieldRef(i);
+        if( poGeom != NULL )
+            nSize += poGeom->WkbSize();
+    }
+
+    return nSize;
+}
+
+/************************************************************************/
+/*                        ProbeCaseInsensitive()                        */
+/*                                                                      */
+/*      Per-feature lookups go through the attribute filter of the      */
+/*      secondary layer, which compares strings case insensitively      */
+/*      when evaluated by OGR SQL, but usually not when translated to   */
+/*      a database query.  Find which by filtering on a key of the      */
+/*      layer with its case changed.  Sets bCaseInsensitive, and        */
+/*      returns FALSE if this cannot be determined.                     */
+/************************************************************************/
+
+int OGRGenSQLJoinHash::ProbeCaseInsensitive( OGRLayer *poJoinLayer,
+                                             int iSecondaryField )
+
+{
+    OGRFeature *poFeature;
+    CPLString osKey;
+    CPLString osProbe;
+
+    poJoinLayer->SetAttributeFilter( NULL );
+    poJoinLayer->ResetReading();
+    while( (poFeature = poJoinLayer->GetNextFeature()) != NULL )
+    {
+        if( poFeature->IsFieldSet( iSecondaryField ) )
+        {
+            osKey = poFeature->GetFieldAsString( iSecondaryField );
+            osProbe = osKey;
+            osProbe.toupper();
+            if( osProbe == osKey )
+                osProbe.tolower();
+        }
+        delete poFeature;
+        if( osProbe != osKey )
+            break;
+    }
+
+    /* No key has letters, so case does not matter. */
+    if( osProbe == osKey )
+    {
+        bCaseInsensitive = FALSE;
+        return TRUE;
+    }
+
+    char *pszEscaped = CPLEscapeString( osProbe, -1, CPLES_SQL );
+    CPLString osFilter;
+    osFilter.Printf( "\"%s\" = '%s'",
+                     poJoinLayer->GetLayerDefn()->
+                        GetFieldDefn(iSecondaryField)->GetNameRef(),
+                     pszEscaped );
+    CPLFree( pszEscaped );
+
+    poJoinLayer->ResetReading();
+    if( poJoinLayer->SetAttributeFilter( osFilter ) != OGRERR_NONE )
+    {
+        poJoinLayer->SetAttributeFilter( NULL );
+        return FALSE;
+    }
+
+    /* A case insensitive filter also returns the feature of osKey. */
+    bCaseInsensitive = FALSE;
+    while( !bCaseInsensitive
+           && (poFeature = poJoinLayer->GetNextFeature()) != NULL )
+    {
+        if( strcmp( poFeature->GetFieldAsString( iSecondaryField ),
+                    osProbe ) != 0 )
+            bCaseInsensitive = TRUE;
+        delete poFeature;
+    }
+
+    poJoinLayer->SetAttributeFilter( NULL );
+    return TRUE;
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/*                                                                      */
+/*      Returns FALSE if the join cannot use a hash table, in which     */
+/*      case the caller must do a lookup per feature.                   */
+/************************************************************************/
+
+int OGRGenSQLJoinHash::Build( swq_join_def *psJoinInfo, OGRLayer *poSrcLayer,
+                              OGRLayer *poJoinLayer )
+
+{
+    swq_expr_node *poExpr = psJoinInfo->poExpr;
+
+/* -------------------------------------------------------------------- */
+/*      Only simple equalities between a primary and a secondary        */
+/*      field of the same kind are handled.                             */
+/* -------------------------------------------------------------------- */
+    if( poExpr->eNodeType != SNT_OPERATION || poExpr->nOperation != SWQ_EQ ||
+        poExpr->nSubExprCount != 2 ||
+        poExpr->papoSubExpr[0]->eNodeType != SNT_COLUMN ||
+        poExpr->papoSubExpr[1]->eNodeType != SNT_COLUMN )
+        return FALSE;
+
+    swq_expr_node *poPrimary = poExpr->papoSubExpr[0];
+    swq_expr_node *poSecondary = poExpr->papoSubExpr[1];
+    if( poPrimary->table_index != 0 )
+    {
+        poPrimary = poExpr->papoSubExpr[1];
+        poSecondary = poExpr->papoSubExpr[0];
+    }
+    if( poPrimary->table_index != 0 ||
+        poSecondary->table_index != psJoinInfo->secondary_table )
+        return FALSE;
+
+    OGRFeatureDefn *poSrcDefn = poSrcLayer->GetLayerDefn();
+    OGRFeatureDefn *poJoinDefn = poJoinLayer->GetLayerDefn();
+    if( poPrimary->field_index < 0 ||
+        poPrimary->field_index >= poSrcDefn->GetFieldCount() ||
+        poSecondary->field_index < 0 ||
+        poSecondary->field_index >= poJoinDefn->GetFieldCount() )
+        return FALSE;
+
+    OGRFieldType ePrimaryType =
+        poSrcDefn->GetFieldDefn(poPrimary->field_index)->GetType();
+    OGRFieldType eSecondaryType =
+        poJoinDefn->GetFieldDefn(poSecondary->field_index)->GetType();
+    if( ePrimaryType == OFTString && eSecondaryType == OFTString )
+        bStringKey = TRUE;
+    else if( (ePrimaryType == OFTInteger || ePrimaryType == OFTInteger64) &&
+             (eSecondaryType == OFTInteger || eSecondaryType == OFTInteger64) )
+        bStringKey = FALSE;
+    else
+        return FALSE;
+
+    GIntBig nMaxMem = (GIntBig) 1024 * 1024 *
+        atoi(CPLGetConfigOption("OGR_SQL_JOIN_HASH_MAX_MEMORY", "100"));
+    if( nMaxMem <= 0 )
+        return FALSE;
+
+    if( bStringKey &&
+        !ProbeCaseInsensitive( poJoinLayer, poSecondary->field_index ) )
+        return FALSE;
+
+/* -------------------------------------------------------------------- */
+/*      Load the secondary layer, keeping the first feature of each     */
+/*      key, as the per-feature lookup does.                            */
+/* -------------------------------------------------------------------- */
+    int iSecondaryField = poSecondary->field_index;
+    GIntBig nMem = 0;
+    OGRFeature *poFeature;
+
+    hSet = CPLHashSetNew( OGRGenSQLJoinHashFunc, OGRGenSQLJoinEqualFunc,
+                          OGRGenSQLJoinFreeFunc );
+
+    poJoinLayer->SetAttributeFilter( NULL );
+    poJoinLayer->ResetReading();
+    while( (poFeature = poJoinLayer->GetNextFeature()) != NULL )
+    {
+        if( !poFeature->IsFieldSet( iSecondaryField ) )
+        {
+            delete poFeature;
+            continue;
+        }
+
+        OGRGenSQLJoinHashEntry sEntry;
+        sEntry.pszKey = NULL;
+        sEntry.nKey = 0;
+        sEntry.poFeature = poFeature;
+        if( bStringKey )
+        {
+            sEntry.pszKey = CPLStrdup(poFeature->GetFieldAsString(iSecondaryField));
+            for( char *pszIter = sEntry.pszKey;
+                 bCaseInsensitive && *pszIter; pszIter++ )
+                *pszIter = (char) toupper( (unsigned char) *pszIter );
+        }
+        else
+            sEntry.nKey = poFeature->GetFieldAsInteger64(iSecondaryField);
+
+        if( CPLHashSetLookup( hSet, &sEntry ) != NULL )
+        {
+            CPLFree( sEntry.pszKey );
+            delete poFeature;
+            continue;
+        }
+
+        nMem += sizeof(OGRGenSQLJoinHashEntry) + JOIN_HASH_SET_OVERHEAD +
+                GetFeatureMemSize( poFeature ) +
+                (sEntry.pszKey ? strlen(sEntry.pszKey) + 1 : 0);
+        if( nMem > nMaxMem )
+        {
+            CPLDebug( "GenSQL",
+                      "Secondary layer %s too large for a hashed join "
+                      "(OGR_SQL_JOIN_HASH_MAX_MEMORY = " CPL_FRMT_GIB " MB). "
+                      "Falling back to per-feature lookups.",
+                      poJoinLayer->GetName(), nMaxMem / (1024 * 1024) );
+            CPLFree( sEntry.pszKey );
+            delete poFeature;
+            CPLHashSetDestroy( hSet );
+            hSet = NULL;
+            poJoinLayer->ResetReading();
+            return FALSE;
+        }
+
+        OGRGenSQLJoinHashEntry *psEntry = (OGRGenSQLJoinHashEntry *)
+            CPLMalloc( sizeof(OGRGenSQLJoinHashEntry) );
+        *psEntry = sEntry;
+        CPLHashSetInsert( hSet, psEntry );
+    }
+    poJoinLayer->ResetReading();
+
+    CPLDebug( "GenSQL", "Hashed %d distinct keys of layer %s for JOIN.",
+              CPLHashSetSize( hSet ), poJoinLayer->GetName() );
+
+    iPrimaryField = poPrimary->field_index;
+    bUsable = TRUE;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                               Lookup()                               */
+/*                                                                      */
+/*      Returns the secondary feature matching the source feature, or   */
+/*      NULL. The feature remains owned by the hash table.              */
+/************************************************************************/
+
+OGRFeature *OGRGenSQLJoinHash::Lookup( OGRFeature *poSrcFeat )
+
+{
+    // if source key is null, we can't do join.
+    if( !poSrcFeat->IsFieldSet( iPrimaryField ) )
+        return NULL;
+
+    OGRGenSQLJoinHashEntry sEntry;
+    OGRGenSQLJoinHashEntry *psEntry;
+    sEntry.poFeature = NULL;
+    sEntry.nKey = 0;
+
+    if( bStringKey )
+    {
+        CPLString osKey( poSrcFeat->GetFieldAsString( iPrimaryField ) );
+        if( bCaseInsensitive )
+            osKey.toupper();
+        sEntry.pszKey = (char *) osKey.c_str();
+        psEntry = (OGRGenSQLJoinHashEntry *) CPLHashSetLookup( hSet, &sEntry );
+    }
+    else
+    {
+        sEntry.pszKey = NULL;
+        sEntry.nKey = poSrcFeat->GetFieldAsInteger64( iPrimaryField );
+        psEntry = (OGRGenSQLJoinHashEntry *) CPLHashSetLookup( hSet, &sEntry );
+    }
+
+    return psEntry ? psEntry->poFeature : NULL;
+}
+
+/************************************************************************/
+/*                          ClearJoinHashes()                           */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::ClearJoinHashes()
+
+{
+    if( papoJoinHash == NULL )
+        return;
+
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    for( int iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++ )
+        delete papoJoinHash[iJoin];
+    CPLFree( papoJoinHash );
+    papoJoinHash = NULL;
+}
+
+/************************************************************************/
+/*                            GetJoinHash()                             */
+/*                                                                      */
+/*      Returns the hash table of a join, building it on first use,     */
+/*      or NULL if the join must be done with per-feature lookups.      */
+/************************************************************************/
+
+OGRGenSQLJoinHash *OGRGenSQLResultsLayer::GetJoinHash( int iJoin )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+
+    if( papoJoinHash == NULL )
+        papoJoinHash = (OGRGenSQLJoinHash **)
+            CPLCalloc( sizeof(OGRGenSQLJoinHash*), psSelectInfo->join_count );
+
+    if( papoJoinHash[iJoin] == NULL )
+    {
+        swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
+
+        papoJoinHash[iJoin] = new OGRGenSQLJoinHash();
+        papoJoinHash[iJoin]->Build( psJoinInfo, poSrcLayer,
+                                    papoTableLayers[psJoinInfo->secondary_table] );
+    }
+
+    return papoJoinHash[iJoin]->bUsable ? papoJoinHash[iJoin] : NULL;
+}
+
+/************************************************************************/
+/*                          TranslateFeature()                          */
+/************************************************************************/
+
+OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    OGRFeature *poDstFeat;
+    std::vector<OGRFeature*> apoFeatures;
+    std::vector<int> abJoinFeatureOwned;
+
+    if( poSrcFeat == NULL )
+        return NULL;
+
+    m_nFeaturesRead++;
+
+    apoFeatures.push_back( poSrcFeat );
+
+/* -------------------------------------------------------------------- */
+/*      Fetch the corresponding features from any jointed tables.       */
+/* -------------------------------------------------------------------- */
+    int iJoin;
+
+    for( iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++ )
+    {
+        CPLString osFilter;
+
+        swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
+
+        /* OGRMultiFeatureFetcher assumes that the features are pushed in */
+        /* apoFeatures with increasing secondary_table, so make sure */
+        /* we have taken care of this */
+        CPLAssert(psJoinInfo->secondary_table == iJoin + 1);
+
+        OGRGenSQLJoinHash *poJoinHash = GetJoinHash( iJoin );
+        if( poJoinHash != NULL )
+        {
+            apoFeatures.push_back( poJoinHash->Lookup( poSrcFeat ) );
+            abJoinFeatureOwned.push_back( FALSE );
+            continue;
+        }
+        abJoinFeatureOwned.push_back( TRUE );
+
+        OGRLayer *poJoinLayer = papoTableLayers[psJoinInfo->secondary_table];
+        
+        osFilter = GetFilterForJoin(psJoinInfo->poExpr, poSrcFeat, poJoinLayer, 
+                                    psJoinInfo->secondary_table);
+        //CPLDebug("OGR", "Filter = %s\n", osFilter.c_str());
+
+        // if source key is null, we can't do join.
+        if( osFilter.size() == 0 )
+        {
+            apoFeatures.push_back( NULL );
+            continue;
+        }
+
+        OGRFeature *poJoinFeature = NULL;
+
+        poJoinLayer->ResetReading();
+        if( poJoinLayer->SetAttributeFilter( osFilter.c_str() ) == OGRERR_NONE )
+            poJoinFeature = poJoinLayer->GetNextFeature();
+
+        apoFeatures.push_back( poJoinFeature );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Create destination feature.                                     */
+/* -------------------------------------------------------------------- */
+    poDstFeat = new OGRFeature( poDefn );
+
+    poDstFeat->SetFID( poSrcFeat->GetFID() );
+
+    poDstFeat->SetStyleString( poSrcFeat->GetStyleString() );
+
+/* -------------------------------------------------------------------- */
+/*      Evaluate fields that are complex expressions.                   */
+/* -------------------------------------------------------------------- */
+    int iRegularField = 0;
+    int iGeomField = 0;
+    for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
+    {
+        swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+        swq_expr_node *poResult;
+
+        if( psColDef->field_index != -1 )
+        {
+            if( psColDef->field_type == SWQ_GEOMETRY ||
+                psColDef->target_type == SWQ_GEOMETRY )
+                iGeomField++;
+            else
+                iRegularField++;
+            continue;
+        }
+
+        poResult = psColDef->expr->Evaluate( OGRMultiFeatureFetcher, 
+                                             (void *) &apoFeatures );
+        
+        if( poResult == NULL )
+        {
+            delete poDstFeat;
+            return NULL;
+        }
+
+        if( poResult->is_null )
+        {
+            if( poResult->field_type == SWQ_GEOMETRY )
+                iGeomField++;
+            else
+                iRegularField++;
+            delete poResult;
+            continue;
+        }
+
+        switch( poResult->field_type )
+        {
+          case SWQ_BOOLEAN:
+          case SWQ_INTEGER:
+            poDstFeat->SetField( iRegularField++, (int)poResult->int_value );
+            break;
+
+          case SWQ_INTEGER64:
+            poDstFeat->SetField( iRegularField++, poResult->int_value );
+            break;
+            
+          case SWQ_FLOAT:
+            poDstFeat->SetField( iRegularField++, poResult->float_value );
+            break;
+            
+          case SWQ_GEOMETRY:
+          {
+            OGRGenSQLGeomFieldDefn* poGeomFieldDefn =
+                (OGRGenSQLGeomFieldDefn*) poDstFeat->GetGeomFieldDefnRef(iGeomField);
+            if( poGeomFieldDefn->bForceGeomType &&
+                poResult->geometry_value != NULL )
+            {
+                OGRwkbGeometryType eCurType =
+                    wkbFlatten(poResult->geometry_value->getGeometryType());
+                OGRwkbGeometryType eReqType =
+                    wkbFlatten(poGeomFieldDefn->GetType());
+                if( eCurType == wkbPolygon && eReqType == wkbMultiPolygon )
+                {
+                    poResult->geometry_value = (OGRGeometry*)
+                        OGR_G_ForceToMultiPolygon( (OGRGeometryH) poResult->geometry_value );
+                }
+                else if( (eCurType == wkbMultiPolygon || eCurType == wkbGeometryCollection) &&
+                         eReqType == wkbPolygon )
+                {
+                    poResult->geometry_value = (OGRGeometry*)
+                        OGR_G_ForceToPolygon( (OGRGeometryH) poResult->geometry_value );
+                }
+                else if( eCurType == wkbLineString && eReqType == wkbMultiLineString )
+                {
+                    poResult->geometry_value = (OGRGeometry*)
+                        OGR_G_ForceToMultiLineString( (OGRGeometryH) poResult->geometry_value );
+                }
+                else if( (eCurType == wkbMultiLineString || eCurType == wkbGeometryCollection) &&
+                         eReqType == wkbLineString )
+                {
+                    poResult->geometry_value = (OGRGeometry*)
+                        OGR_G_ForceToLineString( (OGRGeometryH) poResult->geometry_value );
+                }
+            }
+            poDstFeat->SetGeomField( iGeomField++, poResult->geometry_value );
+            break;
+          }
+            
+          default:
+            poDstFeat->SetField( iRegularField++, poResult->string_value );
+            break;
+        }
+
+        delete poResult;
+    }
+    
+/* -------------------------------------------------------------------- */
+/*      Copy fields from primary record to the destination feature.     */
+/* -------------------------------------------------------------------- */
+    iRegularField = 0;
+    iGeomField = 0;
+    for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
+    {
+        swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+
+        if( psColDef->table_index != 0 )
+        {
+            if( psColDef->field_type == SWQ_GEOMETRY ||
+                psColDef->target_type == SWQ_GEOMETRY )
+                iGeomField++;
+            else
+                iRegularField++;
+            continue;
+        }
+
+        if( IS_GEOM_FIELD_INDEX(poSrcFeat->GetDefnRef(), psColDef->field_index) )
+        {
+            int iSrcGeomField = ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(
+                poSrcFeat->GetDefnRef(), psColDef->field_index);
+            poDstFeat->SetGeomField( iGeomField ++,
+                                     poSrcFeat->GetGeomFieldRef(iSrcGeomField) );
+        }
+        else if( psColDef->field_index >= iFIDFieldIndex &&
+                 psColDef->field_index < iFIDFieldIndex + SPECIAL_FIELD_COUNT )
+        {
+            switch (SpecialFieldTypes[psColDef->field_index - iFIDFieldIndex])
+            {
+              case SWQ_INTEGER:
+                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsInteger(psColDef->field_index) );
+                break;
+              case SWQ_INTEGER64:
+                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsInteger64(psColDef->field_index) );
+                break;
+              case SWQ_FLOAT:
+                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsDouble(psColDef->field_index) );
+                break;
+              default:
+                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsString(psColDef->field_index) );
+            }
+            iRegularField ++;
+        }
+        else
+        {
+            switch (psColDef->target_type)
+            {
+              case SWQ_INTEGER:
+                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsInteger(psColDef->field_index) );
+                break;
+
+              case SWQ_INTEGER64:
+                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsInteger64(psColDef->field_index) );
+                break;
+
+              case SWQ_FLOAT:
+                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsDouble(psColDef->field_index) );
+                break;
+              
+              case SWQ_STRING:
+              case SWQ_TIMESTAMP:
+              case SWQ_DATE:
+              case SWQ_TIME:
+                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsString(psColDef->field_index) );
+                break;
+                
+              case SWQ_GEOMETRY:
+                  CPLAssert(0);
+                  break;
+
+              default:
+                poDstFeat->SetField( iRegularField,
+                         poSrcFeat->GetRawFieldRef( psColDef->field_index ) );
+            }
+            iRegularField ++;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Copy values from any joined tables.                             */
+/* -------------------------------------------------------------------- */
+    for( iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++ )
+    {
+        CPLString osFilter;
+
+        swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
+        OGRFeature *poJoinFeature = apoFeatures[iJoin+1];
+
+        if( poJoinFeature == NULL )
+            continue;
+
+        // Copy over selected field values. 
+        iRegularField = 0;
+        for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
+        {
+            swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+
+            if( psColDef->field_type == SWQ_GEOMETRY ||
+                psColDef->target_type == SWQ_GEOMETRY )
+                continue;
+
+            if( psColDef->table_index == psJoinInfo->secondary_table )
+                poDstFeat->SetField( iRegularField,
+                                     poJoinFeature->GetRawFieldRef( 
+                                         psColDef->field_index ) );
+
+            iRegularField ++;
+        }
+
+        if( abJoinFeatureOwned[iJoin] )
+            delete poJoinFeature;
+    }
+
+    return poDstFeat;
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature *OGRGenSQLResultsLayer::GetNextFeature()
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+
+    CreateOrderByIndex();
+
+/* -------------------------------------------------------------------- */
+/*      Handle summary sets.                                            */
+/* -------------------------------------------------------------------- */
+    if( psSelectInfo->query_mode == SWQM_SUMMARY_RECORD 
+        || psSelectInfo->query_mode == SWQM_DISTINCT_LIST 
+        || psSelectInfo->query_mode == SWQM_GROUP_BY )
+        return GetFeature( nNextIndexFID++ );
+
+    int bEvaluateSpatialFilter = MustEvaluateSpatialFilterOnGenSQL();
+
+/* -------------------------------------------------------------------- */
+/*      Handle ordered sets.                                            */
+/* -------------------------------------------------------------------- */
+    while( TRUE )
+    {
+        OGRFeature *poFeature;
+
+        if( panFIDIndex != NULL )
+            poFeature =  GetFeature( nNextIndexFID++ );
+        else if( papoSortedFeatures != NULL || poSortRuns != NULL )
+        {
+            OGRFeature *poSrcFeat = GetSortedSrcFeature( nNextIndexFID++ );
+
+            if( poSrcFeat == NULL )
+                return NULL;
+
+            poFeature = TranslateFeature( poSrcFeat );
+        }
+        else if( panSrcIndexFIDs != NULL )
+        {
+            if( panSrcIndexFIDs[iNextSrcIndexFID] == OGRNullFID )
+                return NULL;
+
+            OGRFeature *poSrcFeat =
+                poSrcLayer->GetFeature( panSrcIndexFIDs[iNextSrcIndexFID++] );
+
+            /* the index may be a superset of the WHERE clause result */
+            if( poSrcFeat == NULL )
+                continue;
+            if( !poSrcIndexQuery->Evaluate( poSrcFeat ) )
+            {
+                delete poSrcFeat;
+                continue;
+            }
+
+            poFeature = TranslateFeature( poSrcFeat );
+            delete poSrcFeat;
+        }
+        else
+        {
+            OGRFeature *poSrcFeat = poSrcLayer->GetNextFeature();
+
+            if( poSrcFeat == NULL )
+                return NULL;
+            
+            poFeature = TranslateFeature( poSrcFeat );
+            delete poSrcFeat;
+        }
+
+        if( poFeature == NULL )
+            return NULL;
+
+        if( (m_poAttrQuery == NULL
+            || m_poAttrQuery->Evaluate( poFeature )) &&
+            (!bEvaluateSpatialFilter ||
+             FilterGeometry( poFeature->GetGeomFieldRef(m_iGeomFieldFilter) )) )
+            return poFeature;
+
+        delete poFeature;
+    }
+
+    return NULL;
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/************************************************************************/
+
+OGRFeature *OGRGenSQLResultsLayer::GetFeature( GIntBig nFID )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+
+    CreateOrderByIndex();
+
+/* -------------------------------------------------------------------- */
+/*      Handle request for summary record.                              */
+/* -------------------------------------------------------------------- */
+    if( psSelectInfo->query_mode == SWQM_SUMMARY_RECORD )
+    {
+        if( !PrepareSummary() || nFID != 0 || poSummaryFeature == NULL )
+            return NULL;
+        else
+            return poSummaryFeature->Clone();
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Handle request for distinct list record.                        */
+/* -------------------------------------------------------------------- */
+    if( psSelectInfo->query_mode == SWQM_DISTINCT_LIST )
+    {
+        if( !PrepareSummary() )
+            return NULL;
+
+        swq_summary *psSummary = psSelectInfo->column_summary + 0;
+
+        if( psSummary == NULL )
+            return NULL;
+
+        if( nFID < 0 || nFID >= psSummary->count )
+            return NULL;
+
+        if( psSummary->distinct_list[nFID] != NULL )
+            poSummaryFeature->SetField( 0, psSummary->distinct_list[nFID] );
+        else
+            poSummaryFeature->UnsetField( 0 );
+        poSummaryFeature->SetFID( nFID );
+
+        return poSummaryFeature->Clone();
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Handle request for a group of a GROUP BY.                       */
+/* -------------------------------------------------------------------- */
+    if( psSelectInfo->query_mode == SWQM_GROUP_BY )
+    {
+        if( !PrepareSummary() || nFID < 0 || nFID >= nGroupFeatureCount )
+            return NULL;
+
+        return papoGroupFeatures[nFID]->Clone();
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Are we running in sorted mode?  If so, run the fid through      */
+/*      the index.                                                      */
+/* -------------------------------------------------------------------- */
+    if( panFIDIndex != NULL )
+    {
+        if( nFID < 0 || nFID >= nIndexSize )
+            return NULL;
+        else
+            nFID = panFIDIndex[nFID];
+    }
+    else if( papoSortedFeatures != NULL || poSortRuns != NULL )
+    {
+        OGRFeature *poSrcFeature = GetSortedSrcFeature( nFID );
+
+        if( poSrcFeature == NULL )
+            return NULL;
+
+        return TranslateFeature( poSrcFeature );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Handle request for random record.                               */
+/* -------------------------------------------------------------------- */
+    OGRFeature *poSrcFeature = poSrcLayer->GetFeature( nFID );
+    OGRFeature *poResult;
+
+    if( poSrcFeature == NULL )
+        return NULL;
+
+    poResult = TranslateFeature( poSrcFeature );
+    poResult->SetFID( nFID );
+    
+    delete poSrcFeature;
+
+    return poResult;
+}
+
+/************************************************************************/
+/*                          GetSpatialFilter()                          */
+/************************************************************************/
+
+OGRGeometry *OGRGenSQLResultsLayer::GetSpatialFilter() 
+
+{
+    return NULL;
+}
+
+/************************************************************************/
+/*                            GetLayerDefn()                            */
+/************************************************************************/
+
+OGRFeatureDefn *OGRGenSQLResultsLayer::GetLayerDefn()
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    if( (psSelectInfo->query_mode == SWQM_SUMMARY_RECORD ||
+         psSelectInfo->query_mode == SWQM_GROUP_BY) &&
+        poSummaryFeature == NULL )
+    {
+        // Run PrepareSummary() is we have a COUNT column so as to be
+        // able to downcast it from OFTInteger64 to OFTInteger
+        for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
+        {
+            swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+            if( psColDef->col_func == SWQCF_COUNT )
+            {
+                PrepareSummary();
+                break;
+            }
+        }
+    }
+
+    return poDefn;
+}
+
+/************************************************************************/
+/*                         SerializeFeature()                           */
+/*                                                                      */
+/*      Serialize a feature in native byte order, for the temporary     */
+/*      files of the ORDER BY external sort.                            */
+/************************************************************************/
+
+static void AppendBytes( std::vector<GByte>& abyRecord,
+                         const void *pData, size_t nSize )
+{
+    const GByte *pabyData = (const GByte *) pData;
+    abyRecord.insert( abyRecord.end(), pabyData, pabyData + nSize );
+}
+
+static void AppendString( std::vector<GByte>& abyRecord, const char *pszStr )
+{
+    int nLen = (pszStr != NULL) ? (int) strlen(pszStr) : -1;
+    AppendBytes( abyRecord, &nLen, sizeof(int) );
+    if( nLen > 0 )
+        AppendBytes( abyRecord, pszStr, nLen );
+}
+
+static void SerializeFeature( OGRFeature *poFeature,
+                              std::vector<GByte>& abyRecord )
+
+{
+    abyRecord.resize( 0 );
+
+    GIntBig nFID = poFeature->GetFID();
+    AppendBytes( abyRecord, &nFID, sizeof(GIntBig) );
+    AppendString( abyRecord, poFeature->GetStyleString() );
+
+    for( int i = 0; i < poFeature->GetFieldCount(); i++ )
+    {
+        GByte bSet = (GByte) poFeature->IsFieldSet(i);
+        AppendBytes( abyRecord, &bSet, 1 );
+        if( !bSet )
+            continue;
+
+        OGRField *psField = poFeature->GetRawFieldRef(i);
+        switch( poFeature->GetFieldDefnRef(i)->GetType() )
+        {
+          case OFTString:
+            AppendString( abyRecord, psField->String );
             break;
-            
-          case SWQ_GEOMETRY:
+
+          case OFTIntegerList:
+            AppendBytes( abyRecord, &(psField->IntegerList.nCount), sizeof(int) );
+            AppendBytes( abyRecord, psField->IntegerList.paList,
+                         sizeof(int) * psField->IntegerList.nCount );
+            break;
+
+          case OFTInteger64List:
+            AppendBytes( abyRecord, &(psField->Integer64List.nCount), sizeof(int) );
+            AppendBytes( abyRecord, psField->Integer64List.paList,
+                         sizeof(GIntBig) * psField->Integer64List.nCount );
+            break;
+
+          case OFTRealList:
+            AppendBytes( abyRecord, &(psField->RealList.nCount), sizeof(int) );
+            AppendBytes( abyRecord, psField->RealList.paList,
+                         sizeof(double) * psField->RealList.nCount );
+            break;
+
+          case OFTStringList:
+            AppendBytes( abyRecord, &(psField->StringList.nCount), sizeof(int) );
+            for( int j = 0; j < psField->StringList.nCount; j++ )
+                AppendString( abyRecord, psField->StringList.paList[j] );
+            break;
+
+          case OFTBinary:
+            AppendBytes( abyRecord, &(psField->Binary.nCount), sizeof(int) );
+            AppendBytes( abyRecord, psField->Binary.paData,
+                         psField->Binary.nCount );
+            break;
+
+          default:
+            /* Integer, Integer64, Real, Date, Time and DateTime */
+            AppendBytes( abyRecord, psField, sizeof(OGRField) );
+            break;
+        }
+    }
+
+    for( int i = 0; i < poFeature->GetGeomFieldCount(); i++ )
+    {
+        OGRGeometry *poGeom = poFeature->GetGeomFieldRef(i);
+        int nWkbSize = (poGeom != NULL) ? poGeom->WkbSize() : 0;
+        AppendBytes( abyRecord, &nWkbSize, sizeof(int) );
+        if( nWkbSize > 0 )
+        {
+            size_t nOffset = abyRecord.size();
+            abyRecord.resize( nOffset + nWkbSize );
+            poGeom->exportToWkb( wkbNDR, &abyRecord[nOffset], wkbVariantIso );
+        }
+    }
+}
+
+/************************************************************************/
+/*                        DeserializeFeature()                          */
+/************************************************************************/
+
+class OGRGenSQLRecordReader
+{
+    const GByte *pabyCur;
+    const GByte *pabyEnd;
+
+  public:
+    OGRGenSQLRecordReader( const GByte *pabyData, size_t nSize ) :
+        pabyCur(pabyData), pabyEnd(pabyData + nSize) {}
+
+    int Read( void *pDst, size_t nSize )
+    {
+        if( (size_t)(pabyEnd - pabyCur) < nSize )
+            return FALSE;
+        memcpy( pDst, pabyCur, nSize );
+        pabyCur += nSize;
+        return TRUE;
+    }
+
+    int ReadCount( int *pnCount, size_t nEltSize )
+    {
+        return Read( pnCount, sizeof(int) ) && *pnCount >= 0 &&
+               (size_t)(pabyEnd - pabyCur) / nEltSize >= (size_t)*pnCount;
+    }
+
+    int ReadString( CPLString& osStr, int *pbIsNull )
+    {
+        int nLen;
+        if( !Read( &nLen, sizeof(int) ) )
+            return FALSE;
+        *pbIsNull = (nLen < 0);
+        if( nLen <= 0 )
+        {
+            osStr.resize( 0 );
+            return TRUE;
+        }
+        if( (size_t)(pabyEnd - pabyCur) < (size_t)nLen )
+            return FALSE;
+        osStr.assign( (const char *) pabyCur, nLen );
+        pabyCur += nLen;
+        return TRUE;
+    }
+
+    const GByte *GetCur() { return pabyCur; }
+    int Skip( size_t nSize )
+    {
+        if( (size_t)(pabyEnd - pabyCur) < nSize )
+            return FALSE;
+        pabyCur += nSize;
+        return TRUE;
+    }
+};
+
+static OGRFeature *DeserializeFeature( OGRFeatureDefn *poDefn,
+                                       const GByte *pabyData, size_t nSize )
+
+{
+    OGRGenSQLRecordReader oReader( pabyData, nSize );
+    OGRFeature *poFeature = new OGRFeature( poDefn );
+    CPLString osStr;
+    int bIsNull;
+    GIntBig nFID;
+    int bOK = TRUE;
+
+    bOK = oReader.Read( &nFID, sizeof(GIntBig) ) &&
+          oReader.ReadString( osStr, &bIsNull );
+    if( bOK )
+    {
+        poFeature->SetFID( nFID );
+        if( !bIsNull )
+            poFeature->SetStyleString( osStr );
+    }
+
+    for( int i = 0; bOK && i < poFeature->GetFieldCount(); i++ )
+    {
+        GByte bSet = 0;
+        if( !oReader.Read( &bSet, 1 ) )
+        {
+            bOK = FALSE;
+            break;
+        }
+        if( !bSet )
+            continue;
+
+        int nCount = 0;
+        switch( poDefn->GetFieldDefn(i)->GetType() )
+        {
+          case OFTString:
+            bOK = oReader.ReadString( osStr, &bIsNull );
+            if( bOK )
+                poFeature->SetField( i, osStr.c_str() );
+            break;
+
+          case OFTIntegerList:
           {
-            OGRGenSQLGeomFieldDefn* poGeomFieldDefn =
-                (OGRGenSQLGeomFieldDefn*) poDstFeat->GetGeomFieldDefnRef(iGeomField);
-            if( poGeomFieldDefn->bForceGeomType &&
-                poResult->geometry_value != NULL )
+            bOK = oReader.ReadCount( &nCount, sizeof(int) );
+            if( bOK )
             {
-                OGRwkbGeometryType eCurType =
-                    wkbFlatten(poResult->geometry_value->getGeometryType());
-                OGRwkbGeometryType eReqType =
-                    wkbFlatten(poGeomFieldDefn->GetType());
-                if( eCurType == wkbPolygon && eReqType == wkbMultiPolygon )
-                {
-                    poResult->geometry_value = (OGRGeometry*)
-                        OGR_G_ForceToMultiPolygon( (OGRGeometryH) poResult->geometry_value );
-                }
-                else if( (eCurType == wkbMultiPolygon || eCurType == wkbGeometryCollection) &&
-                         eReqType == wkbPolygon )
-                {
-                    poResult->geometry_value = (OGRGeometry*)
-                        OGR_G_ForceToPolygon( (OGRGeometryH) poResult->geometry_value );
-                }
-                else if( eCurType == wkbLineString && eReqType == wkbMultiLineString )
-                {
-                    poResult->geometry_value = (OGRGeometry*)
-                        OGR_G_ForceToMultiLineString( (OGRGeometryH) poResult->geometry_value );
-                }
-                else if( (eCurType == wkbMultiLineString || eCurType == wkbGeometryCollection) &&
-                         eReqType == wkbLineString )
-                {
-                    poResult->geometry_value = (OGRGeometry*)
-                        OGR_G_ForceToLineString( (OGRGeometryH) poResult->geometry_value );
-                }
+                std::vector<int> anList( nCount + 1 );
+                oReader.Read( &anList[0], sizeof(int) * nCount );
+                poFeature->SetField( i, nCount, &anList[0] );
+            }
+            break;
+          }
+
+          case OFTInteger64List:
+          {
+            bOK = oReader.ReadCount( &nCount, sizeof(GIntBig) );
+            if( bOK )
+            {
+                std::vector<GIntBig> anList( nCount + 1 );
+                oReader.Read( &anList[0], sizeof(GIntBig) * nCount );
+                poFeature->SetField( i, nCount, &anList[0] );
+            }
+            break;
+          }
+
+          case OFTRealList:
+          {
+            bOK = oReader.ReadCount( &nCount, sizeof(double) );
+            if( bOK )
+            {
+                std::vector<double> adfList( nCount + 1 );
+                oReader.Read( &adfList[0], sizeof(double) * nCount );
+                poFeature->SetField( i, nCount, &adfList[0] );
+            }
+            break;
+          }
+
+          case OFTStringList:
+          {
+            bOK = oReader.ReadCount( &nCount, sizeof(int) );
+            char **papszList = NULL;
+            for( int j = 0; bOK && j < nCount; j++ )
+            {
+                bOK = oReader.ReadString( osStr, &bIsNull );
+                papszList = CSLAddString( papszList, osStr );
+            }
+            if( bOK )
+                poFeature->SetField( i, papszList );
+            CSLDestroy( papszList );
+            break;
+          }
+
+          case OFTBinary:
+          {
+            bOK = oReader.ReadCount( &nCount, 1 );
+            if( bOK )
+            {
+                poFeature->SetField( i, nCount, (GByte *) oReader.GetCur() );
+                oReader.Skip( nCount );
             }
-            poDstFeat->SetGeomField( iGeomField++, poResult->geometry_value );
             break;
           }
-            
+
           default:
-            poDstFeat->SetField( iRegularField++, poResult->string_value );
+          {
+            OGRField sField;
+            bOK = oReader.Read( &sField, sizeof(OGRField) );
+            if( bOK )
+                poFeature->SetField( i, &sField );
             break;
+          }
         }
-
-        delete poResult;
     }
-    
-/* -------------------------------------------------------------------- */
-/*      Copy fields from primary record to the destination feature.     */
-/* -------------------------------------------------------------------- */
-    iRegularField = 0;
-    iGeomField = 0;
-    for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
-    {
-        swq_col_def *psColDef = psSelectInfo->column_defs + iField;
 
-        if( psColDef->table_index != 0 )
-        {
-            if( psColDef->field_type == SWQ_GEOMETRY ||
-                psColDef->target_type == SWQ_GEOMETRY )
-                iGeomField++;
-            else
-                iRegularField++;
+    for( int i = 0; bOK && i < poFeature->GetGeomFieldCount(); i++ )
+    {
+        int nWkbSize = 0;
+        bOK = oReader.ReadCount( &nWkbSize, 1 );
+        if( !bOK || nWkbSize == 0 )
             continue;
-        }
 
-        if( IS_GEOM_FIELD_INDEX(poSrcFeat->GetDefnRef(), psColDef->field_index) )
-        {
-            int iSrcGeomField = ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(
-                poSrcFeat->GetDefnRef(), psColDef->field_index);
-            poDstFeat->SetGeomField( iGeomField ++,
-                                     poSrcFeat->GetGeomFieldRef(iSrcGeomField) );
-        }
-        else if( psColDef->field_index >= iFIDFieldIndex &&
-                 psColDef->field_index < iFIDFieldIndex + SPECIAL_FIELD_COUNT )
+        OGRGeometry *poGeom = NULL;
+        if( OGRGeometryFactory::createFromWkb( (unsigned char *) oReader.GetCur(),
+                                               NULL, &poGeom, nWkbSize,
+                                               wkbVariantIso ) != OGRERR_NONE )
         {
-            switch (SpecialFieldTypes[psColDef->field_index - iFIDFieldIndex])
-            {
-              case SWQ_INTEGER:
-                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsInteger(psColDef->field_index) );
-                break;
-              case SWQ_INTEGER64:
-                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsInteger64(psColDef->field_index) );
-                break;
-              case SWQ_FLOAT:
-                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsDouble(psColDef->field_index) );
-                break;
-              default:
-                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsString(psColDef->field_index) );
-            }
-            iRegularField ++;
+            bOK = FALSE;
+            break;
         }
-        else
-        {
-            switch (psColDef->target_type)
-            {
-              case SWQ_INTEGER:
-                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsInteger(psColDef->field_index) );
-                break;
+        oReader.Skip( nWkbSize );
+        poGeom->assignSpatialReference(
+            poDefn->GetGeomFieldDefn(i)->GetSpatialRef() );
+        poFeature->SetGeomFieldDirectly( i, poGeom );
+    }
 
-              case SWQ_INTEGER64:
-                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsInteger64(psColDef->field_index) );
-                break;
+    if( !bOK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Corrupted record in ORDER BY temporary file" );
+        delete poFeature;
+        return NULL;
+    }
 
-              case SWQ_FLOAT:
-                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsDouble(psColDef->field_index) );
-                break;
-              
-              case SWQ_STRING:
-              case SWQ_TIMESTAMP:
-              case SWQ_DATE:
-              case SWQ_TIME:
-                poDstFeat->SetField( iRegularField, poSrcFeat->GetFieldAsString(psColDef->field_index) );
-                break;
-                
-              case SWQ_GEOMETRY:
-                  CPLAssert(0);
-                  break;
+    return poFeature;
+}
 
-              default:
-                poDstFeat->SetField( iRegularField,
-                         poSrcFeat->GetRawFieldRef( psColDef->field_index ) );
-            }
-            iRegularField ++;
-        }
-    }
+/************************************************************************/
+/*                          OGRGenSQLSortRuns                           */
+/*                                                                      */
+/*      Sorted runs of source features written to a temporary file,     */
+/*      and merged back when reading the results of an ORDER BY.        */
+/************************************************************************/
 
-/* -------------------------------------------------------------------- */
-/*      Copy values from any joined tables.                             */
-/* -------------------------------------------------------------------- */
-    for( iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++ )
-    {
-        CPLString osFilter;
+#define SORT_RUN_BUFFER_SIZE 65536
 
-        swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
-        OGRFeature *poJoinFeature = apoFeatures[iJoin+1];
+typedef struct
+{
+    vsi_l_offset nStart;
+    vsi_l_offset nEnd;
+    vsi_l_offset nOffset;       /* next file offset to load in the buffer */
 
-        if( poJoinFeature == NULL )
-            continue;
+    GByte       *pabyBuffer;
+    size_t       nBufferPos;
+    size_t       nBufferFilled;
 
-        // Copy over selected field values. 
-        iRegularField = 0;
-        for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
-        {
-            swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+    OGRFeature  *poFeature;     /* next feature of the run, or NULL */
+    OGRField    *pasKeys;       /* its ORDER BY keys */
+} OGRGenSQLSortRun;
 
-            if( psColDef->field_type == SWQ_GEOMETRY ||
-                psColDef->target_type == SWQ_GEOMETRY )
-                continue;
+class OGRGenSQLSortRuns
+{
+    OGRGenSQLResultsLayer *poLayer;
+    OGRFeatureDefn *poSrcDefn;
+    int             nOrderItems;
 
-            if( psColDef->table_index == psJoinInfo->secondary_table )
-                poDstFeat->SetField( iRegularField,
-                                     poJoinFeature->GetRawFieldRef( 
-                                         psColDef->field_index ) );
+    CPLString       osFilename;
+    VSILFILE       *fp;
+    vsi_l_offset    nFileSize;
 
-            iRegularField ++;
-        }
+    std::vector<OGRGenSQLSortRun> asRuns;
+    std::vector<int> anHeap;
+    std::vector<GByte> abyRecord;
 
-        delete poJoinFeature;
-    }
+    OGRFeature     *poCurFeature;
 
-    return poDstFeat;
-}
+    int             ReadBytes( OGRGenSQLSortRun *psRun, void *pDst, size_t nSize );
+    int             ReadHead( int iRun );
+    int             Before( int iRun1, int iRun2 );
+    void            SiftDown( int iPos );
+
+  public:
+    GIntBig         nNextIndex;
+
+                    OGRGenSQLSortRuns( OGRGenSQLResultsLayer *poLayerIn,
+                                       OGRFeatureDefn *poSrcDefnIn );
+                   ~OGRGenSQLSortRuns();
+
+    int             GetRunCount() { return (int) asRuns.size(); }
+    OGRFeature     *GetCurFeature() { return poCurFeature; }
+
+    int             WriteRun( OGRFeature **papoFeatures, int nCount );
+    void            Rewind();
+    OGRFeature     *GetNext();
+};
 
 /************************************************************************/
-/*                           GetNextFeature()                           */
+/*                         OGRGenSQLSortRuns()                          */
 /************************************************************************/
 
-OGRFeature *OGRGenSQLResultsLayer::GetNextFeature()
+OGRGenSQLSortRuns::OGRGenSQLSortRuns( OGRGenSQLResultsLayer *poLayerIn,
+                                      OGRFeatureDefn *poSrcDefnIn )
 
 {
-    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    poLayer = poLayerIn;
+    poSrcDefn = poSrcDefnIn;
+    poSrcDefn->Reference();
+    nOrderItems = ((swq_select *) poLayer->pSelectInfo)->order_specs;
+    fp = NULL;
+    nFileSize = 0;
+    poCurFeature = NULL;
+    nNextIndex = 0;
+}
 
-    CreateOrderByIndex();
+/************************************************************************/
+/*                         ~OGRGenSQLSortRuns()                         */
+/************************************************************************/
 
-/* -------------------------------------------------------------------- */
-/*      Handle summary sets.                                            */
-/* -------------------------------------------------------------------- */
-    if( psSelectInfo->query_mode == SWQM_SUMMARY_RECORD 
-        || psSelectInfo->query_mode == SWQM_DISTINCT_LIST )
-        return GetFeature( nNextIndexFID++ );
+OGRGenSQLSortRuns::~OGRGenSQLSortRuns()
 
-    int bEvaluateSpatialFilter = MustEvaluateSpatialFilterOnGenSQL();
+{
+    for( size_t i = 0; i < asRuns.size(); i++ )
+    {
+        delete asRuns[i].poFeature;
+        if( asRuns[i].pasKeys != NULL )
+        {
+            poLayer->FreeOrderByKeys( asRuns[i].pasKeys, 1 );
+            CPLFree( asRuns[i].pasKeys );
+        }
+        CPLFree( asRuns[i].pabyBuffer );
+    }
+    delete poCurFeature;
+    poSrcDefn->Release();
 
-/* -------------------------------------------------------------------- */
-/*      Handle ordered sets.                                            */
-/* -------------------------------------------------------------------- */
-    while( TRUE )
+    if( fp != NULL )
     {
-        OGRFeature *poFeature;
+        VSIFCloseL( fp );
+        VSIUnlink( osFilename );
+    }
+}
 
-        if( panFIDIndex != NULL )
-            poFeature =  GetFeature( nNextIndexFID++ );
-        else
+/************************************************************************/
+/*                              WriteRun()                              */
+/*                                                                      */
+/*      Append an already sorted run of features to the temporary       */
+/*      file.                                                           */
+/************************************************************************/
+
+int OGRGenSQLSortRuns::WriteRun( OGRFeature **papoFeatures, int nCount )
+
+{
+    if( fp == NULL )
+    {
+        osFilename = CPLGenerateTempFilename( "ogr_sql_sort" );
+        fp = VSIFOpenL( osFilename, "wb+" );
+        if( fp == NULL )
         {
-            OGRFeature *poSrcFeat = poSrcLayer->GetNextFeature();
+            CPLError( CE_Failure, CPLE_OpenFailed,
+                      "Cannot create temporary file %s for ORDER BY",
+                      osFilename.c_str() );
+            return FALSE;
+        }
+    }
 
-            if( poSrcFeat == NULL )
-                return NULL;
-            
-            poFeature = TranslateFeature( poSrcFeat );
-            delete poSrcFeat;
+    OGRGenSQLSortRun sRun;
+    memset( &sRun, 0, sizeof(sRun) );
+    sRun.nStart = nFileSize;
+
+    VSIFSeekL( fp, nFileSize, SEEK_SET );
+    for( int i = 0; i < nCount; i++ )
+    {
+        SerializeFeature( papoFeatures[i], abyRecord );
+        GUInt32 nSize = (GUInt32) abyRecord.size();
+        if( VSIFWriteL( &nSize, sizeof(GUInt32), 1, fp ) != 1 ||
+            VSIFWriteL( &abyRecord[0], 1, nSize, fp ) != nSize )
+        {
+            CPLError( CE_Failure, CPLE_FileIO,
+                      "Cannot write in temporary file %s for ORDER BY",
+                      osFilename.c_str() );
+            return FALSE;
         }
+        nFileSize += sizeof(GUInt32) + nSize;
+    }
 
-        if( poFeature == NULL )
-            return NULL;
+    sRun.nEnd = nFileSize;
+    sRun.pasKeys = (OGRField *) CPLCalloc( sizeof(OGRField), nOrderItems );
+    asRuns.push_back( sRun );
 
-        if( (m_poAttrQuery == NULL
-            || m_poAttrQuery->Evaluate( poFeature )) &&
-            (!bEvaluateSpatialFilter ||
-             FilterGeometry( poFeature->GetGeomFieldRef(m_iGeomFieldFilter) )) )
-            return poFeature;
+    return TRUE;
+}
 
-        delete poFeature;
+/************************************************************************/
+/*                             ReadBytes()                              */
+/************************************************************************/
+
+int OGRGenSQLSortRuns::ReadBytes( OGRGenSQLSortRun *psRun,
+                                  void *pDst, size_t nSize )
+
+{
+    GByte *pabyDst = (GByte *) pDst;
+
+    while( nSize > 0 )
+    {
+        if( psRun->nBufferPos == psRun->nBufferFilled )
+        {
+            if( psRun->nOffset >= psRun->nEnd )
+                return FALSE;
+            if( psRun->pabyBuffer == NULL )
+                psRun->pabyBuffer = (GByte *) CPLMalloc( SORT_RUN_BUFFER_SIZE );
+
+            size_t nToRead = SORT_RUN_BUFFER_SIZE;
+            if( psRun->nEnd - psRun->nOffset < nToRead )
+                nToRead = (size_t) (psRun->nEnd - psRun->nOffset);
+            VSIFSeekL( fp, psRun->nOffset, SEEK_SET );
+            psRun->nBufferFilled = VSIFReadL( psRun->pabyBuffer, 1, nToRead, fp );
+            psRun->nBufferPos = 0;
+            if( psRun->nBufferFilled == 0 )
+                return FALSE;
+            psRun->nOffset += psRun->nBufferFilled;
+        }
+
+        size_t nAvail = psRun->nBufferFilled - psRun->nBufferPos;
+        if( nAvail > nSize )
+            nAvail = nSize;
+        memcpy( pabyDst, psRun->pabyBuffer + psRun->nBufferPos, nAvail );
+        psRun->nBufferPos += nAvail;
+        pabyDst += nAvail;
+        nSize -= nAvail;
     }
 
-    return NULL;
+    return TRUE;
 }
 
 /************************************************************************/
-/*                             GetFeature()                             */
+/*                              ReadHead()                              */
+/*                                                                      */
+/*      Load the next feature of a run and its keys.                    */
 /************************************************************************/
 
-OGRFeature *OGRGenSQLResultsLayer::GetFeature( GIntBig nFID )
+int OGRGenSQLSortRuns::ReadHead( int iRun )
 
 {
-    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    OGRGenSQLSortRun *psRun = &(asRuns[iRun]);
 
-    CreateOrderByIndex();
+    delete psRun->poFeature;
+    psRun->poFeature = NULL;
+    poLayer->FreeOrderByKeys( psRun->pasKeys, 1 );
+    memset( psRun->pasKeys, 0, sizeof(OGRField) * nOrderItems );
 
-/* -------------------------------------------------------------------- */
-/*      Handle request for summary record.                              */
-/* -------------------------------------------------------------------- */
-    if( psSelectInfo->query_mode == SWQM_SUMMARY_RECORD )
-    {
-        if( !PrepareSummary() || nFID != 0 || poSummaryFeature == NULL )
-            return NULL;
-        else
-            return poSummaryFeature->Clone();
-    }
+    GUInt32 nSize;
+    if( !ReadBytes( psRun, &nSize, sizeof(GUInt32) ) )
+        return FALSE;
 
-/* -------------------------------------------------------------------- */
-/*      Handle request for distinct list record.                        */
-/* -------------------------------------------------------------------- */
-    if( psSelectInfo->query_mode == SWQM_DISTINCT_LIST )
-    {
-        if( !PrepareSummary() )
-            return NULL;
+    abyRecord.resize( nSize + 1 );
+    if( !ReadBytes( psRun, &abyRecord[0], nSize ) )
+        return FALSE;
 
-        swq_summary *psSummary = psSelectInfo->column_summary + 0;
+    psRun->poFeature = DeserializeFeature( poSrcDefn, &abyRecord[0], nSize );
+    if( psRun->poFeature == NULL )
+        return FALSE;
 
-        if( psSummary == NULL )
-            return NULL;
+    poLayer->ExtractOrderByKeys( psRun->poFeature, psRun->pasKeys );
+    return TRUE;
+}
 
-        if( nFID < 0 || nFID >= psSummary->count )
-            return NULL;
+/************************************************************************/
+/*                               Before()                               */
+/*                                                                      */
+/*      Whether the head of a run must be returned before the head of   */
+/*      another one. Ties are broken by run order, so that the merge    */
+/*      is stable like SortIndexSection().                              */
+/************************************************************************/
 
-        if( psSummary->distinct_list[nFID] != NULL )
-            poSummaryFeature->SetField( 0, psSummary->distinct_list[nFID] );
-        else
-            poSummaryFeature->UnsetField( 0 );
-        poSummaryFeature->SetFID( nFID );
+int OGRGenSQLSortRuns::Before( int iRun1, int iRun2 )
 
-        return poSummaryFeature->Clone();
-    }
+{
+    int nResult = poLayer->Compare( asRuns[iRun1].pasKeys,
+                                    asRuns[iRun2].pasKeys );
+    return nResult > 0 || (nResult == 0 && iRun1 < iRun2);
+}
 
-/* -------------------------------------------------------------------- */
-/*      Are we running in sorted mode?  If so, run the fid through      */
-/*      the index.                                                      */
-/* -------------------------------------------------------------------- */
-    if( panFIDIndex != NULL )
-    {
-        if( nFID < 0 || nFID >= nIndexSize )
-            return NULL;
-        else
-            nFID = panFIDIndex[nFID];
-    }
+/************************************************************************/
+/*                              SiftDown()                              */
+/************************************************************************/
 
-/* -------------------------------------------------------------------- */
-/*      Handle request for random record.                               */
-/* -------------------------------------------------------------------- */
-    OGRFeature *poSrcFeature = poSrcLayer->GetFeature( nFID );
-    OGRFeature *poResult;
+void OGRGenSQLSortRuns::SiftDown( int iPos )
 
-    if( poSrcFeature == NULL )
-        return NULL;
+{
+    int nHeapSize = (int) anHeap.size();
 
-    poResult = TranslateFeature( poSrcFeature );
-    poResult->SetFID( nFID );
-    
-    delete poSrcFeature;
+    while( TRUE )
+    {
+        int iFirst = iPos;
+        int iLeft = 2 * iPos + 1;
+        int iRight = iLeft + 1;
+
+        if( iLeft < nHeapSize && Before( anHeap[iLeft], anHeap[iFirst] ) )
+            iFirst = iLeft;
+        if( iRight < nHeapSize && Before( anHeap[iRight], anHeap[iFirst] ) )
+            iFirst = iRight;
+        if( iFirst == iPos )
+            break;
 
-    return poResult;
+        int nTmp = anHeap[iPos];
+        anHeap[iPos] = anHeap[iFirst];
+        anHeap[iFirst] = nTmp;
+        iPos = iFirst;
+    }
 }
 
 /************************************************************************/
-/*                          GetSpatialFilter()                          */
+/*                               Rewind()                               */
 /************************************************************************/
 
-OGRGeometry *OGRGenSQLResultsLayer::GetSpatialFilter() 
+void OGRGenSQLSortRuns::Rewind()
 
 {
-    return NULL;
+    delete poCurFeature;
+    poCurFeature = NULL;
+    nNextIndex = 0;
+
+    anHeap.resize( 0 );
+    for( int iRun = 0; iRun < (int) asRuns.size(); iRun++ )
+    {
+        asRuns[iRun].nOffset = asRuns[iRun].nStart;
+        asRuns[iRun].nBufferPos = 0;
+        asRuns[iRun].nBufferFilled = 0;
+        if( ReadHead( iRun ) )
+            anHeap.push_back( iRun );
+    }
+
+    for( int iPos = (int) anHeap.size() / 2 - 1; iPos >= 0; iPos-- )
+        SiftDown( iPos );
 }
 
 /************************************************************************/
-/*                            GetLayerDefn()                            */
+/*                              GetNext()                               */
+/*                                                                      */
+/*      Returns the next feature in sort order. It remains owned by     */
+/*      this object, and is valid until the next call.                  */
 /************************************************************************/
 
-OGRFeatureDefn *OGRGenSQLResultsLayer::GetLayerDefn()
+OGRFeature *OGRGenSQLSortRuns::GetNext()
 
 {
-    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
-    if( psSelectInfo->query_mode == SWQM_SUMMARY_RECORD &&
-        poSummaryFeature == NULL )
+    delete poCurFeature;
+    poCurFeature = NULL;
+
+    if( anHeap.empty() )
+        return NULL;
+
+    int iRun = anHeap[0];
+    poCurFeature = asRuns[iRun].poFeature;
+    asRuns[iRun].poFeature = NULL;
+
+    if( !ReadHead( iRun ) )
     {
-        // Run PrepareSummary() is we have a COUNT column so as to be
-        // able to downcast it from OFTInteger64 to OFTInteger
-        for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
-        {
-            swq_col_def *psColDef = psSelectInfo->column_defs + iField;
-            if( psColDef->col_func == SWQCF_COUNT )
-            {
-                PrepareSummary();
-                break;
-            }
-        }
+        anHeap[0] = anHeap.back();
+        anHeap.pop_back();
     }
+    if( !anHeap.empty() )
+        SiftDown( 0 );
 
-    return poDefn;
+    nNextIndex ++;
+    return poCurFeature;
 }
 
 /************************************************************************/
@@ -1722,6 +3480,10 @@ OGRFeatureDefn *OGRGenSQLResultsLayer::GetLayerDefn()
 /*                                                                      */
 /*      Keeping all the key values in memory will *not* scale up to     */
 /*      very large input datasets.                                      */
+/*                                                                      */
+/*      Fetching the features back by FID is also very slow on layers   */
+/*      without random access, so for them the features themselves      */
+/*      are sorted, see CreateSortedFeatures().                         */
 /************************************************************************/
 
 void OGRGenSQLResultsLayer::CreateOrderByIndex()
@@ -1745,6 +3507,13 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
 
     ResetReading();
 
+    if( !poSrcLayer->TestCapability( OLCRandomRead ) )
+    {
+        CreateSortedFeatures();
+        ResetReading();
+        return;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Allocate set of key values, and the output index.               */
 /* -------------------------------------------------------------------- */
@@ -1763,8 +3532,6 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
 
     while( (poSrcFeat = poSrcLayer->GetNextFeature()) != NULL )
     {
-        int iKey;
-
         if ((size_t)nIndexSize == nFeaturesAlloc)
         {
             GIntBig nNewFeaturesAlloc = (nFeaturesAlloc * 4) / 3;
@@ -1807,60 +3574,7 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
             nFeaturesAlloc = (size_t)nNewFeaturesAlloc;
         }
 
-        for( iKey = 0; iKey < nOrderItems; iKey++ )
-        {
-            swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
-            OGRFieldDefn *poFDefn;
-            OGRField *psSrcField, *psDstField;
-
-            psDstField = pasIndexFields + nIndexSize * nOrderItems + iKey;
-
-            if ( psKeyDef->field_index >= iFIDFieldIndex)
-            {
-                if ( psKeyDef->field_index < iFIDFieldIndex + SPECIAL_FIELD_COUNT )
-                {
-                    switch (SpecialFieldTypes[psKeyDef->field_index - iFIDFieldIndex])
-                    {
-                      case SWQ_INTEGER:
-                        psDstField->Integer = poSrcFeat->GetFieldAsInteger(psKeyDef->field_index);
-                        break;
-
-                      case SWQ_INTEGER64:
-                        psDstField->Integer64 = poSrcFeat->GetFieldAsInteger64(psKeyDef->field_index);
-                        break;
-
-                      case SWQ_FLOAT:
-                        psDstField->Real = poSrcFeat->GetFieldAsDouble(psKeyDef->field_index);
-                        break;
-
-                      default:
-                        psDstField->String = CPLStrdup( poSrcFeat->GetFieldAsString(psKeyDef->field_index) );
-                        break;
-                    }
-                }
-                continue;
-            }
-            
-            poFDefn = poSrcLayer->GetLayerDefn()->GetFieldDefn( 
-                psKeyDef->field_index );
-
-            psSrcField = poSrcFeat->GetRawFieldRef( psKeyDef->field_index );
-
-            if( poFDefn->GetType() == OFTInteger 
-                || poFDefn->GetType() == OFTInteger64 
-                || poFDefn->GetType() == OFTReal
-                || poFDefn->GetType() == OFTDate
-                || poFDefn->GetType() == OFTTime
-                || poFDefn->GetType() == OFTDateTime)
-                memcpy( psDstField, psSrcField, sizeof(OGRField) );
-            else if( poFDefn->GetType() == OFTString )
-            {
-                if( poSrcFeat->IsFieldSet( psKeyDef->field_index ) )
-                    psDstField->String = CPLStrdup( psSrcField->String );
-                else
-                    memcpy( psDstField, psSrcField, sizeof(OGRField) );
-            }
-        }
+        ExtractOrderByKeys( poSrcFeat, pasIndexFields + nIndexSize * nOrderItems );
 
         panFIDList[nIndexSize] = poSrcFeat->GetFID();
         delete poSrcFeat;
@@ -1888,7 +3602,7 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
 /* -------------------------------------------------------------------- */
 /*      Quick sort the records.                                         */
 /* -------------------------------------------------------------------- */
-    if( !SortIndexSection( pasIndexFields, 0, nIndexSize ) )
+    if( !SortIndexSection( pasIndexFields, panFIDIndex, 0, nIndexSize ) )
     {
         VSIFree(pasIndexFields);
         VSIFree(panFIDList);
@@ -1914,6 +3628,291 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
 /* -------------------------------------------------------------------- */
 /*      Free the key field values.                                      */
 /* -------------------------------------------------------------------- */
+    FreeOrderByKeys( pasIndexFields, nIndexSize );
+    CPLFree( pasIndexFields );
+
+    /* If it is already sorted, then free than panFIDIndex array */
+    /* so that GetNextFeature() can call a sequential GetNextFeature() */
+    /* on the source array. Very useful for layers where random access */
+    /* is slow. */
+    /* Use case: the GML result of a WFS GetFeature with a SORTBY */
+    if (bAlreadySorted)
+    {
+        CPLFree( panFIDIndex );
+        panFIDIndex = NULL;
+
+        nIndexSize = 0;
+    }
+
+    ResetReading();
+}
+
+/************************************************************************/
+/*                        CreateSortedFeatures()                        */
+/*                                                                      */
+/*      ORDER BY for source layers without random access. The source    */
+/*      features are read once and kept in memory, in sort order.       */
+/*      Beyond OGR_SQL_SORT_MAX_MEMORY (in MB), sorted runs of          */
+/*      features are written to a temporary file, and merged when       */
+/*      reading the results.                                            */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::CreateSortedFeatures()
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    int nOrderItems = psSelectInfo->order_specs;
+    double dfMaxMem = CPLAtof(
+        CPLGetConfigOption( "OGR_SQL_SORT_MAX_MEMORY", "100" ) ) * 1024 * 1024;
+    double dfMem = 0;
+    std::vector<OGRFeature*> apoFeatures;
+    OGRFeature *poSrcFeat;
+    size_t i;
+
+    nIndexSize = 0;
+
+    while( (poSrcFeat = poSrcLayer->GetNextFeature()) != NULL )
+    {
+        apoFeatures.push_back( poSrcFeat );
+        dfMem += (double) GetFeatureMemSize( poSrcFeat ) +
+                 sizeof(OGRField) * nOrderItems + sizeof(OGRFeature*);
+        if( dfMem <= dfMaxMem )
+            continue;
+
+/* -------------------------------------------------------------------- */
+/*      Spill a sorted run.                                             */
+/* -------------------------------------------------------------------- */
+        if( poSortRuns == NULL )
+            poSortRuns = new OGRGenSQLSortRuns( this, poSrcLayer->GetLayerDefn() );
+
+        SortFeatures( &apoFeatures[0], apoFeatures.size() );
+        int bOK = poSortRuns->WriteRun( &apoFeatures[0], (int) apoFeatures.size() );
+        nIndexSize += apoFeatures.size();
+
+        for( i = 0; i < apoFeatures.size(); i++ )
+            delete apoFeatures[i];
+        apoFeatures.resize( 0 );
+        dfMem = 0;
+
+        if( !bOK )
+        {
+            delete poSortRuns;
+            poSortRuns = NULL;
+            nIndexSize = 0;
+            return;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Everything fits in memory.                                      */
+/* -------------------------------------------------------------------- */
+    if( poSortRuns == NULL )
+    {
+        nIndexSize = apoFeatures.size();
+        papoSortedFeatures = (OGRFeature **)
+            CPLMalloc( sizeof(OGRFeature*) * (apoFeatures.size() + 1) );
+        for( i = 0; i < apoFeatures.size(); i++ )
+            papoSortedFeatures[i] = apoFeatures[i];
+        SortFeatures( papoSortedFeatures, nIndexSize );
+        return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Otherwise write the last run, and start the merge.              */
+/* -------------------------------------------------------------------- */
+    if( !apoFeatures.empty() )
+    {
+        SortFeatures( &apoFeatures[0], apoFeatures.size() );
+        int bOK = poSortRuns->WriteRun( &apoFeatures[0], (int) apoFeatures.size() );
+        nIndexSize += apoFeatures.size();
+
+        for( i = 0; i < apoFeatures.size(); i++ )
+            delete apoFeatures[i];
+
+        if( !bOK )
+        {
+            delete poSortRuns;
+            poSortRuns = NULL;
+            nIndexSize = 0;
+            return;
+        }
+    }
+
+    CPLDebug( "GenSQL", "ORDER BY on " CPL_FRMT_GIB " features, "
+              "merging %d sorted runs from a temporary file.",
+              nIndexSize, poSortRuns->GetRunCount() );
+
+    poSortRuns->Rewind();
+}
+
+/************************************************************************/
+/*                            SortFeatures()                            */
+/*                                                                      */
+/*      Sort an array of source features in place.                      */
+/************************************************************************/
+
+int OGRGenSQLResultsLayer::SortFeatures( OGRFeature **papoFeatures,
+                                         GIntBig nEntries )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    int nOrderItems = psSelectInfo->order_specs;
+    GIntBig i;
+
+    if( nEntries < 2 )
+        return TRUE;
+
+    OGRField *pasIndexFields = (OGRField *)
+        VSICalloc( sizeof(OGRField) * nOrderItems, (size_t)nEntries );
+    GIntBig *panIndex = (GIntBig *) VSIMalloc( sizeof(GIntBig) * (size_t)nEntries );
+    OGRFeature **papoSorted = (OGRFeature **)
+        VSIMalloc( sizeof(OGRFeature*) * (size_t)nEntries );
+    if( pasIndexFields == NULL || panIndex == NULL || papoSorted == NULL )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Cannot allocate pasIndexFields");
+        VSIFree( pasIndexFields );
+        VSIFree( panIndex );
+        VSIFree( papoSorted );
+        return FALSE;
+    }
+
+    for( i = 0; i < nEntries; i++ )
+    {
+        ExtractOrderByKeys( papoFeatures[i], pasIndexFields + i * nOrderItems );
+        panIndex[i] = i;
+    }
+
+    int bRet = SortIndexSection( pasIndexFields, panIndex, 0, nEntries );
+    if( bRet )
+    {
+        for( i = 0; i < nEntries; i++ )
+            papoSorted[i] = papoFeatures[panIndex[i]];
+        memcpy( papoFeatures, papoSorted, sizeof(OGRFeature*) * (size_t)nEntries );
+    }
+
+    FreeOrderByKeys( pasIndexFields, nEntries );
+    CPLFree( pasIndexFields );
+    CPLFree( panIndex );
+    CPLFree( papoSorted );
+
+    return bRet;
+}
+
+/************************************************************************/
+/*                        GetSortedSrcFeature()                         */
+/*                                                                      */
+/*      Returns the source feature at a given position of the ORDER BY  */
+/*      result built by CreateSortedFeatures(). The feature remains     */
+/*      owned by the layer.                                             */
+/************************************************************************/
+
+OGRFeature *OGRGenSQLResultsLayer::GetSortedSrcFeature( GIntBig nIndex )
+
+{
+    if( nIndex < 0 || nIndex >= nIndexSize )
+        return NULL;
+
+    if( papoSortedFeatures != NULL )
+        return papoSortedFeatures[nIndex];
+
+    if( poSortRuns == NULL )
+        return NULL;
+
+    if( nIndex == poSortRuns->nNextIndex - 1 )
+        return poSortRuns->GetCurFeature();
+
+    if( nIndex < poSortRuns->nNextIndex )
+        poSortRuns->Rewind();
+    while( poSortRuns->nNextIndex < nIndex )
+    {
+        if( poSortRuns->GetNext() == NULL )
+            return NULL;
+    }
+
+    return poSortRuns->GetNext();
+}
+
+/************************************************************************/
+/*                         ExtractOrderByKeys()                         */
+/*                                                                      */
+/*      Capture the ORDER BY fields of a source feature.                */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::ExtractOrderByKeys( OGRFeature *poSrcFeat,
+                                                OGRField *pasKeys )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    int iKey;
+
+    for( iKey = 0; iKey < psSelectInfo->order_specs; iKey++ )
+    {
+        swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
+        OGRFieldDefn *poFDefn;
+        OGRField *psSrcField, *psDstField;
+
+        psDstField = pasKeys + iKey;
+
+        if ( psKeyDef->field_index >= iFIDFieldIndex)
+        {
+            if ( psKeyDef->field_index < iFIDFieldIndex + SPECIAL_FIELD_COUNT )
+            {
+                switch (SpecialFieldTypes[psKeyDef->field_index - iFIDFieldIndex])
+                {
+                  case SWQ_INTEGER:
+                    psDstField->Integer = poSrcFeat->GetFieldAsInteger(psKeyDef->field_index);
+                    break;
+
+                  case SWQ_INTEGER64:
+                    psDstField->Integer64 = poSrcFeat->GetFieldAsInteger64(psKeyDef->field_index);
+                    break;
+
+                  case SWQ_FLOAT:
+                    psDstField->Real = poSrcFeat->GetFieldAsDouble(psKeyDef->field_index);
+                    break;
+
+                  default:
+                    psDstField->String = CPLStrdup( poSrcFeat->GetFieldAsString(psKeyDef->field_index) );
+                    break;
+                }
+            }
+            continue;
+        }
+        
+        poFDefn = poSrcLayer->GetLayerDefn()->GetFieldDefn( 
+            psKeyDef->field_index );
+
+        psSrcField = poSrcFeat->GetRawFieldRef( psKeyDef->field_index );
+
+        if( poFDefn->GetType() == OFTInteger 
+            || poFDefn->GetType() == OFTInteger64 
+            || poFDefn->GetType() == OFTReal
+            || poFDefn->GetType() == OFTDate
+            || poFDefn->GetType() == OFTTime
+            || poFDefn->GetType() == OFTDateTime)
+            memcpy( psDstField, psSrcField, sizeof(OGRField) );
+        else if( poFDefn->GetType() == OFTString )
+        {
+            if( poSrcFeat->IsFieldSet( psKeyDef->field_index ) )
+                psDstField->String = CPLStrdup( psSrcField->String );
+            else
+                memcpy( psDstField, psSrcField, sizeof(OGRField) );
+        }
+    }
+}
+
+/************************************************************************/
+/*                          FreeOrderByKeys()                           */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::FreeOrderByKeys( OGRField *pasIndexFields,
+                                             GIntBig nEntries )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    int nOrderItems = psSelectInfo->order_specs;
+    GIntBig i;
+
     for( int iKey = 0; iKey < nOrderItems; iKey++ )
     {
         swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
@@ -1925,7 +3924,7 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
             /* warning: only special fields of type string should be deallocated */
             if (SpecialFieldTypes[psKeyDef->field_index - iFIDFieldIndex] == SWQ_STRING)
             {
-                for( i = 0; i < nIndexSize; i++ )
+                for( i = 0; i < nEntries; i++ )
                 {
                     OGRField *psField = pasIndexFields + iKey + i * nOrderItems;
                     CPLFree( psField->String );
@@ -1939,7 +3938,7 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
 
         if( poFDefn->GetType() == OFTString )
         {
-            for( i = 0; i < nIndexSize; i++ )
+            for( i = 0; i < nEntries; i++ )
             {
                 OGRField *psField = pasIndexFields + iKey + i * nOrderItems;
                 
@@ -1949,23 +3948,6 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
             }
         }
     }
-
-    CPLFree( pasIndexFields );
-
-    /* If it is already sorted, then free than panFIDIndex array */
-    /* so that GetNextFeature() can call a sequential GetNextFeature() */
-    /* on the source array. Very useful for layers where random access */
-    /* is slow. */
-    /* Use case: the GML result of a WFS GetFeature with a SORTBY */
-    if (bAlreadySorted)
-    {
-        CPLFree( panFIDIndex );
-        panFIDIndex = NULL;
-
-        nIndexSize = 0;
-    }
-
-    ResetReading();
 }
 
 /************************************************************************/
@@ -1974,7 +3956,8 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
 /*      Sort the records in a section of the index.                     */
 /************************************************************************/
 
-int OGRGenSQLResultsLayer::SortIndexSection( OGRField *pasIndexFields, 
+int OGRGenSQLResultsLayer::SortIndexSection( OGRField *pasIndexFields,
+                                              GIntBig *panIndex,
                                               GIntBig nStart, GIntBig nEntries )
 
 {
@@ -1991,8 +3974,8 @@ int OGRGenSQLResultsLayer::SortIndexSection( OGRField *pasIndexFields,
     GIntBig iMerge = 0;
     GIntBig *panMerged;
 
-    if( !SortIndexSection( pasIndexFields, nFirstStart, nFirstGroup ) ||
-        !SortIndexSection( pasIndexFields, nSecondStart, nSecondGroup ) )
+    if( !SortIndexSection( pasIndexFields, panIndex, nFirstStart, nFirstGroup ) ||
+        !SortIndexSection( pasIndexFields, panIndex, nSecondStart, nSecondGroup ) )
         return FALSE;
 
     panMerged = (GIntBig *) VSIMalloc( sizeof(GIntBig) * (size_t)nEntries );
@@ -2012,25 +3995,25 @@ int OGRGenSQLResultsLayer::SortIndexSection( OGRField *pasIndexFields,
             nResult = 1;
         else
             nResult = Compare( pasIndexFields 
-                               + panFIDIndex[nFirstStart] * nOrderItems, 
+                               + panIndex[nFirstStart] * nOrderItems, 
                                pasIndexFields 
-                               + panFIDIndex[nSecondStart] * nOrderItems );
+                               + panIndex[nSecondStart] * nOrderItems );
 
         if( nResult < 0 )
         {
-            panMerged[iMerge++] = panFIDIndex[nSecondStart++];
+            panMerged[iMerge++] = panIndex[nSecondStart++];
             nSecondGroup--;
         }
         else
         {
-            panMerged[iMerge++] = panFIDIndex[nFirstStart++];
+            panMerged[iMerge++] = panIndex[nFirstStart++];
             nFirstGroup--;
         }
     }
 
     /* Copy the merge list back into the main index */
 
-    memcpy( panFIDIndex + nStart, panMerged, sizeof(GIntBig) * (size_t)nEntries );
+    memcpy( panIndex + nStart, panMerged, sizeof(GIntBig) * (size_t)nEntries );
     CPLFree( panMerged );
     
     return TRUE;
@@ -2217,6 +4200,12 @@ void OGRGenSQLResultsLayer::FindAndSetIgnoredFields()
         AddFieldDefnToSet(psOrderDef->table_index, psOrderDef->field_index, hSet);
     }
 
+    for( int iGroup = 0; iGroup < psSelectInfo->group_by_specs; iGroup++ )
+    {
+        swq_group_by_def *psGroupDef = psSelectInfo->group_by_defs + iGroup;
+        AddFieldDefnToSet(psGroupDef->table_index, psGroupDef->field_index, hSet);
+    }
+
 /* -------------------------------------------------------------------- */
 /*      2nd phase : now, we can exclude the unused fields               */
 /* -------------------------------------------------------------------- */
@@ -2252,6 +4241,17 @@ void OGRGenSQLResultsLayer::InvalidateOrderByIndex()
     CPLFree( panFIDIndex );
     panFIDIndex = NULL;
 
+    if( papoSortedFeatures != NULL )
+    {
+        for( GIntBig i = 0; i < nIndexSize; i++ )
+            delete papoSortedFeatures[i];
+        CPLFree( papoSortedFeatures );
+        papoSortedFeatures = NULL;
+    }
+
+    delete poSortRuns;
+    poSortRuns = NULL;
+
     nIndexSize = 0;
     bOrderByValid = FALSE;
 }
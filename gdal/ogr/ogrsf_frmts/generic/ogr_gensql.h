@@ -45,12 +45,17 @@
 #define ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(poFDefn, idx) \
     ((idx) - ((poFDefn)->GetFieldCount() + SPECIAL_FIELD_COUNT))
 
+class OGRGenSQLJoinHash;
+class OGRGenSQLSortRuns;
+
 /************************************************************************/
 /*                        OGRGenSQLResultsLayer                         */
 /************************************************************************/
 
 class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
 {
+    friend class OGRGenSQLSortRuns;
+
   private:
     GDALDataset *poSrcDS;
     OGRLayer    *poSrcLayer;
@@ -63,6 +68,7 @@ class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
     OGRFeatureDefn *poDefn;
 
     int         PrepareSummary();
+    int         PrepareGroups();
     
     int        *panGeomFieldToSrcGeomField;
 
@@ -70,22 +76,50 @@ class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
     GIntBig    *panFIDIndex;
     int         bOrderByValid;
 
+    /* ORDER BY result of source layers without random access : the */
+    /* sorted source features, either in memory or spilled to disk */
+    OGRFeature **papoSortedFeatures;
+    OGRGenSQLSortRuns *poSortRuns;
+
     GIntBig      nNextIndexFID;
     OGRFeature  *poSummaryFeature;
 
+    /* result features of a GROUP BY query */
+    GIntBig      nGroupFeatureCount;
+    OGRFeature **papoGroupFeatures;
+
     int         iFIDFieldIndex;
 
     int         nExtraDSCount;
     GDALDataset **papoExtraDS;
 
+    OGRGenSQLJoinHash **papoJoinHash;
+
+    /* FIDs of the source features selected by the generic attribute */
+    /* indexes of a source layer whose driver does not use them */
+    GDALDataset *poSrcLayerDS;
+    int         bSrcLayerHasGenericIndex;
+    OGRFeatureQuery *poSrcIndexQuery;
+    GIntBig    *panSrcIndexFIDs;
+    GIntBig     iNextSrcIndexFID;
+
     OGRFeature *TranslateFeature( OGRFeature * );
+    OGRGenSQLJoinHash *GetJoinHash( int iJoin );
+    void        ClearJoinHashes();
     void        CreateOrderByIndex();
-    int         SortIndexSection( OGRField *pasIndexFields, 
+    void        CreateSortedFeatures();
+    int         SortFeatures( OGRFeature **papoFeatures, GIntBig nEntries );
+    OGRFeature *GetSortedSrcFeature( GIntBig nIndex );
+    void        ExtractOrderByKeys( OGRFeature *poSrcFeat, OGRField *pasKeys );
+    void        FreeOrderByKeys( OGRField *pasIndexFields, GIntBig nEntries );
+    int         SortIndexSection( OGRField *pasIndexFields, GIntBig *panIndex,
                                   GIntBig nStart, GIntBig nEntries );
     int         Compare( OGRField *pasFirst, OGRField *pasSecond );
 
     void        ClearFilters();
     void        ApplyFiltersToSource();
+    void        OpenSrcLayerGenericIndex();
+    void        ComputeSrcIndexFIDs();
 
     void        FindAndSetIgnoredFields();
     void        ExploreExprForIgnoredFields(swq_expr_node* expr, CPLHashSet* hSet);
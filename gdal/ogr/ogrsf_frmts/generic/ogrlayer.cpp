@@ -34,6 +34,11 @@
 #include "ogr_attrind.h"
 #include "swq.h"
 #include "ograpispy.h"
+#include "cpl_multiproc.h"
+#include "cpl_quad_tree.h"
+
+#include <algorithm>
+#include <vector>
 
 CPL_CVSID("$Id$");
 
@@ -550,6 +555,144 @@ OGRFeatureH OGR_L_GetNextFeature( OGRLayerH hLayer )
     return (OGRFeatureH) ((OGRLayer *)hLayer)->GetNextFeature();
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch, int nMaxFeatures )
+
+{
+    poBatch->Reset();
+
+    if( !ValidateFeatureBatch( poBatch ) )
+        return 0;
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        OGRFeature *poFeature = GetNextFeature();
+        if( poFeature == NULL )
+            break;
+
+        int bOK = poBatch->AddFeature( poFeature );
+        delete poFeature;
+        if( !bOK )
+            break;
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
+/************************************************************************/
+/*                        ValidateFeatureBatch()                        */
+/*                                                                      */
+/*      Check that a batch can receive the features of this layer.      */
+/************************************************************************/
+
+int OGRLayer::ValidateFeatureBatch( OGRFeatureBatch *poBatch )
+
+{
+    OGRFeatureDefn *poDefn = GetLayerDefn();
+
+    if( poBatch->GetDefnRef() != poDefn ||
+        poBatch->GetFieldCount() != poDefn->GetFieldCount() ||
+        poBatch->GetGeomFieldCount() != poDefn->GetGeomFieldCount() )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Feature batch was not created from the current definition "
+                  "of layer %s.", GetName() );
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                     OGR_L_GetNextFeatureBatch()                      */
+/************************************************************************/
+
+int OGR_L_GetNextFeatureBatch( OGRLayerH hLayer, OGRFeatureBatchH hBatch,
+                               int nMaxFeatures )
+
+{
+    VALIDATE_POINTER1( hLayer, "OGR_L_GetNextFeatureBatch", 0 );
+    VALIDATE_POINTER1( hBatch, "OGR_L_GetNextFeatureBatch", 0 );
+
+    return ((OGRLayer *)hLayer)->GetNextFeatureBatch(
+                                    (OGRFeatureBatch *)hBatch, nMaxFeatures );
+}
+
+/************************************************************************/
+/*                       GetNextFeatureInPlace()                        */
+/************************************************************************/
+
+int OGRLayer::GetNextFeatureInPlace( OGRFeature *poFeature )
+
+{
+    OGRFeatureDefn *poDefn = GetLayerDefn();
+
+    if( poFeature->GetDefnRef() != poDefn ||
+        poFeature->GetFieldCount() != poDefn->GetFieldCount() ||
+        poFeature->GetGeomFieldCount() != poDefn->GetGeomFieldCount() )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Feature was not created from the current definition "
+                  "of layer %s.", GetName() );
+        return FALSE;
+    }
+
+    poFeature->EnableStringArena();
+
+    return IGetNextFeatureInPlace( poFeature );
+}
+
+/************************************************************************/
+/*                       IGetNextFeatureInPlace()                       */
+/*                                                                      */
+/*      Default implementation: read a new feature and transfer its     */
+/*      content into the caller's feature.  Drivers that can decode     */
+/*      directly into an existing feature override this.                */
+/************************************************************************/
+
+int OGRLayer::IGetNextFeatureInPlace( OGRFeature *poFeature )
+
+{
+    OGRFeature *poSrcFeature = GetNextFeature();
+
+    poFeature->Reset();
+    if( poSrcFeature == NULL )
+        return FALSE;
+
+    int i;
+    for( i = 0; i < poFeature->GetFieldCount(); i++ )
+    {
+        if( poSrcFeature->IsFieldSet( i ) )
+            poFeature->SetField( i, poSrcFeature->GetRawFieldRef( i ) );
+    }
+    for( i = 0; i < poFeature->GetGeomFieldCount(); i++ )
+        poFeature->SetGeomFieldDirectly( i, poSrcFeature->StealGeometry( i ) );
+
+    poFeature->SetFID( poSrcFeature->GetFID() );
+    if( poSrcFeature->GetStyleString() != NULL )
+        poFeature->SetStyleString( poSrcFeature->GetStyleString() );
+
+    delete poSrcFeature;
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                    OGR_L_GetNextFeatureInPlace()                     */
+/************************************************************************/
+
+int OGR_L_GetNextFeatureInPlace( OGRLayerH hLayer, OGRFeatureH hFeat )
+
+{
+    VALIDATE_POINTER1( hLayer, "OGR_L_GetNextFeatureInPlace", FALSE );
+    VALIDATE_POINTER1( hFeat, "OGR_L_GetNextFeatureInPlace", FALSE );
+
+    return ((OGRLayer *)hLayer)->GetNextFeatureInPlace( (OGRFeature *)hFeat );
+}
+
 /************************************************************************/
 /*                    ConvertNonLinearGeomsIfNecessary()                */
 /************************************************************************/
@@ -1476,6 +1619,12 @@ void OGR_L_ResetReading( OGRLayerH hLayer )
 /*      This is only intended to be called by driver layer              */
 /*      implementations but we don't make it protected so that the      */
 /*      datasources can do it too if that is more appropriate.          */
+/*                                                                      */
+/*      Existing B-tree (.btm) or MapInfo (.idm) indexes are reused.    */
+/*      Otherwise, new indexes use the format selected by the           */
+/*      OGR_ATTR_INDEX_FORMAT configuration option (MAPINFO or BTREE),  */
+/*      except when a .btm filename is passed, which always selects     */
+/*      the B-tree format.                                              */
 /************************************************************************/
 
 OGRErr OGRLayer::InitializeIndexSupport( const char *pszFilename )
@@ -1486,7 +1635,23 @@ OGRErr OGRLayer::InitializeIndexSupport( const char *pszFilename )
     if (m_poAttrIndex != NULL)
         return OGRERR_NONE;
 
-    m_poAttrIndex = OGRCreateDefaultLayerIndex();
+    int bBTree = FALSE;
+    if( !EQUALN(pszFilename, "<OGRMILayerAttrIndex>", 21) )
+    {
+        VSIStatBufL sStat;
+
+        if( EQUAL(CPLGetExtension(pszFilename), "btm")
+            || VSIStatL( CPLResetExtension(pszFilename, "btm"), &sStat ) == 0 )
+            bBTree = TRUE;
+        else if( VSIStatL( CPLResetExtension(pszFilename, "idm"), &sStat ) != 0 )
+            bBTree = EQUAL( CPLGetConfigOption( "OGR_ATTR_INDEX_FORMAT",
+                                                "MAPINFO" ), "BTREE" );
+    }
+
+    if( bBTree )
+        m_poAttrIndex = OGRCreateBTreeLayerIndex();
+    else
+        m_poAttrIndex = OGRCreateDefaultLayerIndex();
 
     eErr = m_poAttrIndex->Initialize( pszFilename, this );
     if( eErr != OGRERR_NONE )
@@ -1929,22 +2094,6 @@ OGRErr set_result_schema(OGRLayer *pLayerResult,
     return ret;
 }
 
-static
-OGRGeometry *set_filter_from(OGRLayer *pLayer, OGRGeometry *pGeometryExistingFilter, OGRFeature *pFeature)
-{
-    OGRGeometry *geom = pFeature->GetGeometryRef();
-    if (!geom) return NULL;
-    if (pGeometryExistingFilter) {
-        if (!geom->Intersects(pGeometryExistingFilter)) return NULL;
-        OGRGeometry *intersection = geom->Intersection(pGeometryExistingFilter);
-        pLayer->SetSpatialFilter(intersection);
-        if (intersection) delete intersection;
-    } else {
-        pLayer->SetSpatialFilter(geom);
-    }
-    return geom;
-}
-
 static OGRGeometry* promote_to_multi(OGRGeometry* poGeom)
 {
     OGRwkbGeometryType eType = wkbFlatten(poGeom->getGeometryType());
@@ -1957,216 +2106,553 @@ static OGRGeometry* promote_to_multi(OGRGeometry* poGeom)
 }
 
 /************************************************************************/
-/*                          Intersection()                              */
+/*                           OGROverlayIndex                            */
+/*                                                                      */
+/*      In-memory copy of the features of a layer, with a quadtree of   */
+/*      their envelopes. The overlay methods read the method layer      */
+/*      once into it, instead of setting a spatial filter on the layer  */
+/*      and reading it again for every input feature.                  */
 /************************************************************************/
-/**
- * \brief Intersection of two layers.
- *
- * The result layer contains features whose geometries represent areas
- * that are common between features in the input layer and in the
- * method layer. The features in the result layer have attributes from
- * both input and method layers. The schema of the result layer can be
- * set by the user or, if it is empty, is initialized to contain all
- * fields in the input and method layers.
- *
- * \note If the schema of the result is set by user and contains
- * fields that have the same name as a field in input and in method
- * layer, then the attribute in the result feature will get the value
- * from the feature of the method layer.
- *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
- *
- * \note This method relies on GEOS support. Do not use unless the
- * GEOS support is compiled in.
- *
- * The recognized list of options is :
- * <ul>
- * <li>SKIP_FAILURES=YES/NO. Set it to YES to go on, even when a
- *     feature could not be inserted.
- * <li>PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons
- *     into MultiPolygons, or LineStrings to MultiLineStrings.
- * <li>INPUT_PREFIX=string. Set a prefix for the field names that
- *     will be created from the fields of the input layer.
- * <li>METHOD_PREFIX=string. Set a prefix for the field names that
- *     will be created from the fields of the method layer.
- * </ul>
- *
- * This method is the same as the C function OGR_L_Intersection().
- *
- * @param pLayerMethod the method layer. Should not be NULL.
- *
- * @param pLayerResult the layer where the features resulting from the
- * operation are inserted. Should not be NULL. See above the note
- * about the schema.
- *
- * @param papszOptions NULL terminated list of options (may be NULL).
- *
- * @param pfnProgress a GDALProgressFunc() compatible callback function for
- * reporting progress or NULL.
- *
- * @param pProgressArg argument to be passed to pfnProgress. May be NULL.
- *
- * @return an error code if there was an error or the execution was
- * interrupted, OGRERR_NONE otherwise.
- *
- * @since OGR 1.10
- */
 
-OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod, 
-                               OGRLayer *pLayerResult, 
-                               char** papszOptions, 
-                               GDALProgressFunc pfnProgress, 
-                               void * pProgressArg )
+typedef struct
 {
-    OGRErr ret = OGRERR_NONE;
-    OGRFeatureDefn *poDefnInput = GetLayerDefn();
-    OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
-    OGRGeometry *pGeometryMethodFilter = NULL;
-    int *mapInput = NULL;
-    int *mapMethod = NULL;
-    OGREnvelope sEnvelopeMethod;
-    GBool bEnvelopeSet;
-    double progress_max = (double) GetFeatureCount(0);
-    double progress_counter = 0;
-    double progress_ticker = 0;
-    int bSkipFailures = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
+    int          iFeature;
+    OGREnvelope  sEnvelope;
+} OGROverlayIndexEntry;
 
-    // check for GEOS
-    if (!OGRGeometryFactory::haveGEOS()) {
-        return OGRERR_UNSUPPORTED_OPERATION;
-    }
+static void OGROverlayIndexEntryGetBounds( const void* hFeature,
+                                           CPLRectObj* pBounds )
+{
+    const OGROverlayIndexEntry* psEntry = (const OGROverlayIndexEntry*) hFeature;
+    pBounds->minx = psEntry->sEnvelope.MinX;
+    pBounds->miny = psEntry->sEnvelope.MinY;
+    pBounds->maxx = psEntry->sEnvelope.MaxX;
+    pBounds->maxy = psEntry->sEnvelope.MaxY;
+}
 
-    // get resources
-    ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
-    if (ret != OGRERR_NONE) goto done;
-    ret = create_field_map(poDefnInput, &mapInput);
-    if (ret != OGRERR_NONE) goto done;
-    ret = create_field_map(poDefnMethod, &mapMethod);
-    if (ret != OGRERR_NONE) goto done;
-    ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
-    if (ret != OGRERR_NONE) goto done;
-    poDefnResult = pLayerResult->GetLayerDefn();
-    bEnvelopeSet = pLayerMethod->GetExtent(&sEnvelopeMethod, 1) == OGRERR_NONE;
+class OGROverlayIndex
+{
+    std::vector<OGRFeature*>            apoFeatures;
+    std::vector<OGROverlayIndexEntry>   asEntries;
+    CPLQuadTree                        *hQuadTree;
 
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
+  public:
+                OGROverlayIndex() : hQuadTree(NULL) {}
+               ~OGROverlayIndex();
 
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
+    void        Build( OGRLayer* poLayer );
+    int         GetFeatureCount() const { return (int)apoFeatures.size(); }
+    OGRFeature *GetFeature( int i ) const { return apoFeatures[i]; }
+    void        Search( const OGRGeometry* poGeom,
+                        std::vector<int>& anFeatures ) const;
+};
 
-        // is it worth to proceed?
-        if (bEnvelopeSet) {
-            OGRGeometry *x_geom = x->GetGeometryRef();
-            if (x_geom) {
-                OGREnvelope x_env;
-                x_geom->getEnvelope(&x_env);
-                if (x_env.MaxX < sEnvelopeMethod.MinX 
-                    || x_env.MaxY < sEnvelopeMethod.MinY
-                    || sEnvelopeMethod.MaxX < x_env.MinX
-                    || sEnvelopeMethod.MaxY < x_env.MinY) {
-                    delete x;
-                    continue;
-                }
-            } else {
-                delete x;
-                continue;
-            }
-        }
+OGROverlayIndex::~OGROverlayIndex()
+{
+    if( hQuadTree != NULL )
+        CPLQuadTreeDestroy( hQuadTree );
+    for( size_t i = 0; i < apoFeatures.size(); i++ )
+        delete apoFeatures[i];
+}
 
-        // set up the filter for method layer
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (!x_geom) {
-            delete x;
-            continue;
-        }
+/* Reads all the features of the layer, honouring its current filters. */
+void OGROverlayIndex::Build( OGRLayer* poLayer )
+{
+    OGRFeature* poFeature;
+    CPLRectObj sGlobalBounds;
 
-        pLayerMethod->ResetReading();
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            OGRGeometry* poIntersection = x_geom->Intersection(y_geom);
-            if( poIntersection == NULL || poIntersection->IsEmpty() ||
-                (x_geom->getDimension() == 2 &&
-                y_geom->getDimension() == 2 &&
-                poIntersection->getDimension() < 2) )
+    sGlobalBounds.minx = sGlobalBounds.miny = 0;
+    sGlobalBounds.maxx = sGlobalBounds.maxy = 0;
+
+    poLayer->ResetReading();
+    while( (poFeature = poLayer->GetNextFeature()) != NULL )
+    {
+        OGRGeometry* poGeom = poFeature->GetGeometryRef();
+        if( poGeom != NULL && !poGeom->IsEmpty() )
+        {
+            OGROverlayIndexEntry sEntry;
+            sEntry.iFeature = (int)apoFeatures.size();
+            poGeom->getEnvelope( &sEntry.sEnvelope );
+            if( asEntries.size() == 0 )
             {
-                delete poIntersection;
-                delete y;
+                sGlobalBounds.minx = sEntry.sEnvelope.MinX;
+                sGlobalBounds.miny = sEntry.sEnvelope.MinY;
+                sGlobalBounds.maxx = sEntry.sEnvelope.MaxX;
+                sGlobalBounds.maxy = sEntry.sEnvelope.MaxY;
             }
             else
             {
-                OGRFeature *z = new OGRFeature(poDefnResult);
-                z->SetFieldsFrom(x, mapInput);
-                z->SetFieldsFrom(y, mapMethod);
-                if( bPromoteToMulti )
-                    poIntersection = promote_to_multi(poIntersection);
-                z->SetGeometryDirectly(poIntersection);
-                delete y;
-                ret = pLayerResult->CreateFeature(z);
-                delete z;
-                if (ret != OGRERR_NONE) {
-                    if (!bSkipFailures) {
-                        delete x; 
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                    }
-                }
+                sGlobalBounds.minx = MIN(sGlobalBounds.minx, sEntry.sEnvelope.MinX);
+                sGlobalBounds.miny = MIN(sGlobalBounds.miny, sEntry.sEnvelope.MinY);
+                sGlobalBounds.maxx = MAX(sGlobalBounds.maxx, sEntry.sEnvelope.MaxX);
+                sGlobalBounds.maxy = MAX(sGlobalBounds.maxy, sEntry.sEnvelope.MaxY);
             }
+            asEntries.push_back( sEntry );
         }
+        apoFeatures.push_back( poFeature );
+    }
+
+    /* asEntries does not grow anymore, so its items can be referenced. */
+    hQuadTree = CPLQuadTreeCreate( &sGlobalBounds,
+                                   OGROverlayIndexEntryGetBounds );
+    CPLQuadTreeSetMaxDepth( hQuadTree,
+            CPLQuadTreeGetAdvisedMaxDepth( (int)asEntries.size() ) );
+    for( size_t i = 0; i < asEntries.size(); i++ )
+        CPLQuadTreeInsert( hQuadTree, &asEntries[i] );
+}
+
+/* Returns, in reading order, the features whose envelope intersects    */
+/* the one of poGeom. Safe to call from several threads.                */
+void OGROverlayIndex::Search( const OGRGeometry* poGeom,
+                              std::vector<int>& anFeatures ) const
+{
+    OGREnvelope sEnvelope;
+    CPLRectObj sAoi;
+    int nCount = 0;
+
+    poGeom->getEnvelope( &sEnvelope );
+    sAoi.minx = sEnvelope.MinX;
+    sAoi.miny = sEnvelope.MinY;
+    sAoi.maxx = sEnvelope.MaxX;
+    sAoi.maxy = sEnvelope.MaxY;
+
+    void** phEntries = CPLQuadTreeSearch( hQuadTree, &sAoi, &nCount );
+    for( int i = 0; i < nCount; i++ )
+        anFeatures.push_back( ((OGROverlayIndexEntry*)phEntries[i])->iFeature );
+    CPLFree( phEntries );
+
+    std::sort( anFeatures.begin(), anFeatures.end() );
+}
+
+/************************************************************************/
+/*                      Overlay processing engine                       */
+/*                                                                      */
+/*      Each processed feature is matched against the features of an    */
+/*      OGROverlayIndex. The geometric work is done by a set of worker   */
+/*      threads on batches of features, and the resulting features are  */
+/*      created in the result layer by the calling thread, in the order  */
+/*      of the processed features.                                      */
+/************************************************************************/
+
+typedef enum
+{
+    OVERLAY_INTERSECTION,   /* x intersection y, for each y */
+    OVERLAY_IDENTITY,       /* same, plus x minus all the y */
+    OVERLAY_DIFFERENCE,     /* x minus all the y */
+    OVERLAY_CLIP,           /* x intersection union of the y */
+    OVERLAY_ERASE,          /* x minus union of the y */
+    OVERLAY_COPY            /* x itself */
+} OGROverlayOperation;
+
+typedef struct
+{
+    OGROverlayOperation eOperation;
+    OGRFeatureDefn     *poDefnResult;
+    int                *mapProcessed;   /* field map of the processed features */
+    int                *mapCandidate;   /* field map of the indexed features */
+    OGRGeometry        *poCandidateFilter; /* spatial filter of the indexed layer */
+    OGROverlayIndex    *poIndex;
+    int                 bPromoteToMulti;
+    int                 bUsePreparedGeometries;
+    int                 nThreads;
+} OGROverlayContext;
+
+typedef struct
+{
+    OGRGeometry *poGeom;
+    int          iCandidate;    /* feature of the index, or -1 */
+} OGROverlayResult;
+
+typedef struct
+{
+    OGRFeature                     *poFeature;
+    int                             bOwned;
+    std::vector<OGROverlayResult>   asResults;
+} OGROverlayJob;
+
+static void init_overlay_context( OGROverlayContext *psCtxt,
+                                  OGROverlayOperation eOperation,
+                                  OGRFeatureDefn *poDefnResult,
+                                  int *mapProcessed,
+                                  int *mapCandidate,
+                                  OGRGeometry *poCandidateFilter,
+                                  OGROverlayIndex *poIndex,
+                                  char** papszOptions )
+{
+    psCtxt->eOperation = eOperation;
+    psCtxt->poDefnResult = poDefnResult;
+    psCtxt->mapProcessed = mapProcessed;
+    psCtxt->mapCandidate = mapCandidate;
+    psCtxt->poCandidateFilter = poCandidateFilter;
+    psCtxt->poIndex = poIndex;
+    psCtxt->bPromoteToMulti = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
+    psCtxt->bUsePreparedGeometries = OGRHasPreparedGeometrySupport() &&
+        CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES"));
+
+    const char* pszThreads = CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if( pszThreads == NULL )
+        pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    if( EQUAL(pszThreads, "ALL_CPUS") )
+        psCtxt->nThreads = CPLGetNumCPUs();
+    else
+        psCtxt->nThreads = atoi(pszThreads);
+    if( psCtxt->nThreads < 1 )
+        psCtxt->nThreads = 1;
+    else if( psCtxt->nThreads > 128 )
+        psCtxt->nThreads = 128;
+}
+
+static void add_overlay_result( const OGROverlayContext *psCtxt,
+                                OGROverlayJob *psJob,
+                                OGRGeometry *poGeom, int iCandidate )
+{
+    OGROverlayResult sResult;
+    if( psCtxt->bPromoteToMulti )
+        poGeom = promote_to_multi(poGeom);
+    sResult.poGeom = poGeom;
+    sResult.iCandidate = iCandidate;
+    psJob->asResults.push_back(sResult);
+}
+
+/* Collects the indexed features that intersect x_geom, restricted to   */
+/* the spatial filter of the indexed layer, as a spatial filter set on  */
+/* that layer would do. Returns FALSE if x_geom is outside the filter.  */
+static int get_overlay_candidates( const OGROverlayContext *psCtxt,
+                                   const OGRGeometry *x_geom,
+                                   std::vector<int>& anCandidates )
+{
+    const OGRGeometry *poQuery = x_geom;
+    OGRGeometry *poQueryOwned = NULL;
 
-        delete x;
+    if( psCtxt->poCandidateFilter != NULL )
+    {
+        if( !x_geom->Intersects(psCtxt->poCandidateFilter) )
+            return FALSE;
+        poQueryOwned = x_geom->Intersection(psCtxt->poCandidateFilter);
+        if( poQueryOwned != NULL )
+            poQuery = poQueryOwned;
     }
-    if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
-      CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-      ret = OGRERR_FAILURE;
-      goto done;
+
+    std::vector<int> anEnvelopeCandidates;
+    psCtxt->poIndex->Search(poQuery, anEnvelopeCandidates);
+
+    OGRPreparedGeometry *poPreparedQuery = NULL;
+    if( psCtxt->bUsePreparedGeometries && anEnvelopeCandidates.size() > 1 )
+        poPreparedQuery = OGRCreatePreparedGeometry(poQuery);
+
+    for( size_t i = 0; i < anEnvelopeCandidates.size(); i++ )
+    {
+        OGRGeometry *y_geom =
+            psCtxt->poIndex->GetFeature(anEnvelopeCandidates[i])->GetGeometryRef();
+        int bIntersects = (poPreparedQuery != NULL) ?
+            OGRPreparedGeometryIntersects(poPreparedQuery, y_geom) :
+            poQuery->Intersects(y_geom);
+        if( bIntersects )
+            anCandidates.push_back(anEnvelopeCandidates[i]);
     }
-done:
-    // release resources
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
-    if (pGeometryMethodFilter) delete pGeometryMethodFilter;
-    if (mapInput) VSIFree(mapInput);
-    if (mapMethod) VSIFree(mapMethod);
-    return ret;
+
+    OGRDestroyPreparedGeometry(poPreparedQuery);
+    delete poQueryOwned;
+    return TRUE;
 }
 
-/************************************************************************/
-/*                       OGR_L_Intersection()                           */
-/************************************************************************/
-/**
- * \brief Intersection of two layers.
- *
- * The result layer contains features whose geometries represent areas
- * that are common between features in the input layer and in the
- * method layer. The features in the result layer have attributes from
- * both input and method layers. The schema of the result layer can be
- * set by the user or, if it is empty, is initialized to contain all
- * fields in the input and method layers.
- *
- * \note If the schema of the result is set by user and contains
- * fields that have the same name as a field in input and in method
- * layer, then the attribute in the result feature will get the value
- * from the feature of the method layer.
- *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
- *
- * \note This method relies on GEOS support. Do not use unless the
+/* Computes the result geometries of one processed feature. Only reads  */
+/* the shared features, so that it can run in worker threads.           */
+static void process_overlay_job( const OGROverlayContext *psCtxt,
+                                 OGROverlayJob *psJob )
+{
+    OGRGeometry *x_geom = psJob->poFeature->GetGeometryRef();
+    if( !x_geom )
+        return;
+
+    if( psCtxt->eOperation == OVERLAY_COPY )
+    {
+        add_overlay_result(psCtxt, psJob, x_geom->clone(), -1);
+        return;
+    }
+
+    std::vector<int> anCandidates;
+    if( !get_overlay_candidates(psCtxt, x_geom, anCandidates) )
+        return;
+
+    switch( psCtxt->eOperation )
+    {
+        case OVERLAY_INTERSECTION:
+        case OVERLAY_IDENTITY:
+        {
+            // this will be the geometry of the identity result feature
+            OGRGeometry *x_geom_diff = NULL;
+            if( psCtxt->eOperation == OVERLAY_IDENTITY )
+                x_geom_diff = x_geom->clone();
+            for( size_t i = 0; i < anCandidates.size(); i++ )
+            {
+                OGRGeometry *y_geom =
+                    psCtxt->poIndex->GetFeature(anCandidates[i])->GetGeometryRef();
+                OGRGeometry* poIntersection = x_geom->Intersection(y_geom);
+                if( poIntersection == NULL || poIntersection->IsEmpty() ||
+                    (x_geom->getDimension() == 2 &&
+                    y_geom->getDimension() == 2 &&
+                    poIntersection->getDimension() < 2) )
+                {
+                    delete poIntersection;
+                    continue;
+                }
+                add_overlay_result(psCtxt, psJob, poIntersection, anCandidates[i]);
+                if( psCtxt->eOperation == OVERLAY_IDENTITY )
+                {
+                    OGRGeometry *x_geom_diff_new = x_geom_diff ? x_geom_diff->Difference(y_geom) : NULL;
+                    delete x_geom_diff;
+                    x_geom_diff = x_geom_diff_new;
+                }
+            }
+            if( psCtxt->eOperation == OVERLAY_IDENTITY )
+            {
+                if( x_geom_diff == NULL || x_geom_diff->IsEmpty() )
+                    delete x_geom_diff;
+                else
+                    add_overlay_result(psCtxt, psJob, x_geom_diff, -1);
+            }
+            break;
+        }
+
+        case OVERLAY_DIFFERENCE:
+        {
+            OGRGeometry *geom = x_geom->clone();
+            for( size_t i = 0; i < anCandidates.size(); i++ )
+            {
+                OGRGeometry *y_geom =
+                    psCtxt->poIndex->GetFeature(anCandidates[i])->GetGeometryRef();
+                OGRGeometry *geom_new = geom->Difference(y_geom);
+                delete geom;
+                geom = geom_new;
+                if (geom == NULL || geom->IsEmpty()) break;
+            }
+            if( geom == NULL || geom->IsEmpty() )
+                delete geom;
+            else
+                add_overlay_result(psCtxt, psJob, geom, -1);
+            break;
+        }
+
+        case OVERLAY_CLIP:
+        case OVERLAY_ERASE:
+        {
+            // incrementally add area from y to geom
+            OGRGeometry *geom = NULL;
+            for( size_t i = 0; i < anCandidates.size(); i++ )
+            {
+                OGRGeometry *y_geom =
+                    psCtxt->poIndex->GetFeature(anCandidates[i])->GetGeometryRef();
+                if (!geom) {
+                    geom = y_geom->clone();
+                } else {
+                    OGRGeometry *geom_new = geom->Union(y_geom);
+                    delete geom;
+                    geom = geom_new;
+                    if (!geom) break;
+                }
+            }
+            if( geom )
+            {
+                OGRGeometry *poResult = (psCtxt->eOperation == OVERLAY_CLIP) ?
+                    x_geom->Intersection(geom) : x_geom->Difference(geom);
+                if( poResult == NULL || poResult->IsEmpty() )
+                    delete poResult;
+                else
+                    add_overlay_result(psCtxt, psJob, poResult, -1);
+                delete geom;
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+typedef struct
+{
+    const OGROverlayContext    *psCtxt;
+    std::vector<OGROverlayJob> *pasJobs;
+    CPLMutex                   *hMutex;
+    size_t                      iNextJob;
+} OGROverlayWorkerData;
+
+static void overlay_worker( void *pData )
+{
+    OGROverlayWorkerData *psData = (OGROverlayWorkerData *) pData;
+    while( TRUE )
+    {
+        CPLAcquireMutex(psData->hMutex, 1000.0);
+        size_t iJob = psData->iNextJob ++;
+        CPLReleaseMutex(psData->hMutex);
+        if( iJob >= psData->pasJobs->size() )
+            break;
+        process_overlay_job(psData->psCtxt, &(*psData->pasJobs)[iJob]);
+    }
+}
+
+static void process_overlay_jobs( const OGROverlayContext *psCtxt,
+                                  std::vector<OGROverlayJob>& asJobs )
+{
+    int nThreads = MIN(psCtxt->nThreads, (int)asJobs.size());
+    if( nThreads <= 1 )
+    {
+        for( size_t i = 0; i < asJobs.size(); i++ )
+            process_overlay_job(psCtxt, &asJobs[i]);
+        return;
+    }
+
+    OGROverlayWorkerData sData;
+    sData.psCtxt = psCtxt;
+    sData.pasJobs = &asJobs;
+    sData.hMutex = CPLCreateMutex();
+    sData.iNextJob = 0;
+    CPLReleaseMutex(sData.hMutex);
+
+    // the calling thread is one of the workers
+    std::vector<CPLJoinableThread*> ahThreads;
+    for( int i = 1; i < nThreads; i++ )
+    {
+        CPLJoinableThread* hThread = CPLCreateJoinableThread(overlay_worker, &sData);
+        if( hThread != NULL )
+            ahThreads.push_back(hThread);
+    }
+    overlay_worker(&sData);
+    for( size_t i = 0; i < ahThreads.size(); i++ )
+        CPLJoinThread(ahThreads[i]);
+
+    CPLDestroyMutex(sData.hMutex);
+}
+
+static void free_overlay_jobs( std::vector<OGROverlayJob>& asJobs )
+{
+    for( size_t i = 0; i < asJobs.size(); i++ )
+    {
+        for( size_t j = 0; j < asJobs[i].asResults.size(); j++ )
+            delete asJobs[i].asResults[j].poGeom;
+        if( asJobs[i].bOwned )
+            delete asJobs[i].poFeature;
+    }
+    asJobs.resize(0);
+}
+
+/* Processes all the features of poSrcLayer, or of poSrcIndex if        */
+/* poSrcLayer is NULL, and creates the result features.                 */
+static OGRErr run_overlay( const OGROverlayContext *psCtxt,
+                           OGRLayer *poSrcLayer,
+                           OGROverlayIndex *poSrcIndex,
+                           OGRLayer *pLayerResult,
+                           int bSkipFailures,
+                           GDALProgressFunc pfnProgress,
+                           void * pProgressArg,
+                           double *pprogress_counter,
+                           double progress_max )
+{
+    OGRErr ret = OGRERR_NONE;
+    const size_t nBatchSize = (psCtxt->nThreads > 1) ? 64 * psCtxt->nThreads : 1;
+    std::vector<OGROverlayJob> asJobs;
+    int iNextSrcFeature = 0;
+    int bEOF = FALSE;
+
+    if( poSrcLayer != NULL )
+        poSrcLayer->ResetReading();
+
+    while( !bEOF )
+    {
+        // read a batch of features
+        while( asJobs.size() < nBatchSize )
+        {
+            OGROverlayJob sJob;
+            if( poSrcLayer != NULL )
+            {
+                sJob.poFeature = poSrcLayer->GetNextFeature();
+                sJob.bOwned = TRUE;
+            }
+            else
+            {
+                sJob.poFeature = (iNextSrcFeature < poSrcIndex->GetFeatureCount()) ?
+                    poSrcIndex->GetFeature(iNextSrcFeature++) : NULL;
+                sJob.bOwned = FALSE;
+            }
+            if( sJob.poFeature == NULL )
+            {
+                bEOF = TRUE;
+                break;
+            }
+            asJobs.push_back(sJob);
+        }
+
+        process_overlay_jobs(psCtxt, asJobs);
+
+        // create the result features, in order
+        for( size_t i = 0; i < asJobs.size(); i++ )
+        {
+            OGROverlayJob *psJob = &asJobs[i];
+
+            if (pfnProgress) {
+                double p = *pprogress_counter/progress_max;
+                if (!pfnProgress(p, "", pProgressArg)) {
+                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+                    free_overlay_jobs(asJobs);
+                    return OGRERR_FAILURE;
+                }
+                *pprogress_counter += 1.0;
+            }
+
+            for( size_t j = 0; j < psJob->asResults.size(); j++ )
+            {
+                OGRFeature *z = new OGRFeature(psCtxt->poDefnResult);
+                if (psCtxt->mapProcessed)
+                    z->SetFieldsFrom(psJob->poFeature, psCtxt->mapProcessed);
+                if (psJob->asResults[j].iCandidate >= 0 && psCtxt->mapCandidate)
+                    z->SetFieldsFrom(psCtxt->poIndex->GetFeature(psJob->asResults[j].iCandidate),
+                                     psCtxt->mapCandidate);
+                z->SetGeometryDirectly(psJob->asResults[j].poGeom);
+                psJob->asResults[j].poGeom = NULL;
+                ret = pLayerResult->CreateFeature(z);
+                delete z;
+                if (ret != OGRERR_NONE) {
+                    if (!bSkipFailures) {
+                        free_overlay_jobs(asJobs);
+                        return ret;
+                    } else {
+                        CPLErrorReset();
+                        ret = OGRERR_NONE;
+                    }
+                }
+            }
+        }
+
+        free_overlay_jobs(asJobs);
+    }
+
+    return ret;
+}
+
+/************************************************************************/
+/*                          Intersection()                              */
+/************************************************************************/
+/**
+ * \brief Intersection of two layers.
+ *
+ * The result layer contains features whose geometries represent areas
+ * that are common between features in the input layer and in the
+ * method layer. The features in the result layer have attributes from
+ * both input and method layers. The schema of the result layer can be
+ * set by the user or, if it is empty, is initialized to contain all
+ * fields in the input and method layers.
+ *
+ * \note If the schema of the result is set by user and contains
+ * fields that have the same name as a field in input and in method
+ * layer, then the attribute in the result feature will get the value
+ * from the feature of the method layer.
+ *
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
+ *
+ * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
  *
  * The recognized list of options is :
@@ -2179,6 +2665,132 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
+ * </ul>
+ *
+ * This method is the same as the C function OGR_L_Intersection().
+ *
+ * @param pLayerMethod the method layer. Should not be NULL.
+ *
+ * @param pLayerResult the layer where the features resulting from the
+ * operation are inserted. Should not be NULL. See above the note
+ * about the schema.
+ *
+ * @param papszOptions NULL terminated list of options (may be NULL).
+ *
+ * @param pfnProgress a GDALProgressFunc() compatible callback function for
+ * reporting progress or NULL.
+ *
+ * @param pProgressArg argument to be passed to pfnProgress. May be NULL.
+ *
+ * @return an error code if there was an error or the execution was
+ * interrupted, OGRERR_NONE otherwise.
+ *
+ * @since OGR 1.10
+ */
+
+OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod, 
+                               OGRLayer *pLayerResult, 
+                               char** papszOptions, 
+                               GDALProgressFunc pfnProgress, 
+                               void * pProgressArg )
+{
+    OGRErr ret = OGRERR_NONE;
+    OGRFeatureDefn *poDefnInput = GetLayerDefn();
+    OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
+    OGRGeometry *pGeometryMethodFilter = NULL;
+    int *mapInput = NULL;
+    int *mapMethod = NULL;
+    OGROverlayIndex oMethodIndex;
+    OGROverlayContext sContext;
+    double progress_max = (double) GetFeatureCount(0);
+    double progress_counter = 0;
+    int bSkipFailures = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
+
+    // check for GEOS
+    if (!OGRGeometryFactory::haveGEOS()) {
+        return OGRERR_UNSUPPORTED_OPERATION;
+    }
+
+    // get resources
+    ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
+    if (ret != OGRERR_NONE) goto done;
+    ret = create_field_map(poDefnInput, &mapInput);
+    if (ret != OGRERR_NONE) goto done;
+    ret = create_field_map(poDefnMethod, &mapMethod);
+    if (ret != OGRERR_NONE) goto done;
+    ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
+    if (ret != OGRERR_NONE) goto done;
+
+    // index the method layer once
+    oMethodIndex.Build(pLayerMethod);
+
+    init_overlay_context(&sContext, OVERLAY_INTERSECTION, pLayerResult->GetLayerDefn(),
+                         mapInput, mapMethod, pGeometryMethodFilter, &oMethodIndex,
+                         papszOptions);
+    ret = run_overlay(&sContext, this, NULL, pLayerResult, bSkipFailures,
+                      pfnProgress, pProgressArg, &progress_counter, progress_max);
+    if (ret != OGRERR_NONE) goto done;
+
+    if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
+      CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+      ret = OGRERR_FAILURE;
+      goto done;
+    }
+done:
+    // release resources
+    if (pGeometryMethodFilter) delete pGeometryMethodFilter;
+    if (mapInput) VSIFree(mapInput);
+    if (mapMethod) VSIFree(mapMethod);
+    return ret;
+}
+
+/************************************************************************/
+/*                       OGR_L_Intersection()                           */
+/************************************************************************/
+/**
+ * \brief Intersection of two layers.
+ *
+ * The result layer contains features whose geometries represent areas
+ * that are common between features in the input layer and in the
+ * method layer. The features in the result layer have attributes from
+ * both input and method layers. The schema of the result layer can be
+ * set by the user or, if it is empty, is initialized to contain all
+ * fields in the input and method layers.
+ *
+ * \note If the schema of the result is set by user and contains
+ * fields that have the same name as a field in input and in method
+ * layer, then the attribute in the result feature will get the value
+ * from the feature of the method layer.
+ *
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
+ *
+ * \note This method relies on GEOS support. Do not use unless the
+ * GEOS support is compiled in.
+ *
+ * The recognized list of options is :
+ * <ul>
+ * <li>SKIP_FAILURES=YES/NO. Set it to YES to go on, even when a
+ *     feature could not be inserted.
+ * <li>PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons
+ *     into MultiPolygons, or LineStrings to MultiLineStrings.
+ * <li>INPUT_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the input layer.
+ * <li>METHOD_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Intersection().
@@ -2240,8 +2852,9 @@ OGRErr OGR_L_Intersection( OGRLayerH pLayerInput,
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -2256,6 +2869,12 @@ OGRErr OGR_L_Intersection( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Union().
@@ -2288,16 +2907,16 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
     OGRErr ret = OGRERR_NONE;
     OGRFeatureDefn *poDefnInput = GetLayerDefn();
     OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
     OGRGeometry *pGeometryMethodFilter = NULL;
     OGRGeometry *pGeometryInputFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGROverlayIndex oMethodIndex;
+    OGROverlayIndex oInputIndex;
+    OGROverlayContext sContext;
     double progress_max = (double) GetFeatureCount(0) + (double) pLayerMethod->GetFeatureCount(0);
     double progress_counter = 0;
-    double progress_ticker = 0;
     int bSkipFailures = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -2315,161 +2934,27 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
     if (ret != OGRERR_NONE) goto done;
     ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
     if (ret != OGRERR_NONE) goto done;
-    poDefnResult = pLayerResult->GetLayerDefn();
-
-    // add features based on input layer
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
-
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
-
-        // set up the filter on method layer
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (!x_geom) {
-            delete x; 
-            continue;
-        }
-        
-        OGRGeometry *x_geom_diff = x_geom->clone(); // this will be the geometry of the result feature
-        pLayerMethod->ResetReading();
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            OGRGeometry *poIntersection = x_geom->Intersection(y_geom);
-            if( poIntersection == NULL || poIntersection->IsEmpty() ||
-                (x_geom->getDimension() == 2 &&
-                y_geom->getDimension() == 2 &&
-                poIntersection->getDimension() < 2) )
-            {
-                delete poIntersection;
-                delete y;
-            }
-            else
-            {
-                OGRFeature *z = new OGRFeature(poDefnResult);
-                z->SetFieldsFrom(x, mapInput);
-                z->SetFieldsFrom(y, mapMethod);
-                if( bPromoteToMulti )
-                    poIntersection = promote_to_multi(poIntersection);
-                z->SetGeometryDirectly(poIntersection);
-                OGRGeometry *x_geom_diff_new = x_geom_diff ? x_geom_diff->Difference(y_geom) : NULL;
-                if (x_geom_diff) delete x_geom_diff;
-                x_geom_diff = x_geom_diff_new;
-                delete y;
-                ret = pLayerResult->CreateFeature(z);
-                delete z;
-                if (ret != OGRERR_NONE) {
-                    if (!bSkipFailures) {
-                        delete x;
-                        if (x_geom_diff)
-                            delete x_geom_diff;
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                    }
-                }
-            }
-        }
-
-        if( x_geom_diff == NULL || x_geom_diff->IsEmpty() )
-        {
-            delete x_geom_diff;
-            delete x;
-        }
-        else
-        {
-            OGRFeature *z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapInput);
-            if( bPromoteToMulti )
-                x_geom_diff = promote_to_multi(x_geom_diff);
-            z->SetGeometryDirectly(x_geom_diff);
-            delete x;
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
 
-    // restore filter on method layer and add features based on it
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
-    pLayerMethod->ResetReading();
-    while (OGRFeature *x = pLayerMethod->GetNextFeature()) {
+    // index both layers once
+    oMethodIndex.Build(pLayerMethod);
+    oInputIndex.Build(this);
 
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
+    // add features based on input layer
+    init_overlay_context(&sContext, OVERLAY_IDENTITY, pLayerResult->GetLayerDefn(),
+                         mapInput, mapMethod, pGeometryMethodFilter, &oMethodIndex,
+                         papszOptions);
+    ret = run_overlay(&sContext, NULL, &oInputIndex, pLayerResult, bSkipFailures,
+                      pfnProgress, pProgressArg, &progress_counter, progress_max);
+    if (ret != OGRERR_NONE) goto done;
 
-        // set up the filter on input layer
-        OGRGeometry *x_geom = set_filter_from(this, pGeometryInputFilter, x);
-        if (!x_geom) {
-            delete x; 
-            continue;
-        }
-        
-        OGRGeometry *x_geom_diff = x_geom->clone(); // this will be the geometry of the result feature
-        ResetReading();
-        while (OGRFeature *y = GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            OGRGeometry *x_geom_diff_new = x_geom_diff ? x_geom_diff->Difference(y_geom) : NULL;
-            if (x_geom_diff) delete x_geom_diff;
-            x_geom_diff = x_geom_diff_new;
-            delete y;
-        }
+    // add features based on method layer
+    init_overlay_context(&sContext, OVERLAY_DIFFERENCE, pLayerResult->GetLayerDefn(),
+                         mapMethod, NULL, pGeometryInputFilter, &oInputIndex,
+                         papszOptions);
+    ret = run_overlay(&sContext, NULL, &oMethodIndex, pLayerResult, bSkipFailures,
+                      pfnProgress, pProgressArg, &progress_counter, progress_max);
+    if (ret != OGRERR_NONE) goto done;
 
-        if( x_geom_diff == NULL || x_geom_diff->IsEmpty() )
-        {
-            delete x_geom_diff;
-            delete x;
-        }
-        else
-        {
-            OGRFeature *z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapMethod);
-            if( bPromoteToMulti )
-                x_geom_diff = promote_to_multi(x_geom_diff);
-            z->SetGeometryDirectly(x_geom_diff);
-            delete x;
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
@@ -2477,8 +2962,6 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
     }
 done:
     // release resources
-    SetSpatialFilter(pGeometryInputFilter);
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     if (pGeometryMethodFilter) delete pGeometryMethodFilter;
     if (pGeometryInputFilter) delete pGeometryInputFilter;
     if (mapInput) VSIFree(mapInput);
@@ -2507,8 +2990,9 @@ done:
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -2523,6 +3007,12 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Union().
@@ -2584,8 +3074,9 @@ OGRErr OGR_L_Union( OGRLayerH pLayerInput,
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -2600,6 +3091,12 @@ OGRErr OGR_L_Union( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This method is the same as the C function OGR_L_SymDifference().
@@ -2632,16 +3129,16 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
     OGRErr ret = OGRERR_NONE;
     OGRFeatureDefn *poDefnInput = GetLayerDefn();
     OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
     OGRGeometry *pGeometryMethodFilter = NULL;
     OGRGeometry *pGeometryInputFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGROverlayIndex oMethodIndex;
+    OGROverlayIndex oInputIndex;
+    OGROverlayContext sContext;
     double progress_max = (double) GetFeatureCount(0) + (double) pLayerMethod->GetFeatureCount(0);
     double progress_counter = 0;
-    double progress_ticker = 0;
     int bSkipFailures = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -2659,130 +3156,27 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
     if (ret != OGRERR_NONE) goto done;
     ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
     if (ret != OGRERR_NONE) goto done;
-    poDefnResult = pLayerResult->GetLayerDefn();
 
-    // add features based on input layer
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
+    // index both layers once
+    oMethodIndex.Build(pLayerMethod);
+    oInputIndex.Build(this);
 
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
-
-        // set up the filter on method layer
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (!x_geom) {
-            delete x; 
-            continue;
-        }
-        
-        OGRGeometry *geom = x_geom->clone(); // this will be the geometry of the result feature
-        pLayerMethod->ResetReading();
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            OGRGeometry *geom_new = geom ? geom->Difference(y_geom) : NULL;
-            if (geom) delete geom;
-            geom = geom_new;
-            delete y;
-            if (geom && geom->IsEmpty()) break;
-        }
-
-        OGRFeature *z = NULL;
-        if (geom && !geom->IsEmpty()) {
-            z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapInput);
-            if( bPromoteToMulti )
-                geom = promote_to_multi(geom);
-            z->SetGeometryDirectly(geom);
-        } else {
-            if (geom) delete geom;
-        }
-        delete x;
-        if (z) {
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
-
-    // restore filter on method layer and add features based on it
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
-    pLayerMethod->ResetReading();
-    while (OGRFeature *x = pLayerMethod->GetNextFeature()) {
-
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
+    // add features based on input layer
+    init_overlay_context(&sContext, OVERLAY_DIFFERENCE, pLayerResult->GetLayerDefn(),
+                         mapInput, mapMethod, pGeometryMethodFilter, &oMethodIndex,
+                         papszOptions);
+    ret = run_overlay(&sContext, NULL, &oInputIndex, pLayerResult, bSkipFailures,
+                      pfnProgress, pProgressArg, &progress_counter, progress_max);
+    if (ret != OGRERR_NONE) goto done;
 
-        // set up the filter on input layer
-        OGRGeometry *x_geom = set_filter_from(this, pGeometryInputFilter, x);
-        if (!x_geom) {
-            delete x; 
-            continue;
-        }
-        
-        OGRGeometry *geom = x_geom->clone(); // this will be the geometry of the result feature
-        ResetReading();
-        while (OGRFeature *y = GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            OGRGeometry *geom_new = geom ? geom->Difference(y_geom) : NULL;
-            if (geom) delete geom;
-            geom = geom_new;
-            delete y;
-            if (geom == NULL || geom->IsEmpty()) break;
-        }
+    // add features based on method layer
+    init_overlay_context(&sContext, OVERLAY_DIFFERENCE, pLayerResult->GetLayerDefn(),
+                         mapMethod, NULL, pGeometryInputFilter, &oInputIndex,
+                         papszOptions);
+    ret = run_overlay(&sContext, NULL, &oMethodIndex, pLayerResult, bSkipFailures,
+                      pfnProgress, pProgressArg, &progress_counter, progress_max);
+    if (ret != OGRERR_NONE) goto done;
 
-        OGRFeature *z = NULL;
-        if (geom && !geom->IsEmpty()) {
-            z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapMethod);
-            if( bPromoteToMulti )
-                geom = promote_to_multi(geom);
-            z->SetGeometryDirectly(geom);
-        } else {
-            if (geom) delete geom;
-        }
-        delete x;
-        if (z) {
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
@@ -2790,8 +3184,6 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
     }
 done:
     // release resources
-    SetSpatialFilter(pGeometryInputFilter);
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     if (pGeometryMethodFilter) delete pGeometryMethodFilter;
     if (pGeometryInputFilter) delete pGeometryInputFilter;
     if (mapInput) VSIFree(mapInput);
@@ -2820,8 +3212,9 @@ done:
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -2836,6 +3229,12 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::SymDifference().
@@ -2895,8 +3294,9 @@ OGRErr OGR_L_SymDifference( OGRLayerH pLayerInput,
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -2911,6 +3311,12 @@ OGRErr OGR_L_SymDifference( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Identity().
@@ -2943,15 +3349,14 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
     OGRErr ret = OGRERR_NONE;
     OGRFeatureDefn *poDefnInput = GetLayerDefn();
     OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
     OGRGeometry *pGeometryMethodFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGROverlayIndex oMethodIndex;
+    OGROverlayContext sContext;
     double progress_max = (double) GetFeatureCount(0);
     double progress_counter = 0;
-    double progress_ticker = 0;
     int bSkipFailures = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -2967,98 +3372,18 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
     if (ret != OGRERR_NONE) goto done;
     ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
     if (ret != OGRERR_NONE) goto done;
-    poDefnResult = pLayerResult->GetLayerDefn();
 
-    // split the features in input layer to the result layer
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
-
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
+    // index the method layer once
+    oMethodIndex.Build(pLayerMethod);
 
-        // set up the filter on method layer
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (!x_geom) {
-            delete x; 
-            continue;
-        }
-        
-        OGRGeometry *x_geom_diff = x_geom->clone(); // this will be the geometry of the result feature
-        pLayerMethod->ResetReading();
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            OGRGeometry* poIntersection = x_geom->Intersection(y_geom);
-            if( poIntersection == NULL || poIntersection->IsEmpty() ||
-                (x_geom->getDimension() == 2 &&
-                y_geom->getDimension() == 2 &&
-                poIntersection->getDimension() < 2) )
-            {
-                delete poIntersection;
-                delete y;
-            }
-            else
-            {
-                OGRFeature *z = new OGRFeature(poDefnResult);
-                z->SetFieldsFrom(x, mapInput);
-                z->SetFieldsFrom(y, mapMethod);
-                if( bPromoteToMulti )
-                    poIntersection = promote_to_multi(poIntersection);
-                z->SetGeometryDirectly(poIntersection);
-                OGRGeometry *x_geom_diff_new = x_geom_diff ? x_geom_diff->Difference(y_geom) : NULL;
-                if (x_geom_diff) delete x_geom_diff;
-                x_geom_diff = x_geom_diff_new;
-                delete y;
-                ret = pLayerResult->CreateFeature(z);
-                delete z;
-                if (ret != OGRERR_NONE) {
-                    if (!bSkipFailures) {
-                        delete x;
-                        delete x_geom_diff;
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                    }
-                }
-            }
-        }
+    // split the features in input layer to the result layer
+    init_overlay_context(&sContext, OVERLAY_IDENTITY, pLayerResult->GetLayerDefn(),
+                         mapInput, mapMethod, pGeometryMethodFilter, &oMethodIndex,
+                         papszOptions);
+    ret = run_overlay(&sContext, this, NULL, pLayerResult, bSkipFailures,
+                      pfnProgress, pProgressArg, &progress_counter, progress_max);
+    if (ret != OGRERR_NONE) goto done;
 
-        if( x_geom_diff == NULL || x_geom_diff->IsEmpty() )
-        {
-            delete x_geom_diff;
-            delete x;
-        }
-        else
-        {
-            OGRFeature *z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapInput);
-            if( bPromoteToMulti )
-                x_geom_diff = promote_to_multi(x_geom_diff);
-            z->SetGeometryDirectly(x_geom_diff);
-            delete x;
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
@@ -3066,7 +3391,6 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
     }
 done:
     // release resources
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     if (pGeometryMethodFilter) delete pGeometryMethodFilter;
     if (mapInput) VSIFree(mapInput);
     if (mapMethod) VSIFree(mapMethod);
@@ -3092,8 +3416,9 @@ done:
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3108,6 +3433,12 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Identity().
@@ -3169,8 +3500,9 @@ OGRErr OGR_L_Identity( OGRLayerH pLayerInput,
  * the attribute in the result feature the originates from the method
  * layer will get the value from the feature of the method layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3185,6 +3517,12 @@ OGRErr OGR_L_Identity( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Update().
@@ -3217,15 +3555,14 @@ OGRErr OGRLayer::Update( OGRLayer *pLayerMethod,
     OGRErr ret = OGRERR_NONE;
     OGRFeatureDefn *poDefnInput = GetLayerDefn();
     OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
     OGRGeometry *pGeometryMethodFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGROverlayIndex oMethodIndex;
+    OGROverlayContext sContext;
     double progress_max = (double) GetFeatureCount(0) + (double) pLayerMethod->GetFeatureCount(0);
     double progress_counter = 0;
-    double progress_ticker = 0;
     int bSkipFailures = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -3241,104 +3578,25 @@ OGRErr OGRLayer::Update( OGRLayer *pLayerMethod,
     if (ret != OGRERR_NONE) goto done;
     ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 0, papszOptions);
     if (ret != OGRERR_NONE) goto done;
-    poDefnResult = pLayerResult->GetLayerDefn();
-
-    // add clipped features from the input layer
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
 
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
+    // index the method layer once
+    oMethodIndex.Build(pLayerMethod);
 
-        // set up the filter on method layer
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (!x_geom) {
-            delete x; 
-            continue;
-        }
-        
-        OGRGeometry *x_geom_diff = x_geom->clone(); //this will be the geometry of a result feature
-        pLayerMethod->ResetReading();
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            OGRGeometry *x_geom_diff_new = x_geom_diff ? x_geom_diff->Difference(y_geom) : NULL;
-            if (x_geom_diff) delete x_geom_diff;
-            x_geom_diff = x_geom_diff_new;
-            delete y;
-        }
-
-        if( x_geom_diff == NULL || x_geom_diff->IsEmpty() )
-        {
-            delete x_geom_diff;
-            delete x;
-        }
-        else
-        {
-            OGRFeature *z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapInput);
-            if( bPromoteToMulti )
-                x_geom_diff = promote_to_multi(x_geom_diff);
-            z->SetGeometryDirectly(x_geom_diff);
-            delete x;
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
-
-    // restore the original filter and add features from the update layer
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
-    pLayerMethod->ResetReading();
-    while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
+    // add clipped features from the input layer
+    init_overlay_context(&sContext, OVERLAY_DIFFERENCE, pLayerResult->GetLayerDefn(),
+                         mapInput, NULL, pGeometryMethodFilter, &oMethodIndex,
+                         papszOptions);
+    ret = run_overlay(&sContext, this, NULL, pLayerResult, bSkipFailures,
+                      pfnProgress, pProgressArg, &progress_counter, progress_max);
+    if (ret != OGRERR_NONE) goto done;
 
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete y;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
+    // add features from the update layer
+    init_overlay_context(&sContext, OVERLAY_COPY, pLayerResult->GetLayerDefn(),
+                         mapMethod, NULL, NULL, NULL, papszOptions);
+    ret = run_overlay(&sContext, NULL, &oMethodIndex, pLayerResult, bSkipFailures,
+                      pfnProgress, pProgressArg, &progress_counter, progress_max);
+    if (ret != OGRERR_NONE) goto done;
 
-        OGRGeometry *y_geom = y->GetGeometryRef();
-        if (!y_geom) {delete y; continue;}
-        OGRFeature *z = new OGRFeature(poDefnResult);
-        if (mapMethod) z->SetFieldsFrom(y, mapMethod);
-        z->SetGeometry(y_geom);
-        delete y;
-        ret = pLayerResult->CreateFeature(z);
-        delete z;
-        if (ret != OGRERR_NONE) {
-            if (!bSkipFailures) {
-                goto done;
-            } else {
-                CPLErrorReset();
-                ret = OGRERR_NONE;
-            }
-        }
-    }
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
@@ -3346,7 +3604,6 @@ OGRErr OGRLayer::Update( OGRLayer *pLayerMethod,
     }
 done:
     // release resources
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     if (pGeometryMethodFilter) delete pGeometryMethodFilter;
     if (mapInput) VSIFree(mapInput);
     if (mapMethod) VSIFree(mapMethod);
@@ -3374,8 +3631,9 @@ done:
  * the attribute in the result feature the originates from the method
  * layer will get the value from the feature of the method layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3390,6 +3648,12 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Update().
@@ -3444,8 +3708,9 @@ OGRErr OGR_L_Update( OGRLayerH pLayerInput,
  * schema of the result layer can be set by the user or, if it is
  * empty, is initialized to contain all fields in the input layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3460,6 +3725,12 @@ OGRErr OGR_L_Update( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Clip().
@@ -3491,98 +3762,37 @@ OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
 {
     OGRErr ret = OGRERR_NONE;
     OGRFeatureDefn *poDefnInput = GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
     OGRGeometry *pGeometryMethodFilter = NULL;
     int *mapInput = NULL;
+    OGROverlayIndex oMethodIndex;
+    OGROverlayContext sContext;
     double progress_max = (double) GetFeatureCount(0);
     double progress_counter = 0;
-    double progress_ticker = 0;
     int bSkipFailures = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
         return OGRERR_UNSUPPORTED_OPERATION;
     }
 
+    // get resources
     ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
     if (ret != OGRERR_NONE) goto done;
     ret = create_field_map(poDefnInput, &mapInput);
     if (ret != OGRERR_NONE) goto done;
     ret = set_result_schema(pLayerResult, poDefnInput, NULL, mapInput, NULL, 0, papszOptions);
     if (ret != OGRERR_NONE) goto done;
-    
-    poDefnResult = pLayerResult->GetLayerDefn();
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
 
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
+    // index the method layer once
+    oMethodIndex.Build(pLayerMethod);
 
-        // set up the filter on method layer
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (!x_geom) {
-            delete x; 
-            continue;
-        }
-        
-        OGRGeometry *geom = NULL; // this will be the geometry of the result feature 
-        pLayerMethod->ResetReading();
-        // incrementally add area from y to geom
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            if (!geom) {
-                geom = y_geom->clone();
-            } else {
-                OGRGeometry *geom_new = geom->Union(y_geom);
-                delete geom;
-                geom = geom_new;
-            }
-            delete y;
-        }
+    init_overlay_context(&sContext, OVERLAY_CLIP, pLayerResult->GetLayerDefn(),
+                         mapInput, NULL, pGeometryMethodFilter, &oMethodIndex,
+                         papszOptions);
+    ret = run_overlay(&sContext, this, NULL, pLayerResult, bSkipFailures,
+                      pfnProgress, pProgressArg, &progress_counter, progress_max);
+    if (ret != OGRERR_NONE) goto done;
 
-        // possibly add a new feature with area x intersection sum of y
-        OGRFeature *z = NULL;
-        if (geom) {
-            OGRGeometry* poIntersection = x_geom->Intersection(geom);
-            if( poIntersection != NULL && !poIntersection->IsEmpty() )
-            {
-                z = new OGRFeature(poDefnResult);
-                z->SetFieldsFrom(x, mapInput);
-                if( bPromoteToMulti )
-                    poIntersection = promote_to_multi(poIntersection);
-                z->SetGeometryDirectly(poIntersection);
-            }
-            else
-                delete poIntersection;
-            delete geom;
-        }
-        delete x;
-        if (z) {
-            if (z->GetGeometryRef() != NULL && !z->GetGeometryRef()->IsEmpty())
-                ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
@@ -3590,7 +3800,6 @@ OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
     }
 done:
     // release resources
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     if (pGeometryMethodFilter) delete pGeometryMethodFilter;
     if (mapInput) VSIFree(mapInput);
     return ret;
@@ -3610,8 +3819,9 @@ done:
  * schema of the result layer can be set by the user or, if it is
  * empty, is initialized to contain all fields in the input layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3626,6 +3836,12 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Clip().
@@ -3680,8 +3896,9 @@ OGRErr OGR_L_Clip( OGRLayerH pLayerInput,
  * it is empty, is initialized to contain all fields in the input
  * layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3696,6 +3913,12 @@ OGRErr OGR_L_Clip( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Erase().
@@ -3727,14 +3950,13 @@ OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
 {
     OGRErr ret = OGRERR_NONE;
     OGRFeatureDefn *poDefnInput = GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
     OGRGeometry *pGeometryMethodFilter = NULL;
     int *mapInput = NULL;
+    OGROverlayIndex oMethodIndex;
+    OGROverlayContext sContext;
     double progress_max = (double) GetFeatureCount(0);
     double progress_counter = 0;
-    double progress_ticker = 0;
     int bSkipFailures = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CSLTestBoolean(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -3748,78 +3970,17 @@ OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
     if (ret != OGRERR_NONE) goto done;
     ret = set_result_schema(pLayerResult, poDefnInput, NULL, mapInput, NULL, 0, papszOptions);
     if (ret != OGRERR_NONE) goto done;
-    poDefnResult = pLayerResult->GetLayerDefn();
 
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
+    // index the method layer once
+    oMethodIndex.Build(pLayerMethod);
 
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
-
-        // set up the filter on the method layer
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (!x_geom) {
-            delete x; 
-            continue;
-        }
-
-        OGRGeometry *geom = NULL; // this will be the geometry of the result feature
-        pLayerMethod->ResetReading();
-        // incrementally add area from y to geom
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            if (!geom) {
-                geom = y_geom->clone();
-            } else {
-                OGRGeometry *geom_new = geom->Union(y_geom);
-                delete geom;
-                geom = geom_new;
-            }
-            delete y;
-        }
+    init_overlay_context(&sContext, OVERLAY_ERASE, pLayerResult->GetLayerDefn(),
+                         mapInput, NULL, pGeometryMethodFilter, &oMethodIndex,
+                         papszOptions);
+    ret = run_overlay(&sContext, this, NULL, pLayerResult, bSkipFailures,
+                      pfnProgress, pProgressArg, &progress_counter, progress_max);
+    if (ret != OGRERR_NONE) goto done;
 
-        // possibly add a new feature with area x minus sum of y
-        OGRFeature *z = NULL;
-        if (geom) {
-            OGRGeometry* x_geom_diff = x_geom->Difference(geom);
-            if( x_geom_diff != NULL && !x_geom_diff->IsEmpty() )
-            {
-                z = new OGRFeature(poDefnResult);
-                z->SetFieldsFrom(x, mapInput);
-                if( bPromoteToMulti )
-                    x_geom_diff = promote_to_multi(x_geom_diff);
-                z->SetGeometryDirectly(x_geom_diff);
-            }
-            else
-                delete x_geom_diff;
-            delete geom;
-        }
-        delete x;
-        if (z) {
-            if (z->GetGeometryRef() != NULL && !z->GetGeometryRef()->IsEmpty())
-                ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
@@ -3827,7 +3988,6 @@ OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
     }
 done:
     // release resources
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     if (pGeometryMethodFilter) delete pGeometryMethodFilter;
     if (mapInput) VSIFree(mapInput);
     return ret;
@@ -3847,8 +4007,9 @@ done:
  * it is empty, is initialized to contain all fields in the input
  * layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are loaded in memory and
+ * spatially indexed once, so for best performance use the minimum
+ * amount of features in the method layer.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3863,6 +4024,12 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer. Defaults to YES.
+ * <li>NUM_THREADS=number or ALL_CPUS. Number of threads used to compute
+ *     the result geometries. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or 1.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Erase().
@@ -0,0 +1,883 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Implements OGRSpatialIndexedLayer class
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "ogrspatialindexedlayer.h"
+#include "cpl_conv.h"
+#include "cpl_vsi.h"
+
+CPL_CVSID("$Id$");
+
+/* Sidecar layout (all values little endian) :                          */
+/*   8 bytes  : "OGRSPIX2"                                              */
+/*   int32    : index of the geometry field                             */
+/*   int32    : size of an entry (48)                                   */
+/*   int64    : number of entries                                       */
+/*   int64    : size of the source file when indexed, or -1             */
+/*   int64    : modification time of the source file, or -1             */
+/*   entries  : int64 FID, int64 ordinal, double minx,miny,maxx,maxy    */
+
+#define SPIX_SIGNATURE      "OGRSPIX2"
+#define SPIX_HEADER_SIZE    40
+#define SPIX_ENTRY_SIZE     48
+
+/************************************************************************/
+/*                       OGRSpatialIndexedLayer()                       */
+/************************************************************************/
+
+OGRSpatialIndexedLayer::OGRSpatialIndexedLayer( OGRLayer* poDecoratedLayer,
+                                                int bTakeOwnership,
+                                                const char* pszIndexFilename,
+                                                const char* pszSourceFilename ) :
+                                      OGRLayerDecorator(poDecoratedLayer,
+                                                        bTakeOwnership)
+{
+    SetDescription( poDecoratedLayer->GetDescription() );
+
+    if( pszIndexFilename != NULL )
+        m_osIndexFilename = pszIndexFilename;
+    if( pszSourceFilename != NULL )
+        m_osSourceFilename = pszSourceFilename;
+    m_nSourceSize = -1;
+    m_nSourceMTime = -1;
+
+    m_pasEntries = NULL;
+    m_nEntryCount = 0;
+    m_nEntryAlloc = 0;
+    m_hQuadTree = NULL;
+    m_bIndexBuilt = FALSE;
+    m_bIndexDirty = FALSE;
+    m_iIndexGeomField = -1;
+
+    m_eScanMode = SCAN_UNDECIDED;
+    m_nReadOrdinal = 0;
+    m_papsCandidates = NULL;
+    m_nCandidateCount = 0;
+    m_iNextCandidate = 0;
+
+    m_bDecoratedAttrFilterCleared = FALSE;
+}
+
+/************************************************************************/
+/*                      ~OGRSpatialIndexedLayer()                       */
+/************************************************************************/
+
+OGRSpatialIndexedLayer::~OGRSpatialIndexedLayer()
+{
+    InvalidateIndex();
+}
+
+/************************************************************************/
+/*                          InvalidateIndex()                           */
+/************************************************************************/
+
+void OGRSpatialIndexedLayer::InvalidateIndex()
+{
+    if( m_hQuadTree != NULL )
+        CPLQuadTreeDestroy( m_hQuadTree );
+    m_hQuadTree = NULL;
+
+    CPLFree( m_papsCandidates );
+    m_papsCandidates = NULL;
+    m_nCandidateCount = 0;
+    m_iNextCandidate = 0;
+
+    CPLFree( m_pasEntries );
+    m_pasEntries = NULL;
+    m_nEntryCount = 0;
+    m_nEntryAlloc = 0;
+
+    m_bIndexBuilt = FALSE;
+    m_bIndexDirty = FALSE;
+    m_iIndexGeomField = -1;
+}
+
+/************************************************************************/
+/*                           MarkIndexDirty()                           */
+/*                                                                      */
+/*      Called after the decorated layer has been modified. The index   */
+/*      is kept until the end of the current pass so that a scan that   */
+/*      updates the features it reads is not interrupted.               */
+/************************************************************************/
+
+void OGRSpatialIndexedLayer::MarkIndexDirty()
+{
+    m_bIndexDirty = TRUE;
+
+    if( m_osIndexFilename.size() )
+    {
+        VSIStatBufL sStat;
+        if( VSIStatL( m_osIndexFilename, &sStat ) == 0 )
+            VSIUnlink( m_osIndexFilename );
+    }
+}
+
+/************************************************************************/
+/*                           IsPassThrough()                            */
+/*                                                                      */
+/*      Whether the current spatial filter is better evaluated by the   */
+/*      decorated layer itself.                                         */
+/************************************************************************/
+
+int OGRSpatialIndexedLayer::IsPassThrough()
+{
+    if( m_poFilterGeom == NULL )
+        return FALSE;
+
+    if( m_poDecoratedLayer->TestCapability( OLCFastSpatialFilter ) )
+        return TRUE;
+
+    OGRFeatureDefn* poDefn = GetLayerDefn();
+    if( m_iGeomFieldFilter < 0 ||
+        m_iGeomFieldFilter >= poDefn->GetGeomFieldCount() ||
+        poDefn->GetGeomFieldDefn(m_iGeomFieldFilter)->IsIgnored() )
+        return TRUE;
+
+    return FALSE;
+}
+
+/************************************************************************/
+/*                           IsIndexedScan()                            */
+/************************************************************************/
+
+int OGRSpatialIndexedLayer::IsIndexedScan()
+{
+    return m_poFilterGeom != NULL && !IsPassThrough();
+}
+
+/************************************************************************/
+/*                    SetDecoratedAttributeFilter()                     */
+/*                                                                      */
+/*      Index building and ordinal skipping need to see all the         */
+/*      features of the decorated layer, so its attribute filter is     */
+/*      removed and evaluated here while an indexed scan is active.     */
+/************************************************************************/
+
+void OGRSpatialIndexedLayer::SetDecoratedAttributeFilter( int bUnfiltered )
+{
+    if( bUnfiltered && !m_bDecoratedAttrFilterCleared &&
+        m_osAttrFilter.size() )
+    {
+        m_poDecoratedLayer->SetAttributeFilter( NULL );
+        m_bDecoratedAttrFilterCleared = TRUE;
+    }
+    else if( !bUnfiltered && m_bDecoratedAttrFilterCleared )
+    {
+        m_poDecoratedLayer->SetAttributeFilter( m_osAttrFilter );
+        m_bDecoratedAttrFilterCleared = FALSE;
+    }
+}
+
+/************************************************************************/
+/*                    UpdateDecoratedSpatialFilter()                    */
+/************************************************************************/
+
+void OGRSpatialIndexedLayer::UpdateDecoratedSpatialFilter()
+{
+    if( IsPassThrough() )
+        m_poDecoratedLayer->SetSpatialFilter( m_iGeomFieldFilter,
+                                              m_poFilterGeom );
+    else
+        m_poDecoratedLayer->SetSpatialFilter( NULL );
+}
+
+/************************************************************************/
+/*                          GetSpatialFilter()                          */
+/************************************************************************/
+
+OGRGeometry *OGRSpatialIndexedLayer::GetSpatialFilter()
+{
+    return m_poFilterGeom;
+}
+
+/************************************************************************/
+/*                          SetSpatialFilter()                          */
+/************************************************************************/
+
+void OGRSpatialIndexedLayer::SetSpatialFilter( OGRGeometry* poGeom )
+{
+    OGRLayer::SetSpatialFilter( poGeom );
+    UpdateDecoratedSpatialFilter();
+    ResetReading();
+}
+
+void OGRSpatialIndexedLayer::SetSpatialFilter( int iGeomField,
+                                               OGRGeometry* poGeom )
+{
+    if( iGeomField == 0 )
+    {
+        SetSpatialFilter( poGeom );
+        return;
+    }
+
+    OGRLayer::SetSpatialFilter( iGeomField, poGeom );
+    UpdateDecoratedSpatialFilter();
+    ResetReading();
+}
+
+/************************************************************************/
+/*                        SetSpatialFilterRect()                        */
+/************************************************************************/
+
+void OGRSpatialIndexedLayer::SetSpatialFilterRect( double dfMinX, double dfMinY,
+                                                   double dfMaxX, double dfMaxY )
+{
+    OGRLayer::SetSpatialFilterRect( dfMinX, dfMinY, dfMaxX, dfMaxY );
+}
+
+void OGRSpatialIndexedLayer::SetSpatialFilterRect( int iGeomField,
+                                                   double dfMinX, double dfMinY,
+                                                   double dfMaxX, double dfMaxY )
+{
+    OGRLayer::SetSpatialFilterRect( iGeomField, dfMinX, dfMinY, dfMaxX, dfMaxY );
+}
+
+/************************************************************************/
+/*                         SetAttributeFilter()                         */
+/************************************************************************/
+
+OGRErr OGRSpatialIndexedLayer::SetAttributeFilter( const char* pszQuery )
+{
+    m_osAttrFilter = (pszQuery != NULL) ? pszQuery : "";
+    m_bDecoratedAttrFilterCleared = FALSE;
+
+    OGRErr eErr = m_poDecoratedLayer->SetAttributeFilter( pszQuery );
+    if( eErr != OGRERR_NONE )
+        return eErr;
+
+    eErr = OGRLayer::SetAttributeFilter( pszQuery );
+    ResetReading();
+    return eErr;
+}
+
+/************************************************************************/
+/*                          SetIgnoredFields()                          */
+/************************************************************************/
+
+OGRErr OGRSpatialIndexedLayer::SetIgnoredFields( const char **papszFields )
+{
+    OGRErr eErr = m_poDecoratedLayer->SetIgnoredFields( papszFields );
+    if( eErr == OGRERR_NONE && m_poFilterGeom != NULL )
+    {
+        UpdateDecoratedSpatialFilter();
+        ResetReading();
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
+
+void OGRSpatialIndexedLayer::ResetReading()
+{
+    /* A partially built index is useless : the next scan starts over. */
+    if( m_eScanMode == SCAN_BUILD )
+        InvalidateIndex();
+
+    CPLFree( m_papsCandidates );
+    m_papsCandidates = NULL;
+    m_nCandidateCount = 0;
+    m_iNextCandidate = 0;
+    m_nReadOrdinal = 0;
+    m_eScanMode = SCAN_UNDECIDED;
+
+    SetDecoratedAttributeFilter( IsIndexedScan() );
+    m_poDecoratedLayer->ResetReading();
+}
+
+/************************************************************************/
+/*                              AddEntry()                              */
+/************************************************************************/
+
+void OGRSpatialIndexedLayer::AddEntry( GIntBig nFID, GIntBig nOrdinal,
+                                       const OGRGeometry* poGeom )
+{
+    if( m_nEntryCount == m_nEntryAlloc )
+    {
+        m_nEntryAlloc = m_nEntryAlloc + m_nEntryAlloc / 3 + 1000;
+        m_pasEntries = (OGRSpatialIndexEntry*)
+            CPLRealloc( m_pasEntries,
+                        sizeof(OGRSpatialIndexEntry) * m_nEntryAlloc );
+    }
+
+    OGREnvelope sEnvelope;
+    poGeom->getEnvelope( &sEnvelope );
+
+    OGRSpatialIndexEntry* psEntry = m_pasEntries + m_nEntryCount;
+    psEntry->nFID = nFID;
+    psEntry->nOrdinal = nOrdinal;
+    psEntry->dfMinX = sEnvelope.MinX;
+    psEntry->dfMinY = sEnvelope.MinY;
+    psEntry->dfMaxX = sEnvelope.MaxX;
+    psEntry->dfMaxY = sEnvelope.MaxY;
+    m_nEntryCount ++;
+}
+
+/************************************************************************/
+/*                           BuildQuadTree()                            */
+/************************************************************************/
+
+static void OGRSpatialIndexEntryGetBounds( const void* hFeature,
+                                           CPLRectObj* pBounds )
+{
+    const OGRSpatialIndexEntry* psEntry =
+        (const OGRSpatialIndexEntry*) hFeature;
+    pBounds->minx = psEntry->dfMinX;
+    pBounds->miny = psEntry->dfMinY;
+    pBounds->maxx = psEntry->dfMaxX;
+    pBounds->maxy = psEntry->dfMaxY;
+}
+
+void OGRSpatialIndexedLayer::BuildQuadTree()
+{
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = 0;
+    sGlobalBounds.miny = 0;
+    sGlobalBounds.maxx = 0;
+    sGlobalBounds.maxy = 0;
+
+    for( int i = 0; i < m_nEntryCount; i++ )
+    {
+        const OGRSpatialIndexEntry* psEntry = m_pasEntries + i;
+        if( i == 0 || psEntry->dfMinX < sGlobalBounds.minx )
+            sGlobalBounds.minx = psEntry->dfMinX;
+        if( i == 0 || psEntry->dfMinY < sGlobalBounds.miny )
+            sGlobalBounds.miny = psEntry->dfMinY;
+        if( i == 0 || psEntry->dfMaxX > sGlobalBounds.maxx )
+            sGlobalBounds.maxx = psEntry->dfMaxX;
+        if( i == 0 || psEntry->dfMaxY > sGlobalBounds.maxy )
+            sGlobalBounds.maxy = psEntry->dfMaxY;
+    }
+
+    m_hQuadTree = CPLQuadTreeCreate( &sGlobalBounds,
+                                     OGRSpatialIndexEntryGetBounds );
+    CPLQuadTreeSetMaxDepth( m_hQuadTree,
+                            CPLQuadTreeGetAdvisedMaxDepth( m_nEntryCount ) );
+
+    for( int i = 0; i < m_nEntryCount; i++ )
+        CPLQuadTreeInsert( m_hQuadTree, m_pasEntries + i );
+
+    m_bIndexBuilt = TRUE;
+}
+
+/************************************************************************/
+/*                           GetSourceStamp()                           */
+/*                                                                      */
+/*      Size and modification time of the source file, or -1 when       */
+/*      there is no source file to check.                               */
+/************************************************************************/
+
+void OGRSpatialIndexedLayer::GetSourceStamp( GIntBig* pnSize,
+                                             GIntBig* pnMTime )
+{
+    VSIStatBufL sSourceStat;
+
+    *pnSize = -1;
+    *pnMTime = -1;
+    if( m_osSourceFilename.size() &&
+        VSIStatL( m_osSourceFilename, &sSourceStat ) == 0 )
+    {
+        *pnSize = (GIntBig) sSourceStat.st_size;
+        *pnMTime = (GIntBig) sSourceStat.st_mtime;
+    }
+}
+
+/************************************************************************/
+/*                             LoadIndex()                              */
+/************************************************************************/
+
+int OGRSpatialIndexedLayer::LoadIndex()
+{
+    if( m_osIndexFilename.size() == 0 )
+        return FALSE;
+
+    VSIStatBufL sIndexStat;
+    if( VSIStatL( m_osIndexFilename, &sIndexStat ) != 0 )
+        return FALSE;
+
+    VSILFILE* fp = VSIFOpenL( m_osIndexFilename, "rb" );
+    if( fp == NULL )
+        return FALSE;
+
+    GByte abyHeader[SPIX_HEADER_SIZE];
+    GInt32 iGeomField, nEntrySize;
+    GIntBig nCount, nSourceSize, nSourceMTime;
+
+    if( VSIFReadL( abyHeader, 1, SPIX_HEADER_SIZE, fp ) != SPIX_HEADER_SIZE ||
+        memcmp( abyHeader, SPIX_SIGNATURE, 8 ) != 0 )
+    {
+        VSIFCloseL( fp );
+        return FALSE;
+    }
+
+    memcpy( &iGeomField, abyHeader + 8, 4 );
+    CPL_LSBPTR32( &iGeomField );
+    memcpy( &nEntrySize, abyHeader + 12, 4 );
+    CPL_LSBPTR32( &nEntrySize );
+    memcpy( &nCount, abyHeader + 16, 8 );
+    CPL_LSBPTR64( &nCount );
+    memcpy( &nSourceSize, abyHeader + 24, 8 );
+    CPL_LSBPTR64( &nSourceSize );
+    memcpy( &nSourceMTime, abyHeader + 32, 8 );
+    CPL_LSBPTR64( &nSourceMTime );
+
+/* -------------------------------------------------------------------- */
+/*      Ignore a sidecar that was not built from the current state of   */
+/*      the source. Modification times only have a one second           */
+/*      resolution, so a sidecar written in the same second as the      */
+/*      last modification of the source cannot tell a later edit in     */
+/*      that second apart : it is rebuilt instead of being trusted.     */
+/* -------------------------------------------------------------------- */
+    GIntBig nCurSourceSize, nCurSourceMTime;
+    GetSourceStamp( &nCurSourceSize, &nCurSourceMTime );
+    if( nSourceSize != nCurSourceSize || nSourceMTime != nCurSourceMTime ||
+        (nSourceMTime >= 0 && nSourceMTime >= (GIntBig)sIndexStat.st_mtime) )
+    {
+        CPLDebug( "OGR", "Spatial index %s does not match %s, ignoring it.",
+                  m_osIndexFilename.c_str(), m_osSourceFilename.c_str() );
+        VSIFCloseL( fp );
+        return FALSE;
+    }
+
+    if( iGeomField != m_iGeomFieldFilter || nEntrySize != SPIX_ENTRY_SIZE ||
+        nCount < 0 || nCount > INT_MAX / SPIX_ENTRY_SIZE ||
+        (vsi_l_offset)(SPIX_HEADER_SIZE + nCount * SPIX_ENTRY_SIZE) !=
+                                        (vsi_l_offset)sIndexStat.st_size )
+    {
+        VSIFCloseL( fp );
+        return FALSE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      When the feature count is cheap, use it as a sanity check.      */
+/* -------------------------------------------------------------------- */
+    if( m_poDecoratedLayer->TestCapability( OLCFastFeatureCount ) &&
+        nCount > m_poDecoratedLayer->GetFeatureCount() )
+    {
+        VSIFCloseL( fp );
+        return FALSE;
+    }
+
+    m_pasEntries = (OGRSpatialIndexEntry*)
+        VSIMalloc2( (size_t)nCount + 1, sizeof(OGRSpatialIndexEntry) );
+    if( m_pasEntries == NULL )
+    {
+        VSIFCloseL( fp );
+        return FALSE;
+    }
+    m_nEntryAlloc = (int)nCount + 1;
+
+    int bOK = TRUE;
+    for( m_nEntryCount = 0; m_nEntryCount < (int)nCount; m_nEntryCount++ )
+    {
+        GByte abyEntry[SPIX_ENTRY_SIZE];
+        if( VSIFReadL( abyEntry, 1, SPIX_ENTRY_SIZE, fp ) != SPIX_ENTRY_SIZE )
+        {
+            bOK = FALSE;
+            break;
+        }
+
+        OGRSpatialIndexEntry* psEntry = m_pasEntries + m_nEntryCount;
+        memcpy( &psEntry->nFID, abyEntry, 8 );
+        CPL_LSBPTR64( &psEntry->nFID );
+        memcpy( &psEntry->nOrdinal, abyEntry + 8, 8 );
+        CPL_LSBPTR64( &psEntry->nOrdinal );
+        memcpy( &psEntry->dfMinX, abyEntry + 16, 8 );
+        CPL_LSBPTR64( &psEntry->dfMinX );
+        memcpy( &psEntry->dfMinY, abyEntry + 24, 8 );
+        CPL_LSBPTR64( &psEntry->dfMinY );
+        memcpy( &psEntry->dfMaxX, abyEntry + 32, 8 );
+        CPL_LSBPTR64( &psEntry->dfMaxX );
+        memcpy( &psEntry->dfMaxY, abyEntry + 40, 8 );
+        CPL_LSBPTR64( &psEntry->dfMaxY );
+
+        /* Entries are stored in reading order. */
+        if( psEntry->nOrdinal < 0 ||
+            (m_nEntryCount > 0 &&
+             psEntry->nOrdinal <= psEntry[-1].nOrdinal) )
+        {
+            bOK = FALSE;
+            break;
+        }
+    }
+
+    VSIFCloseL( fp );
+
+    if( !bOK )
+    {
+        CPLDebug( "OGR", "Spatial index %s is corrupted, ignoring it.",
+                  m_osIndexFilename.c_str() );
+        InvalidateIndex();
+        return FALSE;
+    }
+
+    CPLDebug( "OGR", "Using spatial index %s (" CPL_FRMT_GIB " entries)",
+              m_osIndexFilename.c_str(), nCount );
+
+    BuildQuadTree();
+    m_iIndexGeomField = m_iGeomFieldFilter;
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                             SaveIndex()                              */
+/************************************************************************/
+
+void OGRSpatialIndexedLayer::SaveIndex()
+{
+    if( m_osIndexFilename.size() == 0 )
+        return;
+
+/* -------------------------------------------------------------------- */
+/*      Do not save an index if the source changed during the scan.     */
+/* -------------------------------------------------------------------- */
+    GIntBig nSourceSize, nSourceMTime;
+    GetSourceStamp( &nSourceSize, &nSourceMTime );
+    if( nSourceSize != m_nSourceSize || nSourceMTime != m_nSourceMTime )
+    {
+        CPLDebug( "OGR", "%s changed while it was indexed, "
+                  "not saving spatial index %s.",
+                  m_osSourceFilename.c_str(), m_osIndexFilename.c_str() );
+        return;
+    }
+
+    VSILFILE* fp = VSIFOpenL( m_osIndexFilename, "wb" );
+    if( fp == NULL )
+    {
+        CPLDebug( "OGR", "Cannot create spatial index %s.",
+                  m_osIndexFilename.c_str() );
+        return;
+    }
+
+    GByte abyHeader[SPIX_HEADER_SIZE];
+    GInt32 nVal32;
+    GIntBig nVal64;
+
+    memcpy( abyHeader, SPIX_SIGNATURE, 8 );
+    nVal32 = m_iIndexGeomField;
+    CPL_LSBPTR32( &nVal32 );
+    memcpy( abyHeader + 8, &nVal32, 4 );
+    nVal32 = SPIX_ENTRY_SIZE;
+    CPL_LSBPTR32( &nVal32 );
+    memcpy( abyHeader + 12, &nVal32, 4 );
+    nVal64 = m_nEntryCount;
+    CPL_LSBPTR64( &nVal64 );
+    memcpy( abyHeader + 16, &nVal64, 8 );
+    nVal64 = nSourceSize;
+    CPL_LSBPTR64( &nVal64 );
+    memcpy( abyHeader + 24, &nVal64, 8 );
+    nVal64 = nSourceMTime;
+    CPL_LSBPTR64( &nVal64 );
+    memcpy( abyHeader + 32, &nVal64, 8 );
+
+    int bOK = VSIFWriteL( abyHeader, 1, SPIX_HEADER_SIZE, fp ) ==
+                                                        SPIX_HEADER_SIZE;
+
+    for( int i = 0; bOK && i < m_nEntryCount; i++ )
+    {
+        OGRSpatialIndexEntry sEntry = m_pasEntries[i];
+        GByte abyEntry[SPIX_ENTRY_SIZE];
+
+        CPL_LSBPTR64( &sEntry.nFID );
+        memcpy( abyEntry, &sEntry.nFID, 8 );
+        CPL_LSBPTR64( &sEntry.nOrdinal );
+        memcpy( abyEntry + 8, &sEntry.nOrdinal, 8 );
+        CPL_LSBPTR64( &sEntry.dfMinX );
+        memcpy( abyEntry + 16, &sEntry.dfMinX, 8 );
+        CPL_LSBPTR64( &sEntry.dfMinY );
+        memcpy( abyEntry + 24, &sEntry.dfMinY, 8 );
+        CPL_LSBPTR64( &sEntry.dfMaxX );
+        memcpy( abyEntry + 32, &sEntry.dfMaxX, 8 );
+        CPL_LSBPTR64( &sEntry.dfMaxY );
+        memcpy( abyEntry + 40, &sEntry.dfMaxY, 8 );
+
+        bOK = VSIFWriteL( abyEntry, 1, SPIX_ENTRY_SIZE, fp ) ==
+                                                        SPIX_ENTRY_SIZE;
+    }
+
+    if( VSIFCloseL( fp ) != 0 )
+        bOK = FALSE;
+
+    if( !bOK )
+    {
+        CPLDebug( "OGR", "Failed to write spatial index %s.",
+                  m_osIndexFilename.c_str() );
+        VSIUnlink( m_osIndexFilename );
+    }
+}
+
+/************************************************************************/
+/*                             StartScan()                              */
+/*                                                                      */
+/*      Decide how the current spatially filtered pass is run : build   */
+/*      the index while reading everything, or fetch the candidates     */
+/*      of an existing index by FID or by position.                     */
+/************************************************************************/
+
+static int OGRSpatialIndexEntryCompareOrdinal( const void* a, const void* b )
+{
+    const OGRSpatialIndexEntry* psA = *(const OGRSpatialIndexEntry* const*) a;
+    const OGRSpatialIndexEntry* psB = *(const OGRSpatialIndexEntry* const*) b;
+    if( psA->nOrdinal < psB->nOrdinal )
+        return -1;
+    if( psA->nOrdinal > psB->nOrdinal )
+        return 1;
+    return 0;
+}
+
+void OGRSpatialIndexedLayer::StartScan()
+{
+    if( !IsIndexedScan() )
+    {
+        m_eScanMode = SCAN_PASSTHROUGH;
+        return;
+    }
+
+    if( m_bIndexDirty ||
+        (m_bIndexBuilt && m_iIndexGeomField != m_iGeomFieldFilter) )
+        InvalidateIndex();
+
+    if( !m_bIndexBuilt && !LoadIndex() )
+    {
+        InvalidateIndex();
+        m_iIndexGeomField = m_iGeomFieldFilter;
+        GetSourceStamp( &m_nSourceSize, &m_nSourceMTime );
+        m_eScanMode = SCAN_BUILD;
+        return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Collect candidates and sort them in reading order.              */
+/* -------------------------------------------------------------------- */
+    CPLRectObj sAoi;
+    sAoi.minx = m_sFilterEnvelope.MinX;
+    sAoi.miny = m_sFilterEnvelope.MinY;
+    sAoi.maxx = m_sFilterEnvelope.MaxX;
+    sAoi.maxy = m_sFilterEnvelope.MaxY;
+
+    m_papsCandidates = (OGRSpatialIndexEntry**)
+        CPLQuadTreeSearch( m_hQuadTree, &sAoi, &m_nCandidateCount );
+    if( m_nCandidateCount > 1 )
+        qsort( m_papsCandidates, m_nCandidateCount,
+               sizeof(OGRSpatialIndexEntry*),
+               OGRSpatialIndexEntryCompareOrdinal );
+    m_iNextCandidate = 0;
+
+    if( m_poDecoratedLayer->TestCapability( OLCRandomRead ) )
+        m_eScanMode = SCAN_RANDOM;
+    else
+        m_eScanMode = SCAN_SKIP;
+}
+
+/************************************************************************/
+/*                           MatchesFilters()                           */
+/************************************************************************/
+
+int OGRSpatialIndexedLayer::MatchesFilters( OGRFeature* poFeature )
+{
+    return FilterGeometry( poFeature->GetGeomFieldRef(m_iGeomFieldFilter) ) &&
+           (m_poAttrQuery == NULL || m_poAttrQuery->Evaluate( poFeature ));
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature *OGRSpatialIndexedLayer::GetNextFeature()
+{
+    if( m_eScanMode == SCAN_UNDECIDED )
+        StartScan();
+
+    OGRFeature* poFeature;
+
+    switch( m_eScanMode )
+    {
+        case SCAN_BUILD:
+        {
+            while( TRUE )
+            {
+                poFeature = m_poDecoratedLayer->GetNextFeature();
+                if( poFeature == NULL )
+                {
+                    m_eScanMode = SCAN_DONE;
+                    if( m_bIndexDirty )
+                    {
+                        InvalidateIndex();
+                        return NULL;
+                    }
+                    BuildQuadTree();
+                    SaveIndex();
+                    return NULL;
+                }
+
+                GIntBig nOrdinal = m_nReadOrdinal ++;
+                OGRGeometry* poGeom =
+                    poFeature->GetGeomFieldRef(m_iGeomFieldFilter);
+                if( poGeom != NULL && !poGeom->IsEmpty() )
+                    AddEntry( poFeature->GetFID(), nOrdinal, poGeom );
+
+                if( MatchesFilters( poFeature ) )
+                    return poFeature;
+                delete poFeature;
+            }
+        }
+
+        case SCAN_RANDOM:
+        {
+            while( m_iNextCandidate < m_nCandidateCount )
+            {
+                const OGRSpatialIndexEntry* psEntry =
+                    m_papsCandidates[m_iNextCandidate ++];
+                poFeature = m_poDecoratedLayer->GetFeature( psEntry->nFID );
+                if( poFeature == NULL )
+                    continue;
+                if( MatchesFilters( poFeature ) )
+                    return poFeature;
+                delete poFeature;
+            }
+            return NULL;
+        }
+
+        case SCAN_SKIP:
+        {
+            int bFastSetNextByIndex =
+                m_poDecoratedLayer->TestCapability( OLCFastSetNextByIndex );
+            while( m_iNextCandidate < m_nCandidateCount )
+            {
+                GIntBig nTarget =
+                    m_papsCandidates[m_iNextCandidate]->nOrdinal;
+                if( bFastSetNextByIndex && nTarget > m_nReadOrdinal &&
+                    m_poDecoratedLayer->SetNextByIndex( nTarget ) == OGRERR_NONE )
+                    m_nReadOrdinal = nTarget;
+
+                poFeature = m_poDecoratedLayer->GetNextFeature();
+                if( poFeature == NULL )
+                {
+                    m_iNextCandidate = m_nCandidateCount;
+                    return NULL;
+                }
+
+                if( m_nReadOrdinal ++ < nTarget )
+                {
+                    delete poFeature;
+                    continue;
+                }
+
+                m_iNextCandidate ++;
+                if( MatchesFilters( poFeature ) )
+                    return poFeature;
+                delete poFeature;
+            }
+            return NULL;
+        }
+
+        case SCAN_DONE:
+            return NULL;
+
+        default:
+            return m_poDecoratedLayer->GetNextFeature();
+    }
+}
+
+/************************************************************************/
+/*                           SetNextByIndex()                           */
+/************************************************************************/
+
+OGRErr OGRSpatialIndexedLayer::SetNextByIndex( GIntBig nIndex )
+{
+    if( IsIndexedScan() )
+        return OGRLayer::SetNextByIndex( nIndex );
+    return m_poDecoratedLayer->SetNextByIndex( nIndex );
+}
+
+/************************************************************************/
+/*                            ISetFeature()                             */
+/************************************************************************/
+
+OGRErr OGRSpatialIndexedLayer::ISetFeature( OGRFeature *poFeature )
+{
+    OGRErr eErr = m_poDecoratedLayer->SetFeature( poFeature );
+    if( eErr == OGRERR_NONE )
+        MarkIndexDirty();
+    return eErr;
+}
+
+/************************************************************************/
+/*                           ICreateFeature()                           */
+/************************************************************************/
+
+OGRErr OGRSpatialIndexedLayer::ICreateFeature( OGRFeature *poFeature )
+{
+    OGRErr eErr = m_poDecoratedLayer->CreateFeature( poFeature );
+    if( eErr == OGRERR_NONE )
+        MarkIndexDirty();
+    return eErr;
+}
+
+/************************************************************************/
+/*                           DeleteFeature()                            */
+/************************************************************************/
+
+OGRErr OGRSpatialIndexedLayer::DeleteFeature( GIntBig nFID )
+{
+    OGRErr eErr = m_poDecoratedLayer->DeleteFeature( nFID );
+    if( eErr == OGRERR_NONE )
+        MarkIndexDirty();
+    return eErr;
+}
+
+/************************************************************************/
+/*                          GetFeatureCount()                           */
+/************************************************************************/
+
+GIntBig OGRSpatialIndexedLayer::GetFeatureCount( int bForce )
+{
+    if( IsIndexedScan() )
+        return OGRLayer::GetFeatureCount( bForce );
+    return m_poDecoratedLayer->GetFeatureCount( bForce );
+}
+
+/************************************************************************/
+/*                           TestCapability()                           */
+/************************************************************************/
+
+int OGRSpatialIndexedLayer::TestCapability( const char * pszCapability )
+{
+    if( EQUAL(pszCapability, OLCFastSpatialFilter) )
+        return HasSpatialIndex() ||
+               m_poDecoratedLayer->TestCapability( pszCapability );
+
+    if( IsIndexedScan() &&
+        (EQUAL(pszCapability, OLCFastFeatureCount) ||
+         EQUAL(pszCapability, OLCFastSetNextByIndex)) )
+        return FALSE;
+
+    return m_poDecoratedLayer->TestCapability( pszCapability );
+}
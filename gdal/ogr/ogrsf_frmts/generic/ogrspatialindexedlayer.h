@@ -0,0 +1,145 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Defines OGRSpatialIndexedLayer class
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef _OGRSPATIALINDEXEDLAYER_H_INCLUDED
+#define _OGRSPATIALINDEXEDLAYER_H_INCLUDED
+
+#include "ogrlayerdecorator.h"
+#include "cpl_quad_tree.h"
+#include "cpl_string.h"
+
+/************************************************************************/
+/*                        OGRSpatialIndexEntry                          */
+/************************************************************************/
+
+typedef struct
+{
+    GIntBig     nFID;
+    GIntBig     nOrdinal;   /* position of the feature in sequential reading */
+    double      dfMinX;
+    double      dfMinY;
+    double      dfMaxX;
+    double      dfMaxY;
+} OGRSpatialIndexEntry;
+
+/************************************************************************/
+/*                       OGRSpatialIndexedLayer                         */
+/************************************************************************/
+
+/* Layer decorator that builds an in-memory quadtree of feature envelopes */
+/* during the first spatially filtered scan of a layer that has no native */
+/* spatial index, and uses it to answer later spatial filters. The index  */
+/* can optionally be persisted in a sidecar file.                         */
+
+class CPL_DLL OGRSpatialIndexedLayer : public OGRLayerDecorator
+{
+  protected:
+    typedef enum
+    {
+        SCAN_UNDECIDED,
+        SCAN_PASSTHROUGH,
+        SCAN_BUILD,
+        SCAN_RANDOM,
+        SCAN_SKIP,
+        SCAN_DONE
+    } ScanMode;
+
+    CPLString               m_osIndexFilename;
+    CPLString               m_osSourceFilename;
+    GIntBig                 m_nSourceSize;
+    GIntBig                 m_nSourceMTime;
+
+    OGRSpatialIndexEntry   *m_pasEntries;
+    int                     m_nEntryCount;
+    int                     m_nEntryAlloc;
+    CPLQuadTree            *m_hQuadTree;
+    int                     m_bIndexBuilt;
+    int                     m_bIndexDirty;
+    int                     m_iIndexGeomField;
+
+    ScanMode                m_eScanMode;
+    GIntBig                 m_nReadOrdinal;
+    OGRSpatialIndexEntry  **m_papsCandidates;
+    int                     m_nCandidateCount;
+    int                     m_iNextCandidate;
+
+    CPLString               m_osAttrFilter;
+    int                     m_bDecoratedAttrFilterCleared;
+
+    int                 IsPassThrough();
+    int                 IsIndexedScan();
+    void                SetDecoratedAttributeFilter( int bUnfiltered );
+    void                UpdateDecoratedSpatialFilter();
+
+    void                InvalidateIndex();
+    void                MarkIndexDirty();
+    void                AddEntry( GIntBig nFID, GIntBig nOrdinal,
+                                  const OGRGeometry* poGeom );
+    void                BuildQuadTree();
+    void                StartScan();
+    void                GetSourceStamp( GIntBig* pnSize, GIntBig* pnMTime );
+    int                 LoadIndex();
+    void                SaveIndex();
+
+    int                 MatchesFilters( OGRFeature* poFeature );
+
+  public:
+
+                       OGRSpatialIndexedLayer(OGRLayer* poDecoratedLayer,
+                                              int bTakeOwnership,
+                                              const char* pszIndexFilename = NULL,
+                                              const char* pszSourceFilename = NULL);
+    virtual           ~OGRSpatialIndexedLayer();
+
+    int                 HasSpatialIndex() { return m_bIndexBuilt && !m_bIndexDirty; }
+
+    virtual OGRGeometry *GetSpatialFilter();
+    virtual void        SetSpatialFilter( OGRGeometry * );
+    virtual void        SetSpatialFilterRect( double dfMinX, double dfMinY,
+                                              double dfMaxX, double dfMaxY );
+    virtual void        SetSpatialFilter( int iGeomField, OGRGeometry * );
+    virtual void        SetSpatialFilterRect( int iGeomField, double dfMinX, double dfMinY,
+                                              double dfMaxX, double dfMaxY );
+
+    virtual OGRErr      SetAttributeFilter( const char * );
+
+    virtual void        ResetReading();
+    virtual OGRFeature *GetNextFeature();
+    virtual OGRErr      SetNextByIndex( GIntBig nIndex );
+    virtual OGRErr      ISetFeature( OGRFeature *poFeature );
+    virtual OGRErr      ICreateFeature( OGRFeature *poFeature );
+    virtual OGRErr      DeleteFeature( GIntBig nFID );
+
+    virtual GIntBig     GetFeatureCount( int bForce = TRUE );
+
+    virtual int         TestCapability( const char * );
+
+    virtual OGRErr      SetIgnoredFields( const char **papszFields );
+};
+
+#endif //  _OGRSPATIALINDEXEDLAYER_H_INCLUDED
@@ -40,6 +40,7 @@
 #define SPACE_FOR_BBOX  80
 
 class OGRGeoJSONDataSource;
+class OGRGeoJSONReader;
 
 /************************************************************************/
 /*                           OGRGeoJSONLayer                            */
@@ -76,6 +77,8 @@ public:
     //
     void AddFeature( OGRFeature* poFeature );
     void DetectGeometryType();
+    void SetStreamingReader( OGRGeoJSONReader* poReader,
+                             GIntBig nFeatureCount );
 
 private:
 
@@ -83,6 +86,14 @@ private:
     FeaturesSeq seqFeatures_;
     FeaturesSeq::iterator iterCurrent_;
 
+    // Set when features are read from the file on demand rather than
+    // held in seqFeatures_.
+    OGRGeoJSONReader* poReader_;
+    GIntBig nStreamedFeatureCount_;
+    GIntBig nNextFID_;
+
+    void AssignFID( OGRFeature* poFeature, GIntBig nFID );
+
 
     // CPL_UNUSED OGRGeoJSONDataSource* poDS_;
     OGRFeatureDefn* poFeatureDefn_;
@@ -206,6 +217,8 @@ private:
     int ReadFromFile( GDALOpenInfo* poOpenInfo );
     int ReadFromService( const char* pszSource );
     void LoadLayers(char** papszOpenOptions);
+    int LoadLayerStreaming( GDALOpenInfo* poOpenInfo );
+    void SetupReader( OGRGeoJSONReader& oReader, char** papszOpenOptions );
 };
 
 
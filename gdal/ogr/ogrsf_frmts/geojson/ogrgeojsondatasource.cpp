@@ -84,6 +84,8 @@ int OGRGeoJSONDataSource::Open( GDALOpenInfo* poOpenInfo,
     }
     else if( eGeoJSONSourceFile == nSrcType )
     {
+        if( LoadLayerStreaming( poOpenInfo ) )
+            return TRUE;
         if( !ReadFromFile( poOpenInfo ) )
             return FALSE;
     }
@@ -514,32 +516,107 @@ void OGRGeoJSONDataSource::LoadLayers(char** papszOpenOptions)
 /* -------------------------------------------------------------------- */
     OGRGeoJSONReader reader;
 
+    SetupReader( reader, papszOpenOptions );
+
+/* -------------------------------------------------------------------- */
+/*      Parse GeoJSON and build valid OGRLayer instance.                */
+/* -------------------------------------------------------------------- */
+    err = reader.Parse( pszGeoData_ );
+    if( OGRERR_NONE == err )
+    {
+        reader.ReadLayers( this );
+    }
+
+    return;
+}
+
+/************************************************************************/
+/*                            SetupReader()                             */
+/************************************************************************/
+
+void OGRGeoJSONDataSource::SetupReader( OGRGeoJSONReader& oReader,
+                                        char** papszOpenOptions )
+{
     if( eGeometryAsCollection == flTransGeom_ )
     {
-        reader.SetPreserveGeometryType( false );
+        oReader.SetPreserveGeometryType( false );
         CPLDebug( "GeoJSON", "Geometry as OGRGeometryCollection type." );
     }
     
     if( eAtributesSkip == flTransAttrs_ )
     {
-        reader.SetSkipAttributes( true );
+        oReader.SetSkipAttributes( true );
         CPLDebug( "GeoJSON", "Skip all attributes." );
     }
     
-    reader.SetFlattenNestedAttributes(
+    oReader.SetFlattenNestedAttributes(
         (bool)CSLFetchBoolean(papszOpenOptions, "FLATTEN_NESTED_ATTRIBUTES", FALSE),
         CSLFetchNameValueDef(papszOpenOptions, "NESTED_ATTRIBUTE_SEPARATOR", "_")[0]);
+}
+
+/************************************************************************/
+/*                        LoadLayerStreaming()                          */
+/*                                                                      */
+/*      Open a large FeatureCollection file without ingesting it:       */
+/*      the features are read from the file one at a time, so memory   */
+/*      use is bounded by the largest feature. Returns FALSE for small  */
+/*      files and for content that is not a plain FeatureCollection,    */
+/*      which are then ingested and parsed as a whole.                  */
+/************************************************************************/
+
+int OGRGeoJSONDataSource::LoadLayerStreaming( GDALOpenInfo* poOpenInfo )
+{
+    if( poOpenInfo->fpL == NULL || poOpenInfo->pabyHeader == NULL )
+        return FALSE;
+
+    GIntBig nMinSize = CPLAtoGIntBig(
+        CPLGetConfigOption( "GEOJSON_STREAMING_MIN_SIZE", "10485760" ) );
+    if( nMinSize < 0 )
+        return FALSE;
+
+    VSIFSeekL( poOpenInfo->fpL, 0, SEEK_END );
+    GIntBig nFileSize = (GIntBig) VSIFTellL( poOpenInfo->fpL );
+    VSIFSeekL( poOpenInfo->fpL, 0, SEEK_SET );
+    if( nFileSize < nMinSize )
+        return FALSE;
 
 /* -------------------------------------------------------------------- */
-/*      Parse GeoJSON and build valid OGRLayer instance.                */
+/*      Leave JSONP wrapped content and CouchDB responses to the        */
+/*      regular code path.                                              */
 /* -------------------------------------------------------------------- */
-    err = reader.Parse( pszGeoData_ );
-    if( OGRERR_NONE == err )
+    const char* pszHeader = (const char*) poOpenInfo->pabyHeader;
+    if( strncmp(pszHeader, "{\"couchdb\":\"Welcome\"", strlen("{\"couchdb\":\"Welcome\"")) == 0 ||
+        strncmp(pszHeader, "{\"db_name\":\"", strlen("{\"db_name\":\"")) == 0 ||
+        strncmp(pszHeader, "{\"total_rows\":", strlen("{\"total_rows\":")) == 0 ||
+        strncmp(pszHeader, "{\"rows\":[", strlen("{\"rows\":[")) == 0 )
     {
-        reader.ReadLayers( this );
+        return FALSE;
     }
 
-    return;
+    const GByte* pabyData = poOpenInfo->pabyHeader;
+    if( pabyData[0] == 0xEF && pabyData[1] == 0xBB && pabyData[2] == 0xBF )
+        pszHeader += 3;
+    while( *pszHeader != '\0' && isspace( (unsigned char)*pszHeader ) )
+        pszHeader++;
+    if( *pszHeader != '{' )
+        return FALSE;
+
+/* -------------------------------------------------------------------- */
+/*      Scan the file, and hand it over to the layer on success.        */
+/* -------------------------------------------------------------------- */
+    OGRGeoJSONReader* poReader = new OGRGeoJSONReader();
+    SetupReader( *poReader, poOpenInfo->papszOpenOptions );
+
+    if( !poReader->FirstPassReadLayer( this, poOpenInfo->fpL ) )
+    {
+        delete poReader;
+        return FALSE;
+    }
+
+    poOpenInfo->fpL = NULL;
+    pszName_ = CPLStrdup( poOpenInfo->pszFilename );
+
+    return TRUE;
 }
 
 /************************************************************************/
@@ -30,6 +30,7 @@
 #include <algorithm> // for_each, find_if
 #include <json.h> // JSON-C
 #include "ogr_geojson.h"
+#include "ogrgeojsonreader.h"
 
 /* Remove annoying warnings Microsoft Visual C++ */
 #if defined(_MSC_VER)
@@ -52,7 +53,9 @@ OGRGeoJSONLayer::OGRGeoJSONLayer( const char* pszName,
                                   OGRSpatialReference* poSRSIn,
                                   OGRwkbGeometryType eGType,
                                   CPL_UNUSED OGRGeoJSONDataSource* poDS )
-  : iterCurrent_( seqFeatures_.end() ), /* poDS_( poDS ), */ poFeatureDefn_(new OGRFeatureDefn( pszName ) )
+  : iterCurrent_( seqFeatures_.end() ),
+    poReader_( NULL ), nStreamedFeatureCount_( 0 ), nNextFID_( 0 ),
+    /* poDS_( poDS ), */ poFeatureDefn_(new OGRFeatureDefn( pszName ) )
 {
     /* CPLAssert( NULL != poDS_ ); */
     CPLAssert( NULL != poFeatureDefn_ );
@@ -73,6 +76,8 @@ OGRGeoJSONLayer::~OGRGeoJSONLayer()
     std::for_each(seqFeatures_.begin(), seqFeatures_.end(),
                   OGRFeature::DestroyFeature);
 
+    delete poReader_;
+
     if( NULL != poFeatureDefn_ )
     {
         poFeatureDefn_->Release();
@@ -95,7 +100,11 @@ OGRFeatureDefn* OGRGeoJSONLayer::GetLayerDefn()
 GIntBig OGRGeoJSONLayer::GetFeatureCount( int bForce )
 {
     if (m_poFilterGeom == NULL && m_poAttrQuery == NULL)
+    {
+        if( poReader_ != NULL )
+            return nStreamedFeatureCount_;
         return static_cast<int>( seqFeatures_.size() );
+    }
     else
         return OGRLayer::GetFeatureCount(bForce);
 }
@@ -107,6 +116,12 @@ GIntBig OGRGeoJSONLayer::GetFeatureCount( int bForce )
 void OGRGeoJSONLayer::ResetReading()
 {
     iterCurrent_ = seqFeatures_.begin();
+
+    if( poReader_ != NULL )
+    {
+        poReader_->ResetReading();
+        nNextFID_ = 0;
+    }
 }
 
 /************************************************************************/
@@ -115,6 +130,33 @@ void OGRGeoJSONLayer::ResetReading()
 
 OGRFeature* OGRGeoJSONLayer::GetNextFeature()
 {
+    while ( poReader_ != NULL )
+    {
+        OGRFeature* poFeature = poReader_->GetNextFeature( this );
+        if( poFeature == NULL )
+            return NULL;
+
+        /* Number features as AddFeature() would have. */
+        if( -1 == poFeature->GetFID() )
+            AssignFID( poFeature, nNextFID_ );
+        nNextFID_ ++;
+
+        if((m_poFilterGeom == NULL
+            || FilterGeometry( poFeature->GetGeometryRef() ) )
+        && (m_poAttrQuery == NULL
+            || m_poAttrQuery->Evaluate( poFeature )) )
+        {
+            if (poFeature->GetGeometryRef() != NULL && GetSpatialRef() != NULL)
+            {
+                poFeature->GetGeometryRef()->assignSpatialReference( GetSpatialRef() );
+            }
+
+            return poFeature;
+        }
+
+        delete poFeature;
+    }
+
     while ( iterCurrent_ != seqFeatures_.end() )
     {
         OGRFeature* poFeature = (*iterCurrent_);
@@ -190,15 +232,7 @@ void OGRGeoJSONLayer::AddFeature( OGRFeature* poFeature )
 
     if( -1 == poNewFeature->GetFID() )
     {
-        int nFID = static_cast<int>(seqFeatures_.size());
-        poNewFeature->SetFID( nFID );
-
-        // TODO - mlokot: We need to redesign creation of FID column
-        int nField = poNewFeature->GetFieldIndex( DefaultFIDColumn );
-        if( -1 != nField && GetLayerDefn()->GetFieldDefn(nField)->GetType() == OFTInteger )
-        {
-            poNewFeature->SetField( nField, nFID );
-        }
+        AssignFID( poNewFeature, static_cast<int>(seqFeatures_.size()) );
     }
     
         
@@ -208,6 +242,40 @@ void OGRGeoJSONLayer::AddFeature( OGRFeature* poFeature )
     seqFeatures_.push_back( poNewFeature );
 }
 
+/************************************************************************/
+/*                           AssignFID                                  */
+/************************************************************************/
+
+void OGRGeoJSONLayer::AssignFID( OGRFeature* poFeature, GIntBig nFID )
+{
+    poFeature->SetFID( nFID );
+
+    // TODO - mlokot: We need to redesign creation of FID column
+    int nField = poFeature->GetFieldIndex( DefaultFIDColumn );
+    if( -1 != nField && GetLayerDefn()->GetFieldDefn(nField)->GetType() == OFTInteger )
+    {
+        poFeature->SetField( nField, static_cast<int>(nFID) );
+    }
+}
+
+/************************************************************************/
+/*                           SetStreamingReader                         */
+/*                                                                      */
+/*      Make the layer read its features from poReader, which it        */
+/*      takes ownership of, instead of from the in-memory sequence.     */
+/************************************************************************/
+
+void OGRGeoJSONLayer::SetStreamingReader( OGRGeoJSONReader* poReader,
+                                          GIntBig nFeatureCount )
+{
+    CPLAssert( seqFeatures_.empty() );
+
+    delete poReader_;
+    poReader_ = poReader;
+    nStreamedFeatureCount_ = nFeatureCount;
+    nNextFID_ = 0;
+}
+
 /************************************************************************/
 /*                           DetectGeometryType                         */
 /************************************************************************/
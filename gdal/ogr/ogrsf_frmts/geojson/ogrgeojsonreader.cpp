@@ -33,12 +33,243 @@
 #include <json.h> // JSON-C
 #include <ogr_api.h>
 
+#define GEOJSON_STREAM_BUFFER_SIZE 65536
+
+/************************************************************************/
+/*                      OGRGeoJSONFeatureStream()                       */
+/************************************************************************/
+
+OGRGeoJSONFeatureStream::OGRGeoJSONFeatureStream( VSILFILE* fp )
+    : fp_( fp ), nBufferLen_( 0 ), nBufferPos_( 0 ),
+        eState_( eStateStart )
+{
+    pabyBuffer_ = (char*) CPLMalloc( GEOJSON_STREAM_BUFFER_SIZE );
+}
+
+/************************************************************************/
+/*                      ~OGRGeoJSONFeatureStream()                      */
+/************************************************************************/
+
+OGRGeoJSONFeatureStream::~OGRGeoJSONFeatureStream()
+{
+    CPLFree( pabyBuffer_ );
+}
+
+/************************************************************************/
+/*                               Rewind()                               */
+/************************************************************************/
+
+void OGRGeoJSONFeatureStream::Rewind()
+{
+    VSIFSeekL( fp_, 0, SEEK_SET );
+    nBufferLen_ = 0;
+    nBufferPos_ = 0;
+    eState_ = eStateStart;
+}
+
+/************************************************************************/
+/*                             FillBuffer()                             */
+/************************************************************************/
+
+bool OGRGeoJSONFeatureStream::FillBuffer()
+{
+    nBufferPos_ = 0;
+    nBufferLen_ = VSIFReadL( pabyBuffer_, 1, GEOJSON_STREAM_BUFFER_SIZE, fp_ );
+    return nBufferLen_ > 0;
+}
+
+/************************************************************************/
+/*                            PeekNonSpace()                            */
+/*                                                                      */
+/*      Skip white space and return the next character without          */
+/*      consuming it, or -1 at end of file.                             */
+/************************************************************************/
+
+int OGRGeoJSONFeatureStream::PeekNonSpace()
+{
+    while( true )
+    {
+        if( nBufferPos_ == nBufferLen_ && !FillBuffer() )
+            return -1;
+
+        const char ch = pabyBuffer_[nBufferPos_];
+        if( !isspace( (unsigned char)ch ) )
+            return (unsigned char)ch;
+        nBufferPos_ ++;
+    }
+}
+
+/************************************************************************/
+/*                             ReadValue()                              */
+/*                                                                      */
+/*      Read the text of the JSON value starting at the current         */
+/*      position: an object or array up to its matching closing         */
+/*      bracket, a string up to its closing quote, or a bare literal    */
+/*      up to the next separator.                                       */
+/************************************************************************/
+
+bool OGRGeoJSONFeatureStream::ReadValue( CPLString& osValue )
+{
+    int nDepth = 0;
+    bool bInString = false;
+    bool bEscape = false;
+    bool bDone = false;
+
+    osValue.resize( 0 );
+
+    while( !bDone )
+    {
+        if( nBufferPos_ == nBufferLen_ && !FillBuffer() )
+            return nDepth == 0 && !bInString && !osValue.empty();
+
+        size_t i = nBufferPos_;
+        for( ; i < nBufferLen_ && !bDone; i++ )
+        {
+            const char ch = pabyBuffer_[i];
+            if( bInString )
+            {
+                if( bEscape )
+                    bEscape = false;
+                else if( ch == '\\' )
+                    bEscape = true;
+                else if( ch == '"' )
+                {
+                    bInString = false;
+                    bDone = (nDepth == 0);
+                }
+            }
+            else if( ch == '"' )
+                bInString = true;
+            else if( ch == '{' || ch == '[' )
+                nDepth ++;
+            else if( ch == '}' || ch == ']' )
+            {
+                if( nDepth == 0 )
+                {
+                    /* Closing bracket of the container: leave it. */
+                    bDone = true;
+                    i --;
+                }
+                else
+                {
+                    nDepth --;
+                    bDone = (nDepth == 0);
+                }
+            }
+            else if( nDepth == 0 &&
+                     (ch == ',' || isspace( (unsigned char)ch )) )
+            {
+                bDone = true;
+                i --;
+            }
+        }
+
+        osValue.append( pabyBuffer_ + nBufferPos_, i - nBufferPos_ );
+        nBufferPos_ = i;
+    }
+
+    return !osValue.empty();
+}
+
+/************************************************************************/
+/*                                Next()                                */
+/*                                                                      */
+/*      Return the next top-level member of the FeatureCollection       */
+/*      (eMember, with its key and the text of its value), or the       */
+/*      next element of its "features" array (eFeature).                */
+/************************************************************************/
+
+OGRGeoJSONFeatureStream::ElementType
+OGRGeoJSONFeatureStream::Next( CPLString& osKey, CPLString& osValue )
+{
+    if( eState_ == eStateStart )
+    {
+        if( !FillBuffer() )
+            return eError;
+
+        /* Skip UTF-8 BOM (#5630) */
+        const GByte* pabyData = (const GByte*)pabyBuffer_;
+        if( nBufferLen_ >= 3 &&
+            pabyData[0] == 0xEF && pabyData[1] == 0xBB && pabyData[2] == 0xBF )
+            nBufferPos_ = 3;
+
+        if( PeekNonSpace() != '{' )
+            return eError;
+        nBufferPos_ ++;
+        eState_ = eStateTopObject;
+    }
+
+    while( eState_ != eStateEnd )
+    {
+        int ch = PeekNonSpace();
+        if( ch < 0 )
+            return eError;
+
+        if( eState_ == eStateFeatures )
+        {
+            if( ch == ']' )
+            {
+                nBufferPos_ ++;
+                eState_ = eStateTopObject;
+                continue;
+            }
+            if( ch == ',' )
+            {
+                nBufferPos_ ++;
+                continue;
+            }
+
+            if( !ReadValue( osValue ) )
+                return eError;
+            osKey = "features";
+            return eFeature;
+        }
+
+        if( ch == '}' )
+        {
+            nBufferPos_ ++;
+            eState_ = eStateEnd;
+            break;
+        }
+        if( ch == ',' )
+        {
+            nBufferPos_ ++;
+            continue;
+        }
+
+        /* Read the member name, and the value separator. */
+        if( ch != '"' || !ReadValue( osKey ) || osKey.size() < 2 )
+            return eError;
+        osKey = osKey.substr( 1, osKey.size() - 2 );
+
+        if( PeekNonSpace() != ':' )
+            return eError;
+        nBufferPos_ ++;
+
+        ch = PeekNonSpace();
+        if( ch < 0 )
+            return eError;
+        if( ch == '[' && osKey == "features" )
+        {
+            nBufferPos_ ++;
+            eState_ = eStateFeatures;
+            continue;
+        }
+
+        if( !ReadValue( osValue ) )
+            return eError;
+        return eMember;
+    }
+
+    return eEnd;
+}
+
 /************************************************************************/
 /*                           OGRGeoJSONReader                           */
 /************************************************************************/
 
 OGRGeoJSONReader::OGRGeoJSONReader()
-    : poGJObject_( NULL ),
+    : poGJObject_( NULL ), poStream_( NULL ), fpStream_( NULL ),
         bGeometryPreserve_( true ),
         bAttributesSkip_( false ),
         bFlattenNestedAttributes_ (false),
@@ -60,6 +291,10 @@ OGRGeoJSONReader::~OGRGeoJSONReader()
     }
 
     poGJObject_ = NULL;
+
+    delete poStream_;
+    if( NULL != fpStream_ )
+        VSIFCloseL( fpStream_ );
 }
 
 /************************************************************************/
@@ -119,6 +354,27 @@ void OGRGeoJSONReader::ReadLayers( OGRGeoJSONDataSource* poDS )
     ReadLayer(poDS, OGRGeoJSONLayer::DefaultName, poGJObject_);
 }
 
+/************************************************************************/
+/*                OGRGeoJSONReadLayerSpatialReference()                 */
+/************************************************************************/
+
+static OGRSpatialReference* OGRGeoJSONReadLayerSpatialReference( json_object* poObj )
+{
+    OGRSpatialReference* poSRS = NULL;
+    poSRS = OGRGeoJSONReadSpatialReference( poObj );
+    if (poSRS == NULL ) {
+        // If there is none defined, we use 4326
+        poSRS = new OGRSpatialReference();
+        if( OGRERR_NONE != poSRS->importFromEPSG( 4326 ) )
+        {
+            delete poSRS;
+            poSRS = NULL;
+        }
+    }
+
+    return poSRS;
+}
+
 /************************************************************************/
 /*                           ReadLayer                                  */
 /************************************************************************/
@@ -153,17 +409,7 @@ void OGRGeoJSONReader::ReadLayer( OGRGeoJSONDataSource* poDS,
         return;
     }
 
-    OGRSpatialReference* poSRS = NULL;
-    poSRS = OGRGeoJSONReadSpatialReference( poObj );
-    if (poSRS == NULL ) {
-        // If there is none defined, we use 4326
-        poSRS = new OGRSpatialReference();
-        if( OGRERR_NONE != poSRS->importFromEPSG( 4326 ) )
-        {
-            delete poSRS;
-            poSRS = NULL;
-        }
-    }
+    OGRSpatialReference* poSRS = OGRGeoJSONReadLayerSpatialReference( poObj );
 
     OGRGeoJSONLayer* poLayer = new OGRGeoJSONLayer( pszName, poSRS,
                                     OGRGeoJSONLayer::DefaultGeometryType,
@@ -231,6 +477,295 @@ void OGRGeoJSONReader::ReadLayer( OGRGeoJSONDataSource* poDS,
     poDS->AddLayer(poLayer);
 }
 
+/************************************************************************/
+/*                     OGRGeoJSONParseStreamedText()                    */
+/************************************************************************/
+
+static json_object* OGRGeoJSONParseStreamedText( const char* pszText )
+{
+    json_tokener* jstok = json_tokener_new();
+    json_object* poObj = json_tokener_parse_ex( jstok, pszText, -1 );
+    if( jstok->err != json_tokener_success )
+    {
+        if( NULL != poObj )
+            json_object_put( poObj );
+        poObj = NULL;
+    }
+    json_tokener_free( jstok );
+
+    return poObj;
+}
+
+/************************************************************************/
+/*                         OGRGeoJSONIsFID64()                          */
+/************************************************************************/
+
+static bool OGRGeoJSONIsFID64( json_object* poObjId )
+{
+    if( NULL == poObjId || json_object_get_type( poObjId ) != json_type_int )
+        return false;
+
+    GIntBig nId = (GIntBig)json_object_get_int64( poObjId );
+    return (GIntBig)(int)nId != nId;
+}
+
+/************************************************************************/
+/*                         FirstPassReadLayer()                         */
+/*                                                                      */
+/*      Scan a FeatureCollection file once to establish the layer       */
+/*      schema, geometry type, spatial reference and feature count,     */
+/*      holding a single feature in memory at a time. The features     */
+/*      are then read again from the file by GetNextFeature().          */
+/*                                                                      */
+/*      Returns false, leaving the file untouched, if it is not a       */
+/*      plain GeoJSON FeatureCollection, in which case the caller       */
+/*      should fall back to parsing the whole document.                 */
+/************************************************************************/
+
+bool OGRGeoJSONReader::FirstPassReadLayer( OGRGeoJSONDataSource* poDS,
+                                           VSILFILE* fp )
+{
+    CPLAssert( NULL == poStream_ );
+    poStream_ = new OGRGeoJSONFeatureStream( fp );
+
+    OGRGeoJSONLayer* poLayer =
+        new OGRGeoJSONLayer( OGRGeoJSONLayer::DefaultName, NULL,
+                             OGRGeoJSONLayer::DefaultGeometryType, poDS );
+    json_object* poTopLevel = json_object_new_object();
+
+    bool bOK = true;
+    bool bFirstFeature = true;
+    bool bGeomTypeDone = false;
+    bool bFID64 = false;
+    int nElements = 0;
+    GIntBig nFeatures = 0;
+    OGRwkbGeometryType eGType = OGRGeoJSONLayer::DefaultGeometryType;
+    CPLString osKey;
+    CPLString osValue;
+
+    while( bOK )
+    {
+        OGRGeoJSONFeatureStream::ElementType eType =
+            poStream_->Next( osKey, osValue );
+        if( OGRGeoJSONFeatureStream::eEnd == eType )
+            break;
+        if( OGRGeoJSONFeatureStream::eError == eType )
+        {
+            bOK = false;
+            break;
+        }
+
+        /* Content that OGRGeoJSONDataSource::LoadLayers() would hand */
+        /* over to the ESRI or TopoJSON readers. */
+        if( strstr( osKey, "esriGeometry" ) || strstr( osKey, "esriFieldType" ) ||
+            strstr( osValue, "esriGeometry" ) || strstr( osValue, "esriFieldType" ) ||
+            strstr( osValue, "\"Topology\"" ) )
+        {
+            bOK = false;
+            break;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Top-level members: only "type" and "crs" are of interest.       */
+/* -------------------------------------------------------------------- */
+        if( OGRGeoJSONFeatureStream::eMember == eType )
+        {
+            if( osKey == "features" )
+            {
+                /* "features" is not an array. */
+                bOK = false;
+            }
+            else if( osKey == "type" || osKey == "crs" )
+            {
+                json_object* poObj = OGRGeoJSONParseStreamedText( osValue );
+                if( NULL == poObj )
+                    bOK = false;
+                else
+                    json_object_object_add( poTopLevel, osKey, poObj );
+            }
+            continue;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Feature: update the schema as GenerateLayerDefn() would.        */
+/* -------------------------------------------------------------------- */
+        nElements ++;
+
+        json_object* poObj = OGRGeoJSONParseStreamedText( osValue );
+        if( NULL == poObj )
+        {
+            bOK = false;
+            break;
+        }
+
+        if( !bAttributesSkip_ && !GenerateFeatureDefn( poLayer, poObj ) )
+        {
+            CPLDebug( "GeoJSON", "Create feature schema failure." );
+        }
+
+        /* ReadFeature() rejects features without a geometry member. */
+        bool bHasGeometryMember = false;
+        json_object* poObjGeom = NULL;
+        json_object_iter it;
+        it.key = NULL;
+        it.val = NULL;
+        it.entry = NULL;
+        json_object_object_foreachC( poObj, it )
+        {
+            if( EQUAL( it.key, "geometry" ) )
+            {
+                bHasGeometryMember = true;
+                poObjGeom = it.val;
+            }
+        }
+
+        if( bHasGeometryMember )
+        {
+            nFeatures ++;
+
+            /* Same logic as OGRGeoJSONLayer::DetectGeometryType() */
+            if( !bGeomTypeDone )
+            {
+                OGRGeometry* poGeometry = NULL;
+                if( NULL != poObjGeom )
+                    poGeometry = ReadGeometry( poObjGeom );
+                if( bFirstFeature )
+                {
+                    if( NULL != poGeometry )
+                        eGType = poGeometry->getGeometryType();
+                    bFirstFeature = false;
+                    bGeomTypeDone = (eGType == wkbUnknown);
+                }
+                else if( NULL != poGeometry &&
+                         poGeometry->getGeometryType() != eGType )
+                {
+                    CPLDebug( "GeoJSON",
+                        "Detected layer of mixed-geometry type features." );
+                    eGType = OGRGeoJSONLayer::DefaultGeometryType;
+                    bGeomTypeDone = true;
+                }
+                delete poGeometry;
+            }
+
+            if( !bFID64 )
+            {
+                json_object* poObjProps =
+                    OGRGeoJSONFindMemberByName( poObj, "properties" );
+                bFID64 = OGRGeoJSONIsFID64(
+                    OGRGeoJSONFindMemberByName( poObj, "id" ) );
+                if( !bFID64 && NULL != poObjProps &&
+                    json_object_get_type( poObjProps ) == json_type_object )
+                {
+                    bFID64 = OGRGeoJSONIsFID64(
+                        json_object_object_get( poObjProps, "id" ) );
+                }
+            }
+        }
+
+        json_object_put( poObj );
+    }
+
+    if( bOK && (nElements == 0 ||
+                GeoJSONObject::eFeatureCollection != OGRGeoJSONGetType( poTopLevel )) )
+    {
+        bOK = false;
+    }
+
+    if( !bOK )
+    {
+        json_object_put( poTopLevel );
+        delete poLayer;
+        delete poStream_;
+        poStream_ = NULL;
+        VSIFSeekL( fp, 0, SEEK_SET );
+        return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Finalize the layer definition.                                  */
+/* -------------------------------------------------------------------- */
+    OGRSpatialReference* poSRS = OGRGeoJSONReadLayerSpatialReference( poTopLevel );
+    if( NULL != poSRS )
+    {
+        poLayer->GetLayerDefn()->GetGeomFieldDefn(0)->SetSpatialRef( poSRS );
+        poSRS->Release();
+    }
+    json_object_put( poTopLevel );
+
+    poLayer->GetLayerDefn()->SetGeomType( eGType );
+    SetFIDColumn( poLayer );
+    if( bFID64 )
+        poLayer->SetMetadataItem( OLMD_FID64, "YES" );
+
+    CPLDebug( "GeoJSON", "Streaming " CPL_FRMT_GIB " features from file.",
+              nFeatures );
+
+    fpStream_ = fp;
+    poLayer->SetStreamingReader( this, nFeatures );
+
+    CPLErrorReset();
+
+    poDS->AddLayer( poLayer );
+
+    return true;
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
+
+void OGRGeoJSONReader::ResetReading()
+{
+    if( NULL != poStream_ )
+        poStream_->Rewind();
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/*                                                                      */
+/*      Read the next feature of a layer set up by                      */
+/*      FirstPassReadLayer() from the file.                             */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONReader::GetNextFeature( OGRGeoJSONLayer* poLayer )
+{
+    if( NULL == poStream_ )
+        return NULL;
+
+    CPLString osKey;
+    CPLString osValue;
+
+    while( true )
+    {
+        OGRGeoJSONFeatureStream::ElementType eType =
+            poStream_->Next( osKey, osValue );
+        if( OGRGeoJSONFeatureStream::eEnd == eType )
+            return NULL;
+        if( OGRGeoJSONFeatureStream::eError == eType )
+        {
+            CPLError( CE_Failure, CPLE_FileIO,
+                      "GeoJSON parsing error while streaming features." );
+            return NULL;
+        }
+        if( OGRGeoJSONFeatureStream::eFeature != eType )
+            continue;
+
+        json_object* poObj = OGRGeoJSONParseStreamedText( osValue );
+        if( NULL == poObj )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "GeoJSON parsing error while streaming features." );
+            return NULL;
+        }
+
+        OGRFeature* poFeature = ReadFeature( poLayer, poObj );
+        json_object_put( poObj );
+
+        if( NULL != poFeature )
+            return poFeature;
+    }
+}
+
 /************************************************************************/
 /*                    OGRGeoJSONReadSpatialReference                    */
 /************************************************************************/
@@ -428,6 +963,17 @@ bool OGRGeoJSONReader::GenerateLayerDefn( OGRGeoJSONLayer* poLayer, json_object*
         }
     }
 
+    SetFIDColumn( poLayer );
+
+    return bSuccess;
+}
+
+/************************************************************************/
+/*                            SetFIDColumn()                            */
+/************************************************************************/
+
+void OGRGeoJSONReader::SetFIDColumn( OGRGeoJSONLayer* poLayer )
+{
 /* -------------------------------------------------------------------- */
 /*      Validate and add FID column if necessary.                       */
 /* -------------------------------------------------------------------- */
@@ -459,8 +1005,6 @@ bool OGRGeoJSONReader::GenerateLayerDefn( OGRGeoJSONLayer* poLayer, json_object*
       poLayer_->SetFIDColumn( fldDefn.GetNameRef() );
       }
     */
-
-    return bSuccess;
 }
 
 /************************************************************************/
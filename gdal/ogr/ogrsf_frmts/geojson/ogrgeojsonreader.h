@@ -79,6 +79,60 @@ struct GeoJSONObject
     };
 };
 
+/************************************************************************/
+/*                       OGRGeoJSONFeatureStream                        */
+/*                                                                      */
+/*      Incremental scanner of a GeoJSON FeatureCollection file.        */
+/*      It returns the text of the top-level members one at a time,     */
+/*      and each element of the "features" array as a separate          */
+/*      member, so that the file never needs to be held in memory.      */
+/************************************************************************/
+
+class OGRGeoJSONFeatureStream
+{
+public:
+
+    enum ElementType
+    {
+        eEnd,
+        eError,
+        eMember,
+        eFeature
+    };
+
+    OGRGeoJSONFeatureStream( VSILFILE* fp );
+    ~OGRGeoJSONFeatureStream();
+
+    void Rewind();
+    ElementType Next( CPLString& osKey, CPLString& osValue );
+
+private:
+
+    enum State
+    {
+        eStateStart,
+        eStateTopObject,
+        eStateFeatures,
+        eStateEnd
+    };
+
+    VSILFILE* fp_;
+    char* pabyBuffer_;
+    size_t nBufferLen_;
+    size_t nBufferPos_;
+    State eState_;
+
+    //
+    // Copy operations not supported.
+    //
+    OGRGeoJSONFeatureStream( OGRGeoJSONFeatureStream const& );
+    OGRGeoJSONFeatureStream& operator=( OGRGeoJSONFeatureStream const& );
+
+    bool FillBuffer();
+    int PeekNonSpace();
+    bool ReadValue( CPLString& osValue );
+};
+
 /************************************************************************/
 /*                           OGRGeoJSONReader                           */
 /************************************************************************/
@@ -102,9 +156,15 @@ public:
                     const char* pszName,
                     json_object* poObj );
 
+    bool FirstPassReadLayer( OGRGeoJSONDataSource* poDS, VSILFILE* fp );
+    void ResetReading();
+    OGRFeature* GetNextFeature( OGRGeoJSONLayer* poLayer );
+
 private:
 
     json_object* poGJObject_;
+    OGRGeoJSONFeatureStream* poStream_;
+    VSILFILE* fpStream_;
 
     bool bGeometryPreserve_;
     bool bAttributesSkip_;
@@ -125,6 +185,7 @@ private:
     //
     bool GenerateLayerDefn( OGRGeoJSONLayer* poLayer, json_object* poGJObject );
     bool GenerateFeatureDefn( OGRGeoJSONLayer* poLayer, json_object* poObj );
+    void SetFIDColumn( OGRGeoJSONLayer* poLayer );
     bool AddFeature( OGRGeoJSONLayer* poLayer, OGRGeometry* poGeometry );
     bool AddFeature( OGRGeoJSONLayer* poLayer, OGRFeature* poFeature );
 
@@ -51,6 +51,8 @@ GMLFeature::GMLFeature( GMLFeatureClass *poClass )
     m_apsGeometry[1] = NULL;
     
     m_papszOBProperties = NULL;
+
+    m_bOutsideSpatialFilter = FALSE;
 }
 
 /************************************************************************/
@@ -0,0 +1,634 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GML Reader
+ * Purpose:  Implementation of the GMLReader feature index (.gfi file).
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * The feature index records, for each top-level feature of the GML file,
+ * the byte range of its element, its class and the extent of its
+ * geometries. It is built by a full parse of the file the first time it
+ * is requested, and saved in a .gfi file next to the .gml so that later
+ * opens only have to load it.
+ *
+ * When a layer has a spatial filter, features whose extent does not
+ * intersect the envelope of the filter are known in advance to be
+ * discarded by OGRLayer::FilterGeometry(). Two levels of skipping are
+ * done :
+ *  - if the gml:id of all the features of the class can be turned into
+ *    OGR FIDs independently of the previous features, the byte range of
+ *    the feature is not even fed to the XML parser. Byte ranges of
+ *    features of other classes than the filtered one (STANDARD read mode)
+ *    are skipped the same way.
+ *  - otherwise, the feature is still parsed, but the handler does not
+ *    collect its properties and geometries, and the layer only uses it to
+ *    advance its FID numbering.
+ *
+ * The .gfi file layout is (all values little endian) :
+ *   "GFI1"
+ *   uint32 length + bytes : signature of the geometry building options
+ *   uint64 size and int64 modification time of the GML file
+ *   uint32 class count, then for each class :
+ *      uint32 length + bytes : class name
+ *      uint32 : whether FIDs are stable
+ *   uint64 feature count, then for each feature :
+ *      uint64 start offset, uint64 end offset,
+ *      uint32 class index, uint32 has extent,
+ *      double xmin, xmax, ymin, ymax
+ */
+
+#include "gmlreader.h"
+#include "gmlreaderp.h"
+#include "gmlutils.h"
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_string.h"
+#include "ogr_geometry.h"
+
+CPL_CVSID("$Id$");
+
+#ifdef HAVE_EXPAT
+
+#define GFI_MAGIC       "GFI1"
+#define GFI_ENTRY_SIZE  (8 + 8 + 4 + 4 + 4 * 8)
+
+/************************************************************************/
+/*                     Little endian I/O helpers                        */
+/************************************************************************/
+
+static int GFIWriteUInt32( VSILFILE* fp, GUInt32 nVal )
+{
+    CPL_LSBPTR32(&nVal);
+    return VSIFWriteL(&nVal, 1, 4, fp) == 4;
+}
+
+static int GFIWriteUInt64( VSILFILE* fp, GUIntBig nVal )
+{
+    CPL_LSBPTR64(&nVal);
+    return VSIFWriteL(&nVal, 1, 8, fp) == 8;
+}
+
+static int GFIWriteString( VSILFILE* fp, const CPLString& osStr )
+{
+    return GFIWriteUInt32(fp, (GUInt32)osStr.size()) &&
+           VSIFWriteL(osStr.c_str(), 1, osStr.size(), fp) == osStr.size();
+}
+
+static int GFIReadUInt32( VSILFILE* fp, GUInt32* pnVal )
+{
+    if( VSIFReadL(pnVal, 1, 4, fp) != 4 )
+        return FALSE;
+    CPL_LSBPTR32(pnVal);
+    return TRUE;
+}
+
+static int GFIReadUInt64( VSILFILE* fp, GUIntBig* pnVal )
+{
+    if( VSIFReadL(pnVal, 1, 8, fp) != 8 )
+        return FALSE;
+    CPL_LSBPTR64(pnVal);
+    return TRUE;
+}
+
+static int GFIReadString( VSILFILE* fp, CPLString& osStr )
+{
+    GUInt32 nLen;
+    if( !GFIReadUInt32(fp, &nLen) || nLen > 100000 )
+        return FALSE;
+    osStr.resize(nLen);
+    return nLen == 0 || VSIFReadL(&osStr[0], 1, nLen, fp) == nLen;
+}
+
+/************************************************************************/
+/*                        GFIGetFIDPrefixLength()                       */
+/*                                                                      */
+/*      Returns the length of the prefix preceding the numeric part     */
+/*      of the fid, using the same rules as OGRGMLLayer, or -1 if no    */
+/*      valid numeric part can be found.                                */
+/************************************************************************/
+
+static int GFIGetFIDPrefixLength( const char* pszFID )
+{
+    int i = (int)strlen(pszFID) - 1;
+    int j = 0;
+    while( i >= 0 && pszFID[i] >= '0' && pszFID[i] <= '9' && j < 20 )
+        i--, j++;
+    if( j == 0 || j >= 20 )
+        return -1;
+    return i + 1;
+}
+
+/************************************************************************/
+/*                      GetFeatureIndexSignature()                      */
+/*                                                                      */
+/*      The extents stored in the index depend on the options used      */
+/*      to build geometries, so an index built with other options       */
+/*      is rejected.                                                    */
+/************************************************************************/
+
+CPLString GMLReader::GetFeatureIndexSignature( const char* pszSRSName )
+{
+    CPLString osSignature;
+    osSignature.Printf("%d,%d,%d,%d,%d,%s",
+                       m_bInvertAxisOrderIfLatLong,
+                       m_bConsiderEPSGAsURN,
+                       m_bGetSecondaryGeometryOption,
+                       m_bFetchAllGeometries,
+                       m_bFaceHoleNegative,
+                       pszSRSName ? pszSRSName : "");
+    return osSignature;
+}
+
+/************************************************************************/
+/*                          LoadFeatureIndex()                          */
+/************************************************************************/
+
+int GMLReader::LoadFeatureIndex( const char* pszIndexFile,
+                                 const char* pszSRSName )
+{
+    VSIStatBufL sGMLStat, sIndexStat;
+    if( VSIStatL( m_pszFilename, &sGMLStat ) != 0 ||
+        VSIStatL( pszIndexFile, &sIndexStat ) != 0 )
+        return FALSE;
+
+    VSILFILE* fp = VSIFOpenL( pszIndexFile, "rb" );
+    if( fp == NULL )
+        return FALSE;
+
+/* -------------------------------------------------------------------- */
+/*      Check that the index matches the GML file and the options.      */
+/* -------------------------------------------------------------------- */
+    char szMagic[4];
+    CPLString osSignature;
+    GUIntBig nFileSize = 0, nMTime = 0;
+    GUInt32 nClassCount = 0;
+    int bOK = VSIFReadL(szMagic, 1, 4, fp) == 4 &&
+              memcmp(szMagic, GFI_MAGIC, 4) == 0 &&
+              GFIReadString(fp, osSignature) &&
+              osSignature == GetFeatureIndexSignature(pszSRSName) &&
+              GFIReadUInt64(fp, &nFileSize) &&
+              nFileSize == (GUIntBig)sGMLStat.st_size &&
+              GFIReadUInt64(fp, &nMTime) &&
+              nMTime == (GUIntBig)sGMLStat.st_mtime &&
+              GFIReadUInt32(fp, &nClassCount) &&
+              (int)nClassCount == m_nClassCount;
+
+    std::vector<GMLFeatureIndexClass> asClass;
+    for( int i = 0; bOK && i < m_nClassCount; i++ )
+    {
+        CPLString osName;
+        GUInt32 nStableFIDs = 0;
+        bOK = GFIReadString(fp, osName) &&
+              osName == m_papoClass[i]->GetName() &&
+              GFIReadUInt32(fp, &nStableFIDs);
+
+        GMLFeatureIndexClass sClass;
+        memset(&sClass, 0, sizeof(sClass));
+        sClass.bStableFIDs = (nStableFIDs != 0);
+        asClass.push_back(sClass);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Read the entries, and check that they are ordered and that      */
+/*      they fit in the file.                                           */
+/* -------------------------------------------------------------------- */
+    GUIntBig nEntryCount = 0;
+    if( bOK )
+        bOK = GFIReadUInt64(fp, &nEntryCount) &&
+              nEntryCount <= (GUIntBig)sIndexStat.st_size / GFI_ENTRY_SIZE;
+
+    std::vector<GMLFeatureIndexEntry> asEntries;
+    if( bOK )
+        asEntries.resize((size_t)nEntryCount);
+
+    GUIntBig nLastEnd = 0;
+    for( size_t i = 0; bOK && i < asEntries.size(); i++ )
+    {
+        GMLFeatureIndexEntry& sEntry = asEntries[i];
+        GUInt32 nClass = 0, nHasExtent = 0;
+        double adfExtent[4];
+
+        bOK = GFIReadUInt64(fp, &sEntry.nStartOffset) &&
+              GFIReadUInt64(fp, &sEntry.nEndOffset) &&
+              GFIReadUInt32(fp, &nClass) &&
+              GFIReadUInt32(fp, &nHasExtent) &&
+              VSIFReadL(adfExtent, 8, 4, fp) == 4;
+        if( !bOK )
+            break;
+
+        for( int j = 0; j < 4; j++ )
+            CPL_LSBPTR64(&adfExtent[j]);
+
+        sEntry.iClass = (int)nClass;
+        sEntry.bHasExtent = (nHasExtent != 0);
+        sEntry.dfXMin = adfExtent[0];
+        sEntry.dfXMax = adfExtent[1];
+        sEntry.dfYMin = adfExtent[2];
+        sEntry.dfYMax = adfExtent[3];
+
+        bOK = sEntry.nStartOffset >= nLastEnd &&
+              sEntry.nStartOffset < sEntry.nEndOffset &&
+              sEntry.nEndOffset <= nFileSize &&
+              nClass < nClassCount;
+        nLastEnd = sEntry.nEndOffset;
+    }
+
+    VSIFCloseL(fp);
+
+    if( !bOK )
+    {
+        CPLDebug("GML", "Ignoring %s : invalid or out of date.", pszIndexFile);
+        return FALSE;
+    }
+
+    m_asFeatureIndex.swap(asEntries);
+    m_asFeatureIndexClass.swap(asClass);
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          SaveFeatureIndex()                          */
+/************************************************************************/
+
+int GMLReader::SaveFeatureIndex( const char* pszIndexFile,
+                                 const char* pszSRSName )
+{
+    VSIStatBufL sGMLStat;
+    if( VSIStatL( m_pszFilename, &sGMLStat ) != 0 )
+        return FALSE;
+
+    VSILFILE* fp = VSIFOpenL( pszIndexFile, "wb" );
+    if( fp == NULL )
+        return FALSE;
+
+    int bOK = VSIFWriteL(GFI_MAGIC, 1, 4, fp) == 4 &&
+              GFIWriteString(fp, GetFeatureIndexSignature(pszSRSName)) &&
+              GFIWriteUInt64(fp, (GUIntBig)sGMLStat.st_size) &&
+              GFIWriteUInt64(fp, (GUIntBig)sGMLStat.st_mtime) &&
+              GFIWriteUInt32(fp, (GUInt32)m_nClassCount);
+
+    for( int i = 0; bOK && i < m_nClassCount; i++ )
+    {
+        bOK = GFIWriteString(fp, m_papoClass[i]->GetName()) &&
+              GFIWriteUInt32(fp, m_asFeatureIndexClass[i].bStableFIDs);
+    }
+
+    if( bOK )
+        bOK = GFIWriteUInt64(fp, (GUIntBig)m_asFeatureIndex.size());
+
+    for( size_t i = 0; bOK && i < m_asFeatureIndex.size(); i++ )
+    {
+        const GMLFeatureIndexEntry& sEntry = m_asFeatureIndex[i];
+        double adfExtent[4];
+
+        adfExtent[0] = sEntry.dfXMin;
+        adfExtent[1] = sEntry.dfXMax;
+        adfExtent[2] = sEntry.dfYMin;
+        adfExtent[3] = sEntry.dfYMax;
+        for( int j = 0; j < 4; j++ )
+            CPL_LSBPTR64(&adfExtent[j]);
+
+        bOK = GFIWriteUInt64(fp, sEntry.nStartOffset) &&
+              GFIWriteUInt64(fp, sEntry.nEndOffset) &&
+              GFIWriteUInt32(fp, (GUInt32)sEntry.iClass) &&
+              GFIWriteUInt32(fp, (GUInt32)sEntry.bHasExtent) &&
+              VSIFWriteL(adfExtent, 8, 4, fp) == 4;
+    }
+
+    VSIFCloseL(fp);
+
+    if( !bOK )
+        VSIUnlink(pszIndexFile);
+
+    return bOK;
+}
+
+/************************************************************************/
+/*                         BuildFeatureIndex()                          */
+/*                                                                      */
+/*      Parse the whole file. PushFeature() and PopState() record       */
+/*      the byte range of each feature in m_asFeatureIndex, in the      */
+/*      order in which the features are returned by NextFeature(),      */
+/*      and we complete the entries with the geometry extents.          */
+/************************************************************************/
+
+int GMLReader::BuildFeatureIndex( const char* pszSRSName )
+{
+    ResetReading();
+
+    m_asFeatureIndex.resize(0);
+    m_asFeatureIndexClass.resize(0);
+
+    std::vector<GMLFeatureIndexClass> asClass;
+    std::vector<CPLString> aosFIDPrefix;
+    std::vector<int> abSeen;
+    for( int i = 0; i < m_nClassCount; i++ )
+    {
+        GMLFeatureIndexClass sClass;
+        memset(&sClass, 0, sizeof(sClass));
+        sClass.bStableFIDs = TRUE;
+        asClass.push_back(sClass);
+        aosFIDPrefix.push_back("");
+        abSeen.push_back(FALSE);
+    }
+
+    void* hCacheSRS = GML_BuildOGRGeometryFromList_CreateCache();
+
+    /* Geometry errors will be reported when the features are really read */
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+
+    m_bBuildingFeatureIndex = TRUE;
+
+    GMLFeature *poFeature;
+    size_t iEntry = 0;
+    int bOK = TRUE;
+    while( (poFeature = NextFeature()) != NULL )
+    {
+        if( iEntry >= m_asFeatureIndex.size() ||
+            m_asFeatureIndex[iEntry].iClass < 0 ||
+            m_asFeatureIndex[iEntry].iClass >= m_nClassCount )
+        {
+            delete poFeature;
+            bOK = FALSE;
+            break;
+        }
+        GMLFeatureIndexEntry& sEntry = m_asFeatureIndex[iEntry++];
+        GMLFeatureClass *poClass = poFeature->GetClass();
+
+/* -------------------------------------------------------------------- */
+/*      Do the fids of the class keep the same prefix, followed by a    */
+/*      numeric part ?                                                  */
+/* -------------------------------------------------------------------- */
+        GMLFeatureIndexClass& sClass = asClass[sEntry.iClass];
+        const char* pszFID = poFeature->GetFID();
+        int nPrefixLen = (pszFID != NULL) ? GFIGetFIDPrefixLength(pszFID) : -1;
+        if( nPrefixLen < 0 )
+            sClass.bStableFIDs = FALSE;
+        else if( !abSeen[sEntry.iClass] )
+        {
+            aosFIDPrefix[sEntry.iClass].assign(pszFID, nPrefixLen);
+            abSeen[sEntry.iClass] = TRUE;
+        }
+        else if( aosFIDPrefix[sEntry.iClass].size() != (size_t)nPrefixLen ||
+                 strncmp(aosFIDPrefix[sEntry.iClass], pszFID, nPrefixLen) != 0 )
+            sClass.bStableFIDs = FALSE;
+
+/* -------------------------------------------------------------------- */
+/*      Compute the extent of the geometries the same way as            */
+/*      OGRGMLLayer::GetNextFeature(). The feature is only skippable    */
+/*      if all its geometries could be built and are not empty.         */
+/* -------------------------------------------------------------------- */
+        OGREnvelope sExtent;
+        int bHasExtent = FALSE;
+        const CPLXMLNode* const * papsGeometry = poFeature->GetGeometryList();
+        const CPLXMLNode* apsOneGeometry[2] = { NULL, NULL };
+        int nGeomCount = poClass->GetGeometryPropertyCount();
+        int nLists = ( nGeomCount > 1 ) ? nGeomCount : 1;
+
+        for( int i = 0; i < nLists; i++ )
+        {
+            const CPLXMLNode* const * papsList = papsGeometry;
+            if( nGeomCount > 1 )
+            {
+                apsOneGeometry[0] = poFeature->GetGeometryRef(i);
+                papsList = apsOneGeometry;
+            }
+            if( papsList == NULL || papsList[0] == NULL )
+            {
+                bHasExtent = FALSE;
+                break;
+            }
+
+            OGRGeometry* poGeom = GML_BuildOGRGeometryFromList(
+                papsList, TRUE, m_bInvertAxisOrderIfLatLong, pszSRSName,
+                m_bConsiderEPSGAsURN, m_bGetSecondaryGeometryOption,
+                hCacheSRS, m_bFaceHoleNegative );
+            if( poGeom == NULL || poGeom->IsEmpty() )
+            {
+                delete poGeom;
+                bHasExtent = FALSE;
+                break;
+            }
+
+            OGREnvelope sGeomExtent;
+            poGeom->getEnvelope(&sGeomExtent);
+            sExtent.Merge(sGeomExtent);
+            bHasExtent = TRUE;
+            delete poGeom;
+        }
+
+        sEntry.bHasExtent = bHasExtent;
+        if( bHasExtent )
+        {
+            sEntry.dfXMin = sExtent.MinX;
+            sEntry.dfXMax = sExtent.MaxX;
+            sEntry.dfYMin = sExtent.MinY;
+            sEntry.dfYMax = sExtent.MaxY;
+        }
+
+        delete poFeature;
+    }
+
+    m_bBuildingFeatureIndex = FALSE;
+
+    CPLPopErrorHandler();
+
+    GML_BuildOGRGeometryFromList_DestroyCache(hCacheSRS);
+
+    if( m_bStopParsing || iEntry != m_asFeatureIndex.size() )
+        bOK = FALSE;
+
+    ResetReading();
+
+    if( !bOK )
+    {
+        m_asFeatureIndex.resize(0);
+        return FALSE;
+    }
+
+    m_asFeatureIndexClass.swap(asClass);
+
+    return TRUE;
+}
+
+#endif /* HAVE_EXPAT */
+
+/************************************************************************/
+/*                         SetupFeatureIndex()                          */
+/*                                                                      */
+/*      Load the feature index from pszIndexFile if it is valid, or     */
+/*      build it, and save it if bSaveIndex is set. pszSRSName is       */
+/*      the SRS name the layers use to build geometries.                */
+/************************************************************************/
+
+int GMLReader::SetupFeatureIndex( CPL_UNUSED const char* pszIndexFile,
+                                  CPL_UNUSED int bSaveIndex,
+                                  CPL_UNUSED const char* pszSRSName )
+{
+#ifdef HAVE_EXPAT
+    /* Byte offsets are those of the Expat parser, and features nested */
+    /* in other elements can't be skipped safely */
+    if( !bUseExpatReader || m_bLookForClassAtAnyLevel ||
+        m_pszFilename == NULL )
+        return FALSE;
+
+    m_bUseFeatureIndex = FALSE;
+
+    if( !LoadFeatureIndex(pszIndexFile, pszSRSName) )
+    {
+        if( !BuildFeatureIndex(pszSRSName) )
+        {
+            CPLDebug("GML", "Cannot build feature index of %s", m_pszFilename);
+            return FALSE;
+        }
+
+        if( bSaveIndex && !SaveFeatureIndex(pszIndexFile, pszSRSName) )
+            CPLDebug("GML", "Cannot write %s", pszIndexFile);
+    }
+
+    CPLDebug("GML", "Using feature index with " CPL_FRMT_GUIB " features",
+             (GUIntBig)m_asFeatureIndex.size());
+
+    m_bUseFeatureIndex = TRUE;
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+/************************************************************************/
+/*                       SetClassSpatialFilter()                        */
+/*                                                                      */
+/*      Set the envelope of the spatial filter of the layer matching    */
+/*      poClass. Features whose extent does not intersect it will be    */
+/*      skipped.                                                        */
+/************************************************************************/
+
+void GMLReader::SetClassSpatialFilter( CPL_UNUSED GMLFeatureClass* poClass,
+                                       CPL_UNUSED int bHasFilter,
+                                       CPL_UNUSED double dfXMin,
+                                       CPL_UNUSED double dfXMax,
+                                       CPL_UNUSED double dfYMin,
+                                       CPL_UNUSED double dfYMax )
+{
+#ifdef HAVE_EXPAT
+    for( int i = 0; i < m_nClassCount &&
+                    i < (int)m_asFeatureIndexClass.size(); i++ )
+    {
+        if( m_papoClass[i] == poClass )
+        {
+            GMLFeatureIndexClass& sClass = m_asFeatureIndexClass[i];
+            sClass.bHasFilter = bHasFilter;
+            sClass.dfXMin = dfXMin;
+            sClass.dfXMax = dfXMax;
+            sClass.dfYMin = dfYMin;
+            sClass.dfYMax = dfYMax;
+            break;
+        }
+    }
+#endif
+}
+
+#ifdef HAVE_EXPAT
+
+/************************************************************************/
+/*                        IsOutsideClassFilter()                        */
+/*                                                                      */
+/*      Same test as the envelope test of OGRLayer::FilterGeometry().   */
+/************************************************************************/
+
+int GMLReader::IsOutsideClassFilter( const GMLFeatureIndexEntry& sEntry )
+{
+    const GMLFeatureIndexClass& sClass = m_asFeatureIndexClass[sEntry.iClass];
+
+    return sEntry.bHasExtent && sClass.bHasFilter &&
+           ( sEntry.dfXMax < sClass.dfXMin ||
+             sEntry.dfYMax < sClass.dfYMin ||
+             sClass.dfXMax < sEntry.dfXMin ||
+             sClass.dfYMax < sEntry.dfYMin );
+}
+
+/************************************************************************/
+/*                        CanSkipFeatureBytes()                         */
+/************************************************************************/
+
+int GMLReader::CanSkipFeatureBytes( const GMLFeatureIndexEntry& sEntry )
+{
+    /* Features of other classes than the filtered one would be ignored */
+    /* by the handler */
+    if( m_pszFilteredClassName != NULL )
+    {
+        const char* pszElementName =
+            m_papoClass[sEntry.iClass]->GetElementName();
+        const char* pszLastPipe = strrchr( pszElementName, '|' );
+        if ( pszLastPipe != NULL )
+            pszElementName = pszLastPipe + 1;
+        if( strcmp(pszElementName, m_pszFilteredClassName) != 0 )
+            return TRUE;
+    }
+
+    return m_asFeatureIndexClass[sEntry.iClass].bStableFIDs &&
+           IsOutsideClassFilter(sEntry);
+}
+
+/************************************************************************/
+/*                        SkipIndexedFeatures()                         */
+/*                                                                      */
+/*      Seek over the skippable features starting at the current        */
+/*      position, and return the number of bytes that can be read       */
+/*      before reaching the next skippable feature.                     */
+/************************************************************************/
+
+unsigned int GMLReader::SkipIndexedFeatures()
+{
+    GUIntBig nOffset = VSIFTellL(fpGML);
+
+    while( m_iFeatureIndexCursor < m_asFeatureIndex.size() )
+    {
+        const GMLFeatureIndexEntry& sEntry =
+            m_asFeatureIndex[m_iFeatureIndexCursor];
+        if( sEntry.nStartOffset >= nOffset + PARSER_BUF_SIZE )
+            break;
+        if( sEntry.nStartOffset < nOffset || !CanSkipFeatureBytes(sEntry) )
+        {
+            m_iFeatureIndexCursor++;
+            continue;
+        }
+        if( sEntry.nStartOffset > nOffset )
+            return (unsigned int)(sEntry.nStartOffset - nOffset);
+
+        if( VSIFSeekL(fpGML, sEntry.nEndOffset, SEEK_SET) != 0 )
+            break;
+        m_nSkippedBytes += sEntry.nEndOffset - nOffset;
+        m_nFeaturesNotParsed ++;
+        nOffset = sEntry.nEndOffset;
+        m_iFeatureIndexCursor++;
+    }
+
+    return PARSER_BUF_SIZE;
+}
+
+#endif /* HAVE_EXPAT */
@@ -581,6 +581,7 @@ OGRErr GMLHandler::startElement(const char *pszName, int nLenName, void* attr)
         case STATE_FEATUREPROPERTY:     eRet = startElementFeatureProperty(pszName, nLenName, attr); break;
         case STATE_GEOMETRY:            eRet = startElementGeometry(pszName, nLenName, attr); break;
         case STATE_IGNORED_FEATURE:     eRet = OGRERR_NONE; break;
+        case STATE_SKIPPED_FEATURE:     eRet = OGRERR_NONE; break;
         case STATE_BOUNDED_BY:          eRet = startElementBoundedBy(pszName, nLenName, attr); break;
         case STATE_CITYGML_ATTRIBUTE:   eRet = startElementCityGMLGenericAttr(pszName, nLenName, attr); break;
         default:                        eRet = OGRERR_NONE; break;
@@ -605,6 +606,7 @@ OGRErr GMLHandler::endElement()
         case STATE_FEATUREPROPERTY:     return endElementFeatureProperty(); break;
         case STATE_GEOMETRY:            return endElementGeometry(); break;
         case STATE_IGNORED_FEATURE:     return endElementIgnoredFeature(); break;
+        case STATE_SKIPPED_FEATURE:     return endElementSkippedFeature(); break;
         case STATE_BOUNDED_BY:          return endElementBoundedBy(); break;
         case STATE_CITYGML_ATTRIBUTE:   return endElementCityGMLGenericAttr(); break;
         default:                        return OGRERR_NONE; break;
@@ -626,6 +628,7 @@ OGRErr GMLHandler::dataHandler(const char *data, int nLen)
         case STATE_FEATUREPROPERTY:     return OGRERR_NONE; break;
         case STATE_GEOMETRY:            return dataHandlerGeometry(data, nLen); break;
         case STATE_IGNORED_FEATURE:     return OGRERR_NONE; break;
+        case STATE_SKIPPED_FEATURE:     return OGRERR_NONE; break;
         case STATE_BOUNDED_BY:          return OGRERR_NONE; break;
         case STATE_CITYGML_ATTRIBUTE:   return dataHandlerAttribute(data, nLen); break;
         default:                        return OGRERR_NONE; break;
@@ -1336,7 +1339,12 @@ OGRErr GMLHandler::startElementDefault(const char *pszName, int nLenName, void*
 
             m_nDepthFeature = m_nDepth;
 
-            PUSH_STATE(STATE_FEATURE);
+            /* The feature index tells us that this feature will be */
+            /* discarded by the spatial filter : don't collect its content */
+            if( m_poReader->GetState()->m_poFeature->IsOutsideSpatialFilter() )
+                PUSH_STATE(STATE_SKIPPED_FEATURE);
+            else
+                PUSH_STATE(STATE_FEATURE);
 
             return OGRERR_NONE;
         }
@@ -1364,6 +1372,22 @@ OGRErr GMLHandler::endElementIgnoredFeature()
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                      endElementSkippedFeature()                      */
+/************************************************************************/
+
+OGRErr GMLHandler::endElementSkippedFeature()
+
+{
+    if (m_nDepth == m_nDepthFeature)
+    {
+        m_poReader->PopState();
+
+        POP_STATE();
+    }
+    return OGRERR_NONE;
+}
+
 /************************************************************************/
 /*                         endElementBoundedBy()                        */
 /************************************************************************/
@@ -35,6 +35,7 @@
 #include "gmlreaderp.h"
 #include "cpl_conv.h"
 #include <map>
+#include <algorithm>
 #include "cpl_multiproc.h"
 
 #define SUPPORT_GEOMETRY
@@ -153,6 +154,16 @@ CPL_UNUSED
     nFeatureTabLength = 0;
     nFeatureTabAlloc = 0;
     pabyBuf = NULL;
+
+    m_bUseFeatureIndex = FALSE;
+    m_bBuildingFeatureIndex = FALSE;
+    m_iFeatureIndexCursor = 0;
+    m_nSkippedBytes = 0;
+    m_nFeaturesNotParsed = 0;
+    m_nFeaturesNotBuilt = 0;
+    m_nCurFeatureStart = 0;
+    m_nCurFeatureStartTagEnd = 0;
+    m_iCurFeatureClass = -1;
 #endif
     fpGML = NULL;
     m_bReadStarted = FALSE;
@@ -271,6 +282,11 @@ int GMLReader::SetupParser()
     if (fpGML != NULL)
         VSIFSeekL( fpGML, 0, SEEK_SET );
 
+#ifdef HAVE_EXPAT
+    m_iFeatureIndexCursor = 0;
+    m_nSkippedBytes = 0;
+#endif
+
     int bRet = -1;
 #ifdef HAVE_EXPAT
     if (bUseExpatReader)
@@ -463,6 +479,14 @@ void GMLReader::CleanupParser()
     nFeatureTabAlloc = 0;
     ppoFeatureTab = NULL;
 
+    if( m_nFeaturesNotParsed || m_nFeaturesNotBuilt )
+    {
+        CPLDebug("GML", "Feature index: " CPL_FRMT_GUIB " features not parsed, "
+                 CPL_FRMT_GUIB " features parsed but not built",
+                 m_nFeaturesNotParsed, m_nFeaturesNotBuilt);
+        m_nFeaturesNotParsed = 0;
+        m_nFeaturesNotBuilt = 0;
+    }
 #endif
 
     delete m_poGMLHandler;
@@ -619,8 +643,14 @@ GMLFeature *GMLReader::NextFeatureExpat()
         /* Reset counter that is used to detect billion laugh attacks */
         ((GMLExpatHandler*)m_poGMLHandler)->ResetDataHandlerCounter();
 
+        /* Do not feed the parser with features that the feature index */
+        /* tells us to be of no interest */
+        unsigned int nToRead = PARSER_BUF_SIZE;
+        if( m_bUseFeatureIndex )
+            nToRead = SkipIndexedFeatures();
+
         unsigned int nLen =
-                (unsigned int)VSIFReadL( pabyBuf, 1, PARSER_BUF_SIZE, fpGML );
+                (unsigned int)VSIFReadL( pabyBuf, 1, nToRead, fpGML );
         nDone = VSIFEofL(fpGML);
 
         /* Some files, such as APT_AIXM.xml from https://nfdc.faa.gov/webContent/56DaySub/2015-03-05/aixm5.1.zip */
@@ -664,6 +694,18 @@ GMLFeature *GMLReader::NextFeature()
     return NULL;
 }
 
+#ifdef HAVE_EXPAT
+/************************************************************************/
+/*                      GMLFeatureIndexEntryLess()                      */
+/************************************************************************/
+
+static bool GMLFeatureIndexEntryLess( const GMLFeatureIndexEntry& sA,
+                                      const GMLFeatureIndexEntry& sB )
+{
+    return sA.nStartOffset < sB.nStartOffset;
+}
+#endif
+
 /************************************************************************/
 /*                            PushFeature()                             */
 /*                                                                      */
@@ -720,6 +762,42 @@ void GMLReader::PushFeature( const char *pszElement,
         poFeature->SetFID( pszFID );
     }
 
+#ifdef HAVE_EXPAT
+/* -------------------------------------------------------------------- */
+/*      Record where the feature starts if we are building the          */
+/*      feature index, or check in the index if it is outside of the    */
+/*      spatial filter of its class.                                    */
+/* -------------------------------------------------------------------- */
+    if( bUseExpatReader && oParser != NULL &&
+        (m_bBuildingFeatureIndex || m_bUseFeatureIndex) &&
+        XML_GetCurrentByteIndex(oParser) >= 0 )
+    {
+        GUIntBig nOffset = (GUIntBig)XML_GetCurrentByteIndex(oParser);
+        if( m_bBuildingFeatureIndex )
+        {
+            m_nCurFeatureStart = nOffset;
+            m_nCurFeatureStartTagEnd = nOffset + XML_GetCurrentByteCount(oParser);
+            m_iCurFeatureClass = iClass;
+        }
+        else
+        {
+            GMLFeatureIndexEntry sKey;
+            sKey.nStartOffset = nOffset + m_nSkippedBytes;
+            std::vector<GMLFeatureIndexEntry>::iterator oIter =
+                std::lower_bound(m_asFeatureIndex.begin(),
+                                 m_asFeatureIndex.end(), sKey,
+                                 GMLFeatureIndexEntryLess);
+            if( oIter != m_asFeatureIndex.end() &&
+                oIter->nStartOffset == sKey.nStartOffset &&
+                oIter->iClass == iClass && IsOutsideClassFilter(*oIter) )
+            {
+                poFeature->SetOutsideSpatialFilter( TRUE );
+                m_nFeaturesNotBuilt ++;
+            }
+        }
+    }
+#endif
+
 /* -------------------------------------------------------------------- */
 /*      Create and push a new read state.                               */
 /* -------------------------------------------------------------------- */
@@ -955,6 +1033,21 @@ void GMLReader::PopState()
 #ifdef HAVE_EXPAT
         if ( bUseExpatReader && m_poState->m_poFeature != NULL )
         {
+            if( m_bBuildingFeatureIndex && oParser != NULL &&
+                XML_GetCurrentByteIndex(oParser) >= 0 )
+            {
+                /* For an empty element, the end tag is the start tag */
+                GMLFeatureIndexEntry sEntry;
+                memset(&sEntry, 0, sizeof(sEntry));
+                sEntry.nStartOffset = m_nCurFeatureStart;
+                sEntry.nEndOffset = (GUIntBig)XML_GetCurrentByteIndex(oParser) +
+                                    XML_GetCurrentByteCount(oParser);
+                if( sEntry.nEndOffset < m_nCurFeatureStartTagEnd )
+                    sEntry.nEndOffset = m_nCurFeatureStartTagEnd;
+                sEntry.iClass = m_iCurFeatureClass;
+                m_asFeatureIndex.push_back(sEntry);
+            }
+
             if (nFeatureTabLength >= nFeatureTabAlloc)
             {
                 nFeatureTabAlloc = nFeatureTabLength * 4 / 3 + 16;
@@ -238,6 +238,11 @@ class CPL_DLL GMLFeature
     // string list of named non-schema properties - used by NAS driver.
     char           **m_papszOBProperties;
 
+    // set when the feature index tells that the feature is outside of
+    // the spatial filter of its class. Properties and geometries are
+    // not collected.
+    int              m_bOutsideSpatialFilter;
+
 public:
                     GMLFeature( GMLFeatureClass * );
                    ~GMLFeature();
@@ -259,6 +264,9 @@ public:
 
     void             Dump( FILE *fp );
 
+    int              IsOutsideSpatialFilter() const { return m_bOutsideSpatialFilter; }
+    void             SetOutsideSpatialFilter( int bFlag ) { m_bOutsideSpatialFilter = bFlag; }
+
     // Out of Band property handling - special stuff like relations for NAS.
     void             AddOBProperty( const char *pszName, const char *pszValue );
     const char      *GetOBProperty( const char *pszName );
@@ -317,6 +325,16 @@ public:
     virtual const char* GetFilteredClassName() = 0;
 
     virtual int IsSequentialLayers() const { return FALSE; }
+
+    virtual int  SetupFeatureIndex( CPL_UNUSED const char* pszIndexFile,
+                                    CPL_UNUSED int bSaveIndex,
+                                    CPL_UNUSED const char* pszSRSName ) { return FALSE; }
+    virtual void SetClassSpatialFilter( CPL_UNUSED GMLFeatureClass* poClass,
+                                        CPL_UNUSED int bHasFilter,
+                                        CPL_UNUSED double dfXMin,
+                                        CPL_UNUSED double dfXMax,
+                                        CPL_UNUSED double dfYMin,
+                                        CPL_UNUSED double dfYMax ) {}
 };
 
 IGMLReader *CreateGMLReader(int bUseExpatParserPreferably,
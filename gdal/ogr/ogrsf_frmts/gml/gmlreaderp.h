@@ -35,6 +35,7 @@
 #include "ogr_api.h"
 #include "cpl_vsi.h"
 #include "cpl_multiproc.h"
+#include "cpl_string.h"
 
 #include <string>
 #include <vector>
@@ -86,6 +87,7 @@ typedef enum
     STATE_FEATUREPROPERTY,
     STATE_GEOMETRY,
     STATE_IGNORED_FEATURE,
+    STATE_SKIPPED_FEATURE,
     STATE_BOUNDED_BY,
     STATE_CITYGML_ATTRIBUTE
 } HandlerState;
@@ -143,6 +145,7 @@ class GMLHandler
     OGRErr     startElementTop(const char *pszName, int nLenName, void* attr);
 
     OGRErr     endElementIgnoredFeature();
+    OGRErr     endElementSkippedFeature();
 
     OGRErr     startElementBoundedBy(const char *pszName, int nLenName, void* attr);
     OGRErr     endElementBoundedBy();
@@ -378,6 +381,36 @@ public:
     int          m_nPathLength;
 };
 
+/************************************************************************/
+/*                         GMLFeatureIndexEntry                         */
+/*                                                                      */
+/*      One top-level feature of the .gfi feature index : its byte      */
+/*      range in the GML file, its class and the extent of its          */
+/*      geometries, when they could all be built.                       */
+/************************************************************************/
+
+typedef struct
+{
+    GUIntBig    nStartOffset;
+    GUIntBig    nEndOffset;
+    int         iClass;
+    int         bHasExtent;
+    double      dfXMin;
+    double      dfXMax;
+    double      dfYMin;
+    double      dfYMax;
+} GMLFeatureIndexEntry;
+
+typedef struct
+{
+    int         bStableFIDs;
+    int         bHasFilter;
+    double      dfXMin;
+    double      dfXMax;
+    double      dfYMin;
+    double      dfYMax;
+} GMLFeatureIndexClass;
+
 /************************************************************************/
 /*                              GMLReader                               */
 /************************************************************************/
@@ -425,6 +458,28 @@ private:
     int           SetupParserExpat();
     GMLFeature   *NextFeatureExpat();
     char         *pabyBuf;
+
+    int           m_bUseFeatureIndex;
+    int           m_bBuildingFeatureIndex;
+    std::vector<GMLFeatureIndexEntry> m_asFeatureIndex;
+    std::vector<GMLFeatureIndexClass> m_asFeatureIndexClass;
+    size_t        m_iFeatureIndexCursor;
+    GUIntBig      m_nSkippedBytes;
+    GUIntBig      m_nFeaturesNotParsed;
+    GUIntBig      m_nFeaturesNotBuilt;
+    GUIntBig      m_nCurFeatureStart;
+    GUIntBig      m_nCurFeatureStartTagEnd;
+    int           m_iCurFeatureClass;
+
+    CPLString     GetFeatureIndexSignature( const char* pszSRSName );
+    int           LoadFeatureIndex( const char* pszIndexFile,
+                                    const char* pszSRSName );
+    int           SaveFeatureIndex( const char* pszIndexFile,
+                                    const char* pszSRSName );
+    int           BuildFeatureIndex( const char* pszSRSName );
+    int           CanSkipFeatureBytes( const GMLFeatureIndexEntry& sEntry );
+    int           IsOutsideClassFilter( const GMLFeatureIndexEntry& sEntry );
+    unsigned int  SkipIndexedFeatures();
 #endif
 
     VSILFILE*     fpGML;
@@ -555,6 +610,14 @@ public:
     void             SetIsWFSJointLayer( int bFlag ) { m_bIsWFSJointLayer = bFlag; }
     int              IsWFSJointLayer() const { return m_bIsWFSJointLayer; }
 
+    int              SetupFeatureIndex( const char* pszIndexFile,
+                                        int bSaveIndex,
+                                        const char* pszSRSName );
+    void             SetClassSpatialFilter( GMLFeatureClass* poClass,
+                                            int bHasFilter,
+                                            double dfXMin, double dfXMax,
+                                            double dfYMin, double dfYMax );
+
     static CPLMutex* hMutex;
 };
 
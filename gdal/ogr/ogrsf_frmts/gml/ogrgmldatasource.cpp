@@ -1165,6 +1165,32 @@ int OGRGMLDataSource::Open( GDALOpenInfo* poOpenInfo )
         papoLayers[nLayers] = TranslateGMLSchema(poReader->GetClass(nLayers));
         nLayers++;
     }
+
+/* -------------------------------------------------------------------- */
+/*      Load or build the feature index (.gfi) if requested, so that    */
+/*      spatially filtered reads can skip the features outside of the   */
+/*      filter.                                                         */
+/* -------------------------------------------------------------------- */
+    if( CSLTestBoolean(CSLFetchNameValueDef(poOpenInfo->papszOpenOptions,
+                        "FEATURE_INDEX",
+                        CPLGetConfigOption("GML_FEATURE_INDEX", "NO"))) )
+    {
+        CPLString osGFIFilename = CPLResetExtension( pszFilename, "gfi" );
+        if (strncmp(osGFIFilename, "/vsigzip/", strlen("/vsigzip/")) == 0)
+            osGFIFilename = osGFIFilename.substr(strlen("/vsigzip/"));
+
+        int bSaveIndex =
+            !bOutIsTempFile &&
+            !EQUALN(pszFilename, "/vsitar/", strlen("/vsitar/")) &&
+            !EQUALN(pszFilename, "/vsizip/", strlen("/vsizip/")) &&
+            !EQUALN(pszFilename, "/vsigzip/vsi", strlen("/vsigzip/vsi")) &&
+            !EQUALN(pszFilename, "/vsigzip//vsi", strlen("/vsigzip//vsi")) &&
+            !EQUALN(pszFilename, "/vsicurl/", strlen("/vsicurl/")) &&
+            !EQUALN(pszFilename, "/vsicurl_streaming/", strlen("/vsicurl_streaming/"));
+
+        poReader->SetupFeatureIndex( osGFIFilename, bSaveIndex,
+                                     GetGlobalSRSName() );
+    }
     
 
     
@@ -164,6 +164,7 @@ void RegisterOGRGML()
 "<OpenOptionList>"
 "  <Option name='XSD' type='string' description='Name of the related application schema file (.xsd).'/>"
 "  <Option name='FORCE_SRS_DETECTION' type='boolean' description='Force a full scan to detect the SRS of layers.' default='NO'/>"
+"  <Option name='FEATURE_INDEX' type='boolean' description='Whether to use a .gfi feature index to skip features outside of spatial filters.' default='NO'/>"
 "</OpenOptionList>" );
 
         poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
@@ -111,6 +111,25 @@ void OGRGMLLayer::ResetReading()
     if (bWriter)
         return;
 
+    /* Let the reader know our spatial filter, so that it can skip the */
+    /* features that the feature index tells to be outside of it */
+    if( m_poFilterGeom != NULL &&
+        (poFeatureDefn->GetGeomFieldCount() <= 1 ||
+         (m_iGeomFieldFilter >= 0 &&
+          m_iGeomFieldFilter < poFeatureDefn->GetGeomFieldCount())) )
+    {
+        poDS->GetReader()->SetClassSpatialFilter( poFClass, TRUE,
+                                                  m_sFilterEnvelope.MinX,
+                                                  m_sFilterEnvelope.MaxX,
+                                                  m_sFilterEnvelope.MinY,
+                                                  m_sFilterEnvelope.MaxY );
+    }
+    else
+    {
+        poDS->GetReader()->SetClassSpatialFilter( poFClass, FALSE,
+                                                  0.0, 0.0, 0.0, 0.0 );
+    }
+
     if (poDS->GetReadMode() == INTERLEAVED_LAYERS ||
         poDS->GetReadMode() == SEQUENTIAL_LAYERS)
     {
@@ -269,6 +288,16 @@ OGRFeature *OGRGMLLayer::GetNextFeature()
             }
         }
 
+/* -------------------------------------------------------------------- */
+/*      The feature index already told that the feature does not        */
+/*      satisfy the spatial query.                                      */
+/* -------------------------------------------------------------------- */
+        if( poGMLFeature->IsOutsideSpatialFilter() )
+        {
+            delete poGMLFeature;
+            continue;
+        }
+
 /* -------------------------------------------------------------------- */
 /*      Does it satisfy the spatial query, if there is one?             */
 /* -------------------------------------------------------------------- */
@@ -33,6 +33,9 @@
 #include "ogrsf_frmts.h"
 #include "ogr_sqlite.h"
 #include "ogrgeopackageutility.h"
+#include "cpl_multiproc.h"
+
+#include <vector>
 
 #define UNKNOWN_SRID   -2
 #define DEFAULT_SRID    0
@@ -122,6 +125,10 @@ class GDALGeoPackageDataset : public OGRSQLiteBaseDataSource
 
     CPLString           m_osTilingScheme;
 
+#ifdef HAVE_SQLITE_VFS
+    sqlite3_vfs*        m_pWorkerVFS;
+#endif
+
         void            ComputeTileAndPixelShifts();
         int             InitRaster ( GDALGeoPackageDataset* poParentDS,
                                      const char* pszTableName,
@@ -245,6 +252,8 @@ class GDALGeoPackageDataset : public OGRSQLiteBaseDataSource
 
         virtual OGRErr      CommitTransaction();
         virtual OGRErr      RollbackTransaction();
+        int                 IsInTransaction() const { return bUserTransactionActive; }
+        sqlite3            *OpenWorkerConnection();
 
         int                 GetSrsId( const OGRSpatialReference * poSRS );
         const char*         GetSrsName( const OGRSpatialReference * poSRS );
@@ -305,6 +314,8 @@ class GDALGeoPackageRasterBand: public GDALPamRasterBand
 
 class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
 {
+    friend class OGRGeoPackageParallelScan;
+
   protected:
     GDALGeoPackageDataset *m_poDS;
 
@@ -313,6 +324,7 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
 
     sqlite3_stmt        *m_poQueryStatement;
     int                  bDoStep;
+    int                  bEOF;
 
     char                *m_pszFidColumn;
 
@@ -327,6 +339,9 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
                                            sqlite3_stmt *hStmt );
 
     OGRFeature*         TranslateFeature(sqlite3_stmt* hStmt);
+    OGRFeature*         TranslateRow(sqlite3_stmt* hStmt);
+    int                 TranslateFeatureToBatch(sqlite3_stmt* hStmt,
+                                                OGRFeatureBatch *poBatch);
 
   public:
 
@@ -347,10 +362,76 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
 
 };
 
+/************************************************************************/
+/*                       OGRGeoPackageParallelScan                      */
+/************************************************************************/
+
+class OGRGeoPackageParallelScan
+{
+    typedef struct
+    {
+        OGRGeoPackageParallelScan *poScan;
+        sqlite3                   *hDB;
+        sqlite3_stmt              *hStmt;
+        CPLJoinableThread         *hThread;
+    } Worker;
+
+    typedef struct
+    {
+        int                        nStatus;
+        int                        iChunk;
+        std::vector<OGRFeature*>   apoFeatures;
+        size_t                     iNext;
+        CPLString                  osError;
+    } Slot;
+
+    OGRGeoPackageLayer *poLayer;
+    int                 bOrdered;
+
+    GIntBig             nMinFID;
+    GIntBig             nMaxFID;
+    GIntBig             nChunkSize;
+    int                 nChunks;
+
+    int                 nWorkers;
+    Worker             *pasWorkers;
+    std::vector<Slot>   asSlots;
+
+    CPLMutex           *hMutex;
+    CPLCond            *hCond;
+    int                 nNextChunk;
+    int                 nChunksConsumed;
+    int                 iCurSlot;
+    volatile int        bStop;
+
+    static void         WorkerMain( void* pData );
+    void                RunWorker( Worker* psWorker );
+    void                ReleaseSlot( Slot& oSlot );
+
+  public:
+                        OGRGeoPackageParallelScan( OGRGeoPackageLayer* poLayer,
+                                                   int bOrdered );
+                       ~OGRGeoPackageParallelScan();
+
+    int                 Start( const char* pszSQL, int nThreads,
+                               GIntBig nMinFID, GIntBig nMaxFID );
+    OGRFeature*         GetNextFeature();
+};
+
 /************************************************************************/
 /*                        OGRGeoPackageTableLayer                       */
 /************************************************************************/
 
+typedef struct
+{
+    GIntBig     nId;
+    double      dfMinX;
+    double      dfMaxX;
+    double      dfMinY;
+    double      dfMaxY;
+    GUInt32     nHilbertCode;
+} GPkgRTreeEntry;
+
 class OGRGeoPackageTableLayer : public OGRGeoPackageLayer
 {
     char*                       m_pszTableName;
@@ -366,6 +447,8 @@ class OGRGeoPackageTableLayer : public OGRGeoPackageLayer
     int                         bDeferedSpatialIndexCreation;
     int                         m_bHasSpatialIndex;
     int                         bDropRTreeTable;
+    int                         m_bDeferredSpatialIndexUpdate;
+    std::vector<GPkgRTreeEntry> m_asRTreeEntries;
     int                         m_anHasGeometryExtension[wkbMultiSurface+1];
     int                         m_bPreservePrecision;
     int                         m_bTruncateFields;
@@ -376,7 +459,12 @@ class OGRGeoPackageTableLayer : public OGRGeoPackageLayer
     CPLString                   m_osDescriptionLCO;
     int                         m_bHasReadMetadataFromStorage;
 
+    int                         m_bParallelScanChecked;
+    OGRGeoPackageParallelScan*  m_poParallelScan;
+
     virtual OGRErr      ResetStatement();
+    void                StartParallelScanIfPossible();
+    OGRFeature*         GetNextParallelScanFeature();
     
     void                BuildWhere(void);
     OGRErr              RegisterGeometryColumn();
@@ -402,6 +490,8 @@ class OGRGeoPackageTableLayer : public OGRGeoPackageLayer
     OGRErr              SetAttributeFilter( const char *pszQuery );
     OGRErr              SyncToDisk();
     OGRFeature*         GetNextFeature();
+    virtual int         GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures );
     OGRFeature*         GetFeature(GIntBig nFID);
     OGRErr              StartTransaction();
     OGRErr              CommitTransaction();
@@ -423,6 +513,8 @@ class OGRGeoPackageTableLayer : public OGRGeoPackageLayer
                                 { bDeferedSpatialIndexCreation = bFlag; }
 
     void                CreateSpatialIndexIfNecessary();
+    OGRErr              FlushDeferredSpatialIndexUpdate();
+    void                CancelDeferredSpatialIndexUpdate();
     int                 CreateSpatialIndex();
     int                 DropSpatialIndex(int bCalledFromSQLFunction = FALSE);
 
@@ -456,6 +548,9 @@ class OGRGeoPackageTableLayer : public OGRGeoPackageLayer
     private:
     
     OGRErr              UpdateExtent( const OGREnvelope *poExtent );
+    OGRErr              CreateRTreeInsertTrigger();
+    OGRErr              FillRTreeFromTable();
+    OGRErr              InsertRTreeEntries();
     OGRErr              SaveExtent();
     OGRErr              BuildColumns();
     OGRBoolean          IsGeomFieldSet( OGRFeature *poFeature );
@@ -408,6 +408,9 @@ int GDALGeoPackageDataset::GetSrsId(const OGRSpatialReference * cpoSRS)
 GDALGeoPackageDataset::GDALGeoPackageDataset()
 {
     m_bNew = FALSE;
+#ifdef HAVE_SQLITE_VFS
+    m_pWorkerVFS = NULL;
+#endif
     m_papoLayers = NULL;
     m_nLayers = 0;
     m_bUtf8 = FALSE;
@@ -507,6 +510,15 @@ GDALGeoPackageDataset::~GDALGeoPackageDataset()
     CPLFree(m_pabyCachedTiles);
     delete m_poCT;
     CPLFree(m_pabyHugeColorArray);
+
+#ifdef HAVE_SQLITE_VFS
+    if( m_pWorkerVFS != NULL )
+    {
+        sqlite3_vfs_unregister(m_pWorkerVFS);
+        CPLFree(m_pWorkerVFS->pAppData);
+        CPLFree(m_pWorkerVFS);
+    }
+#endif
 }
 
 /************************************************************************/
@@ -3504,6 +3516,9 @@ OGRLayer * GDALGeoPackageDataset::ExecuteSQL( const char *pszSQLCommand,
     {
         m_papoLayers[i]->RunDeferredCreationIfNecessary();
         m_papoLayers[i]->CreateSpatialIndexIfNecessary();
+        /* The statement may read the R-Tree or end the transaction, */
+        /* so insert the pending envelopes and restore the trigger */
+        m_papoLayers[i]->FlushDeferredSpatialIndexUpdate();
     }
 
     if( pszDialect != NULL && EQUAL(pszDialect,"OGRSQL") )
@@ -4239,19 +4254,13 @@ void GPKG_GDAL_HasColorTable(sqlite3_context* pContext,
 }
 
 /************************************************************************/
-/*                         OpenOrCreateDB()                             */
+/*                    OGRGeoPackageRegisterSTFunctions()                */
+/*                                                                      */
+/*      Register the SQL functions that do not depend on the dataset.   */
 /************************************************************************/
 
-int GDALGeoPackageDataset::OpenOrCreateDB(int flags)
+static void OGRGeoPackageRegisterSTFunctions(sqlite3* hDB)
 {
-    int bSuccess = OGRSQLiteBaseDataSource::OpenOrCreateDB(flags, FALSE);
-    if( !bSuccess )
-        return FALSE;
-
-#ifdef SPATIALITE_412_OR_LATER
-    InitNewSpatialite();
-#endif
-
     /* Used by RTree Spatial Index Extension */
     sqlite3_create_function(hDB, "ST_MinX", 1, SQLITE_ANY, NULL,
                             OGRGeoPackageSTMinX, NULL, NULL);
@@ -4274,16 +4283,33 @@ int GDALGeoPackageDataset::OpenOrCreateDB(int flags)
     sqlite3_create_function(hDB, "ST_SRID", 1, SQLITE_ANY, NULL,
                             OGRGeoPackageSTSRID, NULL, NULL);
 
+    // HSTORE functions
+    sqlite3_create_function(hDB, "hstore_get_value", 2, SQLITE_ANY, NULL,
+                            GPKG_hstore_get_value, NULL, NULL);
+}
+
+/************************************************************************/
+/*                         OpenOrCreateDB()                             */
+/************************************************************************/
+
+int GDALGeoPackageDataset::OpenOrCreateDB(int flags)
+{
+    int bSuccess = OGRSQLiteBaseDataSource::OpenOrCreateDB(flags, FALSE);
+    if( !bSuccess )
+        return FALSE;
+
+#ifdef SPATIALITE_412_OR_LATER
+    InitNewSpatialite();
+#endif
+
+    OGRGeoPackageRegisterSTFunctions(hDB);
+
     /* Spatialite-like functions */
     sqlite3_create_function(hDB, "CreateSpatialIndex", 2, SQLITE_ANY, this,
                             OGRGeoPackageCreateSpatialIndex, NULL, NULL);
     sqlite3_create_function(hDB, "DisableSpatialIndex", 2, SQLITE_ANY, this,
                             OGRGeoPackageDisableSpatialIndex, NULL, NULL);
 
-    // HSTORE functions
-    sqlite3_create_function(hDB, "hstore_get_value", 2, SQLITE_ANY, NULL,
-                            GPKG_hstore_get_value, NULL, NULL);
-    
     // Debug functions
     if( CSLTestBoolean(CPLGetConfigOption("GPKG_DEBUG", "FALSE")) )
     {
@@ -4298,6 +4324,52 @@ int GDALGeoPackageDataset::OpenOrCreateDB(int flags)
     return TRUE;
 }
 
+/************************************************************************/
+/*                        OpenWorkerConnection()                        */
+/*                                                                      */
+/*      Open an additional read-only connection on the database, to    */
+/*      be used by a worker thread.  Files accessed through the VSI     */
+/*      layer use a VFS distinct from the one of the main connection,   */
+/*      so that they do not interfere with the tracking of the main     */
+/*      file handle.                                                    */
+/************************************************************************/
+
+sqlite3 *GDALGeoPackageDataset::OpenWorkerConnection()
+{
+    sqlite3* hWorkerDB = NULL;
+    int rc;
+
+#ifdef HAVE_SQLITE_VFS
+    const char* pszVFSName = NULL;
+    if( pMyVFS != NULL )
+    {
+        if( m_pWorkerVFS == NULL )
+        {
+            m_pWorkerVFS = OGRSQLiteCreateVFS(NULL, NULL);
+            sqlite3_vfs_register(m_pWorkerVFS, 0);
+        }
+        pszVFSName = m_pWorkerVFS->zName;
+    }
+    rc = sqlite3_open_v2( m_pszFilename, &hWorkerDB,
+                          SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+                          pszVFSName );
+#else
+    rc = sqlite3_open( m_pszFilename, &hWorkerDB );
+#endif
+    if( rc != SQLITE_OK )
+    {
+        CPLError( CE_Failure, CPLE_OpenFailed,
+                  "sqlite3_open(%s) failed: %s",
+                  m_pszFilename, sqlite3_errmsg( hWorkerDB ) );
+        sqlite3_close( hWorkerDB );
+        return NULL;
+    }
+
+    OGRGeoPackageRegisterSTFunctions(hWorkerDB);
+
+    return hWorkerDB;
+}
+
 /************************************************************************/
 /*                   GetLayerWithGetSpatialWhereByName()                */
 /************************************************************************/
@@ -4322,6 +4394,7 @@ OGRErr GDALGeoPackageDataset::CommitTransaction()
         for( int i = 0; i < m_nLayers; i++ )
         {
             m_papoLayers[i]->RunDeferredCreationIfNecessary();
+            m_papoLayers[i]->FlushDeferredSpatialIndexUpdate();
         }
     }
 
@@ -4340,6 +4413,8 @@ OGRErr GDALGeoPackageDataset::RollbackTransaction()
         FlushMetadata();
         for( int i = 0; i < m_nLayers; i++ )
         {
+            /* The rollback restores the R-Tree insert trigger */
+            m_papoLayers[i]->CancelDeferredSpatialIndexUpdate();
             m_papoLayers[i]->RunDeferredCreationIfNecessary();
             m_papoLayers[i]->CreateSpatialIndexIfNecessary();
             m_papoLayers[i]->ResetReading();
@@ -42,6 +42,7 @@ OGRGeoPackageLayer::OGRGeoPackageLayer(GDALGeoPackageDataset *poDS) : m_poDS(poD
     iNextShapeId = 0;
     m_poQueryStatement = NULL;
     bDoStep = TRUE;
+    bEOF = FALSE;
     m_pszFidColumn = NULL;
     iFIDCol = -1;
     iGeomCol = -1;
@@ -76,6 +77,7 @@ void OGRGeoPackageLayer::ResetReading()
 {
     ClearStatement();
     iNextShapeId = 0;
+    bEOF = FALSE;
 }
 
 /************************************************************************/
@@ -100,6 +102,9 @@ void OGRGeoPackageLayer::ClearStatement()
 OGRFeature *OGRGeoPackageLayer::GetNextFeature()
 
 {
+    if( bEOF )
+        return NULL;
+
     for( ; TRUE; )
     {
         OGRFeature      *poFeature;
@@ -130,6 +135,7 @@ OGRFeature *OGRGeoPackageLayer::GetNextFeature()
                 }
 
                 ClearStatement();
+                bEOF = TRUE;
 
                 return NULL;
             }
@@ -157,6 +163,30 @@ OGRFeature *OGRGeoPackageLayer::GetNextFeature()
 
 OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
 
+{
+    OGRFeature *poFeature = TranslateRow( hStmt );
+
+    if( iFIDCol < 0 )
+        poFeature->SetFID( iNextShapeId );
+
+    iNextShapeId++;
+
+    m_nFeaturesRead++;
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                            TranslateRow()                            */
+/*                                                                      */
+/*      Create a feature from the current result row.  The layer        */
+/*      state is not modified, so that this can be called from the      */
+/*      worker threads of a parallel scan, each one with its own        */
+/*      statement.                                                      */
+/************************************************************************/
+
+OGRFeature *OGRGeoPackageLayer::TranslateRow( sqlite3_stmt* hStmt )
+
 {
 
 /* -------------------------------------------------------------------- */
@@ -170,12 +200,6 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
 /* -------------------------------------------------------------------- */
     if( iFIDCol >= 0 )
         poFeature->SetFID( sqlite3_column_int64( hStmt, iFIDCol ) );
-    else
-        poFeature->SetFID( iNextShapeId );
-
-    iNextShapeId++;
-
-    m_nFeaturesRead++;
 
 /* -------------------------------------------------------------------- */
 /*      Process Geometry if we have a column.                           */
@@ -269,6 +293,142 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
     return poFeature;
 }
 
+/************************************************************************/
+/*                      TranslateFeatureToBatch()                       */
+/*                                                                      */
+/*      Same as TranslateFeature(), but append the current result       */
+/*      row to a feature batch.  The geometry blob is copied as it      */
+/*      is once its GeoPackage header is skipped.                       */
+/************************************************************************/
+
+int OGRGeoPackageLayer::TranslateFeatureToBatch( sqlite3_stmt* hStmt,
+                                                 OGRFeatureBatch *poBatch )
+
+{
+    GIntBig nFID;
+    if( iFIDCol >= 0 )
+        nFID = sqlite3_column_int64( hStmt, iFIDCol );
+    else
+        nFID = iNextShapeId;
+
+    if( !poBatch->BeginFeature( nFID ) )
+        return FALSE;
+
+    iNextShapeId++;
+
+    m_nFeaturesRead++;
+
+/* -------------------------------------------------------------------- */
+/*      Process Geometry if we have a column.                           */
+/* -------------------------------------------------------------------- */
+    if( iGeomCol >= 0 &&
+        sqlite3_column_type(hStmt, iGeomCol) != SQLITE_NULL &&
+        !m_poFeatureDefn->GetGeomFieldDefn(0)->IsIgnored() )
+    {
+        int iGpkgSize = sqlite3_column_bytes(hStmt, iGeomCol);
+        const GByte *pabyGpkg = (const GByte *)
+                                    sqlite3_column_blob(hStmt, iGeomCol);
+        GPkgHeader oHeader;
+
+        if( iGpkgSize < 8 ||
+            GPkgHeaderFromWKB(pabyGpkg, &oHeader) != OGRERR_NONE ||
+            (int)oHeader.szHeader >= iGpkgSize )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined, "Unable to read geometry");
+        }
+        else
+        {
+            size_t nWKBSize = iGpkgSize - oHeader.szHeader;
+            GByte *pabyWKB = poBatch->ReserveGeomFieldWKB( 0, nWKBSize );
+            if( pabyWKB == NULL )
+                return FALSE;
+            memcpy( pabyWKB, pabyGpkg + oHeader.szHeader, nWKBSize );
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      set the fields.                                                 */
+/* -------------------------------------------------------------------- */
+    for( int iField = 0; iField < m_poFeatureDefn->GetFieldCount(); iField++ )
+    {
+        OGRFieldDefn *poFieldDefn = m_poFeatureDefn->GetFieldDefn( iField );
+        if ( poFieldDefn->IsIgnored() )
+            continue;
+
+        int iRawField = panFieldOrdinals[iField];
+
+        if( sqlite3_column_type( hStmt, iRawField ) == SQLITE_NULL )
+            continue;
+
+        switch( poFieldDefn->GetType() )
+        {
+            case OFTInteger:
+                poBatch->SetFieldInteger( iField,
+                    sqlite3_column_int( hStmt, iRawField ) );
+                break;
+
+            case OFTInteger64:
+                poBatch->SetFieldInteger64( iField,
+                    sqlite3_column_int64( hStmt, iRawField ) );
+                break;
+
+            case OFTReal:
+                poBatch->SetFieldDouble( iField,
+                    sqlite3_column_double( hStmt, iRawField ) );
+                break;
+
+            case OFTBinary:
+            {
+                const void *pData = sqlite3_column_blob( hStmt, iRawField );
+                const int nBytes = sqlite3_column_bytes( hStmt, iRawField );
+                if( !poBatch->SetFieldBinary( iField, pData, nBytes ) )
+                    return FALSE;
+                break;
+            }
+
+            case OFTDate:
+            {
+                const char* pszTxt = (const char*)sqlite3_column_text( hStmt, iRawField );
+                OGRField sField;
+                memset( &sField, 0, sizeof(sField) );
+                int nYear, nMonth, nDay;
+                if( sscanf(pszTxt, "%d-%d-%d", &nYear, &nMonth, &nDay) == 3 )
+                {
+                    sField.Date.Year = (GInt16)nYear;
+                    sField.Date.Month = (GByte)nMonth;
+                    sField.Date.Day = (GByte)nDay;
+                    poBatch->SetFieldDateTime( iField, &sField );
+                }
+                break;
+            }
+
+            case OFTDateTime:
+            {
+                const char* pszTxt = (const char*)sqlite3_column_text( hStmt, iRawField );
+                OGRField sField;
+                if( OGRParseXMLDateTime(pszTxt, &sField) )
+                    poBatch->SetFieldDateTime( iField, &sField );
+                break;
+            }
+
+            case OFTString:
+            {
+                const char *pszTxt = (const char *)
+                                    sqlite3_column_text( hStmt, iRawField );
+                const int nBytes = sqlite3_column_bytes( hStmt, iRawField );
+                if( !poBatch->SetFieldBinary( iField, pszTxt, nBytes ) )
+                    return FALSE;
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                      GetFIDColumn()                                  */
 /************************************************************************/
@@ -0,0 +1,338 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GeoPackage Translator
+ * Purpose:  Implements OGRGeoPackageParallelScan class, which reads the
+ *           rows of a table by FID ranges in several worker threads.
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_geopackage.h"
+
+/* Maximum number of FIDs covered by a chunk */
+#define MAX_CHUNK_SIZE          16384
+
+/* Maximum number of chunks, for tables with very sparse FIDs */
+#define MAX_CHUNK_COUNT         65536
+
+/* Number of chunks that can be read ahead, per worker */
+#define SLOTS_PER_WORKER        2
+
+#define SLOT_FREE               0
+#define SLOT_READING            1
+#define SLOT_READY              2
+
+/************************************************************************/
+/*                     OGRGeoPackageParallelScan()                      */
+/************************************************************************/
+
+OGRGeoPackageParallelScan::OGRGeoPackageParallelScan(
+                            OGRGeoPackageLayer* poLayerIn, int bOrderedIn )
+{
+    poLayer = poLayerIn;
+    bOrdered = bOrderedIn;
+    nMinFID = 0;
+    nMaxFID = 0;
+    nChunkSize = 0;
+    nChunks = 0;
+    nWorkers = 0;
+    pasWorkers = NULL;
+    hMutex = NULL;
+    hCond = NULL;
+    nNextChunk = 0;
+    nChunksConsumed = 0;
+    iCurSlot = -1;
+    bStop = FALSE;
+}
+
+/************************************************************************/
+/*                     ~OGRGeoPackageParallelScan()                     */
+/************************************************************************/
+
+OGRGeoPackageParallelScan::~OGRGeoPackageParallelScan()
+{
+    int i;
+
+    if( hMutex != NULL && hCond != NULL )
+    {
+        CPLAcquireMutex(hMutex, 1000.0);
+        bStop = TRUE;
+        CPLCondBroadcast(hCond);
+        CPLReleaseMutex(hMutex);
+    }
+
+    for( i = 0; i < nWorkers; i++ )
+    {
+        if( pasWorkers[i].hThread != NULL )
+            CPLJoinThread(pasWorkers[i].hThread);
+        if( pasWorkers[i].hStmt != NULL )
+            sqlite3_finalize(pasWorkers[i].hStmt);
+        if( pasWorkers[i].hDB != NULL )
+            sqlite3_close(pasWorkers[i].hDB);
+    }
+    CPLFree(pasWorkers);
+
+    for( size_t iSlot = 0; iSlot < asSlots.size(); iSlot++ )
+        ReleaseSlot(asSlots[iSlot]);
+
+    if( hCond != NULL )
+        CPLDestroyCond(hCond);
+    if( hMutex != NULL )
+        CPLDestroyMutex(hMutex);
+}
+
+/************************************************************************/
+/*                             ReleaseSlot()                            */
+/************************************************************************/
+
+void OGRGeoPackageParallelScan::ReleaseSlot( Slot& oSlot )
+{
+    for( size_t i = oSlot.iNext; i < oSlot.apoFeatures.size(); i++ )
+        delete oSlot.apoFeatures[i];
+    std::vector<OGRFeature*>().swap(oSlot.apoFeatures);
+    oSlot.iNext = 0;
+    oSlot.osError = "";
+    oSlot.nStatus = SLOT_FREE;
+}
+
+/************************************************************************/
+/*                                Start()                               */
+/*                                                                      */
+/*      pszSQL must select the layer columns, with two parameters      */
+/*      for the bounds of the FID range.                                */
+/************************************************************************/
+
+int OGRGeoPackageParallelScan::Start( const char* pszSQL, int nThreads,
+                                      GIntBig nMinFIDIn, GIntBig nMaxFIDIn )
+{
+    int i;
+
+    nMinFID = nMinFIDIn;
+    nMaxFID = nMaxFIDIn;
+
+/* -------------------------------------------------------------------- */
+/*      Split the FID range in chunks small enough for their features   */
+/*      to be held in memory, but big enough to keep all workers busy.  */
+/* -------------------------------------------------------------------- */
+    GIntBig nRange = nMaxFID - nMinFID + 1;
+    nChunkSize = nRange / (nThreads * 4);
+    if( nChunkSize > MAX_CHUNK_SIZE )
+        nChunkSize = MAX_CHUNK_SIZE;
+    if( nChunkSize < 1 )
+        nChunkSize = 1;
+    if( nRange / nChunkSize >= MAX_CHUNK_COUNT )
+        nChunkSize = nRange / MAX_CHUNK_COUNT + 1;
+    nChunks = (int)((nRange + nChunkSize - 1) / nChunkSize);
+    if( nThreads > nChunks )
+        nThreads = nChunks;
+
+/* -------------------------------------------------------------------- */
+/*      Open a connection per worker.                                   */
+/* -------------------------------------------------------------------- */
+    pasWorkers = (Worker*) CPLCalloc(nThreads, sizeof(Worker));
+    for( i = 0; i < nThreads; i++ )
+    {
+        Worker* psWorker = pasWorkers + nWorkers;
+        psWorker->poScan = this;
+        psWorker->hDB = poLayer->m_poDS->OpenWorkerConnection();
+        if( psWorker->hDB == NULL )
+            return FALSE;
+        nWorkers ++;
+
+        int rc = sqlite3_prepare_v2( psWorker->hDB, pszSQL, -1,
+                                     &(psWorker->hStmt), NULL );
+        if( rc != SQLITE_OK )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "failed to prepare SQL %s: %s",
+                      pszSQL, sqlite3_errmsg(psWorker->hDB) );
+            psWorker->hStmt = NULL;
+            return FALSE;
+        }
+    }
+
+    asSlots.resize(nWorkers * SLOTS_PER_WORKER);
+    for( size_t iSlot = 0; iSlot < asSlots.size(); iSlot++ )
+    {
+        asSlots[iSlot].nStatus = SLOT_FREE;
+        asSlots[iSlot].iChunk = -1;
+        asSlots[iSlot].iNext = 0;
+    }
+
+    hMutex = CPLCreateMutex();
+    CPLReleaseMutex(hMutex);
+    hCond = CPLCreateCond();
+    if( hCond == NULL )
+        return FALSE;
+
+    for( i = 0; i < nWorkers; i++ )
+    {
+        pasWorkers[i].hThread = CPLCreateJoinableThread( WorkerMain,
+                                                         pasWorkers + i );
+        if( pasWorkers[i].hThread == NULL )
+            return FALSE;
+    }
+
+    CPLDebug( "GPKG", "Parallel scan of %s with %d threads, %d chunks of "
+              CPL_FRMT_GIB " FIDs",
+              poLayer->GetName(), nWorkers, nChunks, nChunkSize );
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                             WorkerMain()                             */
+/************************************************************************/
+
+void OGRGeoPackageParallelScan::WorkerMain( void* pData )
+{
+    Worker* psWorker = (Worker*) pData;
+    psWorker->poScan->RunWorker(psWorker);
+}
+
+/************************************************************************/
+/*                             RunWorker()                              */
+/*                                                                      */
+/*      Chunk i is read into slot i modulo the number of slots, once    */
+/*      the features of the chunk that used it before have all been     */
+/*      fetched.  This bounds the number of features held in memory.    */
+/************************************************************************/
+
+void OGRGeoPackageParallelScan::RunWorker( Worker* psWorker )
+{
+    const int nSlots = (int) asSlots.size();
+
+    CPLAcquireMutex(hMutex, 1000.0);
+    while( TRUE )
+    {
+        while( !bStop && nNextChunk < nChunks &&
+               asSlots[nNextChunk % nSlots].nStatus != SLOT_FREE )
+            CPLCondWait(hCond, hMutex);
+        if( bStop || nNextChunk >= nChunks )
+            break;
+
+        const int iChunk = nNextChunk ++;
+        Slot& oSlot = asSlots[iChunk % nSlots];
+        oSlot.nStatus = SLOT_READING;
+        oSlot.iChunk = iChunk;
+        CPLReleaseMutex(hMutex);
+
+/* -------------------------------------------------------------------- */
+/*      Read the chunk outside of the lock.                             */
+/* -------------------------------------------------------------------- */
+        GIntBig nStart = nMinFID + iChunk * nChunkSize;
+        GIntBig nEnd = (nMaxFID - nStart < nChunkSize) ? nMaxFID :
+                                                nStart + nChunkSize - 1;
+        sqlite3_bind_int64(psWorker->hStmt, 1, nStart);
+        sqlite3_bind_int64(psWorker->hStmt, 2, nEnd);
+
+        int rc = SQLITE_DONE;
+        while( !bStop && (rc = sqlite3_step(psWorker->hStmt)) == SQLITE_ROW )
+        {
+            oSlot.apoFeatures.push_back(
+                            poLayer->TranslateRow(psWorker->hStmt) );
+        }
+        if( !bStop && rc != SQLITE_DONE )
+        {
+            oSlot.osError.Printf( "sqlite3_step() : %s",
+                                  sqlite3_errmsg(psWorker->hDB) );
+        }
+        sqlite3_reset(psWorker->hStmt);
+
+        CPLAcquireMutex(hMutex, 1000.0);
+        oSlot.nStatus = SLOT_READY;
+        CPLCondBroadcast(hCond);
+    }
+    CPLReleaseMutex(hMutex);
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/*                                                                      */
+/*      Returns the next feature read by the workers, in FID order      */
+/*      if the scan is ordered, or else in the order chunks are         */
+/*      completed.  Filters are not applied.                            */
+/************************************************************************/
+
+OGRFeature *OGRGeoPackageParallelScan::GetNextFeature()
+{
+    const int nSlots = (int) asSlots.size();
+
+    while( TRUE )
+    {
+        if( iCurSlot >= 0 )
+        {
+            Slot& oSlot = asSlots[iCurSlot];
+            if( oSlot.iNext < oSlot.apoFeatures.size() )
+                return oSlot.apoFeatures[oSlot.iNext ++];
+
+            CPLAcquireMutex(hMutex, 1000.0);
+            ReleaseSlot(oSlot);
+            nChunksConsumed ++;
+            CPLCondBroadcast(hCond);
+            CPLReleaseMutex(hMutex);
+            iCurSlot = -1;
+        }
+
+        if( nChunksConsumed == nChunks )
+            return NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Wait for the next chunk to be read.                             */
+/* -------------------------------------------------------------------- */
+        CPLAcquireMutex(hMutex, 1000.0);
+        while( iCurSlot < 0 )
+        {
+            if( bOrdered )
+            {
+                int iSlot = nChunksConsumed % nSlots;
+                if( asSlots[iSlot].nStatus == SLOT_READY &&
+                    asSlots[iSlot].iChunk == nChunksConsumed )
+                    iCurSlot = iSlot;
+            }
+            else
+            {
+                for( int iSlot = 0; iSlot < nSlots; iSlot++ )
+                {
+                    if( asSlots[iSlot].nStatus == SLOT_READY )
+                    {
+                        iCurSlot = iSlot;
+                        break;
+                    }
+                }
+            }
+            if( iCurSlot < 0 )
+                CPLCondWait(hCond, hMutex);
+        }
+        CPLReleaseMutex(hMutex);
+
+        if( asSlots[iCurSlot].osError.size() )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "In GetNextFeature(): %s",
+                      asSlots[iCurSlot].osError.c_str() );
+            nChunksConsumed = nChunks;
+            return NULL;
+        }
+    }
+}
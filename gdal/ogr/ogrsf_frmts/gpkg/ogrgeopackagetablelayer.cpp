@@ -33,6 +33,12 @@
 #include "cpl_time.h"
 #include "ogr_p.h"
 
+#include <algorithm>
+
+/* Maximum number of R-Tree entries accumulated in memory before being */
+/* inserted into the R-Tree */
+#define MAX_PENDING_RTREE_ENTRIES   (1024 * 1024)
+
 //----------------------------------------------------------------------
 // SaveExtent()
 // 
@@ -849,12 +855,15 @@ OGRGeoPackageTableLayer::OGRGeoPackageTableLayer(
     bDeferedSpatialIndexCreation = FALSE;
     m_bHasSpatialIndex = -1;
     bDropRTreeTable = FALSE;
+    m_bDeferredSpatialIndexUpdate = FALSE;
     memset(m_anHasGeometryExtension, 0, sizeof(m_anHasGeometryExtension));
     m_bPreservePrecision = TRUE;
     m_bTruncateFields = FALSE;
     m_bDeferredCreation = FALSE;
     m_iFIDAsRegularColumnIndex = -1;
     m_bHasReadMetadataFromStorage = FALSE;
+    m_bParallelScanChecked = FALSE;
+    m_poParallelScan = NULL;
 }
 
 
@@ -864,6 +873,8 @@ OGRGeoPackageTableLayer::OGRGeoPackageTableLayer(
 
 OGRGeoPackageTableLayer::~OGRGeoPackageTableLayer()
 {
+    delete m_poParallelScan;
+
     if( m_bDeferredCreation )
         RunDeferredCreationIfNecessary();
 
@@ -1136,6 +1147,22 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
         }
     }
 
+    /* Within a transaction, the R-Tree insert trigger is disabled and the */
+    /* envelopes of the new features are inserted at commit time, in a */
+    /* spatially sorted order. */
+    if( !m_bDeferredSpatialIndexUpdate && !bDeferedSpatialIndexCreation &&
+        m_poDS->IsInTransaction() && HasSpatialIndex() &&
+        CSLTestBoolean(CPLGetConfigOption("OGR_GPKG_DEFERRED_SPATIAL_INDEX_UPDATE", "YES")) )
+    {
+        const char* pszT = m_pszTableName;
+        const char* pszC = m_poFeatureDefn->GetGeomFieldDefn(0)->GetNameRef();
+        char* pszSQL = sqlite3_mprintf("DROP TRIGGER \"rtree_%s_%s_insert\"",
+                                       pszT, pszC);
+        if( SQLCommand(m_poDS->GetDB(), pszSQL) == OGRERR_NONE )
+            m_bDeferredSpatialIndexUpdate = TRUE;
+        sqlite3_free(pszSQL);
+    }
+
     /* If there's a unset field with a default value, then we must create */
     /* a specific INSERT statement to avoid unset fields to be bound to NULL */
     if( m_poInsertStatement && (bHasDefaultValue || m_bInsertStatementWithFID != (poFeature->GetFID() != OGRNullFID)) )
@@ -1200,11 +1227,13 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
     }
 
     /* Update the layer extents with this new object */
+    OGREnvelope oEnv;
+    int bHasEnvelope = FALSE;
     if ( IsGeomFieldSet(poFeature) )
     {
-        OGREnvelope oEnv;
         poFeature->GetGeomFieldRef(0)->getEnvelope(&oEnv);
         UpdateExtent(&oEnv);
+        bHasEnvelope = !poFeature->GetGeomFieldRef(0)->IsEmpty();
     }
 
     /* Read the latest FID value */
@@ -1219,6 +1248,22 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
     {
         poFeature->SetFID(OGRNullFID);
     }
+
+    /* Do what the R-Tree insert trigger would have done */
+    if( m_bDeferredSpatialIndexUpdate && bHasEnvelope )
+    {
+        GPkgRTreeEntry sEntry;
+        sEntry.nId = nFID;
+        sEntry.dfMinX = oEnv.MinX;
+        sEntry.dfMaxX = oEnv.MaxX;
+        sEntry.dfMinY = oEnv.MinY;
+        sEntry.dfMaxY = oEnv.MaxY;
+        sEntry.nHilbertCode = 0;
+        m_asRTreeEntries.push_back(sEntry);
+        if( m_asRTreeEntries.size() >= MAX_PENDING_RTREE_ENTRIES &&
+            InsertRTreeEntries() != OGRERR_NONE )
+            return OGRERR_FAILURE;
+    }
     
     /* All done! */
     return OGRERR_NONE;
@@ -1259,6 +1304,10 @@ OGRErr OGRGeoPackageTableLayer::ISetFeature( OGRFeature *poFeature )
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return OGRERR_FAILURE;
 
+    /* The update triggers must see the R-Tree entries of all created features */
+    if( m_bDeferredSpatialIndexUpdate && InsertRTreeEntries() != OGRERR_NONE )
+        return OGRERR_FAILURE;
+
     /* Old version of SQLite have issues with some of the spatial index triggers */
 #if SQLITE_VERSION_NUMBER < 3007008
     if( HasSpatialIndex() )
@@ -1393,6 +1442,10 @@ void OGRGeoPackageTableLayer::ResetReading()
 
     OGRGeoPackageLayer::ResetReading();
 
+    delete m_poParallelScan;
+    m_poParallelScan = NULL;
+    m_bParallelScanChecked = FALSE;
+
     if ( m_poInsertStatement )
     {
         sqlite3_finalize(m_poInsertStatement);
@@ -1419,6 +1472,10 @@ OGRErr OGRGeoPackageTableLayer::ResetStatement()
 {
     ClearStatement();
 
+    /* A spatial filter reads the R-Tree, which must be up to date */
+    if( m_bDeferredSpatialIndexUpdate && InsertRTreeEntries() != OGRERR_NONE )
+        return OGRERR_FAILURE;
+
     /* There is no active query statement set up, */
     /* so job #1 is to prepare the statement. */
     /* Append the attribute filter, if there is one */
@@ -1439,6 +1496,118 @@ OGRErr OGRGeoPackageTableLayer::ResetStatement()
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                     StartParallelScanIfPossible()                    */
+/*                                                                      */
+/*      When reading a whole layer of a read-only dataset, with         */
+/*      OGR_GPKG_NUM_THREADS (or GDAL_NUM_THREADS) set to more than     */
+/*      one thread, split the FID range of the table between worker     */
+/*      threads that read the rows with their own connection and        */
+/*      translate them to features.                                     */
+/************************************************************************/
+
+void OGRGeoPackageTableLayer::StartParallelScanIfPossible()
+{
+    if( m_bParallelScanChecked )
+        return;
+    m_bParallelScanChecked = TRUE;
+
+    if( m_poQueryStatement != NULL || bEOF || iNextShapeId != 0 )
+        return;
+
+    const char* pszNumThreads = CPLGetConfigOption("OGR_GPKG_NUM_THREADS",
+                                    CPLGetConfigOption("GDAL_NUM_THREADS", "1"));
+    int nThreads;
+    if( EQUAL(pszNumThreads, "ALL_CPUS") )
+        nThreads = CPLGetNumCPUs();
+    else
+        nThreads = atoi(pszNumThreads);
+    if( nThreads > 128 )
+        nThreads = 128;
+    if( nThreads <= 1 )
+        return;
+
+    /* The worker connections would not see uncommitted changes. Filtered */
+    /* requests are left to SQLite, as the spatial index subquery would */
+    /* have to be evaluated again for each FID range */
+    if( m_poDS->GetUpdate() || m_pszFidColumn == NULL || iFIDCol < 0 ||
+        m_soFilter.length() != 0 || !sqlite3_threadsafe() )
+        return;
+
+/* -------------------------------------------------------------------- */
+/*      Fetch the FID range.                                            */
+/* -------------------------------------------------------------------- */
+    char* pszSQL = sqlite3_mprintf("SELECT MIN(\"%s\"), MAX(\"%s\") FROM \"%s\"",
+                                   m_pszFidColumn, m_pszFidColumn,
+                                   m_pszTableName);
+    sqlite3_stmt* hStmt = NULL;
+    int rc = sqlite3_prepare(m_poDS->GetDB(), pszSQL, -1, &hStmt, NULL);
+    sqlite3_free(pszSQL);
+    if( rc != SQLITE_OK )
+        return;
+    GIntBig nMinFID = 0, nMaxFID = -1;
+    if( sqlite3_step(hStmt) == SQLITE_ROW &&
+        sqlite3_column_type(hStmt, 0) == SQLITE_INTEGER &&
+        sqlite3_column_type(hStmt, 1) == SQLITE_INTEGER )
+    {
+        nMinFID = sqlite3_column_int64(hStmt, 0);
+        nMaxFID = sqlite3_column_int64(hStmt, 1);
+    }
+    sqlite3_finalize(hStmt);
+
+    /* Avoid overflows when computing the size of the range */
+    if( nMaxFID < nMinFID ||
+        (nMinFID < 0 && nMaxFID > GINTBIG_MAX + nMinFID - 1) )
+        return;
+
+/* -------------------------------------------------------------------- */
+/*      Start the workers.                                              */
+/* -------------------------------------------------------------------- */
+    CPLString osSQL;
+    osSQL.Printf("SELECT %s FROM \"%s\" WHERE \"%s\" BETWEEN ? AND ?",
+                 m_soColumns.c_str(), m_pszTableName, m_pszFidColumn);
+
+    int bOrdered = CSLTestBoolean(
+        CPLGetConfigOption("OGR_GPKG_PARALLEL_SCAN_ORDERED", "YES"));
+    m_poParallelScan = new OGRGeoPackageParallelScan(this, bOrdered);
+    if( !m_poParallelScan->Start(osSQL, nThreads, nMinFID, nMaxFID) )
+    {
+        CPLDebug("GPKG", "Cannot start parallel scan of %s", m_pszTableName);
+        delete m_poParallelScan;
+        m_poParallelScan = NULL;
+    }
+}
+
+/************************************************************************/
+/*                     GetNextParallelScanFeature()                     */
+/************************************************************************/
+
+OGRFeature* OGRGeoPackageTableLayer::GetNextParallelScanFeature()
+{
+    while( TRUE )
+    {
+        OGRFeature* poFeature = m_poParallelScan->GetNextFeature();
+        if( poFeature == NULL )
+        {
+            delete m_poParallelScan;
+            m_poParallelScan = NULL;
+            bEOF = TRUE;
+            return NULL;
+        }
+
+        iNextShapeId++;
+        m_nFeaturesRead++;
+
+        if( (m_poFilterGeom == NULL
+            || FilterGeometry( poFeature->GetGeomFieldRef(m_iGeomFieldFilter) ) )
+            && (m_poAttrQuery == NULL
+                || m_poAttrQuery->Evaluate( poFeature )) )
+            return poFeature;
+
+        delete poFeature;
+    }
+}
+
 /************************************************************************/
 /*                           GetNextFeature()                           */
 /************************************************************************/
@@ -1450,7 +1619,13 @@ OGRFeature* OGRGeoPackageTableLayer::GetNextFeature()
 
     CreateSpatialIndexIfNecessary();
 
-    OGRFeature* poFeature = OGRGeoPackageLayer::GetNextFeature();
+    StartParallelScanIfPossible();
+
+    OGRFeature* poFeature;
+    if( m_poParallelScan != NULL )
+        poFeature = GetNextParallelScanFeature();
+    else
+        poFeature = OGRGeoPackageLayer::GetNextFeature();
     if( poFeature && m_iFIDAsRegularColumnIndex >= 0 )
     {
         poFeature->SetField(m_iFIDAsRegularColumnIndex, poFeature->GetFID());
@@ -1458,6 +1633,85 @@ OGRFeature* OGRGeoPackageTableLayer::GetNextFeature()
     return poFeature;
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRGeoPackageTableLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                                  int nMaxFeatures )
+{
+    /* Attribute filters are translated into the SQL request, but the */
+    /* spatial filter still needs to be checked against each geometry */
+    if( m_poFilterGeom != NULL || m_poAttrQuery != NULL )
+        return OGRLayer::GetNextFeatureBatch( poBatch, nMaxFeatures );
+
+    /* Features are built by the worker threads of the parallel scan */
+    if( !m_bDeferredCreation )
+    {
+        StartParallelScanIfPossible();
+        if( m_poParallelScan != NULL )
+            return OGRLayer::GetNextFeatureBatch( poBatch, nMaxFeatures );
+    }
+
+    poBatch->Reset();
+
+    if( !ValidateFeatureBatch( poBatch ) )
+        return 0;
+
+    if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
+        return 0;
+
+    CreateSpatialIndexIfNecessary();
+
+    while( !bEOF && poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        if( m_poQueryStatement == NULL )
+        {
+            ResetStatement();
+            if (m_poQueryStatement == NULL)
+                break;
+        }
+
+        if( bDoStep )
+        {
+            int rc = sqlite3_step( m_poQueryStatement );
+            if( rc != SQLITE_ROW )
+            {
+                if ( rc != SQLITE_DONE )
+                {
+                    sqlite3_reset(m_poQueryStatement);
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                            "In GetNextFeatureBatch(): sqlite3_step() : %s",
+                            sqlite3_errmsg(m_poDS->GetDB()) );
+                }
+
+                ClearStatement();
+                bEOF = TRUE;
+                break;
+            }
+        }
+        else
+            bDoStep = TRUE;
+
+        if( !TranslateFeatureToBatch( m_poQueryStatement, poBatch ) )
+            break;
+
+        if( m_iFIDAsRegularColumnIndex >= 0 )
+        {
+            GIntBig nFID = poBatch->GetFIDs()[poBatch->GetFeatureCount() - 1];
+            if( m_poFeatureDefn->GetFieldDefn(
+                        m_iFIDAsRegularColumnIndex)->GetType() == OFTInteger64 )
+                poBatch->SetFieldInteger64( m_iFIDAsRegularColumnIndex, nFID );
+            else if( m_poFeatureDefn->GetFieldDefn(
+                        m_iFIDAsRegularColumnIndex)->GetType() == OFTInteger )
+                poBatch->SetFieldInteger( m_iFIDAsRegularColumnIndex,
+                                          (int)nFID );
+        }
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                        GetFeature()                                  */
 /************************************************************************/
@@ -1533,6 +1787,10 @@ OGRErr OGRGeoPackageTableLayer::DeleteFeature(GIntBig nFID)
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return OGRERR_FAILURE;
 
+    /* The delete trigger must see the R-Tree entries of all created features */
+    if( m_bDeferredSpatialIndexUpdate && InsertRTreeEntries() != OGRERR_NONE )
+        return OGRERR_FAILURE;
+
     /* Clear out any existing query */
     ResetReading();
 
@@ -1602,6 +1860,10 @@ GIntBig OGRGeoPackageTableLayer::GetFeatureCount( CPL_UNUSED int bForce )
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return 0;
 
+    /* A spatial filter reads the R-Tree, which must be up to date */
+    if( m_bDeferredSpatialIndexUpdate && InsertRTreeEntries() != OGRERR_NONE )
+        return -1;
+
     /* Ignore bForce, because we always do a full count on the database */
     OGRErr err;
     CPLString soSQL;
@@ -1640,6 +1902,9 @@ OGRErr OGRGeoPackageTableLayer::GetExtent(OGREnvelope *psExtent, int bForce)
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return OGRERR_FAILURE;
 
+    if( m_bDeferredSpatialIndexUpdate && InsertRTreeEntries() != OGRERR_NONE )
+        return OGRERR_FAILURE;
+
     /* User is OK with expensive calculation, fall back to */
     /* default implementation (scan all features) and save */
     /* the result for later */
@@ -1708,6 +1973,11 @@ void OGRGeoPackageTableLayer::CreateSpatialIndexIfNecessary()
     {
         CreateSpatialIndex();
     }
+
+    /* Readers of the R-Tree must see the features created so far, but */
+    /* the insert trigger stays disabled until the end of the transaction */
+    if( m_bDeferredSpatialIndexUpdate )
+        InsertRTreeEntries();
 }
 
 /************************************************************************/
@@ -1778,13 +2048,7 @@ int OGRGeoPackageTableLayer::CreateSpatialIndex()
     bDropRTreeTable = FALSE;
 
     /* Populate the RTree */
-    pszSQL = sqlite3_mprintf(
-                 "INSERT OR REPLACE INTO \"rtree_%s_%s\" "
-                 "SELECT \"%s\", st_minx(\"%s\"), st_maxx(\"%s\"), st_miny(\"%s\"), st_maxy(\"%s\") FROM \"%s\"",
-                 pszT, pszC, pszI, pszC, pszC, pszC, pszC, pszT );
-    err = SQLCommand(m_poDS->GetDB(), pszSQL);
-    sqlite3_free(pszSQL);
-    if( err != OGRERR_NONE )
+    if( FillRTreeFromTable() != OGRERR_NONE )
     {
         m_poDS->SoftRollbackTransaction();
         return FALSE;
@@ -1792,27 +2056,7 @@ int OGRGeoPackageTableLayer::CreateSpatialIndex()
 
     /* Define Triggers to Maintain Spatial Index Values */
 
-    /* Conditions: Insertion of non-empty geometry
-       Actions   : Insert record into rtree */
-    pszSQL = sqlite3_mprintf(
-                   "CREATE TRIGGER \"rtree_%s_%s_insert\" AFTER INSERT ON \"%s\" "
-                   "WHEN (new.\"%s\" NOT NULL AND NOT ST_IsEmpty(NEW.\"%s\")) "
-                   "BEGIN "
-                   "INSERT OR REPLACE INTO \"rtree_%s_%s\" VALUES ("
-                   "NEW.\"%s\","
-                   "ST_MinX(NEW.\"%s\"), ST_MaxX(NEW.\"%s\"),"
-                   "ST_MinY(NEW.\"%s\"), ST_MaxY(NEW.\"%s\")"
-                   "); "
-                   "END",
-                   pszT, pszC, pszT,
-                   pszC, pszC,
-                   pszT, pszC,
-                   pszI,
-                   pszC, pszC,
-                   pszC, pszC);
-    err = SQLCommand(m_poDS->GetDB(), pszSQL);
-    sqlite3_free(pszSQL);
-    if( err != OGRERR_NONE )
+    if( CreateRTreeInsertTrigger() != OGRERR_NONE )
     {
         m_poDS->SoftRollbackTransaction();
         return FALSE;
@@ -1951,6 +2195,258 @@ int OGRGeoPackageTableLayer::CreateSpatialIndex()
     return TRUE;
 }
 
+/************************************************************************/
+/*                      CreateRTreeInsertTrigger()                      */
+/************************************************************************/
+
+OGRErr OGRGeoPackageTableLayer::CreateRTreeInsertTrigger()
+{
+    const char* pszT = m_pszTableName;
+    const char* pszC = m_poFeatureDefn->GetGeomFieldDefn(0)->GetNameRef();
+    const char* pszI = GetFIDColumn();
+
+    /* Conditions: Insertion of non-empty geometry
+       Actions   : Insert record into rtree */
+    char* pszSQL = sqlite3_mprintf(
+                   "CREATE TRIGGER \"rtree_%s_%s_insert\" AFTER INSERT ON \"%s\" "
+                   "WHEN (new.\"%s\" NOT NULL AND NOT ST_IsEmpty(NEW.\"%s\")) "
+                   "BEGIN "
+                   "INSERT OR REPLACE INTO \"rtree_%s_%s\" VALUES ("
+                   "NEW.\"%s\","
+                   "ST_MinX(NEW.\"%s\"), ST_MaxX(NEW.\"%s\"),"
+                   "ST_MinY(NEW.\"%s\"), ST_MaxY(NEW.\"%s\")"
+                   "); "
+                   "END",
+                   pszT, pszC, pszT,
+                   pszC, pszC,
+                   pszT, pszC,
+                   pszI,
+                   pszC, pszC,
+                   pszC, pszC);
+    OGRErr err = SQLCommand(m_poDS->GetDB(), pszSQL);
+    sqlite3_free(pszSQL);
+    return err;
+}
+
+static bool GPkgRTreeEntryLess( const GPkgRTreeEntry& a,
+                                const GPkgRTreeEntry& b )
+{
+    return a.nHilbertCode < b.nHilbertCode;
+}
+
+/************************************************************************/
+/*                         InsertRTreeEntries()                         */
+/*                                                                      */
+/*      Insert the accumulated entries in the R-Tree, sorted along a    */
+/*      Hilbert curve. Inserting spatially close entries together      */
+/*      touches fewer R-Tree nodes and results in a better packed       */
+/*      tree than insertion in FID order.                               */
+/************************************************************************/
+
+OGRErr OGRGeoPackageTableLayer::InsertRTreeEntries()
+{
+    if( m_asRTreeEntries.empty() )
+        return OGRERR_NONE;
+
+    size_t i;
+    const size_t nEntries = m_asRTreeEntries.size();
+    OGREnvelope sExtent;
+    for( i = 0; i < nEntries; i++ )
+    {
+        const GPkgRTreeEntry& sEntry = m_asRTreeEntries[i];
+        sExtent.Merge(sEntry.dfMinX, sEntry.dfMinY);
+        sExtent.Merge(sEntry.dfMaxX, sEntry.dfMaxY);
+    }
+
+    double dfXRes = (sExtent.MaxX > sExtent.MinX) ?
+                        65535.0 / (sExtent.MaxX - sExtent.MinX) : 0.0;
+    double dfYRes = (sExtent.MaxY > sExtent.MinY) ?
+                        65535.0 / (sExtent.MaxY - sExtent.MinY) : 0.0;
+    for( i = 0; i < nEntries; i++ )
+    {
+        GPkgRTreeEntry& sEntry = m_asRTreeEntries[i];
+        double dfX = (sEntry.dfMinX + sEntry.dfMaxX) / 2 - sExtent.MinX;
+        double dfY = (sEntry.dfMinY + sEntry.dfMaxY) / 2 - sExtent.MinY;
+        sEntry.nHilbertCode = CPLHilbertCode( (GUInt32)(dfX * dfXRes),
+                                              (GUInt32)(dfY * dfYRes) );
+    }
+
+    std::sort(m_asRTreeEntries.begin(), m_asRTreeEntries.end(),
+              GPkgRTreeEntryLess);
+
+    const char* pszT = m_pszTableName;
+    const char* pszC = m_poFeatureDefn->GetGeomFieldDefn(0)->GetNameRef();
+    char* pszSQL = sqlite3_mprintf(
+        "INSERT OR REPLACE INTO \"rtree_%s_%s\" VALUES (?,?,?,?,?)", pszT, pszC);
+    sqlite3_stmt* hStmt = NULL;
+    int rc = sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hStmt, NULL);
+    if( rc != SQLITE_OK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "failed to prepare SQL: %s", pszSQL);
+        sqlite3_free(pszSQL);
+        m_asRTreeEntries.clear();
+        return OGRERR_FAILURE;
+    }
+    sqlite3_free(pszSQL);
+
+    OGRErr eErr = OGRERR_NONE;
+    m_poDS->SoftStartTransaction();
+    for( i = 0; i < nEntries; i++ )
+    {
+        const GPkgRTreeEntry& sEntry = m_asRTreeEntries[i];
+        sqlite3_bind_int64(hStmt, 1, sEntry.nId);
+        sqlite3_bind_double(hStmt, 2, sEntry.dfMinX);
+        sqlite3_bind_double(hStmt, 3, sEntry.dfMaxX);
+        sqlite3_bind_double(hStmt, 4, sEntry.dfMinY);
+        sqlite3_bind_double(hStmt, 5, sEntry.dfMaxY);
+        rc = sqlite3_step(hStmt);
+        sqlite3_reset(hStmt);
+        if( rc != SQLITE_OK && rc != SQLITE_DONE )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "failed to insert into R-Tree: %s",
+                      sqlite3_errmsg(m_poDS->GetDB()) );
+            eErr = OGRERR_FAILURE;
+            break;
+        }
+    }
+    sqlite3_finalize(hStmt);
+    if( eErr == OGRERR_NONE )
+        m_poDS->SoftCommitTransaction();
+    else
+        m_poDS->SoftRollbackTransaction();
+
+    /* Release the memory */
+    std::vector<GPkgRTreeEntry>().swap(m_asRTreeEntries);
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                         FillRTreeFromTable()                         */
+/************************************************************************/
+
+OGRErr OGRGeoPackageTableLayer::FillRTreeFromTable()
+{
+    const char* pszT = m_pszTableName;
+    const char* pszC = m_poFeatureDefn->GetGeomFieldDefn(0)->GetNameRef();
+    const char* pszI = GetFIDColumn();
+
+    char* pszSQL = sqlite3_mprintf(
+        "SELECT \"%s\", \"%s\" FROM \"%s\" WHERE \"%s\" NOT NULL",
+        pszI, pszC, pszT, pszC);
+    sqlite3_stmt* hStmt = NULL;
+    int rc = sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hStmt, NULL);
+    if( rc != SQLITE_OK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "failed to prepare SQL: %s", pszSQL);
+        sqlite3_free(pszSQL);
+        return OGRERR_FAILURE;
+    }
+    sqlite3_free(pszSQL);
+
+    /* Read the envelopes from the geometry headers. They are only */
+    /* missing for points, for which the geometry must be parsed */
+    OGRErr eErr = OGRERR_NONE;
+    m_asRTreeEntries.clear();
+    while( (rc = sqlite3_step(hStmt)) == SQLITE_ROW )
+    {
+        if( sqlite3_column_type(hStmt, 1) != SQLITE_BLOB )
+            continue;
+        const GByte* pabyBLOB = (const GByte*) sqlite3_column_blob(hStmt, 1);
+        int nBLOBLen = sqlite3_column_bytes(hStmt, 1);
+
+        GPkgHeader sHeader;
+        if( nBLOBLen < 8 ||
+            GPkgHeaderFromWKB(pabyBLOB, &sHeader) != OGRERR_NONE ||
+            sHeader.bEmpty )
+            continue;
+
+        GPkgRTreeEntry sEntry;
+        sEntry.nId = sqlite3_column_int64(hStmt, 0);
+        sEntry.nHilbertCode = 0;
+        if( sHeader.iDims == 0 )
+        {
+            OGRGeometry *poGeom = GPkgGeometryToOGR(pabyBLOB, nBLOBLen, NULL);
+            if( poGeom == NULL || poGeom->IsEmpty() )
+            {
+                delete poGeom;
+                continue;
+            }
+            OGREnvelope sEnvelope;
+            poGeom->getEnvelope(&sEnvelope);
+            delete poGeom;
+            sEntry.dfMinX = sEnvelope.MinX;
+            sEntry.dfMaxX = sEnvelope.MaxX;
+            sEntry.dfMinY = sEnvelope.MinY;
+            sEntry.dfMaxY = sEnvelope.MaxY;
+        }
+        else
+        {
+            sEntry.dfMinX = sHeader.MinX;
+            sEntry.dfMaxX = sHeader.MaxX;
+            sEntry.dfMinY = sHeader.MinY;
+            sEntry.dfMaxY = sHeader.MaxY;
+        }
+        m_asRTreeEntries.push_back(sEntry);
+
+        if( m_asRTreeEntries.size() >= MAX_PENDING_RTREE_ENTRIES )
+        {
+            eErr = InsertRTreeEntries();
+            if( eErr != OGRERR_NONE )
+                break;
+        }
+    }
+    if( eErr == OGRERR_NONE && rc != SQLITE_DONE && rc != SQLITE_ROW )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "failed to read features: %s",
+                  sqlite3_errmsg(m_poDS->GetDB()) );
+        eErr = OGRERR_FAILURE;
+    }
+    sqlite3_finalize(hStmt);
+
+    if( eErr == OGRERR_NONE )
+        eErr = InsertRTreeEntries();
+    else
+        m_asRTreeEntries.clear();
+    return eErr;
+}
+
+/************************************************************************/
+/*                   FlushDeferredSpatialIndexUpdate()                  */
+/*                                                                      */
+/*      Insert the envelopes of the features created since the R-Tree   */
+/*      insert trigger was disabled, and restore the trigger.           */
+/************************************************************************/
+
+OGRErr OGRGeoPackageTableLayer::FlushDeferredSpatialIndexUpdate()
+{
+    if( !m_bDeferredSpatialIndexUpdate )
+        return OGRERR_NONE;
+    m_bDeferredSpatialIndexUpdate = FALSE;
+
+    OGRErr eErr = InsertRTreeEntries();
+    if( eErr == OGRERR_NONE )
+        eErr = CreateRTreeInsertTrigger();
+    return eErr;
+}
+
+/************************************************************************/
+/*                  CancelDeferredSpatialIndexUpdate()                  */
+/*                                                                      */
+/*      Called when the transaction is rolled back, which also          */
+/*      restores the R-Tree insert trigger.                             */
+/************************************************************************/
+
+void OGRGeoPackageTableLayer::CancelDeferredSpatialIndexUpdate()
+{
+    m_bDeferredSpatialIndexUpdate = FALSE;
+    std::vector<GPkgRTreeEntry>().swap(m_asRTreeEntries);
+}
+
 /************************************************************************/
 /*                    CheckUnknownExtensions()                          */
 /************************************************************************/
@@ -2128,9 +2624,17 @@ int OGRGeoPackageTableLayer::DropSpatialIndex(int bCalledFromSQLFunction)
     SQLCommand(m_poDS->GetDB(), pszSQL);
     sqlite3_free(pszSQL);
 
-    pszSQL = sqlite3_mprintf("DROP TRIGGER \"rtree_%s_%s_insert\"", pszT, pszC);
-    SQLCommand(m_poDS->GetDB(), pszSQL);
-    sqlite3_free(pszSQL);
+    if( m_bDeferredSpatialIndexUpdate )
+    {
+        /* The insert trigger is currently disabled */
+        CancelDeferredSpatialIndexUpdate();
+    }
+    else
+    {
+        pszSQL = sqlite3_mprintf("DROP TRIGGER \"rtree_%s_%s_insert\"", pszT, pszC);
+        SQLCommand(m_poDS->GetDB(), pszSQL);
+        sqlite3_free(pszSQL);
+    }
 
     pszSQL = sqlite3_mprintf("DROP TRIGGER \"rtree_%s_%s_update1\"", pszT, pszC);
     SQLCommand(m_poDS->GetDB(), pszSQL);
@@ -49,6 +49,13 @@ public:
     virtual GIntBig   GetFirstMatch( OGRField *psKey ) = 0;
     virtual GIntBig  *GetAllMatches( OGRField *psKey ) = 0;
     virtual GIntBig  *GetAllMatches( OGRField *psKey, GIntBig* panFIDList, int* nFIDCount, int* nLength ) = 0;
+
+    virtual int       SupportsRangeMatches();
+    virtual GIntBig  *GetRangeMatches( OGRField *psMin, int bMinIncluded,
+                                       OGRField *psMax, int bMaxIncluded,
+                                       int *pnFIDCount );
+    virtual GIntBig  *GetPrefixMatches( const char *pszPrefix,
+                                        int *pnFIDCount );
     
     virtual OGRErr AddEntry( OGRField *psKey, GIntBig nFID ) = 0;
     virtual OGRErr RemoveEntry( OGRField *psKey, GIntBig nFID ) = 0;
@@ -68,6 +75,9 @@ class CPL_DLL OGRLayerAttrIndex
 protected:
     OGRLayer    *poLayer;
     char        *pszIndexPath;
+    /* data file whose size and modification time are recorded by */
+    /* indexes that are not updated on edits, to detect stale ones */
+    CPLString   osSourceFilename;
 
                 OGRLayerAttrIndex();
 
@@ -84,9 +94,18 @@ public:
     virtual OGRErr RemoveFromIndex( OGRFeature *poFeature ) = 0;
 
     virtual OGRAttrIndex *GetFieldIndex( int iField ) = 0;
+
+    const char  *GetIndexPath() { return pszIndexPath; }
+    void        SetSourceFilename( const char *pszFilename )
+                                        { osSourceFilename = pszFilename; }
 };
 
 OGRLayerAttrIndex CPL_DLL *OGRCreateDefaultLayerIndex();
+OGRLayerAttrIndex CPL_DLL *OGRCreateBTreeLayerIndex();
+
+CPLString CPL_DLL OGRGetGenericLayerIndexFilename( GDALDataset *poDS,
+                                                   OGRLayer *poLayer,
+                                        CPLString *posSourceFilename = NULL );
 
 
 #endif /* ndef _OGR_ATTRIND_H_INCLUDED */
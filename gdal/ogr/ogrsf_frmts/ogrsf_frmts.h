@@ -79,11 +79,13 @@ class CPL_DLL OGRLayer : public GDALMajorObject
     int          FilterGeometry( OGRGeometry * );
     //int          FilterGeometry( OGRGeometry *, OGREnvelope* psGeometryEnvelope);
     int          InstallFilter( OGRGeometry * );
+    int          ValidateFeatureBatch( OGRFeatureBatch * );
     
     OGRErr       GetExtentInternal(int iGeomField, OGREnvelope *psExtent, int bForce );
 
     virtual OGRErr      ISetFeature( OGRFeature *poFeature );
     virtual OGRErr      ICreateFeature( OGRFeature *poFeature );
+    virtual int         IGetNextFeatureInPlace( OGRFeature *poFeature );
 
   public:
     OGRLayer();
@@ -103,6 +105,9 @@ class CPL_DLL OGRLayer : public GDALMajorObject
 
     virtual void        ResetReading() = 0;
     virtual OGRFeature *GetNextFeature() = 0;
+    virtual int         GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures );
+    int                 GetNextFeatureInPlace( OGRFeature *poFeature );
     virtual OGRErr      SetNextByIndex( GIntBig nIndex );
     virtual OGRFeature *GetFeature( GIntBig nFID );
 
@@ -1793,4 +1793,284 @@ int FileGDBIndexIterator::GetMinMaxSumCount(double& dfMin, double& dfMax,
     return TRUE;
 }
 
+/************************************************************************/
+/*                              GetInt64()                              */
+/************************************************************************/
+
+static GIntBig GetInt64(const GByte* pBaseAddr, int iOffset)
+{
+    GIntBig nVal;
+    memcpy(&nVal, pBaseAddr + sizeof(nVal) * iOffset, sizeof(nVal));
+    CPL_LSBPTR64(&nVal);
+    return nVal;
+}
+
+/************************************************************************/
+/*                     FileGDBSpatialIndexIterator                      */
+/************************************************************************/
+
+/* The .spx file is a B-tree with the same page layout as the .atx files, */
+/* whose keys are 64-bit integers made of the grid number (2 bits), the */
+/* column (31 bits) and the row (31 bits) of the grid cells intersecting */
+/* the extent of each feature. */
+
+#define SPX_GRID_SHIFT          (1 << 29)
+#define SPX_MAX_CELL            0x7FFFFFFF
+#define SPX_MAX_GRIDS           3
+
+class FileGDBSpatialIndexIterator : public FileGDBIterator
+{
+        FileGDBTable        *poParent;
+        VSILFILE            *fpCurIdx;
+        GUInt32              nMaxPerPages;
+        GUInt32              nOffsetFirstValInPage;
+        GUInt32              nIndexDepth;
+        GByte                abyPage[MAX_DEPTH + 1][FGDB_PAGE_SIZE];
+
+        GIntBig              nMinCol, nMaxCol, nMinRow, nMaxRow;
+
+        std::vector<int>     anRows;
+        size_t               iCurRow;
+
+                             FileGDBSpatialIndexIterator(FileGDBTable* poParent);
+        int                  SetEnvelope(const OGREnvelope& sEnvelope);
+        int                  CollectRows(GUInt32 iLevel, GUInt32 nPage,
+                                         GIntBig nMinKey, GIntBig nMaxKey);
+
+    public:
+        virtual             ~FileGDBSpatialIndexIterator();
+
+        static FileGDBIterator*      Build(FileGDBTable* poParent,
+                                           const OGREnvelope& sEnvelope);
+
+        virtual FileGDBTable        *GetTable() { return poParent; }
+        virtual void                 Reset() { iCurRow = 0; }
+        virtual int                  GetNextRowSortedByFID();
+        virtual int                  GetRowCount() { return (int)anRows.size(); }
+};
+
+/************************************************************************/
+/*                      FileGDBSpatialIndexIterator()                   */
+/************************************************************************/
+
+FileGDBSpatialIndexIterator::FileGDBSpatialIndexIterator(FileGDBTable* poParent) :
+                    poParent(poParent), fpCurIdx(NULL),
+                    nMaxPerPages(0), nOffsetFirstValInPage(0), nIndexDepth(0),
+                    nMinCol(0), nMaxCol(0), nMinRow(0), nMaxRow(0),
+                    iCurRow(0)
+{
+}
+
+/************************************************************************/
+/*                     ~FileGDBSpatialIndexIterator()                   */
+/************************************************************************/
+
+FileGDBSpatialIndexIterator::~FileGDBSpatialIndexIterator()
+{
+    if( fpCurIdx )
+        VSIFCloseL(fpCurIdx);
+}
+
+/************************************************************************/
+/*                             Build()                                  */
+/************************************************************************/
+
+FileGDBIterator* FileGDBSpatialIndexIterator::Build( FileGDBTable* poParent,
+                                                     const OGREnvelope& sEnvelope )
+{
+    FileGDBSpatialIndexIterator* poIterator =
+                new FileGDBSpatialIndexIterator(poParent);
+    if( poIterator->SetEnvelope(sEnvelope) )
+    {
+        return poIterator;
+    }
+    delete poIterator;
+    return NULL;
+}
+
+/************************************************************************/
+/*                          GetSpatialIndexCell()                       */
+/************************************************************************/
+
+static GIntBig GetSpatialIndexCell(double dfCoord, double dfGridRes0,
+                                   double dfGridRes)
+{
+    double dfCell = floor(dfCoord / dfGridRes +
+                          SPX_GRID_SHIFT * (dfGridRes0 / dfGridRes));
+    if( !(dfCell >= 0) )
+        return 0;
+    if( dfCell > SPX_MAX_CELL )
+        return SPX_MAX_CELL;
+    return (GIntBig)dfCell;
+}
+
+/************************************************************************/
+/*                            SetEnvelope()                             */
+/************************************************************************/
+
+int FileGDBSpatialIndexIterator::SetEnvelope(const OGREnvelope& sEnvelope)
+{
+    const int errorRetValue = FALSE;
+    CPLAssert(fpCurIdx == NULL);
+
+    int iGeomField = poParent->GetGeomFieldIdx();
+    if( iGeomField < 0 )
+        return FALSE;
+    const FileGDBGeomField* poGeomField =
+        (const FileGDBGeomField*) poParent->GetField(iGeomField);
+    const std::vector<double>& adfGridRes =
+        poGeomField->GetSpatialIndexGridResolution();
+    if( adfGridRes.size() == 0 || adfGridRes.size() > SPX_MAX_GRIDS )
+        return FALSE;
+    for( size_t i = 0; i < adfGridRes.size(); i++ )
+    {
+        /* Unused grids have a 0 resolution */
+        if( i > 0 && adfGridRes[i] == 0.0 )
+            break;
+        if( !(adfGridRes[i] > 0.0) )
+            return FALSE;
+    }
+
+    const char* pszSpxName = CPLFormFilename(CPLGetPath(poParent->GetFilename().c_str()),
+                    CPLGetBasename(poParent->GetFilename().c_str()), "spx");
+    fpCurIdx = VSIFOpenL( pszSpxName, "rb" );
+    if( fpCurIdx == NULL )
+        return FALSE;
+
+    VSIFSeekL(fpCurIdx, 0, SEEK_END);
+    vsi_l_offset nFileSize = VSIFTellL(fpCurIdx);
+    returnErrorIf(nFileSize < FGDB_PAGE_SIZE + 22 );
+
+    VSIFSeekL(fpCurIdx, nFileSize - 22, SEEK_SET);
+    GByte abyTrailer[22];
+    returnErrorIf(VSIFReadL( abyTrailer, 22, 1, fpCurIdx ) != 1 );
+
+    returnErrorIf(abyTrailer[0] != sizeof(GIntBig));
+    nMaxPerPages = (FGDB_PAGE_SIZE - 12) / (4 + abyTrailer[0]);
+    nOffsetFirstValInPage = 12 + nMaxPerPages * 4;
+
+    GUInt32 nMagic1 = GetUInt32(abyTrailer + 2, 0);
+    returnErrorIf(nMagic1 != 1 );
+
+    nIndexDepth = GetUInt32(abyTrailer + 6, 0);
+    returnErrorIf(!(nIndexDepth >= 1 && nIndexDepth <= MAX_DEPTH + 1) );
+
+    /* The spatial index is not always maintained: when it is empty */
+    /* while the table is not, we cannot use it. */
+    GUInt32 nValueCountInIdx = GetUInt32(abyTrailer + 10, 0);
+    if( (int)nValueCountInIdx <= 0 )
+        return FALSE;
+
+    for( size_t iGrid = 0; iGrid < adfGridRes.size(); iGrid++ )
+    {
+        double dfGridRes = adfGridRes[iGrid];
+        if( dfGridRes == 0.0 )
+            break;
+        nMinCol = GetSpatialIndexCell(sEnvelope.MinX, adfGridRes[0], dfGridRes);
+        nMaxCol = GetSpatialIndexCell(sEnvelope.MaxX, adfGridRes[0], dfGridRes);
+        nMinRow = GetSpatialIndexCell(sEnvelope.MinY, adfGridRes[0], dfGridRes);
+        nMaxRow = GetSpatialIndexCell(sEnvelope.MaxY, adfGridRes[0], dfGridRes);
+
+        GIntBig nGrid = ((GIntBig)iGrid) << 62;
+        GIntBig nMinKey = nGrid | (nMinCol << 31) | nMinRow;
+        GIntBig nMaxKey = nGrid | (nMaxCol << 31) | nMaxRow;
+        returnErrorIf(!CollectRows(0, 1, nMinKey, nMaxKey));
+    }
+
+    /* A feature is registered in each of the cells it intersects */
+    std::sort(anRows.begin(), anRows.end());
+    anRows.erase(std::unique(anRows.begin(), anRows.end()), anRows.end());
+
+    VSIFCloseL(fpCurIdx);
+    fpCurIdx = NULL;
+
+    CPLDebug("OpenFileGDB", "Using spatial index of %s: %d candidate rows",
+             poParent->GetFilename().c_str(), (int)anRows.size());
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                            CollectRows()                             */
+/************************************************************************/
+
+int FileGDBSpatialIndexIterator::CollectRows(GUInt32 iLevel, GUInt32 nPage,
+                                             GIntBig nMinKey, GIntBig nMaxKey)
+{
+    const int errorRetValue = FALSE;
+    GByte* pabyPage = abyPage[iLevel];
+    VSIFSeekL(fpCurIdx, (vsi_l_offset)(nPage - 1) * FGDB_PAGE_SIZE, SEEK_SET);
+    returnErrorIf(VSIFReadL( pabyPage, FGDB_PAGE_SIZE, 1, fpCurIdx ) != 1 );
+
+    GUInt32 nCount = GetUInt32(pabyPage + 4, 0);
+    returnErrorIf(nCount > nMaxPerPages);
+
+    if( iLevel + 1 == nIndexDepth )
+    {
+        for( GUInt32 i = 0; i < nCount; i ++ )
+        {
+            GIntBig nKey = GetInt64(pabyPage + nOffsetFirstValInPage, i);
+            if( nKey < nMinKey )
+                continue;
+            if( nKey > nMaxKey )
+                break;
+
+            /* The key range covers whole columns between the first */
+            /* and the last one, so filter on the row */
+            GIntBig nRow = nKey & SPX_MAX_CELL;
+            if( nRow < nMinRow || nRow > nMaxRow )
+                continue;
+
+            GUInt32 nFID = GetUInt32(pabyPage + 12, i);
+            returnErrorIf(nFID < 1 ||
+                          nFID > (GUInt32)poParent->GetTotalRecordCount());
+            anRows.push_back((int)nFID - 1);
+        }
+        return TRUE;
+    }
+
+    /* In an inner page, the value of index i is the maximum key of the */
+    /* sub-page i, and there is one more sub-page than values. */
+    returnErrorIf(nCount == 0);
+    for( GUInt32 i = 0; i <= nCount; i ++ )
+    {
+        if( i < nCount &&
+            GetInt64(pabyPage + nOffsetFirstValInPage, i) < nMinKey )
+            continue;
+
+        GUInt32 nSubPage = GetUInt32(pabyPage + 8, i);
+        returnErrorIf(nSubPage < 2);
+        if( !CollectRows(iLevel + 1, nSubPage, nMinKey, nMaxKey) )
+            return FALSE;
+
+        /* CollectRows() has overwritten the page of the next level, */
+        /* but not ours. */
+        if( i < nCount &&
+            GetInt64(pabyPage + nOffsetFirstValInPage, i) > nMaxKey )
+            break;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                        GetNextRowSortedByFID()                       */
+/************************************************************************/
+
+int FileGDBSpatialIndexIterator::GetNextRowSortedByFID()
+{
+    if( iCurRow < anRows.size() )
+        return anRows[iCurRow ++];
+    return -1;
+}
+
+/************************************************************************/
+/*                           BuildSpatial()                             */
+/************************************************************************/
+
+FileGDBIterator* FileGDBIterator::BuildSpatial(FileGDBTable* poParent,
+                                               const OGREnvelope& sEnvelope)
+{
+    return FileGDBSpatialIndexIterator::Build(poParent, sEnvelope);
+}
+
 }; /* namespace OpenFileGDB */
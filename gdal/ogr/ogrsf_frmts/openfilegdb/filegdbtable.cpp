@@ -1001,8 +1001,14 @@ int FileGDBTable::Open(const char* pszFilename,
                         nRemaining -= 5;
                         returnErrorIf(nRemaining < (GUInt32)(nToSkip * 8) );
                         nCountDoubles += nToSkip;
-                        pabyIter += nToSkip * 8;
-                        nRemaining -= nToSkip * 8;
+                        /* Those are the sizes of the cells of the grids */
+                        /* of the spatial index (.spx) */
+                        for( int iGrid = 0; iGrid < nToSkip; iGrid++ )
+                        {
+                            double dfGridSize;
+                            READ_DOUBLE(dfGridSize);
+                            poField->adfSpatialIndexGridResolution.push_back(dfGridSize);
+                        }
                         break;
                     }
                     else
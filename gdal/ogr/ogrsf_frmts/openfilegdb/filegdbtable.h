@@ -144,6 +144,7 @@ class FileGDBGeomField: public FileGDBField
         double            dfXMax;
         double            dfYMax;
         int               bHas3D;
+        std::vector<double> adfSpatialIndexGridResolution;
 
     public:
                           FileGDBGeomField(FileGDBTable* poParent);
@@ -173,6 +174,9 @@ class FileGDBGeomField: public FileGDBField
         double             GetMTolerance() const { return dfMTolerance; }
         
         int                Has3D() const { return bHas3D; }
+
+        const std::vector<double>& GetSpatialIndexGridResolution() const
+                                        { return adfSpatialIndexGridResolution; }
 };
 
 /************************************************************************/
@@ -361,6 +365,10 @@ class FileGDBIterator
         static FileGDBIterator*      BuildIsNotNull(FileGDBTable* poParent,
                                                     int nFieldIdx,
                                                     int bAscending);
+        /* Returns the rows whose spatial index (.spx) cells intersect */
+        /* the envelope, or NULL if there is no usable spatial index */
+        static FileGDBIterator*      BuildSpatial(FileGDBTable* poParent,
+                                                  const OGREnvelope& sEnvelope);
         static FileGDBIterator*      BuildNot(FileGDBIterator* poIterBase);
         static FileGDBIterator*      BuildAnd(FileGDBIterator* poIter1,
                                               FileGDBIterator* poIter2);
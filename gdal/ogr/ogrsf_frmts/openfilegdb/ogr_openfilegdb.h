@@ -86,6 +86,8 @@ class OGROpenFileGDBLayer : public OGRLayer
 
     FileGDBIterator*      m_poIterMinMax;
 
+    FileGDBIterator*      m_poSpatialIndexIterator;
+
     SPIState            m_eSpatialIndexState;
     CPLQuadTree        *m_pQuadTree;
     void              **m_pahFilteredFeatures;
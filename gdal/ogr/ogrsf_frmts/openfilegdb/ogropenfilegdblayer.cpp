@@ -152,6 +152,7 @@ OGROpenFileGDBLayer::OGROpenFileGDBLayer(const char* pszGDBFilename,
             m_poIterator(NULL),
             m_bIteratorSufficientToEvaluateFilter(FALSE),
             m_poIterMinMax(NULL),
+            m_poSpatialIndexIterator(NULL),
             m_eSpatialIndexState(SPI_IN_BUILDING),
             m_pQuadTree(NULL),
             m_pahFilteredFeatures(NULL),
@@ -184,6 +185,7 @@ OGROpenFileGDBLayer::~OGROpenFileGDBLayer()
     }
     delete m_poIterator;
     delete m_poIterMinMax;
+    delete m_poSpatialIndexIterator;
     delete m_poGeomConverter;
     if( m_pQuadTree != NULL )
         CPLQuadTreeDestroy(m_pQuadTree);
@@ -644,6 +646,8 @@ void OGROpenFileGDBLayer::ResetReading()
     m_iCurFeat = 0;
     if( m_poIterator )
         m_poIterator->Reset();
+    if( m_poSpatialIndexIterator )
+        m_poSpatialIndexIterator->Reset();
 }
 
 /***********************************************************************/
@@ -657,6 +661,9 @@ void OGROpenFileGDBLayer::SetSpatialFilter( OGRGeometry *poGeom )
 
     OGRLayer::SetSpatialFilter(poGeom);
 
+    delete m_poSpatialIndexIterator;
+    m_poSpatialIndexIterator = NULL;
+
     if( m_bFilterIsEnvelope )
     {
         OGREnvelope sLayerEnvelope;
@@ -695,6 +702,16 @@ void OGROpenFileGDBLayer::SetSpatialFilter( OGRGeometry *poGeom )
                 std::sort(panStart, panStart + m_nFilteredFeatureCount);
             }
         }
+        else if( CSLTestBoolean(CPLGetConfigOption("OPENFILEGDB_USE_SPATIAL_INDEX", "YES")) )
+        {
+            /* Use the .spx file, when it is usable, rather than building */
+            /* the in-memory spatial index during a full scan */
+            m_poSpatialIndexIterator =
+                FileGDBIterator::BuildSpatial(m_poLyrTable, m_sFilterEnvelope);
+            if( m_poSpatialIndexIterator != NULL &&
+                m_eSpatialIndexState == SPI_IN_BUILDING )
+                m_eSpatialIndexState = SPI_INVALID;
+        }
         m_poLyrTable->InstallFilterEnvelope(&m_sFilterEnvelope);
     }
     else
@@ -1232,6 +1249,7 @@ OGRErr OGROpenFileGDBLayer::SetAttributeFilter( const char* pszFilter )
     {
         swq_expr_node* poNode = (swq_expr_node*) m_poAttrQuery->GetSWQExpr();
         poNode->ReplaceBetweenByGEAndLERecurse();
+        m_poAttrQuery->ExpressionChanged();
         m_bIteratorSufficientToEvaluateFilter = -1;
         m_poIterator = BuildIteratorFromExprNode(poNode);
         if( m_poIterator != NULL && m_eSpatialIndexState == SPI_IN_BUILDING )
@@ -1395,6 +1413,26 @@ OGRFeature* OGROpenFileGDBLayer::GetNextFeature()
                 }
             }
         }
+        else if( m_poSpatialIndexIterator != NULL )
+        {
+            while( TRUE )
+            {
+                int iRow = m_poSpatialIndexIterator->GetNextRowSortedByFID();
+                if( iRow < 0 )
+                    return NULL;
+                if( m_poLyrTable->SelectRow(iRow) )
+                {
+                    poFeature = GetCurrentFeature();
+                    if( poFeature )
+                        break;
+                }
+                else if( m_poLyrTable->HasGotError() )
+                {
+                    m_bEOF = TRUE;
+                    return NULL;
+                }
+            }
+        }
         else
         {
             while( TRUE )
@@ -1473,7 +1511,7 @@ OGRFeature* OGROpenFileGDBLayer::GetFeature( GIntBig nFeatureId )
 
 OGRErr OGROpenFileGDBLayer::SetNextByIndex( GIntBig nIndex )
 {
-    if( m_poIterator != NULL )
+    if( m_poIterator != NULL || m_poSpatialIndexIterator != NULL )
         return OGRLayer::SetNextByIndex(nIndex);
 
     if( !BuildLayerDefinition() )
@@ -1560,8 +1598,26 @@ GIntBig OGROpenFileGDBLayer::GetFeatureCount( int bForce )
             m_nFilteredFeatureCount = 0;
         }
 
-        for(int i=0;i<m_poLyrTable->GetTotalRecordCount();i++)
+        /* Only visit the candidate rows of the .spx if available */
+        if( m_poSpatialIndexIterator != NULL )
+            m_poSpatialIndexIterator->Reset();
+
+        for(int iIter=0;;iIter++)
         {
+            int i;
+            if( m_poSpatialIndexIterator != NULL )
+            {
+                i = m_poSpatialIndexIterator->GetNextRowSortedByFID();
+                if( i < 0 )
+                    break;
+            }
+            else
+            {
+                if( iIter == m_poLyrTable->GetTotalRecordCount() )
+                    break;
+                i = iIter;
+            }
+
             if( !m_poLyrTable->SelectRow(i) )
             {
                 if( m_poLyrTable->HasGotError() )
@@ -1611,6 +1667,8 @@ GIntBig OGROpenFileGDBLayer::GetFeatureCount( int bForce )
                 }
             }
         }
+        if( m_poSpatialIndexIterator != NULL )
+            m_poSpatialIndexIterator->Reset();
         if( m_eSpatialIndexState == SPI_IN_BUILDING )
         {
             m_nFilteredFeatureCount = nCount;
@@ -1647,7 +1705,7 @@ int OGROpenFileGDBLayer::TestCapability( const char * pszCap )
     {
         return ( m_poLyrTable->GetValidRecordCount() ==
                  m_poLyrTable->GetTotalRecordCount() &&
-                 m_poIterator == NULL );
+                 m_poIterator == NULL && m_poSpatialIndexIterator == NULL );
     }
     else if( EQUAL(pszCap,OLCRandomRead) )
     {
@@ -35,6 +35,7 @@
 
 #include "ogrsf_frmts.h"
 #include "cpl_string.h"
+#include "cpl_virtualmem.h"
 
 #include <set>
 #include <map>
@@ -389,6 +390,13 @@ class OGROSMDataSource : public OGRDataSource
     Bucket             *papsBuckets;
     int                 nBuckets;
 
+    /* Node locations directly addressed by node id. See IndexPointArray() */
+    int                 bNodesArray;
+    int                 bNodesArrayInFile;
+    int                 nNodesArraySegments;
+    LonLat            **papasNodesArraySegments;
+    CPLVirtualMem     **papsNodesArrayVMem;
+
     int                 bNeedsToSaveWayInfo;
 
     int                 CompressWay (unsigned int nTags, IndexedKVP* pasTags,
@@ -413,6 +421,10 @@ class OGROSMDataSource : public OGRDataSource
     int                 FlushCurrentSectorCompressedCase();
     int                 FlushCurrentSectorNonCompressedCase();
     int                 IndexPointCustom(OSMNode* psNode);
+    int                 IndexPointArray(OSMNode* psNode);
+    int                 AllocNodesArraySegment(int iSegment);
+    void                FreeNodesArray();
+    int                 GetNodeFromArray(GIntBig nID, LonLat* psLonLat);
 
     void                IndexWay(GIntBig nWayID,
                                  unsigned int nTags, IndexedKVP* pasTags,
@@ -432,6 +444,7 @@ class OGROSMDataSource : public OGRDataSource
     void                LookupNodesCustom();
     void                LookupNodesCustomCompressedCase();
     void                LookupNodesCustomNonCompressedCase();
+    void                LookupNodesArray();
 
     unsigned int        LookupWays( std::map< GIntBig, std::pair<int,void*> >& aoMapWays,
                                     OSMRelation* psRelation );
@@ -66,6 +66,12 @@
 
 #define VALID_ID_FOR_CUSTOM_INDEXING(_id) ((_id) >= 0 && (_id / NODE_PER_BUCKET) < INT_MAX)
 
+/* Number of nodes in a segment of the nodes array (32 MB of LonLat) */
+#define NODE_PER_SEGMENT_SHIFT  22
+#define NODE_PER_SEGMENT        (1 << NODE_PER_SEGMENT_SHIFT)
+
+#define VALID_ID_FOR_NODES_ARRAY(_id) ((_id) >= 0 && ((_id) >> NODE_PER_SEGMENT_SHIFT) < INT_MAX)
+
 /* Minimum size of data written on disk, in *uncompressed* case */
 #define SECTOR_SIZE         512
 /* Which represents, 64 nodes */
@@ -246,6 +252,12 @@ OGROSMDataSource::OGROSMDataSource()
     papsBuckets = NULL;
     nBuckets = 0;
 
+    bNodesArray = FALSE;
+    bNodesArrayInFile = FALSE;
+    nNodesArraySegments = 0;
+    papasNodesArraySegments = NULL;
+    papsNodesArrayVMem = NULL;
+
     nReqIds = 0;
     panReqIds = NULL;
 #ifdef ENABLE_NODE_LOOKUP_BY_HASHING
@@ -350,6 +362,8 @@ OGROSMDataSource::~OGROSMDataSource()
         delete psKD;
     }
 
+    FreeNodesArray();
+
     if( fpNodes )
         VSIFCloseL(fpNodes);
     if( osNodesFilename.size() && bMustUnlinkNodesFile )
@@ -466,7 +480,9 @@ int OGROSMDataSource::IndexPoint(OSMNode* psNode)
     if( !bIndexPoints )
         return TRUE;
 
-    if( bCustomIndexing)
+    if( bNodesArray )
+        return IndexPointArray(psNode);
+    else if( bCustomIndexing)
         return IndexPointCustom(psNode);
     else
         return IndexPointSQLite(psNode);
@@ -797,6 +813,154 @@ int OGROSMDataSource::IndexPointCustom(OSMNode* psNode)
     return TRUE;
 }
 
+/************************************************************************/
+/*                       AllocNodesArraySegment()                       */
+/*                                                                      */
+/*      Each segment covers NODE_PER_SEGMENT consecutive node ids. It   */
+/*      is either zero-initialized RAM, or a memory mapping of a        */
+/*      region of the temporary nodes file. In both cases, the pages    */
+/*      of ids that are never written do not consume physical memory   */
+/*      nor disk space.                                                 */
+/************************************************************************/
+
+int OGROSMDataSource::AllocNodesArraySegment(int iSegment)
+{
+    if( iSegment >= nNodesArraySegments )
+    {
+        int nNewSegments = MAX(nNodesArraySegments + nNodesArraySegments / 2,
+                               iSegment + 1);
+        LonLat** papasNewSegments = (LonLat**) VSIRealloc(
+            papasNodesArraySegments, nNewSegments * sizeof(LonLat*));
+        if( papasNewSegments == NULL )
+            goto oom;
+        papasNodesArraySegments = papasNewSegments;
+
+        CPLVirtualMem** papsNewVMem = (CPLVirtualMem**) VSIRealloc(
+            papsNodesArrayVMem, nNewSegments * sizeof(CPLVirtualMem*));
+        if( papsNewVMem == NULL )
+            goto oom;
+        papsNodesArrayVMem = papsNewVMem;
+
+        for(int i = nNodesArraySegments; i < nNewSegments; i++)
+        {
+            papasNodesArraySegments[i] = NULL;
+            papsNodesArrayVMem[i] = NULL;
+        }
+        nNodesArraySegments = nNewSegments;
+    }
+
+    if( bNodesArrayInFile )
+    {
+        const vsi_l_offset nLength = (vsi_l_offset)NODE_PER_SEGMENT * sizeof(LonLat);
+        CPLVirtualMem* psVMem = CPLVirtualMemFileMapNew( fpNodes,
+                                                         nNodesFileSize,
+                                                         nLength,
+                                                         VIRTUALMEM_READWRITE,
+                                                         NULL, NULL );
+        if( psVMem == NULL )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Cannot map temporary node file %s",
+                     osNodesFilename.c_str());
+            bStopParsing = TRUE;
+            return FALSE;
+        }
+        nNodesFileSize += nLength;
+        papsNodesArrayVMem[iSegment] = psVMem;
+        papasNodesArraySegments[iSegment] = (LonLat*) CPLVirtualMemGetAddr(psVMem);
+    }
+    else
+    {
+        papasNodesArraySegments[iSegment] =
+            (LonLat*) VSICalloc(NODE_PER_SEGMENT, sizeof(LonLat));
+        if( papasNodesArraySegments[iSegment] == NULL )
+            goto oom;
+    }
+
+    return TRUE;
+
+oom:
+    CPLError(CE_Failure, CPLE_OutOfMemory,
+             "AllocNodesArraySegment() failed. Use OSM_NODES_ARRAY=FILE");
+    bStopParsing = TRUE;
+    return FALSE;
+}
+
+/************************************************************************/
+/*                           FreeNodesArray()                           */
+/************************************************************************/
+
+void OGROSMDataSource::FreeNodesArray()
+{
+    for(int i = 0; i < nNodesArraySegments; i++)
+    {
+        if( papsNodesArrayVMem[i] != NULL )
+            CPLVirtualMemFree(papsNodesArrayVMem[i]);
+        else
+            CPLFree(papasNodesArraySegments[i]);
+    }
+    CPLFree(papasNodesArraySegments);
+    CPLFree(papsNodesArrayVMem);
+    papasNodesArraySegments = NULL;
+    papsNodesArrayVMem = NULL;
+    nNodesArraySegments = 0;
+
+    if( bNodesArrayInFile && fpNodes != NULL )
+    {
+        VSIFSeekL(fpNodes, 0, SEEK_SET);
+        VSIFTruncateL(fpNodes, 0);
+    }
+    nNodesFileSize = 0;
+}
+
+/************************************************************************/
+/*                          IndexPointArray()                           */
+/************************************************************************/
+
+int OGROSMDataSource::IndexPointArray(OSMNode* psNode)
+{
+    if( !VALID_ID_FOR_NODES_ARRAY(psNode->nID) )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Unsupported node id value (" CPL_FRMT_GIB "). Use OSM_NODES_ARRAY=NO",
+                 psNode->nID);
+        bStopParsing = TRUE;
+        return FALSE;
+    }
+
+    int iSegment = (int)(psNode->nID >> NODE_PER_SEGMENT_SHIFT);
+    if( (iSegment >= nNodesArraySegments ||
+         papasNodesArraySegments[iSegment] == NULL) &&
+        !AllocNodesArraySegment(iSegment) )
+        return FALSE;
+
+    LonLat* psLonLat = papasNodesArraySegments[iSegment] +
+                            (psNode->nID & (NODE_PER_SEGMENT - 1));
+    psLonLat->nLon = DBL_TO_INT(psNode->dfLon);
+    psLonLat->nLat = DBL_TO_INT(psNode->dfLat);
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          GetNodeFromArray()                          */
+/************************************************************************/
+
+int OGROSMDataSource::GetNodeFromArray(GIntBig nID, LonLat* psLonLat)
+{
+    if( !VALID_ID_FOR_NODES_ARRAY(nID) )
+        return FALSE;
+    int iSegment = (int)(nID >> NODE_PER_SEGMENT_SHIFT);
+    if( iSegment >= nNodesArraySegments ||
+        papasNodesArraySegments[iSegment] == NULL )
+        return FALSE;
+
+    *psLonLat = papasNodesArraySegments[iSegment][nID & (NODE_PER_SEGMENT - 1)];
+
+    /* As in the other indexing methods, (0,0) means a missing node */
+    return psLonLat->nLon != 0 || psLonLat->nLat != 0;
+}
+
 /************************************************************************/
 /*                             NotifyNodes()                            */
 /************************************************************************/
@@ -883,7 +1047,9 @@ static void OGROSMNotifyNodes (unsigned int nNodes,
 
 void OGROSMDataSource::LookupNodes( )
 {
-    if( bCustomIndexing )
+    if( bNodesArray )
+        LookupNodesArray();
+    else if( bCustomIndexing )
         LookupNodesCustom();
     else
         LookupNodesSQLite();
@@ -1023,6 +1189,34 @@ void OGROSMDataSource::LookupNodesSQLite( )
     nReqIds = j;
 }
 
+/************************************************************************/
+/*                          LookupNodesArray()                          */
+/************************************************************************/
+
+void OGROSMDataSource::LookupNodesArray( )
+{
+    unsigned int i;
+
+    CPLAssert(nUnsortedReqIds <= MAX_ACCUMULATED_NODES);
+
+    nReqIds = 0;
+    for(i = 0; i < nUnsortedReqIds; i++)
+        panReqIds[nReqIds++] = panUnsortedReqIds[i];
+
+    std::sort(panReqIds, panReqIds + nReqIds);
+
+    /* Remove duplicates and missing nodes */
+    unsigned int j = 0;
+    for(i = 0; i < nReqIds; i++)
+    {
+        if( i > 0 && panReqIds[i] == panReqIds[i-1] )
+            continue;
+        if( GetNodeFromArray(panReqIds[i], &pasLonLatArray[j]) )
+            panReqIds[j++] = panReqIds[i];
+    }
+    nReqIds = j;
+}
+
 /************************************************************************/
 /*                            ReadVarSInt64()                           */
 /************************************************************************/
@@ -1624,7 +1818,9 @@ void OGROSMDataSource::ProcessWaysBatch()
     if( nWayFeaturePairs == 0 ) return;
 
     //printf("nodes = %d, features = %d\n", nUnsortedReqIds, nWayFeaturePairs);
-    LookupNodes();
+    /* With the nodes array, nodes are directly fetched for each way */
+    if( !bNodesArray )
+        LookupNodes();
 
     int iPair;
     for(iPair = 0; iPair < nWayFeaturePairs; iPair ++)
@@ -1636,6 +1832,16 @@ void OGROSMDataSource::ProcessWaysBatch()
         unsigned int nFound = 0;
         unsigned int i;
 
+        if( bNodesArray )
+        {
+            for(i=0;i<psWayFeaturePairs->nRefs;i++)
+            {
+                if( GetNodeFromArray(psWayFeaturePairs->panNodeRefs[i],
+                                     &pasLonLatCache[nFound]) )
+                    nFound ++;
+            }
+        }
+        else
 #ifdef ENABLE_NODE_LOOKUP_BY_HASHING
         if( bHashedIndexValid )
         {
@@ -2688,6 +2894,49 @@ int OGROSMDataSource::Open( const char * pszFilename )
     if( bCompressNodes )
         CPLDebug("OSM", "Using compression for nodes DB");
 
+    /* Store node locations in an array addressed by node id, in RAM or */
+    /* in a memory mapped temporary file. */
+    const char* pszNodesArray = CPLGetConfigOption("OSM_NODES_ARRAY", "NO");
+    if( EQUAL(pszNodesArray, "FILE") )
+    {
+        if( CPLIsVirtualMemFileMapAvailable() )
+        {
+            bNodesArray = TRUE;
+            bNodesArrayInFile = TRUE;
+        }
+        else
+        {
+            CPLDebug("OSM", "Memory mapping not available. Using RAM for nodes array");
+            bNodesArray = TRUE;
+        }
+    }
+    else if( EQUAL(pszNodesArray, "RAM") || CSLTestBoolean(pszNodesArray) )
+        bNodesArray = TRUE;
+    if( bNodesArray )
+    {
+        CPLDebug("OSM", "Using nodes array in %s",
+                 bNodesArrayInFile ? "temporary file" : "RAM");
+        bCustomIndexing = FALSE;
+    }
+
+    /* Number of threads used to decode PBF blocks */
+    const char* pszNumThreads = CPLGetConfigOption("OSM_NUM_THREADS",
+                                    CPLGetConfigOption("GDAL_NUM_THREADS", "1"));
+    int nThreads;
+    if( EQUAL(pszNumThreads, "ALL_CPUS") )
+        nThreads = CPLGetNumCPUs();
+    else
+        nThreads = atoi(pszNumThreads);
+    if( nThreads < 1 )
+        nThreads = 1;
+    else if( nThreads > 128 )
+        nThreads = 128;
+    if( nThreads > 1 )
+    {
+        CPLDebug("OSM", "Using %d threads for PBF decoding", nThreads);
+        OSM_SetNumThreads(psParser, nThreads);
+    }
+
     nLayers = 5;
     papoLayers = (OGROSMLayer**) CPLMalloc(nLayers * sizeof(OGROSMLayer*));
 
@@ -2757,6 +3006,28 @@ int OGROSMDataSource::Open( const char * pszFilename )
         nSize = (GIntBig)nMaxSizeForInMemoryDBInMB * 1024 * 1024;
     }
 
+    if( bNodesArrayInFile )
+    {
+        /* Memory mapping requires a real file */
+        osNodesFilename = CPLGenerateTempFilename("osm_tmp_nodes");
+        fpNodes = VSIFOpenL(osNodesFilename, "wb+");
+        if( fpNodes == NULL )
+        {
+            CPLError(CE_Failure, CPLE_OpenFailed,
+                     "Cannot create temporary node file %s",
+                     osNodesFilename.c_str());
+            return FALSE;
+        }
+
+        const char* pszVal = CPLGetConfigOption("OSM_UNLINK_TMPFILE", "YES");
+        if( EQUAL(pszVal, "YES") )
+        {
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            bMustUnlinkNodesFile = VSIUnlink( osNodesFilename ) != 0;
+            CPLPopErrorHandler();
+        }
+    }
+
     if( bCustomIndexing )
     {
         pabySector = (GByte*) VSICalloc(1, SECTOR_SIZE);
@@ -3664,6 +3935,9 @@ int OGROSMDataSource::ResetReading()
         }
     }
 
+    if( bNodesArray )
+        FreeNodesArray();
+
     for(int i=0;i<nLayers;i++)
     {
         papoLayers[i]->ForceResetReading();
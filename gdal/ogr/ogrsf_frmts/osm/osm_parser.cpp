@@ -31,9 +31,12 @@
 #include "gpb.h"
 
 #include "cpl_conv.h"
+#include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 
+#include <vector>
+
 #ifdef HAVE_EXPAT
 #include "ogr_expat.h"
 #endif
@@ -61,6 +64,8 @@ CPL_CVSID("$Id$");
 /*    \    sInfo.nVisible = 1; */
 
 
+struct _OSMPBFBatch;
+
 /************************************************************************/
 /*                            _OSMContext                               */
 /************************************************************************/
@@ -127,6 +132,13 @@ struct _OSMContext
 
     GUIntBig        nBytesRead;
 
+    /* Parallel PBF decoding. See PBF_ProcessBlockParallel() */
+    int                   nThreads;
+    struct _OSMPBFBatch  *pasBatches;
+    int                   iCurBatch;
+    OSMRetCode            eReadRet;
+    GUIntBig              nBytesReadAhead;
+
     NotifyNodesFunc     pfnNotifyNodes;
     NotifyWayFunc       pfnNotifyWay;
     NotifyRelationFunc  pfnNotifyRelation;
@@ -134,6 +146,9 @@ struct _OSMContext
     void               *user_data;
 };
 
+static void PBF_StopBatches(OSMContext* psCtxt);
+static void PBF_FreeBatches(OSMContext* psCtxt);
+
 /************************************************************************/
 /*                          ReadBlobHeader()                            */
 /************************************************************************/
@@ -2308,6 +2323,8 @@ void OSM_Close(OSMContext* psCtxt)
     }
 #endif
 
+    PBF_FreeBatches(psCtxt);
+
     VSIFree(psCtxt->pabyBlob);
     VSIFree(psCtxt->pabyUncompressed);
     VSIFree(psCtxt->panStrOff);
@@ -2325,6 +2342,8 @@ void OSM_Close(OSMContext* psCtxt)
 
 void OSM_ResetReading( OSMContext* psCtxt )
 {
+    PBF_StopBatches(psCtxt);
+
     VSIFSeekL(psCtxt->fp, 0, SEEK_SET);
 
     psCtxt->nBytesRead = 0;
@@ -2354,61 +2373,70 @@ void OSM_ResetReading( OSMContext* psCtxt )
 }
 
 /************************************************************************/
-/*                          OSM_ProcessBlock()                          */
+/*                            PBF_ReadBlob()                            */
+/*                                                                      */
+/*      Read the next blob header and blob of the file into            */
+/*      *ppabyBlob, growing it as needed.                               */
 /************************************************************************/
 
-static OSMRetCode PBF_ProcessBlock(OSMContext* psCtxt)
+static OSMRetCode PBF_ReadBlob(VSILFILE* fp,
+                               GByte** ppabyBlob,
+                               unsigned int* pnBlobSizeAllocated,
+                               unsigned int* pnBlobSize,
+                               BlobType* peType,
+                               GUIntBig* pnBytesRead)
 {
     int nRet = FALSE;
     GByte abyHeaderSize[4];
     unsigned int nHeaderSize;
     unsigned int nBlobSize = 0;
     BlobType eType;
+    GByte* pabyBlob = *ppabyBlob;
 
-    if (VSIFReadL(abyHeaderSize, 4, 1, psCtxt->fp) != 1)
+    if (VSIFReadL(abyHeaderSize, 4, 1, fp) != 1)
     {
         return OSM_EOF;
     }
     nHeaderSize = (abyHeaderSize[0] << 24) | (abyHeaderSize[1] << 16) |
                     (abyHeaderSize[2] << 8) | abyHeaderSize[3];
 
-    psCtxt->nBytesRead += 4;
+    *pnBytesRead += 4;
 
     /* printf("nHeaderSize = %d\n", nHeaderSize); */
     if (nHeaderSize > 64 * 1024)
         GOTO_END_ERROR;
-    if (VSIFReadL(psCtxt->pabyBlob, 1, nHeaderSize, psCtxt->fp) != nHeaderSize)
+    if (VSIFReadL(pabyBlob, 1, nHeaderSize, fp) != nHeaderSize)
         GOTO_END_ERROR;
 
-    psCtxt->nBytesRead += nHeaderSize;
+    *pnBytesRead += nHeaderSize;
 
-    memset(psCtxt->pabyBlob + nHeaderSize, 0, EXTRA_BYTES);
-    nRet = ReadBlobHeader(psCtxt->pabyBlob, psCtxt->pabyBlob + nHeaderSize, &nBlobSize, &eType);
+    memset(pabyBlob + nHeaderSize, 0, EXTRA_BYTES);
+    nRet = ReadBlobHeader(pabyBlob, pabyBlob + nHeaderSize, &nBlobSize, &eType);
     if (!nRet || eType == BLOB_UNKNOW)
         GOTO_END_ERROR;
 
     if (nBlobSize > 64*1024*1024)
         GOTO_END_ERROR;
-    if (nBlobSize > psCtxt->nBlobSizeAllocated)
+    if (nBlobSize > *pnBlobSizeAllocated)
     {
         GByte* pabyBlobNew;
-        psCtxt->nBlobSizeAllocated = MAX(psCtxt->nBlobSizeAllocated * 2, nBlobSize);
-        pabyBlobNew = (GByte*)VSIRealloc(psCtxt->pabyBlob,
-                                        psCtxt->nBlobSizeAllocated + EXTRA_BYTES);
+        *pnBlobSizeAllocated = MAX(*pnBlobSizeAllocated * 2, nBlobSize);
+        pabyBlobNew = (GByte*)VSIRealloc(pabyBlob,
+                                        *pnBlobSizeAllocated + EXTRA_BYTES);
         if( pabyBlobNew == NULL )
             GOTO_END_ERROR;
-        psCtxt->pabyBlob = pabyBlobNew;
+        pabyBlob = pabyBlobNew;
+        *ppabyBlob = pabyBlob;
     }
-    if (VSIFReadL(psCtxt->pabyBlob, 1, nBlobSize, psCtxt->fp) != nBlobSize)
+    if (VSIFReadL(pabyBlob, 1, nBlobSize, fp) != nBlobSize)
         GOTO_END_ERROR;
 
-    psCtxt->nBytesRead += nBlobSize;
+    *pnBytesRead += nBlobSize;
 
-    memset(psCtxt->pabyBlob + nBlobSize, 0, EXTRA_BYTES);
-    nRet = ReadBlob(psCtxt->pabyBlob, nBlobSize, eType,
-                    psCtxt);
-    if (!nRet)
-        GOTO_END_ERROR;
+    memset(pabyBlob + nBlobSize, 0, EXTRA_BYTES);
+
+    *pnBlobSize = nBlobSize;
+    *peType = eType;
 
     return OSM_OK;
 
@@ -2417,6 +2445,542 @@ end_error:
     return OSM_ERROR;
 }
 
+/************************************************************************/
+/*                          PBF_ProcessBlock()                          */
+/************************************************************************/
+
+static OSMRetCode PBF_ProcessBlock(OSMContext* psCtxt)
+{
+    unsigned int nBlobSize = 0;
+    BlobType eType = BLOB_UNKNOW;
+
+    OSMRetCode eRet = PBF_ReadBlob(psCtxt->fp, &psCtxt->pabyBlob,
+                                   &psCtxt->nBlobSizeAllocated,
+                                   &nBlobSize, &eType,
+                                   &psCtxt->nBytesRead);
+    if( eRet != OSM_OK )
+        return eRet;
+
+    if (!ReadBlob(psCtxt->pabyBlob, nBlobSize, eType, psCtxt))
+        return OSM_ERROR;
+
+    return OSM_OK;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                      Parallel PBF decoding                           */
+/*                                                                      */
+/*      Blobs are read from the file by the calling thread, in          */
+/*      batches of a few blobs per thread. Worker threads inflate and   */
+/*      decode the blobs of a batch, recording the notifications in     */
+/*      per-blob buffers instead of issuing them. The calling thread    */
+/*      then replays the recorded notifications one blob per            */
+/*      OSM_ProcessBlock() call, in file order, while the next batch   */
+/*      is being decoded.                                               */
+/* ==================================================================== */
+/************************************************************************/
+
+#define OSM_EVENT_NODES     0
+#define OSM_EVENT_WAY       1
+#define OSM_EVENT_RELATION  2
+#define OSM_EVENT_BOUNDS    3
+
+#define BLOBS_PER_THREAD    2
+
+typedef struct
+{
+    int          nType;
+    unsigned int nIdx;      /* first node, or way, relation, bounds index */
+    unsigned int nCount;    /* number of nodes */
+    unsigned int nTagIdx;   /* first tag of the way or relation */
+    unsigned int nItemIdx;  /* first node ref of the way, or member of the relation */
+} OSMPBFEvent;
+
+typedef struct
+{
+    GByte        *pabyBlob;
+    unsigned int  nBlobSizeAllocated;
+    unsigned int  nBlobSize;
+    BlobType      eType;
+    GUIntBig      nBytesRead;   /* file position after the blob */
+    int           bOK;
+
+    /* Context used by the worker thread to decode the blob. Strings */
+    /* of the recorded notifications point into its buffers. */
+    OSMContext   *psDecodeCtxt;
+
+    std::vector<OSMPBFEvent>  *pasEvents;
+    std::vector<OSMNode>      *pasNodes;
+    std::vector<unsigned int> *panNodeTagIdx;
+    std::vector<OSMWay>       *pasWays;
+    std::vector<OSMRelation>  *pasRelations;
+    std::vector<OSMTag>       *pasTags;
+    std::vector<GIntBig>      *panNodeRefs;
+    std::vector<OSMMember>    *pasMembers;
+    std::vector<double>       *padfBounds;
+} OSMPBFJob;
+
+typedef struct _OSMPBFBatch
+{
+    OSMPBFJob          *pasJobs;
+    int                 nJobs;
+    int                 iNextJobToDecode;   /* protected by hMutex */
+    int                 iNextJobToReplay;
+    CPLMutex           *hMutex;
+    CPLJoinableThread **pahThreads;
+    int                 nRunningThreads;
+} OSMPBFBatch;
+
+/************************************************************************/
+/*                          PBF_RecordNodes()                           */
+/************************************************************************/
+
+static void PBF_RecordNodes(unsigned int nNodes, OSMNode* pasNodes,
+                            CPL_UNUSED OSMContext* psCtxt, void* user_data)
+{
+    OSMPBFJob* psJob = (OSMPBFJob*) user_data;
+    OSMPBFEvent sEvent;
+    unsigned int i;
+
+    sEvent.nType = OSM_EVENT_NODES;
+    sEvent.nIdx = (unsigned int) psJob->pasNodes->size();
+    sEvent.nCount = nNodes;
+    sEvent.nTagIdx = 0;
+    sEvent.nItemIdx = 0;
+
+    for(i = 0; i < nNodes; i++)
+    {
+        OSMNode sNode = pasNodes[i];
+        psJob->panNodeTagIdx->push_back((unsigned int) psJob->pasTags->size());
+        psJob->pasTags->insert(psJob->pasTags->end(),
+                               sNode.pasTags, sNode.pasTags + sNode.nTags);
+        sNode.pasTags = NULL;
+        psJob->pasNodes->push_back(sNode);
+    }
+
+    psJob->pasEvents->push_back(sEvent);
+}
+
+/************************************************************************/
+/*                           PBF_RecordWay()                            */
+/************************************************************************/
+
+static void PBF_RecordWay(OSMWay* psWay,
+                          CPL_UNUSED OSMContext* psCtxt, void* user_data)
+{
+    OSMPBFJob* psJob = (OSMPBFJob*) user_data;
+    OSMPBFEvent sEvent;
+    OSMWay sWay = *psWay;
+
+    sEvent.nType = OSM_EVENT_WAY;
+    sEvent.nIdx = (unsigned int) psJob->pasWays->size();
+    sEvent.nCount = 0;
+    sEvent.nTagIdx = (unsigned int) psJob->pasTags->size();
+    sEvent.nItemIdx = (unsigned int) psJob->panNodeRefs->size();
+
+    psJob->pasTags->insert(psJob->pasTags->end(),
+                           sWay.pasTags, sWay.pasTags + sWay.nTags);
+    psJob->panNodeRefs->insert(psJob->panNodeRefs->end(),
+                               sWay.panNodeRefs, sWay.panNodeRefs + sWay.nRefs);
+    sWay.pasTags = NULL;
+    sWay.panNodeRefs = NULL;
+    psJob->pasWays->push_back(sWay);
+
+    psJob->pasEvents->push_back(sEvent);
+}
+
+/************************************************************************/
+/*                         PBF_RecordRelation()                         */
+/************************************************************************/
+
+static void PBF_RecordRelation(OSMRelation* psRelation,
+                               CPL_UNUSED OSMContext* psCtxt, void* user_data)
+{
+    OSMPBFJob* psJob = (OSMPBFJob*) user_data;
+    OSMPBFEvent sEvent;
+    OSMRelation sRelation = *psRelation;
+
+    sEvent.nType = OSM_EVENT_RELATION;
+    sEvent.nIdx = (unsigned int) psJob->pasRelations->size();
+    sEvent.nCount = 0;
+    sEvent.nTagIdx = (unsigned int) psJob->pasTags->size();
+    sEvent.nItemIdx = (unsigned int) psJob->pasMembers->size();
+
+    psJob->pasTags->insert(psJob->pasTags->end(),
+                           sRelation.pasTags,
+                           sRelation.pasTags + sRelation.nTags);
+    psJob->pasMembers->insert(psJob->pasMembers->end(),
+                              sRelation.pasMembers,
+                              sRelation.pasMembers + sRelation.nMembers);
+    sRelation.pasTags = NULL;
+    sRelation.pasMembers = NULL;
+    psJob->pasRelations->push_back(sRelation);
+
+    psJob->pasEvents->push_back(sEvent);
+}
+
+/************************************************************************/
+/*                          PBF_RecordBounds()                          */
+/************************************************************************/
+
+static void PBF_RecordBounds(double dfXMin, double dfYMin,
+                             double dfXMax, double dfYMax,
+                             CPL_UNUSED OSMContext* psCtxt, void* user_data)
+{
+    OSMPBFJob* psJob = (OSMPBFJob*) user_data;
+    OSMPBFEvent sEvent;
+
+    sEvent.nType = OSM_EVENT_BOUNDS;
+    sEvent.nIdx = (unsigned int) psJob->padfBounds->size();
+    sEvent.nCount = 0;
+    sEvent.nTagIdx = 0;
+    sEvent.nItemIdx = 0;
+
+    psJob->padfBounds->push_back(dfXMin);
+    psJob->padfBounds->push_back(dfYMin);
+    psJob->padfBounds->push_back(dfXMax);
+    psJob->padfBounds->push_back(dfYMax);
+
+    psJob->pasEvents->push_back(sEvent);
+}
+
+/************************************************************************/
+/*                           PBF_InitJob()                              */
+/************************************************************************/
+
+static int PBF_InitJob(OSMPBFJob* psJob)
+{
+    memset(psJob, 0, sizeof(OSMPBFJob));
+
+    psJob->nBlobSizeAllocated = 64 * 1024 + EXTRA_BYTES;
+    psJob->pabyBlob = (GByte*)VSIMalloc(psJob->nBlobSizeAllocated);
+
+    psJob->psDecodeCtxt = (OSMContext*) VSICalloc(1, sizeof(OSMContext));
+    if( psJob->pabyBlob == NULL || psJob->psDecodeCtxt == NULL )
+        return FALSE;
+
+    psJob->psDecodeCtxt->bPBF = TRUE;
+    psJob->psDecodeCtxt->pfnNotifyNodes = PBF_RecordNodes;
+    psJob->psDecodeCtxt->pfnNotifyWay = PBF_RecordWay;
+    psJob->psDecodeCtxt->pfnNotifyRelation = PBF_RecordRelation;
+    psJob->psDecodeCtxt->pfnNotifyBounds = PBF_RecordBounds;
+    psJob->psDecodeCtxt->user_data = psJob;
+
+    psJob->pasEvents = new std::vector<OSMPBFEvent>();
+    psJob->pasNodes = new std::vector<OSMNode>();
+    psJob->panNodeTagIdx = new std::vector<unsigned int>();
+    psJob->pasWays = new std::vector<OSMWay>();
+    psJob->pasRelations = new std::vector<OSMRelation>();
+    psJob->pasTags = new std::vector<OSMTag>();
+    psJob->panNodeRefs = new std::vector<GIntBig>();
+    psJob->pasMembers = new std::vector<OSMMember>();
+    psJob->padfBounds = new std::vector<double>();
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                           PBF_FreeJob()                              */
+/************************************************************************/
+
+static void PBF_FreeJob(OSMPBFJob* psJob)
+{
+    OSMContext* psDecodeCtxt = psJob->psDecodeCtxt;
+    if( psDecodeCtxt != NULL )
+    {
+        VSIFree(psDecodeCtxt->pabyUncompressed);
+        VSIFree(psDecodeCtxt->panStrOff);
+        VSIFree(psDecodeCtxt->pasNodes);
+        VSIFree(psDecodeCtxt->pasTags);
+        VSIFree(psDecodeCtxt->pasMembers);
+        VSIFree(psDecodeCtxt->panNodeRefs);
+        VSIFree(psDecodeCtxt);
+    }
+    VSIFree(psJob->pabyBlob);
+
+    delete psJob->pasEvents;
+    delete psJob->pasNodes;
+    delete psJob->panNodeTagIdx;
+    delete psJob->pasWays;
+    delete psJob->pasRelations;
+    delete psJob->pasTags;
+    delete psJob->panNodeRefs;
+    delete psJob->pasMembers;
+    delete psJob->padfBounds;
+}
+
+/************************************************************************/
+/*                           PBF_DecodeJob()                            */
+/************************************************************************/
+
+static void PBF_DecodeJob(OSMPBFJob* psJob)
+{
+    psJob->pasEvents->resize(0);
+    psJob->pasNodes->resize(0);
+    psJob->panNodeTagIdx->resize(0);
+    psJob->pasWays->resize(0);
+    psJob->pasRelations->resize(0);
+    psJob->pasTags->resize(0);
+    psJob->panNodeRefs->resize(0);
+    psJob->pasMembers->resize(0);
+    psJob->padfBounds->resize(0);
+
+    psJob->bOK = ReadBlob(psJob->pabyBlob, psJob->nBlobSize, psJob->eType,
+                          psJob->psDecodeCtxt);
+}
+
+/************************************************************************/
+/*                          PBF_DecodeWorker()                          */
+/************************************************************************/
+
+static void PBF_DecodeWorker(void* pData)
+{
+    OSMPBFBatch* psBatch = (OSMPBFBatch*) pData;
+    while( TRUE )
+    {
+        CPLAcquireMutex(psBatch->hMutex, 1000.0);
+        int iJob = psBatch->iNextJobToDecode ++;
+        CPLReleaseMutex(psBatch->hMutex);
+        if( iJob >= psBatch->nJobs )
+            break;
+        PBF_DecodeJob(&psBatch->pasJobs[iJob]);
+    }
+}
+
+/************************************************************************/
+/*                           PBF_StartBatch()                           */
+/*                                                                      */
+/*      Read the blobs of the next batch from the file, and start       */
+/*      decoding them in the background.                                */
+/************************************************************************/
+
+static void PBF_StartBatch(OSMContext* psCtxt, OSMPBFBatch* psBatch)
+{
+    int nMaxJobs = psCtxt->nThreads * BLOBS_PER_THREAD;
+    int i;
+
+    psBatch->nJobs = 0;
+    psBatch->iNextJobToDecode = 0;
+    psBatch->iNextJobToReplay = 0;
+
+    while( psCtxt->eReadRet == OSM_OK && psBatch->nJobs < nMaxJobs )
+    {
+        OSMPBFJob* psJob = &psBatch->pasJobs[psBatch->nJobs];
+        psCtxt->eReadRet = PBF_ReadBlob(psCtxt->fp, &psJob->pabyBlob,
+                                        &psJob->nBlobSizeAllocated,
+                                        &psJob->nBlobSize, &psJob->eType,
+                                        &psCtxt->nBytesReadAhead);
+        if( psCtxt->eReadRet != OSM_OK )
+            break;
+        psJob->nBytesRead = psCtxt->nBytesReadAhead;
+        psBatch->nJobs ++;
+    }
+
+    int nThreads = MIN(psCtxt->nThreads, psBatch->nJobs);
+    for( i = 0; i < nThreads; i++ )
+    {
+        psBatch->pahThreads[psBatch->nRunningThreads] =
+            CPLCreateJoinableThread(PBF_DecodeWorker, psBatch);
+        if( psBatch->pahThreads[psBatch->nRunningThreads] != NULL )
+            psBatch->nRunningThreads ++;
+    }
+
+    /* In case no thread could be started */
+    if( psBatch->nJobs > 0 && psBatch->nRunningThreads == 0 )
+        PBF_DecodeWorker(psBatch);
+}
+
+/************************************************************************/
+/*                           PBF_WaitBatch()                            */
+/************************************************************************/
+
+static void PBF_WaitBatch(OSMPBFBatch* psBatch)
+{
+    int i;
+    for( i = 0; i < psBatch->nRunningThreads; i++ )
+        CPLJoinThread(psBatch->pahThreads[i]);
+    psBatch->nRunningThreads = 0;
+}
+
+/************************************************************************/
+/*                          PBF_StopBatches()                           */
+/************************************************************************/
+
+static void PBF_StopBatches(OSMContext* psCtxt)
+{
+    int i;
+
+    if( psCtxt->pasBatches == NULL )
+        return;
+
+    for( i = 0; i < 2; i++ )
+    {
+        PBF_WaitBatch(&psCtxt->pasBatches[i]);
+        psCtxt->pasBatches[i].nJobs = 0;
+        psCtxt->pasBatches[i].iNextJobToReplay = 0;
+    }
+    psCtxt->eReadRet = OSM_OK;
+    psCtxt->nBytesReadAhead = 0;
+}
+
+/************************************************************************/
+/*                           PBF_FreeBatches()                          */
+/************************************************************************/
+
+static void PBF_FreeBatches(OSMContext* psCtxt)
+{
+    int i, j;
+
+    if( psCtxt->pasBatches == NULL )
+        return;
+
+    PBF_StopBatches(psCtxt);
+
+    for( i = 0; i < 2; i++ )
+    {
+        OSMPBFBatch* psBatch = &psCtxt->pasBatches[i];
+        for( j = 0; j < psCtxt->nThreads * BLOBS_PER_THREAD; j++ )
+            PBF_FreeJob(&psBatch->pasJobs[j]);
+        CPLFree(psBatch->pasJobs);
+        CPLFree(psBatch->pahThreads);
+        if( psBatch->hMutex != NULL )
+            CPLDestroyMutex(psBatch->hMutex);
+    }
+    CPLFree(psCtxt->pasBatches);
+    psCtxt->pasBatches = NULL;
+}
+
+/************************************************************************/
+/*                          PBF_AllocBatches()                          */
+/************************************************************************/
+
+static int PBF_AllocBatches(OSMContext* psCtxt)
+{
+    int i, j;
+    int nJobs = psCtxt->nThreads * BLOBS_PER_THREAD;
+    int bOK = TRUE;
+
+    psCtxt->pasBatches = (OSMPBFBatch*) CPLCalloc(2, sizeof(OSMPBFBatch));
+    for( i = 0; i < 2; i++ )
+    {
+        OSMPBFBatch* psBatch = &psCtxt->pasBatches[i];
+        psBatch->pasJobs = (OSMPBFJob*) CPLCalloc(nJobs, sizeof(OSMPBFJob));
+        psBatch->pahThreads = (CPLJoinableThread**)
+            CPLCalloc(psCtxt->nThreads, sizeof(CPLJoinableThread*));
+        psBatch->hMutex = CPLCreateMutex();
+        CPLReleaseMutex(psBatch->hMutex);
+        for( j = 0; j < nJobs; j++ )
+        {
+            if( !PBF_InitJob(&psBatch->pasJobs[j]) )
+                bOK = FALSE;
+        }
+    }
+    psCtxt->iCurBatch = 0;
+    psCtxt->eReadRet = OSM_OK;
+    psCtxt->nBytesReadAhead = 0;
+
+    if( !bOK )
+    {
+        PBF_FreeBatches(psCtxt);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                           PBF_ReplayJob()                            */
+/************************************************************************/
+
+static void PBF_ReplayJob(OSMContext* psCtxt, OSMPBFJob* psJob)
+{
+    size_t i;
+    unsigned int j;
+
+    for( i = 0; i < psJob->pasEvents->size(); i++ )
+    {
+        const OSMPBFEvent& sEvent = (*psJob->pasEvents)[i];
+        if( sEvent.nType == OSM_EVENT_NODES )
+        {
+            OSMNode* pasNodes = &(*psJob->pasNodes)[sEvent.nIdx];
+            for( j = 0; j < sEvent.nCount; j++ )
+            {
+                if( pasNodes[j].nTags > 0 )
+                    pasNodes[j].pasTags = &(*psJob->pasTags)[
+                        (*psJob->panNodeTagIdx)[sEvent.nIdx + j]];
+            }
+            psCtxt->pfnNotifyNodes(sEvent.nCount, pasNodes, psCtxt,
+                                   psCtxt->user_data);
+        }
+        else if( sEvent.nType == OSM_EVENT_WAY )
+        {
+            OSMWay* psWay = &(*psJob->pasWays)[sEvent.nIdx];
+            if( psWay->nTags > 0 )
+                psWay->pasTags = &(*psJob->pasTags)[sEvent.nTagIdx];
+            if( psWay->nRefs > 0 )
+                psWay->panNodeRefs = &(*psJob->panNodeRefs)[sEvent.nItemIdx];
+            psCtxt->pfnNotifyWay(psWay, psCtxt, psCtxt->user_data);
+        }
+        else if( sEvent.nType == OSM_EVENT_RELATION )
+        {
+            OSMRelation* psRelation = &(*psJob->pasRelations)[sEvent.nIdx];
+            if( psRelation->nTags > 0 )
+                psRelation->pasTags = &(*psJob->pasTags)[sEvent.nTagIdx];
+            if( psRelation->nMembers > 0 )
+                psRelation->pasMembers = &(*psJob->pasMembers)[sEvent.nItemIdx];
+            psCtxt->pfnNotifyRelation(psRelation, psCtxt, psCtxt->user_data);
+        }
+        else
+        {
+            const double* padfBounds = &(*psJob->padfBounds)[sEvent.nIdx];
+            psCtxt->pfnNotifyBounds(padfBounds[0], padfBounds[1],
+                                    padfBounds[2], padfBounds[3],
+                                    psCtxt, psCtxt->user_data);
+        }
+    }
+}
+
+/************************************************************************/
+/*                      PBF_ProcessBlockParallel()                      */
+/************************************************************************/
+
+static OSMRetCode PBF_ProcessBlockParallel(OSMContext* psCtxt)
+{
+    if( psCtxt->pasBatches == NULL && !PBF_AllocBatches(psCtxt) )
+        return OSM_ERROR;
+
+    OSMPBFBatch* psBatch = &psCtxt->pasBatches[psCtxt->iCurBatch];
+    if( psBatch->iNextJobToReplay == psBatch->nJobs )
+    {
+        /* Switch to the other batch, starting it first if needed */
+        /* (first call, or after OSM_ResetReading()) */
+        OSMPBFBatch* psNextBatch = &psCtxt->pasBatches[1 - psCtxt->iCurBatch];
+        if( psNextBatch->nJobs == 0 )
+            PBF_StartBatch(psCtxt, psNextBatch);
+        PBF_WaitBatch(psNextBatch);
+
+        psBatch->nJobs = 0;
+        psBatch->iNextJobToReplay = 0;
+        psCtxt->iCurBatch = 1 - psCtxt->iCurBatch;
+
+        /* Decode the following batch while this one is delivered */
+        PBF_StartBatch(psCtxt, psBatch);
+
+        psBatch = psNextBatch;
+        if( psBatch->nJobs == 0 )
+            return psCtxt->eReadRet;
+    }
+
+    OSMPBFJob* psJob = &psBatch->pasJobs[psBatch->iNextJobToReplay ++];
+    if( !psJob->bOK )
+        return OSM_ERROR;
+
+    PBF_ReplayJob(psCtxt, psJob);
+    psCtxt->nBytesRead = psJob->nBytesRead;
+
+    return OSM_OK;
+}
+
 /************************************************************************/
 /*                          OSM_ProcessBlock()                          */
 /************************************************************************/
@@ -2424,13 +2988,22 @@ end_error:
 OSMRetCode OSM_ProcessBlock(OSMContext* psCtxt)
 {
 #ifdef HAVE_EXPAT
-    if( psCtxt->bPBF )
-        return PBF_ProcessBlock(psCtxt);
-    else
+    if( !psCtxt->bPBF )
         return XML_ProcessBlock(psCtxt);
-#else
-    return PBF_ProcessBlock(psCtxt);
 #endif
+    if( psCtxt->nThreads > 1 )
+        return PBF_ProcessBlockParallel(psCtxt);
+    return PBF_ProcessBlock(psCtxt);
+}
+
+/************************************************************************/
+/*                          OSM_SetNumThreads()                         */
+/************************************************************************/
+
+void OSM_SetNumThreads( OSMContext* psCtxt, int nThreads )
+{
+    PBF_FreeBatches(psCtxt);
+    psCtxt->nThreads = nThreads;
 }
 
 /************************************************************************/
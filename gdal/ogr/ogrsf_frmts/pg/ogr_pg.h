@@ -276,9 +276,20 @@ class OGRPGTableLayer : public OGRPGLayer
     int                 bFirstInsertion;
 
     OGRErr		CreateFeatureViaCopy( OGRFeature *poFeature );
+    OGRErr		CreateFeatureViaBinaryCopy( OGRFeature *poFeature );
     OGRErr		CreateFeatureViaInsert( OGRFeature *poFeature );
     CPLString           BuildCopyFields();
 
+    int                 bCopyBinary;
+    Oid                *panCopyBinaryTypes;
+    int                 PrepareBinaryCopy( const CPLString& osFields );
+
+    int                 nInsertBatchSize;
+    int                 nInsertBatchCount;
+    CPLString           osInsertBatchHead;
+    CPLString           osInsertBatch;
+    OGRErr              FlushInsertBatch();
+
     int                 bHasWarnedIncompatibleGeom;
     void                CheckGeomTypeCompatibility(int iGeomField, OGRGeometry* poGeom);
 
@@ -329,6 +340,7 @@ public:
     virtual OGRErr      ISetFeature( OGRFeature *poFeature );
     virtual OGRErr      DeleteFeature( GIntBig nFID );
     virtual OGRErr      ICreateFeature( OGRFeature *poFeature );
+    virtual OGRErr      SyncToDisk();
 
     virtual OGRErr      CreateField( OGRFieldDefn *poField,
                                      int bApproxOK = TRUE );
@@ -543,6 +555,7 @@ class OGRPGDataSource : public OGRDataSource
 
     int                 UseCopy();
     void                StartCopy( OGRPGTableLayer *poPGLayer );
+    void                StartInsertBatch( OGRPGTableLayer *poPGLayer );
     OGRErr              EndCopy( );
 };
 
@@ -2826,6 +2826,21 @@ void OGRPGDataSource::StartCopy( OGRPGTableLayer *poPGLayer )
     poLayerInCopyMode->StartCopy();
 }
 
+/************************************************************************/
+/*                          StartInsertBatch()                          */
+/*                                                                      */
+/*      Register a layer that accumulates rows in a multi-row INSERT,   */
+/*      so that they get flushed by EndCopy() like a pending COPY.      */
+/************************************************************************/
+
+void OGRPGDataSource::StartInsertBatch( OGRPGTableLayer *poPGLayer )
+{
+    if( poLayerInCopyMode == poPGLayer )
+        return;
+    EndCopy();
+    poLayerInCopyMode = poPGLayer;
+}
+
 /************************************************************************/
 /*                              EndCopy()                               */
 /************************************************************************/
@@ -144,6 +144,10 @@ OGRPGTableLayer::OGRPGTableLayer( OGRPGDataSource *poDSIn,
     bUseCopyByDefault = FALSE;
     bFIDColumnInCopyFields = FALSE;
     bFirstInsertion = TRUE;
+    bCopyBinary = FALSE;
+    panCopyBinaryTypes = NULL;
+    nInsertBatchSize = -1;  // unknown
+    nInsertBatchCount = 0;
 
     pszTableName = CPLStrdup( pszTableNameIn );
     if (pszSchemaNameIn)
@@ -212,7 +216,8 @@ OGRPGTableLayer::~OGRPGTableLayer()
 
 {
     if( bDifferedCreation ) RunDifferedCreationIfNecessary();
-    if ( bCopyActive ) EndCopy();
+    if ( bCopyActive || nInsertBatchCount > 0 ) EndCopy();
+    CPLFree( panCopyBinaryTypes );
     CPLFree( pszSqlTableName );
     CPLFree( pszTableName );
     CPLFree( pszSqlGeomParentTableName );
@@ -1548,7 +1553,24 @@ OGRErr OGRPGTableLayer::CreateFeatureViaInsert( OGRFeature *poFeature )
 
     int bEmptyInsert = FALSE;
 
-    poDS->EndCopy();
+/* -------------------------------------------------------------------- */
+/*      When PG_INSERT_BATCH_SIZE is greater than 1, the new rows are   */
+/*      accumulated in a multi-row INSERT, sent when it is full or by   */
+/*      EndCopy() before any other request, instead of doing one        */
+/*      round-trip to the server per feature.                           */
+/* -------------------------------------------------------------------- */
+    if( nInsertBatchSize < 0 )
+        nInsertBatchSize = MAX(1, atoi(CPLGetConfigOption("PG_INSERT_BATCH_SIZE", "1")));
+    int bBatchInsert = ( nInsertBatchSize > 1 );
+
+    if( bBatchInsert )
+    {
+        if( bCopyActive )
+            poDS->EndCopy();
+        poDS->StartInsertBatch( this );
+    }
+    else
+        poDS->EndCopy();
 
 /* -------------------------------------------------------------------- */
 /*      Form the INSERT command.                                        */
@@ -1599,7 +1621,9 @@ OGRErr OGRPGTableLayer::CreateFeatureViaInsert( OGRFeature *poFeature )
     if (!bNeedComma)
         bEmptyInsert = TRUE;
 
-    osCommand += ") VALUES (";
+    osCommand += ") VALUES ";
+    size_t nValuesOffset = osCommand.size();
+    osCommand += "(";
 
     /* Set the geometry */
     bNeedComma = FALSE;
@@ -1723,7 +1747,9 @@ OGRErr OGRPGTableLayer::CreateFeatureViaInsert( OGRFeature *poFeature )
     /* RETURNING is only available since Postgres 8.2 */
     /* We only get the FID, but we also could add the unset fields to get */
     /* the default values */
-    if (bRetrieveFID && pszFIDColumn != NULL && poFeature->GetFID() == OGRNullFID &&
+    /* In batch mode, the FID of the new features is not retrieved */
+    if (!bBatchInsert &&
+        bRetrieveFID && pszFIDColumn != NULL && poFeature->GetFID() == OGRNullFID &&
         (poDS->sPostgreSQLVersion.nMajor >= 9 ||
          (poDS->sPostgreSQLVersion.nMajor == 8 && poDS->sPostgreSQLVersion.nMinor >= 2)))
     {
@@ -1732,6 +1758,47 @@ OGRErr OGRPGTableLayer::CreateFeatureViaInsert( OGRFeature *poFeature )
         osCommand += OGRPGEscapeColumnName(pszFIDColumn);
     }
 
+/* -------------------------------------------------------------------- */
+/*      Append the row to the pending multi-row INSERT, if it targets   */
+/*      the same columns.                                               */
+/* -------------------------------------------------------------------- */
+    if( bBatchInsert && !bEmptyInsert )
+    {
+        if( nInsertBatchCount > 0 &&
+            osCommand.compare(0, nValuesOffset, osInsertBatchHead) != 0 &&
+            FlushInsertBatch() != OGRERR_NONE )
+        {
+            return OGRERR_FAILURE;
+        }
+
+        if( nInsertBatchCount == 0 )
+        {
+            osInsertBatchHead.assign(osCommand, 0, nValuesOffset);
+            osInsertBatch = osCommand;
+        }
+        else
+        {
+            osInsertBatch += ", ";
+            osInsertBatch.append(osCommand, nValuesOffset, std::string::npos);
+        }
+        nInsertBatchCount ++;
+
+        /* Also bound the size of the statement for features with big geometries */
+        if( nInsertBatchCount >= nInsertBatchSize ||
+            osInsertBatch.size() > 16 * 1024 * 1024 )
+        {
+            return FlushInsertBatch();
+        }
+
+        /* The row is not sent yet : its FID is left unset, and an error */
+        /* on it is reported by the call that sends the batch (this one */
+        /* when it is full, SyncToDisk(), or any other request). */
+        return OGRERR_NONE;
+    }
+
+    if( nInsertBatchCount > 0 && FlushInsertBatch() != OGRERR_NONE )
+        return OGRERR_FAILURE;
+
 /* -------------------------------------------------------------------- */
 /*      Execute the insert.                                             */
 /* -------------------------------------------------------------------- */
@@ -1769,6 +1836,40 @@ OGRErr OGRPGTableLayer::CreateFeatureViaInsert( OGRFeature *poFeature )
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                          FlushInsertBatch()                          */
+/*                                                                      */
+/*      Send the pending multi-row INSERT, if any.                      */
+/************************************************************************/
+
+OGRErr OGRPGTableLayer::FlushInsertBatch()
+
+{
+    if( nInsertBatchCount == 0 )
+        return OGRERR_NONE;
+
+    PGconn              *hPGConn = poDS->GetPGConn();
+    OGRErr               eErr = OGRERR_NONE;
+    int                  nCount = nInsertBatchCount;
+
+    nInsertBatchCount = 0;
+
+    PGresult *hResult = OGRPG_PQexec(hPGConn, osInsertBatch);
+    if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "INSERT command for %d new features failed.\n%s",
+                  nCount, PQerrorMessage(hPGConn) );
+        eErr = OGRERR_FAILURE;
+    }
+    OGRPGClearResult( hResult );
+
+    osInsertBatchHead.clear();
+    osInsertBatch.clear();
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                        CreateFeatureViaCopy()                        */
 /************************************************************************/
@@ -1779,9 +1880,16 @@ OGRErr OGRPGTableLayer::CreateFeatureViaCopy( OGRFeature *poFeature )
     CPLString            osCommand;
     int                  i;
 
+    /* Send the rows pending in a multi-row INSERT first */
+    if( nInsertBatchCount > 0 )
+        poDS->EndCopy();
+
     /* Tell the datasource we are now planning to copy data */
     poDS->StartCopy( this ); 
 
+    if( bCopyBinary )
+        return CreateFeatureViaBinaryCopy( poFeature );
+
     /* First process geometry */
     for( i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
     {
@@ -1867,6 +1975,391 @@ OGRErr OGRPGTableLayer::CreateFeatureViaCopy( OGRFeature *poFeature )
 }
 
 
+/************************************************************************/
+/*                    Binary COPY encoding helpers.                     */
+/*                                                                      */
+/*      Values are in network byte order, each field being preceded     */
+/*      by its length, or -1 for NULL.                                  */
+/************************************************************************/
+
+static void OGRPGAppendBinaryInt16( CPLString& osBuffer, GInt16 nVal )
+{
+    CPL_MSBPTR16( &nVal );
+    osBuffer.append( (const char*) &nVal, sizeof(nVal) );
+}
+
+static void OGRPGAppendBinaryInt32( CPLString& osBuffer, GInt32 nVal )
+{
+    CPL_MSBPTR32( &nVal );
+    osBuffer.append( (const char*) &nVal, sizeof(nVal) );
+}
+
+static void OGRPGAppendBinaryInt64( CPLString& osBuffer, GIntBig nVal )
+{
+    CPL_MSBPTR64( &nVal );
+    osBuffer.append( (const char*) &nVal, sizeof(nVal) );
+}
+
+static void OGRPGAppendBinaryField( CPLString& osBuffer,
+                                    const void* pData, int nLen )
+{
+    OGRPGAppendBinaryInt32( osBuffer, nLen );
+    osBuffer.append( (const char*) pData, nLen );
+}
+
+/************************************************************************/
+/*                         PrepareBinaryCopy()                          */
+/*                                                                      */
+/*      Fetch the types of the COPY columns, and check that all of      */
+/*      them can be sent in the binary COPY format. Other types (for    */
+/*      example NUMERIC, dates or arrays) use the text format.          */
+/************************************************************************/
+
+int OGRPGTableLayer::PrepareBinaryCopy( const CPLString& osFields )
+
+{
+    PGconn      *hPGConn = poDS->GetPGConn();
+    CPLString    osCommand;
+    int          i, iCol = 0;
+    int          bOK = TRUE;
+
+    CPLFree( panCopyBinaryTypes );
+    panCopyBinaryTypes = NULL;
+
+    osCommand.Printf( "SELECT %s FROM %s LIMIT 0",
+                      osFields.c_str(), pszSqlTableName );
+    PGresult *hResult = OGRPG_PQexec( hPGConn, osCommand );
+    if( PQresultStatus(hResult) != PGRES_TUPLES_OK )
+    {
+        OGRPGClearResult( hResult );
+        return FALSE;
+    }
+
+    int nCols = PQnfields(hResult);
+    panCopyBinaryTypes = (Oid *) CPLMalloc( sizeof(Oid) * (nCols + 1) );
+    for( i = 0; i < nCols; i++ )
+        panCopyBinaryTypes[i] = PQftype(hResult, i);
+    OGRPGClearResult( hResult );
+
+    for( i = 0; bOK && i < poFeatureDefn->GetGeomFieldCount(); i++ )
+    {
+        OGRPGGeomFieldDefn* poGeomFieldDefn =
+            poFeatureDefn->myGetGeomFieldDefn(i);
+        if( iCol >= nCols )
+            bOK = FALSE;
+        else if( poGeomFieldDefn->ePostgisType == GEOM_TYPE_WKB )
+            bOK = ( panCopyBinaryTypes[iCol] == BYTEAOID );
+        else
+            bOK = ( poGeomFieldDefn->ePostgisType == GEOM_TYPE_GEOMETRY ||
+                    poGeomFieldDefn->ePostgisType == GEOM_TYPE_GEOGRAPHY );
+        iCol ++;
+    }
+
+    int nFIDIndex = -1;
+    if( bOK && bFIDColumnInCopyFields )
+    {
+        nFIDIndex = poFeatureDefn->GetFieldIndex( pszFIDColumn );
+        bOK = ( iCol < nCols && (panCopyBinaryTypes[iCol] == INT4OID ||
+                                 panCopyBinaryTypes[iCol] == INT8OID) );
+        iCol ++;
+    }
+
+    for( i = 0; bOK && i < poFeatureDefn->GetFieldCount(); i++ )
+    {
+        if( i == nFIDIndex )
+            continue;
+        if( iCol >= nCols )
+        {
+            bOK = FALSE;
+            break;
+        }
+
+        OGRFieldDefn* poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        Oid nType = panCopyBinaryTypes[iCol];
+        switch( poFieldDefn->GetType() )
+        {
+            case OFTInteger:
+                if( poFieldDefn->GetSubType() == OFSTBoolean )
+                    bOK = ( nType == BOOLOID );
+                else
+                    bOK = ( nType == INT2OID || nType == INT4OID ||
+                            nType == INT8OID );
+                break;
+
+            case OFTInteger64:
+                bOK = ( nType == INT8OID );
+                break;
+
+            case OFTReal:
+                bOK = ( nType == FLOAT4OID || nType == FLOAT8OID );
+                break;
+
+            case OFTString:
+                bOK = ( nType == TEXTOID || nType == VARCHAROID ||
+                        nType == BPCHAROID );
+                break;
+
+            default:
+                bOK = FALSE;
+                break;
+        }
+        iCol ++;
+    }
+
+    if( !bOK || iCol != nCols )
+    {
+        CPLDebug( "PG", "Binary COPY not possible for %s, using text COPY",
+                  pszSqlTableName );
+        CPLFree( panCopyBinaryTypes );
+        panCopyBinaryTypes = NULL;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                     CreateFeatureViaBinaryCopy()                     */
+/*                                                                      */
+/*      Same as CreateFeatureViaCopy(), but geometries are sent as raw  */
+/*      EWKB and other values in their binary representation, which     */
+/*      avoids the hex and text formatting and parsing.                 */
+/************************************************************************/
+
+OGRErr OGRPGTableLayer::CreateFeatureViaBinaryCopy( OGRFeature *poFeature )
+{
+    PGconn              *hPGConn = poDS->GetPGConn();
+    CPLString            osCommand;
+    int                  i, iCol = 0;
+
+    /* The number of fields is patched at the end */
+    OGRPGAppendBinaryInt16( osCommand, 0 );
+
+/* -------------------------------------------------------------------- */
+/*      Geometries, as EWKB or WKB for bytea columns.                   */
+/* -------------------------------------------------------------------- */
+    for( i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++, iCol++ )
+    {
+        OGRPGGeomFieldDefn* poGeomFieldDefn =
+            poFeatureDefn->myGetGeomFieldDefn(i);
+        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(i);
+
+        if ( NULL == poGeom )
+        {
+            OGRPGAppendBinaryInt32( osCommand, -1 );
+            continue;
+        }
+
+        CheckGeomTypeCompatibility(i, poGeom);
+
+        poGeom->closeRings();
+        poGeom->setCoordinateDimension( poGeomFieldDefn->nCoordDimension );
+
+        int bIsPostGIS1 = poDS->sPostGISVersion.nMajor < 2;
+        int nSRSId = ( poGeomFieldDefn->ePostgisType == GEOM_TYPE_WKB ) ?
+                                            0 : poGeomFieldDefn->nSRSId;
+        int nWkbSize = poGeom->WkbSize();
+        int nHeaderSize = ( nSRSId > 0 ) ? 4 : 0;
+        GByte *pabyWKB = (GByte *) CPLMalloc(nWkbSize + nHeaderSize);
+
+        if( poGeom->exportToWkb( wkbNDR, pabyWKB + nHeaderSize,
+                                 bIsPostGIS1 ? wkbVariantPostGIS1 : wkbVariantOldOgc ) != OGRERR_NONE )
+        {
+            CPLFree( pabyWKB );
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Cannot export geometry to WKB" );
+            return OGRERR_FAILURE;
+        }
+
+        /* Insert the SRID after the byte order and geometry type */
+        if( nSRSId > 0 )
+        {
+            memmove( pabyWKB, pabyWKB + 4, 5 );
+
+            GUInt32 nGeomType;
+            memcpy( &nGeomType, pabyWKB + 1, 4 );
+            nGeomType |= CPL_LSBWORD32( 0x20000000 ); /* SRID flag */
+            memcpy( pabyWKB + 1, &nGeomType, 4 );
+
+            GUInt32 nGSRSId = CPL_LSBWORD32( nSRSId );
+            memcpy( pabyWKB + 5, &nGSRSId, 4 );
+        }
+
+        OGRPGAppendBinaryField( osCommand, pabyWKB, nWkbSize + nHeaderSize );
+        CPLFree( pabyWKB );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      FID.                                                            */
+/* -------------------------------------------------------------------- */
+    int nFIDIndex = -1;
+    if( bFIDColumnInCopyFields )
+    {
+        nFIDIndex = poFeatureDefn->GetFieldIndex( pszFIDColumn );
+
+        GIntBig nFID = poFeature->GetFID();
+        if( nFID == OGRNullFID )
+            OGRPGAppendBinaryInt32( osCommand, -1 );
+        else if( panCopyBinaryTypes[iCol] == INT8OID )
+        {
+            OGRPGAppendBinaryInt32( osCommand, 8 );
+            OGRPGAppendBinaryInt64( osCommand, nFID );
+        }
+        else
+        {
+            if( nFID != (GIntBig)(GInt32) nFID )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "FID " CPL_FRMT_GIB " is out of range for the integer column %s",
+                          nFID, pszFIDColumn );
+                return OGRERR_FAILURE;
+            }
+            OGRPGAppendBinaryInt32( osCommand, 4 );
+            OGRPGAppendBinaryInt32( osCommand, (GInt32) nFID );
+        }
+        iCol ++;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Attributes.                                                     */
+/* -------------------------------------------------------------------- */
+    int nFieldCount = poFeatureDefn->GetFieldCount();
+    for( i = 0; i < nFieldCount; i++ )
+    {
+        if( i == nFIDIndex )
+            continue;
+
+        Oid nType = panCopyBinaryTypes[iCol++];
+
+        if( !poFeature->IsFieldSet( i ) )
+        {
+            OGRPGAppendBinaryInt32( osCommand, -1 );
+            continue;
+        }
+
+        switch( nType )
+        {
+            case BOOLOID:
+            {
+                GByte bVal = (GByte)( poFeature->GetFieldAsInteger(i) != 0 );
+                OGRPGAppendBinaryField( osCommand, &bVal, 1 );
+                break;
+            }
+
+            case INT2OID:
+            {
+                int nVal = poFeature->GetFieldAsInteger(i);
+                if( nVal < -32768 || nVal > 32767 )
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                              "Value %d of field %s is out of range for a smallint column",
+                              nVal, poFeatureDefn->GetFieldDefn(i)->GetNameRef() );
+                    return OGRERR_FAILURE;
+                }
+                OGRPGAppendBinaryInt32( osCommand, 2 );
+                OGRPGAppendBinaryInt16( osCommand, (GInt16) nVal );
+                break;
+            }
+
+            case INT4OID:
+            {
+                GIntBig nVal = poFeature->GetFieldAsInteger64(i);
+                if( nVal != (GIntBig)(GInt32) nVal )
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                              "Value " CPL_FRMT_GIB " of field %s is out of range for an integer column",
+                              nVal, poFeatureDefn->GetFieldDefn(i)->GetNameRef() );
+                    return OGRERR_FAILURE;
+                }
+                OGRPGAppendBinaryInt32( osCommand, 4 );
+                OGRPGAppendBinaryInt32( osCommand, (GInt32) nVal );
+                break;
+            }
+
+            case INT8OID:
+                OGRPGAppendBinaryInt32( osCommand, 8 );
+                OGRPGAppendBinaryInt64( osCommand,
+                                        poFeature->GetFieldAsInteger64(i) );
+                break;
+
+            case FLOAT4OID:
+            {
+                float fVal = (float) poFeature->GetFieldAsDouble(i);
+                CPL_MSBPTR32( &fVal );
+                OGRPGAppendBinaryField( osCommand, &fVal, 4 );
+                break;
+            }
+
+            case FLOAT8OID:
+            {
+                double dfVal = poFeature->GetFieldAsDouble(i);
+                CPL_MSBPTR64( &dfVal );
+                OGRPGAppendBinaryField( osCommand, &dfVal, 8 );
+                break;
+            }
+
+            default: /* TEXTOID, VARCHAROID, BPCHAROID */
+            {
+                const char *pszStrValue = poFeature->GetFieldAsString(i);
+                int nLen = (int) strlen(pszStrValue);
+                int nMaxWidth = poFeatureDefn->GetFieldDefn(i)->GetWidth();
+
+                if( nMaxWidth > 0 )
+                {
+                    int iChar, iUTFChar = 0;
+                    for( iChar = 0; iChar < nLen; iChar++ )
+                    {
+                        if ((pszStrValue[iChar] & 0xc0) != 0x80)
+                        {
+                            if( iUTFChar == nMaxWidth )
+                            {
+                                CPLDebug( "PG",
+                                        "Truncated %s field value, it was too long.",
+                                        poFeatureDefn->GetFieldDefn(i)->GetNameRef() );
+                                nLen = iChar;
+                                break;
+                            }
+                            iUTFChar++;
+                        }
+                    }
+                }
+                OGRPGAppendBinaryField( osCommand, pszStrValue, nLen );
+                break;
+            }
+        }
+    }
+
+    GInt16 nFields = (GInt16) iCol;
+    CPL_MSBPTR16( &nFields );
+    memcpy( &osCommand[0], &nFields, 2 );
+
+/* -------------------------------------------------------------------- */
+/*      Execute the copy.                                               */
+/* -------------------------------------------------------------------- */
+    OGRErr result = OGRERR_NONE;
+
+#if !defined(PG_PRE74)
+    int copyResult = PQputCopyData(hPGConn, osCommand.data(), (int) osCommand.size());
+    switch (copyResult)
+    {
+    case 0:
+        CPLError( CE_Failure, CPLE_AppDefined, "Writing COPY data blocked.");
+        result = OGRERR_FAILURE;
+        break;
+    case -1:
+        CPLError( CE_Failure, CPLE_AppDefined, "%s", PQerrorMessage(hPGConn) );
+        result = OGRERR_FAILURE;
+        break;
+    }
+#else
+    /* Never reached: binary COPY is not used with pre-7.4 libpq */
+    (void) hPGConn;
+    result = OGRERR_FAILURE;
+#endif
+
+    return result;
+}
+
 /************************************************************************/
 /*                           TestCapability()                           */
 /************************************************************************/
@@ -2710,12 +3203,21 @@ OGRErr OGRPGTableLayer::StartCopy()
 
     CPLString osFields = BuildCopyFields();
 
+    /* The binary format is opt-in, and only used if all the columns */
+    /* have a type we know how to encode */
+    bCopyBinary = FALSE;
+#if !defined(PG_PRE74)
+    if( CSLTestBoolean( CPLGetConfigOption( "PG_USE_COPY_BINARY", "NO") ) )
+        bCopyBinary = PrepareBinaryCopy( osFields );
+#endif
+
     int size = strlen(osFields) +  strlen(pszSqlTableName) + 100;
     char *pszCommand = (char *) CPLMalloc(size);
 
     sprintf( pszCommand,
-             "COPY %s (%s) FROM STDIN;",
-             pszSqlTableName, osFields.c_str() );
+             "COPY %s (%s) FROM STDIN%s;",
+             pszSqlTableName, osFields.c_str(),
+             bCopyBinary ? " BINARY" : "" );
 
     PGconn *hPGConn = poDS->GetPGConn();
     PGresult *hResult = OGRPG_PQexec(hPGConn, pszCommand);
@@ -2726,14 +3228,46 @@ OGRErr OGRPGTableLayer::StartCopy()
                   "%s", PQerrorMessage(hPGConn) );
     }
     else
+    {
         bCopyActive = TRUE;
 
+#if !defined(PG_PRE74)
+        /* Signature, flags and header extension length */
+        static const GByte abyBinaryHeader[19] =
+            { 'P', 'G', 'C', 'O', 'P', 'Y', '\n', 0xFF, '\r', '\n', '\0',
+              0, 0, 0, 0, 0, 0, 0, 0 };
+        if( bCopyBinary &&
+            PQputCopyData(hPGConn, (const char*) abyBinaryHeader,
+                          sizeof(abyBinaryHeader)) != 1 )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "%s", PQerrorMessage(hPGConn) );
+        }
+#endif
+    }
+
     OGRPGClearResult( hResult );
     CPLFree( pszCommand );
 
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                             SyncToDisk()                             */
+/*                                                                      */
+/*      Send the rows of a pending COPY or multi-row INSERT, and report  */
+/*      whether they could be inserted.                                 */
+/************************************************************************/
+
+OGRErr OGRPGTableLayer::SyncToDisk()
+
+{
+    if( bCopyActive || nInsertBatchCount > 0 )
+        return poDS->EndCopy();
+
+    return OGRERR_NONE;
+}
+
 /************************************************************************/
 /*                              EndCopy()                               */
 /************************************************************************/
@@ -2741,6 +3275,10 @@ OGRErr OGRPGTableLayer::StartCopy()
 OGRErr OGRPGTableLayer::EndCopy()
 
 {
+    /* Rows accumulated in a multi-row INSERT are sent the same way */
+    if( nInsertBatchCount > 0 )
+        return FlushInsertBatch();
+
     if( !bCopyActive )
         return OGRERR_NONE;
     /*CPLDebug("PG", "OGRPGDataSource(%p)::EndCopy(%p)", poDS, this);*/
@@ -2756,6 +3294,14 @@ OGRErr OGRPGTableLayer::EndCopy()
 
     /* This is for postgresql 7.4 and higher */
 #if !defined(PG_PRE74)
+    if( bCopyBinary )
+    {
+        /* File trailer: a field count of -1 */
+        static const GByte abyBinaryTrailer[2] = { 0xFF, 0xFF };
+        PQputCopyData(hPGConn, (const char*) abyBinaryTrailer,
+                      sizeof(abyBinaryTrailer));
+    }
+
     int copyResult = PQputCopyEnd(hPGConn, NULL);
 
     switch (copyResult)
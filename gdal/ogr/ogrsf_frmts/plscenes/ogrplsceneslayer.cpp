@@ -431,6 +431,7 @@ OGRErr OGRPLScenesLayer::SetAttributeFilter( const char *pszQuery )
         swq_expr_node* poNode = (swq_expr_node*) m_poAttrQuery->GetSWQExpr();
 
         poNode->ReplaceBetweenByGEAndLERecurse();
+        m_poAttrQuery->ExpressionChanged();
 
         if( poNode->eNodeType == SNT_OPERATION &&
             poNode->nOperation == SWQ_EQ && poNode->nSubExprCount == 2 &&
@@ -49,8 +49,14 @@
 /* ==================================================================== */
 OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                                OGRFeatureDefn * poDefn, int iShape, 
-                               SHPObject *psShape, const char *pszSHPEncoding );
-OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape );
+                               SHPObject *psShape, const char *pszSHPEncoding,
+                               OGRFeature *poFeatureToReuse = NULL );
+int SHPReadOGRFeatureToBatch( SHPHandle hSHP, DBFHandle hDBF,
+                              OGRFeatureDefn * poDefn, int iShape,
+                              const char *pszSHPEncoding,
+                              OGRFeatureBatch *poBatch );
+OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape,
+                               OGRGeometry *poGeomToReuse = NULL );
 OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
                                        SHPHandle hSHP, DBFHandle hDBF,
                                        const char *pszSHPEncoding,
@@ -130,12 +136,19 @@ class OGRShapeLayer : public OGRAbstractProxiedLayer
     SHPTreeDiskHandle   hQIX;
     int                 CheckForQIX();
 
+    int                 bCheckedForHRX;
+    int                 bHRXOutOfDate;
+    SHPRTreeHandle      hHRX;
+    int                 CheckForHRX();
+
     int                 bCheckedForSBN;
     SBNSearchHandle     hSBN;
     int                 CheckForSBN();
 
     int                 bSbnSbxDeleted;
 
+    int                 HasSpatialIndexFiles();
+
     CPLString           ConvertCodePage( const char * );
     CPLString           osEncoding;
 
@@ -163,7 +176,8 @@ class OGRShapeLayer : public OGRAbstractProxiedLayer
 /* the layer is properly re-opened if necessary */
 
   public:
-    OGRErr              CreateSpatialIndex( int nMaxDepth );
+    OGRErr              CreateSpatialIndex( int nMaxDepth,
+                                            int bHilbertRTree = FALSE );
     OGRErr              DropSpatialIndex();
     OGRErr              Repack();
     OGRErr              RecomputeExtent();
@@ -173,7 +187,9 @@ class OGRShapeLayer : public OGRAbstractProxiedLayer
 
     const char         *GetFullName() { return pszFullName; }
 
-    OGRFeature *        FetchShape(int iShapeId);
+    OGRFeature *        FetchShape(int iShapeId,
+                                   OGRFeature *poFeatureToReuse = NULL);
+    OGRFeature *        GetNextFeatureInternal(OGRFeature *poFeatureToReuse);
     int                 GetFeatureCountWithSpatialFilterOnly();
 
   public:
@@ -188,6 +204,9 @@ class OGRShapeLayer : public OGRAbstractProxiedLayer
 
     void                ResetReading();
     OGRFeature *        GetNextFeature();
+    virtual int         GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures );
+    virtual int         IGetNextFeatureInPlace( OGRFeature *poFeature );
     virtual OGRErr      SetNextByIndex( GIntBig nIndex );
 
     OGRFeature         *GetFeature( GIntBig nFeatureId );
@@ -847,6 +847,7 @@ OGRLayer *OGRShapeDataSource::GetLayerByName(const char * pszLayerNameIn)
 /*      SPATIAL INDEX commands.  Support forms are:                     */
 /*                                                                      */
 /*        CREATE SPATIAL INDEX ON layer_name [DEPTH n]                  */
+/*        CREATE SPATIAL INDEX ON layer_name TYPE QIX|HRX               */
 /*        DROP SPATIAL INDEX ON layer_name                              */
 /*        REPACK layer_name                                             */
 /*        RECOMPUTE EXTENT ON layer_name                                */
@@ -972,23 +973,30 @@ OGRLayer * OGRShapeDataSource::ExecuteSQL( const char *pszStatement,
         || !EQUAL(papszTokens[2],"INDEX") 
         || !EQUAL(papszTokens[3],"ON") 
         || CSLCount(papszTokens) > 7 
-        || (CSLCount(papszTokens) == 7 && !EQUAL(papszTokens[5],"DEPTH")) )
+        || CSLCount(papszTokens) == 6
+        || (CSLCount(papszTokens) == 7 && !EQUAL(papszTokens[5],"DEPTH") &&
+            !(EQUAL(papszTokens[5],"TYPE") &&
+              (EQUAL(papszTokens[6],"QIX") || EQUAL(papszTokens[6],"HRX")))) )
     {
         CSLDestroy( papszTokens );
         CPLError( CE_Failure, CPLE_AppDefined, 
                   "Syntax error in CREATE SPATIAL INDEX command.\n"
                   "Was '%s'\n"
-                  "Should be of form 'CREATE SPATIAL INDEX ON <table> [DEPTH <n>]'",
+                  "Should be of form 'CREATE SPATIAL INDEX ON <table> [DEPTH <n>]' "
+                  "or 'CREATE SPATIAL INDEX ON <table> TYPE QIX|HRX'",
                   pszStatement );
         return NULL;
     }
 
 /* -------------------------------------------------------------------- */
-/*      Get depth if provided.                                          */
+/*      Get depth or index type if provided.                            */
 /* -------------------------------------------------------------------- */
     int nDepth = 0;
-    if( CSLCount(papszTokens) == 7 )
+    int bHilbertRTree = FALSE;
+    if( CSLCount(papszTokens) == 7 && EQUAL(papszTokens[5],"DEPTH") )
         nDepth = atoi(papszTokens[6]);
+    else if( CSLCount(papszTokens) == 7 )
+        bHilbertRTree = EQUAL(papszTokens[6],"HRX");
 
 /* -------------------------------------------------------------------- */
 /*      What layer are we operating on.                                 */
@@ -1006,7 +1014,7 @@ OGRLayer * OGRShapeDataSource::ExecuteSQL( const char *pszStatement,
 
     CSLDestroy( papszTokens );
 
-    poLayer->CreateSpatialIndex( nDepth );
+    poLayer->CreateSpatialIndex( nDepth, bHilbertRTree );
     return NULL;
 }
 
@@ -1060,6 +1068,7 @@ OGRErr OGRShapeDataSource::DeleteLayer( int iLayer )
     VSIUnlink( CPLResetExtension(pszFilename, "dbf") );
     VSIUnlink( CPLResetExtension(pszFilename, "prj") );
     VSIUnlink( CPLResetExtension(pszFilename, "qix") );
+    VSIUnlink( CPLResetExtension(pszFilename, "hrx") );
 
     CPLFree( pszFilename );
 
@@ -176,7 +176,7 @@ static CPLErr OGRShapeDriverDelete( const char *pszDataSource )
     VSIStatBufL sStatBuf;
     static const char *apszExtensions[] = 
         { "shp", "shx", "dbf", "sbn", "sbx", "prj", "idm", "ind", 
-          "qix", "cpg", NULL };
+          "btm", "bti", "qix", "hrx", "cpg", NULL };
 
     if( VSIStatL( pszDataSource, &sStatBuf ) != 0 )
     {
@@ -199,6 +199,29 @@ static CPLErr OGRShapeDriverDelete( const char *pszDataSource )
             if( VSIStatL( pszFile, &sStatBuf ) == 0 )
                 VSIUnlink( pszFile );
         }
+
+/* -------------------------------------------------------------------- */
+/*      B-tree attribute indexes are in <basename>.<field>.bti files.   */
+/* -------------------------------------------------------------------- */
+        CPLString osPath = CPLGetPath( pszDataSource );
+        CPLString osBasename = CPLGetBasename( pszDataSource );
+        char **papszDirEntries =
+            CPLReadDir( osPath.empty() ? "." : osPath.c_str() );
+
+        for( int iFile = 0;
+             papszDirEntries != NULL && papszDirEntries[iFile] != NULL;
+             iFile++ )
+        {
+            if( EQUAL(CPLGetExtension(papszDirEntries[iFile]), "bti")
+                && EQUAL(CPLGetBasename(CPLGetBasename(papszDirEntries[iFile])),
+                         osBasename) )
+            {
+                VSIUnlink( CPLFormFilename( osPath, papszDirEntries[iFile],
+                                            NULL ) );
+            }
+        }
+
+        CSLDestroy( papszDirEntries );
     }
     else if( VSI_ISDIR(sStatBuf.st_mode) )
     {
@@ -79,6 +79,10 @@ OGRShapeLayer::OGRShapeLayer( OGRShapeDataSource* poDSIn,
     bCheckedForQIX = FALSE;
     hQIX = NULL;
 
+    bCheckedForHRX = FALSE;
+    bHRXOutOfDate = FALSE;
+    hHRX = NULL;
+
     bCheckedForSBN = FALSE;
     hSBN = NULL;
 
@@ -215,6 +219,9 @@ OGRShapeLayer::~OGRShapeLayer()
     if( hQIX != NULL )
         SHPCloseDiskTree( hQIX );
 
+    if( hHRX != NULL )
+        SHPCloseRTree( hHRX );
+
     if( hSBN != NULL )
         SBNCloseDiskTree( hSBN );
 }
@@ -376,6 +383,44 @@ int OGRShapeLayer::CheckForQIX()
     return hQIX != NULL;
 }
 
+/************************************************************************/
+/*                            CheckForHRX()                             */
+/************************************************************************/
+
+int OGRShapeLayer::CheckForHRX()
+
+{
+    const char *pszHRXFilename;
+
+    if( bCheckedForHRX )
+        return hHRX != NULL;
+
+    bCheckedForHRX = TRUE;
+
+    if( hSHP == NULL )
+        return FALSE;
+
+    pszHRXFilename = CPLResetExtension( pszFullName, "hrx" );
+
+    hHRX = SHPOpenRTree( pszHRXFilename, NULL );
+
+/* -------------------------------------------------------------------- */
+/*      Ignore an index built before shapes were added by another       */
+/*      application.                                                    */
+/* -------------------------------------------------------------------- */
+    if( hHRX != NULL && SHPGetRTreeRecordCount( hHRX ) != hSHP->nRecords )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "%s is out of date and will be ignored. "
+                  "It should be recreated.", pszHRXFilename );
+        SHPCloseRTree( hHRX );
+        hHRX = NULL;
+        bHRXOutOfDate = TRUE;
+    }
+
+    return hHRX != NULL;
+}
+
 /************************************************************************/
 /*                            CheckForSBN()                             */
 /************************************************************************/
@@ -397,6 +442,24 @@ int OGRShapeLayer::CheckForSBN()
     return hSBN != NULL;
 }
 
+/************************************************************************/
+/*                        HasSpatialIndexFiles()                        */
+/*                                                                      */
+/*      Returns TRUE if any spatial index file (.hrx, .qix or .sbn)     */
+/*      is present, including an out of date .hrx.  All the checks      */
+/*      are run, so that DropSpatialIndex() sees every open index.      */
+/************************************************************************/
+
+int OGRShapeLayer::HasSpatialIndexFiles()
+
+{
+    int bHasHRX = CheckForHRX() || bHRXOutOfDate;
+    int bHasQIX = CheckForQIX();
+    int bHasSBN = CheckForSBN();
+
+    return bHasHRX || bHasQIX || bHasSBN;
+}
+
 /************************************************************************/
 /*                            ScanIndices()                             */
 /*                                                                      */
@@ -459,16 +522,19 @@ int OGRShapeLayer::ScanIndices()
 
     if( bTryQIXorSBN )
     {
-        if( !bCheckedForQIX )
+        if( !bCheckedForHRX )
+            CheckForHRX();
+        if( hHRX == NULL && !bCheckedForQIX )
             CheckForQIX();
-        if( hQIX == NULL && !bCheckedForSBN )
+        if( hHRX == NULL && hQIX == NULL && !bCheckedForSBN )
             CheckForSBN();
     }
 
 /* -------------------------------------------------------------------- */
 /*      Compute spatial index if appropriate.                           */
 /* -------------------------------------------------------------------- */
-    if( bTryQIXorSBN && (hQIX != NULL || hSBN != NULL) && panSpatialFIDs == NULL )
+    if( bTryQIXorSBN && (hHRX != NULL || hQIX != NULL || hSBN != NULL) &&
+        panSpatialFIDs == NULL )
     {
         double adfBoundsMin[4], adfBoundsMax[4];
 
@@ -481,7 +547,11 @@ int OGRShapeLayer::ScanIndices()
         adfBoundsMax[2] = 0.0;
         adfBoundsMax[3] = 0.0;
 
-        if( hQIX != NULL )
+        if( hHRX != NULL )
+            panSpatialFIDs = SHPSearchRTree( hHRX,
+                                             adfBoundsMin, adfBoundsMax,
+                                             &nSpatialFIDCount );
+        else if( hQIX != NULL )
             panSpatialFIDs = SHPSearchDiskTreeEx( hQIX,
                                                   adfBoundsMin, adfBoundsMax,
                                                   &nSpatialFIDCount );
@@ -672,7 +742,8 @@ OGRErr OGRShapeLayer::SetNextByIndex( GIntBig nIndex )
 /*      if the shapeid bbox intersects the geometry.                    */
 /************************************************************************/
 
-OGRFeature *OGRShapeLayer::FetchShape(int iShapeId /*, OGREnvelope* psShapeExtent */)
+OGRFeature *OGRShapeLayer::FetchShape(int iShapeId /*, OGREnvelope* psShapeExtent */,
+                                      OGRFeature *poFeatureToReuse)
 
 {
     OGRFeature *poFeature;
@@ -694,7 +765,8 @@ OGRFeature *OGRShapeLayer::FetchShape(int iShapeId /*, OGREnvelope* psShapeExten
             || psShape->nSHPType == SHPT_NULL )
         {
             poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
-                                           iShapeId, psShape, osEncoding );
+                                           iShapeId, psShape, osEncoding,
+                                           poFeatureToReuse );
         }
         else if( m_sFilterEnvelope.MaxX < psShape->dfXMin 
                  || m_sFilterEnvelope.MaxY < psShape->dfYMin
@@ -711,13 +783,15 @@ OGRFeature *OGRShapeLayer::FetchShape(int iShapeId /*, OGREnvelope* psShapeExten
             psShapeExtent->MaxX = psShape->dfXMax;
             psShapeExtent->MaxY = psShape->dfYMax;*/
             poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
-                                           iShapeId, psShape, osEncoding );
+                                           iShapeId, psShape, osEncoding,
+                                           poFeatureToReuse );
         }                
     } 
     else 
     {
         poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
-                                       iShapeId, NULL, osEncoding );
+                                       iShapeId, NULL, osEncoding,
+                                       poFeatureToReuse );
     }    
     
     return poFeature;
@@ -729,6 +803,34 @@ OGRFeature *OGRShapeLayer::FetchShape(int iShapeId /*, OGREnvelope* psShapeExten
 
 OGRFeature *OGRShapeLayer::GetNextFeature()
 
+{
+    return GetNextFeatureInternal( NULL );
+}
+
+/************************************************************************/
+/*                       IGetNextFeatureInPlace()                       */
+/************************************************************************/
+
+int OGRShapeLayer::IGetNextFeatureInPlace( OGRFeature *poFeature )
+
+{
+    if( GetNextFeatureInternal( poFeature ) == NULL )
+    {
+        poFeature->Reset();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                       GetNextFeatureInternal()                       */
+/*                                                                      */
+/*      Read the next feature matching the filters, into                */
+/*      poFeatureToReuse if it is not NULL.                             */
+/************************************************************************/
+
+OGRFeature *OGRShapeLayer::GetNextFeatureInternal( OGRFeature *poFeatureToReuse )
+
 {
     if (!TouchLayer())
         return NULL;
@@ -762,7 +864,8 @@ OGRFeature *OGRShapeLayer::GetNextFeature()
             
             // Check the shape object's geometry, and if it matches
             // any spatial filter, return it.  
-            poFeature = FetchShape((int)panMatchingFIDs[iMatchingFID] /*, &oShapeExtent*/);
+            poFeature = FetchShape((int)panMatchingFIDs[iMatchingFID] /*, &oShapeExtent*/,
+                                   poFeatureToReuse);
             
             iMatchingFID++;
 
@@ -781,10 +884,12 @@ OGRFeature *OGRShapeLayer::GetNextFeature()
                 else if( VSIFEofL(VSI_SHP_GetVSIL(hDBF->fp)) )
                     return NULL; /* There's an I/O error */
                 else
-                    poFeature = FetchShape(iNextShapeId /*, &oShapeExtent */);
+                    poFeature = FetchShape(iNextShapeId /*, &oShapeExtent */,
+                                           poFeatureToReuse);
             }
             else
-                poFeature = FetchShape(iNextShapeId /*, &oShapeExtent */);
+                poFeature = FetchShape(iNextShapeId /*, &oShapeExtent */,
+                                       poFeatureToReuse);
 
             iNextShapeId++;
         }
@@ -805,11 +910,57 @@ OGRFeature *OGRShapeLayer::GetNextFeature()
                 return poFeature;
             }
 
-            delete poFeature;
+            if( poFeature != poFeatureToReuse )
+                delete poFeature;
         }
     }
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/*                                                                      */
+/*      Without filters, read the shapes and DBF records directly       */
+/*      into the batch.  Otherwise use the generic implementation.      */
+/************************************************************************/
+
+int OGRShapeLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                        int nMaxFeatures )
+
+{
+    if( m_poAttrQuery != NULL || m_poFilterGeom != NULL ||
+        panMatchingFIDs != NULL )
+        return OGRLayer::GetNextFeatureBatch( poBatch, nMaxFeatures );
+
+    poBatch->Reset();
+
+    if( !ValidateFeatureBatch( poBatch ) || !TouchLayer() )
+        return 0;
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures &&
+           iNextShapeId < nTotalShapeCount )
+    {
+        if( hDBF )
+        {
+            if( DBFIsRecordDeleted( hDBF, iNextShapeId ) )
+            {
+                iNextShapeId++;
+                continue;
+            }
+            if( VSIFEofL(VSI_SHP_GetVSIL(hDBF->fp)) )
+                break; /* There's an I/O error */
+        }
+
+        if( !SHPReadOGRFeatureToBatch( hSHP, hDBF, poFeatureDefn,
+                                       iNextShapeId, osEncoding, poBatch ) )
+            break;
+
+        iNextShapeId++;
+        m_nFeaturesRead++;
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                             GetFeature()                             */
 /************************************************************************/
@@ -869,7 +1020,7 @@ OGRErr OGRShapeLayer::ISetFeature( OGRFeature *poFeature )
     }
 
     bHeaderDirty = TRUE;
-    if( CheckForQIX() || CheckForSBN() )
+    if( HasSpatialIndexFiles() )
         DropSpatialIndex();
 
     unsigned int nOffset = 0;
@@ -939,7 +1090,7 @@ OGRErr OGRShapeLayer::DeleteFeature( GIntBig nFID )
         return OGRERR_FAILURE;
 
     bHeaderDirty = TRUE;
-    if( CheckForQIX() || CheckForSBN() )
+    if( HasSpatialIndexFiles() )
         DropSpatialIndex();
 
     return OGRERR_NONE;
@@ -972,7 +1123,7 @@ OGRErr OGRShapeLayer::ICreateFeature( OGRFeature *poFeature )
     }
 
     bHeaderDirty = TRUE;
-    if( CheckForQIX() || CheckForSBN() )
+    if( HasSpatialIndexFiles() )
         DropSpatialIndex();
 
     poFeature->SetFID( OGRNullFID );
@@ -1393,7 +1544,8 @@ int OGRShapeLayer::TestCapability( const char * pszCap )
 
     else if( EQUAL(pszCap,OLCFastFeatureCount) )
     {
-        if( !(m_poFilterGeom == NULL || CheckForQIX() || CheckForSBN()) )
+        if( !(m_poFilterGeom == NULL || CheckForHRX() || CheckForQIX() ||
+              CheckForSBN()) )
             return FALSE;
 
         if( m_poAttrQuery != NULL )
@@ -1408,7 +1560,7 @@ int OGRShapeLayer::TestCapability( const char * pszCap )
         return bUpdateAccess;
 
     else if( EQUAL(pszCap,OLCFastSpatialFilter) )
-        return CheckForQIX() || CheckForSBN();
+        return CheckForHRX() || CheckForQIX() || CheckForSBN();
 
     else if( EQUAL(pszCap,OLCFastGetExtent) )
         return TRUE;
@@ -2055,7 +2207,7 @@ OGRErr OGRShapeLayer::DropSpatialIndex()
     if (!TouchLayer())
         return OGRERR_FAILURE;
 
-    if( !CheckForQIX() && !CheckForSBN() )
+    if( !HasSpatialIndexFiles() )
     {
         CPLError( CE_Warning, CPLE_AppDefined, 
                   "Layer %s has no spatial index, DROP SPATIAL INDEX failed.",
@@ -2063,28 +2215,42 @@ OGRErr OGRShapeLayer::DropSpatialIndex()
         return OGRERR_FAILURE;
     }
 
-    int bHadQIX = hQIX != NULL;
-
     SHPCloseDiskTree( hQIX );
     hQIX = NULL;
     bCheckedForQIX = FALSE;
 
+    SHPCloseRTree( hHRX );
+    hHRX = NULL;
+    bCheckedForHRX = FALSE;
+    bHRXOutOfDate = FALSE;
+
     SBNCloseDiskTree( hSBN );
     hSBN = NULL;
     bCheckedForSBN = FALSE;
 
-    if( bHadQIX )
+/* -------------------------------------------------------------------- */
+/*      Remove both the .qix and the .hrx whatever index was in use,    */
+/*      so that none of them is left behind out of date.                */
+/* -------------------------------------------------------------------- */
+    const char papszOwnExt[2][4] = { "qix", "hrx" };
+    int iExt;
+    for( iExt = 0; iExt < 2; iExt++ )
     {
-        const char *pszQIXFilename;
+        const char *pszIndexFilename;
+        VSIStatBufL sStatBuf;
+
+        pszIndexFilename = CPLResetExtension( pszFullName, papszOwnExt[iExt] );
+        if( VSIStatExL( pszIndexFilename, &sStatBuf,
+                        VSI_STAT_EXISTS_FLAG ) != 0 )
+            continue;
 
-        pszQIXFilename = CPLResetExtension( pszFullName, "qix" );
-        CPLDebug( "SHAPE", "Unlinking index file %s", pszQIXFilename );
+        CPLDebug( "SHAPE", "Unlinking index file %s", pszIndexFilename );
 
-        if( VSIUnlink( pszQIXFilename ) != 0 )
+        if( VSIUnlink( pszIndexFilename ) != 0 )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
                     "Failed to delete file %s.\n%s",
-                    pszQIXFilename, VSIStrerror( errno ) );
+                    pszIndexFilename, VSIStrerror( errno ) );
             return OGRERR_FAILURE;
         }
     }
@@ -2116,9 +2282,12 @@ OGRErr OGRShapeLayer::DropSpatialIndex()
 
 /************************************************************************/
 /*                         CreateSpatialIndex()                         */
+/*                                                                      */
+/*      Create a .qix quadtree, or with bHilbertRTree a .hrx packed     */
+/*      Hilbert R-tree, in which case nMaxDepth is ignored.             */
 /************************************************************************/
 
-OGRErr OGRShapeLayer::CreateSpatialIndex( int nMaxDepth )
+OGRErr OGRShapeLayer::CreateSpatialIndex( int nMaxDepth, int bHilbertRTree )
 
 {
     if (!TouchLayer())
@@ -2127,10 +2296,36 @@ OGRErr OGRShapeLayer::CreateSpatialIndex( int nMaxDepth )
 /* -------------------------------------------------------------------- */
 /*      If we have an existing spatial index, blow it away first.       */
 /* -------------------------------------------------------------------- */
-    if( CheckForQIX() )
+    int bHasHRX = CheckForHRX() || bHRXOutOfDate;
+    int bHasQIX = CheckForQIX();
+    if( bHasHRX || bHasQIX )
         DropSpatialIndex();
 
     bCheckedForQIX = FALSE;
+    bCheckedForHRX = FALSE;
+    bHRXOutOfDate = FALSE;
+
+/* -------------------------------------------------------------------- */
+/*      Build the packed Hilbert R-tree in one pass over the shapes.    */
+/* -------------------------------------------------------------------- */
+    if( bHilbertRTree )
+    {
+        if( hSHP == NULL )
+            return OGRERR_FAILURE;
+
+        SyncToDisk();
+
+        CPLString osHRXFilename = CPLResetExtension( pszFullName, "hrx" );
+
+        CPLDebug( "SHAPE", "Creating index file %s", osHRXFilename.c_str() );
+
+        if( !SHPWriteRTree( hSHP, osHRXFilename, 0, NULL ) )
+            return OGRERR_FAILURE;
+
+        CheckForHRX();
+
+        return OGRERR_NONE;
+    }
 
 /* -------------------------------------------------------------------- */
 /*      Build a quadtree structure for this file.                       */
@@ -2323,7 +2518,7 @@ OGRErr OGRShapeLayer::Repack()
 /*      Cleanup any existing spatial index.  It will become             */
 /*      meaningless when the fids change.                               */
 /* -------------------------------------------------------------------- */
-    if( CheckForQIX() || CheckForSBN() )
+    if( HasSpatialIndexFiles() )
         DropSpatialIndex();
 
 /* -------------------------------------------------------------------- */
@@ -2853,6 +3048,12 @@ void OGRShapeLayer::CloseUnderlyingLayer()
     hQIX = NULL;
     bCheckedForQIX = FALSE;
 
+    if( hHRX != NULL )
+        SHPCloseRTree( hHRX );
+    hHRX = NULL;
+    bCheckedForHRX = FALSE;
+    bHRXOutOfDate = FALSE;
+
     if( hSBN != NULL )
         SBNCloseDiskTree( hSBN );
     hSBN = NULL;
@@ -2898,6 +3099,11 @@ void OGRShapeLayer::AddToFileList( CPLStringList& oFileList )
                 (OGRShapeGeomFieldDefn*)GetLayerDefn()->GetGeomFieldDefn(0);
             oFileList.AddString(poGeomFieldDefn->GetPrjFilename());
         }
+        if( CheckForHRX() )
+        {
+            const char* pszHRXFilename = CPLResetExtension( pszFullName, "hrx" );
+            oFileList.AddString(pszHRXFilename);
+        }
         if( CheckForQIX() )
         {
             const char* pszQIXFilename = CPLResetExtension( pszFullName, "qix" );
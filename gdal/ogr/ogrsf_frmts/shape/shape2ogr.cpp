@@ -57,16 +57,14 @@ static void RingStartEnd ( SHPObject *psShape, int ring, int *start, int *end )
 }
     
 /************************************************************************/
-/*                        CreateLinearRing                              */
+/*                        SetLinearRingPoints                           */
 /*                                                                      */
 /************************************************************************/
-static OGRLinearRing * CreateLinearRing ( SHPObject *psShape, int ring, int bHasZ )
+static void SetLinearRingPoints ( OGRLinearRing *poRing, SHPObject *psShape,
+                                  int ring, int bHasZ )
 {
-    OGRLinearRing *poRing;
     int nRingStart, nRingEnd, nRingPoints;
 
-    poRing = new OGRLinearRing();
-
     RingStartEnd ( psShape, ring, &nRingStart, &nRingEnd );
 
     nRingPoints = nRingEnd - nRingStart + 1;
@@ -78,19 +76,62 @@ static OGRLinearRing * CreateLinearRing ( SHPObject *psShape, int ring, int bHas
     else
         poRing->setPoints( nRingPoints, psShape->padfX + nRingStart,
                            psShape->padfY + nRingStart );
+}
+
+/************************************************************************/
+/*                        CreateLinearRing                              */
+/*                                                                      */
+/************************************************************************/
+static OGRLinearRing * CreateLinearRing ( SHPObject *psShape, int ring, int bHasZ )
+{
+    OGRLinearRing *poRing;
+
+    poRing = new OGRLinearRing();
+
+    SetLinearRingPoints( poRing, psShape, ring, bHasZ );
 
     return ( poRing );
 }
 
+/************************************************************************/
+/*                          TakeReusableGeometry                        */
+/*                                                                      */
+/*      Return the geometry to reuse if it is of the requested type,    */
+/*      and transfer its ownership to the caller.  Polygons are only    */
+/*      reused when they are made of a single ring.                     */
+/************************************************************************/
+static OGRGeometry *TakeReusableGeometry( OGRGeometry **ppoGeomToReuse,
+                                          OGRwkbGeometryType eFlatType )
+{
+    OGRGeometry *poGeom = *ppoGeomToReuse;
+
+    if( poGeom == NULL
+        || wkbFlatten(poGeom->getGeometryType()) != eFlatType )
+        return NULL;
+
+    if( eFlatType == wkbPolygon
+        && (((OGRPolygon *) poGeom)->getExteriorRing() == NULL
+            || ((OGRPolygon *) poGeom)->getNumInteriorRings() != 0) )
+        return NULL;
+
+    *ppoGeomToReuse = NULL;
+    return poGeom;
+}
 
 /************************************************************************/
 /*                          SHPReadOGRObject()                          */
 /*                                                                      */
 /*      Read an item in a shapefile, and translate to OGR geometry      */
 /*      representation.                                                 */
+/*                                                                      */
+/*      If poGeomToReuse is not NULL, the function takes ownership of   */
+/*      it and, for points, single part lines and single ring           */
+/*      polygons, overwrites it with the shape instead of allocating    */
+/*      a new geometry.                                                 */
 /************************************************************************/
 
-OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape )
+OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape,
+                               OGRGeometry *poGeomToReuse )
 {
     // CPLDebug( "Shape", "SHPReadOGRObject( iShape=%d )\n", iShape );
 
@@ -101,26 +142,33 @@ OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape )
 
     if( psShape == NULL )
     {
+        delete poGeomToReuse;
         return NULL;
     }
 
 /* -------------------------------------------------------------------- */
 /*      Point.                                                          */
 /* -------------------------------------------------------------------- */
-    else if( psShape->nSHPType == SHPT_POINT )
-    {
-        poOGR = new OGRPoint( psShape->padfX[0], psShape->padfY[0] );
-    }
-    else if(psShape->nSHPType == SHPT_POINTZ )
+    else if( psShape->nSHPType == SHPT_POINT
+             || psShape->nSHPType == SHPT_POINTZ
+             || psShape->nSHPType == SHPT_POINTM )
     {
-        poOGR = new OGRPoint( psShape->padfX[0], psShape->padfY[0],
-                              psShape->padfZ[0] );
-    }
-    else if(psShape->nSHPType == SHPT_POINTM )
-    {
-        // Read XYM as XYZ
-        poOGR = new OGRPoint( psShape->padfX[0], psShape->padfY[0],
-                              psShape->padfM[0] );
+        OGRPoint *poPoint = (OGRPoint *)
+            TakeReusableGeometry( &poGeomToReuse, wkbPoint );
+        if( poPoint == NULL )
+            poPoint = new OGRPoint();
+
+        poPoint->setX( psShape->padfX[0] );
+        poPoint->setY( psShape->padfY[0] );
+        if( psShape->nSHPType == SHPT_POINTZ )
+            poPoint->setZ( psShape->padfZ[0] );
+        else if( psShape->nSHPType == SHPT_POINTM )
+            // Read XYM as XYZ
+            poPoint->setZ( psShape->padfM[0] );
+        else
+            poPoint->flattenTo2D();
+
+        poOGR = poPoint;
     }
 /* -------------------------------------------------------------------- */
 /*      Multipoint.                                                     */
@@ -172,7 +220,10 @@ OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape )
         }
         else if( psShape->nParts == 1 )
         {
-            OGRLineString *poOGRLine = new OGRLineString();
+            OGRLineString *poOGRLine = (OGRLineString *)
+                TakeReusableGeometry( &poGeomToReuse, wkbLineString );
+            if( poOGRLine == NULL )
+                poOGRLine = new OGRLineString();
 
             if( psShape->nSHPType == SHPT_ARCZ )
                 poOGRLine->setPoints( psShape->nVertices,
@@ -261,12 +312,23 @@ OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape )
         else if ( psShape->nParts == 1 )
         {
             /* Surely outer ring */
-            OGRPolygon *poOGRPoly = NULL;
-            OGRLinearRing *poRing = NULL;
+            OGRPolygon *poOGRPoly = (OGRPolygon *)
+                TakeReusableGeometry( &poGeomToReuse, wkbPolygon );
 
-            poOGR = poOGRPoly = new OGRPolygon();
-            poRing = CreateLinearRing ( psShape, 0, bHasZ );
-            poOGRPoly->addRingDirectly( poRing );
+            if( poOGRPoly != NULL )
+            {
+                SetLinearRingPoints( poOGRPoly->getExteriorRing(),
+                                     psShape, 0, bHasZ );
+                poOGR = poOGRPoly;
+            }
+            else
+            {
+                OGRLinearRing *poRing = NULL;
+
+                poOGR = poOGRPoly = new OGRPolygon();
+                poRing = CreateLinearRing ( psShape, 0, bHasZ );
+                poOGRPoly->addRingDirectly( poRing );
+            }
         }
 
         else
@@ -453,6 +515,8 @@ OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape )
 /* -------------------------------------------------------------------- */
     SHPDestroyObject( psShape );
 
+    delete poGeomToReuse;
+
     return poOGR;
 }
 
@@ -1054,13 +1118,45 @@ OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
     return poDefn;
 }
 
+/************************************************************************/
+/*                          SHPParseDBFDate()                           */
+/*                                                                      */
+/*      Parse a DBF date, either as YYYYMMDD or as MM/DD/YYYY.          */
+/************************************************************************/
+
+static void SHPParseDBFDate( const char *pszDateValue, OGRField *psField )
+
+{
+    memset( psField, 0, sizeof(OGRField) );
+
+    if( strlen(pszDateValue) >= 10 &&
+        pszDateValue[2] == '/' && pszDateValue[5] == '/' )
+    {
+        psField->Date.Month = (GByte)atoi(pszDateValue+0);
+        psField->Date.Day   = (GByte)atoi(pszDateValue+3);
+        psField->Date.Year  = (GInt16)atoi(pszDateValue+6);
+    }
+    else
+    {
+        int nFullDate = atoi(pszDateValue);
+        psField->Date.Year = (GInt16)(nFullDate / 10000);
+        psField->Date.Month = (GByte)((nFullDate / 100) % 100);
+        psField->Date.Day = (GByte)(nFullDate % 100);
+    }
+}
+
 /************************************************************************/
 /*                         SHPReadOGRFeature()                          */
+/*                                                                      */
+/*      If poFeatureToReuse is not NULL, it is reset and filled, and    */
+/*      its geometry is recycled when possible, instead of allocating   */
+/*      a new feature.                                                  */
 /************************************************************************/
 
 OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                                OGRFeatureDefn * poDefn, int iShape,
-                               SHPObject *psShape, const char *pszSHPEncoding )
+                               SHPObject *psShape, const char *pszSHPEncoding,
+                               OGRFeature *poFeatureToReuse )
 
 {
     if( iShape < 0 
@@ -1081,7 +1177,18 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
         return NULL;
     }
 
-    OGRFeature  *poFeature = new OGRFeature( poDefn );
+    OGRFeature  *poFeature;
+    OGRGeometry *poGeomToReuse = NULL;
+
+    if( poFeatureToReuse != NULL )
+    {
+        poFeature = poFeatureToReuse;
+        if( poFeature->GetGeomFieldCount() > 0 )
+            poGeomToReuse = poFeature->StealGeometry();
+        poFeature->Reset();
+    }
+    else
+        poFeature = new OGRFeature( poDefn );
 
 /* -------------------------------------------------------------------- */
 /*      Fetch geometry from Shapefile to OGRFeature.                    */
@@ -1091,7 +1198,9 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
         if( !poDefn->IsGeometryIgnored() )
         {
             OGRGeometry* poGeometry = NULL;
-            poGeometry = SHPReadOGRObject( hSHP, iShape, psShape );
+            poGeometry = SHPReadOGRObject( hSHP, iShape, psShape,
+                                           poGeomToReuse );
+            poGeomToReuse = NULL;
 
             /*
             * NOTE - mloskot:
@@ -1109,6 +1218,7 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
             SHPDestroyObject( psShape );
         }
     }
+    delete poGeomToReuse;
 
 /* -------------------------------------------------------------------- */
 /*      Fetch feature attributes to OGRFeature fields.                  */
@@ -1165,23 +1275,7 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
               if (pszDateValue[0] == '\0')
                   continue;
 
-              memset( &sFld, 0, sizeof(sFld) );
-
-              if( strlen(pszDateValue) >= 10 &&
-                  pszDateValue[2] == '/' && pszDateValue[5] == '/' )
-              {
-                  sFld.Date.Month = (GByte)atoi(pszDateValue+0);
-                  sFld.Date.Day   = (GByte)atoi(pszDateValue+3);
-                  sFld.Date.Year  = (GInt16)atoi(pszDateValue+6);
-              }
-              else
-              {
-                  int nFullDate = atoi(pszDateValue);
-                  sFld.Date.Year = (GInt16)(nFullDate / 10000);
-                  sFld.Date.Month = (GByte)((nFullDate / 100) % 100);
-                  sFld.Date.Day = (GByte)(nFullDate % 100);
-              }
-              
+              SHPParseDBFDate( pszDateValue, &sFld );
               poFeature->SetField( iField, &sFld );
           }
           break;
@@ -1197,6 +1291,124 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
     return( poFeature );
 }
 
+/************************************************************************/
+/*                      SHPReadOGRFeatureToBatch()                      */
+/*                                                                      */
+/*      Append a shape and its DBF record to a feature batch,           */
+/*      without going through an intermediate OGRFeature.  The shape    */
+/*      must exist and not be deleted.                                  */
+/************************************************************************/
+
+int SHPReadOGRFeatureToBatch( SHPHandle hSHP, DBFHandle hDBF,
+                              OGRFeatureDefn * poDefn, int iShape,
+                              const char *pszSHPEncoding,
+                              OGRFeatureBatch *poBatch )
+
+{
+    if( !poBatch->BeginFeature( iShape ) )
+        return FALSE;
+
+/* -------------------------------------------------------------------- */
+/*      Fetch geometry from Shapefile as WKB.                           */
+/* -------------------------------------------------------------------- */
+    if( hSHP != NULL && !poDefn->IsGeometryIgnored() )
+    {
+        OGRGeometry *poGeometry = SHPReadOGRObject( hSHP, iShape, NULL );
+        if( poGeometry != NULL )
+        {
+            GByte *pabyWKB =
+                poBatch->ReserveGeomFieldWKB( 0, poGeometry->WkbSize() );
+            if( pabyWKB != NULL )
+                poGeometry->exportToWkb( wkbNDR, pabyWKB, wkbVariantIso );
+            delete poGeometry;
+            if( pabyWKB == NULL )
+                return FALSE;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Fetch feature attributes to the batch columns.                  */
+/* -------------------------------------------------------------------- */
+    for( int iField = 0; iField < poDefn->GetFieldCount(); iField++ )
+    {
+        OGRFieldDefn* poFieldDefn = poDefn->GetFieldDefn(iField);
+        if (poFieldDefn->IsIgnored() )
+            continue;
+
+        switch( poFieldDefn->GetType() )
+        {
+          case OFTString:
+          {
+              const char *pszFieldVal = 
+                  DBFReadStringAttribute( hDBF, iShape, iField );
+              if( pszFieldVal == NULL || pszFieldVal[0] == '\0' )
+                  break;
+
+              int bOK;
+              if( pszSHPEncoding[0] != '\0' )
+              {
+                  char *pszUTF8Field = CPLRecode( pszFieldVal,
+                                                  pszSHPEncoding, CPL_ENC_UTF8);
+                  bOK = poBatch->SetFieldBinary( iField, pszUTF8Field,
+                                                 strlen(pszUTF8Field) );
+                  CPLFree( pszUTF8Field );
+              }
+              else
+                  bOK = poBatch->SetFieldBinary( iField, pszFieldVal,
+                                                 strlen(pszFieldVal) );
+              if( !bOK )
+                  return FALSE;
+          }
+          break;
+
+          case OFTInteger:
+            if( !DBFIsAttributeNULL( hDBF, iShape, iField ) )
+            {
+                long nVal = strtol( DBFReadStringAttribute( hDBF, iShape,
+                                                            iField ),
+                                    NULL, 10 );
+                poBatch->SetFieldInteger( iField,
+                    (nVal > INT_MAX) ? INT_MAX :
+                    (nVal < INT_MIN) ? INT_MIN : (int) nVal );
+            }
+            break;
+
+          case OFTInteger64:
+            if( !DBFIsAttributeNULL( hDBF, iShape, iField ) )
+                poBatch->SetFieldInteger64( iField, CPLAtoGIntBig(
+                    DBFReadStringAttribute( hDBF, iShape, iField ) ) );
+            break;
+
+          case OFTReal:
+            if( !DBFIsAttributeNULL( hDBF, iShape, iField ) )
+                poBatch->SetFieldDouble( iField, CPLAtof(
+                    DBFReadStringAttribute( hDBF, iShape, iField ) ) );
+            break;
+
+          case OFTDate:
+          {
+              if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
+                  break;
+
+              const char* pszDateValue = 
+                  DBFReadStringAttribute(hDBF,iShape,iField);
+              if (pszDateValue[0] == '\0')
+                  break;
+
+              OGRField sFld;
+              SHPParseDBFDate( pszDateValue, &sFld );
+              poBatch->SetFieldDateTime( iField, &sFld );
+          }
+          break;
+
+          default:
+            CPLAssert( FALSE );
+        }
+    }
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                             GrowField()                              */
 /************************************************************************/
@@ -544,6 +544,32 @@ SBNSearchDiskTreeInteger( SBNSearchHandle hSBN,
 
 void SHPAPI_CALL SBNSearchFreeIds( int* panShapeId );
 
+/* -------------------------------------------------------------------- */
+/*      Packed Hilbert R-tree (.hrx) API                                */
+/* -------------------------------------------------------------------- */
+
+typedef struct SHPRTreeInfo* SHPRTreeHandle;
+
+int SHPAPI_CALL
+    SHPWriteRTree( SHPHandle hSHP, const char *pszFilename, int nNodeSize,
+                   SAHooks *psHooks );
+
+SHPRTreeHandle SHPAPI_CALL
+    SHPOpenRTree( const char *pszHRXFilename, SAHooks *psHooks );
+
+void SHPAPI_CALL
+    SHPCloseRTree( SHPRTreeHandle hTree );
+
+int SHPAPI_CALL
+    SHPGetRTreeRecordCount( SHPRTreeHandle hTree );
+
+int SHPAPI_CALL1(*)
+SHPSearchRTree( SHPRTreeHandle hTree,
+                double *padfBoundsMin, double *padfBoundsMax,
+                int *pnShapeCount );
+
+void SHPAPI_CALL SHPSearchRTreeFreeIds( int* panShapeId );
+
 /************************************************************************/
 /*                             DBF Support.                             */
 /************************************************************************/
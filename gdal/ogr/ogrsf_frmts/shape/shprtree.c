@@ -0,0 +1,881 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  Shapelib
+ * Purpose:  Implementation of a packed Hilbert R-tree spatial index (.hrx)
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, GDAL contributors
+ *
+ * This software is available under the following "MIT Style" license,
+ * or at the option of the licensee under the LGPL (see LICENSE.LGPL).  This
+ * option is discussed in more detail in shapelib.html.
+ *
+ * --
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************
+ *
+ * The .hrx file is a static R-tree, whose leaves are the bounding boxes of
+ * the shapes sorted along a Hilbert curve, and which is written level by
+ * level, root first.  All values are little endian.
+ *
+ *   Header (64 bytes):
+ *     0   "SHRT"           magic
+ *     4   int32            version (1)
+ *     8   int32            node size, i.e. number of items per node
+ *     12  int32            number of indexed shapes (leaf items)
+ *     16  int32            number of records of the .shp when indexed
+ *     20  int32            reserved (0)
+ *     24  double[4]        xmin, ymin, xmax, ymax of the indexed shapes
+ *     56  int32[2]         reserved (0)
+ *
+ *   Items (36 bytes each):
+ *     0   double[4]        xmin, ymin, xmax, ymax
+ *     32  int32            for leaf items, the shape id.  Otherwise
+ *                          the index of the first item of the child node.
+ *
+ * Each level holds ceil(n / node size) items, n being the item count of
+ * the level below, up to a single root item.  The children of the item i
+ * of a level are the items [i * node size, (i + 1) * node size[ of the
+ * level below, so the nodes visited by a search at a given level are in
+ * increasing file order.
+ */
+
+#include "shapefil.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+SHP_CVSID("$Id$")
+
+#ifndef TRUE
+#  define TRUE 1
+#  define FALSE 0
+#endif
+
+#define HRX_HEADER_SIZE         64
+#define HRX_ITEM_SIZE           36
+#define HRX_DEFAULT_NODE_SIZE   16
+#define HRX_MAX_NODE_SIZE       1024
+#define HRX_MAX_LEVELS          32
+
+/* Number of items read at once when scanning a run of nodes */
+#define HRX_READ_BUFFER_ITEMS   4096
+
+/* Size of the window used to read the record headers of the .shp */
+#define HRX_SHP_BUFFER_SIZE     (1024 * 1024)
+
+typedef unsigned char uchar;
+
+struct SHPRTreeInfo
+{
+    SAHooks     sHooks;
+    SAFile      fpHRX;
+
+    int         nNodeSize;
+    int         nItemCount;             /* Number of indexed shapes */
+    int         nRecordCount;           /* Records of the .shp */
+    int         nLevels;
+    int         anLevelStart[HRX_MAX_LEVELS];   /* Root level first */
+    int         anLevelCount[HRX_MAX_LEVELS];
+    double      adfExtent[4];
+
+    uchar      *pabyBuffer;             /* HRX_READ_BUFFER_ITEMS items */
+};
+
+typedef struct
+{
+    unsigned int nHilbertCode;
+    int          nShapeId;
+} HRXSortEntry;
+
+/************************************************************************/
+/*                              SwapWord()                              */
+/*                                                                      */
+/*      Swap a 2, 4 or 8 byte word.                                     */
+/************************************************************************/
+
+static void SwapWord( int length, void * wordP )
+
+{
+    int     i;
+    uchar   temp;
+
+    for( i=0; i < length/2; i++ )
+    {
+        temp = ((uchar *) wordP)[i];
+        ((uchar *)wordP)[i] = ((uchar *) wordP)[length-i-1];
+        ((uchar *) wordP)[length-i-1] = temp;
+    }
+}
+
+/************************************************************************/
+/*                            IsBigEndian()                             */
+/************************************************************************/
+
+static int IsBigEndian( void )
+{
+    int i = 1;
+    return *((unsigned char *) &i) != 1;
+}
+
+/************************************************************************/
+/*                     HRXGetInt32() / HRXSetInt32()                    */
+/************************************************************************/
+
+static int HRXGetInt32( const uchar *pabyData )
+{
+    int nVal;
+    memcpy( &nVal, pabyData, 4 );
+    if( IsBigEndian() )
+        SwapWord( 4, &nVal );
+    return nVal;
+}
+
+static void HRXSetInt32( uchar *pabyData, int nVal )
+{
+    if( IsBigEndian() )
+        SwapWord( 4, &nVal );
+    memcpy( pabyData, &nVal, 4 );
+}
+
+/************************************************************************/
+/*                    HRXGetDouble() / HRXSetDouble()                   */
+/************************************************************************/
+
+static double HRXGetDouble( const uchar *pabyData )
+{
+    double dfVal;
+    memcpy( &dfVal, pabyData, 8 );
+    if( IsBigEndian() )
+        SwapWord( 8, &dfVal );
+    return dfVal;
+}
+
+static void HRXSetDouble( uchar *pabyData, double dfVal )
+{
+    if( IsBigEndian() )
+        SwapWord( 8, &dfVal );
+    memcpy( pabyData, &dfVal, 8 );
+}
+
+/************************************************************************/
+/*                          HRXComputeLevels()                          */
+/*                                                                      */
+/*      Compute the start and item count of each level, root first.     */
+/************************************************************************/
+
+static int HRXComputeLevels( int nItemCount, int nNodeSize,
+                             int *panLevelStart, int *panLevelCount )
+{
+    int anCount[HRX_MAX_LEVELS];
+    int nLevels = 0;
+    int nCount = nItemCount;
+    int nStart = 0;
+    int i;
+
+    if( nItemCount == 0 )
+        return 0;
+
+    /* Count the items of each level, from the leaves up to the root */
+    while( TRUE )
+    {
+        if( nLevels == HRX_MAX_LEVELS )
+            return -1;
+        anCount[nLevels++] = nCount;
+        if( nCount == 1 )
+            break;
+        nCount = (nCount + nNodeSize - 1) / nNodeSize;
+    }
+
+    for( i = 0; i < nLevels; i++ )
+    {
+        panLevelCount[i] = anCount[nLevels - 1 - i];
+        panLevelStart[i] = nStart;
+        nStart += panLevelCount[i];
+    }
+
+    return nLevels;
+}
+
+/* helper for qsort */
+static int
+HRXCompareSortEntries( const void * a, const void * b )
+{
+    const HRXSortEntry *psA = (const HRXSortEntry *) a;
+    const HRXSortEntry *psB = (const HRXSortEntry *) b;
+    if( psA->nHilbertCode < psB->nHilbertCode )
+        return -1;
+    if( psA->nHilbertCode > psB->nHilbertCode )
+        return 1;
+    return psA->nShapeId - psB->nShapeId;
+}
+
+/* helper for qsort */
+static int
+compare_ints( const void * a, const void * b)
+{
+    return (*(int*)a) - (*(int*)b);
+}
+
+/************************************************************************/
+/*                        HRXReadShapeBounds()                          */
+/*                                                                      */
+/*      Read the bounding box of a shape from its record header,        */
+/*      through a window over the .shp file, since records are         */
+/*      visited in file order.  Returns FALSE for null shapes.          */
+/************************************************************************/
+
+static int HRXReadShapeBounds( SHPHandle hSHP, int iShape,
+                               uchar *pabyWindow, SAOffset *pnWindowStart,
+                               int *pnWindowSize, double *padfBounds )
+{
+    SAOffset nOffset;
+    int nToRead, nType;
+    const uchar *pabyRec;
+
+    /* The offsets might not have been read from the .shx yet */
+    if( hSHP->panRecOffset[iShape] == 0 )
+    {
+        SHPObject *psShape = SHPReadObject( hSHP, iShape );
+        int bRet;
+        if( psShape == NULL )
+            return FALSE;
+        bRet = psShape->nSHPType != SHPT_NULL;
+        padfBounds[0] = psShape->dfXMin;
+        padfBounds[1] = psShape->dfYMin;
+        padfBounds[2] = psShape->dfXMax;
+        padfBounds[3] = psShape->dfYMax;
+        SHPDestroyObject( psShape );
+        return bRet;
+    }
+
+    /* Record header, shape type and either a point or a bounding box */
+    nOffset = hSHP->panRecOffset[iShape];
+    nToRead = 8 + 4 + 32;
+    if( hSHP->panRecSize[iShape] + 8 < (unsigned int) nToRead )
+        nToRead = hSHP->panRecSize[iShape] + 8;
+    if( nToRead < 12 )
+        return FALSE;
+
+    if( nOffset < *pnWindowStart ||
+        nOffset + nToRead > *pnWindowStart + *pnWindowSize )
+    {
+        *pnWindowStart = nOffset;
+        *pnWindowSize = 0;
+        if( hSHP->sHooks.FSeek( hSHP->fpSHP, nOffset, 0 ) != 0 )
+            return FALSE;
+        *pnWindowSize = (int) hSHP->sHooks.FRead( pabyWindow, 1,
+                                                   HRX_SHP_BUFFER_SIZE,
+                                                   hSHP->fpSHP );
+        if( *pnWindowSize < nToRead )
+            return FALSE;
+    }
+
+    pabyRec = pabyWindow + (nOffset - *pnWindowStart);
+    nType = HRXGetInt32( pabyRec + 8 );
+
+    switch( nType )
+    {
+      case SHPT_POINT:
+      case SHPT_POINTZ:
+      case SHPT_POINTM:
+        if( nToRead < 8 + 4 + 16 )
+            return FALSE;
+        padfBounds[0] = padfBounds[2] = HRXGetDouble( pabyRec + 12 );
+        padfBounds[1] = padfBounds[3] = HRXGetDouble( pabyRec + 20 );
+        return TRUE;
+
+      case SHPT_ARC:
+      case SHPT_ARCZ:
+      case SHPT_ARCM:
+      case SHPT_POLYGON:
+      case SHPT_POLYGONZ:
+      case SHPT_POLYGONM:
+      case SHPT_MULTIPOINT:
+      case SHPT_MULTIPOINTZ:
+      case SHPT_MULTIPOINTM:
+      case SHPT_MULTIPATCH:
+        if( nToRead < 8 + 4 + 32 )
+            return FALSE;
+        padfBounds[0] = HRXGetDouble( pabyRec + 12 );
+        padfBounds[1] = HRXGetDouble( pabyRec + 20 );
+        padfBounds[2] = HRXGetDouble( pabyRec + 28 );
+        padfBounds[3] = HRXGetDouble( pabyRec + 36 );
+        return TRUE;
+
+      default:
+        return FALSE;
+    }
+}
+
+/************************************************************************/
+/*                            SHPWriteRTree()                           */
+/*                                                                      */
+/*      Build the index of all the shapes of a shapefile.  The          */
+/*      bounding boxes are read in a single pass, sorted along the      */
+/*      Hilbert curve and the tree is then packed bottom-up.            */
+/*      nNodeSize may be 0 to use the default node size (16).           */
+/************************************************************************/
+
+int SHPWriteRTree( SHPHandle hSHP, const char *pszFilename, int nNodeSize,
+                   SAHooks *psHooks )
+
+{
+    SAHooks     sHooks;
+    SAFile      fp;
+    double     *padfBounds = NULL;
+    HRXSortEntry *pasEntries = NULL;
+    uchar      *pabyWindow = NULL;
+    uchar      *pabyBuffer = NULL;
+    double     *padfLevelBounds = NULL;
+    SAOffset    nWindowStart = 0;
+    int         nWindowSize = 0;
+    int         nItemCount = 0;
+    int         anLevelStart[HRX_MAX_LEVELS];
+    int         anLevelCount[HRX_MAX_LEVELS];
+    int         nLevels, nUpperCount, iLevel, i, j;
+    double      adfExtent[4];
+    uchar       abyHeader[HRX_HEADER_SIZE];
+    int         bOK = TRUE;
+
+    if( psHooks == NULL )
+        SASetupDefaultHooks( &sHooks );
+    else
+        memcpy( &sHooks, psHooks, sizeof(SAHooks) );
+
+    if( nNodeSize <= 0 )
+        nNodeSize = HRX_DEFAULT_NODE_SIZE;
+    if( nNodeSize < 2 )
+        nNodeSize = 2;
+    else if( nNodeSize > HRX_MAX_NODE_SIZE )
+        nNodeSize = HRX_MAX_NODE_SIZE;
+
+/* -------------------------------------------------------------------- */
+/*      Collect the bounding boxes of the non null shapes.              */
+/* -------------------------------------------------------------------- */
+    if( hSHP->nRecords > 0 )
+    {
+        padfBounds = (double *) malloc( sizeof(double) * 4 * hSHP->nRecords );
+        pasEntries = (HRXSortEntry *)
+            malloc( sizeof(HRXSortEntry) * hSHP->nRecords );
+        pabyWindow = (uchar *) malloc( HRX_SHP_BUFFER_SIZE );
+        if( padfBounds == NULL || pasEntries == NULL || pabyWindow == NULL )
+        {
+            sHooks.Error( "Not enough memory to build the .hrx index." );
+            free( padfBounds );
+            free( pasEntries );
+            free( pabyWindow );
+            return FALSE;
+        }
+    }
+
+    adfExtent[0] = adfExtent[1] = adfExtent[2] = adfExtent[3] = 0.0;
+    for( i = 0; i < hSHP->nRecords; i++ )
+    {
+        double *padfShapeBounds = padfBounds + 4 * i;
+        if( !HRXReadShapeBounds( hSHP, i, pabyWindow, &nWindowStart,
+                                 &nWindowSize, padfShapeBounds ) )
+            continue;
+        if( nItemCount == 0 )
+            memcpy( adfExtent, padfShapeBounds, sizeof(adfExtent) );
+        else
+        {
+            if( padfShapeBounds[0] < adfExtent[0] )
+                adfExtent[0] = padfShapeBounds[0];
+            if( padfShapeBounds[1] < adfExtent[1] )
+                adfExtent[1] = padfShapeBounds[1];
+            if( padfShapeBounds[2] > adfExtent[2] )
+                adfExtent[2] = padfShapeBounds[2];
+            if( padfShapeBounds[3] > adfExtent[3] )
+                adfExtent[3] = padfShapeBounds[3];
+        }
+        pasEntries[nItemCount].nShapeId = i;
+        nItemCount++;
+    }
+    free( pabyWindow );
+
+/* -------------------------------------------------------------------- */
+/*      Sort the shapes by the Hilbert code of their center.            */
+/* -------------------------------------------------------------------- */
+    for( i = 0; i < nItemCount; i++ )
+    {
+        const double *padfShapeBounds = padfBounds +
+                                        4 * pasEntries[i].nShapeId;
+        double dfWidth = adfExtent[2] - adfExtent[0];
+        double dfHeight = adfExtent[3] - adfExtent[1];
+        unsigned int nX = 0, nY = 0;
+        if( dfWidth > 0 )
+            nX = (unsigned int) (65535.0 *
+                ((padfShapeBounds[0] + padfShapeBounds[2]) / 2 - adfExtent[0])
+                    / dfWidth);
+        if( dfHeight > 0 )
+            nY = (unsigned int) (65535.0 *
+                ((padfShapeBounds[1] + padfShapeBounds[3]) / 2 - adfExtent[1])
+                    / dfHeight);
+        pasEntries[i].nHilbertCode = CPLHilbertCode( nX, nY );
+    }
+    if( nItemCount > 0 )
+        qsort( pasEntries, nItemCount, sizeof(HRXSortEntry),
+               HRXCompareSortEntries );
+
+/* -------------------------------------------------------------------- */
+/*      Compute the bounds of the items of the upper levels, from       */
+/*      the level just above the leaves up to the root.                 */
+/* -------------------------------------------------------------------- */
+    nLevels = HRXComputeLevels( nItemCount, nNodeSize,
+                                anLevelStart, anLevelCount );
+    if( nLevels < 0 )
+    {
+        sHooks.Error( "Too many levels in .hrx index." );
+        free( padfBounds );
+        free( pasEntries );
+        return FALSE;
+    }
+    nUpperCount = (nLevels > 0) ? anLevelStart[nLevels - 1] : 0;
+    if( nUpperCount > 0 )
+    {
+        padfLevelBounds = (double *)
+            malloc( sizeof(double) * 4 * nUpperCount );
+        if( padfLevelBounds == NULL )
+        {
+            sHooks.Error( "Not enough memory to build the .hrx index." );
+            free( padfBounds );
+            free( pasEntries );
+            return FALSE;
+        }
+    }
+
+    for( iLevel = nLevels - 2; iLevel >= 0; iLevel-- )
+    {
+        int nChildStart = anLevelStart[iLevel + 1];
+        int nChildCount = anLevelCount[iLevel + 1];
+
+        for( i = 0; i < anLevelCount[iLevel]; i++ )
+        {
+            double *padfItem = padfLevelBounds +
+                               4 * (anLevelStart[iLevel] + i);
+            int nFirst = i * nNodeSize;
+            int nLast = nFirst + nNodeSize;
+            if( nLast > nChildCount )
+                nLast = nChildCount;
+
+            for( j = nFirst; j < nLast; j++ )
+            {
+                const double *padfChild;
+                if( iLevel == nLevels - 2 )
+                    padfChild = padfBounds + 4 * pasEntries[j].nShapeId;
+                else
+                    padfChild = padfLevelBounds + 4 * (nChildStart + j);
+
+                if( j == nFirst )
+                    memcpy( padfItem, padfChild, 4 * sizeof(double) );
+                else
+                {
+                    if( padfChild[0] < padfItem[0] )
+                        padfItem[0] = padfChild[0];
+                    if( padfChild[1] < padfItem[1] )
+                        padfItem[1] = padfChild[1];
+                    if( padfChild[2] > padfItem[2] )
+                        padfItem[2] = padfChild[2];
+                    if( padfChild[3] > padfItem[3] )
+                        padfItem[3] = padfChild[3];
+                }
+            }
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write the header.                                               */
+/* -------------------------------------------------------------------- */
+    fp = sHooks.FOpen( pszFilename, "wb" );
+    if( fp == NULL )
+    {
+        char *pszMessage = (char *) malloc( strlen(pszFilename) + 100 );
+        sprintf( pszMessage, "Failed to create file %s", pszFilename );
+        sHooks.Error( pszMessage );
+        free( pszMessage );
+        free( padfBounds );
+        free( pasEntries );
+        free( padfLevelBounds );
+        return FALSE;
+    }
+
+    memset( abyHeader, 0, sizeof(abyHeader) );
+    memcpy( abyHeader, "SHRT", 4 );
+    HRXSetInt32( abyHeader + 4, 1 );
+    HRXSetInt32( abyHeader + 8, nNodeSize );
+    HRXSetInt32( abyHeader + 12, nItemCount );
+    HRXSetInt32( abyHeader + 16, hSHP->nRecords );
+    for( i = 0; i < 4; i++ )
+        HRXSetDouble( abyHeader + 24 + 8 * i, adfExtent[i] );
+    if( sHooks.FWrite( abyHeader, HRX_HEADER_SIZE, 1, fp ) != 1 )
+        bOK = FALSE;
+
+/* -------------------------------------------------------------------- */
+/*      Write the items, root level first.                              */
+/* -------------------------------------------------------------------- */
+    pabyBuffer = (uchar *) malloc( HRX_READ_BUFFER_ITEMS * HRX_ITEM_SIZE );
+    if( pabyBuffer == NULL )
+        bOK = FALSE;
+
+    for( iLevel = 0; bOK && iLevel < nLevels; iLevel++ )
+    {
+        int nInBuffer = 0;
+        for( i = 0; bOK && i < anLevelCount[iLevel]; i++ )
+        {
+            uchar *pabyItem = pabyBuffer + nInBuffer * HRX_ITEM_SIZE;
+            const double *padfItem;
+            int nValue;
+
+            if( iLevel == nLevels - 1 )
+            {
+                padfItem = padfBounds + 4 * pasEntries[i].nShapeId;
+                nValue = pasEntries[i].nShapeId;
+            }
+            else
+            {
+                padfItem = padfLevelBounds + 4 * (anLevelStart[iLevel] + i);
+                nValue = anLevelStart[iLevel + 1] + i * nNodeSize;
+            }
+
+            for( j = 0; j < 4; j++ )
+                HRXSetDouble( pabyItem + 8 * j, padfItem[j] );
+            HRXSetInt32( pabyItem + 32, nValue );
+
+            if( ++nInBuffer == HRX_READ_BUFFER_ITEMS ||
+                i == anLevelCount[iLevel] - 1 )
+            {
+                if( (int) sHooks.FWrite( pabyBuffer, HRX_ITEM_SIZE,
+                                         nInBuffer, fp ) != nInBuffer )
+                    bOK = FALSE;
+                nInBuffer = 0;
+            }
+        }
+    }
+
+    sHooks.FClose( fp );
+
+    free( pabyBuffer );
+    free( padfBounds );
+    free( pasEntries );
+    free( padfLevelBounds );
+
+    if( !bOK )
+    {
+        char *pszMessage = (char *) malloc( strlen(pszFilename) + 100 );
+        sprintf( pszMessage, "Failed to write file %s", pszFilename );
+        sHooks.Error( pszMessage );
+        free( pszMessage );
+        sHooks.Remove( pszFilename );
+    }
+
+    return bOK;
+}
+
+/************************************************************************/
+/*                            SHPOpenRTree()                            */
+/************************************************************************/
+
+SHPRTreeHandle SHPOpenRTree( const char *pszHRXFilename, SAHooks *psHooks )
+
+{
+    SHPRTreeHandle hTree;
+    uchar abyHeader[HRX_HEADER_SIZE];
+    int i;
+
+    hTree = (SHPRTreeHandle) calloc( sizeof(struct SHPRTreeInfo), 1 );
+
+    if( psHooks == NULL )
+        SASetupDefaultHooks( &(hTree->sHooks) );
+    else
+        memcpy( &(hTree->sHooks), psHooks, sizeof(SAHooks) );
+
+    hTree->fpHRX = hTree->sHooks.FOpen( pszHRXFilename, "rb" );
+    if( hTree->fpHRX == NULL )
+    {
+        free( hTree );
+        return NULL;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Check the header.                                               */
+/* -------------------------------------------------------------------- */
+    if( hTree->sHooks.FRead( abyHeader, HRX_HEADER_SIZE, 1,
+                             hTree->fpHRX ) != 1 ||
+        memcmp( abyHeader, "SHRT", 4 ) != 0 ||
+        HRXGetInt32( abyHeader + 4 ) != 1 )
+    {
+        hTree->sHooks.Error( ".hrx file is unreadable, or corrupt." );
+        SHPCloseRTree( hTree );
+        return NULL;
+    }
+
+    hTree->nNodeSize = HRXGetInt32( abyHeader + 8 );
+    hTree->nItemCount = HRXGetInt32( abyHeader + 12 );
+    hTree->nRecordCount = HRXGetInt32( abyHeader + 16 );
+    for( i = 0; i < 4; i++ )
+        hTree->adfExtent[i] = HRXGetDouble( abyHeader + 24 + 8 * i );
+
+    if( hTree->nNodeSize < 2 || hTree->nNodeSize > HRX_MAX_NODE_SIZE ||
+        hTree->nItemCount < 0 ||
+        hTree->nRecordCount < hTree->nItemCount )
+    {
+        hTree->sHooks.Error( ".hrx file is unreadable, or corrupt." );
+        SHPCloseRTree( hTree );
+        return NULL;
+    }
+
+    hTree->nLevels = HRXComputeLevels( hTree->nItemCount, hTree->nNodeSize,
+                                       hTree->anLevelStart,
+                                       hTree->anLevelCount );
+    if( hTree->nLevels < 0 )
+    {
+        hTree->sHooks.Error( ".hrx file is unreadable, or corrupt." );
+        SHPCloseRTree( hTree );
+        return NULL;
+    }
+
+    hTree->pabyBuffer = (uchar *)
+        malloc( HRX_READ_BUFFER_ITEMS * HRX_ITEM_SIZE );
+    if( hTree->pabyBuffer == NULL )
+    {
+        SHPCloseRTree( hTree );
+        return NULL;
+    }
+
+    return hTree;
+}
+
+/************************************************************************/
+/*                           SHPCloseRTree()                            */
+/************************************************************************/
+
+void SHPCloseRTree( SHPRTreeHandle hTree )
+
+{
+    if( hTree == NULL )
+        return;
+
+    if( hTree->fpHRX != NULL )
+        hTree->sHooks.FClose( hTree->fpHRX );
+    free( hTree->pabyBuffer );
+    free( hTree );
+}
+
+/************************************************************************/
+/*                       SHPGetRTreeRecordCount()                       */
+/*                                                                      */
+/*      Number of records of the .shp file when the index was built,    */
+/*      so that callers can detect an index that is out of date.        */
+/************************************************************************/
+
+int SHPGetRTreeRecordCount( SHPRTreeHandle hTree )
+
+{
+    return hTree->nRecordCount;
+}
+
+/************************************************************************/
+/*                           SHPSearchRTree()                           */
+/*                                                                      */
+/*      Return the sorted list of the ids of the shapes whose           */
+/*      bounding box intersects the passed one, or NULL in case of      */
+/*      error.  The tree is walked level by level: the runs of          */
+/*      consecutive nodes to visit at one level are read with a         */
+/*      single request, in increasing file order.                       */
+/************************************************************************/
+
+int *SHPSearchRTree( SHPRTreeHandle hTree,
+                     double *padfBoundsMin, double *padfBoundsMax,
+                     int *pnShapeCount )
+
+{
+    int    *panNodes = NULL;        /* First item of nodes to visit */
+    int     nNodeCount = 0, nNodeAlloc = 0;
+    int    *panNextNodes = NULL;
+    int     nNextNodeCount = 0, nNextNodeAlloc = 0;
+    int    *panResult = NULL;
+    int     nResultCount = 0, nResultAlloc = 0;
+    int     iLevel, iNode;
+
+    *pnShapeCount = 0;
+
+    if( hTree->nItemCount == 0 ||
+        padfBoundsMax[0] < hTree->adfExtent[0] ||
+        padfBoundsMax[1] < hTree->adfExtent[1] ||
+        padfBoundsMin[0] > hTree->adfExtent[2] ||
+        padfBoundsMin[1] > hTree->adfExtent[3] )
+    {
+        /* To distinguish between empty intersection from error case */
+        return (int *) calloc( 1, sizeof(int) );
+    }
+
+    panNodes = (int *) malloc( sizeof(int) );
+    if( panNodes == NULL )
+        return NULL;
+    panNodes[0] = 0;
+    nNodeCount = 1;
+    nNodeAlloc = 1;
+
+    for( iLevel = 0; iLevel < hTree->nLevels; iLevel++ )
+    {
+        int nLevelStart = hTree->anLevelStart[iLevel];
+        int nLevelEnd = nLevelStart + hTree->anLevelCount[iLevel];
+        int bLeaves = (iLevel == hTree->nLevels - 1);
+        /* The root level is a single node of 1 item */
+        int nNodeItems = (iLevel == 0) ? 1 : hTree->nNodeSize;
+
+        nNextNodeCount = 0;
+
+        iNode = 0;
+        while( iNode < nNodeCount )
+        {
+            /* Coalesce the nodes that follow each other in the file */
+            int nRunStart = panNodes[iNode];
+            int nRunEnd = nRunStart + nNodeItems;
+            int nItem;
+
+            iNode++;
+            while( iNode < nNodeCount && panNodes[iNode] == nRunEnd &&
+                   nRunEnd - nRunStart + nNodeItems <= HRX_READ_BUFFER_ITEMS )
+            {
+                nRunEnd += nNodeItems;
+                iNode++;
+            }
+            if( nRunEnd > nLevelEnd )
+                nRunEnd = nLevelEnd;
+            if( nRunStart >= nRunEnd )
+                continue;
+
+            if( hTree->sHooks.FSeek( hTree->fpHRX,
+                        (SAOffset) HRX_HEADER_SIZE +
+                        (SAOffset) nRunStart * HRX_ITEM_SIZE, 0 ) != 0 ||
+                (int) hTree->sHooks.FRead( hTree->pabyBuffer, HRX_ITEM_SIZE,
+                                           nRunEnd - nRunStart,
+                                           hTree->fpHRX )
+                                                != nRunEnd - nRunStart )
+            {
+                hTree->sHooks.Error( "Cannot read .hrx file." );
+                free( panNodes );
+                free( panNextNodes );
+                free( panResult );
+                return NULL;
+            }
+
+            for( nItem = nRunStart; nItem < nRunEnd; nItem++ )
+            {
+                const uchar *pabyItem = hTree->pabyBuffer +
+                                        (nItem - nRunStart) * HRX_ITEM_SIZE;
+                int nValue;
+
+                if( HRXGetDouble( pabyItem ) > padfBoundsMax[0] ||
+                    HRXGetDouble( pabyItem + 8 ) > padfBoundsMax[1] ||
+                    HRXGetDouble( pabyItem + 16 ) < padfBoundsMin[0] ||
+                    HRXGetDouble( pabyItem + 24 ) < padfBoundsMin[1] )
+                    continue;
+
+                if( bLeaves )
+                {
+                    nValue = HRXGetInt32( pabyItem + 32 );
+                    if( nResultCount == nResultAlloc )
+                    {
+                        int *panNew;
+                        nResultAlloc = nResultAlloc * 2 + 64;
+                        panNew = (int *) realloc( panResult,
+                                                  sizeof(int) * nResultAlloc );
+                        if( panNew == NULL )
+                        {
+                            free( panNodes );
+                            free( panNextNodes );
+                            free( panResult );
+                            return NULL;
+                        }
+                        panResult = panNew;
+                    }
+                    panResult[nResultCount++] = nValue;
+                }
+                else
+                {
+                    /* The child node position follows from the item one */
+                    nValue = hTree->anLevelStart[iLevel + 1] +
+                             (nItem - nLevelStart) * hTree->nNodeSize;
+                    if( nNextNodeCount == nNextNodeAlloc )
+                    {
+                        int *panNew;
+                        nNextNodeAlloc = nNextNodeAlloc * 2 + 64;
+                        panNew = (int *) realloc( panNextNodes,
+                                                  sizeof(int) * nNextNodeAlloc );
+                        if( panNew == NULL )
+                        {
+                            free( panNodes );
+                            free( panNextNodes );
+                            free( panResult );
+                            return NULL;
+                        }
+                        panNextNodes = panNew;
+                    }
+                    panNextNodes[nNextNodeCount++] = nValue;
+                }
+            }
+        }
+
+        /* Swap the node lists */
+        {
+            int *panTmp = panNodes;
+            int nTmpAlloc = nNodeAlloc;
+            panNodes = panNextNodes;
+            nNodeAlloc = nNextNodeAlloc;
+            nNodeCount = nNextNodeCount;
+            panNextNodes = panTmp;
+            nNextNodeAlloc = nTmpAlloc;
+        }
+
+        if( nNodeCount == 0 )
+            break;
+    }
+
+    free( panNodes );
+    free( panNextNodes );
+
+/* -------------------------------------------------------------------- */
+/*      Return the ids in file order.                                   */
+/* -------------------------------------------------------------------- */
+    if( nResultCount > 0 )
+        qsort( panResult, nResultCount, sizeof(int), compare_ints );
+
+    /* To distinguish between empty intersection from error case */
+    if( panResult == NULL )
+        panResult = (int *) calloc( 1, sizeof(int) );
+
+    *pnShapeCount = nResultCount;
+    return panResult;
+}
+
+/************************************************************************/
+/*                         SHPSearchRTreeFreeIds()                      */
+/************************************************************************/
+
+void SHPSearchRTreeFreeIds( int *panShapeId )
+
+{
+    free( panShapeId );
+}
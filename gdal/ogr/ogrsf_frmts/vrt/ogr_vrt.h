@@ -231,6 +231,10 @@ class OGRVRTDataSource : public OGRDataSource
                                                const char *pszVRTDirectory,
                                                int bUpdate,
                                                int nRecLevel);
+    OGRLayer*           InstanciateSpatialIndexedLayer(CPLXMLNode *psLTree,
+                                               const char *pszVRTDirectory,
+                                               int bUpdate,
+                                               int nRecLevel);
 
     OGRLayerPool*       poLayerPool;
 
@@ -33,6 +33,7 @@
 #include "cpl_string.h"
 #include "ogrwarpedlayer.h"
 #include "ogrunionlayer.h"
+#include "ogrspatialindexedlayer.h"
 
 CPL_CVSID("$Id$");
 
@@ -286,6 +287,81 @@ OGRLayer*  OGRVRTDataSource::InstanciateWarpedLayer(
     return poLayer;
 }
 
+/************************************************************************/
+/*                   InstanciateSpatialIndexedLayer()                   */
+/************************************************************************/
+
+OGRLayer*  OGRVRTDataSource::InstanciateSpatialIndexedLayer(
+                                        CPLXMLNode *psLTree,
+                                        const char *pszVRTDirectory,
+                                        int bUpdate,
+                                        int nRecLevel)
+{
+    if( !EQUAL(psLTree->pszValue,"OGRVRTSpatialIndexedLayer") )
+        return NULL;
+
+    CPLXMLNode *psSubNode;
+    OGRLayer* poSrcLayer = NULL;
+
+    for( psSubNode=psLTree->psChild;
+         psSubNode != NULL;
+         psSubNode=psSubNode->psNext )
+    {
+        if( psSubNode->eType != CXT_Element )
+            continue;
+
+        poSrcLayer = InstanciateLayer(psSubNode, pszVRTDirectory,
+                                 bUpdate, nRecLevel + 1);
+        if( poSrcLayer != NULL )
+            break;
+    }
+
+    if( poSrcLayer == NULL )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Cannot instanciate source layer" );
+        return NULL;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Optional sidecar file to persist the index in.                  */
+/* -------------------------------------------------------------------- */
+    CPLString osIndexFilename;
+    const char* pszIndexFile = CPLGetXMLValue(psLTree, "IndexFile", NULL);
+    if( pszIndexFile != NULL )
+    {
+        if( pszVRTDirectory != NULL &&
+            CSLTestBoolean(CPLGetXMLValue(psLTree, "IndexFile.relativeToVRT", "0")) )
+            osIndexFilename = CPLProjectRelativeFilename(pszVRTDirectory,
+                                                         pszIndexFile);
+        else
+            osIndexFilename = pszIndexFile;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      When the source is a plain file referenced by an OGRVRTLayer,   */
+/*      use it to detect a stale sidecar.                               */
+/* -------------------------------------------------------------------- */
+    CPLString osSourceFilename;
+    CPLXMLNode* psSrcLayerNode = CPLGetXMLNode(psLTree, "OGRVRTLayer");
+    const char* pszSrcDSName = (psSrcLayerNode != NULL) ?
+        CPLGetXMLValue(psSrcLayerNode, "SrcDataSource", NULL) : NULL;
+    if( pszSrcDSName != NULL && osIndexFilename.size() )
+    {
+        if( pszVRTDirectory != NULL &&
+            CSLTestBoolean(CPLGetXMLValue(psSrcLayerNode,
+                                          "SrcDataSource.relativeToVRT", "0")) )
+            osSourceFilename = CPLProjectRelativeFilename(pszVRTDirectory,
+                                                          pszSrcDSName);
+        else
+            osSourceFilename = pszSrcDSName;
+    }
+
+    return new OGRSpatialIndexedLayer(poSrcLayer, TRUE,
+                          osIndexFilename.size() ? osIndexFilename.c_str() : NULL,
+                          osSourceFilename.size() ? osSourceFilename.c_str() : NULL);
+}
+
 /************************************************************************/
 /*                        InstanciateUnionLayer()                       */
 /************************************************************************/
@@ -716,6 +792,11 @@ OGRLayer* OGRVRTDataSource::InstanciateLayerInternal(CPLXMLNode *psLTree,
         return InstanciateUnionLayer( psLTree, pszVRTDirectory,
                                       bUpdate, nRecLevel + 1 );
     }
+    else if( EQUAL(psLTree->pszValue,"OGRVRTSpatialIndexedLayer") && nRecLevel < 30 )
+    {
+        return InstanciateSpatialIndexedLayer( psLTree, pszVRTDirectory,
+                                               bUpdate, nRecLevel + 1 );
+    }
     else
         return NULL;
 }
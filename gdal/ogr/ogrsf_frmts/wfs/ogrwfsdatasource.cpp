@@ -2287,6 +2287,7 @@ OGRLayer * OGRWFSDataSource::ExecuteSQL( const char *pszSQLCommand,
         }
         else if( bStandardJoinsWFS2 &&
                  psSelectInfo->join_count > 0 &&
+                 psSelectInfo->group_by_specs == 0 &&
                  psSelectInfo->poOtherSelect == NULL )
         {
             // Just to make sure everything is valid, but we won't use
@@ -37,6 +37,12 @@
 #include "ogr_geometry.h"
 #include "ogr_p.h"
 
+/* We restrict to 64bit processors because they are guaranteed to have SSE2 */
+#if defined(__x86_64) || defined(_M_X64)
+#define OGR_WKB_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 #ifdef OGR_ENABLED
 # include "ogrsf_frmts.h"
 #endif /* OGR_ENABLED */
@@ -1359,3 +1365,126 @@ OGRErr OGRReadWKBGeometryType( unsigned char * pabyData, OGRwkbVariant eWkbVaria
     
     return OGRERR_NONE;
 }
+
+/************************************************************************/
+/*                          OGRSwapDouble2()                            */
+/*                                                                      */
+/*      Byte swap two consecutive doubles from pabySrc into pabyDst.    */
+/*      The buffers need not be aligned, and may be the same.           */
+/************************************************************************/
+
+static CPL_INLINE void OGRSwapDouble2( GByte *pabyDst, const GByte *pabySrc )
+
+{
+#ifdef OGR_WKB_USE_SSE2
+    __m128i xmm = _mm_loadu_si128( (const __m128i*) pabySrc );
+
+    /* Swap the two bytes of each 16 bit word, and then reverse the order */
+    /* of the four 16 bit words of each 64 bit lane. */
+    xmm = _mm_or_si128( _mm_slli_epi16( xmm, 8 ), _mm_srli_epi16( xmm, 8 ) );
+    xmm = _mm_shufflelo_epi16( xmm, _MM_SHUFFLE(0,1,2,3) );
+    xmm = _mm_shufflehi_epi16( xmm, _MM_SHUFFLE(0,1,2,3) );
+    _mm_storeu_si128( (__m128i*) pabyDst, xmm );
+#else
+    GByte abyTemp[16];
+
+    memcpy( abyTemp, pabySrc, 16 );
+    for( int i = 0; i < 8; i++ )
+    {
+        pabyDst[i] = abyTemp[7 - i];
+        pabyDst[8 + i] = abyTemp[15 - i];
+    }
+#endif
+}
+
+/************************************************************************/
+/*                         OGRCopyWkbDoubles()                          */
+/*                                                                      */
+/*      Copy nCount doubles between a WKB stream and memory, byte       */
+/*      swapping them on the fly when bSwap is set.  The swapping       */
+/*      processes two doubles at a time (with SSE2 when available)      */
+/*      so that large coordinate arrays are converted in one pass.      */
+/************************************************************************/
+
+void OGRCopyWkbDoubles( void *pDst, const void *pSrc, int nCount, int bSwap )
+
+{
+    GByte       *pabyDst = (GByte *) pDst;
+    const GByte *pabySrc = (const GByte *) pSrc;
+
+    if( !bSwap )
+    {
+        memcpy( pabyDst, pabySrc, 8 * (size_t) nCount );
+        return;
+    }
+
+    int i = 0;
+    for( ; i + 1 < nCount; i += 2 )
+        OGRSwapDouble2( pabyDst + 8 * i, pabySrc + 8 * i );
+
+    if( i < nCount )
+    {
+        memcpy( pabyDst + 8 * i, pabySrc + 8 * i, 8 );
+        CPL_SWAP64PTR( pabyDst + 8 * i );
+    }
+}
+
+/************************************************************************/
+/*                           OGRReadWkbXYZ()                            */
+/*                                                                      */
+/*      Split nPointCount interleaved x,y,z WKB vertices into an        */
+/*      OGRRawPoint array and a Z array, swapping when required.        */
+/************************************************************************/
+
+void OGRReadWkbXYZ( const GByte *pabyWkb, OGRRawPoint *paoPoints,
+                    double *padfZ, int nPointCount, int bSwap )
+
+{
+    for( int i = 0; i < nPointCount; i++ )
+    {
+        const GByte *pabyVertex = pabyWkb + 24 * i;
+
+        if( bSwap )
+        {
+            OGRSwapDouble2( (GByte *) (paoPoints + i), pabyVertex );
+            memcpy( padfZ + i, pabyVertex + 16, 8 );
+            CPL_SWAP64PTR( padfZ + i );
+        }
+        else
+        {
+            memcpy( paoPoints + i, pabyVertex, 16 );
+            memcpy( padfZ + i, pabyVertex + 16, 8 );
+        }
+    }
+}
+
+/************************************************************************/
+/*                          OGRWriteWkbXYZ()                            */
+/*                                                                      */
+/*      Interleave an OGRRawPoint array and a Z array (which may be     */
+/*      NULL, meaning all zero) into nPointCount x,y,z WKB vertices.    */
+/************************************************************************/
+
+void OGRWriteWkbXYZ( GByte *pabyWkb, const OGRRawPoint *paoPoints,
+                     const double *padfZ, int nPointCount, int bSwap )
+
+{
+    for( int i = 0; i < nPointCount; i++ )
+    {
+        GByte *pabyVertex = pabyWkb + 24 * i;
+
+        if( bSwap )
+            OGRSwapDouble2( pabyVertex, (const GByte *) (paoPoints + i) );
+        else
+            memcpy( pabyVertex, paoPoints + i, 16 );
+
+        if( padfZ == NULL )
+            memset( pabyVertex + 16, 0, 8 );
+        else
+        {
+            memcpy( pabyVertex + 16, padfZ + i, 8 );
+            if( bSwap )
+                CPL_SWAP64PTR( pabyVertex + 16 );
+        }
+    }
+}
@@ -243,6 +243,8 @@ int swqlex( YYSTYPE *ppNode, swq_parse_context *context )
             nReturn = SWQT_ON;
         else if( EQUAL(osToken,"ORDER") )
             nReturn = SWQT_ORDER;
+        else if( EQUAL(osToken,"GROUP") )
+            nReturn = SWQT_GROUP;
         else if( EQUAL(osToken,"BY") )
             nReturn = SWQT_BY;
         else if( EQUAL(osToken,"FROM") )
@@ -287,6 +289,20 @@ int swqlex( YYSTYPE *ppNode, swq_parse_context *context )
     }
 }
 
+/************************************************************************/
+/*                          swq_summary_init()                          */
+/************************************************************************/
+
+void swq_summary_init( swq_summary *summary )
+
+{
+    memset( summary, 0, sizeof(swq_summary) );
+    summary->min = 1e20;
+    summary->max = -1e20;
+    strcpy(summary->szMin, "9999/99/99 99:99:99");
+    strcpy(summary->szMax, "0000/00/00 00:00:00");
+}
+
 /************************************************************************/
 /*                        swq_select_summarize()                        */
 /************************************************************************/
@@ -321,59 +337,77 @@ swq_select_summarize( swq_select *select_info,
 
         select_info->column_summary = (swq_summary *) 
             CPLMalloc(sizeof(swq_summary) * select_info->result_columns);
-        memset( select_info->column_summary, 0, 
-                sizeof(swq_summary) * select_info->result_columns );
 
         for( i = 0; i < select_info->result_columns; i++ )
-        {
-            select_info->column_summary[i].min = 1e20;
-            select_info->column_summary[i].max = -1e20;
-            strcpy(select_info->column_summary[i].szMin, "9999/99/99 99:99:99");
-            strcpy(select_info->column_summary[i].szMax, "0000/00/00 00:00:00");
-        }
+            swq_summary_init( select_info->column_summary + i );
     }
 
     if( select_info->column_summary == NULL )
         return NULL;
 
 /* -------------------------------------------------------------------- */
-/*      If distinct processing is on, process that now.                 */
+/*      If distinct processing is on, process that now.  The values     */
+/*      of the list are indexed in a hash set so that high              */
+/*      cardinality columns do not require a scan of the list for       */
+/*      each new value.                                                 */
 /* -------------------------------------------------------------------- */
     summary = select_info->column_summary + dest_column;
     
     if( def->distinct_flag )
     {
-        GIntBig  i;
+        int bNew;
 
-        /* This should be implemented with a much more complicated
-           data structure to achieve any sort of efficiency. */
-        for( i = 0; i < summary->count; i++ )
+        if( value == NULL )
         {
-            if( value == NULL )
-            {
-                if (summary->distinct_list[i] == NULL)
-                    break;
-            }
-            else if( summary->distinct_list[i] != NULL &&
-                     strcmp(value,summary->distinct_list[i]) == 0 )
-                break;
+            bNew = !summary->distinct_has_null;
+            summary->distinct_has_null = TRUE;
         }
-        
-        if( i == summary->count )
+        else
         {
-            char  **old_list = summary->distinct_list;
-            
-            summary->distinct_list = (char **) 
-                CPLMalloc(sizeof(char *) * (size_t)(summary->count+1));
-            memcpy( summary->distinct_list, old_list, 
-                    sizeof(char *) * (size_t)summary->count );
-            summary->distinct_list[(summary->count)++] = 
-                (value != NULL) ? CPLStrdup( value ) : NULL;
-
-            CPLFree(old_list);
+            if( summary->distinct_set == NULL )
+                summary->distinct_set = CPLHashSetNew( CPLHashSetHashStr,
+                                                       CPLHashSetEqualStr,
+                                                       NULL );
+            bNew = CPLHashSetLookup( summary->distinct_set, value ) == NULL;
+        }
+
+        if( bNew )
+        {
+            /* Grow the list geometrically, i.e. when count is a power of 2 */
+            if( (summary->count & (summary->count - 1)) == 0 )
+            {
+                summary->distinct_list = (char **) 
+                    CPLRealloc( summary->distinct_list,
+                                sizeof(char *) *
+                                (size_t)(summary->count == 0 ? 1 : summary->count * 2) );
+            }
+
+            if( value != NULL )
+            {
+                char *pszValue = CPLStrdup( value );
+                summary->distinct_list[(summary->count)++] = pszValue;
+                CPLHashSetInsert( summary->distinct_set, pszValue );
+            }
+            else
+                summary->distinct_list[(summary->count)++] = NULL;
         }
     }
 
+    return swq_summary_accumulate( def, summary, value );
+}
+
+/************************************************************************/
+/*                       swq_summary_accumulate()                       */
+/*                                                                      */
+/*      Account for a value in the MIN/MAX/AVG/SUM/COUNT state of a     */
+/*      summary.                                                        */
+/************************************************************************/
+
+const char *swq_summary_accumulate( const swq_col_def *def,
+                                    swq_summary *summary,
+                                    const char *value )
+
+{
 /* -------------------------------------------------------------------- */
 /*      Process various options.                                        */
 /* -------------------------------------------------------------------- */
@@ -466,14 +500,15 @@ swq_select_summarize( swq_select *select_info,
         break;
 
       case SWQCF_CUSTOM:
-        return "swq_select_summarize() called on custom field function.";
+        return "swq_summary_accumulate() called on custom field function.";
 
       default:
-        return "swq_select_summarize() - unexpected col_func";
+        return "swq_summary_accumulate() - unexpected col_func";
     }
 
     return NULL;
 }
+
 /************************************************************************/
 /*                      sort comparison functions.                      */
 /************************************************************************/
@@ -841,6 +876,7 @@ static const char* apszSQLReservedKeywords[] = {
     "WHERE",
     "ON",
     "ORDER",
+    "GROUP",
     "BY",
     "FROM",
     "AS",
@@ -23,6 +23,7 @@
 
 #include "cpl_conv.h"
 #include "cpl_string.h"
+#include "cpl_hash_set.h"
 #include "ogr_core.h"
 
 #if defined(_WIN32) && !defined(_WIN32_WCE)
@@ -250,6 +251,55 @@ swq_expr_node *SWQCastEvaluator( swq_expr_node *, swq_expr_node **);
 swq_field_type SWQCastChecker( swq_expr_node *node, int bAllowMismatchTypeOnFieldComparison );
 const char*    SWQFieldTypeToString( swq_field_type field_type );
 
+/*
+** Compiled evaluation.
+*/
+
+/* Value of a column fetched by a swq_value_fetcher, or computed by a
+** swq_expr_program. string_value only needs to remain valid until the next
+** call to the fetcher.
+*/
+typedef struct {
+    swq_field_type field_type;
+    int            is_null;
+    GIntBig        int_value;
+    double         float_value;
+    const char    *string_value;
+} swq_value;
+
+typedef void (*swq_value_fetcher)( swq_expr_node *op, void *record_handle,
+                                   swq_value *value );
+
+class swq_compiled_node;
+
+/* Expression lowered to a tree of nodes with preallocated value slots, so
+** that it can be evaluated on each record without heap allocations.
+** Constant sub-expressions are folded, and AND/OR evaluate their second
+** argument only when needed. Operations that have no compiled form are
+** evaluated with swq_expr_node::Evaluate(). The program works on its own
+** copy of the expression.
+*/
+class swq_expr_program {
+    swq_expr_node     *poExpr;
+    swq_compiled_node *poRoot;
+    int                nFallbackCount;
+
+    swq_compiled_node *CompileNode( swq_expr_node * );
+
+public:
+    swq_expr_program( swq_expr_node *poExprIn );
+    ~swq_expr_program();
+
+    int            GetFallbackCount() { return nFallbackCount; }
+
+    const swq_value *Evaluate( swq_value_fetcher pfnValueFetcher,
+                               swq_field_fetcher pfnNodeFetcher,
+                               void *record );
+    int            EvaluateAsBoolean( swq_value_fetcher pfnValueFetcher,
+                                      swq_field_fetcher pfnNodeFetcher,
+                                      void *record );
+};
+
 /****************************************************************************/
 
 #define SWQP_ALLOW_UNDEFINED_COL_FUNCS 0x01
@@ -257,6 +307,7 @@ const char*    SWQFieldTypeToString( swq_field_type field_type );
 #define SWQM_SUMMARY_RECORD  1
 #define SWQM_RECORDSET       2
 #define SWQM_DISTINCT_LIST   3
+#define SWQM_GROUP_BY        4
 
 typedef enum {
     SWQCF_NONE = 0,
@@ -290,6 +341,8 @@ typedef struct {
     GIntBig     count;
     
     char        **distinct_list; /* items of the list can be NULL */
+    CPLHashSet  *distinct_set;   /* non NULL items of distinct_list */
+    int         distinct_has_null;
     double      sum;
     double      min;
     double      max;
@@ -305,6 +358,13 @@ typedef struct {
     int   ascending_flag;
 } swq_order_def;
 
+typedef struct {
+    char *table_name;
+    char *field_name;
+    int   table_index;
+    int   field_index;
+} swq_group_by_def;
+
 typedef struct {
     int        secondary_table;
     swq_expr_node  *poExpr;
@@ -362,6 +422,10 @@ public:
     int         order_specs;
     swq_order_def *order_defs;
 
+    void        PushGroupBy( const char* pszTableName, const char *pszFieldName );
+    int         group_by_specs;
+    swq_group_by_def *group_by_defs;
+
     swq_select *poOtherSelect;
     void        PushUnionAll( swq_select* poOtherSelectIn );
 
@@ -384,6 +448,10 @@ const char *swq_select_finish_summarize( swq_select *select_info );
 const char *swq_select_summarize( swq_select *select_info, 
                                   int dest_column, 
                                   const char *value );
+void swq_summary_init( swq_summary *summary );
+const char *swq_summary_accumulate( const swq_col_def *def,
+                                    swq_summary *summary,
+                                    const char *value );
 
 int swq_is_reserved_keyword(const char* pszStr);
 
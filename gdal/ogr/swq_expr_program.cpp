@@ -0,0 +1,819 @@
+/******************************************************************************
+ *
+ * Component: OGR SQL Engine
+ * Purpose: Implementation of swq_expr_program, an allocation free evaluator
+ *          of compiled swq_expr_node trees.
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "swq.h"
+
+CPL_CVSID("$Id$");
+
+int swq_test_like( const char *input, const char *pattern, char chEscape );
+
+typedef enum {
+    SCN_CONSTANT,
+    SCN_COLUMN,
+    SCN_GENERAL,    /* operation of SWQGeneralEvaluator() */
+    SCN_FALLBACK    /* evaluated with swq_expr_node::Evaluate() */
+} swq_compiled_node_type;
+
+/************************************************************************/
+/*                          swq_compiled_node                           */
+/************************************************************************/
+
+class swq_compiled_node
+{
+public:
+    swq_compiled_node_type eType;
+    swq_expr_node     *poNode;
+    int                nSubCount;
+    swq_compiled_node **papoSub;
+
+    /* FALSE if the result of the node can never be NULL */
+    int                bCanBeNull;
+
+    /* Result of the last evaluation. String results are stored in */
+    /* pszBuffer, unless they point to the string of a constant. */
+    swq_value          sValue;
+    char              *pszBuffer;
+    size_t             nBufferSize;
+
+    swq_compiled_node( swq_compiled_node_type eTypeIn, swq_expr_node *poNodeIn );
+    ~swq_compiled_node();
+
+    void               SetString( const char *pszStr, size_t nLen );
+    void               SetFromNode( swq_expr_node *poResult );
+};
+
+/************************************************************************/
+/*                         swq_compiled_node()                          */
+/************************************************************************/
+
+swq_compiled_node::swq_compiled_node( swq_compiled_node_type eTypeIn,
+                                      swq_expr_node *poNodeIn )
+
+{
+    eType = eTypeIn;
+    poNode = poNodeIn;
+    nSubCount = 0;
+    papoSub = NULL;
+    bCanBeNull = TRUE;
+    memset( &sValue, 0, sizeof(sValue) );
+    pszBuffer = NULL;
+    nBufferSize = 0;
+}
+
+/************************************************************************/
+/*                         ~swq_compiled_node()                         */
+/************************************************************************/
+
+swq_compiled_node::~swq_compiled_node()
+
+{
+    for( int i = 0; i < nSubCount; i++ )
+        delete papoSub[i];
+    CPLFree( papoSub );
+    CPLFree( pszBuffer );
+}
+
+/************************************************************************/
+/*                             SetString()                              */
+/*                                                                      */
+/*      Copy a string into the node buffer, which only grows.           */
+/************************************************************************/
+
+void swq_compiled_node::SetString( const char *pszStr, size_t nLen )
+
+{
+    if( nLen + 1 > nBufferSize )
+    {
+        nBufferSize = nLen + 1 + nBufferSize / 2;
+        pszBuffer = (char *) CPLRealloc( pszBuffer, nBufferSize );
+    }
+    memmove( pszBuffer, pszStr, nLen );
+    pszBuffer[nLen] = '\0';
+    sValue.string_value = pszBuffer;
+}
+
+/************************************************************************/
+/*                            SetFromNode()                             */
+/************************************************************************/
+
+void swq_compiled_node::SetFromNode( swq_expr_node *poResult )
+
+{
+    sValue.field_type = poResult->field_type;
+    sValue.is_null = poResult->is_null;
+    sValue.int_value = poResult->int_value;
+    if( poResult->field_type == SWQ_FLOAT )
+        sValue.float_value = poResult->float_value;
+    else
+        sValue.float_value = (double) poResult->int_value;
+    if( poResult->string_value != NULL )
+        SetString( poResult->string_value, strlen(poResult->string_value) );
+    else
+        SetString( "", 0 );
+}
+
+/************************************************************************/
+/*                           IsConstantExpr()                           */
+/*                                                                      */
+/*      Whether an expression can be evaluated once for all : it only   */
+/*      involves constants and general or cast operations.              */
+/************************************************************************/
+
+static int IsConstantExpr( swq_expr_node *poNode )
+
+{
+    if( poNode->eNodeType == SNT_CONSTANT )
+        return poNode->field_type != SWQ_GEOMETRY;
+    if( poNode->eNodeType == SNT_COLUMN )
+        return FALSE;
+
+    const swq_operation *poOp =
+        swq_op_registrar::GetOperator( (swq_op) poNode->nOperation );
+    if( poOp == NULL || poNode->nOperation == SWQ_CUSTOM_FUNC ||
+        (poNode->nOperation >= SWQ_AVG && poNode->nOperation <= SWQ_SUM) )
+        return FALSE;
+
+    for( int i = 0; i < poNode->nSubExprCount; i++ )
+    {
+        if( !IsConstantExpr( poNode->papoSubExpr[i] ) )
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          swq_expr_program()                          */
+/************************************************************************/
+
+swq_expr_program::swq_expr_program( swq_expr_node *poExprIn )
+
+{
+    nFallbackCount = 0;
+    poExpr = (poExprIn != NULL) ? poExprIn->Clone() : NULL;
+    poRoot = (poExpr != NULL) ? CompileNode( poExpr ) : NULL;
+}
+
+/************************************************************************/
+/*                         ~swq_expr_program()                          */
+/************************************************************************/
+
+swq_expr_program::~swq_expr_program()
+
+{
+    delete poRoot;
+    delete poExpr;
+}
+
+/************************************************************************/
+/*                            CompileNode()                             */
+/************************************************************************/
+
+swq_compiled_node *swq_expr_program::CompileNode( swq_expr_node *poNode )
+
+{
+    swq_compiled_node *poCompiled;
+
+/* -------------------------------------------------------------------- */
+/*      Constants, and constant sub-expressions that we fold now.       */
+/* -------------------------------------------------------------------- */
+    if( poNode->eNodeType == SNT_CONSTANT
+        || (poNode->eNodeType == SNT_OPERATION && IsConstantExpr(poNode)) )
+    {
+        if( poNode->field_type == SWQ_GEOMETRY )
+        {
+            nFallbackCount ++;
+            return new swq_compiled_node( SCN_FALLBACK, poNode );
+        }
+
+        poCompiled = new swq_compiled_node( SCN_CONSTANT, poNode );
+        if( poNode->eNodeType == SNT_CONSTANT )
+        {
+            poCompiled->SetFromNode( poNode );
+        }
+        else
+        {
+            swq_expr_node *poResult = poNode->Evaluate( NULL, NULL );
+            if( poResult == NULL )
+            {
+                delete poCompiled;
+                nFallbackCount ++;
+                return new swq_compiled_node( SCN_FALLBACK, poNode );
+            }
+            poCompiled->SetFromNode( poResult );
+            delete poResult;
+        }
+        poCompiled->bCanBeNull = poCompiled->sValue.is_null;
+        return poCompiled;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Column values.                                                  */
+/* -------------------------------------------------------------------- */
+    if( poNode->eNodeType == SNT_COLUMN )
+    {
+        if( poNode->field_type == SWQ_GEOMETRY )
+        {
+            nFallbackCount ++;
+            return new swq_compiled_node( SCN_FALLBACK, poNode );
+        }
+        return new swq_compiled_node( SCN_COLUMN, poNode );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Operations that SWQGeneralEvaluator() implements, except the     */
+/*      ones that need heap allocations anyway.                         */
+/* -------------------------------------------------------------------- */
+    const swq_operation *poOp =
+        swq_op_registrar::GetOperator( (swq_op) poNode->nOperation );
+    if( poOp == NULL || poOp->pfnEvaluator != SWQGeneralEvaluator
+        || poNode->nOperation == SWQ_CUSTOM_FUNC
+        || poNode->nOperation == SWQ_HSTORE_GET_VALUE
+        || (poNode->nOperation >= SWQ_AVG && poNode->nOperation <= SWQ_SUM)
+        || poNode->nSubExprCount == 0 )
+    {
+        nFallbackCount ++;
+        return new swq_compiled_node( SCN_FALLBACK, poNode );
+    }
+
+    poCompiled = new swq_compiled_node( SCN_GENERAL, poNode );
+    poCompiled->nSubCount = poNode->nSubExprCount;
+    poCompiled->papoSub = (swq_compiled_node **)
+        CPLCalloc( sizeof(swq_compiled_node*), poNode->nSubExprCount );
+    for( int i = 0; i < poNode->nSubExprCount; i++ )
+        poCompiled->papoSub[i] = CompileNode( poNode->papoSubExpr[i] );
+
+    /* Boolean operations return FALSE rather than NULL on NULL arguments */
+    poCompiled->bCanBeNull = poNode->field_type != SWQ_BOOLEAN;
+
+    return poCompiled;
+}
+
+/************************************************************************/
+/*                         SWQStringEquals()                            */
+/*                                                                      */
+/*      Same comparison as SWQGeneralEvaluator() : when comparing       */
+/*      timestamps, the +00 at the end might be discarded if the other  */
+/*      member has no explicit timezone.                                */
+/************************************************************************/
+
+static int SWQStringEquals( const swq_value *psVal0, const swq_value *psVal1 )
+
+{
+    const char *pszStr0 = psVal0->string_value;
+    const char *pszStr1 = psVal1->string_value;
+
+    if( (psVal0->field_type == SWQ_TIMESTAMP ||
+         psVal0->field_type == SWQ_STRING) &&
+        (psVal1->field_type == SWQ_TIMESTAMP ||
+         psVal1->field_type == SWQ_STRING) )
+    {
+        size_t nLen0 = strlen(pszStr0);
+        size_t nLen1 = strlen(pszStr1);
+        if( nLen0 > 3 && nLen1 > 3 )
+        {
+            if( strcmp(pszStr0 + nLen0 - 3, "+00") == 0 &&
+                pszStr1[nLen1 - 3] == ':' )
+                return EQUALN(pszStr0, pszStr1, nLen1);
+            if( pszStr0[nLen0 - 3] == ':' &&
+                strcmp(pszStr1 + nLen1 - 3, "+00") == 0 )
+                return EQUALN(pszStr0, pszStr1, nLen0);
+        }
+    }
+
+    return strcasecmp(pszStr0, pszStr1) == 0;
+}
+
+/************************************************************************/
+/*                        SWQCompareIntegerTo()                         */
+/*                                                                      */
+/*      Same rule as SWQGeneralEvaluator() for the items of IN and the  */
+/*      upper bound of BETWEEN : a floating point item is compared as   */
+/*      such. Returns -1, 0 or 1.                                       */
+/************************************************************************/
+
+static int SWQCompareIntegerTo( GIntBig nValue, const swq_value *psOther )
+
+{
+    if( psOther->field_type == SWQ_FLOAT )
+    {
+        double dfValue = (double) nValue;
+        if( dfValue < psOther->float_value )
+            return -1;
+        return dfValue > psOther->float_value ? 1 : 0;
+    }
+    if( nValue < psOther->int_value )
+        return -1;
+    return nValue > psOther->int_value ? 1 : 0;
+}
+
+/************************************************************************/
+/*                           EvaluateNode()                             */
+/*                                                                      */
+/*      Evaluate a node into its value slot. Returns FALSE on error.    */
+/************************************************************************/
+
+static int EvaluateNode( swq_compiled_node *poCompiled,
+                         swq_value_fetcher pfnValueFetcher,
+                         swq_field_fetcher pfnNodeFetcher,
+                         void *pRecord )
+
+{
+    swq_value *psRet = &(poCompiled->sValue);
+    swq_expr_node *poNode = poCompiled->poNode;
+
+    switch( poCompiled->eType )
+    {
+      case SCN_CONSTANT:
+        return TRUE;
+
+      case SCN_COLUMN:
+      {
+        pfnValueFetcher( poNode, pRecord, psRet );
+        if( SWQ_IS_INTEGER(psRet->field_type) ||
+            psRet->field_type == SWQ_BOOLEAN )
+            psRet->float_value = (double) psRet->int_value;
+        else if( psRet->field_type != SWQ_FLOAT )
+        {
+            /* The string of the fetcher may not survive the next fetch */
+            const char *pszStr = psRet->string_value ? psRet->string_value : "";
+            poCompiled->SetString( pszStr, strlen(pszStr) );
+        }
+        return TRUE;
+      }
+
+      case SCN_FALLBACK:
+      {
+        swq_expr_node *poResult = poNode->Evaluate( pfnNodeFetcher, pRecord );
+        if( poResult == NULL )
+            return FALSE;
+        poCompiled->SetFromNode( poResult );
+        delete poResult;
+        return TRUE;
+      }
+
+      case SCN_GENERAL:
+        break;
+    }
+
+    swq_compiled_node **papoSub = poCompiled->papoSub;
+    int nSubCount = poCompiled->nSubCount;
+    int nOperation = poNode->nOperation;
+    int i;
+
+    psRet->field_type = poNode->field_type;
+    psRet->is_null = FALSE;
+    psRet->int_value = 0;
+    psRet->float_value = 0.0;
+    psRet->string_value = NULL;
+
+/* -------------------------------------------------------------------- */
+/*      AND and OR only evaluate their second argument if it can        */
+/*      change the result. A NULL argument makes the result FALSE.      */
+/* -------------------------------------------------------------------- */
+    if( (nOperation == SWQ_AND || nOperation == SWQ_OR)
+        && nSubCount == 2 && poNode->field_type == SWQ_BOOLEAN
+        && (SWQ_IS_INTEGER(papoSub[1]->poNode->field_type)
+            || papoSub[1]->poNode->field_type == SWQ_BOOLEAN) )
+    {
+        if( !EvaluateNode( papoSub[0], pfnValueFetcher, pfnNodeFetcher,
+                           pRecord ) )
+            return FALSE;
+        const swq_value *psVal0 = &(papoSub[0]->sValue);
+        if( SWQ_IS_INTEGER(psVal0->field_type)
+            || psVal0->field_type == SWQ_BOOLEAN )
+        {
+            if( psVal0->is_null )
+                return TRUE;
+            if( nOperation == SWQ_AND && !psVal0->int_value )
+                return TRUE;
+            if( nOperation == SWQ_OR && psVal0->int_value
+                && !papoSub[1]->bCanBeNull )
+            {
+                psRet->int_value = TRUE;
+                return TRUE;
+            }
+
+            if( !EvaluateNode( papoSub[1], pfnValueFetcher, pfnNodeFetcher,
+                               pRecord ) )
+                return FALSE;
+            const swq_value *psVal1 = &(papoSub[1]->sValue);
+            if( psVal1->field_type == SWQ_FLOAT )
+                return FALSE;
+            if( !psVal1->is_null )
+            {
+                if( nOperation == SWQ_AND )
+                    psRet->int_value = psVal1->int_value != 0;
+                else
+                    psRet->int_value = psVal0->int_value || psVal1->int_value;
+            }
+            return TRUE;
+        }
+        /* Otherwise go on with the general case, which will fail */
+        /* like SWQGeneralEvaluator() */
+        i = 1;
+    }
+    else
+        i = 0;
+
+    for( ; i < nSubCount; i++ )
+    {
+        if( !EvaluateNode( papoSub[i], pfnValueFetcher, pfnNodeFetcher,
+                           pRecord ) )
+            return FALSE;
+    }
+
+    const swq_value *psVal0 = &(papoSub[0]->sValue);
+    const swq_value *psVal1 = (nSubCount > 1) ? &(papoSub[1]->sValue) : NULL;
+
+/* -------------------------------------------------------------------- */
+/*      NULL arguments.                                                 */
+/* -------------------------------------------------------------------- */
+    int bFloat = psVal0->field_type == SWQ_FLOAT
+        || (psVal1 != NULL && psVal1->field_type == SWQ_FLOAT);
+    int bInteger = !bFloat && (SWQ_IS_INTEGER(psVal0->field_type)
+                               || psVal0->field_type == SWQ_BOOLEAN);
+
+    if( nOperation != SWQ_ISNULL )
+    {
+        for( i = 0; i < nSubCount; i++ )
+        {
+            if( !papoSub[i]->sValue.is_null )
+                continue;
+
+            if( psRet->field_type == SWQ_BOOLEAN )
+            {
+                psRet->int_value = FALSE;
+                return TRUE;
+            }
+            else if( bFloat && psRet->field_type == SWQ_FLOAT )
+            {
+                psRet->is_null = TRUE;
+                return TRUE;
+            }
+            else if( (bFloat || bInteger) &&
+                     (SWQ_IS_INTEGER(psRet->field_type) ||
+                      (bFloat && nOperation == SWQ_MODULUS)) )
+            {
+                if( bFloat )
+                    psRet->field_type = SWQ_INTEGER;
+                psRet->is_null = TRUE;
+                return TRUE;
+            }
+            else if( !bFloat && !bInteger &&
+                     psRet->field_type == SWQ_STRING )
+            {
+                poCompiled->SetString( "", 0 );
+                psRet->is_null = TRUE;
+                return TRUE;
+            }
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Floating point operations.                                      */
+/* -------------------------------------------------------------------- */
+    if( bFloat )
+    {
+        double dfVal0 = psVal0->float_value;
+        double dfVal1 = (psVal1 != NULL) ? psVal1->float_value : 0.0;
+
+        switch( nOperation )
+        {
+          case SWQ_EQ: psRet->int_value = dfVal0 == dfVal1; break;
+          case SWQ_NE: psRet->int_value = dfVal0 != dfVal1; break;
+          case SWQ_GT: psRet->int_value = dfVal0 > dfVal1; break;
+          case SWQ_LT: psRet->int_value = dfVal0 < dfVal1; break;
+          case SWQ_GE: psRet->int_value = dfVal0 >= dfVal1; break;
+          case SWQ_LE: psRet->int_value = dfVal0 <= dfVal1; break;
+
+          case SWQ_IN:
+            for( i = 1; i < nSubCount; i++ )
+            {
+                if( dfVal0 == papoSub[i]->sValue.float_value )
+                {
+                    psRet->int_value = 1;
+                    break;
+                }
+            }
+            break;
+
+          case SWQ_BETWEEN:
+            psRet->int_value = dfVal0 >= dfVal1 &&
+                               dfVal0 <= papoSub[2]->sValue.float_value;
+            break;
+
+          case SWQ_ISNULL:
+            psRet->int_value = psVal0->is_null;
+            break;
+
+          case SWQ_ADD: psRet->float_value = dfVal0 + dfVal1; break;
+          case SWQ_SUBTRACT: psRet->float_value = dfVal0 - dfVal1; break;
+          case SWQ_MULTIPLY: psRet->float_value = dfVal0 * dfVal1; break;
+
+          case SWQ_DIVIDE:
+            if( dfVal1 == 0 )
+                psRet->float_value = INT_MAX;
+            else
+                psRet->float_value = dfVal0 / dfVal1;
+            break;
+
+          case SWQ_MODULUS:
+          {
+            GIntBig nRight = (GIntBig) dfVal1;
+            psRet->field_type = SWQ_INTEGER;
+            if( nRight == 0 )
+                psRet->int_value = INT_MAX;
+            else
+                psRet->int_value = ((GIntBig) dfVal0) % nRight;
+            break;
+          }
+
+          default:
+            return FALSE;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Integer/boolean operations.                                     */
+/* -------------------------------------------------------------------- */
+    else if( bInteger )
+    {
+        GIntBig nVal0 = psVal0->int_value;
+        GIntBig nVal1 = (psVal1 != NULL) ? psVal1->int_value : 0;
+
+        switch( nOperation )
+        {
+          case SWQ_AND: psRet->int_value = nVal0 && nVal1; break;
+          case SWQ_OR: psRet->int_value = nVal0 || nVal1; break;
+          case SWQ_NOT: psRet->int_value = !nVal0; break;
+          case SWQ_EQ: psRet->int_value = nVal0 == nVal1; break;
+          case SWQ_NE: psRet->int_value = nVal0 != nVal1; break;
+          case SWQ_GT: psRet->int_value = nVal0 > nVal1; break;
+          case SWQ_LT: psRet->int_value = nVal0 < nVal1; break;
+          case SWQ_GE: psRet->int_value = nVal0 >= nVal1; break;
+          case SWQ_LE: psRet->int_value = nVal0 <= nVal1; break;
+
+          case SWQ_IN:
+            for( i = 1; i < nSubCount; i++ )
+            {
+                if( SWQCompareIntegerTo( nVal0, &(papoSub[i]->sValue) ) == 0 )
+                {
+                    psRet->int_value = 1;
+                    break;
+                }
+            }
+            break;
+
+          case SWQ_BETWEEN:
+            psRet->int_value = nVal0 >= nVal1 &&
+                SWQCompareIntegerTo( nVal0, &(papoSub[2]->sValue) ) <= 0;
+            break;
+
+          case SWQ_ISNULL:
+            psRet->int_value = psVal0->is_null;
+            break;
+
+          case SWQ_ADD: psRet->int_value = nVal0 + nVal1; break;
+          case SWQ_SUBTRACT: psRet->int_value = nVal0 - nVal1; break;
+          case SWQ_MULTIPLY: psRet->int_value = nVal0 * nVal1; break;
+
+          case SWQ_DIVIDE:
+            if( nVal1 == 0 )
+                psRet->int_value = INT_MAX;
+            else
+                psRet->int_value = nVal0 / nVal1;
+            break;
+
+          case SWQ_MODULUS:
+            if( nVal1 == 0 )
+                psRet->int_value = INT_MAX;
+            else
+                psRet->int_value = nVal0 % nVal1;
+            break;
+
+          default:
+            return FALSE;
+        }
+        psRet->float_value = (double) psRet->int_value;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      String operations.                                              */
+/* -------------------------------------------------------------------- */
+    else
+    {
+        const char *pszVal0 = psVal0->string_value;
+        const char *pszVal1 = (psVal1 != NULL) ? psVal1->string_value : NULL;
+
+        if( pszVal0 == NULL ||
+            (psVal1 != NULL && pszVal1 == NULL && nOperation != SWQ_SUBSTR) )
+            return FALSE;
+
+        switch( nOperation )
+        {
+          case SWQ_EQ:
+            psRet->int_value = SWQStringEquals( psVal0, psVal1 );
+            break;
+          case SWQ_NE:
+            psRet->int_value = strcasecmp(pszVal0, pszVal1) != 0;
+            break;
+          case SWQ_GT:
+            psRet->int_value = strcasecmp(pszVal0, pszVal1) > 0;
+            break;
+          case SWQ_LT:
+            psRet->int_value = strcasecmp(pszVal0, pszVal1) < 0;
+            break;
+          case SWQ_GE:
+            psRet->int_value = strcasecmp(pszVal0, pszVal1) >= 0;
+            break;
+          case SWQ_LE:
+            psRet->int_value = strcasecmp(pszVal0, pszVal1) <= 0;
+            break;
+
+          case SWQ_IN:
+            for( i = 1; i < nSubCount; i++ )
+            {
+                if( papoSub[i]->sValue.string_value != NULL &&
+                    strcasecmp(pszVal0, papoSub[i]->sValue.string_value) == 0 )
+                {
+                    psRet->int_value = 1;
+                    break;
+                }
+            }
+            break;
+
+          case SWQ_BETWEEN:
+            if( papoSub[2]->sValue.string_value == NULL )
+                return FALSE;
+            psRet->int_value =
+                strcasecmp(pszVal0, pszVal1) >= 0 &&
+                strcasecmp(pszVal0, papoSub[2]->sValue.string_value) <= 0;
+            break;
+
+          case SWQ_LIKE:
+          {
+            char chEscape = '\0';
+            if( nSubCount == 3 && papoSub[2]->sValue.string_value != NULL )
+                chEscape = papoSub[2]->sValue.string_value[0];
+            psRet->int_value = swq_test_like( pszVal0, pszVal1, chEscape );
+            break;
+          }
+
+          case SWQ_ISNULL:
+            psRet->int_value = psVal0->is_null;
+            break;
+
+          case SWQ_CONCAT:
+          case SWQ_ADD:
+          {
+            size_t nLen = 0;
+            for( i = 0; i < nSubCount; i++ )
+            {
+                if( papoSub[i]->sValue.string_value == NULL )
+                    return FALSE;
+                nLen += strlen(papoSub[i]->sValue.string_value);
+            }
+            poCompiled->SetString( "", 0 );
+            if( nLen + 1 > poCompiled->nBufferSize )
+            {
+                poCompiled->nBufferSize = nLen + 1;
+                poCompiled->pszBuffer = (char *)
+                    CPLRealloc( poCompiled->pszBuffer, nLen + 1 );
+            }
+            size_t nOffset = 0;
+            for( i = 0; i < nSubCount; i++ )
+            {
+                size_t nSubLen = strlen(papoSub[i]->sValue.string_value);
+                memcpy( poCompiled->pszBuffer + nOffset,
+                        papoSub[i]->sValue.string_value, nSubLen );
+                nOffset += nSubLen;
+            }
+            poCompiled->pszBuffer[nOffset] = '\0';
+            psRet->string_value = poCompiled->pszBuffer;
+            psRet->is_null = psVal0->is_null;
+            break;
+          }
+
+          case SWQ_SUBSTR:
+          {
+            int nOffset, nSize;
+            const swq_value *psVal2 = (nSubCount > 2) ? &(papoSub[2]->sValue) : NULL;
+
+            if( SWQ_IS_INTEGER(psVal1->field_type) )
+                nOffset = (int) psVal1->int_value;
+            else if( psVal1->field_type == SWQ_FLOAT )
+                nOffset = (int) psVal1->float_value;
+            else
+                nOffset = 0;
+
+            if( psVal2 == NULL )
+                nSize = 100000;
+            else if( SWQ_IS_INTEGER(psVal2->field_type) )
+                nSize = (int) psVal2->int_value;
+            else if( psVal2->field_type == SWQ_FLOAT )
+                nSize = (int) psVal2->float_value;
+            else
+                nSize = 0;
+
+            int nSrcStrLen = (int) strlen(pszVal0);
+
+            /* In SQL, the first character is at offset 1 */
+            /* And 0 is considered as 1 */
+            if( nOffset > 0 )
+                nOffset --;
+            /* Some implementations allow negative offsets, to start */
+            /* from the end of the string */
+            else if( nOffset < 0 )
+            {
+                if( nSrcStrLen + nOffset >= 0 )
+                    nOffset = nSrcStrLen + nOffset;
+                else
+                    nOffset = 0;
+            }
+
+            if( nSize < 0 || nOffset > nSrcStrLen )
+            {
+                nOffset = 0;
+                nSize = 0;
+            }
+            else if( nOffset + nSize > nSrcStrLen )
+                nSize = nSrcStrLen - nOffset;
+
+            poCompiled->SetString( pszVal0 + nOffset, nSize );
+            psRet->is_null = psVal0->is_null;
+            break;
+          }
+
+          default:
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/*                                                                      */
+/*      Returns the value of the expression for the record, or NULL     */
+/*      on error. The value is valid until the next evaluation.         */
+/************************************************************************/
+
+const swq_value *swq_expr_program::Evaluate( swq_value_fetcher pfnValueFetcher,
+                                             swq_field_fetcher pfnNodeFetcher,
+                                             void *pRecord )
+
+{
+    if( poRoot == NULL ||
+        !EvaluateNode( poRoot, pfnValueFetcher, pfnNodeFetcher, pRecord ) )
+        return NULL;
+
+    return &(poRoot->sValue);
+}
+
+/************************************************************************/
+/*                         EvaluateAsBoolean()                          */
+/************************************************************************/
+
+int swq_expr_program::EvaluateAsBoolean( swq_value_fetcher pfnValueFetcher,
+                                         swq_field_fetcher pfnNodeFetcher,
+                                         void *pRecord )
+
+{
+    const swq_value *psResult = Evaluate( pfnValueFetcher, pfnNodeFetcher,
+                                          pRecord );
+    if( psResult == NULL )
+        return FALSE;
+
+    if( SWQ_IS_INTEGER(psResult->field_type) ||
+        psResult->field_type == SWQ_BOOLEAN )
+        return (int) psResult->int_value;
+
+    return FALSE;
+}
@@ -241,6 +241,30 @@ char* OGRHStoreGetValue(const char* pszHStore, const char* pszSearchedKey)
     return pszRet;
 }
 
+/************************************************************************/
+/*                        SWQCompareIntegerTo()                         */
+/*                                                                      */
+/*      Compare an integer with an item of an IN list or the upper      */
+/*      bound of BETWEEN, which can be a floating point value when      */
+/*      the first two arguments are integers.  Returns -1, 0 or 1.      */
+/*      swq_expr_program applies the same rule.                         */
+/************************************************************************/
+
+static int SWQCompareIntegerTo( GIntBig nValue, swq_expr_node *poOther )
+
+{
+    if( poOther->field_type == SWQ_FLOAT )
+    {
+        double dfValue = (double) nValue;
+        if( dfValue < poOther->float_value )
+            return -1;
+        return dfValue > poOther->float_value ? 1 : 0;
+    }
+    if( nValue < poOther->int_value )
+        return -1;
+    return nValue > poOther->int_value ? 1 : 0;
+}
+
 /************************************************************************/
 /*                        SWQGeneralEvaluator()                         */
 /************************************************************************/
@@ -262,11 +286,15 @@ swq_expr_node *SWQGeneralEvaluator( swq_expr_node *node,
         poRet = new swq_expr_node(0);
         poRet->field_type = node->field_type;
 
-        if( SWQ_IS_INTEGER(sub_node_values[0]->field_type) )
-            sub_node_values[0]->float_value = (double) sub_node_values[0]->int_value;
-        if( node->nSubExprCount > 1 &&
-            SWQ_IS_INTEGER(sub_node_values[1]->field_type) )
-            sub_node_values[1]->float_value = (double)sub_node_values[1]->int_value;
+        /* All arguments, including the list of IN and the upper bound */
+        /* of BETWEEN, are compared as floating point values. */
+        for( int i = 0; i < node->nSubExprCount; i++ )
+        {
+            if( SWQ_IS_INTEGER(sub_node_values[i]->field_type) ||
+                sub_node_values[i]->field_type == SWQ_BOOLEAN )
+                sub_node_values[i]->float_value =
+                    (double) sub_node_values[i]->int_value;
+        }
 
         if( node->nOperation != SWQ_ISNULL )
         {
@@ -480,8 +508,8 @@ swq_expr_node *SWQGeneralEvaluator( swq_expr_node *node,
               poRet->int_value = 0;
               for( i = 1; i < node->nSubExprCount; i++ )
               {
-                  if( sub_node_values[0]->int_value 
-                      == sub_node_values[i]->int_value )
+                  if( SWQCompareIntegerTo( sub_node_values[0]->int_value,
+                                           sub_node_values[i] ) == 0 )
                   {
                       poRet->int_value = 1;
                       break;
@@ -493,8 +521,8 @@ swq_expr_node *SWQGeneralEvaluator( swq_expr_node *node,
           case SWQ_BETWEEN:
             poRet->int_value = sub_node_values[0]->int_value
                                 >= sub_node_values[1]->int_value &&
-                               sub_node_values[0]->int_value
-                                <= sub_node_values[2]->int_value;
+                               SWQCompareIntegerTo( sub_node_values[0]->int_value,
+                                                    sub_node_values[2] ) <= 0;
             break;
 
           case SWQ_ISNULL:
@@ -167,22 +167,23 @@ extern int swqdebug;
     SWQT_WHERE = 271,
     SWQT_ON = 272,
     SWQT_ORDER = 273,
-    SWQT_BY = 274,
-    SWQT_FROM = 275,
-    SWQT_AS = 276,
-    SWQT_ASC = 277,
-    SWQT_DESC = 278,
-    SWQT_DISTINCT = 279,
-    SWQT_CAST = 280,
-    SWQT_UNION = 281,
-    SWQT_ALL = 282,
-    SWQT_VALUE_START = 283,
-    SWQT_SELECT_START = 284,
-    SWQT_NOT = 285,
-    SWQT_OR = 286,
-    SWQT_AND = 287,
-    SWQT_UMINUS = 288,
-    SWQT_RESERVED_KEYWORD = 289
+    SWQT_GROUP = 274,
+    SWQT_BY = 275,
+    SWQT_FROM = 276,
+    SWQT_AS = 277,
+    SWQT_ASC = 278,
+    SWQT_DESC = 279,
+    SWQT_DISTINCT = 280,
+    SWQT_CAST = 281,
+    SWQT_UNION = 282,
+    SWQT_ALL = 283,
+    SWQT_VALUE_START = 284,
+    SWQT_SELECT_START = 285,
+    SWQT_NOT = 286,
+    SWQT_OR = 287,
+    SWQT_AND = 288,
+    SWQT_UMINUS = 289,
+    SWQT_RESERVED_KEYWORD = 290
   };
 #endif
 
@@ -201,7 +202,7 @@ int swqparse (swq_parse_context *context);
 
 /* Copy the second part of user declarations.  */
 
-#line 205 "swq_parser.cpp" /* yacc.c:358  */
+#line 206 "swq_parser.cpp" /* yacc.c:358  */
 
 #ifdef short
 # undef short
@@ -424,21 +425,21 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  20
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   416
+#define YYLAST   393
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  48
+#define YYNTOKENS  49
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  20
+#define YYNNTS  23
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  87
+#define YYNRULES  92
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  185
+#define YYNSTATES  193
 
 /* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
    by yylex, with out-of-bounds checking.  */
 #define YYUNDEFTOK  2
-#define YYMAXUTOK   289
+#define YYMAXUTOK   290
 
 #define YYTRANSLATE(YYX)                                                \
   ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
@@ -450,10 +451,10 @@ static const yytype_uint8 yytranslate[] =
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,    36,     2,     2,     2,    41,     2,     2,
-      44,    45,    39,    37,    46,    38,    47,    40,     2,     2,
+       2,     2,     2,    37,     2,     2,     2,    42,     2,     2,
+      45,    46,    40,    38,    47,    39,    48,    41,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      34,    33,    35,     2,     2,     2,     2,     2,     2,     2,
+      35,    34,    36,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -475,22 +476,24 @@ static const yytype_uint8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
-      25,    26,    27,    28,    29,    30,    31,    32,    42,    43
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    43,
+      44
 };
 
 #if YYDEBUG
   /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint16 yyrline[] =
 {
-       0,   112,   112,   113,   118,   124,   129,   137,   145,   152,
-     160,   168,   176,   184,   192,   200,   208,   216,   224,   232,
-     245,   254,   268,   277,   292,   301,   315,   322,   336,   342,
-     349,   356,   368,   373,   378,   382,   387,   392,   397,   413,
-     420,   427,   434,   441,   448,   484,   492,   498,   505,   514,
-     532,   552,   553,   556,   561,   567,   568,   570,   578,   579,
-     582,   591,   602,   616,   638,   668,   702,   726,   755,   761,
-     764,   765,   770,   771,   777,   784,   785,   788,   789,   792,
-     798,   804,   812,   822,   833,   844,   857,   868
+       0,   113,   113,   114,   119,   125,   130,   138,   146,   153,
+     161,   169,   177,   185,   193,   201,   209,   217,   225,   233,
+     246,   255,   269,   278,   293,   302,   316,   323,   337,   343,
+     350,   357,   369,   374,   379,   383,   388,   393,   398,   414,
+     421,   428,   435,   442,   449,   485,   493,   499,   506,   515,
+     533,   553,   554,   557,   562,   568,   569,   571,   579,   580,
+     583,   592,   603,   617,   639,   669,   703,   727,   756,   762,
+     765,   766,   771,   772,   778,   785,   786,   789,   790,   793,
+     800,   801,   804,   805,   808,   814,   820,   828,   838,   849,
+     860,   873,   884
 };
 #endif
 
@@ -503,16 +506,16 @@ static const char *const yytname[] =
   "\"floating point number\"", "\"string\"", "\"identifier\"", "\"IN\"",
   "\"LIKE\"", "\"ESCAPE\"", "\"BETWEEN\"", "\"NULL\"", "\"IS\"",
   "\"SELECT\"", "\"LEFT\"", "\"JOIN\"", "\"WHERE\"", "\"ON\"", "\"ORDER\"",
-  "\"BY\"", "\"FROM\"", "\"AS\"", "\"ASC\"", "\"DESC\"", "\"DISTINCT\"",
-  "\"CAST\"", "\"UNION\"", "\"ALL\"", "SWQT_VALUE_START",
+  "\"GROUP\"", "\"BY\"", "\"FROM\"", "\"AS\"", "\"ASC\"", "\"DESC\"",
+  "\"DISTINCT\"", "\"CAST\"", "\"UNION\"", "\"ALL\"", "SWQT_VALUE_START",
   "SWQT_SELECT_START", "\"NOT\"", "\"OR\"", "\"AND\"", "'='", "'<'", "'>'",
   "'!'", "'+'", "'-'", "'*'", "'/'", "'%'", "SWQT_UMINUS",
   "\"reserved keyword\"", "'('", "')'", "','", "'.'", "$accept", "input",
   "value_expr", "value_expr_list", "field_value", "value_expr_non_logical",
   "type_def", "select_statement", "select_core", "opt_union_all",
   "union_all", "select_field_list", "column_spec", "as_clause",
-  "opt_where", "opt_joins", "opt_order_by", "sort_spec_list", "sort_spec",
-  "table_def", YY_NULL
+  "opt_where", "opt_joins", "opt_group_by", "group_spec_list",
+  "group_spec", "opt_order_by", "sort_spec_list", "sort_spec", "table_def", YY_NULL
 };
 #endif
 
@@ -524,15 +527,15 @@ static const yytype_uint16 yytoknum[] =
        0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
      265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
      275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,    61,    60,    62,    33,    43,    45,    42,
-      47,    37,   288,   289,    40,    41,    44,    46
+     285,   286,   287,   288,    61,    60,    62,    33,    43,    45,
+      42,    47,    37,   289,   290,    40,    41,    44,    46
 };
 # endif
 
-#define YYPACT_NINF -119
+#define YYPACT_NINF -127
 
 #define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-119)))
+  (!!((Yystate) == (-127)))
 
 #define YYTABLE_NINF -1
 
@@ -543,25 +546,26 @@ static const yytype_uint16 yytoknum[] =
      STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-      -9,   204,    -6,    10,  -119,  -119,  -119,   -30,  -119,   -32,
-     204,   240,   204,   342,  -119,   356,    54,    12,  -119,     4,
-    -119,   204,    35,   204,   380,  -119,   263,    18,   204,   240,
-      50,    87,   204,   204,    97,   112,   158,    33,   240,   240,
-     240,   240,   240,   -23,   194,  -119,   297,    36,    28,    31,
-      56,  -119,    -6,   256,    42,  -119,   335,  -119,   204,    82,
-      72,  -119,    70,    55,   204,   240,   247,   350,   204,   204,
-    -119,   204,   204,  -119,   204,  -119,   204,    80,    80,  -119,
-    -119,  -119,   148,     0,    94,  -119,   118,  -119,    47,   194,
-       4,  -119,  -119,   204,  -119,   120,    85,   204,   240,  -119,
-     204,   124,   284,  -119,  -119,  -119,  -119,  -119,  -119,   130,
-      95,  -119,    47,  -119,    96,    -5,    75,  -119,  -119,  -119,
-     100,   101,  -119,  -119,   356,   103,   204,   240,   108,   115,
-       2,    75,   151,   159,  -119,   153,    47,   150,    23,  -119,
-    -119,  -119,   356,     2,  -119,   150,     2,     2,    47,   154,
-     204,   152,    61,    83,  -119,   152,  -119,  -119,   157,   204,
-     342,   156,  -119,  -119,   173,  -119,   174,  -119,   204,   305,
-     130,   134,   135,   305,  -119,   116,  -119,   136,  -119,  -119,
-    -119,  -119,  -119,   130,  -119
+     -17,   217,    -6,     2,  -127,  -127,  -127,   -25,  -127,   -24,
+     217,    50,   217,   312,  -127,   331,    87,    16,  -127,    31,
+    -127,   217,    56,   217,   356,  -127,   263,    19,   217,    50,
+      -3,     9,   217,   217,   105,   117,   170,    46,    50,    50,
+      50,    50,    50,    12,   207,  -127,   270,    66,    57,    51,
+      89,  -127,    -6,   232,    78,  -127,   319,  -127,   217,   110,
+      61,  -127,   118,    85,   217,    50,   224,   350,   217,   217,
+    -127,   217,   217,  -127,   217,  -127,   217,     0,     0,  -127,
+    -127,  -127,   160,    -2,   112,  -127,   129,  -127,    73,   207,
+      31,  -127,  -127,   217,  -127,   131,    92,   217,    50,  -127,
+     217,   130,   248,  -127,  -127,  -127,  -127,  -127,  -127,   136,
+      99,  -127,    73,  -127,    98,     4,    68,  -127,  -127,  -127,
+     102,   108,  -127,  -127,   331,   109,   217,    50,   111,   114,
+       8,    68,   151,   155,  -127,   154,    73,   156,    71,  -127,
+    -127,  -127,   331,     8,  -127,   156,     8,     8,    73,   153,
+     217,   158,    39,    60,  -127,   161,  -127,  -127,   165,   217,
+     312,   167,   161,  -127,   175,  -127,   185,   169,  -127,   217,
+     303,   136,  -127,   144,   146,   136,   303,  -127,  -127,  -127,
+     147,  -127,  -127,    91,  -127,   148,  -127,   136,  -127,  -127,
+     136,  -127,  -127
 };
 
   /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -580,28 +584,31 @@ static const yytype_uint8 yydefact[] =
       42,    43,     0,     0,     0,    69,     0,    61,     0,     0,
       55,    57,    56,     0,    44,     0,     0,     0,     0,    27,
        0,    19,     0,    15,    16,    14,    10,    17,    11,     0,
-       0,    63,     0,    68,     0,    82,    72,    59,    52,    28,
+       0,    63,     0,    68,     0,    87,    72,    59,    52,    28,
       46,     0,    22,    20,    24,     0,     0,     0,    30,     0,
-      64,    72,     0,     0,    83,     0,     0,    70,     0,    45,
-      23,    21,    25,    66,    65,    70,    84,    86,     0,     0,
-       0,    75,     0,     0,    67,    75,    85,    87,     0,     0,
-      71,     0,    53,    47,     0,    49,     0,    54,     0,    72,
-       0,     0,     0,    72,    73,    79,    76,    78,    48,    50,
-      74,    80,    81,     0,    77
+      64,    72,     0,     0,    88,     0,     0,    70,     0,    45,
+      23,    21,    25,    66,    65,    70,    89,    91,     0,     0,
+       0,    75,     0,     0,    67,    80,    90,    92,     0,     0,
+      71,     0,    80,    47,     0,    49,     0,     0,    54,     0,
+      72,     0,    53,     0,     0,     0,    72,    73,    79,    76,
+      78,    48,    50,    84,    81,    83,    74,     0,    85,    86,
+       0,    77,    82
 };
 
   /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -119,  -119,    -1,   -56,  -106,     7,  -119,   129,   167,    99,
-    -119,   -39,  -119,   -61,    40,  -118,    38,    11,  -119,  -108
+    -127,  -127,    -1,   -34,  -106,     7,  -127,   141,   180,   113,
+    -127,   -38,  -127,    37,    53,  -126,  -127,    15,  -127,    44,
+      17,  -127,  -111
 };
 
   /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int16 yydefgoto[] =
 {
       -1,     3,    53,    54,    14,    15,   121,    18,    19,    51,
-      52,    47,    48,    87,   151,   137,   162,   176,   177,   116
+      52,    47,    48,    87,   151,   137,   162,   179,   180,   168,
+     184,   185,   116
 };
 
   /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -609,133 +616,131 @@ static const yytype_int16 yydefgoto[] =
      number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
-      13,    85,    96,   129,   131,    84,    55,    16,    85,    24,
-      20,    26,    23,   145,    21,    46,    86,    22,    25,     1,
-       2,    82,    56,    86,    83,    16,   152,    59,   149,   153,
-      50,    66,    67,    70,    73,    75,    60,   119,    17,   111,
-     158,    55,   133,    46,   125,    77,    78,    79,    80,    81,
-     117,   174,   114,   115,   134,   180,    88,     4,     5,     6,
-      43,    61,    58,   101,   175,     8,    76,   103,   104,   144,
-     105,   106,   102,   107,    89,   108,    90,   175,    44,     9,
-      62,    99,   154,    91,    10,   156,   157,    94,    46,   135,
-     136,    97,    11,    45,    63,    64,   123,    65,    12,   100,
-       4,     5,     6,     7,    98,   124,   163,   164,     8,    38,
-      39,    40,    41,    42,   112,     4,     5,     6,     7,    40,
-      41,    42,     9,     8,   113,   141,   120,    10,   165,   166,
-     122,    68,    69,   126,   142,    11,   128,     9,   181,   182,
-     130,    12,    10,   132,   138,    71,   139,    72,   140,   160,
-      11,     4,     5,     6,     7,    22,    12,   146,   169,     8,
-     143,     4,     5,     6,     7,   147,   150,   173,   148,     8,
-     161,   159,   109,     9,   168,   170,   171,   172,    10,   178,
-     179,    92,   183,     9,    49,   155,    11,   110,    10,   118,
-       0,    74,    12,   167,   184,     0,    11,     4,     5,     6,
-      43,     0,    12,     0,     0,     8,     0,     4,     5,     6,
-       7,     0,     0,     0,     0,     8,     0,     0,     0,     9,
-       0,     0,     0,     0,    10,     0,     0,     0,     0,     9,
-       0,     0,    11,    45,    10,     0,     0,     0,    12,     0,
-       0,     0,    11,     4,     5,     6,     7,     0,    12,     0,
-       0,     8,     0,     0,    27,    28,     0,    29,     0,    30,
-       0,     0,     0,    27,    28,     9,    29,     0,    30,     0,
-      27,    28,     0,    29,     0,    30,     0,    31,    11,    33,
-      34,    35,    36,    37,    12,     0,    31,    32,    33,    34,
-      35,    36,    37,    31,    32,    33,    34,    35,    36,    37,
-       0,     0,    93,    85,    27,    28,     0,    29,    57,    30,
-       0,     0,    27,    28,     0,    29,   127,    30,    86,   135,
-     136,    38,    39,    40,    41,    42,     0,    31,    32,    33,
-      34,    35,    36,    37,     0,    31,    32,    33,    34,    35,
-      36,    37,    27,    28,     0,    29,     0,    30,     0,    27,
-      28,     0,    29,     0,    30,     0,    95,    27,    28,     0,
-      29,     0,    30,     0,     0,    31,    32,    33,    34,    35,
-      36,    37,    31,    32,    33,    34,    35,    36,    37,     0,
-      31,     0,     0,    34,    35,    36,    37,    27,    28,     0,
-      29,     0,    30,    38,    39,    40,    41,    42,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,    34,    35,    36,    37
+      13,   131,    20,   129,    55,   145,    84,    16,    61,    24,
+      85,    26,     1,     2,    85,    46,    63,    64,    25,    65,
+      21,    23,    56,    22,    96,   149,    86,    59,    62,    16,
+      86,    66,    67,    70,    73,    75,    60,   158,   111,    17,
+      40,    41,    42,    46,   177,    77,    78,    79,    80,    81,
+     186,   117,   133,     4,     5,     6,     7,    82,    50,   119,
+      83,     8,    55,   101,    58,   178,   125,   103,   104,   183,
+     105,   106,   102,   107,   152,   108,     9,   153,   114,   115,
+      76,   178,   135,   136,   183,   163,   164,    88,    46,    11,
+       4,     5,     6,    43,    98,    12,   123,    90,     8,    38,
+      39,    40,    41,    42,    89,   124,   165,   166,     4,     5,
+       6,     7,    44,     9,   188,   189,     8,    91,    10,    97,
+       4,     5,     6,     7,    94,   141,    11,    45,     8,    99,
+     100,     9,    12,   112,   142,   113,    10,   120,   122,   126,
+      68,    69,   128,     9,    11,   130,   132,   138,    10,   160,
+      12,    71,   134,    72,   139,   140,    11,   146,   170,    22,
+     143,   147,    12,     4,     5,     6,     7,   144,   176,   148,
+     159,     8,   150,     4,     5,     6,     7,   161,   173,   167,
+     154,     8,   169,   156,   157,   109,     9,   171,   174,   175,
+     181,    10,   182,    92,   187,   190,     9,    49,   155,    11,
+     110,    10,   191,   118,    74,    12,   172,   192,     0,    11,
+       4,     5,     6,    43,     0,    12,     0,     0,     8,     0,
+       4,     5,     6,     7,     0,     0,     0,     0,     8,     0,
+       0,    27,    28,     9,    29,     0,    30,     0,    10,    27,
+      28,     0,    29,     9,    30,     0,    11,    45,    10,     0,
+       0,     0,    12,     0,     0,    31,    11,    33,    34,    35,
+      36,    37,    12,    31,    32,    33,    34,    35,    36,    37,
+      27,    28,     0,    29,     0,    30,    85,    27,    28,    93,
+      29,   127,    30,     0,     0,     0,    38,    39,    40,    41,
+      42,     0,    86,     0,    31,    32,    33,    34,    35,    36,
+      37,    31,    32,    33,    34,    35,    36,    37,     0,    57,
+      27,    28,     0,    29,     0,    30,     0,   135,   136,    27,
+      28,     0,    29,     0,    30,     0,    27,    28,     0,    29,
+       0,    30,     0,     0,    31,    32,    33,    34,    35,    36,
+      37,    95,     0,    31,    32,    33,    34,    35,    36,    37,
+      31,    32,    33,    34,    35,    36,    37,    27,    28,     0,
+      29,     0,    30,    27,    28,     0,    29,     0,    30,    38,
+      39,    40,    41,    42,     0,     0,     0,     0,     0,     0,
+       0,    31,     0,     0,    34,    35,    36,    37,     0,     0,
+      34,    35,    36,    37
 };
 
 static const yytype_int16 yycheck[] =
 {
-       1,     6,    58,   109,   112,    44,     6,    13,     6,    10,
-       0,    12,    44,   131,    44,    16,    21,    47,    11,    28,
-      29,    44,    23,    21,    47,    13,     3,    28,   136,     6,
-      26,    32,    33,    34,    35,    36,    29,    93,    44,    39,
-     148,     6,    47,    44,   100,    38,    39,    40,    41,    42,
-      89,   169,     5,     6,   115,   173,    20,     3,     4,     5,
-       6,    11,    44,    64,   170,    11,    33,    68,    69,   130,
-      71,    72,    65,    74,    46,    76,    45,   183,    24,    25,
-      30,    11,   143,    27,    30,   146,   147,    45,    89,    14,
-      15,     9,    38,    39,     7,     8,    97,    10,    44,    44,
-       3,     4,     5,     6,    32,    98,    45,    46,    11,    37,
-      38,    39,    40,    41,    20,     3,     4,     5,     6,    39,
-      40,    41,    25,    11,     6,   126,     6,    30,    45,    46,
-      45,    34,    35,     9,   127,    38,     6,    25,    22,    23,
-      45,    44,    30,    47,    44,    33,    45,    35,    45,   150,
-      38,     3,     4,     5,     6,    47,    44,     6,   159,    11,
-      45,     3,     4,     5,     6,     6,    16,   168,    15,    11,
-      18,    17,    24,    25,    17,    19,     3,     3,    30,    45,
-      45,    52,    46,    25,    17,   145,    38,    39,    30,    90,
-      -1,    33,    44,   155,   183,    -1,    38,     3,     4,     5,
-       6,    -1,    44,    -1,    -1,    11,    -1,     3,     4,     5,
-       6,    -1,    -1,    -1,    -1,    11,    -1,    -1,    -1,    25,
-      -1,    -1,    -1,    -1,    30,    -1,    -1,    -1,    -1,    25,
-      -1,    -1,    38,    39,    30,    -1,    -1,    -1,    44,    -1,
-      -1,    -1,    38,     3,     4,     5,     6,    -1,    44,    -1,
-      -1,    11,    -1,    -1,     7,     8,    -1,    10,    -1,    12,
-      -1,    -1,    -1,     7,     8,    25,    10,    -1,    12,    -1,
-       7,     8,    -1,    10,    -1,    12,    -1,    30,    38,    32,
-      33,    34,    35,    36,    44,    -1,    30,    31,    32,    33,
-      34,    35,    36,    30,    31,    32,    33,    34,    35,    36,
-      -1,    -1,    46,     6,     7,     8,    -1,    10,    45,    12,
-      -1,    -1,     7,     8,    -1,    10,    32,    12,    21,    14,
-      15,    37,    38,    39,    40,    41,    -1,    30,    31,    32,
-      33,    34,    35,    36,    -1,    30,    31,    32,    33,    34,
-      35,    36,     7,     8,    -1,    10,    -1,    12,    -1,     7,
-       8,    -1,    10,    -1,    12,    -1,    21,     7,     8,    -1,
-      10,    -1,    12,    -1,    -1,    30,    31,    32,    33,    34,
-      35,    36,    30,    31,    32,    33,    34,    35,    36,    -1,
-      30,    -1,    -1,    33,    34,    35,    36,     7,     8,    -1,
-      10,    -1,    12,    37,    38,    39,    40,    41,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    33,    34,    35,    36
+       1,   112,     0,   109,     6,   131,    44,    13,    11,    10,
+       6,    12,    29,    30,     6,    16,     7,     8,    11,    10,
+      45,    45,    23,    48,    58,   136,    22,    28,    31,    13,
+      22,    32,    33,    34,    35,    36,    29,   148,    40,    45,
+      40,    41,    42,    44,   170,    38,    39,    40,    41,    42,
+     176,    89,    48,     3,     4,     5,     6,    45,    27,    93,
+      48,    11,     6,    64,    45,   171,   100,    68,    69,   175,
+      71,    72,    65,    74,     3,    76,    26,     6,     5,     6,
+      34,   187,    14,    15,   190,    46,    47,    21,    89,    39,
+       3,     4,     5,     6,    33,    45,    97,    46,    11,    38,
+      39,    40,    41,    42,    47,    98,    46,    47,     3,     4,
+       5,     6,    25,    26,    23,    24,    11,    28,    31,     9,
+       3,     4,     5,     6,    46,   126,    39,    40,    11,    11,
+      45,    26,    45,    21,   127,     6,    31,     6,    46,     9,
+      35,    36,     6,    26,    39,    46,    48,    45,    31,   150,
+      45,    34,   115,    36,    46,    46,    39,     6,   159,    48,
+      46,     6,    45,     3,     4,     5,     6,   130,   169,    15,
+      17,    11,    16,     3,     4,     5,     6,    19,     3,    18,
+     143,    11,    17,   146,   147,    25,    26,    20,     3,    20,
+      46,    31,    46,    52,    47,    47,    26,    17,   145,    39,
+      40,    31,   187,    90,    34,    45,   162,   190,    -1,    39,
+       3,     4,     5,     6,    -1,    45,    -1,    -1,    11,    -1,
+       3,     4,     5,     6,    -1,    -1,    -1,    -1,    11,    -1,
+      -1,     7,     8,    26,    10,    -1,    12,    -1,    31,     7,
+       8,    -1,    10,    26,    12,    -1,    39,    40,    31,    -1,
+      -1,    -1,    45,    -1,    -1,    31,    39,    33,    34,    35,
+      36,    37,    45,    31,    32,    33,    34,    35,    36,    37,
+       7,     8,    -1,    10,    -1,    12,     6,     7,     8,    47,
+      10,    33,    12,    -1,    -1,    -1,    38,    39,    40,    41,
+      42,    -1,    22,    -1,    31,    32,    33,    34,    35,    36,
+      37,    31,    32,    33,    34,    35,    36,    37,    -1,    46,
+       7,     8,    -1,    10,    -1,    12,    -1,    14,    15,     7,
+       8,    -1,    10,    -1,    12,    -1,     7,     8,    -1,    10,
+      -1,    12,    -1,    -1,    31,    32,    33,    34,    35,    36,
+      37,    22,    -1,    31,    32,    33,    34,    35,    36,    37,
+      31,    32,    33,    34,    35,    36,    37,     7,     8,    -1,
+      10,    -1,    12,     7,     8,    -1,    10,    -1,    12,    38,
+      39,    40,    41,    42,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    31,    -1,    -1,    34,    35,    36,    37,    -1,    -1,
+      34,    35,    36,    37
 };
 
   /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
      symbol of state STATE-NUM.  */
 static const yytype_uint8 yystos[] =
 {
-       0,    28,    29,    49,     3,     4,     5,     6,    11,    25,
-      30,    38,    44,    50,    52,    53,    13,    44,    55,    56,
-       0,    44,    47,    44,    50,    53,    50,     7,     8,    10,
-      12,    30,    31,    32,    33,    34,    35,    36,    37,    38,
-      39,    40,    41,     6,    24,    39,    50,    59,    60,    56,
-      26,    57,    58,    50,    51,     6,    50,    45,    44,    50,
-      53,    11,    30,     7,     8,    10,    50,    50,    34,    35,
-      50,    33,    35,    50,    33,    50,    33,    53,    53,    53,
-      53,    53,    44,    47,    59,     6,    21,    61,    20,    46,
-      45,    27,    55,    46,    45,    21,    51,     9,    32,    11,
-      44,    50,    53,    50,    50,    50,    50,    50,    50,    24,
-      39,    39,    20,     6,     5,     6,    67,    59,    57,    51,
-       6,    54,    45,    50,    53,    51,     9,    32,     6,    52,
-      45,    67,    47,    47,    61,    14,    15,    63,    44,    45,
-      45,    50,    53,    45,    61,    63,     6,     6,    15,    67,
-      16,    62,     3,     6,    61,    62,    61,    61,    67,    17,
-      50,    18,    64,    45,    46,    45,    46,    64,    17,    50,
-      19,     3,     3,    50,    63,    52,    65,    66,    45,    45,
-      63,    22,    23,    46,    65
+       0,    29,    30,    50,     3,     4,     5,     6,    11,    26,
+      31,    39,    45,    51,    53,    54,    13,    45,    56,    57,
+       0,    45,    48,    45,    51,    54,    51,     7,     8,    10,
+      12,    31,    32,    33,    34,    35,    36,    37,    38,    39,
+      40,    41,    42,     6,    25,    40,    51,    60,    61,    57,
+      27,    58,    59,    51,    52,     6,    51,    46,    45,    51,
+      54,    11,    31,     7,     8,    10,    51,    51,    35,    36,
+      51,    34,    36,    51,    34,    51,    34,    54,    54,    54,
+      54,    54,    45,    48,    60,     6,    22,    62,    21,    47,
+      46,    28,    56,    47,    46,    22,    52,     9,    33,    11,
+      45,    51,    54,    51,    51,    51,    51,    51,    51,    25,
+      40,    40,    21,     6,     5,     6,    71,    60,    58,    52,
+       6,    55,    46,    51,    54,    52,     9,    33,     6,    53,
+      46,    71,    48,    48,    62,    14,    15,    64,    45,    46,
+      46,    51,    54,    46,    62,    64,     6,     6,    15,    71,
+      16,    63,     3,     6,    62,    63,    62,    62,    71,    17,
+      51,    19,    65,    46,    47,    46,    47,    18,    68,    17,
+      51,    20,    68,     3,     3,    20,    51,    64,    53,    66,
+      67,    46,    46,    53,    69,    70,    64,    47,    23,    24,
+      47,    66,    69
 };
 
   /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
 static const yytype_uint8 yyr1[] =
 {
-       0,    48,    49,    49,    49,    50,    50,    50,    50,    50,
-      50,    50,    50,    50,    50,    50,    50,    50,    50,    50,
-      50,    50,    50,    50,    50,    50,    50,    50,    51,    51,
-      52,    52,    53,    53,    53,    53,    53,    53,    53,    53,
-      53,    53,    53,    53,    53,    53,    54,    54,    54,    54,
-      54,    55,    55,    56,    56,    57,    57,    58,    59,    59,
-      60,    60,    60,    60,    60,    60,    60,    60,    61,    61,
-      62,    62,    63,    63,    63,    64,    64,    65,    65,    66,
-      66,    66,    67,    67,    67,    67,    67,    67
+       0,    49,    50,    50,    50,    51,    51,    51,    51,    51,
+      51,    51,    51,    51,    51,    51,    51,    51,    51,    51,
+      51,    51,    51,    51,    51,    51,    51,    51,    52,    52,
+      53,    53,    54,    54,    54,    54,    54,    54,    54,    54,
+      54,    54,    54,    54,    54,    54,    55,    55,    55,    55,
+      55,    56,    56,    57,    57,    58,    58,    59,    60,    60,
+      61,    61,    61,    61,    61,    61,    61,    61,    62,    62,
+      63,    63,    64,    64,    64,    65,    65,    66,    66,    67,
+      68,    68,    69,    69,    70,    70,    70,    71,    71,    71,
+      71,    71,    71
 };
 
   /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
@@ -746,10 +751,11 @@ static const yytype_uint8 yyr2[] =
        5,     6,     5,     6,     5,     6,     3,     4,     3,     1,
        1,     3,     1,     1,     1,     1,     3,     1,     2,     3,
        3,     3,     3,     3,     4,     6,     1,     4,     6,     4,
-       6,     2,     4,     7,     8,     0,     2,     2,     1,     3,
+       6,     2,     4,     8,     8,     0,     2,     2,     1,     3,
        1,     2,     1,     3,     4,     5,     5,     6,     2,     1,
        0,     2,     0,     5,     6,     0,     3,     3,     1,     1,
-       2,     2,     1,     2,     3,     4,     3,     4
+       0,     3,     3,     1,     1,     2,     2,     1,     2,     3,
+       4,     3,     4
 };
 
 
@@ -1175,65 +1181,65 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, swq_parse_context
   switch (yytype)
     {
           case 3: /* "integer number"  */
-#line 107 "swq_parser.y" /* yacc.c:1257  */
-      { delete ((*yyvaluep)); }
-#line 1181 "swq_parser.cpp" /* yacc.c:1257  */
-        break;
-
-    case 4: /* "floating point number"  */
-#line 107 "swq_parser.y" /* yacc.c:1257  */
+#line 108 "swq_parser.y" /* yacc.c:1257  */
       { delete ((*yyvaluep)); }
 #line 1187 "swq_parser.cpp" /* yacc.c:1257  */
         break;
 
-    case 5: /* "string"  */
-#line 107 "swq_parser.y" /* yacc.c:1257  */
+    case 4: /* "floating point number"  */
+#line 108 "swq_parser.y" /* yacc.c:1257  */
       { delete ((*yyvaluep)); }
 #line 1193 "swq_parser.cpp" /* yacc.c:1257  */
         break;
 
-    case 6: /* "identifier"  */
-#line 107 "swq_parser.y" /* yacc.c:1257  */
+    case 5: /* "string"  */
+#line 108 "swq_parser.y" /* yacc.c:1257  */
       { delete ((*yyvaluep)); }
 #line 1199 "swq_parser.cpp" /* yacc.c:1257  */
         break;
 
-    case 50: /* value_expr  */
+    case 6: /* "identifier"  */
 #line 108 "swq_parser.y" /* yacc.c:1257  */
       { delete ((*yyvaluep)); }
 #line 1205 "swq_parser.cpp" /* yacc.c:1257  */
         break;
 
-    case 51: /* value_expr_list  */
-#line 108 "swq_parser.y" /* yacc.c:1257  */
+    case 51: /* value_expr  */
+#line 109 "swq_parser.y" /* yacc.c:1257  */
       { delete ((*yyvaluep)); }
 #line 1211 "swq_parser.cpp" /* yacc.c:1257  */
         break;
 
-    case 52: /* field_value  */
-#line 108 "swq_parser.y" /* yacc.c:1257  */
+    case 52: /* value_expr_list  */
+#line 109 "swq_parser.y" /* yacc.c:1257  */
       { delete ((*yyvaluep)); }
 #line 1217 "swq_parser.cpp" /* yacc.c:1257  */
         break;
 
-    case 53: /* value_expr_non_logical  */
-#line 108 "swq_parser.y" /* yacc.c:1257  */
+    case 53: /* field_value  */
+#line 109 "swq_parser.y" /* yacc.c:1257  */
       { delete ((*yyvaluep)); }
 #line 1223 "swq_parser.cpp" /* yacc.c:1257  */
         break;
 
-    case 54: /* type_def  */
-#line 108 "swq_parser.y" /* yacc.c:1257  */
+    case 54: /* value_expr_non_logical  */
+#line 109 "swq_parser.y" /* yacc.c:1257  */
       { delete ((*yyvaluep)); }
 #line 1229 "swq_parser.cpp" /* yacc.c:1257  */
         break;
 
-    case 67: /* table_def  */
-#line 108 "swq_parser.y" /* yacc.c:1257  */
+    case 55: /* type_def  */
+#line 109 "swq_parser.y" /* yacc.c:1257  */
       { delete ((*yyvaluep)); }
 #line 1235 "swq_parser.cpp" /* yacc.c:1257  */
         break;
 
+    case 71: /* table_def  */
+#line 109 "swq_parser.y" /* yacc.c:1257  */
+      { delete ((*yyvaluep)); }
+#line 1241 "swq_parser.cpp" /* yacc.c:1257  */
+        break;
+
 
       default:
         break;
@@ -1497,173 +1503,173 @@ yyreduce:
   switch (yyn)
     {
         case 3:
-#line 114 "swq_parser.y" /* yacc.c:1646  */
+#line 115 "swq_parser.y" /* yacc.c:1646  */
     {
             context->poRoot = (yyvsp[0]);
         }
-#line 1505 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1511 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 4:
-#line 119 "swq_parser.y" /* yacc.c:1646  */
+#line 120 "swq_parser.y" /* yacc.c:1646  */
     {
             context->poRoot = (yyvsp[0]);
         }
-#line 1513 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1519 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 5:
-#line 125 "swq_parser.y" /* yacc.c:1646  */
+#line 126 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[0]);
         }
-#line 1521 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1527 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 6:
-#line 130 "swq_parser.y" /* yacc.c:1646  */
+#line 131 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_AND );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1532 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1538 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 7:
-#line 138 "swq_parser.y" /* yacc.c:1646  */
+#line 139 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_OR );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1543 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1549 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 8:
-#line 146 "swq_parser.y" /* yacc.c:1646  */
+#line 147 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_NOT );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1553 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1559 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 9:
-#line 153 "swq_parser.y" /* yacc.c:1646  */
+#line 154 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_EQ );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1564 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1570 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 10:
-#line 161 "swq_parser.y" /* yacc.c:1646  */
+#line 162 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_NE );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-3]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1575 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1581 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 11:
-#line 169 "swq_parser.y" /* yacc.c:1646  */
+#line 170 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_NE );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-3]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1586 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1592 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 12:
-#line 177 "swq_parser.y" /* yacc.c:1646  */
+#line 178 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_LT );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1597 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1603 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 13:
-#line 185 "swq_parser.y" /* yacc.c:1646  */
+#line 186 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_GT );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1608 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1614 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 14:
-#line 193 "swq_parser.y" /* yacc.c:1646  */
+#line 194 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_LE );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-3]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1619 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1625 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 15:
-#line 201 "swq_parser.y" /* yacc.c:1646  */
+#line 202 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_LE );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-3]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1630 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1636 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 16:
-#line 209 "swq_parser.y" /* yacc.c:1646  */
+#line 210 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_LE );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-3]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1641 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1647 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 17:
-#line 217 "swq_parser.y" /* yacc.c:1646  */
+#line 218 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_GE );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-3]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1652 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1658 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 18:
-#line 225 "swq_parser.y" /* yacc.c:1646  */
+#line 226 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_LIKE );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1663 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1669 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 19:
-#line 233 "swq_parser.y" /* yacc.c:1646  */
+#line 234 "swq_parser.y" /* yacc.c:1646  */
     {
             swq_expr_node *like;
             like = new swq_expr_node( SWQ_LIKE );
@@ -1675,11 +1681,11 @@ yyreduce:
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( like );
         }
-#line 1679 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1685 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 20:
-#line 246 "swq_parser.y" /* yacc.c:1646  */
+#line 247 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_LIKE );
             (yyval)->field_type = SWQ_BOOLEAN;
@@ -1687,11 +1693,11 @@ yyreduce:
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1691 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1697 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 21:
-#line 255 "swq_parser.y" /* yacc.c:1646  */
+#line 256 "swq_parser.y" /* yacc.c:1646  */
     {
             swq_expr_node *like;
             like = new swq_expr_node( SWQ_LIKE );
@@ -1704,11 +1710,11 @@ yyreduce:
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( like );
         }
-#line 1708 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1714 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 22:
-#line 269 "swq_parser.y" /* yacc.c:1646  */
+#line 270 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[-1]);
             (yyval)->field_type = SWQ_BOOLEAN;
@@ -1716,11 +1722,11 @@ yyreduce:
             (yyval)->PushSubExpression( (yyvsp[-4]) );
             (yyval)->ReverseSubExpressions();
         }
-#line 1720 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1726 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 23:
-#line 278 "swq_parser.y" /* yacc.c:1646  */
+#line 279 "swq_parser.y" /* yacc.c:1646  */
     {
             swq_expr_node *in;
 
@@ -1734,11 +1740,11 @@ yyreduce:
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( in );
         }
-#line 1738 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1744 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 24:
-#line 293 "swq_parser.y" /* yacc.c:1646  */
+#line 294 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_BETWEEN );
             (yyval)->field_type = SWQ_BOOLEAN;
@@ -1746,11 +1752,11 @@ yyreduce:
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1750 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1756 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 25:
-#line 302 "swq_parser.y" /* yacc.c:1646  */
+#line 303 "swq_parser.y" /* yacc.c:1646  */
     {
             swq_expr_node *between;
             between = new swq_expr_node( SWQ_BETWEEN );
@@ -1763,21 +1769,21 @@ yyreduce:
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( between );
         }
-#line 1767 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1773 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 26:
-#line 316 "swq_parser.y" /* yacc.c:1646  */
+#line 317 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_ISNULL );
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( (yyvsp[-2]) );
         }
-#line 1777 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1783 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 27:
-#line 323 "swq_parser.y" /* yacc.c:1646  */
+#line 324 "swq_parser.y" /* yacc.c:1646  */
     {
         swq_expr_node *isnull;
 
@@ -1789,39 +1795,39 @@ yyreduce:
             (yyval)->field_type = SWQ_BOOLEAN;
             (yyval)->PushSubExpression( isnull );
         }
-#line 1793 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1799 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 28:
-#line 337 "swq_parser.y" /* yacc.c:1646  */
+#line 338 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[0]);
             (yyvsp[0])->PushSubExpression( (yyvsp[-2]) );
         }
-#line 1802 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1808 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 29:
-#line 343 "swq_parser.y" /* yacc.c:1646  */
+#line 344 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_ARGUMENT_LIST ); /* temporary value */
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1811 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1817 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 30:
-#line 350 "swq_parser.y" /* yacc.c:1646  */
+#line 351 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[0]);  // validation deferred.
             (yyval)->eNodeType = SNT_COLUMN;
             (yyval)->field_index = (yyval)->table_index = -1;
         }
-#line 1821 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1827 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 31:
-#line 357 "swq_parser.y" /* yacc.c:1646  */
+#line 358 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[-2]);  // validation deferred.
             (yyval)->eNodeType = SNT_COLUMN;
@@ -1831,59 +1837,59 @@ yyreduce:
             delete (yyvsp[0]);
             (yyvsp[0]) = NULL;
         }
-#line 1835 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1841 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 32:
-#line 369 "swq_parser.y" /* yacc.c:1646  */
+#line 370 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[0]);
         }
-#line 1843 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1849 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 33:
-#line 374 "swq_parser.y" /* yacc.c:1646  */
+#line 375 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[0]);
         }
-#line 1851 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1857 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 34:
-#line 379 "swq_parser.y" /* yacc.c:1646  */
+#line 380 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[0]);
         }
-#line 1859 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1865 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 35:
-#line 383 "swq_parser.y" /* yacc.c:1646  */
+#line 384 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[0]);
         }
-#line 1867 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1873 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 36:
-#line 388 "swq_parser.y" /* yacc.c:1646  */
+#line 389 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[-1]);
         }
-#line 1875 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1881 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 37:
-#line 393 "swq_parser.y" /* yacc.c:1646  */
+#line 394 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node((const char*)NULL);
         }
-#line 1883 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1889 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 38:
-#line 398 "swq_parser.y" /* yacc.c:1646  */
+#line 399 "swq_parser.y" /* yacc.c:1646  */
     {
             if ((yyvsp[0])->eNodeType == SNT_CONSTANT)
             {
@@ -1898,61 +1904,61 @@ yyreduce:
                 (yyval)->PushSubExpression( (yyvsp[0]) );
             }
         }
-#line 1902 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1908 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 39:
-#line 414 "swq_parser.y" /* yacc.c:1646  */
+#line 415 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_ADD );
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1912 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1918 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 40:
-#line 421 "swq_parser.y" /* yacc.c:1646  */
+#line 422 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_SUBTRACT );
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1922 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1928 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 41:
-#line 428 "swq_parser.y" /* yacc.c:1646  */
+#line 429 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_MULTIPLY );
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1932 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1938 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 42:
-#line 435 "swq_parser.y" /* yacc.c:1646  */
+#line 436 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_DIVIDE );
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1942 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1948 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 43:
-#line 442 "swq_parser.y" /* yacc.c:1646  */
+#line 443 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = new swq_expr_node( SWQ_MODULUS );
             (yyval)->PushSubExpression( (yyvsp[-2]) );
             (yyval)->PushSubExpression( (yyvsp[0]) );
         }
-#line 1952 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1958 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 44:
-#line 449 "swq_parser.y" /* yacc.c:1646  */
+#line 450 "swq_parser.y" /* yacc.c:1646  */
     {
             const swq_operation *poOp = 
                     swq_op_registrar::GetOperator( (yyvsp[-3])->string_value );
@@ -1987,51 +1993,51 @@ yyreduce:
                 delete (yyvsp[-3]);
             }
         }
-#line 1991 "swq_parser.cpp" /* yacc.c:1646  */
+#line 1997 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 45:
-#line 485 "swq_parser.y" /* yacc.c:1646  */
+#line 486 "swq_parser.y" /* yacc.c:1646  */
     {
             (yyval) = (yyvsp[-1]);
             (yyval)->PushSubExpression( (yyvsp[-3]) );
             (yyval)->ReverseSubExpressions();
         }
-#line 2001 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2007 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 46:
-#line 493 "swq_parser.y" /* yacc.c:1646  */
+#line 494 "swq_parser.y" /* yacc.c:1646  */
     {
         (yyval) = new swq_expr_node( SWQ_CAST );
         (yyval)->PushSubExpression( (yyvsp[0]) );
     }
-#line 2010 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2016 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 47:
-#line 499 "swq_parser.y" /* yacc.c:1646  */
+#line 500 "swq_parser.y" /* yacc.c:1646  */
     {
         (yyval) = new swq_expr_node( SWQ_CAST );
         (yyval)->PushSubExpression( (yyvsp[-1]) );
         (yyval)->PushSubExpression( (yyvsp[-3]) );
     }
-#line 2020 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2026 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 48:
-#line 506 "swq_parser.y" /* yacc.c:1646  */
+#line 507 "swq_parser.y" /* yacc.c:1646  */
     {
         (yyval) = new swq_expr_node( SWQ_CAST );
         (yyval)->PushSubExpression( (yyvsp[-1]) );
         (yyval)->PushSubExpression( (yyvsp[-3]) );
         (yyval)->PushSubExpression( (yyvsp[-5]) );
     }
-#line 2031 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2037 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 49:
-#line 515 "swq_parser.y" /* yacc.c:1646  */
+#line 516 "swq_parser.y" /* yacc.c:1646  */
     {
         OGRwkbGeometryType eType = OGRFromOGCGeomType((yyvsp[-1])->string_value);
         if( !EQUAL((yyvsp[-3])->string_value,"GEOMETRY") || 
@@ -2047,11 +2053,11 @@ yyreduce:
         (yyval)->PushSubExpression( (yyvsp[-1]) );
         (yyval)->PushSubExpression( (yyvsp[-3]) );
     }
-#line 2051 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2057 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 50:
-#line 533 "swq_parser.y" /* yacc.c:1646  */
+#line 534 "swq_parser.y" /* yacc.c:1646  */
     {
         OGRwkbGeometryType eType = OGRFromOGCGeomType((yyvsp[-3])->string_value);
         if( !EQUAL((yyvsp[-5])->string_value,"GEOMETRY") || 
@@ -2069,38 +2075,38 @@ yyreduce:
         (yyval)->PushSubExpression( (yyvsp[-3]) );
         (yyval)->PushSubExpression( (yyvsp[-5]) );
     }
-#line 2073 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2079 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 53:
-#line 557 "swq_parser.y" /* yacc.c:1646  */
+#line 558 "swq_parser.y" /* yacc.c:1646  */
     {
-        delete (yyvsp[-3]);
+        delete (yyvsp[-4]);
     }
-#line 2081 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2087 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 54:
-#line 562 "swq_parser.y" /* yacc.c:1646  */
+#line 563 "swq_parser.y" /* yacc.c:1646  */
     {
         context->poCurSelect->query_mode = SWQM_DISTINCT_LIST;
         delete (yyvsp[-3]);
     }
-#line 2090 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2096 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 57:
-#line 571 "swq_parser.y" /* yacc.c:1646  */
+#line 572 "swq_parser.y" /* yacc.c:1646  */
     {
         swq_select* poNewSelect = new swq_select();
         context->poCurSelect->PushUnionAll(poNewSelect);
         context->poCurSelect = poNewSelect;
     }
-#line 2100 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2106 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 60:
-#line 583 "swq_parser.y" /* yacc.c:1646  */
+#line 584 "swq_parser.y" /* yacc.c:1646  */
     {
             if( !context->poCurSelect->PushField( (yyvsp[0]) ) )
             {
@@ -2108,11 +2114,11 @@ yyreduce:
                 YYERROR;
             }
         }
-#line 2112 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2118 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 61:
-#line 592 "swq_parser.y" /* yacc.c:1646  */
+#line 593 "swq_parser.y" /* yacc.c:1646  */
     {
             if( !context->poCurSelect->PushField( (yyvsp[-1]), (yyvsp[0])->string_value ) )
             {
@@ -2122,11 +2128,11 @@ yyreduce:
             }
             delete (yyvsp[0]);
         }
-#line 2126 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2132 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 62:
-#line 603 "swq_parser.y" /* yacc.c:1646  */
+#line 604 "swq_parser.y" /* yacc.c:1646  */
     {
             swq_expr_node *poNode = new swq_expr_node();
             poNode->eNodeType = SNT_COLUMN;
@@ -2139,11 +2145,11 @@ yyreduce:
                 YYERROR;
             }
         }
-#line 2143 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2149 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 63:
-#line 617 "swq_parser.y" /* yacc.c:1646  */
+#line 618 "swq_parser.y" /* yacc.c:1646  */
     {
             CPLString osTableName;
 
@@ -2164,11 +2170,11 @@ yyreduce:
                 YYERROR;
             }
         }
-#line 2168 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2174 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 64:
-#line 639 "swq_parser.y" /* yacc.c:1646  */
+#line 640 "swq_parser.y" /* yacc.c:1646  */
     {
                 // special case for COUNT(*), confirm it.
             if( !EQUAL((yyvsp[-3])->string_value,"COUNT") )
@@ -2197,11 +2203,11 @@ yyreduce:
                 YYERROR;
             }
         }
-#line 2201 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2207 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 65:
-#line 669 "swq_parser.y" /* yacc.c:1646  */
+#line 670 "swq_parser.y" /* yacc.c:1646  */
     {
                 // special case for COUNT(*), confirm it.
             if( !EQUAL((yyvsp[-4])->string_value,"COUNT") )
@@ -2234,11 +2240,11 @@ yyreduce:
 
             delete (yyvsp[0]);
         }
-#line 2238 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2244 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 66:
-#line 703 "swq_parser.y" /* yacc.c:1646  */
+#line 704 "swq_parser.y" /* yacc.c:1646  */
     {
                 // special case for COUNT(DISTINCT x), confirm it.
             if( !EQUAL((yyvsp[-4])->string_value,"COUNT") )
@@ -2261,11 +2267,11 @@ yyreduce:
                 YYERROR;
             }
         }
-#line 2265 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2271 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 67:
-#line 727 "swq_parser.y" /* yacc.c:1646  */
+#line 728 "swq_parser.y" /* yacc.c:1646  */
     {
             // special case for COUNT(DISTINCT x), confirm it.
             if( !EQUAL((yyvsp[-5])->string_value,"COUNT") )
@@ -2292,78 +2298,88 @@ yyreduce:
             delete (yyvsp[-5]);
             delete (yyvsp[0]);
         }
-#line 2296 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2302 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 68:
-#line 756 "swq_parser.y" /* yacc.c:1646  */
+#line 757 "swq_parser.y" /* yacc.c:1646  */
     {
             delete (yyvsp[-1]);
             (yyval) = (yyvsp[0]);
         }
-#line 2305 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2311 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 71:
-#line 766 "swq_parser.y" /* yacc.c:1646  */
+#line 767 "swq_parser.y" /* yacc.c:1646  */
     {
             context->poCurSelect->where_expr = (yyvsp[0]);
         }
-#line 2313 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2319 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 73:
-#line 772 "swq_parser.y" /* yacc.c:1646  */
+#line 773 "swq_parser.y" /* yacc.c:1646  */
     {
             context->poCurSelect->PushJoin( (yyvsp[-3])->int_value,
                                             (yyvsp[-1]) );
             delete (yyvsp[-3]);
         }
-#line 2323 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2329 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 74:
-#line 778 "swq_parser.y" /* yacc.c:1646  */
+#line 779 "swq_parser.y" /* yacc.c:1646  */
     {
             context->poCurSelect->PushJoin( (yyvsp[-3])->int_value,
                                             (yyvsp[-1]) );
             delete (yyvsp[-3]);
 	    }
-#line 2333 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2339 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
   case 79:
-#line 793 "swq_parser.y" /* yacc.c:1646  */
+#line 794 "swq_parser.y" /* yacc.c:1646  */
+    {
+            context->poCurSelect->PushGroupBy( (yyvsp[0])->table_name, (yyvsp[0])->string_value );
+            delete (yyvsp[0]);
+            (yyvsp[0]) = NULL;
+        }
+#line 2349 "swq_parser.cpp" /* yacc.c:1646  */
+    break;
+
+  case 84:
+#line 809 "swq_parser.y" /* yacc.c:1646  */
     {
             context->poCurSelect->PushOrderBy( (yyvsp[0])->table_name, (yyvsp[0])->string_value, TRUE );
             delete (yyvsp[0]);
             (yyvsp[0]) = NULL;
         }
-#line 2343 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2359 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
-  case 80:
-#line 799 "swq_parser.y" /* yacc.c:1646  */
+  case 85:
+#line 815 "swq_parser.y" /* yacc.c:1646  */
     {
             context->poCurSelect->PushOrderBy( (yyvsp[-1])->table_name, (yyvsp[-1])->string_value, TRUE );
             delete (yyvsp[-1]);
             (yyvsp[-1]) = NULL;
         }
-#line 2353 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2369 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
-  case 81:
-#line 805 "swq_parser.y" /* yacc.c:1646  */
+  case 86:
+#line 821 "swq_parser.y" /* yacc.c:1646  */
     {
             context->poCurSelect->PushOrderBy( (yyvsp[-1])->table_name, (yyvsp[-1])->string_value, FALSE );
             delete (yyvsp[-1]);
             (yyvsp[-1]) = NULL;
         }
-#line 2363 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2379 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
-  case 82:
-#line 813 "swq_parser.y" /* yacc.c:1646  */
+  case 87:
+#line 829 "swq_parser.y" /* yacc.c:1646  */
     {
         int iTable;
         iTable =context->poCurSelect->PushTableDef( NULL, (yyvsp[0])->string_value,
@@ -2372,11 +2388,11 @@ yyreduce:
 
         (yyval) = new swq_expr_node( iTable );
     }
-#line 2376 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2392 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
-  case 83:
-#line 823 "swq_parser.y" /* yacc.c:1646  */
+  case 88:
+#line 839 "swq_parser.y" /* yacc.c:1646  */
     {
         int iTable;
         iTable = context->poCurSelect->PushTableDef( NULL, (yyvsp[-1])->string_value,
@@ -2386,11 +2402,11 @@ yyreduce:
 
         (yyval) = new swq_expr_node( iTable );
     }
-#line 2390 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2406 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
-  case 84:
-#line 834 "swq_parser.y" /* yacc.c:1646  */
+  case 89:
+#line 850 "swq_parser.y" /* yacc.c:1646  */
     {
         int iTable;
         iTable = context->poCurSelect->PushTableDef( (yyvsp[-2])->string_value,
@@ -2400,11 +2416,11 @@ yyreduce:
 
         (yyval) = new swq_expr_node( iTable );
     }
-#line 2404 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2420 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
-  case 85:
-#line 845 "swq_parser.y" /* yacc.c:1646  */
+  case 90:
+#line 861 "swq_parser.y" /* yacc.c:1646  */
     {
         int iTable;
         iTable = context->poCurSelect->PushTableDef( (yyvsp[-3])->string_value,
@@ -2416,11 +2432,11 @@ yyreduce:
 
         (yyval) = new swq_expr_node( iTable );
     }
-#line 2420 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2436 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
-  case 86:
-#line 858 "swq_parser.y" /* yacc.c:1646  */
+  case 91:
+#line 874 "swq_parser.y" /* yacc.c:1646  */
     {
         int iTable;
         iTable = context->poCurSelect->PushTableDef( (yyvsp[-2])->string_value,
@@ -2430,11 +2446,11 @@ yyreduce:
 
         (yyval) = new swq_expr_node( iTable );
     }
-#line 2434 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2450 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
-  case 87:
-#line 869 "swq_parser.y" /* yacc.c:1646  */
+  case 92:
+#line 885 "swq_parser.y" /* yacc.c:1646  */
     {
         int iTable;
         iTable = context->poCurSelect->PushTableDef( (yyvsp[-3])->string_value,
@@ -2446,11 +2462,11 @@ yyreduce:
 
         (yyval) = new swq_expr_node( iTable );
     }
-#line 2450 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2466 "swq_parser.cpp" /* yacc.c:1646  */
     break;
 
 
-#line 2454 "swq_parser.cpp" /* yacc.c:1646  */
+#line 2470 "swq_parser.cpp" /* yacc.c:1646  */
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -62,22 +62,23 @@ extern int swqdebug;
     SWQT_WHERE = 271,
     SWQT_ON = 272,
     SWQT_ORDER = 273,
-    SWQT_BY = 274,
-    SWQT_FROM = 275,
-    SWQT_AS = 276,
-    SWQT_ASC = 277,
-    SWQT_DESC = 278,
-    SWQT_DISTINCT = 279,
-    SWQT_CAST = 280,
-    SWQT_UNION = 281,
-    SWQT_ALL = 282,
-    SWQT_VALUE_START = 283,
-    SWQT_SELECT_START = 284,
-    SWQT_NOT = 285,
-    SWQT_OR = 286,
-    SWQT_AND = 287,
-    SWQT_UMINUS = 288,
-    SWQT_RESERVED_KEYWORD = 289
+    SWQT_GROUP = 274,
+    SWQT_BY = 275,
+    SWQT_FROM = 276,
+    SWQT_AS = 277,
+    SWQT_ASC = 278,
+    SWQT_DESC = 279,
+    SWQT_DISTINCT = 280,
+    SWQT_CAST = 281,
+    SWQT_UNION = 282,
+    SWQT_ALL = 283,
+    SWQT_VALUE_START = 284,
+    SWQT_SELECT_START = 285,
+    SWQT_NOT = 286,
+    SWQT_OR = 287,
+    SWQT_AND = 288,
+    SWQT_UMINUS = 289,
+    SWQT_RESERVED_KEYWORD = 290
   };
 #endif
 
@@ -70,6 +70,7 @@
 %token SWQT_WHERE               "WHERE"
 %token SWQT_ON                  "ON"
 %token SWQT_ORDER               "ORDER"
+%token SWQT_GROUP               "GROUP"
 %token SWQT_BY                  "BY"
 %token SWQT_FROM                "FROM"
 %token SWQT_AS                  "AS"
@@ -553,7 +554,7 @@ select_statement:
     | '(' select_core ')' opt_union_all
 
 select_core:
-    SWQT_SELECT select_field_list SWQT_FROM table_def opt_joins opt_where opt_order_by
+    SWQT_SELECT select_field_list SWQT_FROM table_def opt_joins opt_where opt_group_by opt_order_by
     {
         delete $4;
     }
@@ -781,6 +782,21 @@ opt_joins:
             delete $3;
 	    }
 
+opt_group_by:
+    | SWQT_GROUP SWQT_BY group_spec_list
+
+group_spec_list:
+    group_spec ',' group_spec_list
+    | group_spec
+
+group_spec:
+    field_value
+        {
+            context->poCurSelect->PushGroupBy( $1->table_name, $1->string_value );
+            delete $1;
+            $1 = NULL;
+        }
+
 opt_order_by:
     | SWQT_ORDER SWQT_BY sort_spec_list
 
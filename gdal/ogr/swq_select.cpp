@@ -56,6 +56,9 @@ swq_select::swq_select()
     order_specs = 0;
     order_defs = NULL;
 
+    group_by_specs = 0;
+    group_by_defs = NULL;
+
     poOtherSelect = NULL;
 }
 
@@ -100,6 +103,9 @@ swq_select::~swq_select()
 
             CPLFree( column_summary[i].distinct_list );
         }
+        if( column_summary != NULL
+            && column_summary[i].distinct_set != NULL )
+            CPLHashSetDestroy( column_summary[i].distinct_set );
     }
 
     CPLFree( column_defs );
@@ -114,6 +120,14 @@ swq_select::~swq_select()
     
     CPLFree( order_defs );
 
+    for( i = 0; i < group_by_specs; i++ )
+    {
+        CPLFree( group_by_defs[i].table_name );
+        CPLFree( group_by_defs[i].field_name );
+    }
+
+    CPLFree( group_by_defs );
+
     for( i = 0; i < join_count; i++ )
     {
         delete join_defs[i].poExpr;
@@ -208,6 +222,8 @@ void swq_select::Dump( FILE *fp )
         fprintf( fp, "  QUERY MODE: RECORDSET\n" );
     else if( query_mode == SWQM_DISTINCT_LIST )
         fprintf( fp, "  QUERY MODE: DISTINCT LIST\n" );
+    else if( query_mode == SWQM_GROUP_BY )
+        fprintf( fp, "  QUERY MODE: GROUP BY\n" );
     else
         fprintf( fp, "  QUERY MODE: %d/unknown\n", query_mode );
 
@@ -296,6 +312,18 @@ void swq_select::Dump( FILE *fp )
         where_expr->Dump( fp, 2 );
     }
 
+/* -------------------------------------------------------------------- */
+/*      Group by                                                        */
+/* -------------------------------------------------------------------- */
+
+    for( i = 0; i < group_by_specs; i++ )
+    {
+        fprintf( fp, "  GROUP BY: %s (%d/%d)\n",
+                 group_by_defs[i].field_name,
+                 group_by_defs[i].table_index,
+                 group_by_defs[i].field_index );
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Order by                                                        */
 /* -------------------------------------------------------------------- */
@@ -419,6 +447,12 @@ char* swq_select::Unparse()
         CPLFree(pszTmp);
     }
 
+    for( i = 0; i < group_by_specs; i++ )
+    {
+        osSelect += ( i == 0 ) ? " GROUP BY " : ", ";
+        osSelect += swq_expr_node::QuoteIfNecessary(group_by_defs[i].field_name, '"');
+    }
+
     for( i = 0; i < order_specs; i++ )
     {
         osSelect += " ORDER BY ";
@@ -755,6 +789,23 @@ void swq_select::PushOrderBy( const char* pszTableName, const char *pszFieldName
     order_defs[order_specs-1].ascending_flag = bAscending;
 }
 
+/************************************************************************/
+/*                            PushGroupBy()                             */
+/************************************************************************/
+
+void swq_select::PushGroupBy( const char* pszTableName, const char *pszFieldName )
+
+{
+    group_by_specs++;
+    group_by_defs = (swq_group_by_def *) 
+        CPLRealloc( group_by_defs, sizeof(swq_group_by_def) * group_by_specs );
+
+    group_by_defs[group_by_specs-1].table_name = CPLStrdup(pszTableName ? pszTableName : "");
+    group_by_defs[group_by_specs-1].field_name = CPLStrdup(pszFieldName);
+    group_by_defs[group_by_specs-1].table_index = -1;
+    group_by_defs[group_by_specs-1].field_index = -1;
+}
+
 /************************************************************************/
 /*                              PushJoin()                              */
 /************************************************************************/
@@ -1091,6 +1142,95 @@ CPLErr swq_select::parse( swq_field_list *field_list,
         }
     }
 
+/* -------------------------------------------------------------------- */
+/*      Process column names in GROUP BY specs, and check that the      */
+/*      result columns are either grouping fields or aggregates.        */
+/* -------------------------------------------------------------------- */
+    for( i = 0; i < group_by_specs; i++ )
+    {
+        swq_group_by_def *def = group_by_defs + i;
+
+        /* identify field */
+        swq_field_type field_type;
+        def->field_index = swq_identify_field( def->table_name,
+                                               def->field_name, field_list,
+                                               &field_type, &(def->table_index) );
+        if( def->field_index == -1 )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined, 
+                      "Unrecognised field name %s in GROUP BY.", 
+                      def->table_name[0] ? CPLSPrintf("%s.%s", def->table_name, def->field_name) : def->field_name );
+            return CE_Failure;
+        }
+
+        if( def->table_index != 0 )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Cannot use field '%s' of a secondary table in a GROUP BY clause",
+                      def->field_name );
+            return CE_Failure;
+        }
+
+        if( field_type == SWQ_GEOMETRY )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Cannot use geometry field '%s' in a GROUP BY clause",
+                      def->field_name );
+            return CE_Failure;
+        }
+    }
+
+    if( group_by_specs > 0 )
+    {
+        for( i = 0; i < result_columns; i++ )
+        {
+            swq_col_def *def = column_defs + i;
+
+            if( def->col_func == SWQCF_NONE )
+            {
+                int iGroup = group_by_specs;
+
+                if( def->expr == NULL || def->expr->eNodeType == SNT_COLUMN )
+                {
+                    for( iGroup = 0; iGroup < group_by_specs; iGroup++ )
+                    {
+                        if( group_by_defs[iGroup].table_index == def->table_index &&
+                            group_by_defs[iGroup].field_index == def->field_index )
+                            break;
+                    }
+                }
+                if( iGroup == group_by_specs )
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                              "Column '%s' must appear in the GROUP BY clause or be used in an aggregate function.",
+                              def->field_alias ? def->field_alias : def->field_name );
+                    return CE_Failure;
+                }
+            }
+            else if( def->col_func == SWQCF_CUSTOM )
+            {
+                CPLError( CE_Failure, CPLE_NotSupported,
+                          "Custom column functions not supported with GROUP BY." );
+                return CE_Failure;
+            }
+            else if( def->distinct_flag )
+            {
+                CPLError( CE_Failure, CPLE_NotSupported,
+                          "COUNT(DISTINCT ...) not supported with GROUP BY." );
+                return CE_Failure;
+            }
+            else if( def->table_index > 0 )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "Cannot aggregate field '%s' of a secondary table with GROUP BY.",
+                          def->field_name );
+                return CE_Failure;
+            }
+        }
+
+        query_mode = SWQM_GROUP_BY;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Check if we are producing a one row summary result or a set     */
 /*      of records.  Generate an error if we get conflicting            */
@@ -1107,7 +1247,7 @@ CPLErr swq_select::parse( swq_field_list *field_list,
             return CE_Failure;
     }
 
-    for( i = 0; i < result_columns; i++ )
+    for( i = 0; query_mode != SWQM_GROUP_BY && i < result_columns; i++ )
     {
         swq_col_def *def = column_defs + i;
         int this_indicator = -1;
@@ -1216,6 +1356,23 @@ CPLErr swq_select::parse( swq_field_list *field_list,
                       def->field_name );
             return CE_Failure;
         }
+
+        if( query_mode == SWQM_GROUP_BY )
+        {
+            int iGroup;
+            for( iGroup = 0; iGroup < group_by_specs; iGroup++ )
+            {
+                if( group_by_defs[iGroup].field_index == def->field_index )
+                    break;
+            }
+            if( iGroup == group_by_specs )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "Field '%s' in ORDER BY must appear in the GROUP BY clause",
+                          def->field_name );
+                return CE_Failure;
+            }
+        }
     }
 
 /* -------------------------------------------------------------------- */
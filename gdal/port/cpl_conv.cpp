@@ -2057,6 +2057,52 @@ void CPL_DLL CPLStringToComplex( const char *pszString,
     return;
 }
 
+/************************************************************************/
+/*                           CPLHilbertCode()                           */
+/************************************************************************/
+
+/**
+ * Position of a cell along a Hilbert curve.
+ *
+ * The curve covers a 65536 x 65536 grid. Sorting items by the code of
+ * their center keeps spatially close items together, which is what the
+ * packed R-Trees of the Shapefile and GeoPackage drivers are built on.
+ *
+ * @param nX column of the cell, between 0 and 65535.
+ * @param nY row of the cell, between 0 and 65535.
+ *
+ * @return the position of the cell along the curve, between 0 and
+ * 2^32 - 1.
+ */
+
+GUInt32 CPLHilbertCode( GUInt32 nX, GUInt32 nY )
+
+{
+    const GUInt32 nN = 65536;
+    GUInt32 nCode = 0;
+
+    for( GUInt32 nS = nN / 2; nS > 0; nS /= 2 )
+    {
+        GUInt32 nRX = (nX & nS) > 0;
+        GUInt32 nRY = (nY & nS) > 0;
+        nCode += nS * nS * ((3 * nRX) ^ nRY);
+
+        /* Rotate the quadrant */
+        if( nRY == 0 )
+        {
+            if( nRX == 1 )
+            {
+                nX = nN - 1 - nX;
+                nY = nN - 1 - nY;
+            }
+            GUInt32 nTmp = nX;
+            nX = nY;
+            nY = nTmp;
+        }
+    }
+    return nCode;
+}
+
 /************************************************************************/
 /*                           CPLOpenShared()                            */
 /************************************************************************/
@@ -214,6 +214,7 @@ int CPL_DLL CPLUnlinkTree( const char * );
 int CPL_DLL CPLCopyFile( const char *pszNewPath, const char *pszOldPath );
 int CPL_DLL CPLCopyTree( const char *pszNewPath, const char *pszOldPath );
 int CPL_DLL CPLMoveFile( const char *pszNewPath, const char *pszOldPath );
+GUInt32 CPL_DLL CPLHilbertCode( GUInt32 nX, GUInt32 nY );
 
 /* -------------------------------------------------------------------- */
 /*      ZIP Creation.                                                   */
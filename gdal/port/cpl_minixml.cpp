@@ -66,6 +66,19 @@ typedef struct
     CPLXMLNode *psLastChild;
 } StackContext;
 
+/* Blocks of a tree allocated with CPLParseXMLStringInArena(). The root */
+/* node is always the first allocation of the first block, which allows */
+/* CPLDestroyXMLArenaTree() to find the block list back from it. */
+typedef struct _CPLXMLArenaBlock
+{
+    struct _CPLXMLArenaBlock *psNext;
+    size_t      nSize;
+    size_t      nUsed;
+} CPLXMLArenaBlock;
+
+#define ARENA_ALIGN(n)      (((n) + 7) & ~((size_t)7))
+#define ARENA_HEADER_SIZE   ARENA_ALIGN(sizeof(CPLXMLArenaBlock))
+
 typedef struct {
     const char *pszInput;
     int        nInputOffset;
@@ -82,10 +95,15 @@ typedef struct {
 
     CPLXMLNode *psFirstNode;
     CPLXMLNode *psLastNode;
+
+    int        bUseArena;
+    CPLXMLArenaBlock *psArenaFirst;
+    CPLXMLArenaBlock *psArenaCur;
 } ParseContext;
 
 static CPLXMLNode *_CPLCreateXMLNode( CPLXMLNode *poParent, CPLXMLNodeType eType, 
                                       const char *pszText );
+static CPLXMLNode *ParseXMLString( const char *pszString, int bUseArena );
 
 /************************************************************************/
 /*                              ReadChar()                              */
@@ -557,6 +575,118 @@ static void AttachNode( ParseContext *psContext, CPLXMLNode *psNode )
     }
 }
 
+/************************************************************************/
+/*                             ArenaAlloc()                             */
+/************************************************************************/
+
+static void *ArenaAlloc( ParseContext *psContext, size_t nSize )
+
+{
+    CPLXMLArenaBlock *psBlock = psContext->psArenaCur;
+
+    nSize = ARENA_ALIGN(nSize);
+    if( psBlock == NULL || psBlock->nSize - psBlock->nUsed < nSize )
+    {
+        size_t nBlockSize;
+
+        /* The first block is sized after the document, so that most */
+        /* documents fit in it. Following ones are twice bigger each time */
+        if( psBlock == NULL )
+            nBlockSize = strlen(psContext->pszInput) * 3 / 2 + 4096;
+        else
+            nBlockSize = psBlock->nSize * 2;
+        if( nBlockSize < ARENA_HEADER_SIZE + nSize )
+            nBlockSize = ARENA_HEADER_SIZE + nSize;
+
+        CPLXMLArenaBlock *psNewBlock =
+            (CPLXMLArenaBlock *) VSIMalloc( nBlockSize );
+        if( psNewBlock == NULL )
+        {
+            CPLError( CE_Failure, CPLE_OutOfMemory,
+                      "Cannot allocate %lu bytes for XML tree",
+                      (unsigned long) nBlockSize );
+            return NULL;
+        }
+        psNewBlock->psNext = NULL;
+        psNewBlock->nSize = nBlockSize;
+        psNewBlock->nUsed = ARENA_HEADER_SIZE;
+
+        if( psBlock == NULL )
+            psContext->psArenaFirst = psNewBlock;
+        else
+            psBlock->psNext = psNewBlock;
+        psContext->psArenaCur = psBlock = psNewBlock;
+    }
+
+    void *pRet = ((GByte *) psBlock) + psBlock->nUsed;
+    psBlock->nUsed += nSize;
+    return pRet;
+}
+
+/************************************************************************/
+/*                             FreeArena()                              */
+/************************************************************************/
+
+static void FreeArena( CPLXMLArenaBlock *psBlock )
+
+{
+    while( psBlock != NULL )
+    {
+        CPLXMLArenaBlock *psNext = psBlock->psNext;
+        VSIFree( psBlock );
+        psBlock = psNext;
+    }
+}
+
+/************************************************************************/
+/*                          ParseCreateNode()                           */
+/*                                                                      */
+/*      Create a node, either on the heap or in the arena of the        */
+/*      context.                                                        */
+/************************************************************************/
+
+static CPLXMLNode *ParseCreateNode( ParseContext *psContext,
+                                    CPLXMLNode *poParent,
+                                    CPLXMLNodeType eType,
+                                    const char *pszText )
+
+{
+    if( !psContext->bUseArena )
+        return _CPLCreateXMLNode( poParent, eType, pszText );
+
+    size_t nLen = strlen(pszText);
+    CPLXMLNode *psNode = (CPLXMLNode *) ArenaAlloc( psContext,
+                                                    sizeof(CPLXMLNode) );
+    if( psNode == NULL )
+        return NULL;
+    char *pszValue = (char *) ArenaAlloc( psContext, nLen + 1 );
+    if( pszValue == NULL )
+        return NULL;
+    memcpy( pszValue, pszText, nLen + 1 );
+
+    psNode->eType = eType;
+    psNode->pszValue = pszValue;
+    psNode->psNext = NULL;
+    psNode->psChild = NULL;
+
+    if( poParent != NULL )
+    {
+        if( poParent->psChild == NULL )
+            poParent->psChild = psNode;
+        else
+        {
+            CPLXMLNode  *psLink = poParent->psChild;
+
+            while( psLink->psNext != NULL )
+                psLink = psLink->psNext;
+
+            psLink->psNext = psNode;
+        }
+    }
+
+    return psNode;
+}
+
 /************************************************************************/
 /*                         CPLParseXMLString()                          */
 /************************************************************************/
@@ -586,6 +716,68 @@ static void AttachNode( ParseContext *psContext, CPLXMLNode *psNode )
 
 CPLXMLNode *CPLParseXMLString( const char *pszString )
 
+{
+    return ParseXMLString( pszString, FALSE );
+}
+
+/************************************************************************/
+/*                      CPLParseXMLStringInArena()                      */
+/************************************************************************/
+
+/**
+ * \brief Parse an XML string into a read-only tree.
+ *
+ * This function works like CPLParseXMLString(), except that all the nodes
+ * and strings of the returned tree are allocated in a few big memory
+ * blocks rather than with one allocation each, which is much faster for
+ * big documents.
+ *
+ * The returned tree must not be modified in any way that would allocate or
+ * free nodes or values (CPLSetXMLValue(), CPLAddXMLChild(), 
+ * CPLDestroyXMLNode(), ...). Use CPLCloneXMLTree() to get a regular copy of
+ * a part of it that must be kept or modified. It must be freed with 
+ * CPLDestroyXMLArenaTree().
+ *
+ * @param pszString the document to parse. 
+ *
+ * @return parsed tree or NULL on error. 
+ *
+ * @since GDAL 2.0
+ */
+
+CPLXMLNode *CPLParseXMLStringInArena( const char *pszString )
+
+{
+    return ParseXMLString( pszString, TRUE );
+}
+
+/************************************************************************/
+/*                       CPLDestroyXMLArenaTree()                       */
+/************************************************************************/
+
+/**
+ * \brief Destroy a tree returned by CPLParseXMLStringInArena().
+ *
+ * @param psTree the root of the tree to free (may be NULL).
+ *
+ * @since GDAL 2.0
+ */
+
+void CPLDestroyXMLArenaTree( CPLXMLNode *psTree )
+
+{
+    if( psTree == NULL )
+        return;
+
+    FreeArena( (CPLXMLArenaBlock *) (((GByte *) psTree) - ARENA_HEADER_SIZE) );
+}
+
+/************************************************************************/
+/*                           ParseXMLString()                           */
+/************************************************************************/
+
+static CPLXMLNode *ParseXMLString( const char *pszString, int bUseArena )
+
 {
     ParseContext sContext;
 
@@ -616,6 +808,9 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
     sContext.papsStack = NULL;
     sContext.psFirstNode = NULL;
     sContext.psLastNode = NULL;
+    sContext.bUseArena = bUseArena;
+    sContext.psArenaFirst = NULL;
+    sContext.psArenaCur = NULL;
 
 /* ==================================================================== */
 /*      Loop reading tokens.                                            */
@@ -639,7 +834,7 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
 
             if( sContext.pszToken[0] != '/' )
             {
-                psElement = _CPLCreateXMLNode( NULL, CXT_Element,
+                psElement = ParseCreateNode( &sContext, NULL, CXT_Element,
                                               sContext.pszToken );
                 if (!psElement) break;
                 AttachNode( &sContext, psElement );
@@ -696,7 +891,7 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
         {
             CPLXMLNode *psAttr;
 
-            psAttr = _CPLCreateXMLNode(NULL, CXT_Attribute, sContext.pszToken);
+            psAttr = ParseCreateNode( &sContext, NULL, CXT_Attribute, sContext.pszToken);
             if (!psAttr) break;
             AttachNode( &sContext, psAttr );
             
@@ -726,7 +921,7 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
                 break;
             }
 
-            if (!_CPLCreateXMLNode( psAttr, CXT_Text, sContext.pszToken )) break;
+            if (!ParseCreateNode( &sContext, psAttr, CXT_Text, sContext.pszToken )) break;
         }
 
 /* -------------------------------------------------------------------- */
@@ -793,7 +988,7 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
         {
             CPLXMLNode *psValue;
 
-            psValue = _CPLCreateXMLNode(NULL, CXT_Comment, sContext.pszToken);
+            psValue = ParseCreateNode( &sContext, NULL, CXT_Comment, sContext.pszToken);
             if (!psValue) break;
             AttachNode( &sContext, psValue );
         }
@@ -805,7 +1000,7 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
         {
             CPLXMLNode *psValue;
 
-            psValue = _CPLCreateXMLNode(NULL, CXT_Literal, sContext.pszToken);
+            psValue = ParseCreateNode( &sContext, NULL, CXT_Literal, sContext.pszToken);
             if (!psValue) break;
             AttachNode( &sContext, psValue );
         }
@@ -817,7 +1012,7 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
         {
             CPLXMLNode *psValue;
 
-            psValue = _CPLCreateXMLNode(NULL, CXT_Text, sContext.pszToken);
+            psValue = ParseCreateNode( &sContext, NULL, CXT_Text, sContext.pszToken);
             if (!psValue) break;
             AttachNode( &sContext, psValue );
         }
@@ -853,14 +1048,311 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
 
     if( CPLGetLastErrorType() == CE_Failure )
     {
-        CPLDestroyXMLNode( sContext.psFirstNode );
+        if( bUseArena )
+            FreeArena( sContext.psArenaFirst );
+        else
+            CPLDestroyXMLNode( sContext.psFirstNode );
         sContext.psFirstNode = NULL;
         sContext.psLastNode = NULL;
     }
+    else if( bUseArena && sContext.psFirstNode == NULL )
+        FreeArena( sContext.psArenaFirst );
 
     return sContext.psFirstNode;
 }
 
+/************************************************************************/
+/*                            StringStack                               */
+/*                                                                      */
+/*      A stack of strings stored in a single buffer, used by the       */
+/*      SAX parser for the names of the opened elements and the         */
+/*      attributes of the current one.                                  */
+/************************************************************************/
+
+typedef struct
+{
+    char        *pszBuffer;
+    size_t      nBufferSize;
+    size_t      nBufferMaxSize;
+    size_t      *panOffsets;
+    int         nCount;
+    int         nMaxCount;
+    const char  **papszPointers;
+} StringStack;
+
+static void StringStackPush( StringStack *psStack, const char *pszStr )
+
+{
+    size_t nLen = strlen(pszStr) + 1;
+
+    if( psStack->nBufferSize + nLen > psStack->nBufferMaxSize )
+    {
+        psStack->nBufferMaxSize = (psStack->nBufferSize + nLen) * 2;
+        psStack->pszBuffer = (char *)
+            CPLRealloc( psStack->pszBuffer, psStack->nBufferMaxSize );
+    }
+    if( psStack->nCount == psStack->nMaxCount )
+    {
+        psStack->nMaxCount = psStack->nMaxCount * 2 + 10;
+        psStack->panOffsets = (size_t *)
+            CPLRealloc( psStack->panOffsets,
+                        sizeof(size_t) * psStack->nMaxCount );
+    }
+
+    memcpy( psStack->pszBuffer + psStack->nBufferSize, pszStr, nLen );
+    psStack->panOffsets[psStack->nCount++] = psStack->nBufferSize;
+    psStack->nBufferSize += nLen;
+}
+
+static void StringStackPop( StringStack *psStack )
+
+{
+    psStack->nCount--;
+    psStack->nBufferSize = psStack->panOffsets[psStack->nCount];
+}
+
+static const char *StringStackTop( StringStack *psStack )
+
+{
+    return psStack->pszBuffer + psStack->panOffsets[psStack->nCount-1];
+}
+
+/* Returns a NULL terminated list of the strings of the stack */
+static const char * const *StringStackList( StringStack *psStack )
+
+{
+    psStack->papszPointers = (const char **)
+        CPLRealloc( psStack->papszPointers,
+                    sizeof(char*) * (psStack->nCount + 1) );
+    for( int i = 0; i < psStack->nCount; i++ )
+        psStack->papszPointers[i] =
+            psStack->pszBuffer + psStack->panOffsets[i];
+    psStack->papszPointers[psStack->nCount] = NULL;
+    return psStack->papszPointers;
+}
+
+static void StringStackFree( StringStack *psStack )
+
+{
+    CPLFree( psStack->pszBuffer );
+    CPLFree( psStack->panOffsets );
+    CPLFree( psStack->papszPointers );
+}
+
+/************************************************************************/
+/*                        CPLParseXMLStringSAX()                        */
+/************************************************************************/
+
+/**
+ * \brief Parse an XML string, reporting its content through callbacks.
+ *
+ * The document is read with the same tokenizer as CPLParseXMLString(), but
+ * no tree is built: the passed functions are called as the start tags, end
+ * tags and text of the elements are met, which allows processing huge 
+ * documents with little memory.
+ *
+ * pfnStartElement receives the name of the element and its attributes as a
+ * NULL terminated list of names and values ("name1", "value1", "name2",
+ * ...).  Processing instructions like &lt;?xml ...?&gt; are reported as
+ * elements whose name starts with '?'.  Comments and literals are skipped.
+ * The strings passed to the callbacks are only valid during the call. 
+ * Any callback may be NULL.  A callback that returns FALSE stops the 
+ * parsing.
+ *
+ * @param pszString the document to parse. 
+ * @param pfnStartElement function called for each start tag.
+ * @param pfnEndElement function called for each end tag (or after 
+ * pfnStartElement for empty elements).
+ * @param pfnCharacterData function called for each text fragment between
+ * tags.
+ * @param pUserData value passed to the callbacks.
+ *
+ * @return TRUE if the whole document was parsed, FALSE on error (reported
+ * with CPLError()) or if a callback stopped the parsing.
+ *
+ * @since GDAL 2.0
+ */
+
+int CPLParseXMLStringSAX( const char *pszString,
+                          CPLXMLStartElementHandler pfnStartElement,
+                          CPLXMLEndElementHandler pfnEndElement,
+                          CPLXMLCharacterDataHandler pfnCharacterData,
+                          void *pUserData )
+
+{
+    ParseContext sContext;
+    StringStack  sElements, sAttributes;
+    int          bInStartTag = FALSE;
+    int          bOK = TRUE;
+
+    if( pszString == NULL )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined, 
+                  "CPLParseXMLStringSAX() called with NULL pointer." );
+        return FALSE;
+    }
+
+    memset( &sContext, 0, sizeof(sContext) );
+    sContext.pszInput = pszString;
+    sContext.nTokenMaxSize = 10;
+    sContext.pszToken = (char *) VSIMalloc(sContext.nTokenMaxSize);
+    if (sContext.pszToken == NULL)
+        return FALSE;
+    sContext.eTokenType = TNone;
+
+    memset( &sElements, 0, sizeof(sElements) );
+    memset( &sAttributes, 0, sizeof(sAttributes) );
+
+    while( bOK && ReadToken( &sContext ) != TNone )
+    {
+/* -------------------------------------------------------------------- */
+/*      Start or end tag.                                               */
+/* -------------------------------------------------------------------- */
+        if( sContext.eTokenType == TOpen )
+        {
+            if( ReadToken(&sContext) != TToken )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined, 
+                          "Line %d: Didn't find element token after open angle bracket.",
+                          sContext.nInputLine );
+                bOK = FALSE;
+            }
+            else if( sContext.pszToken[0] != '/' )
+            {
+                StringStackPush( &sElements, sContext.pszToken );
+                sAttributes.nCount = 0;
+                sAttributes.nBufferSize = 0;
+                bInStartTag = TRUE;
+            }
+            else if( sElements.nCount == 0
+                     || !EQUAL(sContext.pszToken+1, StringStackTop(&sElements)) )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined, 
+                          "Line %d: <%.500s> doesn't have matching <%.500s>.",
+                          sContext.nInputLine,
+                          sContext.pszToken, sContext.pszToken+1 );
+                bOK = FALSE;
+            }
+            else if( ReadToken(&sContext) != TClose )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined, 
+                          "Line %d: Missing close angle bracket after <%.500s.",
+                          sContext.nInputLine,
+                          sContext.pszToken );
+                bOK = FALSE;
+            }
+            else
+            {
+                if( pfnEndElement != NULL
+                    && !pfnEndElement( pUserData, StringStackTop(&sElements) ) )
+                    bOK = FALSE;
+                StringStackPop( &sElements );
+            }
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Attribute of the current start tag.                             */
+/* -------------------------------------------------------------------- */
+        else if( sContext.eTokenType == TToken && bInStartTag )
+        {
+            StringStackPush( &sAttributes, sContext.pszToken );
+
+            if( ReadToken(&sContext) != TEqual )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined, 
+                          "Line %d: Didn't find expected '=' for value of attribute '%.500s'.",
+                          sContext.nInputLine, StringStackTop(&sAttributes) );
+                bOK = FALSE;
+            }
+            else if( ReadToken(&sContext) != TString
+                     && sContext.eTokenType != TToken )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined, 
+                          "Line %d: Didn't find expected attribute value.",
+                          sContext.nInputLine );
+                bOK = FALSE;
+            }
+            else
+                StringStackPush( &sAttributes, sContext.pszToken );
+        }
+
+/* -------------------------------------------------------------------- */
+/*      End of a start tag : '>', '/>' or '?>'.                         */
+/* -------------------------------------------------------------------- */
+        else if( (sContext.eTokenType == TClose
+                  || sContext.eTokenType == TSlashClose
+                  || sContext.eTokenType == TQuestionClose) && bInStartTag )
+        {
+            bInStartTag = FALSE;
+
+            if( sContext.eTokenType == TQuestionClose
+                && StringStackTop(&sElements)[0] != '?' )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined, 
+                          "Line %d: Found '?>' without matching '<?'.",
+                          sContext.nInputLine );
+                bOK = FALSE;
+            }
+            else if( pfnStartElement != NULL
+                     && !pfnStartElement( pUserData,
+                                          StringStackTop(&sElements),
+                                          StringStackList(&sAttributes) ) )
+                bOK = FALSE;
+            else if( sContext.eTokenType != TClose )
+            {
+                if( pfnEndElement != NULL
+                    && !pfnEndElement( pUserData, StringStackTop(&sElements) ) )
+                    bOK = FALSE;
+                StringStackPop( &sElements );
+            }
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Comments and literals are ignored.                              */
+/* -------------------------------------------------------------------- */
+        else if( sContext.eTokenType == TComment
+                 || sContext.eTokenType == TLiteral )
+        {
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Text.                                                           */
+/* -------------------------------------------------------------------- */
+        else if( sContext.eTokenType == TString && !sContext.bInElement )
+        {
+            if( pfnCharacterData != NULL
+                && !pfnCharacterData( pUserData, sContext.pszToken ) )
+                bOK = FALSE;
+        }
+
+        else
+        {
+            CPLError( CE_Failure, CPLE_AppDefined, 
+                      "Parse error at line %d, unexpected token:%.500s\n", 
+                      sContext.nInputLine, sContext.pszToken );
+            bOK = FALSE;
+        }
+    }
+
+    if( bOK && sContext.pszToken == NULL )
+        bOK = FALSE;
+
+    if( bOK && sElements.nCount != 0 )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined, 
+                  "Parse error at EOF, not all elements have been closed,\n"
+                  "starting with %.500s\n", 
+                  StringStackTop(&sElements) );
+        bOK = FALSE;
+    }
+
+    CPLFree( sContext.pszToken );
+    StringStackFree( &sElements );
+    StringStackFree( &sAttributes );
+
+    return bOK;
+}
+
 /************************************************************************/
 /*                            _GrowBuffer()                             */
 /************************************************************************/
@@ -1946,6 +2438,39 @@ CPLXMLNode *CPLParseXMLFile( const char *pszFilename )
     return psTree;
 }
 
+/************************************************************************/
+/*                       CPLParseXMLFileInArena()                       */
+/************************************************************************/
+
+/**
+ * \brief Parse XML file into a read-only tree.
+ *
+ * Same as CPLParseXMLFile(), but the tree is built with 
+ * CPLParseXMLStringInArena(), and must be freed with 
+ * CPLDestroyXMLArenaTree().
+ *
+ * @param pszFilename the file to open. 
+ *
+ * @return NULL on failure, or the document tree on success.
+ *
+ * @since GDAL 2.0
+ */
+
+CPLXMLNode *CPLParseXMLFileInArena( const char *pszFilename )
+
+{
+    GByte           *pabyOut = NULL;
+    CPLXMLNode      *psTree;
+
+    if( !VSIIngestFile( NULL, pszFilename, &pabyOut, NULL, -1 ) )
+        return NULL;
+
+    psTree = CPLParseXMLStringInArena( (const char *) pabyOut );
+    CPLFree( pabyOut );
+
+    return psTree;
+}
+
 /************************************************************************/
 /*                     CPLSerializeXMLTreeToFile()                      */
 /************************************************************************/
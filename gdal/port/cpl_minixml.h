@@ -155,6 +155,26 @@ CPLXMLNode CPL_DLL *CPLParseXMLFile( const char *pszFilename );
 int        CPL_DLL CPLSerializeXMLTreeToFile( const CPLXMLNode *psTree,
                                               const char *pszFilename );
 
+/* Read-only trees whose nodes and strings all live in a few big blocks */
+CPLXMLNode CPL_DLL *CPLParseXMLStringInArena( const char *pszString );
+CPLXMLNode CPL_DLL *CPLParseXMLFileInArena( const char *pszFilename );
+void       CPL_DLL  CPLDestroyXMLArenaTree( CPLXMLNode *psTree );
+
+/* Event based parsing, without building a tree */
+typedef int (*CPLXMLStartElementHandler)( void *pUserData,
+                                          const char *pszName,
+                                          const char * const *papszAttributes );
+typedef int (*CPLXMLEndElementHandler)( void *pUserData,
+                                        const char *pszName );
+typedef int (*CPLXMLCharacterDataHandler)( void *pUserData,
+                                           const char *pszData );
+
+int        CPL_DLL CPLParseXMLStringSAX( const char *pszString,
+                                         CPLXMLStartElementHandler pfnStartElement,
+                                         CPLXMLEndElementHandler pfnEndElement,
+                                         CPLXMLCharacterDataHandler pfnCharacterData,
+                                         void *pUserData );
+
 CPL_C_END
 
 #endif /* _CPL_MINIXML_H_INCLUDED */
@@ -142,6 +142,9 @@ int CPL_DLL     VSIFSeekL( VSILFILE *, vsi_l_offset, int );
 vsi_l_offset CPL_DLL VSIFTellL( VSILFILE * );
 void CPL_DLL    VSIRewindL( VSILFILE * );
 size_t CPL_DLL  VSIFReadL( void *, size_t, size_t, VSILFILE * );
+size_t CPL_DLL  VSIFPReadL( void *pBuffer, size_t nSize, vsi_l_offset nOffset,
+                            VSILFILE * fp );
+int CPL_DLL     VSIFHasPReadL( VSILFILE * fp );
 int CPL_DLL     VSIFReadMultiRangeL( int nRanges, void ** ppData, const vsi_l_offset* panOffsets, const size_t* panSizes, VSILFILE * );
 size_t CPL_DLL  VSIFWriteL( const void *, size_t, size_t, VSILFILE * );
 int CPL_DLL     VSIFEofL( VSILFILE * );
@@ -173,6 +176,8 @@ int CPL_DLL     VSIStatExL( const char * pszFilename, VSIStatBufL * psStatBuf, i
 int CPL_DLL     VSIIsCaseSensitiveFS( const char * pszFilename );
 
 void CPL_DLL   *VSIFGetNativeFileDescriptorL( VSILFILE* );
+const void CPL_DLL *VSIFGetRangePointerL( VSILFILE* fp, vsi_l_offset nOffset,
+                                          size_t nSize );
 
 /* ==================================================================== */
 /*      Memory allocation                                               */
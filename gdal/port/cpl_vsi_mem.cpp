@@ -121,10 +121,13 @@ class VSIMemHandle : public VSIVirtualHandle
     virtual int       Seek( vsi_l_offset nOffset, int nWhence );
     virtual vsi_l_offset Tell();
     virtual size_t    Read( void *pBuffer, size_t nSize, size_t nMemb );
+    virtual int       HasPRead() { return TRUE; }
+    virtual size_t    PRead( void *pBuffer, size_t nSize, vsi_l_offset nOffset );
     virtual size_t    Write( const void *pBuffer, size_t nSize, size_t nMemb );
     virtual int       Eof();
     virtual int       Close();
     virtual int       Truncate( vsi_l_offset nNewSize );
+    virtual const void *GetRangePointer( vsi_l_offset nOffset, size_t nSize );
 };
 
 /************************************************************************/
@@ -349,6 +352,40 @@ size_t VSIMemHandle::Read( void * pBuffer, size_t nSize, size_t nCount )
     return nCount;
 }
 
+/************************************************************************/
+/*                               PRead()                                */
+/************************************************************************/
+
+size_t VSIMemHandle::PRead( void * pBuffer, size_t nSize,
+                            vsi_l_offset nOffset )
+
+{
+    if( nOffset >= poFile->nLength )
+        return 0;
+
+    if( nSize > poFile->nLength - nOffset )
+        nSize = (size_t)(poFile->nLength - nOffset);
+
+    memcpy( pBuffer, poFile->pabyData + nOffset, nSize );
+
+    return nSize;
+}
+
+/************************************************************************/
+/*                          GetRangePointer()                           */
+/************************************************************************/
+
+const void *VSIMemHandle::GetRangePointer( vsi_l_offset nOffset,
+                                           size_t nSize )
+
+{
+    if( poFile->pabyData == NULL || nOffset > poFile->nLength ||
+        nSize > poFile->nLength - nOffset )
+        return NULL;
+
+    return poFile->pabyData + nOffset;
+}
+
 /************************************************************************/
 /*                               Write()                                */
 /************************************************************************/
@@ -58,12 +58,16 @@ class CPL_DLL VSIVirtualHandle {
     virtual vsi_l_offset Tell() = 0;
     virtual size_t    Read( void *pBuffer, size_t nSize, size_t nMemb ) = 0;
     virtual int       ReadMultiRange( int nRanges, void ** ppData, const vsi_l_offset* panOffsets, const size_t* panSizes );
+    virtual int       HasPRead() { return FALSE; }
+    virtual size_t    PRead( void *pBuffer, size_t nSize, vsi_l_offset nOffset );
     virtual size_t    Write( const void *pBuffer, size_t nSize,size_t nMemb)=0;
     virtual int       Eof() = 0;
     virtual int       Flush() {return 0;}
     virtual int       Close() = 0;
     virtual int       Truncate( CPL_UNUSED vsi_l_offset nNewSize ) { return -1; }
     virtual void     *GetNativeFileDescriptor() { return NULL; }
+    virtual const void *GetRangePointer( CPL_UNUSED vsi_l_offset nOffset,
+                                         CPL_UNUSED size_t nSize ) { return NULL; }
     virtual           ~VSIVirtualHandle() { }
 };
 
@@ -140,11 +144,25 @@ typedef struct
     GIntBig       nModifiedTime;
 } VSIArchiveEntry;
 
-typedef struct
+class VSIArchiveContent
 {
-    int nEntries;
-    VSIArchiveEntry* entries;
-} VSIArchiveContent;
+    public:
+        int nEntries;
+        VSIArchiveEntry* entries;
+
+        /* Lookup of entries by name, and of the entries directly under */
+        /* each directory ("" for the root), so that FindFileInArchive() */
+        /* and ReadDir() do not have to scan the whole member list */
+        std::map<CPLString,int>                 oMapNameToEntry;
+        std::map<CPLString,std::vector<int> >   oMapDirToChildren;
+
+        VSIArchiveContent() : nEntries(0), entries(NULL) {}
+        ~VSIArchiveContent();
+
+        void AddEntry(char* pszFileName, vsi_l_offset nSize,
+                      VSIArchiveEntryFileOffset* poFilePos,
+                      int bIsDir, GIntBig nModifiedTime);
+};
 
 class VSIArchiveReader
 {
@@ -173,6 +191,21 @@ protected:
     virtual std::vector<CPLString> GetExtensions() = 0;
     virtual VSIArchiveReader* CreateReader(const char* pszArchiveFileName) = 0;
 
+    /* Conversion of a reader specific offset from/to two integers, so that */
+    /* the member list can be saved in a persistent index. Handlers that do */
+    /* not implement them never use such an index. */
+    virtual int SerializeFileOffset(CPL_UNUSED const VSIArchiveEntryFileOffset* poOffset,
+                                    CPL_UNUSED GUIntBig* pnVal1,
+                                    CPL_UNUSED GUIntBig* pnVal2) { return FALSE; }
+    virtual VSIArchiveEntryFileOffset* DeserializeFileOffset(CPL_UNUSED GUIntBig nVal1,
+                                                             CPL_UNUSED GUIntBig nVal2) { return NULL; }
+
+    VSIArchiveContent* ReadIndex(const char* archiveFilename,
+                                 const VSIStatBufL* psStatBuf);
+    void               WriteIndex(const char* archiveFilename,
+                                  const VSIStatBufL* psStatBuf,
+                                  const VSIArchiveContent* content);
+
 public:
     VSIArchiveFilesystemHandler();
     virtual ~VSIArchiveFilesystemHandler();
@@ -194,7 +227,12 @@ VSIVirtualHandle CPL_DLL *VSICreateBufferedReaderHandle(VSIVirtualHandle* poBase
 VSIVirtualHandle* VSICreateBufferedReaderHandle(VSIVirtualHandle* poBaseHandle,
                                                 const GByte* pabyBeginningContent,
                                                 vsi_l_offset nSheatFileSize);
-VSIVirtualHandle* VSICreateCachedFile( VSIVirtualHandle* poBaseHandle, size_t nChunkSize = 32768, size_t nCacheSize = 0 );
+VSIVirtualHandle CPL_DLL *VSICreateCachedFile( VSIVirtualHandle* poBaseHandle, const char* pszFilename = NULL, size_t nChunkSize = 0, int nMaxReadAhead = -1 );
+int VSIGetCacheOptions( const char* pszFilename, size_t* pnChunkSize, int* pnMaxReadAhead );
+void VSICacheInvalidateFile( const char* pszFilename );
+void VSICacheNotifyWriteOpen( VSIVirtualHandle* poHandle, const char* pszFilename );
+void VSICacheNotifyClose( VSIVirtualHandle* poHandle );
+void CPL_DLL VSICleanupCachedFileManager();
 VSIVirtualHandle CPL_DLL *VSICreateGZipWritable( VSIVirtualHandle* poBaseHandle, int bRegularZLibIn, int bAutoCloseBaseHandle );
 
 #endif /* ndef CPL_VSI_VIRTUAL_H_INCLUDED */
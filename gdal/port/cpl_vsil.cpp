@@ -297,6 +297,8 @@ int VSIUnlink( const char * pszFilename )
     VSIFilesystemHandler *poFSHandler = 
         VSIFileManager::GetHandler( pszFilename );
 
+    VSICacheInvalidateFile( pszFilename );
+
     return poFSHandler->Unlink( pszFilename );
 }
 
@@ -328,6 +330,9 @@ int VSIRename( const char * oldpath, const char * newpath )
     VSIFilesystemHandler *poFSHandler = 
         VSIFileManager::GetHandler( oldpath );
 
+    VSICacheInvalidateFile( oldpath );
+    VSICacheInvalidateFile( newpath );
+
     return poFSHandler->Rename( oldpath, newpath );
 }
 
@@ -497,6 +502,16 @@ int VSIIsCaseSensitiveFS( const char * pszFilename )
  * This method goes through the VSIFileHandler virtualization and may
  * work on unusual filesystems such as in memory.
  *
+ * Files opened in read-only mode go through a RAM cache shared by the
+ * process when the VSI_CACHE configuration option is set to TRUE, or when
+ * their name starts with one of the prefixes of VSI_CACHE_PREFIX_OPTIONS
+ * (a semicolon separated list of "prefix [CHUNK_SIZE=bytes]
+ * [READ_AHEAD=chunks]" entries). VSI_CACHE_SIZE sets the size of the cache
+ * (25 MB by default). The cached content of a file is discarded when it is
+ * opened for writing, unlinked or renamed through VSI by this process, or
+ * when its size or modification time changed. A file rewritten by another
+ * process with the same size within the same second is not detected.
+ *
  * Analog of the POSIX fopen() function.
  *
  * @param pszFilename the file to open.  UTF-8 encoded.
@@ -513,6 +528,25 @@ VSILFILE *VSIFOpenL( const char * pszFilename, const char * pszAccess )
         
     VSILFILE* fp = (VSILFILE *) poFSHandler->Open( pszFilename, pszAccess );
 
+/* -------------------------------------------------------------------- */
+/*      If VSI_CACHE or VSI_CACHE_PREFIX_OPTIONS request it, use a      */
+/*      cached reader instead of more direct io on the underlying file. */
+/* -------------------------------------------------------------------- */
+    size_t nChunkSize;
+    int    nMaxReadAhead;
+    if( fp != NULL && (EQUAL(pszAccess, "r") || EQUAL(pszAccess, "rb")) )
+    {
+        if( VSIGetCacheOptions( pszFilename, &nChunkSize, &nMaxReadAhead ) )
+            fp = (VSILFILE *) VSICreateCachedFile( (VSIVirtualHandle *) fp,
+                                                   pszFilename, nChunkSize,
+                                                   nMaxReadAhead );
+    }
+    else if( fp != NULL )
+    {
+        /* The file may be modified: drop its cached chunks */
+        VSICacheNotifyWriteOpen( (VSIVirtualHandle *) fp, pszFilename );
+    }
+
     VSIDebug3( "VSIFOpenL(%s,%s) = %p", pszFilename, pszAccess, fp );
         
     return fp;
@@ -545,6 +579,8 @@ int VSIFCloseL( VSILFILE * fp )
     VSIDebug1( "VSICloseL(%p)", fp );
     
     int nResult = poFileHandle->Close();
+
+    VSICacheNotifyClose( poFileHandle );
     
     delete poFileHandle;
 
@@ -679,6 +715,67 @@ size_t VSIFReadL( void * pBuffer, size_t nSize, size_t nCount, VSILFILE * fp )
 }
 
 
+/************************************************************************/
+/*                             VSIFPReadL()                             */
+/************************************************************************/
+
+/**
+ * \brief Read bytes from file at a given offset.
+ *
+ * Reads nSize bytes from the indicated file at offset nOffset into the
+ * indicated buffer, without using nor modifying the current file offset.
+ *
+ * When VSIFHasPReadL() returns TRUE for the handle, this function can be
+ * called concurrently from several threads on the same handle, including
+ * while another thread uses VSIFSeekL() / VSIFReadL(). Otherwise it is
+ * emulated with seek and read calls and the caller must serialize accesses
+ * to the handle.
+ *
+ * Analog of the POSIX pread() call.
+ *
+ * @param pBuffer the buffer into which the data should be read (at least
+ * nSize bytes in size).
+ * @param nSize number of bytes to read.
+ * @param nOffset file offset at which to start reading.
+ * @param fp file handle opened with VSIFOpenL().
+ *
+ * @return number of bytes successfully read.
+ * @since GDAL 2.0
+ */
+
+size_t VSIFPReadL( void * pBuffer, size_t nSize, vsi_l_offset nOffset,
+                   VSILFILE * fp )
+
+{
+    VSIVirtualHandle *poFileHandle = (VSIVirtualHandle *) fp;
+
+    return poFileHandle->PRead( pBuffer, nSize, nOffset );
+}
+
+/************************************************************************/
+/*                            VSIFHasPReadL()                           */
+/************************************************************************/
+
+/**
+ * \brief Returns whether VSIFPReadL() is natively implemented for the handle.
+ *
+ * This is the case for read-only local files, /vsimem/ files, /vsicurl/
+ * files, and /vsisubfile/ files whose underlying file supports it.
+ *
+ * @param fp file handle opened with VSIFOpenL().
+ *
+ * @return TRUE if VSIFPReadL() is thread-safe on this handle.
+ * @since GDAL 2.0
+ */
+
+int VSIFHasPReadL( VSILFILE * fp )
+
+{
+    VSIVirtualHandle *poFileHandle = (VSIVirtualHandle *) fp;
+
+    return poFileHandle->HasPRead();
+}
+
 /************************************************************************/
 /*                       VSIFReadMultiRangeL()                          */
 /************************************************************************/
@@ -1038,6 +1135,43 @@ void *VSIFGetNativeFileDescriptorL( VSILFILE* fp )
     return poFileHandle->GetNativeFileDescriptor();
 }
 
+/************************************************************************/
+/*                        VSIFGetRangePointerL()                        */
+/************************************************************************/
+
+/**
+ * \brief Returns a pointer to a range of bytes of the file, without copy.
+ *
+ * For read-only handles on regular files, the file is memory-mapped on the
+ * first call (unless the VSI_MMAP configuration option is set to NO), and
+ * the returned pointer points into the mapping. /vsimem/ files return a
+ * pointer into their buffer, and /vsisubfile/ forwards the request to its
+ * underlying file.
+ *
+ * For other virtual file systems, or if the requested range is not fully
+ * inside the file, NULL is returned and the caller should fall back to
+ * VSIFSeekL() / VSIFReadL(). The current file offset is not modified.
+ *
+ * The returned pointer must be considered read-only. It remains valid until
+ * the file handle is closed, or for /vsimem/ files, until the file is
+ * written to or truncated.
+ *
+ * @param fp file handle opened with VSIFOpenL().
+ * @param nOffset offset of the start of the range, in bytes.
+ * @param nSize size of the range, in bytes.
+ *
+ * @return a pointer to nSize bytes of file content, or NULL.
+ * @since GDAL 2.0
+ */
+
+const void *VSIFGetRangePointerL( VSILFILE* fp, vsi_l_offset nOffset,
+                                  size_t nSize )
+{
+    VSIVirtualHandle *poFileHandle = (VSIVirtualHandle *) fp;
+
+    return poFileHandle->GetRangePointer( nOffset, nSize );
+}
+
 
 /************************************************************************/
 /* ==================================================================== */
@@ -1202,6 +1336,8 @@ void VSICleanupFileManager()
         poManager = NULL;
     }
 
+    VSICleanupCachedFileManager();
+
     if( hVSIFileManagerMutex != NULL )
     {
         CPLDestroyMutex(hVSIFileManagerMutex);
@@ -1239,3 +1375,21 @@ int VSIVirtualHandle::ReadMultiRange( int nRanges, void ** ppData,
 
     return nRet;
 }
+
+/************************************************************************/
+/*                               PRead()                                */
+/*                                                                      */
+/*      Default implementation, emulated with Seek() and Read().  Not   */
+/*      thread-safe: HasPRead() returns FALSE for such handles.         */
+/************************************************************************/
+
+size_t VSIVirtualHandle::PRead( void *pBuffer, size_t nSize,
+                                vsi_l_offset nOffset )
+{
+    vsi_l_offset nCurOffset = Tell();
+    size_t nRet = 0;
+    if( Seek(nOffset, SEEK_SET) == 0 )
+        nRet = Read(pBuffer, 1, nSize);
+    Seek(nCurOffset, SEEK_SET);
+    return nRet;
+}
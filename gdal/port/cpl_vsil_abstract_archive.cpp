@@ -31,7 +31,6 @@
 #include "cpl_string.h"
 #include "cpl_multiproc.h"
 #include <map>
-#include <set>
 
 #define ENABLE_DEBUG 0
 
@@ -53,6 +52,56 @@ VSIArchiveReader::~VSIArchiveReader()
 {
 }
 
+/************************************************************************/
+/*                        ~VSIArchiveContent()                          */
+/************************************************************************/
+
+VSIArchiveContent::~VSIArchiveContent()
+{
+    int i;
+    for(i=0;i<nEntries;i++)
+    {
+        delete entries[i].file_pos;
+        CPLFree(entries[i].fileName);
+    }
+    CPLFree(entries);
+}
+
+/************************************************************************/
+/*                              AddEntry()                              */
+/*                                                                      */
+/*      Takes ownership of pszFileName and poFilePos.                   */
+/************************************************************************/
+
+void VSIArchiveContent::AddEntry(char* pszFileName, vsi_l_offset nSize,
+                                 VSIArchiveEntryFileOffset* poFilePos,
+                                 int bIsDir, GIntBig nModifiedTime)
+{
+    /* Grow by powers of two, as archives may have several 100,000 members */
+    if ((nEntries & (nEntries - 1)) == 0)
+        entries = (VSIArchiveEntry*)CPLRealloc(entries,
+                        sizeof(VSIArchiveEntry) * (nEntries == 0 ? 1 : 2 * nEntries));
+
+    entries[nEntries].fileName = pszFileName;
+    entries[nEntries].uncompressed_size = nSize;
+    entries[nEntries].file_pos = poFilePos;
+    entries[nEntries].bIsDir = bIsDir;
+    entries[nEntries].nModifiedTime = nModifiedTime;
+    if (ENABLE_DEBUG)
+        CPLDebug("VSIArchive", "[%d] %s : " CPL_FRMT_GUIB " bytes", nEntries+1,
+                 pszFileName, (GUIntBig)nSize);
+
+    oMapNameToEntry[pszFileName] = nEntries;
+
+    const char* pszLastSlash = strrchr(pszFileName, '/');
+    CPLString osParent;
+    if (pszLastSlash != NULL)
+        osParent.assign(pszFileName, pszLastSlash - pszFileName);
+    oMapDirToChildren[osParent].push_back(nEntries);
+
+    nEntries++;
+}
+
 /************************************************************************/
 /*                   VSIArchiveFilesystemHandler()                      */
 /************************************************************************/
@@ -73,15 +122,7 @@ VSIArchiveFilesystemHandler::~VSIArchiveFilesystemHandler()
 
     for( iter = oFileList.begin(); iter != oFileList.end(); ++iter )
     {
-        VSIArchiveContent* content = iter->second;
-        int i;
-        for(i=0;i<content->nEntries;i++)
-        {
-            delete content->entries[i].file_pos;
-            CPLFree(content->entries[i].fileName);
-        }
-        CPLFree(content->entries);
-        delete content;
+        delete iter->second;
     }
 
     if( hMutex != NULL )
@@ -89,6 +130,182 @@ VSIArchiveFilesystemHandler::~VSIArchiveFilesystemHandler()
     hMutex = NULL;
 }
 
+/************************************************************************/
+/*                          GetIndexFilename()                          */
+/************************************************************************/
+
+static CPLString GetIndexFilename(const char* archiveFilename)
+{
+    return CPLString(archiveFilename) + ".vsiidx";
+}
+
+/************************************************************************/
+/*                             ReadIndex()                              */
+/*                                                                      */
+/*      Load the member list from the index file saved next to the      */
+/*      archive by WriteIndex(). The index is rejected if it was        */
+/*      written for another handler, or for an archive of a             */
+/*      different size or modification time.                           */
+/************************************************************************/
+
+VSIArchiveContent* VSIArchiveFilesystemHandler::ReadIndex(
+                                        const char* archiveFilename,
+                                        const VSIStatBufL* psStatBuf)
+{
+    CPLString osIndexFilename = GetIndexFilename(archiveFilename);
+    VSILFILE* fp = VSIFOpenL(osIndexFilename, "rb");
+    if (fp == NULL)
+        return NULL;
+
+    const char* pszLine = CPLReadLineL(fp);
+    if (pszLine == NULL || !EQUAL(pszLine, "GDAL_VSIARCHIVE_INDEX 1"))
+    {
+        VSIFCloseL(fp);
+        return NULL;
+    }
+
+    pszLine = CPLReadLineL(fp);
+    char** papszTokens = (pszLine) ? CSLTokenizeString2(pszLine, " ", 0) : NULL;
+    int nExpectedEntries = -1;
+    if (CSLCount(papszTokens) == 4 &&
+        strcmp(papszTokens[0], GetPrefix()) == 0 &&
+        CPLScanUIntBig(papszTokens[1], strlen(papszTokens[1])) ==
+                                        (GUIntBig)psStatBuf->st_size &&
+        CPLAtoGIntBig(papszTokens[2]) == (GIntBig)psStatBuf->st_mtime)
+    {
+        nExpectedEntries = atoi(papszTokens[3]);
+    }
+    CSLDestroy(papszTokens);
+    if (nExpectedEntries < 0)
+    {
+        VSIFCloseL(fp);
+        return NULL;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Each entry is "<F|D|I> size mtime offset1 offset2 name", where  */
+/*      I stands for the intermediate directories that have no entry    */
+/*      of their own in the archive.                                    */
+/* -------------------------------------------------------------------- */
+    VSIArchiveContent* content = new VSIArchiveContent;
+    int bOK = TRUE;
+    while (bOK && (pszLine = CPLReadLineL(fp)) != NULL)
+    {
+        if (strcmp(pszLine, "END") == 0)
+            break;
+
+        const char* apszFields[5];
+        const char* pszIter = pszLine;
+        int iField;
+        for(iField=0;iField<5 && bOK;iField++)
+        {
+            apszFields[iField] = pszIter;
+            pszIter = strchr(pszIter, ' ');
+            if (pszIter == NULL)
+                bOK = FALSE;
+            else
+                pszIter ++;
+        }
+        if (!bOK || *pszIter == '\0' || content->nEntries == nExpectedEntries)
+        {
+            bOK = FALSE;
+            break;
+        }
+
+        char chKind = apszFields[0][0];
+        VSIArchiveEntryFileOffset* poFilePos = NULL;
+        if (chKind != 'I')
+        {
+            poFilePos = DeserializeFileOffset(
+                CPLScanUIntBig(apszFields[3], apszFields[4] - apszFields[3]),
+                CPLScanUIntBig(apszFields[4], pszIter - apszFields[4]));
+            if (poFilePos == NULL)
+            {
+                bOK = FALSE;
+                break;
+            }
+        }
+
+        content->AddEntry(CPLStrdup(pszIter),
+                          CPLScanUIntBig(apszFields[1], apszFields[2] - apszFields[1]),
+                          poFilePos,
+                          chKind != 'F',
+                          CPLAtoGIntBig(apszFields[2]));
+    }
+    VSIFCloseL(fp);
+
+    /* A truncated index (e.g. still being written by another process) */
+    /* is ignored and the archive scanned again */
+    if (!bOK || pszLine == NULL || content->nEntries != nExpectedEntries)
+    {
+        CPLDebug("VSIArchive", "Ignoring invalid index %s",
+                 osIndexFilename.c_str());
+        delete content;
+        return NULL;
+    }
+
+    CPLDebug("VSIArchive", "Loaded %d entries from %s",
+             content->nEntries, osIndexFilename.c_str());
+    return content;
+}
+
+/************************************************************************/
+/*                             WriteIndex()                             */
+/************************************************************************/
+
+void VSIArchiveFilesystemHandler::WriteIndex(const char* archiveFilename,
+                                             const VSIStatBufL* psStatBuf,
+                                             const VSIArchiveContent* content)
+{
+    CPLString osIndexFilename = GetIndexFilename(archiveFilename);
+
+    /* The archive may well lie in a read-only location */
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    VSILFILE* fp = VSIFOpenL(osIndexFilename, "wb");
+    CPLPopErrorHandler();
+    if (fp == NULL)
+        return;
+
+    int bOK = VSIFPrintfL(fp, "GDAL_VSIARCHIVE_INDEX 1\n%s " CPL_FRMT_GUIB " " CPL_FRMT_GIB " %d\n",
+                          GetPrefix(), (GUIntBig)psStatBuf->st_size,
+                          (GIntBig)psStatBuf->st_mtime, content->nEntries) > 0;
+    int i;
+    for(i=0;bOK && i<content->nEntries;i++)
+    {
+        const VSIArchiveEntry* psEntry = &content->entries[i];
+        GUIntBig nVal1 = 0, nVal2 = 0;
+        char chKind = 'I';
+        if (psEntry->file_pos != NULL)
+        {
+            if (!SerializeFileOffset(psEntry->file_pos, &nVal1, &nVal2))
+            {
+                bOK = FALSE;
+                break;
+            }
+            chKind = (psEntry->bIsDir) ? 'D' : 'F';
+        }
+        if (strchr(psEntry->fileName, '\n') != NULL ||
+            strchr(psEntry->fileName, '\r') != NULL)
+        {
+            bOK = FALSE;
+            break;
+        }
+        bOK = VSIFPrintfL(fp, "%c " CPL_FRMT_GUIB " " CPL_FRMT_GIB " " CPL_FRMT_GUIB " " CPL_FRMT_GUIB " %s\n",
+                          chKind, (GUIntBig)psEntry->uncompressed_size,
+                          psEntry->nModifiedTime, nVal1, nVal2,
+                          psEntry->fileName) > 0;
+    }
+    if (bOK)
+        bOK = VSIFPrintfL(fp, "END\n") > 0;
+    if (VSIFCloseL(fp) != 0)
+        bOK = FALSE;
+
+    if (!bOK)
+        VSIUnlink(osIndexFilename);
+    else
+        CPLDebug("VSIArchive", "Wrote %s", osIndexFilename.c_str());
+}
+
 /************************************************************************/
 /*                       GetContentOfArchive()                          */
 /************************************************************************/
@@ -98,9 +315,33 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive
 {
     CPLMutexHolder oHolder( &hMutex );
 
-    if (oFileList.find(archiveFilename) != oFileList.end() )
+    std::map<CPLString,VSIArchiveContent*>::const_iterator oIter =
+                                            oFileList.find(archiveFilename);
+    if (oIter != oFileList.end() )
     {
-        return oFileList[archiveFilename];
+        return oIter->second;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Try the persistent index first, so that huge archives do not    */
+/*      need to be walked again in every process.                       */
+/* -------------------------------------------------------------------- */
+    const char* pszIndexMode =
+        CPLGetConfigOption("CPL_VSIL_ARCHIVE_INDEX", "IF_EXISTS");
+    int bUseIndex = !EQUAL(pszIndexMode, "NO") && !EQUAL(pszIndexMode, "OFF") &&
+                    !EQUAL(pszIndexMode, "FALSE");
+    VSIStatBufL sStat;
+    if (bUseIndex && VSIStatL(archiveFilename, &sStat) != 0)
+        bUseIndex = FALSE;
+
+    if (bUseIndex)
+    {
+        VSIArchiveContent* content = ReadIndex(archiveFilename, &sStat);
+        if (content != NULL)
+        {
+            oFileList[archiveFilename] = content;
+            return content;
+        }
     }
 
     int bMustClose = (poReader == NULL);
@@ -119,12 +360,8 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive
     }
 
     VSIArchiveContent* content = new VSIArchiveContent;
-    content->nEntries = 0;
-    content->entries = NULL;
     oFileList[archiveFilename] = content;
 
-    std::set<CPLString> oSet;
-
     do
     {
         CPLString osFileName = poReader->GetFileName();
@@ -154,53 +391,30 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive
             pszStrippedFileName[strlen(fileName)-1] = 0;
         }
 
-        if (oSet.find(pszStrippedFileName) == oSet.end())
+        if (content->oMapNameToEntry.find(pszStrippedFileName) ==
+                                        content->oMapNameToEntry.end())
         {
-            oSet.insert(pszStrippedFileName);
-
             /* Add intermediate directory structure */
             for(pszIter = pszStrippedFileName;*pszIter;pszIter++)
             {
                 if (*pszIter == '/')
                 {
-                    char* pszStrippedFileName2 = CPLStrdup(pszStrippedFileName);
-                    pszStrippedFileName2[pszIter - pszStrippedFileName] = 0;
-                    if (oSet.find(pszStrippedFileName2) == oSet.end())
-                    {
-                        oSet.insert(pszStrippedFileName2);
-
-                        content->entries = (VSIArchiveEntry*)CPLRealloc(content->entries,
-                                sizeof(VSIArchiveEntry) * (content->nEntries + 1));
-                        content->entries[content->nEntries].fileName = pszStrippedFileName2;
-                        content->entries[content->nEntries].nModifiedTime = poReader->GetModifiedTime();
-                        content->entries[content->nEntries].uncompressed_size = 0;
-                        content->entries[content->nEntries].bIsDir = TRUE;
-                        content->entries[content->nEntries].file_pos = NULL;
-                        if (ENABLE_DEBUG)
-                            CPLDebug("VSIArchive", "[%d] %s : " CPL_FRMT_GUIB " bytes", content->nEntries+1,
-                                content->entries[content->nEntries].fileName,
-                                content->entries[content->nEntries].uncompressed_size);
-                        content->nEntries++;
-                    }
-                    else
+                    CPLString osDir;
+                    osDir.assign(pszStrippedFileName, pszIter - pszStrippedFileName);
+                    if (content->oMapNameToEntry.find(osDir) ==
+                                        content->oMapNameToEntry.end())
                     {
-                        CPLFree(pszStrippedFileName2);
+                        content->AddEntry(CPLStrdup(osDir), 0, NULL, TRUE,
+                                          poReader->GetModifiedTime());
                     }
                 }
             }
 
-            content->entries = (VSIArchiveEntry*)CPLRealloc(content->entries,
-                                sizeof(VSIArchiveEntry) * (content->nEntries + 1));
-            content->entries[content->nEntries].fileName = pszStrippedFileName;
-            content->entries[content->nEntries].nModifiedTime = poReader->GetModifiedTime();
-            content->entries[content->nEntries].uncompressed_size = poReader->GetFileSize();
-            content->entries[content->nEntries].bIsDir = bIsDir;
-            content->entries[content->nEntries].file_pos = poReader->GetFileOffset();
-            if (ENABLE_DEBUG)
-                CPLDebug("VSIArchive", "[%d] %s : " CPL_FRMT_GUIB " bytes", content->nEntries+1,
-                    content->entries[content->nEntries].fileName,
-                    content->entries[content->nEntries].uncompressed_size);
-            content->nEntries++;
+            content->AddEntry(pszStrippedFileName,
+                              poReader->GetFileSize(),
+                              poReader->GetFileOffset(),
+                              bIsDir,
+                              poReader->GetModifiedTime());
         }
         else
         {
@@ -211,6 +425,10 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive
     if (bMustClose)
         delete(poReader);
 
+    if (bUseIndex && !EQUAL(pszIndexMode, "IF_EXISTS") &&
+        CSLTestBoolean(pszIndexMode))
+        WriteIndex(archiveFilename, &sStat, content);
+
     return content;
 }
 
@@ -228,15 +446,13 @@ int VSIArchiveFilesystemHandler::FindFileInArchive(const char* archiveFilename,
     const VSIArchiveContent* content = GetContentOfArchive(archiveFilename);
     if (content)
     {
-        int i;
-        for(i=0;i<content->nEntries;i++)
+        std::map<CPLString,int>::const_iterator oIter =
+                        content->oMapNameToEntry.find(fileInArchiveName);
+        if (oIter != content->oMapNameToEntry.end())
         {
-            if (strcmp(fileInArchiveName, content->entries[i].fileName) == 0)
-            {
-                if (archiveEntry)
-                    *archiveEntry = &content->entries[i];
-                return TRUE;
-            }
+            if (archiveEntry)
+                *archiveEntry = &content->entries[oIter->second];
+            return TRUE;
         }
     }
     return FALSE;
@@ -579,38 +795,21 @@ char** VSIArchiveFilesystemHandler::ReadDir( const char *pszDirname )
     }
 
     if (ENABLE_DEBUG) CPLDebug("VSIArchive", "Read dir %s", pszDirname);
-    int i;
-    for(i=0;i<content->nEntries;i++)
+
+    /* Only list entries at the same level of inArchiveSubDir */
+    std::map<CPLString,std::vector<int> >::const_iterator oIter =
+                        content->oMapDirToChildren.find(osInArchiveSubDir);
+    if (oIter != content->oMapDirToChildren.end())
     {
-        const char* fileName = content->entries[i].fileName;
-        /* Only list entries at the same level of inArchiveSubDir */
-        if (lenInArchiveSubDir != 0 &&
-            strncmp(fileName, osInArchiveSubDir, lenInArchiveSubDir) == 0 &&
-            (fileName[lenInArchiveSubDir] == '/' || fileName[lenInArchiveSubDir] == '\\') &&
-            fileName[lenInArchiveSubDir + 1] != 0)
+        const std::vector<int>& anChildren = oIter->second;
+        for(size_t i=0;i<anChildren.size();i++)
         {
-            const char* slash = strchr(fileName + lenInArchiveSubDir + 1, '/');
-            if (slash == NULL)
-                slash = strchr(fileName + lenInArchiveSubDir + 1, '\\');
-            if (slash == NULL || slash[1] == 0)
-            {
-                char* tmpFileName = CPLStrdup(fileName);
-                if (slash != NULL)
-                {
-                    tmpFileName[strlen(tmpFileName)-1] = 0;
-                }
-                if (ENABLE_DEBUG)
-                    CPLDebug("VSIArchive", "Add %s as in directory %s\n",
-                            tmpFileName + lenInArchiveSubDir + 1, pszDirname);
-                papszDir = CSLAddString(papszDir, tmpFileName + lenInArchiveSubDir + 1);
-                CPLFree(tmpFileName);
-            }
-        }
-        else if (lenInArchiveSubDir == 0 &&
-                 strchr(fileName, '/') == NULL && strchr(fileName, '\\') == NULL)
-        {
-            /* Only list toplevel files and directories */
-            if (ENABLE_DEBUG) CPLDebug("VSIArchive", "Add %s as in directory %s\n", fileName, pszDirname);
+            const char* fileName = content->entries[anChildren[i]].fileName;
+            if (lenInArchiveSubDir != 0)
+                fileName += lenInArchiveSubDir + 1;
+            if (ENABLE_DEBUG)
+                CPLDebug("VSIArchive", "Add %s as in directory %s\n",
+                         fileName, pszDirname);
             papszDir = CSLAddString(papszDir, fileName);
         }
     }
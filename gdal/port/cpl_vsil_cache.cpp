@@ -29,9 +29,39 @@
  ****************************************************************************/
 
 #include "cpl_vsi_virtual.h"
+#include "cpl_multiproc.h"
+#include <set>
 
 CPL_CVSID("$Id$");
 
+/*
+** The cache is shared by all cached handles of the process. Chunks are
+** identified by a file identifier and a block number, and are kept in a
+** single LRU list whose total size is bounded by VSI_CACHE_SIZE.
+**
+** Files opened by name get a file identifier derived from their name
+** and chunk size, so that successive opens of the same file reuse the
+** cached chunks. The size and modification time of the file are kept
+** along, and a change of either discards the chunks. As a file can be
+** rewritten with the same size within the same second, the chunks of a
+** file are also discarded when this process opens it for writing,
+** closes such a handle, unlinks or renames it. Handles created without
+** a filename get a private identifier whose chunks are discarded on
+** close. The identifier of a file is forgotten once it has no chunk
+** left in the cache and no handle open.
+**
+** The size and modification time cannot detect a file rewritten by
+** another process with the same size within the same second: such a
+** file is only seen changed once its chunks are evicted.
+**
+** The manager is kept alive as long as cached handles are open, even
+** after VSICleanupCachedFileManager(), which then only marks it for
+** deletion by the last Close().
+*/
+
+#define VSI_CACHE_DEFAULT_CHUNK_SIZE   32768
+#define VSI_CACHE_DEFAULT_READ_AHEAD   16
+
 /************************************************************************/
 /* ==================================================================== */
 /*                             VSICacheChunk                            */
@@ -44,8 +74,9 @@ public:
     VSICacheChunk() 
     { 
         poLRUPrev = poLRUNext = NULL;
+        nFileId = 0;
+        iBlock = 0;
         nDataFilled = 0;
-        bDirty = FALSE;
         pabyData = NULL;
     }
 
@@ -54,168 +85,369 @@ public:
         VSIFree( pabyData );
     }
 
-    bool Allocate( size_t nChunkSize )
+    bool Allocate( size_t nSize )
     {
         CPLAssert( pabyData == NULL );
-        pabyData = (GByte *)VSIMalloc( nChunkSize );
+        if( nSize == 0 )
+            return true;
+        pabyData = (GByte *)VSIMalloc( nSize );
         return (pabyData != NULL);
     }
 
-    int            bDirty;
+    int            nFileId;
     vsi_l_offset   iBlock;
 
     VSICacheChunk *poLRUPrev;
     VSICacheChunk *poLRUNext;
 
-    vsi_l_offset   nDataFilled;
+    size_t         nDataFilled;
     GByte          *pabyData;
 };
 
 /************************************************************************/
 /* ==================================================================== */
-/*                             VSICachedFile                            */
+/*                           VSICacheManager                            */
 /* ==================================================================== */
 /************************************************************************/
 
-class VSICachedFile : public VSIVirtualHandle
-{ 
-  public:
-    VSICachedFile( VSIVirtualHandle *poBaseHandle, 
-                   size_t nChunkSize,
-                   size_t nCacheSize );
-    ~VSICachedFile() { Close(); }
+typedef std::pair<int, vsi_l_offset> VSICacheChunkKey;
 
-    void          FlushLRU();
-    int           LoadBlocks( vsi_l_offset nStartBlock, size_t nBlockCount, 
-                              void *pBuffer, size_t nBufferSize );
-    void          Demote( VSICacheChunk * );
+typedef struct
+{
+    CPLString      osFileKey;   /* empty for private or invalidated ids */
+    CPLString      osValidator; /* size and modification time */
+    int            nChunks;
+    int            nHandles;
+} VSICacheFileInfo;
 
-    VSIVirtualHandle *poBase;
-    
-    vsi_l_offset  nOffset;
-    vsi_l_offset  nFileSize;
+class VSICacheManager
+{
+    std::map<CPLString, int>                     oMapFileKeyToId;
+    std::map<int, VSICacheFileInfo>              oMapFileInfo;
+    std::map<VSICacheChunkKey, VSICacheChunk*>   oMapChunks;
+    std::map<VSIVirtualHandle*, CPLString>       oMapWriteHandles;
+    std::set<VSIVirtualHandle*>                  oSetCachedHandles;
+    int            nNextFileId;
 
-    GUIntBig      nCacheUsed;
-    GUIntBig      nCacheMax;
+    VSICacheChunk *poLRUStart;  /* least recently used */
+    VSICacheChunk *poLRUEnd;    /* most recently used */
 
-    size_t        nChunkSize;
+    GUIntBig       nCacheUsed;
+    GUIntBig       nCacheMax;
 
-    VSICacheChunk *poLRUStart;
-    VSICacheChunk *poLRUEnd;
+    void           Unlink( VSICacheChunk * );
+    void           FlushLRU();
+    void           DropFile( int nFileId );
+    void           ForgetFileIdIfUnused( int nFileId );
+    void           DetachFileId( int nFileId );
 
-    std::vector<VSICacheChunk*> apoCache;
+  public:
+                   VSICacheManager();
+                  ~VSICacheManager();
+
+    /* All methods must be called with hCacheMutex held */
+    int            GetFileId( const char* pszFileKey,
+                              const char* pszValidator );
+    void           ReleaseFileId( int nFileId );
+    void           SetCacheMax( GUIntBig nCacheMaxIn ) { nCacheMax = nCacheMaxIn; }
+    VSICacheChunk *Find( int nFileId, vsi_l_offset iBlock );
+    void           Insert( int nFileId, vsi_l_offset iBlock,
+                           const GByte* pabyData, size_t nDataFilled );
+    void           InvalidateFile( const char* pszFilename );
+    void           AddWriteHandle( VSIVirtualHandle* poHandle,
+                                   const char* pszFilename );
+    int            RemoveWriteHandle( VSIVirtualHandle* poHandle,
+                                      CPLString& osFilename );
+    void           AddCachedHandle( VSIVirtualHandle* poHandle )
+                        { oSetCachedHandles.insert( poHandle ); }
+    void           RemoveCachedHandle( VSIVirtualHandle* poHandle )
+                        { oSetCachedHandles.erase( poHandle ); }
+    int            IsCachedHandle( VSIVirtualHandle* poHandle )
+                        { return oSetCachedHandles.find( poHandle ) !=
+                                 oSetCachedHandles.end(); }
+    int            HasCachedHandles() { return !oSetCachedHandles.empty(); }
+};
 
-    int            bEOF;
+static CPLMutex        *hCacheMutex = NULL;
+static VSICacheManager *poCacheManager = NULL;
+/* Read without the mutex to skip the lookup on close in the common case */
+static volatile int     nCacheWriteHandles = 0;
+/* Set by VSICleanupCachedFileManager() while cached handles are open */
+static int              bCacheManagerCleanupPending = FALSE;
 
-    virtual int       Seek( vsi_l_offset nOffset, int nWhence );
-    virtual vsi_l_offset Tell();
-    virtual size_t    Read( void *pBuffer, size_t nSize, size_t nMemb );
-    virtual size_t    Write( const void *pBuffer, size_t nSize, size_t nMemb );
-    virtual int       Eof();
-    virtual int       Flush();
-    virtual int       Close();
-    virtual void     *GetNativeFileDescriptor() { return poBase->GetNativeFileDescriptor(); }
-};
+/************************************************************************/
+/*                          VSICacheManager()                           */
+/************************************************************************/
+
+VSICacheManager::VSICacheManager() :
+    nNextFileId(1), poLRUStart(NULL), poLRUEnd(NULL),
+    nCacheUsed(0), nCacheMax(0)
+{
+}
 
 /************************************************************************/
-/*                           VSICachedFile()                            */
+/*                         ~VSICacheManager()                           */
 /************************************************************************/
 
-VSICachedFile::VSICachedFile( VSIVirtualHandle *poBaseHandle, size_t nChunkSize, size_t nCacheSize )
+VSICacheManager::~VSICacheManager()
+{
+    std::map<VSICacheChunkKey, VSICacheChunk*>::iterator oIter;
+    for( oIter = oMapChunks.begin(); oIter != oMapChunks.end(); ++oIter )
+        delete oIter->second;
+}
 
+/************************************************************************/
+/*                             GetFileId()                              */
+/*                                                                      */
+/*      Return the identifier associated to a file key, or a new        */
+/*      private identifier if pszFileKey is NULL.  The chunks of a      */
+/*      file whose validator changed are discarded.  Each call must     */
+/*      be balanced by a ReleaseFileId().                               */
+/************************************************************************/
+
+int VSICacheManager::GetFileId( const char* pszFileKey,
+                                const char* pszValidator )
 {
-    poBase = poBaseHandle;
-    this->nChunkSize = nChunkSize;
+    if( pszFileKey != NULL )
+    {
+        std::map<CPLString, int>::iterator oIter =
+            oMapFileKeyToId.find( pszFileKey );
+        if( oIter != oMapFileKeyToId.end() )
+        {
+            VSICacheFileInfo& sInfo = oMapFileInfo[oIter->second];
+            if( sInfo.osValidator == pszValidator )
+            {
+                sInfo.nHandles ++;
+                return oIter->second;
+            }
+            DetachFileId( oIter->second );
+        }
+    }
 
-    nCacheUsed = 0;
-    if ( nCacheSize == 0 )
-        nCacheMax = CPLScanUIntBig( 
-             CPLGetConfigOption( "VSI_CACHE_SIZE", "25000000" ), 40 );
-    else
-        nCacheMax = nCacheSize;
+    int nFileId = nNextFileId++;
+    VSICacheFileInfo& sInfo = oMapFileInfo[nFileId];
+    sInfo.nChunks = 0;
+    sInfo.nHandles = 1;
+    if( pszFileKey != NULL )
+    {
+        sInfo.osFileKey = pszFileKey;
+        sInfo.osValidator = pszValidator;
+        oMapFileKeyToId[pszFileKey] = nFileId;
+    }
+    return nFileId;
+}
 
-    poLRUStart = NULL;
-    poLRUEnd = NULL;
+/************************************************************************/
+/*                           ReleaseFileId()                            */
+/*                                                                      */
+/*      Called when a handle is closed.  The chunks of private and      */
+/*      invalidated identifiers are discarded with the last handle.     */
+/************************************************************************/
 
-    poBase->Seek( 0, SEEK_END );
-    nFileSize = poBase->Tell();
+void VSICacheManager::ReleaseFileId( int nFileId )
+{
+    std::map<int, VSICacheFileInfo>::iterator oIter =
+        oMapFileInfo.find( nFileId );
+    if( oIter == oMapFileInfo.end() )
+        return;
 
-    nOffset = 0;
-    bEOF = FALSE;
+    oIter->second.nHandles --;
+    if( oIter->second.nHandles == 0 && oIter->second.osFileKey.size() == 0 )
+        DropFile( nFileId );
+    ForgetFileIdIfUnused( nFileId );
 }
 
 /************************************************************************/
-/*                               Close()                                */
+/*                        ForgetFileIdIfUnused()                        */
 /************************************************************************/
 
-int VSICachedFile::Close()
-
+void VSICacheManager::ForgetFileIdIfUnused( int nFileId )
 {
-    size_t i;
-    for( i = 0; i < apoCache.size(); i++ )
-        delete apoCache[i];
+    std::map<int, VSICacheFileInfo>::iterator oIter =
+        oMapFileInfo.find( nFileId );
+    if( oIter == oMapFileInfo.end() ||
+        oIter->second.nChunks > 0 || oIter->second.nHandles > 0 )
+        return;
 
-    apoCache.resize( 0 );
+    if( oIter->second.osFileKey.size() != 0 )
+        oMapFileKeyToId.erase( oIter->second.osFileKey );
+    oMapFileInfo.erase( oIter );
+}
 
-    poLRUStart = NULL;
-    poLRUEnd = NULL;
+/************************************************************************/
+/*                            DetachFileId()                            */
+/*                                                                      */
+/*      Discard the chunks of a file identifier, and make it private    */
+/*      to the handles still open on it, so that the next open gets     */
+/*      a new identifier.                                               */
+/************************************************************************/
 
-    nCacheUsed = 0;
+void VSICacheManager::DetachFileId( int nFileId )
+{
+    VSICacheFileInfo& sInfo = oMapFileInfo[nFileId];
+    if( sInfo.osFileKey.size() != 0 )
+    {
+        oMapFileKeyToId.erase( sInfo.osFileKey );
+        sInfo.osFileKey.clear();
+    }
+    DropFile( nFileId );
+    ForgetFileIdIfUnused( nFileId );
+}
 
-    if( poBase )
+/************************************************************************/
+/*                           InvalidateFile()                           */
+/*                                                                      */
+/*      Discard the chunks of a file, whatever the chunk size it was    */
+/*      opened with.                                                    */
+/************************************************************************/
+
+void VSICacheManager::InvalidateFile( const char* pszFilename )
+{
+    CPLString osPrefix( pszFilename );
+    osPrefix += "|";
+
+    std::map<CPLString, int>::iterator oIter =
+        oMapFileKeyToId.lower_bound( osPrefix );
+    while( oIter != oMapFileKeyToId.end() &&
+           strncmp( oIter->first.c_str(), osPrefix.c_str(),
+                    osPrefix.size() ) == 0 )
     {
-        poBase->Close();
-        delete poBase;
-        poBase = NULL;
+        int nFileId = oIter->second;
+        ++oIter;
+        DetachFileId( nFileId );
     }
+}
 
-    return 0;
+/************************************************************************/
+/*                           AddWriteHandle()                           */
+/************************************************************************/
+
+void VSICacheManager::AddWriteHandle( VSIVirtualHandle* poHandle,
+                                      const char* pszFilename )
+{
+    oMapWriteHandles[poHandle] = pszFilename;
+    nCacheWriteHandles = (int) oMapWriteHandles.size();
 }
 
 /************************************************************************/
-/*                                Seek()                                */
+/*                         RemoveWriteHandle()                          */
 /************************************************************************/
 
-int VSICachedFile::Seek( vsi_l_offset nReqOffset, int nWhence )
+int VSICacheManager::RemoveWriteHandle( VSIVirtualHandle* poHandle,
+                                        CPLString& osFilename )
+{
+    std::map<VSIVirtualHandle*, CPLString>::iterator oIter =
+        oMapWriteHandles.find( poHandle );
+    if( oIter == oMapWriteHandles.end() )
+        return FALSE;
+
+    osFilename = oIter->second;
+    oMapWriteHandles.erase( oIter );
+    nCacheWriteHandles = (int) oMapWriteHandles.size();
+    return TRUE;
+}
 
+/************************************************************************/
+/*                               Unlink()                               */
+/*                                                                      */
+/*      Remove the chunk from the LRU list.                             */
+/************************************************************************/
+
+void VSICacheManager::Unlink( VSICacheChunk *poBlock )
 {
-    bEOF = FALSE;
+    if( poLRUStart == poBlock )
+        poLRUStart = poBlock->poLRUNext;
+    if( poLRUEnd == poBlock )
+        poLRUEnd = poBlock->poLRUPrev;
 
-    if( nWhence == SEEK_SET )
-    {
-        // use offset directly.
-    }
+    if( poBlock->poLRUPrev != NULL )
+        poBlock->poLRUPrev->poLRUNext = poBlock->poLRUNext;
+    if( poBlock->poLRUNext != NULL )
+        poBlock->poLRUNext->poLRUPrev = poBlock->poLRUPrev;
 
-    else if( nWhence == SEEK_CUR )
-    {
-        nReqOffset += nOffset;
-    }
+    poBlock->poLRUNext = NULL;
+    poBlock->poLRUPrev = NULL;
+}
 
-    else if( nWhence == SEEK_END )
+/************************************************************************/
+/*                                Find()                                */
+/*                                                                      */
+/*      Find a chunk, and promote it to the most recently used          */
+/*      position.                                                       */
+/************************************************************************/
+
+VSICacheChunk *VSICacheManager::Find( int nFileId, vsi_l_offset iBlock )
+{
+    std::map<VSICacheChunkKey, VSICacheChunk*>::iterator oIter =
+        oMapChunks.find( VSICacheChunkKey(nFileId, iBlock) );
+    if( oIter == oMapChunks.end() )
+        return NULL;
+
+    VSICacheChunk *poBlock = oIter->second;
+    if( poLRUEnd != poBlock )
     {
-        nReqOffset += nFileSize;
+        Unlink( poBlock );
+
+        poBlock->poLRUPrev = poLRUEnd;
+        if( poLRUEnd != NULL )
+            poLRUEnd->poLRUNext = poBlock;
+        poLRUEnd = poBlock;
+        if( poLRUStart == NULL )
+            poLRUStart = poBlock;
     }
 
-    nOffset = nReqOffset;
-
-    return 0;
+    return poBlock;
 }
 
 /************************************************************************/
-/*                                Tell()                                */
+/*                               Insert()                               */
 /************************************************************************/
 
-vsi_l_offset VSICachedFile::Tell()
-
+void VSICacheManager::Insert( int nFileId, vsi_l_offset iBlock,
+                              const GByte* pabyData, size_t nDataFilled )
 {
-    return nOffset;
+    /* May have been loaded in the mean time by another handle */
+    if( Find( nFileId, iBlock ) != NULL )
+        return;
+
+    VSICacheChunk *poBlock = new VSICacheChunk();
+    if( !poBlock->Allocate( nDataFilled ) )
+    {
+        delete poBlock;
+        return;
+    }
+
+    poBlock->nFileId = nFileId;
+    poBlock->iBlock = iBlock;
+    poBlock->nDataFilled = nDataFilled;
+    if( nDataFilled )
+        memcpy( poBlock->pabyData, pabyData, nDataFilled );
+
+    oMapChunks[VSICacheChunkKey(nFileId, iBlock)] = poBlock;
+    oMapFileInfo[nFileId].nChunks ++;
+
+    poBlock->poLRUPrev = poLRUEnd;
+    if( poLRUEnd != NULL )
+        poLRUEnd->poLRUNext = poBlock;
+    poLRUEnd = poBlock;
+    if( poLRUStart == NULL )
+        poLRUStart = poBlock;
+
+    nCacheUsed += nDataFilled;
+
+/* -------------------------------------------------------------------- */
+/*      Ensure the cache is reduced to our limit, but always keep the   */
+/*      chunk we just inserted.                                         */
+/* -------------------------------------------------------------------- */
+    while( nCacheUsed > nCacheMax && poLRUStart != poBlock )
+        FlushLRU();
 }
 
 /************************************************************************/
 /*                              FlushLRU()                              */
 /************************************************************************/
 
-void VSICachedFile::FlushLRU()
+void VSICacheManager::FlushLRU()
 
 {
     CPLAssert( poLRUStart != NULL );
@@ -225,167 +457,200 @@ void VSICachedFile::FlushLRU()
     CPLAssert( nCacheUsed >= poBlock->nDataFilled );
 
     nCacheUsed -= poBlock->nDataFilled;
-    
-    poLRUStart = poBlock->poLRUNext;
-    if( poLRUEnd == poBlock )
-        poLRUEnd = NULL;
-
-    if( poBlock->poLRUNext != NULL )
-        poBlock->poLRUNext->poLRUPrev = NULL;
-
-    CPLAssert( !poBlock->bDirty );
 
-    apoCache[poBlock->iBlock] = NULL;
+    Unlink( poBlock );
+    oMapChunks.erase( VSICacheChunkKey(poBlock->nFileId, poBlock->iBlock) );
 
+    const int nFileId = poBlock->nFileId;
     delete poBlock;
+
+    oMapFileInfo[nFileId].nChunks --;
+    ForgetFileIdIfUnused( nFileId );
 }
 
 /************************************************************************/
-/*                               Demote()                               */
+/*                              DropFile()                              */
 /*                                                                      */
-/*      Demote the indicated block to the end of the LRU list.          */
-/*      Potentially integrate the link into the list if it is not       */
-/*      already there.                                                  */
+/*      Discard all the chunks of a file.                               */
 /************************************************************************/
 
-void VSICachedFile::Demote( VSICacheChunk *poBlock )
-
+void VSICacheManager::DropFile( int nFileId )
 {
-    // already at end?
-    if( poLRUEnd == poBlock )
-        return;
+    std::map<VSICacheChunkKey, VSICacheChunk*>::iterator oIter =
+        oMapChunks.lower_bound( VSICacheChunkKey(nFileId, 0) );
+    while( oIter != oMapChunks.end() && oIter->first.first == nFileId )
+    {
+        VSICacheChunk *poBlock = oIter->second;
+        nCacheUsed -= poBlock->nDataFilled;
+        Unlink( poBlock );
+        oMapChunks.erase( oIter++ );
+        delete poBlock;
+    }
+    oMapFileInfo[nFileId].nChunks = 0;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                             VSICachedFile                            */
+/* ==================================================================== */
+/************************************************************************/
+
+class VSICachedFile : public VSIVirtualHandle
+{ 
+  public:
+    VSICachedFile( VSIVirtualHandle *poBaseHandle, 
+                   const char* pszFilename,
+                   size_t nChunkSize,
+                   int nMaxReadAhead );
+    ~VSICachedFile() { Close(); }
+
+    VSIVirtualHandle *poBase;
     
-    if( poLRUStart == poBlock )
-        poLRUStart = poBlock->poLRUNext;
+    int           nFileId;
 
-    if( poBlock->poLRUPrev != NULL )
-        poBlock->poLRUPrev->poLRUNext = poBlock->poLRUNext;
+    vsi_l_offset  nOffset;
+    vsi_l_offset  nFileSize;
+    int           bFileSizeKnown;
 
-    if( poBlock->poLRUNext != NULL )
-        poBlock->poLRUNext->poLRUPrev = poBlock->poLRUPrev;
+    size_t        nChunkSize;
 
-    poBlock->poLRUNext = NULL;
-    poBlock->poLRUPrev = NULL;
+    /* Adaptive read-ahead, in chunks */
+    int           nMaxReadAhead;
+    int           nReadAhead;
+    vsi_l_offset  nLastReadEnd;
 
-    if( poLRUEnd != NULL )
-        poLRUEnd->poLRUNext = poBlock;
-    poLRUEnd = poBlock;
-    
-    if( poLRUStart == NULL )
-        poLRUStart = poBlock;
-}
+    int           bEOF;
+
+    virtual int       Seek( vsi_l_offset nOffset, int nWhence );
+    virtual vsi_l_offset Tell();
+    virtual size_t    Read( void *pBuffer, size_t nSize, size_t nMemb );
+    virtual size_t    Write( const void *pBuffer, size_t nSize, size_t nMemb );
+    virtual int       Eof();
+    virtual int       Flush();
+    virtual int       Close();
+    virtual void     *GetNativeFileDescriptor() { return poBase->GetNativeFileDescriptor(); }
+    virtual const void *GetRangePointer( vsi_l_offset nOffset, size_t nSize )
+                        { return poBase->GetRangePointer( nOffset, nSize ); }
+};
 
 /************************************************************************/
-/*                             LoadBlocks()                             */
-/*                                                                      */
-/*      Load the desired set of blocks.  Use pBuffer as a temporary     */
-/*      buffer if it would be helpful.                                  */
+/*                           VSICachedFile()                            */
 /************************************************************************/
 
-int VSICachedFile::LoadBlocks( vsi_l_offset nStartBlock, size_t nBlockCount,
-                               void *pBuffer, size_t nBufferSize )
+VSICachedFile::VSICachedFile( VSIVirtualHandle *poBaseHandle,
+                              const char* pszFilename,
+                              size_t nChunkSizeIn, int nMaxReadAheadIn )
 
 {
-    if( nBlockCount == 0 )
-        return 1;
+    poBase = poBaseHandle;
+    nChunkSize = nChunkSizeIn;
+    nMaxReadAhead = nMaxReadAheadIn;
+    nReadAhead = 0;
+    nLastReadEnd = 0;
 
-    if( apoCache.size() < nStartBlock + nBlockCount )
-        apoCache.resize( nStartBlock + nBlockCount );
+    nOffset = 0;
+    nFileSize = 0;
+    bFileSizeKnown = FALSE;
+    bEOF = FALSE;
 
 /* -------------------------------------------------------------------- */
-/*      When we want to load only one block, we can directly load it    */
-/*      into the target buffer with no concern about intermediaries.    */
+/*      Build the key under which the chunks of this file are shared.   */
 /* -------------------------------------------------------------------- */
-    if( nBlockCount == 1 )
+    CPLString osFileKey, osValidator;
+    VSIStatBufL sStat;
+    if( pszFilename != NULL && VSIStatL( pszFilename, &sStat ) == 0 )
     {
-        poBase->Seek( (vsi_l_offset)nStartBlock * nChunkSize, SEEK_SET );
+        osFileKey.Printf( "%s|%d", pszFilename, (int) nChunkSize );
+        osValidator.Printf( CPL_FRMT_GUIB "|" CPL_FRMT_GIB,
+                            (GUIntBig) sStat.st_size,
+                            (GIntBig) sStat.st_mtime );
+    }
 
-        VSICacheChunk *poBlock = new VSICacheChunk();
-        if ( !poBlock || !poBlock->Allocate( nChunkSize ) )
-        {
-            delete poBlock;
-            return 0;
-        }
+    CPLMutexHolderD( &hCacheMutex );
 
-        apoCache[nStartBlock] = poBlock;
+    if( poCacheManager == NULL )
+        poCacheManager = new VSICacheManager();
+    poCacheManager->SetCacheMax( CPLScanUIntBig( 
+             CPLGetConfigOption( "VSI_CACHE_SIZE", "25000000" ), 40 ) );
 
-        poBlock->iBlock = nStartBlock;
-        poBlock->nDataFilled = poBase->Read( poBlock->pabyData, 1, nChunkSize );
-        nCacheUsed += poBlock->nDataFilled;
+    nFileId = poCacheManager->GetFileId(
+        osFileKey.size() ? osFileKey.c_str() : NULL, osValidator.c_str() );
+    poCacheManager->AddCachedHandle( this );
+}
 
-        // Merges into the LRU list. 
-        Demote( poBlock );
+/************************************************************************/
+/*                               Close()                                */
+/************************************************************************/
 
-        return 1;
-    }
+int VSICachedFile::Close()
 
-/* -------------------------------------------------------------------- */
-/*      If the buffer is quite large but not quite large enough to      */
-/*      hold all the blocks we will take the pain of splitting the      */
-/*      io request in two in order to avoid allocating a large          */
-/*      temporary buffer.                                               */
-/* -------------------------------------------------------------------- */
-    if( nBufferSize > nChunkSize * 20 
-        && nBufferSize < nBlockCount * nChunkSize )
+{
+    if( poBase )
     {
-        if( !LoadBlocks( nStartBlock, 2, pBuffer, nBufferSize ) )
-            return 0;
+        poBase->Close();
+        delete poBase;
+        poBase = NULL;
 
-        return LoadBlocks( nStartBlock+2, nBlockCount-2, pBuffer, nBufferSize );
+        CPLMutexHolderD( &hCacheMutex );
+        poCacheManager->ReleaseFileId( nFileId );
+        poCacheManager->RemoveCachedHandle( this );
+        if( bCacheManagerCleanupPending &&
+            !poCacheManager->HasCachedHandles() )
+        {
+            delete poCacheManager;
+            poCacheManager = NULL;
+            bCacheManagerCleanupPending = FALSE;
+        }
     }
 
-/* -------------------------------------------------------------------- */
-/*      Do we need to allocate our own buffer?                          */
-/* -------------------------------------------------------------------- */
-    GByte *pabyWorkBuffer = (GByte *) pBuffer;
+    return 0;
+}
 
-    if( nBufferSize < nChunkSize * nBlockCount )
-        pabyWorkBuffer = (GByte *) CPLMalloc(nChunkSize * nBlockCount);
+/************************************************************************/
+/*                                Seek()                                */
+/************************************************************************/
 
-/* -------------------------------------------------------------------- */
-/*      Read the whole request into the working buffer.                 */
-/* -------------------------------------------------------------------- */
-    if( poBase->Seek( (vsi_l_offset)nStartBlock * nChunkSize, SEEK_SET ) != 0 )
-        return 0;
+int VSICachedFile::Seek( vsi_l_offset nReqOffset, int nWhence )
 
-    size_t nDataRead = poBase->Read( pabyWorkBuffer, 1, nBlockCount*nChunkSize);
+{
+    bEOF = FALSE;
+
+    if( nWhence == SEEK_SET )
+    {
+        // use offset directly.
+    }
 
-    if( nBlockCount * nChunkSize > nDataRead + nChunkSize - 1 )
-        nBlockCount = (nDataRead + nChunkSize - 1) / nChunkSize;
+    else if( nWhence == SEEK_CUR )
+    {
+        nReqOffset += nOffset;
+    }
 
-    for( size_t i = 0; i < nBlockCount; i++ )
+    else if( nWhence == SEEK_END )
     {
-        VSICacheChunk *poBlock = new VSICacheChunk();
-        if ( !poBlock || !poBlock->Allocate( nChunkSize ) )
+        /* Only compute the file size when needed, as it can be */
+        /* expensive on compressed or streamed files */
+        if( !bFileSizeKnown )
         {
-            delete poBlock;
-            return 0;
+            poBase->Seek( 0, SEEK_END );
+            nFileSize = poBase->Tell();
+            bFileSizeKnown = TRUE;
         }
+        nReqOffset += nFileSize;
+    }
 
-        poBlock->iBlock = nStartBlock + i;
-
-        CPLAssert( apoCache[i+nStartBlock] == NULL );
-
-        apoCache[i + nStartBlock] = poBlock;
-
-        if( nDataRead >= (i+1) * nChunkSize )
-            poBlock->nDataFilled = nChunkSize;
-        else
-            poBlock->nDataFilled = nDataRead - i*nChunkSize;
-
-        memcpy( poBlock->pabyData, pabyWorkBuffer + i*nChunkSize,
-                (size_t) poBlock->nDataFilled );
+    nOffset = nReqOffset;
 
-        nCacheUsed += poBlock->nDataFilled;
+    return 0;
+}
 
-        // Merges into the LRU list. 
-        Demote( poBlock );
-    }
+/************************************************************************/
+/*                                Tell()                                */
+/************************************************************************/
 
-    if( pabyWorkBuffer != pBuffer )
-        CPLFree( pabyWorkBuffer );
+vsi_l_offset VSICachedFile::Tell()
 
-    return 1;
+{
+    return nOffset;
 }
 
 /************************************************************************/
@@ -395,78 +660,113 @@ int VSICachedFile::LoadBlocks( vsi_l_offset nStartBlock, size_t nBlockCount,
 size_t VSICachedFile::Read( void * pBuffer, size_t nSize, size_t nCount )
 
 {
-    if( nOffset >= nFileSize )
-    {
-        bEOF = TRUE;
+    const size_t nToRead = nSize * nCount;
+    if( nToRead == 0 )
         return 0;
-    }
-
-/* ==================================================================== */
-/*      Make sure the cache is loaded for the whole request region.     */
-/* ==================================================================== */
-    vsi_l_offset nStartBlock = nOffset / nChunkSize;
-    vsi_l_offset nEndBlock = (nOffset + nSize * nCount - 1) / nChunkSize;
 
-    for( vsi_l_offset iBlock = nStartBlock; iBlock <= nEndBlock; iBlock++ )
+/* -------------------------------------------------------------------- */
+/*      Adapt the read-ahead window: double it while reads are          */
+/*      sequential, and cancel it on random access.                     */
+/* -------------------------------------------------------------------- */
+    if( nOffset == nLastReadEnd && nOffset != 0 )
     {
-        if( apoCache.size() <= iBlock || apoCache[iBlock] == NULL )
-        {
-            size_t nBlocksToLoad = 1;
-            while( iBlock + nBlocksToLoad <= nEndBlock
-                   && (apoCache.size() <= iBlock+nBlocksToLoad 
-                       || apoCache[iBlock+nBlocksToLoad] == NULL) )
-                nBlocksToLoad++;
-
-            LoadBlocks( iBlock, nBlocksToLoad, pBuffer, nSize * nCount );
-        }
+        if( nReadAhead == 0 )
+            nReadAhead = 1;
+        else if( nReadAhead < nMaxReadAhead )
+            nReadAhead = MIN(nReadAhead * 2, nMaxReadAhead);
     }
-    
-/* ==================================================================== */
-/*      Copy data into the target buffer to the extent possible.        */
-/* ==================================================================== */
+    else
+        nReadAhead = 0;
+
     size_t nAmountCopied = 0;
 
-    while( nAmountCopied < nSize * nCount )
+    while( nAmountCopied < nToRead )
     {
-        vsi_l_offset iBlock = (nOffset + nAmountCopied) / nChunkSize;
-        size_t nThisCopy;
-        VSICacheChunk *poBlock = apoCache[iBlock];
-        if( poBlock == NULL )
+        const vsi_l_offset nCurOffset = nOffset + nAmountCopied;
+        const vsi_l_offset iBlock = nCurOffset / nChunkSize;
+        const size_t nOffsetInBlock =
+            (size_t)(nCurOffset - iBlock * nChunkSize);
+
+/* -------------------------------------------------------------------- */
+/*      Copy from the cache if the chunk is already loaded.             */
+/* -------------------------------------------------------------------- */
         {
-            /* We can reach that point when the amount to read exceeds */
-            /* the cache size */
-            LoadBlocks( iBlock, 1, ((GByte *) pBuffer) + nAmountCopied,
-                        MIN(nSize * nCount - nAmountCopied, nChunkSize) );
-            poBlock = apoCache[iBlock];
-            CPLAssert(poBlock != NULL);
+            CPLMutexHolderD( &hCacheMutex );
+
+            VSICacheChunk *poBlock = poCacheManager->Find( nFileId, iBlock );
+            if( poBlock != NULL )
+            {
+                if( nOffsetInBlock >= poBlock->nDataFilled )
+                    break;
+
+                size_t nThisCopy = MIN( poBlock->nDataFilled - nOffsetInBlock,
+                                        nToRead - nAmountCopied );
+                memcpy( ((GByte *) pBuffer) + nAmountCopied,
+                        poBlock->pabyData + nOffsetInBlock, nThisCopy );
+                nAmountCopied += nThisCopy;
+
+                if( poBlock->nDataFilled < nChunkSize )
+                    break;
+                continue;
+            }
         }
 
-        vsi_l_offset nStartOffset = (vsi_l_offset)iBlock * nChunkSize;
-        nThisCopy = (size_t)
-            ((nStartOffset + poBlock->nDataFilled) 
-             - nAmountCopied - nOffset);
-        
-        if( nThisCopy > nSize * nCount - nAmountCopied )
-            nThisCopy = nSize * nCount - nAmountCopied;
+/* -------------------------------------------------------------------- */
+/*      Otherwise load this chunk, the following missing chunks of      */
+/*      the request and the read-ahead window in a single request.      */
+/* -------------------------------------------------------------------- */
+        const vsi_l_offset nEndBlock =
+            (nOffset + nToRead - 1) / nChunkSize + nReadAhead;
+        size_t nBlocksToLoad = 1;
+        {
+            CPLMutexHolderD( &hCacheMutex );
+            while( iBlock + nBlocksToLoad <= nEndBlock &&
+                   poCacheManager->Find( nFileId,
+                                         iBlock + nBlocksToLoad ) == NULL )
+                nBlocksToLoad++;
+        }
 
-        if( nThisCopy == 0 )
+        GByte *pabyWorkBuffer = (GByte *)
+            VSIMalloc2( nBlocksToLoad, nChunkSize );
+        if( pabyWorkBuffer == NULL )
             break;
 
-        memcpy( ((GByte *) pBuffer) + nAmountCopied,
-                poBlock->pabyData 
-                + (nOffset + nAmountCopied) - nStartOffset, 
-                nThisCopy );
+        size_t nDataRead = 0;
+        if( poBase->Seek( iBlock * nChunkSize, SEEK_SET ) == 0 )
+            nDataRead = poBase->Read( pabyWorkBuffer, 1,
+                                      nBlocksToLoad * nChunkSize );
+
+        {
+            CPLMutexHolderD( &hCacheMutex );
+            for( size_t i = 0; i < nBlocksToLoad; i++ )
+            {
+                size_t nDataFilled = 0;
+                if( nDataRead > i * nChunkSize )
+                    nDataFilled = MIN( nDataRead - i * nChunkSize, nChunkSize );
+                else if( i > 0 )
+                    break;
+                poCacheManager->Insert( nFileId, iBlock + i,
+                                        pabyWorkBuffer + i * nChunkSize,
+                                        nDataFilled );
+            }
+        }
 
+        size_t nThisCopy = 0;
+        if( nDataRead > nOffsetInBlock )
+            nThisCopy = MIN( nDataRead - nOffsetInBlock,
+                             nToRead - nAmountCopied );
+        memcpy( ((GByte *) pBuffer) + nAmountCopied,
+                pabyWorkBuffer + nOffsetInBlock, nThisCopy );
         nAmountCopied += nThisCopy;
+
+        CPLFree( pabyWorkBuffer );
+
+        if( nDataRead < nBlocksToLoad * nChunkSize )
+            break;
     }
-    
-    nOffset += nAmountCopied;
 
-/* -------------------------------------------------------------------- */
-/*      Ensure the cache is reduced to our limit.                       */
-/* -------------------------------------------------------------------- */
-    while( nCacheUsed > nCacheMax )
-        FlushLRU();
+    nOffset += nAmountCopied;
+    nLastReadEnd = nOffset;
 
     size_t nRet = nAmountCopied / nSize;
     if (nRet != nCount)
@@ -505,13 +805,198 @@ int VSICachedFile::Flush()
     return 0;
 }
 
+/************************************************************************/
+/*                         VSIGetCacheOptions()                         */
+/*                                                                      */
+/*      Determine whether a file opened in read-only mode should go     */
+/*      through the cache, and with which chunk size and maximum        */
+/*      read-ahead.                                                     */
+/*                                                                      */
+/*      VSI_CACHE_PREFIX_OPTIONS can be set to a semicolon separated    */
+/*      list of "prefix [CHUNK_SIZE=bytes] [READ_AHEAD=chunks]"         */
+/*      entries, which enable the cache for files starting with the     */
+/*      prefix (longest prefix wins).  Otherwise, if VSI_CACHE is set,  */
+/*      all files except those of in-memory and streamed file systems   */
+/*      are cached with the VSI_CACHE_CHUNK_SIZE and                    */
+/*      VSI_CACHE_READ_AHEAD settings.                                  */
+/************************************************************************/
+
+int VSIGetCacheOptions( const char* pszFilename,
+                        size_t* pnChunkSize, int* pnMaxReadAhead )
+
+{
+    int bCache = FALSE;
+    int nChunkSize = atoi( CPLGetConfigOption( "VSI_CACHE_CHUNK_SIZE",
+                                CPLSPrintf("%d", VSI_CACHE_DEFAULT_CHUNK_SIZE) ) );
+    int nMaxReadAhead = atoi( CPLGetConfigOption( "VSI_CACHE_READ_AHEAD",
+                                CPLSPrintf("%d", VSI_CACHE_DEFAULT_READ_AHEAD) ) );
+
+    const char* pszPrefixOptions =
+        CPLGetConfigOption( "VSI_CACHE_PREFIX_OPTIONS", NULL );
+    if( pszPrefixOptions != NULL )
+    {
+        char** papszEntries = CSLTokenizeString2( pszPrefixOptions, ";", 0 );
+        size_t nBestPrefixLen = 0;
+        for( int i = 0; papszEntries != NULL && papszEntries[i] != NULL; i++ )
+        {
+            char** papszTokens = CSLTokenizeString2( papszEntries[i], " ",
+                                                     CSLT_HONOURSTRINGS );
+            if( CSLCount(papszTokens) >= 1 )
+            {
+                const size_t nPrefixLen = strlen(papszTokens[0]);
+                if( nPrefixLen > nBestPrefixLen &&
+                    strncmp( pszFilename, papszTokens[0], nPrefixLen ) == 0 )
+                {
+                    nBestPrefixLen = nPrefixLen;
+                    bCache = TRUE;
+                    const char* pszValue =
+                        CSLFetchNameValue( papszTokens + 1, "CHUNK_SIZE" );
+                    if( pszValue != NULL )
+                        nChunkSize = atoi(pszValue);
+                    pszValue = CSLFetchNameValue( papszTokens + 1, "READ_AHEAD" );
+                    if( pszValue != NULL )
+                        nMaxReadAhead = atoi(pszValue);
+                }
+            }
+            CSLDestroy( papszTokens );
+        }
+        CSLDestroy( papszEntries );
+    }
+
+    if( !bCache &&
+        CSLTestBoolean( CPLGetConfigOption( "VSI_CACHE", "FALSE" ) ) &&
+        strncmp( pszFilename, "/vsimem/", strlen("/vsimem/") ) != 0 &&
+        strncmp( pszFilename, "/vsistdin/", strlen("/vsistdin/") ) != 0 &&
+        strncmp( pszFilename, "/vsistdout/", strlen("/vsistdout/") ) != 0 )
+    {
+        bCache = TRUE;
+    }
+
+    if( nChunkSize <= 0 || nChunkSize > 100 * 1024 * 1024 )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "Invalid cache chunk size %d. Using %d instead",
+                  nChunkSize, VSI_CACHE_DEFAULT_CHUNK_SIZE );
+        nChunkSize = VSI_CACHE_DEFAULT_CHUNK_SIZE;
+    }
+    if( nMaxReadAhead < 0 )
+        nMaxReadAhead = 0;
+
+    *pnChunkSize = nChunkSize;
+    *pnMaxReadAhead = nMaxReadAhead;
+    return bCache;
+}
+
 /************************************************************************/
 /*                        VSICreateCachedFile()                         */
 /************************************************************************/
 
 VSIVirtualHandle *
-VSICreateCachedFile( VSIVirtualHandle *poBaseHandle, size_t nChunkSize, size_t nCacheSize )
+VSICreateCachedFile( VSIVirtualHandle *poBaseHandle, const char* pszFilename,
+                     size_t nChunkSize, int nMaxReadAhead )
+
+{
+    /* Do not cache an already cached handle a second time */
+    if( poCacheManager != NULL )
+    {
+        CPLMutexHolderD( &hCacheMutex );
+        if( poCacheManager != NULL &&
+            poCacheManager->IsCachedHandle( poBaseHandle ) )
+            return poBaseHandle;
+    }
+
+    if( nChunkSize == 0 )
+        nChunkSize = VSI_CACHE_DEFAULT_CHUNK_SIZE;
+    if( nMaxReadAhead < 0 )
+        nMaxReadAhead = VSI_CACHE_DEFAULT_READ_AHEAD;
+    return new VSICachedFile( poBaseHandle, pszFilename, nChunkSize,
+                              nMaxReadAhead );
+}
+
+/************************************************************************/
+/*                       VSICacheInvalidateFile()                       */
+/*                                                                      */
+/*      Discard the cached chunks of a file, which is about to be       */
+/*      modified, unlinked or renamed by this process.                  */
+/************************************************************************/
+
+void VSICacheInvalidateFile( const char* pszFilename )
+
+{
+    if( poCacheManager == NULL )
+        return;
+
+    CPLMutexHolderD( &hCacheMutex );
+    if( poCacheManager != NULL )
+        poCacheManager->InvalidateFile( pszFilename );
+}
+
+/************************************************************************/
+/*                      VSICacheNotifyWriteOpen()                       */
+/*                                                                      */
+/*      Called for a file opened in another mode than read-only.  Its   */
+/*      cached chunks are discarded now, and again when the handle is   */
+/*      closed, so that reads done in between are not kept either.      */
+/************************************************************************/
+
+void VSICacheNotifyWriteOpen( VSIVirtualHandle* poHandle,
+                              const char* pszFilename )
+
+{
+    if( poCacheManager == NULL )
+        return;
+
+    CPLMutexHolderD( &hCacheMutex );
+    if( poCacheManager != NULL )
+    {
+        poCacheManager->InvalidateFile( pszFilename );
+        poCacheManager->AddWriteHandle( poHandle, pszFilename );
+    }
+}
+
+/************************************************************************/
+/*                        VSICacheNotifyClose()                         */
+/************************************************************************/
+
+void VSICacheNotifyClose( VSIVirtualHandle* poHandle )
 
 {
-    return new VSICachedFile( poBaseHandle, nChunkSize, nCacheSize );
+    if( nCacheWriteHandles == 0 )
+        return;
+
+    CPLMutexHolderD( &hCacheMutex );
+    CPLString osFilename;
+    if( poCacheManager != NULL &&
+        poCacheManager->RemoveWriteHandle( poHandle, osFilename ) )
+        poCacheManager->InvalidateFile( osFilename );
+}
+
+/************************************************************************/
+/*                     VSICleanupCachedFileManager()                    */
+/*                                                                      */
+/*      If cached handles are still open, the manager they use is       */
+/*      only deleted when the last one is closed.                       */
+/************************************************************************/
+
+void VSICleanupCachedFileManager()
+
+{
+    if( poCacheManager != NULL )
+    {
+        CPLMutexHolderD( &hCacheMutex );
+        if( poCacheManager->HasCachedHandles() )
+        {
+            bCacheManagerCleanupPending = TRUE;
+            return;
+        }
+        delete poCacheManager;
+        poCacheManager = NULL;
+    }
+    nCacheWriteHandles = 0;
+
+    if( hCacheMutex != NULL )
+    {
+        CPLDestroyMutex( hCacheMutex );
+        hCacheMutex = NULL;
+    }
 }
@@ -286,6 +286,8 @@ class VSICurlHandle : public VSIVirtualHandle
     virtual size_t       Read( void *pBuffer, size_t nSize, size_t nMemb );
     virtual int          ReadMultiRange( int nRanges, void ** ppData,
                                          const vsi_l_offset* panOffsets, const size_t* panSizes );
+    virtual int          HasPRead() { return TRUE; }
+    virtual size_t       PRead( void *pBuffer, size_t nSize, vsi_l_offset nOffset );
     virtual size_t       Write( const void *pBuffer, size_t nSize, size_t nMemb );
     virtual int          Eof();
     virtual int          Flush();
@@ -1396,6 +1398,93 @@ end:
     return nRet;
 }
 
+/************************************************************************/
+/*                               PRead()                                */
+/*                                                                      */
+/*      Issue a single range request with the connection of the         */
+/*      calling thread. The state of the handle (current offset,        */
+/*      read-ahead heuristics) is left untouched, so that several       */
+/*      threads can use this method concurrently on the same handle.    */
+/************************************************************************/
+
+size_t VSICurlHandle::PRead( void *pBuffer, size_t nSize,
+                             vsi_l_offset nOffset )
+{
+    WriteFuncStruct sWriteFuncData;
+    WriteFuncStruct sWriteFuncHeaderData;
+
+    if (nSize == 0)
+        return 0;
+
+    CachedFileProp* cachedFileProp = poFS->GetCachedFileProp(pszURL);
+    if (cachedFileProp->eExists == EXIST_NO)
+        return 0;
+
+    vsi_l_offset nEndOffset = nOffset + nSize - 1;
+    if( cachedFileProp->bHastComputedFileSize )
+    {
+        if( nOffset >= cachedFileProp->fileSize )
+            return 0;
+        if( nEndOffset >= cachedFileProp->fileSize )
+            nEndOffset = cachedFileProp->fileSize - 1;
+    }
+
+    CURL* hCurlHandle = poFS->GetCurlHandleFor(pszURL);
+    VSICurlSetOptions(hCurlHandle, pszURL);
+
+    VSICURLInitWriteFuncStruct(&sWriteFuncData, NULL, NULL, NULL);
+    curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA, &sWriteFuncData);
+    curl_easy_setopt(hCurlHandle, CURLOPT_WRITEFUNCTION, VSICurlHandleWriteFunc);
+
+    VSICURLInitWriteFuncStruct(&sWriteFuncHeaderData, NULL, NULL, NULL);
+    curl_easy_setopt(hCurlHandle, CURLOPT_HEADERDATA, &sWriteFuncHeaderData);
+    curl_easy_setopt(hCurlHandle, CURLOPT_HEADERFUNCTION, VSICurlHandleWriteFunc);
+    sWriteFuncHeaderData.bIsHTTP = strncmp(pszURL, "http", 4) == 0;
+    sWriteFuncHeaderData.nStartOffset = nOffset;
+    sWriteFuncHeaderData.nEndOffset = nEndOffset;
+
+    char rangeStr[512];
+    sprintf(rangeStr, CPL_FRMT_GUIB "-" CPL_FRMT_GUIB, nOffset, nEndOffset);
+
+    if (ENABLE_DEBUG)
+        CPLDebug("VSICURL", "Downloading %s (%s)...", rangeStr, pszURL);
+
+    curl_easy_setopt(hCurlHandle, CURLOPT_RANGE, rangeStr);
+
+    char szCurlErrBuf[CURL_ERROR_SIZE+1];
+    szCurlErrBuf[0] = '\0';
+    curl_easy_setopt(hCurlHandle, CURLOPT_ERRORBUFFER, szCurlErrBuf );
+
+    curl_easy_perform(hCurlHandle);
+
+    curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA, NULL);
+    curl_easy_setopt(hCurlHandle, CURLOPT_WRITEFUNCTION, NULL);
+    curl_easy_setopt(hCurlHandle, CURLOPT_HEADERDATA, NULL);
+    curl_easy_setopt(hCurlHandle, CURLOPT_HEADERFUNCTION, NULL);
+
+    long response_code = 0;
+    curl_easy_getinfo(hCurlHandle, CURLINFO_HTTP_CODE, &response_code);
+
+    size_t nRet = 0;
+    if ((response_code != 200 && response_code != 206 &&
+         response_code != 225 && response_code != 226 && response_code != 426) || sWriteFuncHeaderData.bError)
+    {
+        if (response_code >= 400 && szCurlErrBuf[0] != '\0')
+            CPLError(CE_Failure, CPLE_AppDefined, "%d: %s", (int)response_code, szCurlErrBuf);
+    }
+    else
+    {
+        nRet = MIN(nSize, sWriteFuncData.nSize);
+        if( nRet )
+            memcpy(pBuffer, sWriteFuncData.pBuffer, nRet);
+    }
+
+    CPLFree(sWriteFuncData.pBuffer);
+    CPLFree(sWriteFuncHeaderData.pBuffer);
+
+    return nRet;
+}
+
 /************************************************************************/
 /*                               Write()                                */
 /************************************************************************/
@@ -1779,10 +1868,7 @@ VSIVirtualHandle* VSICurlFilesystemHandler::Open( const char *pszFilename,
         }
     }
 
-    if( CSLTestBoolean( CPLGetConfigOption( "VSI_CACHE", "FALSE" ) ) )
-        return VSICreateCachedFile( poHandle );
-    else
-        return poHandle;
+    return poHandle;
 }
 
 /************************************************************************/
@@ -1397,10 +1397,7 @@ VSIVirtualHandle* VSICurlStreamingFSHandler::Open( const char *pszFilename,
         poHandle = NULL;
     }
 
-    if( CSLTestBoolean( CPLGetConfigOption( "VSI_CACHE", "FALSE" ) ) )
-        return VSICreateCachedFile( poHandle );
-    else
-        return poHandle;
+    return poHandle;
 }
 
 /************************************************************************/
@@ -1757,6 +1757,10 @@ public:
     virtual const char* GetPrefix() { return "/vsizip"; }
     virtual std::vector<CPLString> GetExtensions();
     virtual VSIArchiveReader* CreateReader(const char* pszZipFileName);
+    virtual int SerializeFileOffset(const VSIArchiveEntryFileOffset* poOffset,
+                                    GUIntBig* pnVal1, GUIntBig* pnVal2);
+    virtual VSIArchiveEntryFileOffset* DeserializeFileOffset(GUIntBig nVal1,
+                                                             GUIntBig nVal2);
 
     virtual VSIVirtualHandle *Open( const char *pszFilename, 
                                     const char *pszAccess);
@@ -1878,6 +1882,32 @@ VSIArchiveReader* VSIZipFilesystemHandler::CreateReader(const char* pszZipFileNa
     return poReader;
 }
 
+/************************************************************************/
+/*                        SerializeFileOffset()                         */
+/************************************************************************/
+
+int VSIZipFilesystemHandler::SerializeFileOffset(const VSIArchiveEntryFileOffset* poOffset,
+                                                 GUIntBig* pnVal1, GUIntBig* pnVal2)
+{
+    const VSIZipEntryFileOffset* poZipOffset = (const VSIZipEntryFileOffset*)poOffset;
+    *pnVal1 = poZipOffset->file_pos.pos_in_zip_directory;
+    *pnVal2 = poZipOffset->file_pos.num_of_file;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                       DeserializeFileOffset()                        */
+/************************************************************************/
+
+VSIArchiveEntryFileOffset* VSIZipFilesystemHandler::DeserializeFileOffset(GUIntBig nVal1,
+                                                                          GUIntBig nVal2)
+{
+    unz_file_pos file_pos;
+    file_pos.pos_in_zip_directory = (uLong64)nVal1;
+    file_pos.num_of_file = (uLong64)nVal2;
+    return new VSIZipEntryFileOffset(file_pos);
+}
+
 /************************************************************************/
 /*                                 Open()                               */
 /************************************************************************/
@@ -2098,16 +2128,7 @@ VSIVirtualHandle* VSIZipFilesystemHandler::OpenForWrite_unlocked( const char *ps
     std::map<CPLString,VSIArchiveContent*>::iterator iter = oFileList.find(osZipFilename);
     if (iter != oFileList.end())
     {
-        VSIArchiveContent* content = iter->second;
-        int i;
-        for(i=0;i<content->nEntries;i++)
-        {
-            delete content->entries[i].file_pos;
-            CPLFree(content->entries[i].fileName);
-        }
-        CPLFree(content->entries);
-        delete content;
-
+        delete iter->second;
         oFileList.erase(iter);
     }
 
@@ -2376,6 +2397,10 @@ void  VSIZipWriteHandle::StartNewFile(VSIZipWriteHandle* poSubFile)
  *
  * Directory listing is available through VSIReadDir().
  *
+ * As for /vsitar/, the list of members can be saved in a .vsiidx file next
+ * to the zip file by setting the CPL_VSIL_ARCHIVE_INDEX configuration option
+ * to YES.
+ *
  * Since GDAL 1.8.0, write capabilities are available. They allow creating
  * a new zip file and adding new files to an already existing (or just created)
  * zip file. Read and write operations cannot be interleaved : the new zip must
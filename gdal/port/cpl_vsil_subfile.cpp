@@ -58,9 +58,12 @@ class VSISubFileHandle : public VSIVirtualHandle
     virtual int       Seek( vsi_l_offset nOffset, int nWhence );
     virtual vsi_l_offset Tell();
     virtual size_t    Read( void *pBuffer, size_t nSize, size_t nMemb );
+    virtual int       HasPRead() { return VSIFHasPReadL( fp ); }
+    virtual size_t    PRead( void *pBuffer, size_t nSize, vsi_l_offset nOffset );
     virtual size_t    Write( const void *pBuffer, size_t nSize, size_t nMemb );
     virtual int       Eof();
     virtual int       Close();
+    virtual const void *GetRangePointer( vsi_l_offset nOffset, size_t nSize );
 };
 
 /************************************************************************/
@@ -186,6 +189,40 @@ size_t VSISubFileHandle::Read( void * pBuffer, size_t nSize, size_t nCount )
     return nRet;
 }
 
+/************************************************************************/
+/*                               PRead()                                */
+/************************************************************************/
+
+size_t VSISubFileHandle::PRead( void * pBuffer, size_t nSize,
+                                vsi_l_offset nOffset )
+
+{
+    if( nSubregionSize != 0 )
+    {
+        if( nOffset >= nSubregionSize )
+            return 0;
+        if( nSize > nSubregionSize - nOffset )
+            nSize = (size_t)(nSubregionSize - nOffset);
+    }
+
+    return VSIFPReadL( pBuffer, nSize, nSubregionOffset + nOffset, fp );
+}
+
+/************************************************************************/
+/*                          GetRangePointer()                           */
+/************************************************************************/
+
+const void *VSISubFileHandle::GetRangePointer( vsi_l_offset nOffset,
+                                               size_t nSize )
+
+{
+    if( nSubregionSize != 0 &&
+        (nOffset > nSubregionSize || nSize > nSubregionSize - nOffset) )
+        return NULL;
+
+    return VSIFGetRangePointerL( fp, nSubregionOffset + nOffset, nSize );
+}
+
 /************************************************************************/
 /*                               Write()                                */
 /************************************************************************/
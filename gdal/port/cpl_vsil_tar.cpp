@@ -194,6 +194,10 @@ public:
     virtual const char* GetPrefix() { return "/vsitar"; }
     virtual std::vector<CPLString> GetExtensions();
     virtual VSIArchiveReader* CreateReader(const char* pszTarFileName);
+    virtual int SerializeFileOffset(const VSIArchiveEntryFileOffset* poOffset,
+                                    GUIntBig* pnVal1, GUIntBig* pnVal2);
+    virtual VSIArchiveEntryFileOffset* DeserializeFileOffset(GUIntBig nVal1,
+                                                             GUIntBig nVal2);
 
     virtual VSIVirtualHandle *Open( const char *pszFilename, 
                                     const char *pszAccess);
@@ -246,6 +250,28 @@ VSIArchiveReader* VSITarFilesystemHandler::CreateReader(const char* pszTarFileNa
     return poReader;
 }
 
+/************************************************************************/
+/*                        SerializeFileOffset()                         */
+/************************************************************************/
+
+int VSITarFilesystemHandler::SerializeFileOffset(const VSIArchiveEntryFileOffset* poOffset,
+                                                 GUIntBig* pnVal1, GUIntBig* pnVal2)
+{
+    *pnVal1 = ((const VSITarEntryFileOffset*)poOffset)->nOffset;
+    *pnVal2 = 0;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                       DeserializeFileOffset()                        */
+/************************************************************************/
+
+VSIArchiveEntryFileOffset* VSITarFilesystemHandler::DeserializeFileOffset(GUIntBig nVal1,
+                                                                          CPL_UNUSED GUIntBig nVal2)
+{
+    return new VSITarEntryFileOffset(nVal1);
+}
+
 /************************************************************************/
 /*                                 Open()                               */
 /************************************************************************/
@@ -268,20 +294,42 @@ VSIVirtualHandle* VSITarFilesystemHandler::Open( const char *pszFilename,
     if (tarFilename == NULL)
         return NULL;
 
-    VSIArchiveReader* poReader = OpenArchiveFile(tarFilename, osTarInFileName);
-    if (poReader == NULL)
+    GUIntBig nOffset, nSize;
+    if (strlen(osTarInFileName) != 0)
     {
-        CPLFree(tarFilename);
-        return NULL;
+        /* The member list already gives everything needed to open the */
+        /* member, so avoid re-reading its header */
+        const VSIArchiveEntry* archiveEntry = NULL;
+        if (!FindFileInArchive(tarFilename, osTarInFileName, &archiveEntry) ||
+            archiveEntry->bIsDir)
+        {
+            CPLFree(tarFilename);
+            return NULL;
+        }
+        nOffset = ((VSITarEntryFileOffset*)archiveEntry->file_pos)->nOffset;
+        nSize = archiveEntry->uncompressed_size;
+    }
+    else
+    {
+        VSIArchiveReader* poReader = OpenArchiveFile(tarFilename, osTarInFileName);
+        if (poReader == NULL)
+        {
+            CPLFree(tarFilename);
+            return NULL;
+        }
+
+        VSITarEntryFileOffset* pOffset = (VSITarEntryFileOffset*) poReader->GetFileOffset();
+        nOffset = pOffset->nOffset;
+        nSize = poReader->GetFileSize();
+        delete pOffset;
+        delete(poReader);
     }
 
     CPLString osSubFileName("/vsisubfile/");
-    VSITarEntryFileOffset* pOffset = (VSITarEntryFileOffset*) poReader->GetFileOffset();
-    osSubFileName += CPLString().Printf(CPL_FRMT_GUIB, pOffset->nOffset);
+    osSubFileName += CPLString().Printf(CPL_FRMT_GUIB, nOffset);
     osSubFileName += "_";
-    osSubFileName += CPLString().Printf(CPL_FRMT_GUIB, poReader->GetFileSize());
+    osSubFileName += CPLString().Printf(CPL_FRMT_GUIB, nSize);
     osSubFileName += ",";
-    delete pOffset;
     
     if (VSIIsTGZ(tarFilename))
     {
@@ -291,8 +339,6 @@ VSIVirtualHandle* VSITarFilesystemHandler::Open( const char *pszFilename,
     else
         osSubFileName += tarFilename;
 
-    delete(poReader);
-
     CPLFree(tarFilename);
     tarFilename = NULL;
 
@@ -328,6 +374,13 @@ VSIVirtualHandle* VSITarFilesystemHandler::Open( const char *pszFilename,
  *
  * Directory listing is available through VSIReadDir().
  *
+ * The list of members is built on the first access to an archive by walking
+ * through all of it. It can be saved in a .vsiidx file next to the archive
+ * by setting the CPL_VSIL_ARCHIVE_INDEX configuration option to YES, so that
+ * other processes can open a member without walking the archive again. By
+ * default an existing index is used if it matches the size and modification
+ * time of the archive. Set CPL_VSIL_ARCHIVE_INDEX to NO to ignore it.
+ *
  * @since GDAL 1.8.0
  */
 
@@ -52,6 +52,11 @@
 #include <dirent.h>
 #include <errno.h>
 
+#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+#include <sys/mman.h>
+#define HAVE_VSI_MMAP
+#endif
+
 CPL_CVSID("$Id$");
 
 #if defined(UNIX_STDIO_64)
@@ -68,6 +73,12 @@ CPL_CVSID("$Id$");
 #ifndef VSI_STAT64
 #define VSI_STAT64 stat64
 #endif
+#ifndef VSI_FSTAT64
+#define VSI_FSTAT64 fstat64
+#endif
+#ifndef VSI_PREAD64
+#define VSI_PREAD64 pread64
+#endif
 #ifndef VSI_STAT64_T
 #define VSI_STAT64_T stat64
 #endif
@@ -89,6 +100,12 @@ CPL_CVSID("$Id$");
 #ifndef VSI_STAT64
 #define VSI_STAT64 stat
 #endif
+#ifndef VSI_FSTAT64
+#define VSI_FSTAT64 fstat
+#endif
+#ifndef VSI_PREAD64
+#define VSI_PREAD64 pread
+#endif
 #ifndef VSI_STAT64_T
 #define VSI_STAT64_T stat
 #endif
@@ -148,6 +165,11 @@ class VSIUnixStdioHandle : public VSIVirtualHandle
 #ifdef VSI_COUNT_BYTES_READ
     vsi_l_offset  nTotalBytesRead;
     VSIUnixStdioFilesystemHandler *poFS;
+#endif
+#ifdef HAVE_VSI_MMAP
+    GByte        *pabyMapped;
+    vsi_l_offset  nMappedSize;
+    int           bMapAttempted;
 #endif
   public:
                       VSIUnixStdioHandle(VSIUnixStdioFilesystemHandler *poFSIn,
@@ -156,12 +178,15 @@ class VSIUnixStdioHandle : public VSIVirtualHandle
     virtual int       Seek( vsi_l_offset nOffset, int nWhence );
     virtual vsi_l_offset Tell();
     virtual size_t    Read( void *pBuffer, size_t nSize, size_t nMemb );
+    virtual int       HasPRead() { return bReadOnly; }
+    virtual size_t    PRead( void *pBuffer, size_t nSize, vsi_l_offset nOffset );
     virtual size_t    Write( const void *pBuffer, size_t nSize, size_t nMemb );
     virtual int       Eof();
     virtual int       Flush();
     virtual int       Close();
     virtual int       Truncate( vsi_l_offset nNewSize );
     virtual void     *GetNativeFileDescriptor() { return (void*) (size_t) fileno(fp); }
+    virtual const void *GetRangePointer( vsi_l_offset nOffset, size_t nSize );
 };
 
 
@@ -179,6 +204,9 @@ CPL_UNUSED
 #ifdef VSI_COUNT_BYTES_READ
     , nTotalBytesRead(0), poFS(poFSIn)
 #endif
+#ifdef HAVE_VSI_MMAP
+    , pabyMapped(NULL), nMappedSize(0), bMapAttempted(FALSE)
+#endif
 {
 }
 
@@ -195,6 +223,14 @@ int VSIUnixStdioHandle::Close()
     poFS->AddToTotal(nTotalBytesRead);
 #endif
 
+#ifdef HAVE_VSI_MMAP
+    if( pabyMapped != NULL )
+    {
+        munmap( pabyMapped, (size_t)nMappedSize );
+        pabyMapped = NULL;
+    }
+#endif
+
     return fclose( fp );
 }
 
@@ -366,6 +402,40 @@ size_t VSIUnixStdioHandle::Read( void * pBuffer, size_t nSize, size_t nCount )
     return nResult;
 }
 
+/************************************************************************/
+/*                               PRead()                                */
+/************************************************************************/
+
+size_t VSIUnixStdioHandle::PRead( void * pBuffer, size_t nSize,
+                                  vsi_l_offset nOffset )
+
+{
+/* -------------------------------------------------------------------- */
+/*      Data written through stdio may still be in the FILE buffer,     */
+/*      so only read-only handles can bypass it.                        */
+/* -------------------------------------------------------------------- */
+    if( !bReadOnly )
+        return VSIVirtualHandle::PRead( pBuffer, nSize, nOffset );
+
+    const int fd = fileno(fp);
+    size_t nRead = 0;
+    while( nRead < nSize )
+    {
+        ssize_t nRet = VSI_PREAD64( fd, (GByte*)pBuffer + nRead,
+                                    nSize - nRead, nOffset + nRead );
+        if( nRet < 0 && errno == EINTR )
+            continue;
+        if( nRet <= 0 )
+            break;
+        nRead += nRet;
+    }
+
+    VSIDebug4( "VSIUnixStdioHandle::PRead(%p,%ld," CPL_FRMT_GUIB ") = %ld",
+               fp, (long)nSize, nOffset, (long)nRead );
+
+    return nRead;
+}
+
 /************************************************************************/
 /*                               Write()                                */
 /************************************************************************/
@@ -430,6 +500,55 @@ int VSIUnixStdioHandle::Truncate( vsi_l_offset nNewSize )
 }
 
 
+/************************************************************************/
+/*                          GetRangePointer()                           */
+/************************************************************************/
+
+const void *VSIUnixStdioHandle::GetRangePointer( vsi_l_offset nOffset,
+                                                 size_t nSize )
+{
+#ifdef HAVE_VSI_MMAP
+/* -------------------------------------------------------------------- */
+/*      The whole file is mapped the first time a range is requested.   */
+/*      Only read-only handles are mapped, so that the mapping cannot   */
+/*      get out of sync with stdio buffered writes.                     */
+/* -------------------------------------------------------------------- */
+    if( !bMapAttempted )
+    {
+        bMapAttempted = TRUE;
+
+        if( !bReadOnly ||
+            !CSLTestBoolean(CPLGetConfigOption("VSI_MMAP", "YES")) )
+            return NULL;
+
+        struct VSI_STAT64_T sStat;
+        if( VSI_FSTAT64( fileno(fp), &sStat ) != 0 || sStat.st_size <= 0 ||
+            (vsi_l_offset)sStat.st_size != (vsi_l_offset)(size_t)sStat.st_size )
+            return NULL;
+
+        void* pMapped = mmap( NULL, (size_t)sStat.st_size, PROT_READ,
+                              MAP_SHARED, fileno(fp), 0 );
+        if( pMapped == MAP_FAILED )
+        {
+            CPLDebug( "VSI", "mmap() failed: %s", VSIStrerror(errno) );
+            return NULL;
+        }
+        pabyMapped = (GByte*) pMapped;
+        nMappedSize = sStat.st_size;
+    }
+
+    if( pabyMapped == NULL || nOffset > nMappedSize ||
+        nSize > nMappedSize - nOffset )
+        return NULL;
+
+    return pabyMapped + nOffset;
+#else
+    (void) nOffset;
+    (void) nSize;
+#endif
+    return NULL;
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                       VSIUnixStdioFilesystemHandler                  */
@@ -490,19 +609,7 @@ VSIUnixStdioFilesystemHandler::Open( const char *pszFilename,
 
     errno = nError;
 
-/* -------------------------------------------------------------------- */
-/*      If VSI_CACHE is set we want to use a cached reader instead      */
-/*      of more direct io on the underlying file.                       */
-/* -------------------------------------------------------------------- */
-    if( bReadOnly
-        && CSLTestBoolean( CPLGetConfigOption( "VSI_CACHE", "FALSE" ) ) )
-    {
-        return VSICreateCachedFile( poHandle );
-    }
-    else
-    {
-        return poHandle;
-    }
+    return poHandle;
 }
 
 /************************************************************************/
@@ -441,19 +441,7 @@ VSIVirtualHandle *VSIWin32FilesystemHandler::Open( const char *pszFilename,
     if (strchr(pszAccess, 'a') != 0)
         poHandle->Seek(0, SEEK_END);
     
-/* -------------------------------------------------------------------- */
-/*      If VSI_CACHE is set we want to use a cached reader instead      */
-/*      of more direct io on the underlying file.                       */
-/* -------------------------------------------------------------------- */
-    if( (EQUAL(pszAccess,"r") || EQUAL(pszAccess,"rb"))
-        && CSLTestBoolean( CPLGetConfigOption( "VSI_CACHE", "FALSE" ) ) )
-    {
-        return VSICreateCachedFile( poHandle );
-    }
-    else
-    {
-        return poHandle;
-    }
+    return poHandle;
 }
 
 /************************************************************************/